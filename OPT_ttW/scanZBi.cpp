@@ -17,12 +17,13 @@
 
 
 std::pair<TH1F*,TH1F*> getHistoPassingCuts( TTree* tree, std::vector<std::string> names, std::vector<float> cutsMin, std::vector<float> cutsMax );
+std::vector<std::vector<double> > gridThresholds();
 
 
 int main( int argc, char* argv[] ) {
 
   if( argc <= 2 ) {
-    std::cout << "USAGE: ./scanZBi [selectionType] [charge (\"plus\" or \"minus\" or \"all\")]" << std::endl;
+    std::cout << "USAGE: ./scanZBi [selectionType] [charge (\"plus\" or \"minus\" or \"all\")] [\"grid\" to scan the cuts on a yield grid]" << std::endl;
     exit(999);
   }
 
@@ -45,6 +46,14 @@ int main( int argc, char* argv[] ) {
     exit(777);
   }
 
+  // with "grid" all cut points of a cumulative yield grid are
+  // scanned as well, the best ones are redone on the sig events
+  bool useGrid = ( argc>3 && std::string(argv[3])=="grid" );
+
+  int charge_int = 0;
+  if( charge=="plus")  charge_int = 1;
+  if( charge=="minus") charge_int = -1;
+
 
   float lumi = 20000.;
 
@@ -74,6 +83,9 @@ int main( int argc, char* argv[] ) {
   plotter->storeWeightedPred(plotter->gRegion[plotter->gBaseRegion]);
   //plotter->doAnalysis();
 
+  YieldGrid* grid = 0;
+  if( useGrid ) grid = plotter->makeTTWYieldGrid( gridThresholds(), charge_int );
+
 
 
   std::string optcutsdir = "optcuts_" + selectionType + "_" + charge;
@@ -142,11 +154,7 @@ int main( int argc, char* argv[] ) {
     }
 
 
-    int charge_int = 0;
-    if( charge=="plus")  charge_int = 1;
-    if( charge=="minus") charge_int = -1;
-
-    TTWZPrediction ttwzpred =  plotter->makePredictionSignalEvents(min_ht, 10000., min_met, 10000., min_NJets, min_NBJets, min_NBJets_med, min_ptLept1, min_ptLept2, charge_int, true);
+    TTWZPrediction ttwzpred = plotter->makePredictionSignalEvents(min_ht, 10000., min_met, 10000., min_NJets, min_NBJets, min_NBJets_med, min_ptLept1, min_ptLept2, charge_int, true);
 
     float lumi_SF = lumi/plotter->fLumiNorm;
 
@@ -286,6 +294,11 @@ std::cout << "### " << iEff << "   ZBi: " << ZBi << std::endl;
 
   ofs_ZBi.close();
 
+  if( grid!=0 ) {
+    plotter->scanTTWYieldGrid( *grid, lumi, lumi/plotter->fLumiNorm, optcutsdir, ZBiCalculator::computeZBi, charge_int );
+    delete grid;
+  }
+
   db->resetStyle();
 
   gr_ZBi->SetMarkerSize(2.);
@@ -315,6 +328,33 @@ std::cout << "### " << iEff << "   ZBi: " << ZBi << std::endl;
 
 
 
+std::vector<std::vector<double> > gridThresholds() {
+
+  // thresholds of HT, MET, NJ, NbJ, NbJmed, pT1, pT2 of the yield grid.
+  // The grid is dense: 10*7*7*4*3*7*7 cut points of 42 yields, about 50 MB
+  double ht[]     = { 0., 40., 80., 120., 160., 200., 240., 280., 320., 400. };
+  double met[]    = { 0., 20., 30., 40., 60., 80., 100. };
+  double nj[]     = { 0., 1., 2., 3., 4., 5., 6. };
+  double nbj[]    = { 0., 1., 2., 3. };
+  double nbjmed[] = { 0., 1., 2. };
+  double pt1[]    = { 0., 20., 25., 30., 35., 40., 50. };
+  double pt2[]    = { 0., 10., 20., 25., 30., 35., 40. };
+
+  std::vector<std::vector<double> > thresholds;
+  thresholds.push_back( std::vector<double>(ht,     ht+sizeof(ht)/sizeof(double)) );
+  thresholds.push_back( std::vector<double>(met,    met+sizeof(met)/sizeof(double)) );
+  thresholds.push_back( std::vector<double>(nj,     nj+sizeof(nj)/sizeof(double)) );
+  thresholds.push_back( std::vector<double>(nbj,    nbj+sizeof(nbj)/sizeof(double)) );
+  thresholds.push_back( std::vector<double>(nbjmed, nbjmed+sizeof(nbjmed)/sizeof(double)) );
+  thresholds.push_back( std::vector<double>(pt1,    pt1+sizeof(pt1)/sizeof(double)) );
+  thresholds.push_back( std::vector<double>(pt2,    pt2+sizeof(pt2)/sizeof(double)) );
+
+  return thresholds;
+
+}
+
+
+
 std::pair<TH1F*,TH1F*> getHistoPassingCuts( TTree* tree, std::vector<std::string> names, std::vector<float> cutsMin, std::vector<float> cutsMax ) {
 
 
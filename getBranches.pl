@@ -5,15 +5,27 @@
 # Perl script to extract the list of ETH tree branches used in a list of files
 # The output is the list of used branches. It should be redirected in a text file.
 # This file can then be fed into makeTreeClassBase.py.
+# The branch reports written by the analyzers at the end of a job
+# (UsedBranches.txt) can be merged in with -report=file1[,file2...],
+# so that the list also covers branches that are not accessed as fTR->.
 # 
-# Usage: getBranches.pl <file1.cc> [file2.cc ...]
+# Usage: getBranches.pl [-report=UsedBranches.txt] <file1.cc> [file2.cc ...]
 #
 
-if ( @ARGV==0 || $h || $help ) {
-    die "Usage: ".$0." <file1.cc> [file2.cc ...]\n";
+if ( (@ARGV==0 && !$report) || $h || $help ) {
+    die "Usage: ".$0." [-report=file1[,file2...]] <file1.cc> [file2.cc ...]\n";
 }
 
 my %branches ;
+foreach $file ( split(/,/,$report) ) {
+    open(FIN,$file) or die "Couldn't open $file: $!";
+    while (<FIN>) {
+        chomp();
+        next if ( $_ !~ /^\w+$/ );
+        $branches{$_} = 1;
+    }
+    close(FIN);
+}
 foreach $file ( @ARGV ) {
 
     open(FIN,$file) or die "Couldn't open $file: $!";
@@ -18,9 +18,473 @@
 #include "base/UserAnalysisBase.hh"
 #include "helper/Monitor.hh"
 #include "helper/BTagSF.hh"
-#include "helper/Davismt2.h"
+#include "helper/MT2Calculator.hh"
+#include "helper/Hemisphere.hh"
 #include "SolveTTbarNew.hh"
 
+class TF1;
+class TTree;
+class TMinuit;
+class rochcor2012;
+
+#define jMax 30  // do not touch this
+#define lMax 10
+#define Zmax 5
+
+enum METTYPE { mettype_min, RAW = mettype_min, T1PFMET, TCMET, MUJESCORRMET, PFMET, SUMET, PFRECOILMET, RECOILMET, mettype_max };
+enum JZBTYPE { jzbtype_min, TYPEONECORRPFMETJZB = jzbtype_min, PFJZB, RECOILJZB, PFRECOILJZB, TCJZB, jzbtype_max };
+
+// Event of the output tree
+class nanoEvent
+{
+public:
+  nanoEvent();
+  void reset();
+
+  float mll; // di-lepton system
+  float minc;
+  float pt;
+  float phi;
+  float eta;
+  float E;
+  bool is_data;
+
+  float l1l2dR;
+  float pt1; // leading leptons
+  float pt2;
+  float Ropt1; // Rochester corrected lepton
+  float Ropt2; // Rochester corrected lepton
+  float Romll; // Rochester corrected di-lepton mass
+  float iso1;
+  float iso2;
+  float dz1, dz2;
+  float d01, d02;
+  bool  isConv1; // Photon conversion flag
+  bool  isConv2;
+  bool softMuon;
+
+  int NgenLeps;
+  int NgenZs;
+  
+  float genPt1; // leading legenPtons
+  float genPt2;
+  float genDRll;
+  float genPhi1;
+  float genPhi2;
+  int   genId1;
+  int   genId2;
+  int   genMID1gen;
+  int   genMID2gen;
+  int   genMID1;
+  int   genMID2;
+  int   genGMID1gen;
+  int   genGMID2gen;
+  int   genGMID1;
+  int   genGMID2;
+  float genEta1; // leading legenPtons
+  float genEta2;
+  float genMET;
+  float genZPt;    // True Z Pt
+  float genMll;
+  float genRecoil;
+  float genJZB;
+  int   genNjets;
+  int   genNleptons;
+  float genRecoilSel;
+  float genPt1Sel; // Selected leptons
+  float genPt2Sel;
+  float genEta1Sel;
+  float genEta2Sel;
+  int   genId1Sel;
+  int   genId2Sel;
+  float genZPtSel; // Z candidate from selected leptons
+  float genMllSel;
+  float genJZBSel;
+  float eta1; // leading leptons
+  float eta2;
+  float phi1;
+  float phi2;
+  float dphi;
+  float dphiZpfMet;
+  float dphigenZgenMet;
+  float dphiZs1;
+  float dphiZs2;
+  float dphiMet1;
+  float dphiMet2;
+  float dphitcMet1;
+  float dphitcMet2;
+  float dphipft1Met1;
+  float dphipft1Met2;
+  float dphipfRecoilMet1;
+  float dphipfRecoilMet2;
+  
+  float pfMET;
+  float t1pfMET;
+
+  bool ElCInfoIsGsfCtfCons;
+  bool ElCInfoIsGsfCtfScPixCons;
+  bool ElCInfoIsGsfScPixCons;
+
+  int id1;
+  int id2;
+  int ch1;
+  int ch2;
+  int chid1; // old id (kostas convention)
+  int chid2;
+
+  int process;
+
+  int leptonNum; // store all leptons (reduntant for the 2 leptons that form the Z)
+  float leptonPt[lMax]; 
+  float leptonEta[lMax];
+  float leptonPhi[lMax];
+  int leptonId[lMax];
+  int leptonCharge[lMax];
+
+  int leptonPairNum;
+  int leptonPairId[jMax];
+  float leptonPairMass[jMax];
+  float leptonPairDphi[jMax];
+
+
+  int pfJetNum;
+  float pfJetPt[jMax];
+  float pfJetEta[jMax];
+  float pfJetPhi[jMax];
+  bool  pfJetID[jMax];
+  float pfJetScale[jMax];
+  float pfJetScaleUnc[jMax];
+  float pfJetDphiMet[jMax];
+  float pfJetDphiZ[jMax];
+  float pfBJetDphiZ[jMax];
+  float pfHT;
+  float pfGoodHT;
+  float pfTightHT;
+  float rho;
+ 
+  float metUncertainty;
+  float type1metUncertainty;
+  
+  int pfJetGoodNum30;
+  int pfJetGoodNum30Fwd;
+  int pfJetGoodNumID;
+  int pfJetGoodNump1sigma;
+  int pfJetGoodNumn1sigma;
+  int pfJetGoodNum40p1sigma;
+  int pfJetGoodNum40n1sigma;
+  int pfJetGoodNum50p1sigma;
+  int pfJetGoodNum50n1sigma;
+  int pfJetGoodNum40CHS;
+  float pfJetGoodPt[jMax];
+  float pfJetGoodEta[jMax];
+  float pfJetGoodPhi[jMax];
+  float pfJetGoodE[jMax];
+  float pfJetGoodMl[jMax];
+  float pfJetGoodM[jMax];
+  float pfJetGoodPtl[jMax];
+  float pfJetGoodID[jMax];
+  int   pfJetGoodTracks[jMax];
+  int   pfJetGoodTracksN[jMax];
+  float bTagProbCSVBP[jMax];
+  float bTagProbCSVMVA[jMax];
+  float bTagProbJP[jMax];
+  float bTagProbTCHP[jMax];
+ 
+  int MC_pfJetGoodNumBTag40;
+  int MC_pfJetGoodNumBTag40dn;
+  int MC_pfJetGoodNumBTag40up;
+  int pfJetGoodNumBtag30;
+  int pfJetGoodNumBtag40;
+  int pfJetGoodNumBtag40CSVBPLoose;
+  int pfJetGoodNumBtag40CSVBPTight;
+  int pfJetGoodNumBtag40CSVMVA;
+  int pfJetGoodNumBtag40JP;
+  int pfJetGoodNumBtag40TCHP;
+  
+  int pfJetGoodNumBtag40up;
+  int pfJetGoodNumBtag40dn;
+  int pfJetGoodNumBtag30_Tight;
+  int pfJetGoodNumBtag40_Tight;
+  int pfJetGoodNumBtag30_Loose;
+  int pfJetGoodNumBtag40_Loose;
+  int pfJetGoodNumIDBtag;
+  float pfJetGoodPtBtag[jMax];
+  float pfJetGoodEtaBtag[jMax];
+  float pfJetGoodPhiBtag[jMax];
+  float pfJetGoodEBtag[jMax];
+  float pfJetGoodMlBtag[jMax];
+  float pfJetGoodMBtag[jMax];
+  float pfJetGoodPtlBtag[jMax];
+  bool  pfJetGoodIDBtag[jMax];
+  int   pfJetGoodTracksBtag[jMax];
+  int   pfJetGoodTracksNBtag[jMax];
+
+  int pfJetGoodNum40;
+  int pfJetGoodNum40Fwd;
+  int pfJetGoodNum50;
+  int pfJetGoodNum50Fwd;
+  int pfJetGoodNum60;
+  int pfJetGoodNum60Fwd;
+
+  int EventFlavor;
+  bool EventZToTaus;
+  
+  float met[mettype_max];
+  float metPhi[mettype_max];
+  float dphiMetLep[mettype_max];
+  float dphiMetJet[mettype_max];
+  float dphiMetSumJetPt[mettype_max];
+  float metPerp[mettype_max];
+  float metPar[mettype_max];
+  ULong64_t eventNum;
+  int runNum;
+  int lumi;
+  int goodVtx;
+  int numVtx;
+  float totEvents; // tot events processed by the ntuple producer (job submission efficiency), no need to keep this as int, better as float
+  int badJet;
+
+  float jzb[jzbtype_max];
+  float chs_jzb;
+  float d2;
+  float mt2;
+  float mt2j;
+  float ml1b;
+  float ml2b;
+  float drl1b, drl2b;
+  float mjl[jMax];
+  float mjll[jMax];
+  float st;
+  float sjzb[jzbtype_max]; // smeared JZB
+  float dphi_sumJetVSZ[jzbtype_max];
+  float sumJetPt[jzbtype_max];
+  float MR,MRT,Razor;
+
+  float weight;
+  float weight_2BJets;
+  float weightEffDown;
+  float weightEffUp;
+  float Efficiencyweightonly;
+
+  float lheV_pt;
+  float lheV_mll;
+  float lheHT;
+  int lheNj;
+  float genTopPt;
+  float genAntiTopPt;
+  float benWeight;
+  float topWeight;
+
+  int NPdfs;
+  float pdfW[100];
+  float pdfWsum;
+  float PUweight,PUweightUP,PUweightDOWN;
+  bool passed_triggers;
+  int trigger_bit;
+  bool passed_filters;
+  int filter_bit;
+  float mGlu;
+  float mChi;
+  float mLSP;
+  float xSMS;
+  float xbarSMS;
+  float mGMSBGlu;
+  float mGMSBChi;
+  float mGMSBLSP;
+  
+  
+  //gen information
+  int nZ; // number of generator Z's in the process
+  int SourceOfZ[Zmax];//mother particle of the (first Zmax) Z's
+  int DecayCode; //decay code: 100*h + l, where h = number of hadronically decaying Z's, l = number of leptonically decaying Z's (e.g. 102 = 1 had. Z, 2 lep. Z's)
+  float realx; // this is the "x" we measure (for scans)
+  float imposedx; // this is the "x" we imposed.
+  float GeneratorZPt;
+  float pureGeneratorZpt;
+  float pureGeneratorZM;
+  float pureGeneratorZphi;
+  float pureGeneratorZeta;
+  float pureGeneratorJZB;
+  float pureGeneratorMet;
+  float pureGeneratorMetPhi;
+  float pureGeneratorSumJetPt;
+  float pureGeneratorSumJetEta;
+  float pureGeneratorSumJetPhi;
+  float pure2ndGeneratorJZB;
+  float pure2ndGeneratorZpt;
+  int nLSPs;
+  float angleLSPLSP;
+  float angleLSPLSP2d;
+  float angleLSPZ;
+  float angleLSPZ2d;
+  float angleChi2Z2d;
+  float angleChi2Z;
+  float dphiSumLSPgenMET;
+  float SumLSPEta;
+  float SumLSPPhi;
+  float absvalSumLSP;
+  int LSPPromptnessLevel[2];
+  int ZPromptnessLevel[2];
+  float LSP1pt;
+  float LSP2pt;
+  int LSP1Mo;
+  int LSP2Mo;
+  float LSP1Mopt;
+  float LSP2Mopt;
+  
+  //Z+b variables
+  
+  bool HasSoftLepton;
+  float SoftLeptonPt;
+  
+  float mpf;
+  float mpf_JS;
+  float mpf_L5;
+  float fake_mpf;
+  
+  float ZbCHS3015_alpha;
+  float ZbCHS3015_alphaUp;
+  float ZbCHS3015_alphaDown;
+  float ZbCHS3015_alphaL5;
+  float ZbCHS3015_L5corr;
+  int ZbCHS3015_JetFlavor;
+  
+  float ZbCHS3015_bTagProbCSVBP[jMax]; 
+  int ZbCHS3015_pfJetGoodNumBtag; 
+  float ZbCHS3015_pfJetGoodEta[jMax]; 
+  int ZbCHS3015_pfJetGoodNum;
+  float ZbCHS3015_pfJetDphiZ[jMax];
+  float ZbCHS3015_pfJetGoodPt[jMax];
+  float ZbCHS3015_pfJetGoodUnsmearedPt[jMax];
+  float ZbCHS3015_pfJetSum;
+  float ZbCHS3015_pfBJetDphiZ[jMax];
+
+  float ZbCHS3015_BTagWgtT;
+  float ZbCHS3015_BTagWgtTUp;
+  float ZbCHS3015_BTagWgtTDown;
+  float ZbCHS3015_BTagWgtM;
+  float ZbCHS3015_BTagWgtMUp;
+  float ZbCHS3015_BTagWgtMDown;
+  float ZbCHS3015_BTagWgtL;
+  float ZbCHS3015_BTagWgtLUp;
+  float ZbCHS3015_BTagWgtLDown;
+  bool ZbCHS3015_LeadingJetIsPu;
+  bool ZbCHS3015_SubLeadingJetIsPu;
+  
+  
+  float fact;
+  
+  //Trilepton variables
+  float tri_pt1;
+  float tri_pt2;
+  float tri_pt3;
+  float tri_eta1;
+  float tri_eta2;
+  float tri_eta3;
+  bool tri_MatchFound;
+  int tri_id1;
+  int tri_id2;
+  int tri_id3;
+  int tri_ch1;
+  int tri_ch2;
+  int tri_ch3;
+  float tri_mlll;
+  float tri_badmll;
+  float tri_mll;
+  float tri_submll;
+  float tri_badsubmll;
+  float tri_mT;
+  float tri_badmT;
+  int tri_genMID1;
+  int tri_genMID2;
+  int tri_genMID3;
+  int tri_badgenMID1;
+  int tri_badgenMID2;
+  int tri_badgenMID3;
+
+  float tri_dR12;
+  float tri_dR13;
+  float tri_dR23;
+  int tri_index1;
+  int tri_index2;
+  int tri_index3;
+  int tri_badindex1;
+  int tri_badindex2;
+  int tri_badindex3;
+  int tri_badid1;
+  int tri_badid2;
+  int tri_badid3;
+  bool tri_GoodZMatch;
+  bool tri_GoodWMatch;
+  
+  float gentri_pt1;
+  float gentri_pt2;
+  float gentri_pt3;
+  float gentri_eta1;
+  float gentri_eta2;
+  float gentri_eta3;
+  float gentri_id1;
+  float gentri_id2;
+  float gentri_id3;
+  float gentri_ch1;
+  float gentri_ch2;
+  float gentri_ch3;
+  float gentri_mlll;
+  float gentri_mll;
+  float gentri_badmll;
+  float gentri_submll;
+  float gentri_badsubmll;
+  float gentri_mT;
+  float gentri_badmT;
+  int gentri_genMID1;
+  int gentri_genMID2;
+  int gentri_genMID3;
+  int gentri_badgenMID1;
+  int gentri_badgenMID2;
+  int gentri_badgenMID3;
+  float gentri_dR12;
+  float gentri_dR13;
+  float gentri_dR23;
+  bool gentri_GoodZMatch;
+  bool gentri_GoodWMatch;
+  
+  float pgentri_pt1;
+  float pgentri_pt2;
+  float pgentri_pt3;
+  float pgentri_eta1;
+  float pgentri_eta2;
+  float pgentri_eta3;
+  float pgentri_id1;
+  float pgentri_id2;
+  float pgentri_id3;
+  float pgentri_ch1;
+  float pgentri_ch2;
+  float pgentri_ch3;
+  float pgentri_mlll;
+  float pgentri_mll;
+  float pgentri_submll;
+  float pgentri_mT;
+  float pgentri_dR12;
+  float pgentri_dR13;
+  float pgentri_dR23;
+  
+  float dRmerged;
+  int merged;
+  float mergedPt;
+  float mergedEta;
+  float mergedPhoHCalIso2012ConeDR03;
+  float mergedPhoSigmaIetaIeta;
+  float mergedpfchargedhadiso;
+  float mergedpfneutralhadiso;
+  float mergedpfphotoniso;
+  
+  float SL_pt;
+  float SL_eta;
+  bool SL_Accept;
+  int SL_id;
+
+};
+
 struct lepton {
   TLorentzVector p;
   int charge;
@@ -52,7 +516,7 @@ public:
   const float IndividualEffArea(float abseta, string type);
   const bool IsCustomJet(const int);
 //  const bool IsConvertedPhoton( const int eIndex );
-  const bool passTriggers(std::vector<std::string>& triggerPaths);
+  const bool passTriggers(const int triggerMenu);
   const bool passFilters(int& bits);
   const float GetLeptonWeight(int id1, float phi1, float eta1, int id2, float phi2, float eta2, float &EffErr);
   const float GetMuonWeight(float eta1, float pt1, float &EffErr);
@@ -94,6 +558,11 @@ public:
   void Analyze();
   void End(TFile *f);
 
+  // Parallel running: own generator for the JZB smearing (default: gRandom)
+  // and the counters of a worker added to these
+  void SetSmearingSeed(UInt_t seed);
+  void AddCounters(const JZBAnalysis& other);
+
   // Fill generator information
   void GeneratorInfo();
   
@@ -106,6 +575,23 @@ private:
 
   Monitor counters[count_end];
 
+  // Counter handles, booked in Begin in this order
+  enum evCut_t { evAll, evElTrig, evMuTrig, evEMTrig, evMETrig, evMETTrig, evHTTrig,
+                 evGood, ev2Lep, ev2OSLep, evDilepPt, evCut_end };
+  enum muCut_t { muAll, muPt, muEta, muGlobal, muTracker, muPF, muChi2, muValidHits,
+                 muPxHits, muStations, muLayers, muD0, muDZ, muIso, muPass, muCut_end };
+  enum elCut_t { elAll, elEta, elPt, elID, elMissHits, elEoverP, elDRmu, elD0, elDZ,
+                 elConvVeto, elGap, elIso, elPass, elCut_end };
+  enum jeCut_t { jeN90Hits, jeHPD, jeEMfrac, jeCut_end };
+  enum pjCut_t { pjAll, pjCleaning, pjVeto1, pjVeto2, pjPt, pjEta, pjJetID, pjTight, pjCut_end };
+  Monitor::Handle evCuts[evCut_end];
+  Monitor::Handle muCuts[muCut_end];
+  Monitor::Handle elCuts[elCut_end];
+  Monitor::Handle jeCuts[jeCut_end];
+  Monitor::Handle pjCuts[pjCut_end];
+  Monitor::Handle trAll;
+  Monitor::Handle pairCounters[4][4]; // ee, mm, em, unknown: pairs, + 2 jets, + Z, + JZB>50
+
   vector<lepton> sortLeptonsByPt(vector<lepton>&);
   // Add a set of paths to path container
   void addPath(std::vector<std::string>& paths,std::string base, 
@@ -146,10 +632,47 @@ private:
   BTagSF *fBTagSFup;
   BTagSF *fBTagSFdn;
   TRandom3 *fRand3Normal;
+  MT2Calculator fMT2Calc;
+  Hemisphere fHemisphere; // reused for every event
   
   std::vector<std::string> elTriggerPaths, muTriggerPaths, emTriggerPaths, meTriggerPaths, metTriggerPaths, htTriggerPaths, singleElTriggerPaths, singleMuTriggerPaths;
+  int elTriggers, muTriggers, emTriggers, meTriggers, metTriggers, htTriggers, singleElTriggers, singleMuTriggers; // trigger menus of the paths
 
   TRandom* rand_;
+  TRandom3 *r;
+  TRandom3 *fSmearRand; // see GausRandom
+  Double_t GausRandom(Double_t mu, Double_t sigma);
+  void GetTopWeights(int sample);
+
+  // Output tree
+  nanoEvent nEvent;
+  TTree *myTree;
+  TTree *myInfo;
+  TH1F *weight_histo;
+
+  rochcor2012 *rmcor;
+  TF1 *L5corr_bJ;
+  TF1 *L5corr_qJ;
+  TF1 *L5corr_cJ;
+  TF1 *L5corr_gJ;
+
+  const BTagSF::SFLightPar *CSVL__SFlight_0p0_to_0p5;
+  const BTagSF::SFLightPar *CSVL__SFlight_0p5_to_1p0;
+  const BTagSF::SFLightPar *CSVL__SFlight_1p0_to_1p5;
+  const BTagSF::SFLightPar *CSVL__SFlight_1p5_to_2p4;
+
+  const BTagSF::SFLightPar *CSVM__SFlight_0p0_to_0p8;
+  const BTagSF::SFLightPar *CSVM__SFlight_0p8_to_1p6;
+  const BTagSF::SFLightPar *CSVM__SFlight_1p6_to_2p4;
+
+  const BTagSF::SFLightPar *CSVT__SFlight;
+
+  TF1 *CSVL_SFb;
+  TF1 *CSVM_SFb;
+  TF1 *CSVT_SFb;
+
+  SolveTTbarNew *solver;
+  TMinuit *minuit;
 
 };
 #endif
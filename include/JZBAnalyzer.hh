@@ -13,22 +13,30 @@ class JZBAnalyzer : public TreeAnalyzerBase {
 public:
   JZBAnalyzer(std::vector<std::string>& fileList, std::string dataType="mc", std::string globalTag="",
               bool fullCleaning=false , bool isModelScan=false, bool makeSmall=false, bool doGenInfo=false);
+  // Worker for parallel running, on a part of the entries of master
+  JZBAnalyzer(std::vector<std::string>& fileList, const JZBAnalyzer *master);
   virtual ~JZBAnalyzer();
   void BeginJob(string data_PileUp, string mc_PileUp);
   void EndJob();
   void Loop();
-  void SetMaxEvents(int a){fMaxEvents=a;}
-  void SetOutputFile(TString a){fOutputFile=a;}
-  void SetOutputFileName(string a){outputFileName_=a;}
+  void SetOutputFileName(string a){outputFileName_=a; fOutputFile=a;}
+
+  TreeAnalyzerBase* MakeWorker(std::vector<std::string>& fileList, const TString& outputFile);
+  void MergeWorker(TreeAnalyzerBase *worker);
 
 private:
   JZBAnalysis *fJZBAnalysis;
-  int fMaxEvents;
-  TString fOutputFile;
+  TFile *fHistFile;
   string outputFileName_;
+  std::string fDataType;
+  std::string fGlobalTag;
+  bool fFullCleaning;
   bool f_isModelScan;
   bool f_makeSmall;
   bool f_doGenInfo;
+  string fDataPUFile;
+  string fMCPUFile;
+  int fNWorkers; // workers made, for their random seeds
 
 };
 #endif
@@ -0,0 +1,120 @@
+/*****************************************************************************
+*   Compiled selections and variables on MT2tree                             *
+*****************************************************************************/
+
+#ifndef MT2Selection_HH
+#define MT2Selection_HH
+
+#include <vector>
+#include <map>
+#include "TString.h"
+
+class MT2tree;
+class TTree;
+class TH1;
+
+// Signatures of the generated functions
+typedef int    (*MT2CutFunc)   (MT2tree &t);            // number of leading cuts passed
+typedef void   (*MT2VarFunc)   (MT2tree &t, double *v); // all variables
+typedef double (*MT2WeightFunc)(MT2tree &t);
+
+//
+// Selection of ordered cuts, variables and an event weight, written in the
+// TTree::Draw syntax used with MT2trees ("misc.MET>30", "NJetsIDLoose40>=3",
+// "GetMT2Hemi(0,false,1,20,2.4,3,1)", ...), and evaluated as compiled code
+// instead of interpreted TTreeFormulas.
+//
+// The expressions are translated to C++ on an MT2tree (members and member
+// functions get a "t." prefix) and written into one source file, which
+//  - is compiled and loaded once per session with ACLiC by Compile()
+//    (the executable must export its symbols, i.e. be linked with -rdynamic,
+//    see the MakeMassPlots rule of the Makefile)
+//  - or is generated beforehand with WriteSource() and linked into the
+//    executable: Compile() then finds it registered and compiles nothing.
+// CompileAll() writes the selections which are not registered yet into a
+// single file, i.e. several selections cost one ACLiC call. By default the
+// file goes to a new directory of this process under the temp directory.
+// Selections are identified by the MD5 digest of their generated code.
+// Array expressions (implicit loops of TTree::Draw) are not supported,
+// index the arrays explicitly.
+//
+// Loop() makes one pass over a tree, counts the events passing each cut in
+// sequence (cut flow, weighted and unweighted) and fills the histograms
+// booked on the variables for the events passing all cuts. The address of
+// the MT2tree branch set by the caller is kept, or restored afterwards.
+// Only the branches of the members used by the expressions are read, as
+// with TTree::Draw, unless they call MT2tree member functions.
+//
+class MT2Selection {
+
+public:
+	MT2Selection();
+	virtual ~MT2Selection(){};
+
+	// Definition, before Compile()
+	int  AddCut(TString label, TString expr);
+	int  AddCuts(TString cuts);  // "a && b && c": one cut per top level term
+	int  AddVariable(TString expr);
+	void SetWeight(TString expr){ fWeightExpr = expr; fCompiled = false; };
+
+	bool Compile(TString includedir = "include", TString builddir = "");
+	static bool CompileAll(const std::vector<MT2Selection*> &sels, TString includedir = "include", TString builddir = "");
+	bool WriteSource(TString filename);
+	inline bool IsCompiled() const { return fCompiled; };
+
+	// Evaluation
+	bool   Pass(MT2tree &t, double scale = 1.); // also counts the cut flow
+	inline double GetValue(int i) const { return fValues[i]; };  // after Pass
+	inline double GetWeight()     const { return fWeight;    };  // after Pass, without scale
+
+	void     Book(TH1 *h, int var);
+	Long64_t Loop(TTree *tree, double scale = 1., Long64_t nentries = -1);
+	Long64_t Loop(TTree *tree, MT2tree *&t, double scale = 1., Long64_t nentries = -1); // reads into t
+
+	// Cut flow
+	void ResetCounters();
+	void PrintCutFlow(TString title = "") const;
+	inline int      GetNCuts()           const { return fCutExpr.size(); };
+	inline Long64_t GetNTotal()          const { return fNTotal; };
+	inline Long64_t GetNPassed(int i)    const { return fNPass[i]; };
+	inline double   GetWPassed(int i)    const { return fWPass[i]; };
+	double          GetEfficiency(int i) const; // relative to the previous cut
+
+	// Translation from the TTree::Draw syntax
+	static TString Translate(TString expr);
+	static bool    Register(const char *key, MT2CutFunc cuts, MT2VarFunc vars, MT2WeightFunc weight);
+
+private:
+	struct Functions {
+		MT2CutFunc    cuts;
+		MT2VarFunc    vars;
+		MT2WeightFunc weight;
+	};
+	static std::map<TString, Functions>& Registry();
+
+	TString GetBody(TString &key) const;
+	static TString GetSource(const std::vector<TString> &bodies, const std::vector<TString> &keys);
+	static TString GetBuildDir();
+	bool    SetFunctions();
+	bool    SelectBranches(TTree *tree, std::vector<std::pair<TString, bool> > &status) const;
+
+	std::vector<TString> fCutLabel;
+	std::vector<TString> fCutExpr;
+	std::vector<TString> fVarExpr;
+	TString              fWeightExpr;
+
+	bool      fCompiled;
+	Functions fFunc;
+
+	std::vector<double> fValues;
+	double              fWeight;
+
+	std::vector<std::pair<TH1*, int> > fHistos;
+
+	Long64_t              fNTotal;
+	double                fWTotal;
+	std::vector<Long64_t> fNPass;
+	std::vector<double>   fWPass;
+};
+
+#endif
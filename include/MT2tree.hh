@@ -383,6 +383,42 @@ public:
   ClassDef(MT2GenLept, 3)
 };
 
+// MT2HemiEngine ----------------------------
+class Hemisphere;
+
+// Hemisphere engine of an MT2tree, created on first use: the MT2 variants
+// computed on the same event share its reconstructions. Not streamed,
+// copies of a tree get their own engine.
+class MT2HemiEngine {
+public:
+  MT2HemiEngine() : fHemi(0) {}
+  MT2HemiEngine(const MT2HemiEngine&) : fHemi(0) {}
+  MT2HemiEngine& operator=(const MT2HemiEngine&) { return *this; }
+  ~MT2HemiEngine();
+
+  Hemisphere& Get(int n, const float* px, const float* py, const float* pz, const float* E,
+                  int hemi_seed, int hemi_association);
+private:
+  Hemisphere* fHemi;
+};
+
+// MT2CalcEngine ----------------------------
+class MT2Calculator;
+
+// MT2 calculator of an MT2tree, created on first use and reused by all
+// MT2 computations of the tree. Not streamed, copies get their own.
+class MT2CalcEngine {
+public:
+  MT2CalcEngine() : fCalc(0) {}
+  MT2CalcEngine(const MT2CalcEngine&) : fCalc(0) {}
+  MT2CalcEngine& operator=(const MT2CalcEngine&) { return *this; }
+  ~MT2CalcEngine();
+
+  MT2Calculator& Get();
+private:
+  MT2Calculator* fCalc;
+};
+
 // MT2tree ----------------------------------
 class MT2tree : public TObject {
 
@@ -510,7 +546,10 @@ public:
   TLorentzVector MHT[2];
   TLorentzVector MHTloose[2];
 
-  
+private:
+  MT2HemiEngine  fHemiEngine; //! not streamed
+  MT2CalcEngine  fMT2Engine;  //! not streamed
+
   ClassDef(MT2tree, 18)
 };
 
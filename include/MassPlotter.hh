@@ -10,6 +10,7 @@
 #include "helper/Monitor.hh"
 #include "THStack.h"
 #include "TTree.h"
+#include "TH1.h"
 #include <map>
 
 static const int gNMT2bins                   = 19;
@@ -192,6 +193,7 @@ public:
         void plotSig(TString var="misc.PseudoJetMT2", TString cuts="misc.HBHENoiseFlag == 1", TString xtitle="MT2 [GeV]", 
 		     int nbins=50, double min=0., double max=1., bool cleaned=false, int type=0 ); // 0: s/sqrt(b), 1: s/sqrt(s+b), 3:s/b
   	void PrintCutFlow(int njets=-2, int nleps=0, TString trigger="", TString cuts="");
+	void PrintCompiledCutFlow(TString cuts, int njets=-2, int nleps=0, TString HLT="");
         void FillMonitor(Monitor *count, TString sname, TString type, TString cut, double weight);
 	void PrintZllEfficiency(int sample_index, bool data, std::string lept, Long64_t nevents, double lower_mass, double upper_mass, bool pileup_weight);
 	void PrintWEfficiency(int sample_index ,TString process, std::string lept, Long64_t nevents, bool includeTaus);
@@ -202,6 +204,17 @@ public:
 		      TString upper_cut="misc.MinMetJetDPhi<0.2", TString lower_cut="misc.MinMetJetDPhi>0.3", 
 		      const int nbins=gNMT2bins, const double *bins=gMT2bins, double fit_min=40., double fit_max=100.);
 
+	// Plot book: the MakePlot, CompSamples and plotSig histograms booked here
+	// are filled by FillBookedPlots, all plots of a sample in a single pass
+	// over it. The plotting functions then use them instead of drawing the
+	// tree again
+	void BookPlot(TString var, TString cuts, int njets, int nleps, TString HLT, const int nbins, const double *bins);
+	void BookPlot(TString var, TString cuts, int njets, int nleps, TString HLT, const int nbins, const double min, const double max);
+	void BookCompSamples(TString var, TString cuts, TString optcut, bool RemoveLepts, const int nbins, const double *bins, double scale_factor);
+	void BookPlotSig(TString var, TString cuts, int nbins, double min, double max);
+	void FillBookedPlots();
+	void ClearBookedPlots();
+
 	void CompSamples(TString var, TString cuts, TString optcut, bool RemoveLepts, TString xtitle, 
 			  const int nbins, const double *bins, bool add_underflow, bool logflag, double scale_factor, bool normalize);
 	void compSamples(TString var, TString cuts, TString optcut,  bool RemoveLepts, TString xtitle, 
@@ -217,6 +230,25 @@ private:
 	MT2tree* fMT2tree;
 	TTree*   fTree;
 
+	struct bookedplot{
+		TTree  *tree;  // of the sample
+		TString sname; // sample name
+		TString var;
+		TString cuts;
+		TString weight;
+		std::vector<double> bins;
+		TH1D   *histo; // 0 until filled
+	};
+	std::vector<bookedplot> fBookedPlots;
+
+	TString GetPlotCuts(const sample &Sample, TString cuts, int njets, int nleps, TString HLT);
+	TString GetSampleWeight(const sample &Sample, double scale_factor = 1.);
+	TString GetPlotSigWeight(const sample &Sample);
+	void    GetCompSamplesPlot(const sample &Sample, TString var, TString cuts, TString optcut, bool RemoveLepts, double scale_factor,
+	                           TString &variable, TString &theCuts, TString &weight);
+	void    BookSamplePlot(const sample &Sample, TString var, TString theCuts, TString weight, const int nbins, const double *bins);
+	TH1D*   GetBookedHisto(const sample &Sample, TString var, TString theCuts, TString weight, const int nbins, const double *bins);
+
 
         void MakeMT2PredictionAndPlots(bool cleaned , double dPhisplit[], double fudgefactor);
         void PrintABCDPredictions(TString var, TString basecut, TString upper_cut, TString lower_cut, TF1* func_qcd, TF1* func_sub, TF1* func_qcd_model);
@@ -73,6 +73,7 @@ public:
   const bool passEMuTriggers(int);
   const bool passMuTriggers(int);
   const bool passAnyMT2Trigger();
+  void AddTriggerMenus();
   const bool IsGoodBasicPFJetPAT3(int, double, double);
   void setInfo();
   string outputFileName_; // public name of the output file name
@@ -89,6 +90,9 @@ private:
   enum counters_t { count_begin, EV=count_begin, TR, MU, EL, JE, PJ, count_end };
   Monitor counters[count_end];
 
+  int fElTriggers[2], fMuTriggers[2], fEMuTriggers[2]; // trigger menus for JZB and same sign
+  int fMT2Triggers;
+
   vector<t_lepton> selectLeptons(vector<t_lepton>&); 
   vector<t_lepton> sortLeptonsByPt(vector<t_lepton>& ); 
   
@@ -1,8 +1,16 @@
+#ifndef SFlightFuncs_EPS2013_hh
+#define SFlightFuncs_EPS2013_hh
+
 #include "TF1.h"
 #include "TLegend.h"
 #include <TCanvas.h>
+#include "helper/BTagSF.hh"
 
 TF1* GetSFLight(TString meanminmax, TString tagger, TString TaggerStrength, Float_t Etamin, Float_t Etamax, TString DataPeriod);
 TF1* GetSFlmean(TString tagger, TString TaggerStrength, float Etamin, float Etamax, TString DataPeriod);
 TF1* GetSFlmin(TString tagger, TString TaggerStrength, float Etamin, float Etamax, TString DataPeriod);
 TF1* GetSFlmax(TString tagger, TString TaggerStrength, float Etamin, float Etamax, TString DataPeriod);
+// Compiled parametrisation for mean, min and max, NULL if not tabulated
+const BTagSF::SFLightPar* GetSFLightPar(TString tagger, TString TaggerStrength, Float_t Etamin, Float_t Etamax, TString DataPeriod);
+
+#endif
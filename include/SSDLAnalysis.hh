@@ -57,10 +57,13 @@ public:
 	double corrElIso(int);
 	
 	const bool AddBranch(const char* name, const char* type, void* address, const char* size = 0);
+	// Adds the counters of a worker of a parallel job
+	inline void AddCounters(const SSDLAnalysis& other){ fCounter.add(other.fCounter); };
 
 	struct HLTPathSet{
 		TString name;
-		vector<string> paths;
+		vector<string> paths; // names or patterns, e.g. HLT_Mu17_Mu8_v*
+		int menu;             // trigger menu of the paths, see UserAnalysisBase
 	};
 
 private:
@@ -69,6 +72,7 @@ private:
 	
 	Monitor fCounter;
 	string fCutnames[4];
+	Monitor::Handle fCuts[4];
 
 	static const int fMaxNjets = 40;
 	static const int fMaxNmus  = 5;
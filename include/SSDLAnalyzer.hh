@@ -11,6 +11,8 @@ class SSDLAnalyzer : public TreeAnalyzerBase {
 public:
 	// test mar14 SSDLAnalyzer(std::vector<std::string>& fileList);
 	SSDLAnalyzer(std::vector<std::string>& fileList, bool isdata, string globaltag="");
+	// Worker for parallel running, on a part of the files of master
+	SSDLAnalyzer(std::vector<std::string>& fileList, const SSDLAnalyzer *master);
 	// MARC SSDLAnalyzer(TTree *tree = 0);
 	virtual ~SSDLAnalyzer();
 	void BeginJob	();
@@ -22,9 +24,16 @@ public:
 	inline void SetPtHatCut(float cut){fPtHatCut = cut;};
 	inline void DoFillEffTree(bool fill){fDoFillEffTree = fill;};
 
+	TreeAnalyzerBase* MakeWorker(std::vector<std::string>& fileList, const TString& outputFile);
+	void MergeWorker(TreeAnalyzerBase *worker);
+
 private:
 	SSDLAnalysis	*fSSDLAnalysis;
 	float fPtHatCut;
 	bool fDoFillEffTree;
+	string fGlobalTag;
+	bool   fUsePUFiles;  // BeginJob with PU distribution files
+	string fDataPUFile;
+	string fMCPUFile;
 };
 #endif
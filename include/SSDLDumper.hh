@@ -11,6 +11,7 @@
 //#include "helper/BTagSFUtil/BTagSFUtil.h"
 #include "helper/BTagSF.hh"
 #include "helper/GoodRunList.h"
+#include "helper/MT2Calculator.hh"
 
 #include "TRandom3.h"
 #include "TLorentzVector.h"
@@ -24,6 +25,8 @@
 
 using namespace std;
 
+class TMutex;
+
 class SSDLDumper : public AnaClass{
 
 public:
@@ -440,6 +443,37 @@ public:
 		TH1D *hnt2_os_EE[gNDiffVars];
 	};
 
+	// Lepton pair of one channel and sign, selected once per event for all
+	// regions with the same lepton selection (see fillRegionYields)
+	static const int gNYieldHyps = 5; // SS mm, SS ee, SS em, OS ee, OS em
+	struct HypObs{
+		int   njets;
+		int   nbjets;
+		int   nbjmed;
+		float ht;
+		float met;
+	};
+	struct LepHyp{
+		int    nlep1;   // loose leptons: muons for mm and em, electrons for ee
+		int    nlep2;   // loose electrons for em
+		int    ind1;
+		int    ind2;
+		int    pair;    // isSSLLEvent/isOSLLEvent, the sign is the charge
+		bool   zveto;
+		bool   lowmass; // low mass and gamma* vetoes
+		bool   veto3rd; // passes3rdLepVeto
+		bool   ttzsel;  // passesTTZSel
+		float  weight;
+		HypObs obs;
+		HypObs obsTTZ;  // after passesTTZSel, which moves the hyp leptons
+	};
+	struct RegionGroup{
+		std::vector<int> regions;
+		bool need3rdVet;
+		bool needTTZSel;
+		LepHyp hyp[gNYieldHyps];
+	};
+
 	static const int gNKinSels = 3;
 	static TString gKinSelNames[gNKinSels];
 	static TString gEMULabel[2];
@@ -673,6 +707,7 @@ public:
 	};
 
 	SSDLDumper(TString configfile = "dumperconfig.cfg");
+	SSDLDumper(const SSDLDumper *master); // worker clone for parallel running
 	virtual ~SSDLDumper();
 
 	virtual void init();
@@ -682,7 +717,17 @@ public:
 	virtual void readDatacard(TString); // read in a datacard
 
 	virtual void loop();              // loop on all samples if several
+	virtual void loopSamplesParallel(); // same, fNJobs samples at a time, largest first
+	virtual void runSample(Sample*);  // set up per-sample state and call loopEvents
 	virtual void loopEvents(Sample*); // perform loop on single sample
+	virtual void processEntries(Sample*, Long64_t, Long64_t); // event loop on [first, last) of the current tree
+	virtual void processEntriesParallel(Sample*, Long64_t);   // split [0, nentries) over fNThreads workers
+	virtual void beginShard(Sample*);  // worker: book shard histos, open own copy of the tree
+	virtual void mergeShard(Sample*, SSDLDumper*, Sample*); // master: add shard results to sample
+	void mergeHistos(Sample*, Sample*);
+	void seedRandoms(); // worker: event-keyed seeds, independent of the number of threads
+	inline void setNThreads(int n){ fNThreads = n; };
+	inline void setNJobs(int n){ fNJobs = n; };
 	
         /////////////////////////
         bool IsInJSON();
@@ -691,6 +736,7 @@ public:
 	
 	// Cutflow
 	void initCutNames();
+	void resetCounters();
 	void initCounters();
 	void fillCutFlowHistos(Sample*);
 	void printCutFlow(gChannel, gSample, gSample);
@@ -703,6 +749,13 @@ public:
 	void resetSigEventTree();
 	// old void fillYields(Sample*, gRegion);
 	void fillYields(Sample*, int);
+	void fillSSYields(Sample*, int, gChannel, int, int);
+	void fillOSYields(Sample*, int, gChannel, int, int);
+	void makeRegionGroups();
+	void fillRegionYields(Sample*);
+	void selectHyp(Sample*, LepHyp&, gChannel, bool, const RegionGroup&);
+	bool passesRegion(const LepHyp&, gChannel, bool, int, bool);
+	HypObs getHypObs();
 	void fillDiffYields(Sample*);
 	void fillDiffVar(Sample* S, int lep1, int lep2, float val, int bin, gChannel chan);
 	void fillDiffVarOS(Sample* S, int lep1, int lep2, float val, int bin, gChannel chan);
@@ -758,9 +811,11 @@ public:
 
 	// Event and Object selectors:
 	std::vector<int> cleanedJetIndices(float pt);
-	virtual void scaleBTags(Sample *S, int flag = 0, TString model = "");
+	virtual void scaleBTags(Sample *S, int flag = 0, BTagSF::SMSModel model = BTagSF::kFullSim);
 	virtual void saveBTags();
 	virtual void resetBTags();
+	virtual void saveEvent();
+	virtual void restoreEvent();
 	virtual void smearJetPts(Sample *S, int flag = 0);
 	virtual void scaleLeptons(Sample *S, int flag = 0);
 	virtual void smearMET(Sample *S);
@@ -791,6 +846,51 @@ public:
 	virtual int   getFarestJet(int, gChannel, float = 20.);
 	virtual float getAwayJetPt(int, gChannel);
 	virtual float getMaxJPt();
+
+	// Per-event memo of the jet observables above. isGoodJet is evaluated
+	// once per jet for every jet selection state (hyp leptons and the cuts
+	// it depends on), the observables built from it once per state and
+	// argument. The memo belongs to the entry of fChain it was made for and
+	// is dropped as soon as another entry or tree has been read, whoever
+	// called GetEntry. invalidateObsCache() drops it by hand, which is
+	// needed when the jets, leptons, b-tags or MET are modified.
+	enum ObsCacheKind {kObsGoodJets, kObsNJets, kObsHT, kObsNBTags, kObsNBTagsMed, kObsMaxJPt, kObsClosestJet, kObsAwayJetPt, kObsMT2, kNObsCache};
+	struct ObsMemo{
+		int   ind1;
+		int   ind2;
+		int   chan;
+		float cut;
+		float value;
+	};
+	struct JetSelCache{
+		int   hyptype[3];
+		int   hypindex[3];
+		float minJetPt;
+		float minMu2pt;
+		float minEl2pt;
+		std::vector<bool> good; // isGoodJet without pt cut
+		std::vector<std::pair<float, int> > njets; // (pt cut, getNJets)
+		bool  hasHT, hasNBTags, hasNBTagsMed, hasMaxJPt;
+		float ht;
+		float maxjpt;
+		int   nbtags;
+		int   nbtagsmed;
+		std::vector<ObsMemo> closest;
+		std::vector<ObsMemo> away;
+	};
+	void invalidateObsCache(){ fNJetSelCaches = 0; fMT2Memo.clear(); };
+	inline void checkObsCacheEntry(){
+		const Long64_t entry = fChain ? fChain->GetReadEntry() : -1;
+		if(fChain == fObsTree && entry == fObsEntry) return;
+		invalidateObsCache();
+		fObsTree  = fChain;
+		fObsEntry = entry;
+	};
+	JetSelCache& getJetSelCache();
+	inline bool isGoodJet(const JetSelCache &C, int jet, float pt = 20.){ return C.good[jet] && !(getJetPt(jet) < pt); };
+	void resetObsCacheStats();
+	void addObsCacheStats(const SSDLDumper *W);
+	void printObsCacheStats(TString);
 	virtual int getNTightMuons();
 	virtual int getNTightElectrons();
 	virtual float getTightPt(int=0);
@@ -815,6 +915,8 @@ public:
 
   	virtual bool passesHTCut(float, float = 8000.);
 	virtual bool passesMETCut(float = -1., float = 8000.);
+	bool passesHTCut(float min, float max, float ht);
+	bool passesMETCut(float min, float max, float met, float ht);
 	virtual bool passesZVeto(bool(SSDLDumper::*)(int), bool(SSDLDumper::*)(int), float = 15.); // cut with mZ +/- cut value and specified obj selectors
 	virtual bool passesZVeto(float = 15.); // cut with mZ +/- cut value
 	virtual bool passesZVetoNew(int l1, int l2, int toggle, float dm = 15.);
@@ -941,6 +1043,7 @@ public:
 	int   fC_vetoTTZSel; // ttZ veto
         int   fC_chargeVeto;
         int   fC_GStarVeto;
+	bool  fInvertZVeto; // set by setRegionCuts, per instance for the parallel loops
 	void resetHypLeptons();
 	void setHypLepton1(int, gChannel);
 	void setHypLepton2(int, gChannel);
@@ -948,6 +1051,18 @@ public:
 	lepton fHypLepton1;
 	lepton fHypLepton2;
 	lepton fHypLepton3;
+
+	std::vector<JetSelCache> fJetSelCaches; // entries [0, fNJetSelCaches) are valid
+	int                      fNJetSelCaches;
+	std::vector<ObsMemo>     fMT2Memo;
+	TTree                   *fObsTree;  // tree and entry of the memo
+	Long64_t                 fObsEntry;
+	Long64_t fObsCalls[kNObsCache];
+	Long64_t fObsHits [kNObsCache];
+
+	std::vector<RegionGroup> fRegionGroups;
+	std::vector<int>         fRegionGroupOf; // group of each region
+	std::vector<bool>        fRegionMask[gNYieldHyps]; // regions passed by each hyp
 	
 	// old void setRegionCuts(gRegion reg = Baseline);
 	void setRegionCuts(int reg);
@@ -968,6 +1083,9 @@ public:
 	vector<string> fMMCutNames;
 	vector<string> fEMCutNames;
 	vector<string> fEECutNames;
+	vector<Monitor::Handle> fMMCuts; // counter handles of the cut names, see initCounters
+	vector<Monitor::Handle> fEMCuts;
+	vector<Monitor::Handle> fEECuts;
 	bool fDoCounting;
 	gSample fCurrentSample;
 	gChannel fCurrentChannel;
@@ -1055,6 +1173,12 @@ public:
 	vector<float> fSigEv_HI_EM_MET;
 	
 	vector<float> fSaved_Tags;
+	vector<float> fSaved_JetPt;   // snapshot of the unmodified event, see saveEvent
+	vector<float> fSaved_RawTags;
+	vector<float> fSaved_MuPt;
+	vector<float> fSaved_ElPt;
+	float         fSaved_pfMET;
+	float         fSaved_pfMETType1;
 	
 	TFile *fStorageFile;
 	TString fOutputFileName;
@@ -1065,6 +1189,7 @@ public:
         GoodRunList *fGoodRunList;
 	TRandom3 *fRand3;
 	TRandom3 *fRand3Normal;
+	MT2Calculator fMT2Calc; // one per worker
 
 	// FOR THE BDT
 	// ---------------------------------------
@@ -1094,6 +1219,13 @@ public:
         bool skipLumi;
         bool skipRun;
 	bool isTChiSlepSnu;
+
+	int fNThreads;     // number of worker threads per sample (<= 1: serial)
+	int fNJobs;        // number of samples processed concurrently by loop()
+	int fWorkerIndex;  // -1 for the master, shard index for workers
+	bool fShowProgress;
+	TMutex *fIOMutex;  // serializes file I/O and booking of concurrent jobs, NULL if single job
+	TString fOUTSTREAMName; // name of fOUTSTREAM file of a worker shard
 	private:
 	
 	Monitor fCounter[3];	
@@ -1103,6 +1235,8 @@ public:
 	vector<string> fSyncCutNames;
 	vector<string> fPuritiesCutNames;
 	vector<string> fWZCutNames;
+	vector<Monitor::Handle> fSyncCuts;
+	vector<Monitor::Handle> fPuritiesCuts;
 };
 
 #endif
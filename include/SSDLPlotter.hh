@@ -8,9 +8,12 @@
 
 #include "SSDLDumper.hh"
 #include "helper/Monitor.hh"
+#include "helper/SigEventTable.hh"
+#include "helper/YieldGrid.hh"
 
 #include "TLorentzVector.h"
 
+class FakeRatios;
 
 
 struct SSDLPrediction {
@@ -258,14 +261,19 @@ public:
 	static float gEETrigScale;
 
 	bool fDO_OPT;
+	bool fFRToys; // toys instead of error propagation for the fake ratio systematics
 
 	SSDLPlotter(TString);
 	SSDLPlotter(TString, TString);
+	SSDLPlotter(const SSDLPlotter*); // worker clone for the signal scans
 	virtual ~SSDLPlotter();
 	
 	static void showStatusBar(int, int, int = 100, bool = false, bool = true);
 
 	virtual void init(TString filename = "samples.dat");
+	inline void setFRToys(bool b){ fFRToys = b; };
+	FakeRatios* newFakeRatios(); // with the systematics mode set, see fFRToys
+	SigEventTable* getSigEvents(); // SigEvents tree of fOutputFileName, read once
 	virtual void doSMSscans(TString, TString, TString);
 	virtual void doAnalysis();
 	virtual void sandBox();
@@ -277,7 +285,14 @@ public:
 	virtual void msugraNLOxsecs(TFile *);
 	virtual void scanMSUGRA(const char * filestring);
 	virtual void scanSMS( const char * filestring, int);
+	struct SMSJob; // one worker of scanSMS
+	void scanSMSEntries(SMSJob*);
+	void scanSMSFill(SMSJob*, int, int, double*);
 	virtual void scanModelGeneric( const char * filestring, int, TString,  bool = false);
+	virtual void scanModelGeneric( const char * filestring, vector<int>, TString, bool = false); // all regions in one pass
+	struct ScanJob; // one worker of scanModelGeneric
+	void scanModelEntries(ScanJob*);
+	void scanModelFill(ScanJob*, int, int, float, float, double*);
 	// old virtual void scanSMS( const char * filestring, gRegion);
 	// virtual void scanSMSEWKpaper( const char * filestring, float minHT, float maxHT, float minMET, float maxMET, float pt1, float pt2, bool pass3rdVeto);
 	virtual void plotWeightedHT();
@@ -339,6 +354,22 @@ public:
 //	void makeTTWDiffPredictionSigEvent(TString, int, double*);
 	void makeTTWDiffPredictionSigEvent(vector<TString>, vector<int>, vector<double*>, vector<TString>, vector<TString>, int = -1, int = 0, int = 0);
 	TTWZPrediction makePredictionSignalEvents(float minHT, float maxHT, float minMET, float maxMET, int minNjets, int minNbjetsL, int minNbjetsM, float pT1=20., float pT2=10., int chVeto = 0, bool ttw=false, int flag=0);
+	// Cumulative yield grid for the cut optimizations (see helper/YieldGrid.hh):
+	// the yields of makePredictionSignalEvents for every cut point of the grid,
+	// with gNCHANNELS*gNTTWGridYields slots, slot = chan*gNTTWGridYields + yield
+	enum gTTWGridYield {
+		TTWGridObs, TTWGridFake, TTWGridFake2, TTWGridOSBB, TTWGridOSEB, TTWGridOSEE,
+		TTWGridRare, TTWGridRare2, TTWGridWZ, TTWGridWZ2, TTWGridTTZ, TTWGridTTZ2, TTWGridTTW, TTWGridTTW2,
+		gNTTWGridYields
+	};
+	bool fillTTWYieldGrid(YieldGrid &grid, int chVeto = 0, int flag = 0); // axes: any of HT, MET, NJ, NbJ, NbJmed, pT1, pT2
+	TTWZPrediction getTTWPrediction(const YieldGrid &grid, Long64_t cut, FakeRatios *FR, bool ttw = true);
+	// Booked and filled grid with the thresholds of HT, MET, NJ, NbJ, NbJmed, pT1, pT2, 0 on failure
+	YieldGrid* makeTTWYieldGrid(const vector<vector<double> > &thresholds, int chVeto = 0, int flag = 0);
+	// Best ZBi per 10% signal efficiency step on a grid of makeTTWYieldGrid,
+	// written to outputdir/ZBiGridScan.txt and outputdir/gridcuts_Seff*.txt
+	void scanTTWYieldGrid(const YieldGrid &grid, float lumi, float lumiSF_fake, TString outputdir, float (*computeZBi)(float, float, float), int chVeto = 0);
+	void getTTWZBiInputs(const TTWZPrediction &pred, float lumiSF, float lumiSF_fake, float &b, float &b_err, float &s);
 	void makeTTWKinPlotsSigEvent();
 	void makeTTWKinPlotSigEvent(vector<TString>, vector<int>, vector<double>, vector<double>, vector<TString>, vector<TString>, int = -1, int = 0);
 	void makeTTWKinPlotSigEvent(TString, int, double*, TString = "", TString = "", int = -1, int = 0);
@@ -474,6 +505,7 @@ public:
 	vector<int> fDYJets;
 
 	TLatex *fLatex;
+	SigEventTable *fSigEvents;
 	
 	float fLumiNorm;      // Normalize everything to this luminosity
 	float fBinWidthScale; // Normalize bin contents to this width
@@ -35,6 +35,11 @@ using namespace std;
 //
 // The class SolveTTbarNew contains one function attempting to find the minimum of the discriminant using root minimizers
 //  -NumericalMinimization
+// and a version for all b-jet pairings of an event
+//  -MinimizePairings
+//
+// The minimizer is created once per solver and reused for all
+// minimizations, use one solver per thread.
 //
 // ************************************************************
 
@@ -54,6 +59,19 @@ virtual bool GetEquationParameters(double pb1[], double pb2[], double pl1[], dou
 //same as equation put parameters p and free variables x in a global variable xglob
 double EquationGlob(const double *xglob);
 
+//same as equation with the fixed parameters of the current minimization, fPar
+double EquationPar(const double *x);
+
+// minimizer for minName/algoName, created at the first call
+ROOT::Math::Minimizer* GetMinimizer(const char *minName, const char *algoName);
+
+// one minimization starting from q1z, q2z, the fixed parameters are in fPar
+double Minimize(int &statuss, double &edm, double &q1z, double &q2z, const char *minName, const char *algoName);
+
+// not copyable, the functor points to this
+SolveTTbarNew (const SolveTTbarNew&);
+SolveTTbarNew& operator= (const SolveTTbarNew&);
+
 // Solves the constraint equations and returns a discriminant of type D2
 virtual double Equation(double *x, double *p);
 
@@ -69,6 +87,20 @@ double discconverge;
 double qz1min, qz2min;
 int status;
 
+// minimizer, reused for all minimizations
+ROOT::Math::Minimizer *fMinimizer;
+ROOT::Math::Functor fFunctor;
+std::string fMinName, fAlgoName;
+double fPar[18];
+double fTolerance;
+unsigned int fMaxCalls;
+bool fWarmStart;
+
+// convergence statistics
+long fNMin, fNConverged, fNCalls;
+unsigned int fMaxNCalls;
+double fSumEdm;
+
 public:
 
 // Constructor
@@ -82,6 +114,48 @@ SolveTTbarNew ();
 // by some in root defined minimizers compute the discriminator
 double NumericalMinimization(int &statuss, double &edm, double &q1z, double&q2z, double pb1[], double pb2[], double pl1[], double pl2[], double pTm[], const char * minName = "Minuit2", const char *algoName = "" , int randomSeed = -1);
 
+// Result of the minimization for one pairing
+struct D2Result {
+	double d2;
+	double edm;
+	double q1z, q2z;
+	int status;
+	unsigned int ncalls;
+};
+
+// Compute the discriminator for npairs b-jet pairings (pb1[i], pb2[i]) with the same leptons and MET
+// in one call. With warm start (default), each pairing starts from the solution of the previous one
+// if that converged, the first one from q1z = q2z = 0.
+void MinimizePairings(int npairs, double pb1[][4], double pb2[][4], double pl1[], double pl2[], double pTm[], D2Result res[], const char * minName = "Minuit2", const char *algoName = "");
+
+// Minimizer settings (defaults: tolerance 0.001, 1000000 calls, warm start)
+void SetTolerance (double tol) {
+	fTolerance = tol;
+}
+void SetMaxFunctionCalls (unsigned int n) {
+	fMaxCalls = n;
+}
+void SetWarmStart (bool ws) {
+	fWarmStart = ws;
+}
+
+// Convergence statistics of all minimizations so far
+long GetNMinimizations (void) {
+	return fNMin;
+}
+// fraction with status 0
+double GetConvergedFraction (void) {
+	return fNMin > 0 ? double(fNConverged)/fNMin : 0.;
+}
+double GetMeanNCalls (void) {
+	return fNMin > 0 ? double(fNCalls)/fNMin : 0.;
+}
+double GetMeanEdm (void) {
+	return fNMin > 0 ? fSumEdm/fNMin : 0.;
+}
+void ResetStatistics (void);
+void PrintStatistics (void);
+
 // Setting constants *************************************
 
 // Set the debug flag
@@ -0,0 +1,98 @@
+#ifndef LazyBranch_hh
+#define LazyBranch_hh
+
+//
+// Lazily loaded ntuple product, used for the event leaves of the
+// generated TreeClassBase.
+//
+// The product is only fetched from the event ("getByLabel") the first time
+// it is accessed after Reset(), i.e. once per event and only for the
+// branches the analysis actually reads. The proxy converts to a const
+// reference to the product, so that the usual fTR->NJets, fTR->JPt[i]
+// and fTR->JPt.size() keep working.
+//
+
+#include <string>
+#include <vector>
+
+#include "DataFormats/FWLite/interface/Handle.h"
+#include "DataFormats/FWLite/interface/ChainEvent.h"
+
+class LazyBranchBase {
+public:
+  LazyBranchBase() : fEvent(0), fLoaded(false), fValid(false), fNLoads(0) {}
+  virtual ~LazyBranchBase() {}
+
+  void Setup(const edm::EventBase* event, const edm::InputTag& tag, const std::string& name) {
+    fEvent = event; fTag = tag; fName = name;
+  }
+
+  // Forget the current product: it will be fetched again on next access
+  inline void Reset() { fLoaded = false; }
+  // Fetch the product if not done yet for this event
+  // Returns false if the product is not available
+  inline const bool Load() const {
+    if ( fLoaded ) return fValid;
+    fLoaded = true;
+    ++fNLoads;
+    fValid  = Fetch();
+    return fValid;
+  }
+
+  inline const std::string& Name() const { return fName; }
+  inline const Long64_t NLoads() const { return fNLoads; } // number of events it was read in
+  inline void AddLoads(Long64_t n) { fNLoads += n; }
+
+protected:
+  virtual const bool Fetch() const = 0;
+
+  const edm::EventBase* fEvent;
+  edm::InputTag fTag;
+  std::string fName;
+
+  mutable bool fLoaded;
+  mutable bool fValid;
+  mutable Long64_t fNLoads;
+};
+
+// Element access for vector products
+template <class T> struct LazyBranchTraits {
+  typedef const T& const_reference;
+};
+template <class E> struct LazyBranchTraits<std::vector<E> > {
+  typedef typename std::vector<E>::const_reference const_reference;
+};
+
+template <class T> class LazyBranch : public LazyBranchBase {
+public:
+  typedef typename LazyBranchTraits<T>::const_reference const_reference;
+
+  inline const T& operator()() const { Load(); return fValue; }
+  inline operator const T&() const { return (*this)(); }
+
+  // Only for vector products
+  inline const_reference operator[](size_t i) const { return (*this)()[i]; }
+  inline size_t size() const { return (*this)().size(); }
+
+  // Overwrite the value for this event (e.g. in cleaning)
+  LazyBranch& operator=(const T& value) {
+    fValue  = value;
+    fLoaded = true;
+    fValid  = true;
+    return *this;
+  }
+
+protected:
+  // Missing products are reset to their default value
+  virtual const bool Fetch() const {
+    fEvent->getByLabel(fTag, fHandle);
+    if ( fHandle.isValid() ) fValue = *fHandle;
+    else fValue = T();
+    return fHandle.isValid();
+  }
+
+  mutable T fValue;
+  mutable edm::Handle<T> fHandle;
+};
+
+#endif
@@ -0,0 +1,163 @@
+#ifndef ObjectSelection_hh
+#define ObjectSelection_hh
+
+//
+// Batch object selection kernels used by UserAnalysisBase.
+//
+// Each kernel evaluates one ID for all objects of the event at once and
+// fills a mask with one entry per object (1 = selected). The cut values
+// are static members of the ID structs below, i.e. compile-time constants,
+// and all cuts of an object are combined without branching, so that the
+// loops can be vectorized.
+//
+// The cuts are written exactly as in the per-object selectors of
+// UserAnalysisBase (IsGoodBasicPFJet, IsGoodBasicMu, IsGoodElId_MediumWP,
+// ...): "if (x > cut) return false" becomes "!(x > cut)". Keep them in
+// sync when changing either.
+//
+
+#include <vector>
+#include <cmath>
+#include <limits>
+
+typedef std::vector<unsigned char> ObjectMask;
+
+namespace ObjSel {
+
+	inline double NoCut() { return std::numeric_limits<double>::infinity(); }
+
+	//__________________________________________________________________________
+	// PF jet ID working points: the loose cuts are always applied,
+	// medium and tight tighten the neutral fractions
+	struct PFJetLoose  { static double NeutralFracMax() { return 0.99; } };
+	struct PFJetMedium { static double NeutralFracMax() { return 0.95; } };
+	struct PFJetTight  { static double NeutralFracMax() { return 0.90; } };
+
+	template <class ID, class V1, class V2, class V3, class V4, class V5, class V6, class V7, class V8>
+	inline void PFJetKernel(ObjectMask& mask, int n, double ptcut, double absetacut,
+	                        const V1& pt, const V2& eta, const V3& nconst,
+	                        const V4& nemfrac, const V5& nhadfrac, const V6& chemfrac,
+	                        const V7& chhadfrac, const V8& nassotracks){
+		mask.resize(n);
+		for(int i = 0; i < n; ++i){
+			const bool central = fabs(eta[i]) < 2.4; // charged cuts only within tracker
+			mask[i] = !(pt[i] < ptcut) & !(fabs(eta[i]) > absetacut)
+			        & (nconst[i] > 1)
+			        & (nemfrac[i]  < ID::NeutralFracMax())
+			        & (nhadfrac[i] < ID::NeutralFracMax())
+			        & ((!central) | ((chemfrac[i] < 0.99) & (chhadfrac[i] > 0.00) & (nassotracks[i] > 0)));
+		}
+	}
+
+	//__________________________________________________________________________
+	// Muon PF isolation, as UserAnalysisBase::MuPFIso
+	template <class V1, class V2, class V3, class V4, class V5>
+	inline void MuPFIsoKernel(std::vector<float>& iso, int n, const V1& chhad, const V2& nehad,
+	                          const V3& photon, const V4& sumpupt, const V5& pt){
+		iso.resize(n);
+		for(int i = 0; i < n; ++i){
+			double neutral = (nehad[i] + photon[i] - 0.5*sumpupt[i]);
+			iso[i] = ( chhad[i] + (0. >= neutral ? 0. : neutral) ) / pt[i]; // TMath::Max(0., neutral)
+		}
+	}
+
+	//__________________________________________________________________________
+	// Muons as IsMostBasicMu (loose isolation, global or tracker, PF)
+	template <class V1, class V2, class V3, class V4, class V5>
+	inline void MostBasicMuKernel(ObjectMask& mask, int n, const std::vector<float>& iso,
+	                              const V1& pt, const V2& eta, const V3& isglobal,
+	                              const V4& istracker, const V5& ispf){
+		mask.resize(n);
+		for(int i = 0; i < n; ++i){
+			mask[i] = !(iso[i] > 1.0) & !((isglobal[i] == 0) & (istracker[i] == 0)) & (ispf[i] != 0)
+			        & !(pt[i] < 5.) & !(fabs(eta[i]) > 2.4);
+		}
+	}
+
+	//__________________________________________________________________________
+	// Muon IDs with the IsGoodBasicMu cuts, differing in isolation
+	struct GoodBasicMu { static double IsoMax() { return 1.00; } }; // also IsLooseMu
+	struct TightMu     { static double IsoMax() { return 0.15; } };
+
+	template <class ID, class V1, class V2, class V3, class V4, class V5, class V6, class V7,
+	          class V8, class V9, class V10, class V11>
+	inline void MuonKernel(ObjectMask& mask, int n, const std::vector<float>& iso,
+	                       const V1& pt, const V2& eta, const V3& isglobal, const V4& ispf,
+	                       const V5& nchi2, const V6& nsilayers, const V7& npxhits, const V8& nglmuhits,
+	                       const V9& nmatchedstations, const V10& d0, const V11& dz){
+		mask.resize(n);
+		const bool hasStations = nmatchedstations.size() > 0;
+		for(int i = 0; i < n; ++i){
+			mask[i] = (isglobal[i] != 0) & (ispf[i] != 0)
+			        & !(pt[i] < 5) & !(fabs(eta[i]) > 2.4)
+			        & !(nchi2[i] > 10) & !(nsilayers[i] < 6) & !(npxhits[i] < 1) & !(nglmuhits[i] < 1)
+			        & ((!hasStations) | !(nmatchedstations[i] < 2))
+			        & !(fabs(d0[i]) > 0.02) & !(fabs(dz[i]) > 0.10)
+			        & !(iso[i] > 1.0) & !(iso[i] > ID::IsoMax());
+		}
+	}
+
+	//__________________________________________________________________________
+	// Electron IDs: barrel (|eta| < 1.479) and endcap (|eta| > 1.479) cuts
+	// on sigma_ietaieta, dphi_in, deta_in, H/E in ElectronKernel, then the
+	// impact parameters in ElectronIPKernel and |1/E-1/p| and conversion
+	// rejection in ElectronTrackKernel. The last two only tighten the mask
+	// and are only called for the IDs which cut on them, such that the
+	// branches of cuts an ID does not apply are not read
+	struct GoodBasicEl { // veto WP
+		static double SieieB() { return 0.01;  } static double DPhiB() { return 0.80; } static double DEtaB() { return 0.007; } static double HoEB() { return 0.15;  }
+		static double SieieE() { return 0.03;  } static double DPhiE() { return 0.70; } static double DEtaE() { return 0.01;  } static double HoEE() { return NoCut(); }
+		static double D0Max()  { return 0.04;  } static double DzMax() { return 0.20; }
+	};
+	struct GoodTriggerEl {
+		static double SieieB() { return 0.011; } static double DPhiB() { return 0.15; } static double DEtaB() { return 0.01;  } static double HoEB() { return 0.10;  }
+		static double SieieE() { return 0.031; } static double DPhiE() { return 0.10; } static double DEtaE() { return 0.01;  } static double HoEE() { return 0.075; }
+	};
+	struct ElId_LooseWP { // WP90
+		static double SieieB() { return 0.01;  } static double DPhiB() { return 0.15; } static double DEtaB() { return 0.007; } static double HoEB() { return 0.12;  }
+		static double SieieE() { return 0.03;  } static double DPhiE() { return 0.10; } static double DEtaE() { return 0.009; } static double HoEE() { return 0.10;  }
+		static double D0Max()  { return 0.02;  } static double DzMax() { return 0.20; }
+		static double EPMax()  { return 0.05;  } static double MissingHitsMax() { return 1; }
+	};
+	struct ElId_MediumWP { // WP80
+		static double SieieB() { return 0.01;  } static double DPhiB() { return 0.06; } static double DEtaB() { return 0.004; } static double HoEB() { return 0.10;  }
+		static double SieieE() { return 0.03;  } static double DPhiE() { return 0.03; } static double DEtaE() { return 0.007; } static double HoEE() { return 0.075; }
+		static double D0Max()  { return 0.02;  } static double DzMax() { return 0.10; }
+		static double EPMax()  { return 0.05;  } static double MissingHitsMax() { return 0; }
+	};
+
+	template <class ID, class V1, class V2, class V3, class V4, class V5>
+	inline void ElectronKernel(ObjectMask& mask, int n, const V1& eta, const V2& sieie,
+	                           const V3& dphi, const V4& deta, const V5& hoe){
+		mask.resize(n);
+		for(int i = 0; i < n; ++i){
+			const bool barrel = fabs(eta[i]) < 1.479;
+			const bool endcap = fabs(eta[i]) > 1.479;
+			const bool passB = !(sieie[i] > ID::SieieB()) & !(fabs(dphi[i]) > ID::DPhiB())
+			                 & !(fabs(deta[i]) > ID::DEtaB()) & !(hoe[i] > ID::HoEB());
+			const bool passE = !(sieie[i] > ID::SieieE()) & !(fabs(dphi[i]) > ID::DPhiE())
+			                 & !(fabs(deta[i]) > ID::DEtaE()) & !(hoe[i] > ID::HoEE());
+			mask[i] = ((!barrel) | passB) & ((!endcap) | passE);
+		}
+	}
+
+	template <class ID, class V1, class V2>
+	inline void ElectronIPKernel(ObjectMask& mask, int n, const V1& d0, const V2& dz){
+		for(int i = 0; i < n; ++i){
+			mask[i] &= !(fabs(d0[i]) > ID::D0Max()) & !(fabs(dz[i]) > ID::DzMax());
+		}
+	}
+
+	template <class ID, class V1, class V2, class V3, class V4>
+	inline void ElectronTrackKernel(ObjectMask& mask, int n, const V1& caloenergy, const V2& esuperclusteroverp,
+	                                const V3& missinghits, const V4& convveto){
+		for(int i = 0; i < n; ++i){
+			mask[i] &= !(fabs(1/caloenergy[i] - esuperclusteroverp[i]/caloenergy[i]) > ID::EPMax())
+			         & !(missinghits[i] > ID::MissingHitsMax())
+			         & (convveto[i] != 0);
+		}
+	}
+
+}
+
+#endif
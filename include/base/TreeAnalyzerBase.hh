@@ -4,15 +4,28 @@
 #include <TString.h>
 #include "TreeReader.hh"
 #include "helper/Utilities.hh"
+#include "helper/GoodRunList.h"
 #include <vector>
 #include <string>
 
 // FWLite includes
 #include "DataFormats/FWLite/interface/Event.h"
 
+//
+// Parallel running (SetNThreads(n) with n > 1, for drivers which implement
+// MakeWorker): the entries are split in n contiguous ranges, each run by a
+// worker on the files holding it (a large file is shared by several
+// workers). A worker is a driver of the same class with its own TreeReader
+// and analysis, writing its own part of the output. LoopParallel() runs their Loop() in
+// threads, then ends them on the main thread and adds their counters and
+// branch reports to this driver with MergeWorker(). MergeOutputs() adds the
+// part files into the output file once the driver's own output is closed.
+//
 class TreeAnalyzerBase {
 public:
     TreeAnalyzerBase(std::vector<std::string>& fileList);
+    // Worker for a part of the files, with the settings of master
+    TreeAnalyzerBase(std::vector<std::string>& fileList, const TreeAnalyzerBase *master);
     virtual ~TreeAnalyzerBase();
     virtual void BeginJob() {} // Method called before starting the event loop
     virtual void EndJob() {} // Method called after finishing the event loop
@@ -25,6 +38,14 @@ public:
 
     inline virtual void SetOutputDir(TString dir){ fOutputDir = Util::MakeOutputDir(dir); };
     inline virtual void SetOutputFile(TString file){ fOutputFile = file; };
+    inline virtual void SetNThreads(int n){ fNThreads = n; };
+
+    // Parallel running
+    const bool IsParallel() const;
+    virtual TreeAnalyzerBase* MakeWorker(std::vector<std::string>& fileList, const TString& outputFile){ return 0; }
+    virtual void MergeWorker(TreeAnalyzerBase *worker);
+    virtual void LoopParallel();
+    virtual void MergeOutputs(const TString& outputFile);
 	
     bool fIsData;
     TString fOutputDir;
@@ -32,6 +53,10 @@ public:
     int fVerbose;
     int fNEntries;
     Long64_t fMaxEvents;
+    int fNThreads;      // number of workers (<= 1: serial)
+    bool fShowProgress; // only one worker prints its progress
+    std::vector<std::string> fFileList;
+    std::vector<TString> fWorkerOutputs; // part files to be merged
   
 
     Int_t fCurRun;
@@ -43,12 +68,7 @@ public:
     virtual void ReadJSON(const char* JSONpath);
     virtual const bool CheckRunLumi(void) const;
     virtual const bool CheckRun(void) const;
-    struct RunLumi{
-        int run;
-        std::vector<int> lumi_min;
-        std::vector<int> lumi_max;
-    } fCurRunLumi; 
-    std::vector<RunLumi> fRunLumis;
+    GoodRunList fGoodRunList;
 
 
     TreeReader *fTR;
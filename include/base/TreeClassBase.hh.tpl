@@ -8,6 +8,8 @@
 
 #include "DataFormats/FWLite/interface/Handle.h"
 #include "DataFormats/FWLite/interface/ChainEvent.h"
+#include "base/LazyBranch.hh"
+#include <iostream>
     
 class TreeClassBase {
 public:
@@ -15,6 +17,15 @@ public:
     virtual ~TreeClassBase();
     virtual const bool GetAllByLabel(void);
 
+    // Event branches are fetched on first access (default)
+    // or all at once in GetAllByLabel
+    inline void SetLazy(bool lazy) { fLazy = lazy; }
+    // Report branches read at least once in this job
+    virtual void PrintBranchReport(std::ostream& os) const;
+    virtual void WriteBranchReport(const char* filename) const;
+    // Add the branches read by another reader on the same ntuples
+    virtual void AddBranchReport(const TreeClassBase& other);
+
     // Declaration of run leaf types
     <RUNLEAFDECLARATION>
 
@@ -23,7 +34,11 @@ public:
     
 protected:
     virtual void  Init();
+    void RegisterBranch(LazyBranchBase& branch, const edm::InputTag& tag, const char* name);
     Long64_t fCurRun;
+    bool fLazy;
+    Long64_t fNEventsLoaded;
+    std::vector<LazyBranchBase*> fBranches;
     fwlite::ChainEvent *fEvent;    
 
 };
@@ -13,7 +13,8 @@
     
 class TreeReader : public TreeClassBase {
 public:
-  TreeReader(const std::vector<std::string>& fileList) : TreeClassBase(fileList) {}
+  TreeReader(const std::vector<std::string>& fileList) : TreeClassBase(fileList),
+    fFirstEntry(0), fLastEntry(-1), fCurEntry(0) {}
   virtual ~TreeReader() {}
 
   // Load information
@@ -23,14 +24,24 @@ public:
   // Getters
   inline virtual const Long64_t GetEntries() const { return fEvent->size(); };
 
+  // Restrict the loop to the entries [first, last), last < 0: up to the end
+  inline virtual void SetEntryRange(const Long64_t first, const Long64_t last) {
+    fFirstEntry = first; fLastEntry = last;
+  }
+
   // Looping interface
   virtual const TreeReader& ToBegin();
-  inline virtual bool AtEnd() { return fEvent->atEnd(); }
+  inline virtual bool AtEnd() { return fEvent->atEnd() || (fLastEntry>=0 && fCurEntry>=fLastEntry); }
   virtual const TreeReader &operator++();
   inline virtual const bool CheckLoading() const {
     return (Run>0)&&(LumiSection>0)&&(Event>0); 
   }
 
+private:
+  Long64_t fFirstEntry;
+  Long64_t fLastEntry;
+  Long64_t fCurEntry; // current entry of the chain
+
     
 };
 
@@ -14,6 +14,7 @@
 #include "helper/LumiReweightingStandAlone.h"
 
 #include "TreeReader.hh"
+#include "ObjectSelection.hh"
 
 #include "CondFormats/JetMETObjects/interface/FactorizedJetCorrector.h"
 #include "CondFormats/JetMETObjects/interface/JetCorrectionUncertainty.h"
@@ -43,6 +44,16 @@ public:
     virtual bool GetHLTResult(string);
     virtual int GetHLTPrescale(string);
 
+    // Trigger menus: lists of HLT paths, given by name or by pattern with
+    // '*' and '?' (e.g. "HLT_Mu17_Mu8_v*"). They are resolved to the bits
+    // of the current HLT menu when it changes (GetHLTNames), per event only
+    // these bits are read.
+    virtual int AddTriggerMenu(const vector<string>&);
+    virtual void ResolveTriggerMenus();
+    inline const vector<int>& GetTriggerMenuBits(int menu) const { return fTriggerMenuBits[menu]; };
+    virtual bool GetTriggerMenuResult(int); // OR of the resolved paths
+    static bool MatchHLTName(const char* pattern, const char* name);
+
 	OnTheFlyCorrections * fMetCorrector;
     virtual std::pair<float , float > GetOnTheFlyCorrections();
 
@@ -64,6 +75,8 @@ public:
     map<int, pdgparticle> fPDGMap; // Mapping of PDG ID names
     map<string, int> fHLTLabelMap; // Mapping of HLT trigger bit names
     vector<string>   fHLTLabels;   // Vector with current HLT names
+    vector<vector<string> > fTriggerMenuPaths; // Trigger menus as given
+    vector<vector<int> >    fTriggerMenuBits;  // ... and their bits, in order of the paths
 	
 	virtual int getSusyMass(int, int=1);
 	virtual int   getNParticle(int, int=3);
@@ -113,6 +126,16 @@ public:
     virtual bool IsGoodElEvent();
     virtual bool IsGoodElFakesEvent();
     virtual bool IsGoodHadronicEvent();
+    // Batch selection: fill a mask with one entry per object of the event,
+    // with the cuts of the corresponding per-object selector
+    enum PFJetID    { kPFJetLoose, kPFJetMedium, kPFJetTight };
+    enum MuonID     { kMostBasicMu, kGoodBasicMu, kLooseMu, kTightMu };
+    enum ElectronID { kGoodBasicEl, kGoodTriggerEl, kElId_LooseWP, kElId_MediumWP, kLooseEl };
+    virtual void PFJetMask(   ObjectMask&, PFJetID = kPFJetLoose, double ptcut = 30., double absetacut = 2.5);
+    virtual void MuonMask(    ObjectMask&, MuonID = kGoodBasicMu);
+    virtual void ElectronMask(ObjectMask&, ElectronID = kGoodBasicEl);
+    // The Selection methods use the batch selection when given one of the
+    // selectors above (note: this bypasses overrides of these selectors)
     virtual vector<int> MuonSelection(    bool(UserAnalysisBase::*muonSelector)(int) = NULL);
     virtual vector<int> ElectronSelection(bool(UserAnalysisBase::*eleSelector)(int) = NULL);
     virtual vector<int> PhotonSelection(  bool(UserAnalysisBase::*phoSelector)(int) = NULL);
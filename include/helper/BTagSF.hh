@@ -1,3 +1,6 @@
+#ifndef BTagSF_hh
+#define BTagSF_hh
+
 #include <vector>
 #include <iostream>
 #include <map>
@@ -9,31 +12,62 @@ class BTagSF {
 	public:
 		BTagSF ();
 		~BTagSF(){};
-		
+
+		// Central value and systematic variations of the scale factors
+		enum Variation { kMean = 0, kMin = 1, kMax = 2, kNVariations };
+		// SMS models with fastsim corrections, kFullSim for fullsim samples
+		enum SMSModel { kFullSim = -1, kT1 = 0, kT1bbbb, kT1tttt, kT2, kT2bb, kT2bbbb, kT2bw, kT2tt, kT3w, kT3bw, kNSMSModels };
+
 		struct SFandErr {
 			float sf;
 			float err;
 		};
 
+		// Light flavour SF parametrisation in one eta range: cubic polynomial
+		// in pt, one set of coefficients per variation. Evaluates the same
+		// expression as the "((c0+(c1*x))+(c2*(x*x)))+(c3*(x*(x*x)))" TF1s.
+		struct SFLightPar {
+			double c[kNVariations][4];
+			inline double Eval(double x, Variation v) const {
+				const double *p = c[v];
+				return ((p[0]+(p[1]*x))+(p[2]*(x*x)))+(p[3]*(x*(x*x)));
+			}
+		};
+
+		// String interface, "mean", "min", "max" and the model names. The
+		// lookups print an error on every call for unknown names, resolve them
+		// once before an event loop and use the enum interface there
+		static Variation GetVariation(TString meanminmax);
+		static SMSModel  GetSMSModel (TString model);
+		static inline float GetShift(Variation v){ return v == kMin ? -1. : (v == kMax ? 1. : 0.); };
+
+		double efficiency (float pt, float eta, int flavor, Variation var, int lightUnc = 0);
+		double scalefactor(float pt, float eta, int flavor, Variation var, SMSModel model = kFullSim);
+		float  getSFLight (float jetpt, float jeteta, Variation var);
+		bool   applySF(bool& isBTagged, float SF, float eff, float random);
+		bool   modifyBTagsWithSF(bool& is_tagged, float pt, float eta, int flavor, Variation var, float random, SMSModel model = kFullSim);
+		// All jets of an event at once, tagged[] is updated
+		int    modifyBTagsWithSF(int njets, bool *tagged, const float *pt, const float *eta, const int *flavor, const float *random, Variation var, SMSModel model = kFullSim);
+		SFandErr getSMSSFandError(float jetpt, float jeteta, int jetflavor, SMSModel model);
+
 		double efficiency (float pt, float eta, int flavor, TString meanminmax, int lightUnc = 0);
 		double scalefactor(float pt, float eta, int flavor, TString meanminmax, bool isFastsim=false, TString model="");
 		float getSFLight(float jetpt, float jeteta, TString meanminmax);
-		bool   applySF(bool& isBTagged, float SF, float eff, float random);
 		bool   modifyBTagsWithSF(bool&, float, float, int, TString, float, bool = false, TString = ""); // just to have it in a similar format as before
 		SFandErr getSMSSFandError(float, float, int, TString);
 
-		TF1 * fLightSF;
-		std::map< TString, float> fMeanminmax;
-
-		TF1 * fLightSFeta0mean ;
-		TF1 * fLightSFeta0min  ;
-		TF1 * fLightSFeta0max  ;
-		TF1 * fLightSFeta1mean ;
-		TF1 * fLightSFeta1min  ;
-		TF1 * fLightSFeta1max  ;
-		TF1 * fLightSFeta2mean ;
-		TF1 * fLightSFeta2min  ;
-		TF1 * fLightSFeta2max  ;
-		
+		// Fastsim correction factors, pt bins of fFastSimPtMin/Max
+		// for b, c, central (|eta| < 1.2) and forward light jets
+		enum FastSimFlavor { kFSb = 0, kFSc, kFSlightCentral, kFSlightForward, kNFSFlavors };
+		static const int    kNFastSimBins = 14;
+		static const double fFastSimPtMin[kNFastSimBins];
+		static const double fFastSimPtMax[kNFastSimBins];
+		static const double fFastSimSF   [kNFSFlavors][kNFastSimBins];
+		static const double fFastSimErr  [kNFSFlavors][kNFastSimBins]; // stat + PU
+		static const double fFastSimModelErr[kNFSFlavors][kNSMSModels][kNFastSimBins];
+
+		// CSV medium light flavour SF, |eta| < 0.8, 0.8-1.6, 1.6-2.4
+		static const SFLightPar fLightSFPar[3];
 };
 
+#endif
@@ -29,6 +29,7 @@ public:
 	void   mt2_massless();
 	void   set_momenta(double *pa0, double *pb0, double* pmiss0);
 	void   set_mn(double mn);
+	inline void set_precision(double relprecision){rel_precision = relprecision;}; // call before set_momenta
 	inline void set_verbose(int vlevel){verbose = vlevel;};
 	double get_mt2();
 	void   print();
@@ -67,6 +68,7 @@ private:
 
 	double scale;
 	double precision;
+	double rel_precision;
 	// ClassDef(Davismt2,1)
 };
 #endif
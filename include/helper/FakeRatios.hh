@@ -10,6 +10,7 @@ using namespace std;
 
 class TGraphAsymmErrors;
 class TH1D;
+class TRandom3;
 
 
 class FakeRatios {
@@ -26,6 +27,12 @@ public:
 
 	enum gTLCat { TT, TL, LT, LL };
 
+	// Systematic errors from the errors on the ratios: toys (default) or
+	// linear error propagation. Toys are thrown with a fixed seed.
+	enum gESystMode { Toys, Analytic };
+	inline void setESystMode(gESystMode m){fESystMode = m;};
+	inline void setToySeed(unsigned s){fToySeed = s;};
+
 	//_____________________________________________________________________________
 	// Input
 	// Syntax is Ntt, Ntl, (Nlt), Nll
@@ -134,7 +141,10 @@ public:
 	float getNfpNpfNffSumEStat(float, float, float, float, float, float, float, float);
 	float getNfpNpfSumEStat(float, float, float, float, float, float, float, float);
 
+	// Squared systematic error, input syntax is: Ntt, Ntl, Nlt, Nll, f1, f2, p1, p2, df1, df2, dp1, dp2, function
+	float getESyst2(float, float, float, float, float, float, float, float, float, float, float, float, float(FakeRatios::*)(float, float, float, float, float, float, float, float));
 	float getESystFromToys2(float, float, float, float, float, float, float, float, float, float, float, float, float(FakeRatios::*)(float, float, float, float, float, float, float, float));
+	float getESystAnalytic2(float, float, float, float, float, float, float, float, float, float, float, float, int);
 
 	// Event by event weights
 	float getWpp(gTLCat, float, float, float, float);
@@ -148,6 +158,13 @@ public:
 	inline float getEStat(float N){return sqrt(getEStat2(N));};
 
 private:
+	// Contributions to a prediction, see getComponents
+	enum gComponent { PP = 1, PF = 2, FP = 4, FF = 8 };
+	int getComponents(float(FakeRatios::*)(float, float, float, float, float, float, float, float));
+	void addDerivatives(float, float, float, float, float, float, float, float, int, double*);
+	float getTotESyst2(float(FakeRatios::*)(float, float, float, float), int);
+	float throwRatio(float, float);
+
 	int fVerbose; // default 0
 	int fNToyMCs; // default 100
 	// Additional relative systematic error on predictions (added in quadrature), default 0.
@@ -158,6 +175,10 @@ private:
 	
 	float fAddESyst;
 
+	gESystMode fESystMode; // default Toys
+	unsigned fToySeed;     // default 4357
+	TRandom3 *fRand;
+
 	float fMMNtl[3]; // tt, tl, ll
 	float fEENtl[3]; // tt, tl, ll
 	float fEMNtl[4]; // tt, tl, lt, ll
@@ -6,7 +6,13 @@
 //    DATE: 20/06/2011
 //
 // CONTENT: An utility class to check whether current Run/Lumi is or  not
-//          in any certified JSON file. 
+//          in any certified JSON file.
+//          Runs are kept sorted with sorted, non-overlapping lumi ranges,
+//          so that lookups are binary searches. Several JSON files can be
+//          combined with Union and Intersect, or directly in the path
+//          given to ReadJSON: "a.json|b.json" (union), "a.json&b.json"
+//          (intersection). If any file of the expression cannot be read,
+//          ReadJSON returns false and the list is left unchanged.
 //
 ///////////////////////////////////////////////////////////////////////
 #ifndef GOODRUNLIST_H
@@ -17,30 +23,40 @@
 
 class GoodRunList {
  public:
+  GoodRunList();
   GoodRunList(const char* JSONpath);
   ~GoodRunList(){};
-  
-  const bool IsInitialized() { 
-    return (!(fRunLumis.size()==0));
+
+  const bool IsInitialized() const {
+    return fInitialized;
   }
-  void ReadJSON(const char* JSONpath);
+  bool ReadJSON(const char* JSONpath);      // adds the JSON(s) to the list
+  bool IntersectJSON(const char* JSONpath); // keeps only what is also in the JSON
+  void Union(const GoodRunList& other);
+  void Intersect(const GoodRunList& other);
   const bool CheckRunLumi(int Run, int LumiSection) const;
   const bool CheckRun(int RunNumber) const;
-  
+
   void Dump(std::ostream& os) const;
+  void Print(std::ostream& os) const;
 
  protected:
   struct RunLumi{
     int run;
     std::vector<int> lumi_min;
     std::vector<int> lumi_max;
-  } fCurRunLumi; 
+  };
+
+  bool ReadFile(const char* JSONpath);
+  static bool Parse(std::istream& is, std::vector<RunLumi>& runs);
+  static void Sort(std::vector<RunLumi>& runs);
+  const RunLumi* FindRun(int RunNumber) const;
 
   std::vector<RunLumi> fRunLumis;
-  
+  bool fInitialized;
+
 };
 
 #endif
 
-  
 
@@ -71,10 +71,33 @@ public:
 //   (default = 10000. GeV)
 // RejectISRDRmax() max DeltaR below which objects can be included
 //   (default = 10.)
+//
+// Reusable engine: construct once with the default constructor and pass the
+// objects of every event with SetObjects(n, px, py, pz, E). The arrays are not
+// copied and must stay valid until the results have been retrieved. The internal
+// storage only grows (starting at kInitObjects), so that no memory is allocated
+// per event once it fits the largest event. The results of the last kNCache
+// reconstructions are kept: asking again for the same objects, methods and settings
+// (e.g. several MT2 variants with the same seeding in one event) returns the cached
+// grouping and axes.
+
+static const int kInitObjects = 64;
+static const int kNCache      = 4;
+
+Hemisphere(const vector<float>& Px_vector, const vector<float>& Py_vector, const vector<float>& Pz_vector, const vector<float>& E_vector, int seed_method, int hemisphere_association_method);
+
+Hemisphere(const vector<float>& Px_vector, const vector<float>& Py_vector, const vector<float>& Pz_vector, const vector<float>& E_vector);
 
-Hemisphere(vector<float> Px_vector, vector<float> Py_vector, vector<float> Pz_vector, vector<float> E_vector, int seed_method, int hemisphere_association_method);
+// reusable engine, objects are given by SetObjects()
+Hemisphere(int seed_method = 2, int hemisphere_association_method = 3);
 
-Hemisphere(vector<float> Px_vector, vector<float> Py_vector, vector<float> Pz_vector, vector<float> E_vector);
+// set the objects of a new event (arrays are not copied), clears the NoSeed and NoAssoc lists
+void SetObjects(int n, const float* px, const float* py, const float* pz, const float* E);
+
+// copies take over the input of the vector constructors, the caller's arrays
+// given to SetObjects are shared
+Hemisphere(const Hemisphere& other);
+Hemisphere& operator=(const Hemisphere& other);
 
 // Destructor
 ~Hemisphere(){};
@@ -92,6 +115,12 @@ vector<float> getAxis2();
 //   (order of objects in vector is same as input)
 vector<int> getGrouping();
 
+// same without copies: arrays of length GetNObjects() and 5, valid until the next call
+const int*   Grouping();
+const float* Axis1Array();
+const float* Axis2Array();
+int GetNObjects() const { return nObjects; }
+
 // set or overwrite the seed and association methods
 void SetMethod(int seed_method, int hemisphere_association_method) {
   seed_meth = seed_method;
@@ -117,7 +146,7 @@ void SetNoAssoc(int object_number) {
 // reset the list of NoSeed and NoAssoc objects to empty
 // (method introduced on 01/11/08)
 void ClearAllNoLists() {
-  for (int i = 0; i < (int)Object_Noseed.size(); ++i) {
+  for (int i = 0; i < nObjects; ++i) {
     Object_Noassoc[i] = 0; 
     Object_Noseed[i] = 0; 
     status = 0;
@@ -154,32 +183,76 @@ void RejectISRDRmax(float drmax) {
   status = 0;
 }
 
+// switch off the ISR rejection
+void NoRejectISR() {
+  rejectISRDR = 0;
+  rejectISRPt = 0;
+  rejectISR = 0;
+  status = 0;
+}
+
 // controls the level of debug prints
 void SetDebug(int debug)  { dbg = debug; } 
 int  GetNumLoop(){return numLoop;}
+// number of results taken from the cache
+long GetNCacheHits(){return nCacheHits;}
+void ClearCache(){for (int c = 0; c < kNCache; ++c) Cache[c].n = -1;}
  
  
 private:
 
+void SetVectors(const vector<float>& Px_vector, const vector<float>& Py_vector, const vector<float>& Pz_vector, const vector<float>& E_vector);
+void Reserve(int n);
+
+// run the reconstruction (or take it from the cache) if needed
+struct CacheEntry;
+void Compute();
+bool FindInCache();
+void StoreInCache(CacheEntry& C, bool key);
+
 // the hemisphere separation algorithm
 int Reconstruct();
 int RejectISR(); 
 
+// input, not owned (points to Object_Input for the vector constructors)
+int nObjects;
+const float* Object_Px;
+const float* Object_Py;
+const float* Object_Pz;
+const float* Object_E;
+vector<float> Object_Input[4];
 
-vector<float> Object_Px;
-vector<float> Object_Py;
-vector<float> Object_Pz;
 vector<float> Object_P;
 vector<float> Object_Pt;
-vector<float> Object_E;
 vector<float> Object_Phi;
 vector<float> Object_Eta;
 vector<int> Object_Group;
 vector<int> Object_Noseed;
 vector<int> Object_Noassoc;
 
-vector<float> Axis1;
-vector<float> Axis2;
+float Axis1[5];
+float Axis2[5];
+
+// cached results, keyed by input, methods, settings and NoSeed/NoAssoc lists
+struct CacheEntry {
+  int n;
+  int seed_meth, hemi_meth, nItermax;
+  int rejectISRPt, rejectISRDR;
+  float dRminSeed1, rejectISRPtmax, rejectISRDRmax;
+  vector<float> Input[4];
+  vector<int> Noseed;
+  vector<int> Noassoc;
+  // results
+  vector<int> Group;
+  vector<int> NoassocOut;
+  vector<int> NoseedOut;
+  float Axis1[5];
+  float Axis2[5];
+  int numLoop;
+};
+CacheEntry Cache[kNCache];
+int nextCache;
+long nCacheHits;
 
 //static const float hemivsn = 1.01;
 int seed_meth;
@@ -0,0 +1,96 @@
+#ifndef HistoCache_hh
+#define HistoCache_hh
+
+#include <vector>
+#include <map>
+#include <string>
+#include <iostream>
+#include <cstdlib>
+#include "TString.h"
+
+class TFile;
+class TObject;
+class TH1;
+
+//
+// Flat binary cache of the histograms of a ROOT file, for reading the same
+// few thousand histograms by name at every start (SSDLDumper::readHistos).
+//
+// The cache file (<file>.hcache) holds an index of the histogram names and
+// one record per histogram: binning, labels, statistics and the plain bin
+// content and error arrays. It is memory-mapped by Open(), which only reads
+// the index: a histogram is decoded from its record the first time it is
+// asked for with Get(), without ROOT key lookup, decompression or streamers.
+// The cache carries the MD5 checksum of the file it was made from and is
+// ignored as soon as the file changes.
+//
+// Objects which are not in the cache are read from the file itself (opened
+// on first need) and recorded, Update() then writes a new cache for the
+// next time:
+//   HistoCache cache;
+//   cache.Open("SSDLYields.root");
+//   TH1D *h; cache.GetObjectSafe("TTJets/TTJets_EventCount", h);
+//   cache.Update();
+// TH1F, TH1D, TH2F, TH2D and TEfficiency are cached, other classes are
+// always read from the file. Get() returns a new object owned by the caller.
+//
+class HistoCache {
+
+public:
+	HistoCache();
+	virtual ~HistoCache();
+
+	// Maps the cache of filename if it is up to date. False if there is
+	// neither a valid cache nor a readable file.
+	bool Open(TString filename);
+	void Close();
+	inline bool IsCached() const {return fMap != 0;};
+
+	TObject* Get(const TString &name);
+	template <class T> inline void GetObjectSafe(const TString &name, T*& object){
+		TObject *obj = Get(name);
+		object = dynamic_cast<T*>(obj);
+		if(!object){
+			delete obj;
+			std::cout << name + " not found!" << std::endl;
+			exit(-1);
+		}
+	};
+
+	// Writes the cache if objects had to be read from the file
+	bool Update();
+
+	static TString GetCacheName(const TString &filename){ return filename + ".hcache"; };
+	void setVerbose(int v){fVerbose = v;};
+
+private:
+	struct Record {
+		size_t offset;
+		size_t size;
+	};
+
+	TFile* GetFile();
+	bool   Map();
+
+	static bool Encode(std::vector<char> &out, const TObject *obj);
+	static bool EncodeHisto(std::vector<char> &out, const TH1 *h);
+	static TObject* Decode(const char *data, size_t size);
+	static TH1*     DecodeHisto(const char *&data, const char *end);
+
+	TString     fFileName;
+	TString     fCacheName;
+	std::string fChecksum;  // MD5 of fFileName, empty if it cannot be read
+	TFile      *fFile;
+
+	// mapped cache
+	void  *fMap;
+	size_t fMapSize;
+	std::map<std::string, Record> fIndex;
+
+	// objects read from the file, for the next cache
+	std::vector<std::pair<std::string, std::vector<char> > > fNew;
+
+	int fVerbose;
+};
+
+#endif
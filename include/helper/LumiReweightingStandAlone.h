@@ -26,10 +26,20 @@
 #include "TRandom2.h"
 #include "TRandom3.h"
 #include "TStopwatch.h"
+#include "TThread.h"
+#include "TString.h"
 #include <string>
 #include <vector>
 #include <cmath>
 #include <algorithm>
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 namespace reweight {
 
@@ -229,7 +239,9 @@ namespace reweight {
   class LumiReWeighting {
   public:
 
-    LumiReWeighting ( ) { } ;
+    LumiReWeighting ( ) { weight3D_defaults(); } ;
+
+    virtual ~LumiReWeighting ( ) { weight3D_unmap(); } ;
 
     LumiReWeighting( std::string generatedFile,
 		     std::string dataFile,
@@ -240,6 +252,8 @@ namespace reweight {
       GenHistName_      ( GenHistName ), 
       DataHistName_     ( DataHistName )
 	{
+	  weight3D_defaults();
+
 	  generatedFile_ = new TFile( generatedFileName_.c_str() ) ; //MC distribution
 	  dataFile_      = new TFile( dataFileName_.c_str() );       //Data distribution
 
@@ -277,6 +291,8 @@ namespace reweight {
 
     
       LumiReWeighting( std::vector< float > MC_distr, std::vector< float > Lumi_distr){
+	weight3D_defaults();
+
 	// no histograms for input: use vectors
   
 	// now, make histograms out of them:
@@ -332,168 +348,88 @@ namespace reweight {
 
       }
 
-      void weight3D_init( float ScaleFactor, std::string WeightOutputFile="") { 
-
-	//create histogram to write output weights, save pain of generating them again...
-
-	TH3D* WHist = new TH3D("WHist","3D weights",50,0.,50.,50,0.,50.,50,0.,50. );
-	TH3D* DHist = new TH3D("DHist","3D weights",50,0.,50.,50,0.,50.,50,0.,50. );
-	TH3D* MHist = new TH3D("MHist","3D weights",50,0.,50.,50,0.,50.,50,0.,50. );
-
+      // The 3D weights depend only on the two input distributions and on ScaleFactor.
+      // They are cached in <cache dir>/weight3D_<hash>.bin, keyed on a hash of these
+      // inputs, and later jobs map the cached table instead of recomputing it.
+      // The cache directory is $PU3D_CACHE_DIR, there is no cache if it is not
+      // set or empty (weight3D_setCacheDir("")). Only cache files owned by the
+      // user and not writable by others are read.
+      // On a cache miss the convolution runs on weight3D_setThreads() threads
+      // (default 1).
+      void weight3D_setCacheDir( std::string dir ) { Weight3DCacheDir_ = dir; }
+      void weight3D_setThreads( int n ) { Weight3DThreads_ = n > 0 ? n : 1; }
 
-	using std::min;
+      void weight3D_init( float ScaleFactor, std::string WeightOutputFile="") { 
 
 	if( MC_distr_->GetEntries() == 0 ) {
 	  std::cout << " MC and Data distributions are not initialized! You must call the LumiReWeighting constructor. " << std::endl;
 	}
 
-	// arrays for storing number of interactions
-
-	double MC_ints[50][50][50];
-	double Data_ints[50][50][50];
-
-	for (int i=0; i<50; i++) {
-	  for(int j=0; j<50; j++) {
-	    for(int k=0; k<50; k++) {
-	      MC_ints[i][j][k] = 0.;
-	      Data_ints[i][j][k] = 0.;
-	    }
-	  }
-	}
-
-	double factorial[50];
-	double PowerSer[50];
-	double base = 1.;
-
-	factorial[0] = 1.;
-	PowerSer[0]=1.;
-
-	for (int i = 1; i<50; ++i) {
-	  base = base*float(i);
-	  factorial[i] = base;
+	// the cache has only the weights, the MC and data matrices are recomputed
+	// if they have to be written out
+	unsigned long long key = weight3D_key( ScaleFactor );
+	if( WeightOutputFile.empty() && weight3D_map( key ) ) {
+	  std::cout << " 3D Weight Matrix read from cache " << weight3D_cacheFile( key ) << std::endl;
+	  return;
 	}
 
-
-	double x;
-	double xweight;
-	double probi, probj, probk;
-	double Expval, mean;
-	int xi;
-
-	// Get entries for Data, MC, fill arrays:                                                                                                 
-	int NMCbin = MC_distr_->GetNbinsX();
+	// Poisson probabilities for each bin of the input distributions
+	int NMCbin   = MC_distr_->GetNbinsX();
+	int NDatabin = Data_distr_->GetNbinsX();
+	std::vector<double> MC_prob( 50*NMCbin ), Data_prob( 50*NDatabin );
+	std::vector<double> MC_w( NMCbin ), Data_w( NDatabin );
 
 	for (int jbin=1;jbin<NMCbin+1;jbin++) {
-	  x =  MC_distr_->GetBinCenter(jbin);
-	  xweight = MC_distr_->GetBinContent(jbin); //use as weight for matrix         
-
 	  //for Summer 11, we have this int feature:                      
-	  xi = int(x);
-
-	  // Generate Poisson distribution for each value of the mean     
-	  mean = double(xi);
-
-	  if(mean<0.) {
-	    std::cout << "LumiReweighting:BadInputValue" << " Your histogram generates MC luminosity values less than zero!"
-						  << " Please Check.  Terminating." << std::endl;
-	  }
-
-
-	  if(mean==0.){
-	    Expval = 1.;
-	  }
-	  else {
-	    Expval = exp(-1.*mean);
-	  }
-
-	  base = 1.;
-
-	  for (int i = 1; i<50; ++i) {
-	    base = base*mean;
-	    PowerSer[i] = base; // PowerSer is mean^i                        
-	  }
-
-	  // compute poisson probability for each Nvtx in weight matrix      
-	  for (int i=0; i<50; i++) {
-	    probi = PowerSer[i]/factorial[i]*Expval;
-	    for(int j=0; j<50; j++) {
-	      probj = PowerSer[j]/factorial[j]*Expval;
-	      for(int k=0; k<50; k++) {
-		probk = PowerSer[k]/factorial[k]*Expval;
-		// joint probability is product of event weights multiplied by weight of input distribution bin                                   
-		MC_ints[i][j][k] = MC_ints[i][j][k]+probi*probj*probk*xweight;
-	      }
-	    }
-	  }
-
+	  double mean = double( int( MC_distr_->GetBinCenter(jbin) ) );
+	  weight3D_poisson( mean, &MC_prob[50*(jbin-1)] );
+	  MC_w[jbin-1] = MC_distr_->GetBinContent(jbin); //use as weight for matrix         
 	}
-
-	int NDatabin = Data_distr_->GetNbinsX();
-
 	for (int jbin=1;jbin<NDatabin+1;jbin++) {
-	  mean =  (Data_distr_->GetBinCenter(jbin))*ScaleFactor;
-	  xweight = Data_distr_->GetBinContent(jbin);
-
-	  // Generate poisson distribution for each value of the mean
-	  if(mean<0.) {
-	    std::cout << "LumiReweighting:BadInputValue" << " Your histogram generates MC luminosity values less than zero!"
-						  << " Please Check.  Terminating." << std::endl;
-	  }
-
-	  if(mean==0.){
-	    Expval = 1.;
-	  }
-	  else {
-	    Expval = exp(-1.*mean);
-	  }
-
-	  base = 1.;
-
-	  for (int i = 1; i<50; ++i) {
-	    base = base*mean;
-	    PowerSer[i] = base;
-	  }
-
-	  // compute poisson probability for each Nvtx in weight matrix                                                                           
-
-	  for (int i=0; i<50; i++) {
-	    probi = PowerSer[i]/factorial[i]*Expval;
-	    for(int j=0; j<50; j++) {
-	      probj = PowerSer[j]/factorial[j]*Expval;
-	      for(int k=0; k<50; k++) {
-		probk = PowerSer[k]/factorial[k]*Expval;
-		// joint probability is product of event weights multiplied by weight of input distribution bin                                   
-		Data_ints[i][j][k] = Data_ints[i][j][k]+probi*probj*probk*xweight;
-	      }
-	    }
-	  }
-
+	  double mean = (Data_distr_->GetBinCenter(jbin))*ScaleFactor;
+	  weight3D_poisson( mean, &Data_prob[50*(jbin-1)] );
+	  Data_w[jbin-1] = Data_distr_->GetBinContent(jbin);
 	}
 
+	// joint probabilities, summed over the input distributions
+	std::vector<double> MC_ints( 50*50*50, 0. ), Data_ints( 50*50*50, 0. );
+	weight3D_convolve( &MC_prob[0],   &MC_w[0],   NMCbin,   &MC_ints[0]   );
+	weight3D_convolve( &Data_prob[0], &Data_w[0], NDatabin, &Data_ints[0] );
 
+	weight3D_unmap();
 	for (int i=0; i<50; i++) {
-	  //if(i<5) std::cout << "i = " << i << std::endl;                       
 	  for(int j=0; j<50; j++) {
 	    for(int k=0; k<50; k++) {
-	      if( (MC_ints[i][j][k])>0.) {
-		Weight3D_[i][j][k]  =  Data_ints[i][j][k]/MC_ints[i][j][k];
+	      int n = (i*50+j)*50+k;
+	      if( (MC_ints[n])>0.) {
+		Weight3D_[i][j][k]  =  Data_ints[n]/MC_ints[n];
 	      }
 	      else {
 		Weight3D_[i][j][k]  = 0.;
 	      }
-	      WHist->SetBinContent( i+1,j+1,k+1,Weight3D_[i][j][k] );
-	      DHist->SetBinContent( i+1,j+1,k+1,Data_ints[i][j][k] );
-	      MHist->SetBinContent( i+1,j+1,k+1,MC_ints[i][j][k] );
-	      //      if(i<5 && j<5 && k<5) std::cout << Weight3D_[i][j][k] << " " ;    
 	    }
-	    //      if(i<5 && j<5) std::cout << std::endl;        
 	  }
 	}
+	weight3D_store( key );
 
 	if(! WeightOutputFile.empty() ) {
 	  std::cout << " 3D Weight Matrix initialized! " << std::endl;
 	  std::cout << " Writing weights to file " << WeightOutputFile << " for re-use...  " << std::endl;
 
+	  //create histogram to write output weights, save pain of generating them again...
+	  TH3D* WHist = new TH3D("WHist","3D weights",50,0.,50.,50,0.,50.,50,0.,50. );
+	  TH3D* DHist = new TH3D("DHist","3D weights",50,0.,50.,50,0.,50.,50,0.,50. );
+	  TH3D* MHist = new TH3D("MHist","3D weights",50,0.,50.,50,0.,50.,50,0.,50. );
+	  for (int i=0; i<50; i++) {
+	    for(int j=0; j<50; j++) {
+	      for(int k=0; k<50; k++) {
+		int n = (i*50+j)*50+k;
+		WHist->SetBinContent( i+1,j+1,k+1,Weight3D_[i][j][k] );
+		DHist->SetBinContent( i+1,j+1,k+1,Data_ints[n] );
+		MHist->SetBinContent( i+1,j+1,k+1,MC_ints[n] );
+	      }
+	    }
+	  }
 
 	  TFile * outfile = new TFile(WeightOutputFile.c_str(),"RECREATE");
 	  WHist->Write();
@@ -510,6 +446,7 @@ namespace reweight {
 
       void weight3D_set( std::string WeightFileName ) { 
 
+	weight3D_unmap();
 	TFile *infile = new TFile(WeightFileName.c_str());
 	TH1F *WHist = (TH1F*)infile->Get("WHist");
 
@@ -527,6 +464,7 @@ namespace reweight {
 	    }
 	  }
 	}
+	Weight3DTable_ = &Weight3D_[0][0][0];
 
 	std::cout << " 3D Weight Matrix initialized! " << std::endl;
 
@@ -1320,7 +1258,7 @@ namespace reweight {
 	int np0 = min(pv2,34);
 	int npp1 = min(pv3,34);
 
-	return Weight3D_[npm1][np0][npp1];
+	return Weight3DTable_[(npm1*50+np0)*50+npp1];
 
       }
 
@@ -1398,6 +1336,164 @@ namespace reweight {
 
   protected:
 
+      // 3D weights: cache and convolution ---------------------------------
+      void weight3D_defaults() {
+	Weight3DTable_   = &Weight3D_[0][0][0];
+	Weight3DMap_     = 0;
+	Weight3DMapSize_ = 0;
+	const char *dir  = getenv("PU3D_CACHE_DIR");
+	Weight3DCacheDir_ = dir ? dir : "";
+	Weight3DThreads_ = 1;
+      }
+
+      // Poisson probabilities for 0..49 interactions, computed as in the
+      // original weight3D_init so that the results are unchanged
+      static void weight3D_poisson( double mean, double *prob ) {
+	if(mean<0.) {
+	  std::cout << "LumiReweighting:BadInputValue" << " Your histogram generates MC luminosity values less than zero!"
+		    << " Please Check.  Terminating." << std::endl;
+	}
+	double Expval = (mean==0.) ? 1. : exp(-1.*mean);
+	double base = 1., factorial = 1.;
+	prob[0] = Expval;
+	for (int i = 1; i<50; ++i) {
+	  base      = base*mean;
+	  factorial = factorial*float(i);
+	  prob[i]   = base/factorial*Expval;
+	}
+      }
+
+      struct Weight3DJob {
+	const double *prob;  // nbins x 50 Poisson probabilities
+	const double *w;     // nbins weights
+	int nbins;
+	int i0, i1;          // first index range of this job
+	double *ints;        // 50 x 50 x 50 result
+      };
+
+      static void* weight3D_work( void *arg ) {
+	Weight3DJob *job = (Weight3DJob*)arg;
+	for (int b=0; b<job->nbins; b++) {
+	  const double *p = job->prob + 50*b;
+	  const double xweight = job->w[b];
+	  for (int i=job->i0; i<job->i1; i++) {
+	    for(int j=0; j<50; j++) {
+	      const double pij = p[i]*p[j];
+	      double *row = job->ints + (i*50+j)*50;
+	      for(int k=0; k<50; k++) row[k] += pij*p[k]*xweight;
+	    }
+	  }
+	}
+	return 0;
+      }
+
+      // ints[i][j][k] = sum over bins of w * P(i) P(j) P(k), split in i over threads
+      void weight3D_convolve( const double *prob, const double *w, int nbins, double *ints ) {
+	int nthreads = std::min( Weight3DThreads_, 50 );
+	std::vector<Weight3DJob> jobs( nthreads );
+	for (int t=0; t<nthreads; t++) {
+	  Weight3DJob job = { prob, w, nbins, 50*t/nthreads, 50*(t+1)/nthreads, ints };
+	  jobs[t] = job;
+	}
+	if( nthreads == 1 ) {
+	  weight3D_work( &jobs[0] );
+	  return;
+	}
+	TThread::Initialize();
+	std::vector<TThread*> threads;
+	for (int t=0; t<nthreads; t++) {
+	  threads.push_back( new TThread( Form("Weight3D_%d", t), weight3D_work, &jobs[t] ) );
+	  threads[t]->Run();
+	}
+	for (int t=0; t<nthreads; t++) {
+	  threads[t]->Join();
+	  delete threads[t];
+	}
+      }
+
+      // FNV-1a hash of everything the weights depend on
+      unsigned long long weight3D_key( float ScaleFactor ) const {
+	std::vector<double> in;
+	in.push_back( 1. ); // version of the computation
+	in.push_back( MC_distr_->GetNbinsX() );
+	for (int jbin=1;jbin<MC_distr_->GetNbinsX()+1;jbin++) {
+	  in.push_back( double( int( MC_distr_->GetBinCenter(jbin) ) ) );
+	  in.push_back( MC_distr_->GetBinContent(jbin) );
+	}
+	in.push_back( Data_distr_->GetNbinsX() );
+	for (int jbin=1;jbin<Data_distr_->GetNbinsX()+1;jbin++) {
+	  in.push_back( (Data_distr_->GetBinCenter(jbin))*ScaleFactor );
+	  in.push_back( Data_distr_->GetBinContent(jbin) );
+	}
+	unsigned long long hash = 14695981039346656037ULL;
+	const unsigned char *bytes = (const unsigned char*)&in[0];
+	for (size_t n=0; n<in.size()*sizeof(double); n++) {
+	  hash ^= bytes[n];
+	  hash *= 1099511628211ULL;
+	}
+	return hash;
+      }
+
+      std::string weight3D_cacheFile( unsigned long long key ) const {
+	return Weight3DCacheDir_ + Form("/weight3D_%016llx.bin", key);
+      }
+
+      // Cache file: 64 byte header (magic, key), then the 50x50x50 weights
+      static size_t weight3D_fileSize() { return 64 + sizeof(double)*50*50*50; }
+
+      bool weight3D_map( unsigned long long key ) {
+	if( Weight3DCacheDir_.empty() ) return false;
+	int fd = open( weight3D_cacheFile( key ).c_str(), O_RDONLY );
+	if( fd < 0 ) return false;
+	struct stat st;
+	void *map = MAP_FAILED;
+	if( fstat( fd, &st ) == 0 && size_t(st.st_size) == weight3D_fileSize()
+	    && st.st_uid == geteuid() && !(st.st_mode & (S_IWGRP|S_IWOTH)) )
+	  map = mmap( 0, weight3D_fileSize(), PROT_READ, MAP_SHARED, fd, 0 );
+	close( fd );
+	if( map == MAP_FAILED ) return false;
+
+	const char *header = (const char*)map;
+	unsigned long long filekey;
+	memcpy( &filekey, header+8, sizeof(filekey) );
+	if( memcmp( header, "PU3DW001", 8 ) != 0 || filekey != key ) {
+	  munmap( map, weight3D_fileSize() );
+	  return false;
+	}
+	weight3D_unmap();
+	Weight3DMap_     = map;
+	Weight3DMapSize_ = weight3D_fileSize();
+	Weight3DTable_   = (const double*)(header+64);
+	return true;
+      }
+
+      void weight3D_unmap() {
+	if( Weight3DMap_ ) munmap( Weight3DMap_, Weight3DMapSize_ );
+	Weight3DMap_     = 0;
+	Weight3DMapSize_ = 0;
+	Weight3DTable_   = &Weight3D_[0][0][0];
+      }
+
+      // Written to a temporary file first, concurrent jobs never see a partial table
+      void weight3D_store( unsigned long long key ) const {
+	if( Weight3DCacheDir_.empty() ) return;
+	std::string file = weight3D_cacheFile( key );
+	std::string tmp  = file + Form(".%d", getpid());
+	char header[64];
+	memset( header, 0, sizeof(header) );
+	memcpy( header, "PU3DW001", 8 );
+	memcpy( header+8, &key, sizeof(key) );
+	// new file only (no symlink followed), not writable by others
+	int fd = open( tmp.c_str(), O_WRONLY|O_CREAT|O_EXCL, 0644 );
+	if( fd < 0 ) return;
+	FILE *out = fdopen( fd, "wb" );
+	if( !out ){ close( fd ); unlink( tmp.c_str() ); return; }
+	bool ok = fwrite( header, 1, sizeof(header), out ) == sizeof(header)
+	       && fwrite( &Weight3D_[0][0][0], sizeof(double), 50*50*50, out ) == 50*50*50;
+	ok = (fclose( out ) == 0) && ok;
+	if( !ok || rename( tmp.c_str(), file.c_str() ) != 0 ) unlink( tmp.c_str() );
+      }
+
       std::string generatedFileName_;
       std::string dataFileName_;
       std::string GenHistName_;
@@ -1412,9 +1508,18 @@ namespace reweight {
 
       double WeightOOTPU_[25][25];
       double Weight3D_[50][50][50];
+      const double *Weight3DTable_; // Weight3D_, or the mapped cache file
+      void  *Weight3DMap_;
+      size_t Weight3DMapSize_;
+      std::string Weight3DCacheDir_;
+      int Weight3DThreads_;
 
       bool FirstWarning_;
 
+  private:
+      // Not copyable: Weight3DTable_ points into this object or its mapping
+      LumiReWeighting( const LumiReWeighting& );
+      LumiReWeighting& operator=( const LumiReWeighting& );
 
   };
 }
@@ -0,0 +1,54 @@
+#ifndef MT2Calculator_hh
+#define MT2Calculator_hh
+
+#include "helper/Davismt2.h"
+
+class TLorentzVector;
+
+//
+// Reusable MT2 calculator.
+//
+// Keep one instance (e.g. as a class member) instead of creating a
+// Davismt2 per call. Configurations for which MT2 is known analytically
+// are returned without bisection:
+//  - massive case: the lighter side is compatible with the heavier side at
+//    its own minimum, MT2 = ma + mn ("balanced" configuration)
+//  - massless case with mn = 0: pmiss lies between pa and pb, MT2 = 0
+// All other configurations are bisected by Davismt2, with the relative
+// precision given in the constructor or in setPrecision.
+//
+// Momenta follow the Davismt2 convention: arrays (mass, px, py), the
+// first entry of pmiss is unused.
+//
+class MT2Calculator {
+
+public:
+	MT2Calculator(double relprecision = RELATIVE_PRECISION);
+	virtual ~MT2Calculator(){};
+
+	inline void   setPrecision(double relprecision){fPrecision = relprecision;};
+	inline double getPrecision() const {return fPrecision;};
+	inline void   setVerbose(int v){fSolver.set_verbose(v);};
+
+	double getMT2(const double *pa, const double *pb, const double *pmiss, double mn = 0.);
+	double getMT2(const TLorentzVector &visible1, const TLorentzVector &visible2,
+	              const TLorentzVector &MET, double mn = 0., bool massive = true);
+	// Batch version: n configurations stored as n consecutive
+	// (mass, px, py) triplets in pa, pb and pmiss, results in mt2[0..n-1]
+	void   getMT2(int n, const double *pa, const double *pb, const double *pmiss, double mn, double *mt2);
+
+	// Statistics
+	inline long nCalls()      const {return fNCalls;};
+	inline long nEarlyExits() const {return fNEarly;};
+	inline void resetCounts(){fNCalls = 0; fNEarly = 0;};
+
+private:
+	bool balanced(const double *pa, const double *pb, const double *pmiss, double mn, double &mt2) const;
+
+	Davismt2 fSolver;
+	double fPrecision;
+	long fNCalls;
+	long fNEarly;
+};
+
+#endif
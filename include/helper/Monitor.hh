@@ -15,6 +15,16 @@
 // 
 // 2) Fill them in the analysis code
 //
+//    Counters are printed in the order of their first fill. In an event
+//    loop, register them once with book() and fill the returned handles: a
+//    fill is then two additions to the sums of weights and of squared
+//    weights, without any string handling. A booked counter is only printed
+//    once it has been filled (possibly with weight 0).
+//    Filling by name looks the counter up in a map on every call.
+//
+//      Monitor::Handle hMuGlobal = counters[MU].book("... is global muon"); // in Begin()
+//      counters[MU].fill(hMuGlobal);                                          // per event
+//
 //    for ( ... loop over muons ... ) {
 //      counters[MU].fill("All muons");
 //      if ( !fTR->MuIsGMPT[index] )        return false;
@@ -27,7 +37,7 @@
 //    }
 //
 //
-// 3) Print out at the end
+// 3) Print out at the end (makeHisto() and writeCSV() export the same numbers)
 //    
 //    UserAnalysis::End() {
 //       ...
@@ -47,6 +57,10 @@
 #include <map>
 #include <sstream>
 #include <string>
+#include <vector>
+#include <cmath>
+
+#include "TH1D.h"
 
 
 struct eqstr 
@@ -60,54 +74,71 @@ struct eqstr
 
 class Monitor {
 
-  //typedef std::map<const std::string, float, eqstr> Cmap;
-  typedef std::map<const std::string, double, eqstr> Cmap;
+  typedef std::map<const std::string, int, eqstr> Cmap;
 
 public:
+  typedef int Handle;
+
   Monitor() : maxLength(50),name("") {}
 
   void setName( const std::string& s ) { name = s; }
 
-  /*
-  void fill( const std::string& counter, const float& weight=1. ) {
+  // Register a counter and return its handle. Handles are given in order
+  // of registration, so monitors booked with the same names in the same
+  // order share them. Booking an existing name returns its handle.
+  Handle book( const std::string& counter ) {
     Cmap::iterator it;
-    if ( ( it = counters.find(counter)) == counters.end() ) {
-      countNames.push_back( counter ); // Store name in ordered list
-      if ( counter.length()>maxLength ) maxLength = counter.length();
-      counters.insert( make_pair(counter,weight) ); // Increment counter
-    } else {
-      (*it).second += weight;
-    }
+    if ( ( it = index.find(counter)) != index.end() ) return (*it).second;
+    Handle h = countNames.size();
+    countNames.push_back( counter );
+    sumw .push_back(0.);
+    sumw2.push_back(0.);
+    filled.push_back(false);
+    index.insert( make_pair(counter,h) );
+    return h;
+  }
+
+  void fill( Handle h, double weight=1. ) {
+    if ( !filled[h] ) show(h);
+    sumw [h] += weight;
+    sumw2[h] += weight*weight;
   }
-  */
   void fill( const std::string& counter, const double& weight=1. ) {
-    Cmap::iterator it;
-    if ( ( it = counters.find(counter)) == counters.end() ) {
-      countNames.push_back( counter ); // Store name in ordered list
-      if ( counter.length()>maxLength ) maxLength = counter.length();
-      counters.insert( make_pair(counter,weight) ); // Increment counter
-    } else {
-      (*it).second += weight;
+    fill( book(counter), weight );
+  }
+
+  // Add all counters of another monitor (e.g. of a worker thread), keeping
+  // this monitor's ordering and appending names it has not seen yet
+  void add( const Monitor& other ) {
+    for ( size_t i=0; i<other.order.size(); ++i ) {
+      Handle o = other.order[i];
+      Handle h = book( other.countNames[o] );
+      if ( !filled[h] ) show(h);
+      sumw [h] += other.sumw [o];
+      sumw2[h] += other.sumw2[o];
     }
   }
 
-  const float counts( const std::string& counter ) { 
-     return counters[counter];
+  const float counts( const std::string& counter ) const {
+    Cmap::const_iterator it = index.find(counter);
+    return it != index.end() ? sumw[(*it).second] : 0.;
   }
+  const double counts( Handle h ) const { return sumw[h]; }
+  const double error ( Handle h ) const { return sqrt(sumw2[h]); }
+  const size_t size() const { return order.size(); } // filled counters
 
-  friend ostream& operator<<( ostream& os, Monitor m ) {
+  friend ostream& operator<<( ostream& os, const Monitor& m ) {
     using namespace std;
-    if ( !(m.countNames.size()>0) ) return os;
+    if ( !(m.order.size()>0) ) return os;
     // This needs to be improved
-    float maxc = m.counters[m.countNames[0]];
+    float maxc = m.sumw[m.order[0]];
     float prev = maxc;
     ostringstream maxclen; maxclen << maxc;
     size_t maxwidth = maxclen.str().length();
     os << left << "COUNTER> " << m.name << endl;
-    for ( vector<string>::const_iterator it = m.countNames.begin();
-          it != m.countNames.end(); ++it ) {
-      float count = m.counters[*it];
-      os << setw(m.maxLength+5) << left << (*it)
+    for ( size_t i=0; i<m.order.size(); ++i ) {
+      float count = m.sumw[m.order[i]];
+      os << setw(m.maxLength+5) << left << m.countNames[m.order[i]]
                 << setw(maxwidth) << right << count << " "
                 << setw(3) << right
                 << static_cast<int>(maxc>0.?count/maxc*100.:0.) << "% "
@@ -123,11 +154,59 @@ public:
 
   void print() { std::cout << *this; }
 
+  // Cut flow histogram: one bin per counter, labelled with its name,
+  // holding the sum of weights and its error. Owned by the caller.
+  TH1D* makeHisto( const std::string& hname ) const {
+    int nbins = order.size()>0 ? order.size() : 1;
+    TH1D *h = new TH1D( hname.c_str(), name.c_str(), nbins, 0., nbins );
+    h->Sumw2();
+    for ( size_t i=0; i<order.size(); ++i ) {
+      h->GetXaxis()->SetBinLabel( i+1, countNames[order[i]].c_str() );
+      h->SetBinContent( i+1, sumw[order[i]] );
+      h->SetBinError  ( i+1, sqrt(sumw2[order[i]]) );
+    }
+    return h;
+  }
+
+  // One line per counter: monitor,counter,sumw,sumw2
+  void writeCSV( std::ostream& os, bool header=true ) const {
+    if ( header ) os << "monitor,counter,sumw,sumw2" << std::endl;
+    std::streamsize prec = os.precision(12);
+    for ( size_t i=0; i<order.size(); ++i ) {
+      Handle h = order[i];
+      os << csvQuote(name) << "," << csvQuote(countNames[h]) << ","
+         << sumw[h] << "," << sumw2[h] << std::endl;
+    }
+    os.precision(prec);
+  }
+
 public:
   std::vector<std::string> countNames;
-  Cmap counters;
   size_t maxLength;
   std::string name;
 
+private:
+  // First fill: the counter is printed from now on, after those filled before
+  void show( Handle h ) {
+    filled[h] = true;
+    order.push_back(h);
+    if ( countNames[h].length()>maxLength ) maxLength = countNames[h].length();
+  }
+
+  static std::string csvQuote( const std::string& s ) {
+    std::string q("\"");
+    for ( size_t i=0; i<s.length(); ++i ) {
+      if ( s[i]=='"' ) q += '"';
+      q += s[i];
+    }
+    return q + "\"";
+  }
+
+  std::vector<double> sumw;
+  std::vector<double> sumw2;
+  std::vector<bool>   filled;
+  std::vector<Handle> order;  // filled counters, in the order of their first fill
+  Cmap index; // name -> handle
+
 };
 #endif
@@ -0,0 +1,85 @@
+#ifndef PlotBook_hh
+#define PlotBook_hh
+
+#include <vector>
+#include <map>
+#include "TString.h"
+
+class TTree;
+class TTreeFormula;
+class TTreeFormulaManager;
+class TH1;
+class TH2;
+
+//
+// Fills many histograms from a tree in a single pass.
+//
+// Book the plots as (histogram, variable, cut, weight), then call Fill()
+// once per tree. This is equivalent to one
+//   tree->Draw("var>>+histo", "(weight) * (cut)", "goff")
+// per plot, but every expression (variables, cuts, weights) is compiled
+// only once per tree and evaluated at most once per event, however many
+// plots share it. Weights are only evaluated for events passing a cut.
+//
+// Array expressions are filled for every instance as in TTree::Draw: the
+// array expressions of a plot get their own formulas, synchronized by a
+// TTreeFormulaManager, and scalars are used for all instances.
+//
+class PlotBook {
+
+public:
+	PlotBook();
+	virtual ~PlotBook();
+
+	// Returns the index of the plot, or -1 on error
+	int  Book(TH1 *h, TString var, TString cut = "1", TString weight = "1");
+	int  Book(TH2 *h, TString xvar, TString yvar, TString cut = "1", TString weight = "1");
+
+	// One pass over the tree, fills all booked histograms
+	// Returns the number of entries read, -1 if an expression is invalid
+	Long64_t Fill(TTree *tree, Long64_t nentries = -1, Long64_t firstentry = 0);
+	void     Clear();
+
+	inline int      GetNPlots()       const {return fPlots.size();};
+	inline int      GetNExpressions() const {return fExpr.size();};
+	inline TH1*     GetHisto(int i)   const {return fPlots[i].histo;};
+	// Number of selected rows, as returned by TTree::Draw
+	inline Long64_t GetNSelected(int i) const {return fPlots[i].nsel;};
+
+	void setVerbose(int v){fVerbose = v;};
+
+private:
+	enum {kX, kY, kCut, kWeight, kNSlots};
+	struct Plot {
+		TH1 *histo;
+		int expr[kNSlots]; // indices into fExpr, -1 for no y
+		Long64_t nsel;
+		// Per tree, if the plot has array expressions: their own formulas
+		// and the manager of their instances
+		TTreeFormula        *form[kNSlots];
+		TTreeFormulaManager *manager;
+	};
+
+	int    AddExpression(const TString &expr);
+	bool   Compile(TTree *tree);
+	void   DeleteFormulas();
+	void   Load(int i);
+	bool   LoadScalars(const Plot &plot);
+	double Value(const Plot &plot, int slot, int k);
+
+	std::vector<Plot>    fPlots;
+	std::vector<TString> fExpr;
+	std::map<TString, int> fExprIndex;
+
+	// Per tree, shared formulas of the scalar expressions
+	std::vector<TTreeFormula*> fForm;
+	std::vector<bool>          fScalar;
+	// Per event
+	std::vector<int>    fNdata;
+	std::vector<double> fValue;
+	std::vector<bool>   fLoaded;
+
+	int fVerbose;
+};
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef ScanGrid_hh
+#define ScanGrid_hh
+
+#include <vector>
+#include <map>
+#include "TAxis.h"
+
+class TH2D;
+
+//
+// Sparse weighted 2D grid for the signal scans: a fixed number of slots
+// (one per quantity filled in the scan) for each mass point, holding the
+// sum of weights and the sum of squared weights.
+//
+// The events of a scan come from a few hundred mass points out of a large
+// fine-binned plane, so only the cells of the bins that are actually filled
+// are allocated. Workers fill their own grid, the grids are merged with
+// Add() and written into TH2Ds with the same binning with FillHisto().
+//   ScanGrid grid(nslots, 300, 0., 1500., 300, 0., 1500.);
+//   double *cell = grid.GetCell(grid.FindBin(mGlu, mLSP));
+//   grid.Fill(cell, slot, weight);
+//
+class ScanGrid {
+
+public:
+	ScanGrid(int nslots, int nbinsx, double xmin, double xmax, int nbinsy, double ymin, double ymax);
+	virtual ~ScanGrid(){};
+
+	// Global bin number, as TH2::FindBin on the same binning
+	int FindBin(double x, double y) const;
+
+	// Sums of one bin, created on first use: [2*slot] is the sum of weights,
+	// [2*slot+1] the sum of squared weights. The pointer stays valid.
+	double* GetCell(int bin);
+	inline void Fill(double *cell, int slot, double w = 1.){
+		cell[2*slot]   += w;
+		cell[2*slot+1] += w*w;
+		fEntries[slot]++;
+	};
+
+	// Filled bins in increasing order, and their sums (0 if not filled)
+	std::vector<int> GetBins() const;
+	const double*    FindCell(int bin) const;
+
+	void Add(const ScanGrid &other);
+	// Adds the contents and errors of one slot to h
+	void FillHisto(TH2D *h, int slot) const;
+
+	inline int GetNSlots() const {return fNSlots;};
+	inline int GetNCells() const {return fCells.size();};
+
+private:
+	int   fNSlots;
+	TAxis fXaxis;
+	TAxis fYaxis;
+
+	std::map<int, std::vector<double> > fCells;
+	std::vector<Long64_t>               fEntries;
+};
+
+#endif
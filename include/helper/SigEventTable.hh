@@ -0,0 +1,104 @@
+#ifndef SigEventTable_hh
+#define SigEventTable_hh
+
+#include <vector>
+#include <map>
+#include <string>
+#include "TString.h"
+
+class TFile;
+class TTree;
+
+//
+// In-memory, column-wise copy of the SigEvents tree written by
+// SSDLDumper::fillSigEventTree.
+//
+// The table keeps the tree open and reads a branch completely the first
+// time it is used, i.e. every branch is read from file at most once,
+// however many predictions and plots loop over the signal events. Int_t
+// and Float_t branches are stored as plain arrays, std::string branches
+// (SName) as indices into the list of their distinct values.
+//
+// Filter() applies a range cut on one column to a list of rows, which
+// is the way to preselect the events of a region before looping:
+//   std::vector<int> rows;
+//   table->Select(rows);
+//   table->Filter(rows, "SystFlag", 0, 0);
+//   table->Filter(rows, "HT", 200., 8000.);
+//   table->Filter(rows, "NJ", 2);
+//
+// SigEventReader gives the same interface as the tree to the event loops
+// (SetBranchAddress, GetEntries, GetEntry) on top of the columns.
+//
+class SigEventTable {
+
+public:
+	SigEventTable();
+	virtual ~SigEventTable();
+
+	bool Open(TString filename, TString treename = "SigEvents");
+	void Close();
+	inline bool     IsOpen()      const {return fTree != 0;};
+	inline TString  GetFileName() const {return fFileName;};
+	inline Long64_t GetEntries()  const {return fNEntries;};
+
+	// Columns, read on first use. Return 0 if there is no such branch or
+	// if it has another type
+	const std::vector<int>*         GetIntColumn   (const TString &name);
+	const std::vector<float>*       GetFloatColumn (const TString &name);
+	const std::vector<int>*         GetStringIndex (const TString &name);
+	const std::vector<std::string>* GetStringValues(const TString &name);
+
+	// Row selection
+	void Select(std::vector<int> &rows) const; // all rows
+	// Removes the rows with value < min or value > max
+	bool Filter(std::vector<int> &rows, const TString &name, double min, double max = kNoLimit);
+	static const double kNoLimit;
+
+	void setVerbose(int v){fVerbose = v;};
+
+private:
+	struct StringColumn {
+		std::vector<int>         index;
+		std::vector<std::string> values;
+	};
+
+	enum ColumnType { kNone, kInt, kFloat, kString };
+	ColumnType Load(const TString &name);
+
+	TFile   *fFile;
+	TTree   *fTree;
+	TString  fFileName;
+	Long64_t fNEntries;
+
+	std::map<TString, ColumnType>         fType;
+	std::map<TString, std::vector<int> >   fIntCol;
+	std::map<TString, std::vector<float> > fFloatCol;
+	std::map<TString, StringColumn>        fStringCol;
+
+	int fVerbose;
+};
+
+class SigEventReader {
+
+public:
+	SigEventReader(SigEventTable *table) : fTable(table) {};
+	virtual ~SigEventReader(){};
+
+	void SetBranchAddress(const TString &name, int *address);
+	void SetBranchAddress(const TString &name, float *address);
+	void SetBranchAddress(const TString &name, std::string **address);
+
+	inline Long64_t GetEntries() const {return fTable->GetEntries();};
+	void GetEntry(Long64_t i);
+
+private:
+	SigEventTable *fTable;
+
+	std::vector<std::pair<const std::vector<int>*,   int*> >   fInt;
+	std::vector<std::pair<const std::vector<float>*, float*> > fFloat;
+	std::vector<std::pair<const std::vector<int>*,   std::string**> > fString;
+	std::vector<const std::vector<std::string>*>              fStringValues;
+};
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef YieldGrid_hh
+#define YieldGrid_hh
+
+#include <vector>
+#include <map>
+#include "TString.h"
+
+//
+// Cumulative weighted yield grid for the cut optimizations: a fixed number
+// of slots (one per yield, e.g. one per background and channel) for every
+// combination of lower thresholds on a few axes (HT, MET, NJ, ...).
+//
+// The events are filled once into the cell of the highest thresholds they
+// pass. Integrate() then turns the grid into a summed-area table, after
+// which every cell holds the yields of all events passing its thresholds,
+// i.e. the yield of any cut point on the grid is a single lookup:
+//   YieldGrid grid(nslots);
+//   grid.AddAxis("HT", htcuts);
+//   grid.AddAxis("NJ", njcuts);
+//   grid.Book();
+//   ...
+//   double values[2] = {HT, NJ};
+//   grid.Fill(grid.FindCell(values), slot, weight);
+//   ...
+//   grid.Integrate();
+//   double cuts[2] = {200., 3};
+//   double yield = grid.GetSum(grid.FindCut(cuts), slot);
+//
+// Events below the first threshold of an axis are not filled. The grid is
+// dense, it needs GetNCells()*GetNSlots() floats.
+//
+class YieldGrid {
+
+public:
+	YieldGrid(int nslots);
+	virtual ~YieldGrid(){};
+
+	// Adds an axis of lower thresholds (sorted, duplicates removed), before
+	// Book(). Returns the index of the axis
+	int  AddAxis(const TString &name, std::vector<double> thresholds);
+	int  FindAxis(const TString &name) const; // -1 if there is no such axis
+	bool Book();
+
+	// Cell of the highest thresholds passed by values (one per axis),
+	// -1 if a value is below the first threshold of its axis
+	Long64_t FindCell(const double *values) const;
+	inline void Fill(Long64_t cell, int slot, double w = 1.){
+		if(cell < 0) return;
+		fSums[cell*fNSlots + slot] += w;
+	};
+
+	// Sums over all cells with higher or equal thresholds on every axis
+	void Integrate();
+	inline bool IsIntegrated() const {return fIntegrated;};
+
+	// Cell of a cut point, -1 if a cut is not one of the thresholds of its
+	// axis. After Integrate(), GetSum() of this cell is the yield passing cuts
+	Long64_t FindCut(const double *cuts) const;
+	inline double GetSum(Long64_t cell, int slot) const {return fSums[cell*fNSlots + slot];};
+	double   GetThreshold(Long64_t cell, int axis) const;
+
+	void Add(const YieldGrid &other);
+
+	// Constants of the grid's filling which are needed with the yields,
+	// e.g. the probabilities applied to the event counts
+	inline void   SetParameter(const TString &name, double val){fParameters[name] = val;};
+	double        GetParameter(const TString &name) const;
+
+	inline int      GetNSlots() const {return fNSlots;};
+	inline int      GetNAxes()  const {return fNames.size();};
+	inline Long64_t GetNCells() const {return fNCells;};
+	inline const TString&             GetAxisName (int axis) const {return fNames[axis];};
+	inline const std::vector<double>& GetThresholds(int axis) const {return fThresholds[axis];};
+
+private:
+	int      fNSlots;
+	Long64_t fNCells;
+	bool     fIntegrated;
+
+	std::vector<TString>              fNames;
+	std::vector<std::vector<double> > fThresholds;
+	std::vector<Long64_t>             fStrides;    // in cells
+
+	std::vector<float>          fSums;
+	std::map<TString, double>   fParameters;
+};
+
+#endif
@@ -14,6 +14,10 @@
 # in the rootfile are added).
 # 
 # The outputs are the TreeClassBase header and implementation files.
+# Event branches are declared as LazyBranch members, fetched on first
+# access in each event. The list of branches read by a job can be
+# written with TreeClassBase::WriteBranchReport and used as the list
+# argument (alone or merged by getBranches.pl -report=...).
 #______________________________________________________________
 
 
@@ -66,6 +70,17 @@ def declareVars(names,file):
         spaces = (indent-13)*' '+' '
         file.write(4*' '+'edm::InputTag'+spaces+'t'+name+';\n')
 
+#______________________________________________________________
+def declareLazyVars(names,file):
+    indent = 35 # Formatting attempt
+    for k,v in sorted(names.iteritems()):
+        type = 'LazyBranch<'+typename(v)
+        if isVector(v): type += ' >'
+        else: type += '>'
+	name = k[0] if k[0] is not "" else k[1]
+        spaces = (indent-len(type))*' '+' '
+        file.write(4*' '+type+spaces+' '+name+';\n')
+
 #______________________________________________________________
 def getVars(names,file,spaces,treename):
     indent = spaces*' '
@@ -85,6 +100,14 @@ def defineLabels(names,file):
         spaces = (indent-len(name))*' '
         file.write(4*' '+'t'+name+spaces+' = edm::InputTag("'+k[1]+'","'+k[0]+'");\n')
 
+#______________________________________________________________
+def registerBranches(names,file):
+    indent = 25
+    for k,v in sorted(names.iteritems()):
+	name = k[0] if k[0] is not "" else k[1]
+        spaces = (indent-len(name))*' '
+        file.write(4*' '+'RegisterBranch('+name+','+spaces+'edm::InputTag("'+k[1]+'","'+k[0]+'"), "'+name+'");\n')
+
 #______________________________________________________________
 def processImpl(rBranches,eBranches):
     finput = open('src/base/'+SOURCENAME+'.tpl')
@@ -101,13 +124,11 @@ def processImpl(rBranches,eBranches):
         if m1:
             if m1.group(1) == 'RUN':
                 getVars(rBranches,foutput,6,'run.')
-            elif m1.group(1) == 'EVENT':
-                getVars(eBranches,foutput,4,'event->')
             else:
                 print >>sys.stderr,'*** Unknown header pattern:',line
         elif m2:
             defineLabels(rBranches,foutput)
-            defineLabels(eBranches,foutput)
+            registerBranches(eBranches,foutput)
         else:
             foutput.write(line)
 
@@ -130,7 +151,7 @@ def processHeader(rBranches,eBranches):
             if m.group(1) == 'RUN':
                 declareVars(rBranches,foutput)
             elif m.group(1) == 'EVENT':
-                declareVars(eBranches,foutput)
+                declareLazyVars(eBranches,foutput)
             else:
                 print >>sys.stderr,'*** Unknown header pattern:',line
         else:
@@ -1,5 +1,4 @@
 #include "helper/Utilities.hh"
-#include "helper/Davismt2.h"
 #include "helper/Hemisphere.hh"
 #include "SolveTTbarNew.hh"
 #include "SFlightFuncs_EPS2013.hh"
@@ -12,533 +11,32 @@
 #include "TTree.h"
 #include "TMinuit.h"
 #include <cstdlib>
+#include <cstring>
+#include <fstream>
 using namespace std;
 
 bool UseForZPlusB=false;
 
-
-
-#define jMax 30  // do not touch this
-#define lMax 10
-#define Zmax 5
-
-enum METTYPE { mettype_min, RAW = mettype_min, T1PFMET, TCMET, MUJESCORRMET, PFMET, SUMET, PFRECOILMET, RECOILMET, mettype_max };
-enum JZBTYPE { jzbtype_min, TYPEONECORRPFMETJZB = jzbtype_min, PFJZB, RECOILJZB, PFRECOILJZB, TCJZB, jzbtype_max };
-
 string sjzbversion="$Revision: 1.70.2.132 $";
 string sjzbinfo="";
-TRandom3 *r;
-rochcor2012 *rmcor;
-TF1 *L5corr_bJ;
-TF1 *L5corr_qJ;
-TF1 *L5corr_cJ;
-TF1 *L5corr_gJ;
-
-TF1 *CSVL__SFlight_0p0_to_0p5;
-TF1 *CSVL__SFlight_0p5_to_1p0;
-TF1 *CSVL__SFlight_1p0_to_1p5;
-TF1 *CSVL__SFlight_1p5_to_2p4;
-
-TF1 *CSVM__SFlight_0p0_to_0p8;
-TF1 *CSVM__SFlight_0p8_to_1p6;
-TF1 *CSVM__SFlight_1p6_to_2p4;
-TF1 *CSVT__SFlight;
-
-TF1 *lowCSVL__SFlight_0p0_to_0p5;
-TF1 *lowCSVL__SFlight_0p5_to_1p0;
-TF1 *lowCSVL__SFlight_1p0_to_1p5;
-TF1 *lowCSVL__SFlight_1p5_to_2p4;
-
-TF1 *lowCSVM__SFlight_0p0_to_0p8;
-TF1 *lowCSVM__SFlight_0p8_to_1p6;
-TF1 *lowCSVM__SFlight_1p6_to_2p4;
-
-TF1 *lowCSVT__SFlight;
-
-TF1 *highCSVL__SFlight_0p0_to_0p5;
-TF1 *highCSVL__SFlight_0p5_to_1p0;
-TF1 *highCSVL__SFlight_1p0_to_1p5;
-TF1 *highCSVL__SFlight_1p5_to_2p4;
-
-TF1 *highCSVM__SFlight_0p0_to_0p8;
-TF1 *highCSVM__SFlight_0p8_to_1p6;
-TF1 *highCSVM__SFlight_1p6_to_2p4;
-
-TF1 *highCSVT__SFlight;
-
-TF1 *CSVL_SFb;
-TF1 *CSVM_SFb;
-TF1 *CSVT_SFb;
-
-
-SolveTTbarNew *solver;
 
 float firstLeptonPtCut  = 10.0;
 float secondLeptonPtCut = 10.0;
 
-TMinuit *minuit;
-
 /*
   $Id: JZBAnalysis.cc,v 1.70.2.132 2013/06/20 06:59:05 buchmann Exp $
 */
 
 
-Double_t GausRandom(Double_t mu, Double_t sigma) { 
-  return gRandom->Gaus(mu,sigma);   //real deal
+Double_t JZBAnalysis::GausRandom(Double_t mu, Double_t sigma) { 
+  TRandom *rnd = fSmearRand ? fSmearRand : gRandom;
+  return rnd->Gaus(mu,sigma);   //real deal
   //return mu;//debugging : no smearing
 }
 
-class nanoEvent
-{
-public:
-  nanoEvent();
-  void reset();
-
-  float mll; // di-lepton system
-  float minc;
-  float pt;
-  float phi;
-  float eta;
-  float E;
-  bool is_data;
-
-  float l1l2dR;
-  float pt1; // leading leptons
-  float pt2;
-  float Ropt1; // Rochester corrected lepton
-  float Ropt2; // Rochester corrected lepton
-  float Romll; // Rochester corrected di-lepton mass
-  float iso1;
-  float iso2;
-  float dz1, dz2;
-  float d01, d02;
-  bool  isConv1; // Photon conversion flag
-  bool  isConv2;
-  bool softMuon;
-
-  int NgenLeps;
-  int NgenZs;
-  
-  float genPt1; // leading legenPtons
-  float genPt2;
-  float genDRll;
-  float genPhi1;
-  float genPhi2;
-  int   genId1;
-  int   genId2;
-  int   genMID1gen;
-  int   genMID2gen;
-  int   genMID1;
-  int   genMID2;
-  int   genGMID1gen;
-  int   genGMID2gen;
-  int   genGMID1;
-  int   genGMID2;
-  float genEta1; // leading legenPtons
-  float genEta2;
-  float genMET;
-  float genZPt;    // True Z Pt
-  float genMll;
-  float genRecoil;
-  float genJZB;
-  int   genNjets;
-  int   genNleptons;
-  float genRecoilSel;
-  float genPt1Sel; // Selected leptons
-  float genPt2Sel;
-  float genEta1Sel;
-  float genEta2Sel;
-  int   genId1Sel;
-  int   genId2Sel;
-  float genZPtSel; // Z candidate from selected leptons
-  float genMllSel;
-  float genJZBSel;
-  float eta1; // leading leptons
-  float eta2;
-  float phi1;
-  float phi2;
-  float dphi;
-  float dphiZpfMet;
-  float dphigenZgenMet;
-  float dphiZs1;
-  float dphiZs2;
-  float dphiMet1;
-  float dphiMet2;
-  float dphitcMet1;
-  float dphitcMet2;
-  float dphipft1Met1;
-  float dphipft1Met2;
-  float dphipfRecoilMet1;
-  float dphipfRecoilMet2;
-  
-  float pfMET;
-  float t1pfMET;
-
-  bool ElCInfoIsGsfCtfCons;
-  bool ElCInfoIsGsfCtfScPixCons;
-  bool ElCInfoIsGsfScPixCons;
-
-  int id1;
-  int id2;
-  int ch1;
-  int ch2;
-  int chid1; // old id (kostas convention)
-  int chid2;
-
-  int process;
-
-  int leptonNum; // store all leptons (reduntant for the 2 leptons that form the Z)
-  float leptonPt[lMax]; 
-  float leptonEta[lMax];
-  float leptonPhi[lMax];
-  int leptonId[lMax];
-  int leptonCharge[lMax];
-
-  int leptonPairNum;
-  int leptonPairId[jMax];
-  float leptonPairMass[jMax];
-  float leptonPairDphi[jMax];
-
-
-  int pfJetNum;
-  float pfJetPt[jMax];
-  float pfJetEta[jMax];
-  float pfJetPhi[jMax];
-  bool  pfJetID[jMax];
-  float pfJetScale[jMax];
-  float pfJetScaleUnc[jMax];
-  float pfJetDphiMet[jMax];
-  float pfJetDphiZ[jMax];
-  float pfBJetDphiZ[jMax];
-  float pfHT;
-  float pfGoodHT;
-  float pfTightHT;
-  float rho;
- 
-  float metUncertainty;
-  float type1metUncertainty;
-  
-  int pfJetGoodNum30;
-  int pfJetGoodNum30Fwd;
-  int pfJetGoodNumID;
-  int pfJetGoodNump1sigma;
-  int pfJetGoodNumn1sigma;
-  int pfJetGoodNum40p1sigma;
-  int pfJetGoodNum40n1sigma;
-  int pfJetGoodNum50p1sigma;
-  int pfJetGoodNum50n1sigma;
-  int pfJetGoodNum40CHS;
-  float pfJetGoodPt[jMax];
-  float pfJetGoodEta[jMax];
-  float pfJetGoodPhi[jMax];
-  float pfJetGoodE[jMax];
-  float pfJetGoodMl[jMax];
-  float pfJetGoodM[jMax];
-  float pfJetGoodPtl[jMax];
-  float pfJetGoodID[jMax];
-  int   pfJetGoodTracks[jMax];
-  int   pfJetGoodTracksN[jMax];
-  float bTagProbCSVBP[jMax];
-  float bTagProbCSVMVA[jMax];
-  float bTagProbJP[jMax];
-  float bTagProbTCHP[jMax];
- 
-  int MC_pfJetGoodNumBTag40;
-  int MC_pfJetGoodNumBTag40dn;
-  int MC_pfJetGoodNumBTag40up;
-  int pfJetGoodNumBtag30;
-  int pfJetGoodNumBtag40;
-  int pfJetGoodNumBtag40CSVBPLoose;
-  int pfJetGoodNumBtag40CSVBPTight;
-  int pfJetGoodNumBtag40CSVMVA;
-  int pfJetGoodNumBtag40JP;
-  int pfJetGoodNumBtag40TCHP;
-  
-  int pfJetGoodNumBtag40up;
-  int pfJetGoodNumBtag40dn;
-  int pfJetGoodNumBtag30_Tight;
-  int pfJetGoodNumBtag40_Tight;
-  int pfJetGoodNumBtag30_Loose;
-  int pfJetGoodNumBtag40_Loose;
-  int pfJetGoodNumIDBtag;
-  float pfJetGoodPtBtag[jMax];
-  float pfJetGoodEtaBtag[jMax];
-  float pfJetGoodPhiBtag[jMax];
-  float pfJetGoodEBtag[jMax];
-  float pfJetGoodMlBtag[jMax];
-  float pfJetGoodMBtag[jMax];
-  float pfJetGoodPtlBtag[jMax];
-  bool  pfJetGoodIDBtag[jMax];
-  int   pfJetGoodTracksBtag[jMax];
-  int   pfJetGoodTracksNBtag[jMax];
-
-  int pfJetGoodNum40;
-  int pfJetGoodNum40Fwd;
-  int pfJetGoodNum50;
-  int pfJetGoodNum50Fwd;
-  int pfJetGoodNum60;
-  int pfJetGoodNum60Fwd;
-
-  int EventFlavor;
-  bool EventZToTaus;
-  
-  float met[mettype_max];
-  float metPhi[mettype_max];
-  float dphiMetLep[mettype_max];
-  float dphiMetJet[mettype_max];
-  float dphiMetSumJetPt[mettype_max];
-  float metPerp[mettype_max];
-  float metPar[mettype_max];
-  ULong64_t eventNum;
-  int runNum;
-  int lumi;
-  int goodVtx;
-  int numVtx;
-  float totEvents; // tot events processed by the ntuple producer (job submission efficiency), no need to keep this as int, better as float
-  int badJet;
-
-  float jzb[jzbtype_max];
-  float chs_jzb;
-  float d2;
-  float mt2;
-  float mt2j;
-  float ml1b;
-  float ml2b;
-  float drl1b, drl2b;
-  float mjl[jMax];
-  float mjll[jMax];
-  float st;
-  float sjzb[jzbtype_max]; // smeared JZB
-  float dphi_sumJetVSZ[jzbtype_max];
-  float sumJetPt[jzbtype_max];
-  float MR,MRT,Razor;
-
-  float weight;
-  float weight_2BJets;
-  float weightEffDown;
-  float weightEffUp;
-  float Efficiencyweightonly;
-
-  float lheV_pt;
-  float lheV_mll;
-  float lheHT;
-  int lheNj;
-  float genTopPt;
-  float genAntiTopPt;
-  float benWeight;
-  float topWeight;
-
-  int NPdfs;
-  float pdfW[100];
-  float pdfWsum;
-  float PUweight,PUweightUP,PUweightDOWN;
-  bool passed_triggers;
-  int trigger_bit;
-  bool passed_filters;
-  int filter_bit;
-  float mGlu;
-  float mChi;
-  float mLSP;
-  float xSMS;
-  float xbarSMS;
-  float mGMSBGlu;
-  float mGMSBChi;
-  float mGMSBLSP;
-  
-  
-  //gen information
-  int nZ; // number of generator Z's in the process
-  int SourceOfZ[Zmax];//mother particle of the (first Zmax) Z's
-  int DecayCode; //decay code: 100*h + l, where h = number of hadronically decaying Z's, l = number of leptonically decaying Z's (e.g. 102 = 1 had. Z, 2 lep. Z's)
-  float realx; // this is the "x" we measure (for scans)
-  float imposedx; // this is the "x" we imposed.
-  float GeneratorZPt;
-  float pureGeneratorZpt;
-  float pureGeneratorZM;
-  float pureGeneratorZphi;
-  float pureGeneratorZeta;
-  float pureGeneratorJZB;
-  float pureGeneratorMet;
-  float pureGeneratorMetPhi;
-  float pureGeneratorSumJetPt;
-  float pureGeneratorSumJetEta;
-  float pureGeneratorSumJetPhi;
-  float pure2ndGeneratorJZB;
-  float pure2ndGeneratorZpt;
-  int nLSPs;
-  float angleLSPLSP;
-  float angleLSPLSP2d;
-  float angleLSPZ;
-  float angleLSPZ2d;
-  float angleChi2Z2d;
-  float angleChi2Z;
-  float dphiSumLSPgenMET;
-  float SumLSPEta;
-  float SumLSPPhi;
-  float absvalSumLSP;
-  int LSPPromptnessLevel[2];
-  int ZPromptnessLevel[2];
-  float LSP1pt;
-  float LSP2pt;
-  int LSP1Mo;
-  int LSP2Mo;
-  float LSP1Mopt;
-  float LSP2Mopt;
-  
-  //Z+b variables
-  
-  bool HasSoftLepton;
-  float SoftLeptonPt;
-  
-  float mpf;
-  float mpf_JS;
-  float mpf_L5;
-  float fake_mpf;
-  
-  float ZbCHS3015_alpha;
-  float ZbCHS3015_alphaUp;
-  float ZbCHS3015_alphaDown;
-  float ZbCHS3015_alphaL5;
-  float ZbCHS3015_L5corr;
-  int ZbCHS3015_JetFlavor;
-  
-  float ZbCHS3015_bTagProbCSVBP[jMax]; 
-  int ZbCHS3015_pfJetGoodNumBtag; 
-  float ZbCHS3015_pfJetGoodEta[jMax]; 
-  int ZbCHS3015_pfJetGoodNum;
-  float ZbCHS3015_pfJetDphiZ[jMax];
-  float ZbCHS3015_pfJetGoodPt[jMax];
-  float ZbCHS3015_pfJetGoodUnsmearedPt[jMax];
-  float ZbCHS3015_pfJetSum;
-  float ZbCHS3015_pfBJetDphiZ[jMax];
-
-  float ZbCHS3015_BTagWgtT;
-  float ZbCHS3015_BTagWgtTUp;
-  float ZbCHS3015_BTagWgtTDown;
-  float ZbCHS3015_BTagWgtM;
-  float ZbCHS3015_BTagWgtMUp;
-  float ZbCHS3015_BTagWgtMDown;
-  float ZbCHS3015_BTagWgtL;
-  float ZbCHS3015_BTagWgtLUp;
-  float ZbCHS3015_BTagWgtLDown;
-  bool ZbCHS3015_LeadingJetIsPu;
-  bool ZbCHS3015_SubLeadingJetIsPu;
-  
-  
-  float fact;
-  
-  //Trilepton variables
-  float tri_pt1;
-  float tri_pt2;
-  float tri_pt3;
-  float tri_eta1;
-  float tri_eta2;
-  float tri_eta3;
-  bool tri_MatchFound;
-  int tri_id1;
-  int tri_id2;
-  int tri_id3;
-  int tri_ch1;
-  int tri_ch2;
-  int tri_ch3;
-  float tri_mlll;
-  float tri_badmll;
-  float tri_mll;
-  float tri_submll;
-  float tri_badsubmll;
-  float tri_mT;
-  float tri_badmT;
-  int tri_genMID1;
-  int tri_genMID2;
-  int tri_genMID3;
-  int tri_badgenMID1;
-  int tri_badgenMID2;
-  int tri_badgenMID3;
-
-  float tri_dR12;
-  float tri_dR13;
-  float tri_dR23;
-  int tri_index1;
-  int tri_index2;
-  int tri_index3;
-  int tri_badindex1;
-  int tri_badindex2;
-  int tri_badindex3;
-  int tri_badid1;
-  int tri_badid2;
-  int tri_badid3;
-  bool tri_GoodZMatch;
-  bool tri_GoodWMatch;
-  
-  float gentri_pt1;
-  float gentri_pt2;
-  float gentri_pt3;
-  float gentri_eta1;
-  float gentri_eta2;
-  float gentri_eta3;
-  float gentri_id1;
-  float gentri_id2;
-  float gentri_id3;
-  float gentri_ch1;
-  float gentri_ch2;
-  float gentri_ch3;
-  float gentri_mlll;
-  float gentri_mll;
-  float gentri_badmll;
-  float gentri_submll;
-  float gentri_badsubmll;
-  float gentri_mT;
-  float gentri_badmT;
-  int gentri_genMID1;
-  int gentri_genMID2;
-  int gentri_genMID3;
-  int gentri_badgenMID1;
-  int gentri_badgenMID2;
-  int gentri_badgenMID3;
-  float gentri_dR12;
-  float gentri_dR13;
-  float gentri_dR23;
-  bool gentri_GoodZMatch;
-  bool gentri_GoodWMatch;
-  
-  float pgentri_pt1;
-  float pgentri_pt2;
-  float pgentri_pt3;
-  float pgentri_eta1;
-  float pgentri_eta2;
-  float pgentri_eta3;
-  float pgentri_id1;
-  float pgentri_id2;
-  float pgentri_id3;
-  float pgentri_ch1;
-  float pgentri_ch2;
-  float pgentri_ch3;
-  float pgentri_mlll;
-  float pgentri_mll;
-  float pgentri_submll;
-  float pgentri_mT;
-  float pgentri_dR12;
-  float pgentri_dR13;
-  float pgentri_dR23;
-  
-  float dRmerged;
-  int merged;
-  float mergedPt;
-  float mergedEta;
-  float mergedPhoHCalIso2012ConeDR03;
-  float mergedPhoSigmaIetaIeta;
-  float mergedpfchargedhadiso;
-  float mergedpfneutralhadiso;
-  float mergedpfphotoniso;
-  
-  float SL_pt;
-  float SL_eta;
-  bool SL_Accept;
-  int SL_id;
-
+nanoEvent::nanoEvent(){
+  memset(this,0,sizeof(nanoEvent)); // also the fields which reset() leaves alone
 };
-
-nanoEvent::nanoEvent(){};
 void nanoEvent::reset()
 {
 
@@ -1022,11 +520,6 @@ void nanoEvent::reset()
 }
 
 
-TTree *myTree;
-TTree *myInfo;
-TH1F *weight_histo;
-
-nanoEvent nEvent;
   
 
 void JZBAnalysis::CalcRazor(float& MR, float& MRT, float& R, TLorentzVector& met) {
@@ -1121,12 +614,7 @@ Double_t JZBAnalysis::CalcMT2(double testmass, bool massive, TLorentzVector visi
   pb[1] = visible2.Px();
   pb[2] = visible2.Py();
 
-  Davismt2 *mt2 = new Davismt2();
-  mt2->set_momenta(pa, pb, pmiss);
-  mt2->set_mn(testmass);
-  Double_t MT2=mt2->get_mt2();
-  delete mt2;
-  return MT2;
+  return fMT2Calc.getMT2(pa, pb, pmiss, testmass);
 
 }
 
@@ -1162,22 +650,31 @@ void JZBAnalysis::ComputeD2MT2(float &FinalD2,float &FinalMT2) {
   bj1.SetPtEtaPhiE(nEvent.pfJetGoodPt[0], nEvent.pfJetGoodEta[0], nEvent.pfJetGoodPhi[0], nEvent.pfJetGoodE[0]);
   bj2.SetPtEtaPhiE(nEvent.pfJetGoodPt[1], nEvent.pfJetGoodEta[1], nEvent.pfJetGoodPhi[1], nEvent.pfJetGoodE[1]);
   bj3.SetPtEtaPhiE(nEvent.pfJetGoodPt[2], nEvent.pfJetGoodEta[2], nEvent.pfJetGoodPhi[2], nEvent.pfJetGoodE[2]);
-  double d1 = -1, d2 = -1, d3 = -1;
   nEvent.id1 ? l1.SetPtEtaPhiM(nEvent.pt1, nEvent.eta1, nEvent.phi1, 0.151) : l1.SetPtEtaPhiM(nEvent.pt1, nEvent.eta1, nEvent.phi1, 0.00051);
   nEvent.id2 ? l2.SetPtEtaPhiM(nEvent.pt2, nEvent.eta2, nEvent.phi2, 0.151) : l2.SetPtEtaPhiM(nEvent.pt2, nEvent.eta2, nEvent.phi2, 0.00051);
-  if(b1 != bj1) d1 = getD2(solver, b1, bj1, l1, l2, nEvent.met[4], nEvent.metPhi[4]);
-  if(b1 != bj2) d2 = getD2(solver, b1, bj2, l1, l2, nEvent.met[4], nEvent.metPhi[4]);
-  if(b1 != bj3) d3 = getD2(solver, b1, bj3, l1, l2, nEvent.met[4], nEvent.metPhi[4]);
-  if(d1 == -1 && d2 == -1 && d3 == -1) d2 = -1; 
-  if(d1 == -1 && d2 == -1 && d3 != -1) d2 = d3; 
-  if(d1 == -1 && d2 != -1 && d3 == -1) d2 = d2; 
-  if(d1 != -1 && d2 == -1 && d3 == -1) d2 = d1; 
-  if(d1 != -1 && d2 != -1 && d3 == -1) d2 = TMath::Min(d1, d2);
-  if(d1 != -1 && d2 == -1 && d3 != -1) d2 = TMath::Min(d1, d3);
-  if(d1 == -1 && d2 != -1 && d3 != -1) d2 = TMath::Min(d2, d3);
-  if(d1 != -1 && d2 != -1 && d3 != -1) {
-    double auxiliar = TMath::Min(d1, d2);
-    d2 = TMath::Min(auxiliar, d3);
+
+  // all pairings of the b-tagged jet with one of the three leading jets in one call
+  TLorentzVector bj[3] = {bj1, bj2, bj3};
+  double pb1[3][4], pb2[3][4];
+  int npairs = 0;
+  for(int i = 0; i < 3; i++) {
+    if(b1 == bj[i]) continue;
+    pb1[npairs][0] = b1.Px();    pb1[npairs][1] = b1.Py();    pb1[npairs][2] = b1.Pz();    pb1[npairs][3] = b1.Pt();
+    pb2[npairs][0] = bj[i].Px(); pb2[npairs][1] = bj[i].Py(); pb2[npairs][2] = bj[i].Pz(); pb2[npairs][3] = bj[i].Pt();
+    npairs++;
+  }
+  double pl1[4] = {l1.Px(), l1.Py(), l1.Pz(), l1.Pt()};
+  double pl2[4] = {l2.Px(), l2.Py(), l2.Pz(), l2.Pt()};
+  double met = nEvent.met[4], metphi = nEvent.metPhi[4];
+  double ptM[] = {met*cos(metphi), met*sin(metphi)};
+  SolveTTbarNew::D2Result res[3];
+  solver->MinimizePairings(npairs, pb1, pb2, pl1, pl2, ptM, res);
+
+  // smallest D2 of the pairings with a good minimum, -1 if none
+  double d2 = -1;
+  for(int i = 0; i < npairs; i++) {
+    if(fabs(res[i].q1z)>=8000.||fabs(res[i].q2z)>=8000.||res[i].q1z==0.||res[i].q2z==0.||res[i].edm>0.01||res[i].status!=0) continue;
+    if(d2 == -1 || res[i].d2 < d2) d2 = res[i].d2;
   }
       
   double mt2 = CalcMT2(0., 0, l1, l2,  MET);
@@ -1418,6 +915,16 @@ JZBAnalysis::JZBAnalysis(TreeReader *tr, std::string dataType, std::string globa
   addPath(singleElTriggerPaths, "HLT_Ele27_WP80", 0, 20);
   addPath(singleMuTriggerPaths, "HLT_IsoMu24_eta2p1", 0, 20);
 
+  // Resolved to trigger bits at each new HLT menu
+  elTriggers       = AddTriggerMenu(elTriggerPaths);
+  muTriggers       = AddTriggerMenu(muTriggerPaths);
+  emTriggers       = AddTriggerMenu(emTriggerPaths);
+  meTriggers       = AddTriggerMenu(meTriggerPaths);
+  metTriggers      = AddTriggerMenu(metTriggerPaths);
+  htTriggers       = AddTriggerMenu(htTriggerPaths);
+  singleElTriggers = AddTriggerMenu(singleElTriggerPaths);
+  singleMuTriggers = AddTriggerMenu(singleMuTriggerPaths);
+
   
   L5corr_bJ = new TF1("L5corr_bJ","[0]+log10((x-[3])/[4])*([1]+[2]*log10((x-[3])/[4]))",10,3650);
   L5corr_bJ->SetParameters(1.05724,-0.031178,0.009538,6.80258,0.851021); //values from /shome/buchmann/material/JEStxtfiles/GR_R_50_V9_L5Flavor_bJ_AK5PFchs.txt
@@ -1436,6 +943,12 @@ JZBAnalysis::JZBAnalysis(TreeReader *tr, std::string dataType, std::string globa
   //To get the central value of the momentum correction
   rmcor = new rochcor2012(); // make the pointer of rochcor2012 class
 
+  // Made in Begin
+  rand_ = NULL;
+  r = NULL;
+  fSmearRand = NULL;
+  minuit = NULL;
+  weight_histo = NULL;
 }
 
 //________________________________________________________________________________________
@@ -1547,41 +1060,40 @@ float JZBAnalysis::SFb_Uncertainty(const float pt, const string csvtype) {
 }
 
 //________________________________________________________________________________________
-JZBAnalysis::~JZBAnalysis(){}
-
-void JZBAnalysis::InitializeScalingFactors() {
-  CSVL__SFlight_0p0_to_0p5 = GetSFlmean("CSV","L",0.0, 0.5, "ABCD");
-  CSVL__SFlight_0p5_to_1p0 = GetSFlmean("CSV","L",0.5, 1.0, "ABCD");
-  CSVL__SFlight_1p0_to_1p5 = GetSFlmean("CSV","L",1.0, 1.5, "ABCD");
-  CSVL__SFlight_1p5_to_2p4 = GetSFlmean("CSV","L",1.5, 2.4, "ABCD");
-
-  CSVM__SFlight_0p0_to_0p8 = GetSFlmean("CSV","M",0.0, 0.8, "ABCD");
-  CSVM__SFlight_0p8_to_1p6 = GetSFlmean("CSV","M",0.8, 1.6, "ABCD");
-  CSVM__SFlight_1p6_to_2p4 = GetSFlmean("CSV","M",1.6, 2.4, "ABCD");
-
-  CSVT__SFlight            = GetSFlmean("CSV","T",0.0, 2.4, "ABCD");
-
-  lowCSVL__SFlight_0p0_to_0p5 = GetSFlmin("CSV","L",0.0, 0.5, "ABCD");
-  lowCSVL__SFlight_0p5_to_1p0 = GetSFlmin("CSV","L",0.5, 1.0, "ABCD");
-  lowCSVL__SFlight_1p0_to_1p5 = GetSFlmin("CSV","L",1.0, 1.5, "ABCD");
-  lowCSVL__SFlight_1p5_to_2p4 = GetSFlmin("CSV","L",1.5, 2.4, "ABCD");
-
-  lowCSVM__SFlight_0p0_to_0p8 = GetSFlmin("CSV","M",0.0, 0.8, "ABCD");
-  lowCSVM__SFlight_0p8_to_1p6 = GetSFlmin("CSV","M",0.8, 1.6, "ABCD");
-  lowCSVM__SFlight_1p6_to_2p4 = GetSFlmin("CSV","M",1.6, 2.4, "ABCD");
+JZBAnalysis::~JZBAnalysis(){
+  delete L5corr_bJ;
+  delete L5corr_cJ;
+  delete L5corr_qJ;
+  delete L5corr_gJ;
+  delete fBTagSF;
+  delete fBTagSFup;
+  delete fBTagSFdn;
+  delete fRand3Normal;
+  delete rmcor;
+  delete rand_;
+  delete r;
+  delete fSmearRand;
+  delete minuit;
+  delete weight_histo;
+}
 
-  lowCSVT__SFlight            = GetSFlmin("CSV","T",0.0, 2.4, "ABCD");
+//________________________________________________________________________________________
+void JZBAnalysis::SetSmearingSeed(UInt_t seed) {
+  delete fSmearRand;
+  fSmearRand = new TRandom3(seed);
+}
 
-  highCSVL__SFlight_0p0_to_0p5 = GetSFlmax("CSV","L",0.0, 0.5, "ABCD");
-  highCSVL__SFlight_0p5_to_1p0 = GetSFlmax("CSV","L",0.5, 1.0, "ABCD");
-  highCSVL__SFlight_1p0_to_1p5 = GetSFlmax("CSV","L",1.0, 1.5, "ABCD");
-  highCSVL__SFlight_1p5_to_2p4 = GetSFlmax("CSV","L",1.5, 2.4, "ABCD");
+void JZBAnalysis::InitializeScalingFactors() {
+  CSVL__SFlight_0p0_to_0p5 = GetSFLightPar("CSV","L",0.0, 0.5, "ABCD");
+  CSVL__SFlight_0p5_to_1p0 = GetSFLightPar("CSV","L",0.5, 1.0, "ABCD");
+  CSVL__SFlight_1p0_to_1p5 = GetSFLightPar("CSV","L",1.0, 1.5, "ABCD");
+  CSVL__SFlight_1p5_to_2p4 = GetSFLightPar("CSV","L",1.5, 2.4, "ABCD");
 
-  highCSVM__SFlight_0p0_to_0p8 = GetSFlmax("CSV","M",0.0, 0.8, "ABCD");
-  highCSVM__SFlight_0p8_to_1p6 = GetSFlmax("CSV","M",0.8, 1.6, "ABCD");
-  highCSVM__SFlight_1p6_to_2p4 = GetSFlmax("CSV","M",1.6, 2.4, "ABCD");
+  CSVM__SFlight_0p0_to_0p8 = GetSFLightPar("CSV","M",0.0, 0.8, "ABCD");
+  CSVM__SFlight_0p8_to_1p6 = GetSFLightPar("CSV","M",0.8, 1.6, "ABCD");
+  CSVM__SFlight_1p6_to_2p4 = GetSFLightPar("CSV","M",1.6, 2.4, "ABCD");
 
-  highCSVT__SFlight            = GetSFlmax("CSV","T",0.0, 2.4, "ABCD");
+  CSVT__SFlight            = GetSFLightPar("CSV","T",0.0, 2.4, "ABCD");
 
   CSVL_SFb = new TF1("CSVL_SFb","0.997942*((1.+(0.00923753*x))/(1.+(0.0096119*x)));",0,800);
   CSVM_SFb = new TF1("CSVM_SFb","(0.938887+(0.00017124*x))+(-2.76366e-07*(x*x))",0,800);
@@ -1592,6 +1104,8 @@ void JZBAnalysis::InitializeScalingFactors() {
 void JZBAnalysis::Begin(TFile *f){
 
   solver = new SolveTTbarNew();
+  // Load the minimizer plugin here and not in the (parallel) event loop
+  delete ROOT::Math::Factory::CreateMinimizer("Minuit2", "");
   minuit = new TMinuit();
 
   if(UseForZPlusB) InitializeScalingFactors();
@@ -2096,20 +1610,54 @@ void JZBAnalysis::Begin(TFile *f){
   counters[PJ].setName("PFJets");
   counters[PH].setName("Photons");
 
+  // Book counters, they are printed in the order of their first fill
+  static const char* evNames[evCut_end] = {
+    "All events", "... pass electron triggers", "... pass muon triggers",
+    "... pass EM triggers", "... pass ME triggers", "... pass MET triggers",
+    "... pass HT triggers", "... pass good event requirements",
+    "... has at least 2 leptons", "... has at least 2 OS leptons",
+    "... pass dilepton pt selection" };
+  static const char* muNames[muCut_end] = {
+    "All mus", " ... pt > 10", " ... |eta| < 2.4", " ... is global muon",
+    " ... is tracker muon", " ... is pf muon", " ... nChi2 < 10", " ... nValidHits > 0",
+    " ... nPxHits > 0", " ... nMatchedStations > 1", " ... nLayers > 5",
+    " ... D0(pv) < 0.02", " ... DZ(pv) < 0.1", " ... Iso < 0.15", "... pass mu selection" };
+  static const char* elNames[elCut_end] = {
+    "All eles", " ... |eta| < 2.5", " ... pT > 10", " ... pass additional electron ID cuts",
+    " ... N(missing inner hits) <= 1", " ... |1/e-1/p|<0.05", " ... DR(e,mu)>0.1",
+    " ... D0(PV)<0.02", " ... DZ(PV)<0.1", " ... passed conversion rejection",
+    " ... not in ECAL gap", " ... pfIso  < 0.15 (or 0.1 for endcaps with pt<20)",
+    "... pass e selection" };
+  static const char* jeNames[jeCut_end] = {
+    " ... n90Hits > 1", " ... HPD < 0.98", " ... pass EMfrac cut" };
+  static const char* pjNames[pjCut_end] = {
+    "All PF jets", "... pass full lepton cleaning", "... pass lepton 1 veto",
+    "... pass lepton 2 veto", "... pt>20.", "... |eta|<3.0", "... pass Jet ID",
+    "... pass tight jet selection" };
+  for ( int i=0; i<evCut_end; ++i ) evCuts[i] = counters[EV].book(evNames[i]);
+  for ( int i=0; i<muCut_end; ++i ) muCuts[i] = counters[MU].book(muNames[i]);
+  for ( int i=0; i<elCut_end; ++i ) elCuts[i] = counters[EL].book(elNames[i]);
+  for ( int i=0; i<jeCut_end; ++i ) jeCuts[i] = counters[JE].book(jeNames[i]);
+  for ( int i=0; i<pjCut_end; ++i ) pjCuts[i] = counters[PJ].book(pjNames[i]);
+  trAll = counters[TR].book("All selected events");
+  std::string types[4] = { "ee","mm","em","unknown" };
+  for ( size_t itype=0; itype<4; ++itype ) {
+    pairCounters[itype][0] = counters[EV].book("... "+types[itype]+" pairs");
+    pairCounters[itype][1] = counters[EV].book("... "+types[itype]+" + 2 jets");
+    pairCounters[itype][2] = counters[EV].book("... "+types[itype]+" + 2 jets + require Z");
+    pairCounters[itype][3] = counters[EV].book("... "+types[itype]+" + 2 jets + require Z + JZB>50");
+  }
+
   // Define counters (so we have them in the right order)
-  counters[EV].fill("All events",0.);
+  counters[EV].fill(evCuts[evAll],0.);
   if ( fDataType_ != "mc" ) {
-    counters[EV].fill("... pass electron triggers",0.);
-    counters[EV].fill("... pass muon triggers",0.);
-    counters[EV].fill("... pass EM triggers",0.);
-    counters[EV].fill("... pass MET triggers",0.);
+    counters[EV].fill(evCuts[evElTrig],0.);
+    counters[EV].fill(evCuts[evMuTrig],0.);
+    counters[EV].fill(evCuts[evEMTrig],0.);
+    counters[EV].fill(evCuts[evMETTrig],0.);
   }
-  std::string types[3] = { "ee","mm","em" };
-  for ( size_t itype=0; itype<3; ++itype ) {
-    counters[EV].fill("... "+types[itype]+" pairs",0.); 
-    counters[EV].fill("... "+types[itype]+" + 2 jets",0.);
-    counters[EV].fill("... "+types[itype]+" + 2 jets + require Z",0.);
-    counters[EV].fill("... "+types[itype]+" + 2 jets + require Z + JZB>50",0.);
+  for ( size_t itype=0; itype<3; ++itype ) { // "unknown" only when it happens
+    for ( size_t i=0; i<4; ++i ) counters[EV].fill(pairCounters[itype][i],0.);
   }
 
 
@@ -2151,49 +1699,49 @@ float JZBAnalysis::GetSFLight(const float jpt, const float jeta, string WP, floa
     if(jpt>800) pt=800;
     
     if(0.0<=eta && eta<=0.5) {
-      mean = CSVL__SFlight_0p0_to_0p5->Eval(pt);
-      low  = lowCSVL__SFlight_0p0_to_0p5->Eval(pt);
-      high = highCSVL__SFlight_0p0_to_0p5->Eval(pt);
+      mean = CSVL__SFlight_0p0_to_0p5->Eval(pt, BTagSF::kMean);
+      low  = CSVL__SFlight_0p0_to_0p5->Eval(pt, BTagSF::kMin);
+      high = CSVL__SFlight_0p0_to_0p5->Eval(pt, BTagSF::kMax);
     }
     if(0.5<=eta && eta<=1.0) {
-      mean = CSVL__SFlight_0p5_to_1p0->Eval(pt);
-      low  = lowCSVL__SFlight_0p5_to_1p0->Eval(pt);
-      high = highCSVL__SFlight_0p5_to_1p0->Eval(pt);
+      mean = CSVL__SFlight_0p5_to_1p0->Eval(pt, BTagSF::kMean);
+      low  = CSVL__SFlight_0p5_to_1p0->Eval(pt, BTagSF::kMin);
+      high = CSVL__SFlight_0p5_to_1p0->Eval(pt, BTagSF::kMax);
     }
     if(1.0<=eta && eta<=1.5) {
-      mean = CSVL__SFlight_1p0_to_1p5->Eval(pt);
-      low  = lowCSVL__SFlight_1p0_to_1p5->Eval(pt);
-      high = highCSVL__SFlight_1p0_to_1p5->Eval(pt);
+      mean = CSVL__SFlight_1p0_to_1p5->Eval(pt, BTagSF::kMean);
+      low  = CSVL__SFlight_1p0_to_1p5->Eval(pt, BTagSF::kMin);
+      high = CSVL__SFlight_1p0_to_1p5->Eval(pt, BTagSF::kMax);
     }
     if(1.5<=eta && eta<=2.4) {
-      mean = CSVL__SFlight_1p5_to_2p4->Eval(pt);
-      low  = lowCSVL__SFlight_1p5_to_2p4->Eval(pt);
-      high = highCSVL__SFlight_1p5_to_2p4->Eval(pt);
+      mean = CSVL__SFlight_1p5_to_2p4->Eval(pt, BTagSF::kMean);
+      low  = CSVL__SFlight_1p5_to_2p4->Eval(pt, BTagSF::kMin);
+      high = CSVL__SFlight_1p5_to_2p4->Eval(pt, BTagSF::kMax);
     }
   }
   
   if(WP=="CSVM") {
     if(0.0<=eta && eta<=0.8) {
-      mean = CSVM__SFlight_0p0_to_0p8->Eval(pt);
-      low  = lowCSVM__SFlight_0p0_to_0p8->Eval(pt);
-      high = highCSVM__SFlight_0p0_to_0p8->Eval(pt);
+      mean = CSVM__SFlight_0p0_to_0p8->Eval(pt, BTagSF::kMean);
+      low  = CSVM__SFlight_0p0_to_0p8->Eval(pt, BTagSF::kMin);
+      high = CSVM__SFlight_0p0_to_0p8->Eval(pt, BTagSF::kMax);
     }
     if(0.0<=eta && eta<=0.8) {
-      mean = CSVM__SFlight_0p8_to_1p6->Eval(pt);
-      low  = lowCSVM__SFlight_0p8_to_1p6->Eval(pt);
-      high = highCSVM__SFlight_0p8_to_1p6->Eval(pt);
+      mean = CSVM__SFlight_0p8_to_1p6->Eval(pt, BTagSF::kMean);
+      low  = CSVM__SFlight_0p8_to_1p6->Eval(pt, BTagSF::kMin);
+      high = CSVM__SFlight_0p8_to_1p6->Eval(pt, BTagSF::kMax);
     }
     if(0.0<=eta && eta<=0.8) {
-      mean = CSVM__SFlight_1p6_to_2p4->Eval(pt);
-      low  = lowCSVM__SFlight_1p6_to_2p4->Eval(pt);
-      high = highCSVM__SFlight_1p6_to_2p4->Eval(pt);
+      mean = CSVM__SFlight_1p6_to_2p4->Eval(pt, BTagSF::kMean);
+      low  = CSVM__SFlight_1p6_to_2p4->Eval(pt, BTagSF::kMin);
+      high = CSVM__SFlight_1p6_to_2p4->Eval(pt, BTagSF::kMax);
     }
   }
   
   if(WP=="CSVT") {
-    mean = CSVT__SFlight->Eval(pt);
-    low  = lowCSVT__SFlight->Eval(pt);
-    high = highCSVT__SFlight->Eval(pt);
+    mean = CSVT__SFlight->Eval(pt, BTagSF::kMean);
+    low  = CSVT__SFlight->Eval(pt, BTagSF::kMin);
+    high = CSVT__SFlight->Eval(pt, BTagSF::kMax);
   }
   
   PosUncert=high-mean;
@@ -2230,13 +1778,14 @@ vector<lepton> JZBAnalysis::sortLeptonsByPt(vector<lepton>& leptons) {
 //------------------------------------------------------------------------------
 //for triggers, check out
 // http://fwyzard.web.cern.ch/fwyzard/hlt/summary
-const bool JZBAnalysis::passTriggers( std::vector<std::string>& triggerPaths ) {
+const bool JZBAnalysis::passTriggers( const int triggerMenu ) {
 
   bool foundUnprescaled(false);
   bool passed(false);
-  for ( size_t i=0; i<triggerPaths.size(); ++i ) {
-    if ( GetHLTResult(triggerPaths[i]) ) passed = true;
-    if ( GetHLTPrescale(triggerPaths[i]) == 1 ) foundUnprescaled = true;
+  const std::vector<int>& bits = GetTriggerMenuBits(triggerMenu);
+  for ( size_t i=0; i<bits.size(); ++i ) {
+    if ( fTR->HLTResults[bits[i]] ) passed = true;
+    if ( fTR->HLTPrescale[bits[i]] == 1 ) foundUnprescaled = true;
   }
 
   // Check if found unprescaled trigger...
@@ -2332,7 +1881,7 @@ float topRW_f(float pt,int sample) {
   return exp(a + b*pt);
 }
 
-void GetTopWeights(int sample) {
+void JZBAnalysis::GetTopWeights(int sample) {
   nEvent.benWeight=BenWeight(nEvent.genTopPt);
   nEvent.topWeight=sqrt(topRW_f(nEvent.genTopPt,sample) * topRW_f(nEvent.genAntiTopPt,sample));
 }
@@ -2342,7 +1891,7 @@ void JZBAnalysis::Analyze() {
   minuit->SetPrintLevel(-1);
   // #--- analysis global parameters
   double DRmax=0.4; // veto jets in a cone of DRmax close to the lepton
-  counters[EV].fill("All events");
+  counters[EV].fill(evCuts[evAll]);
   nEvent.reset();
   // Fill generic information
   nEvent.eventNum  = fTR->Event;
@@ -2576,39 +2125,39 @@ void JZBAnalysis::Analyze() {
   // Trigger information
   nEvent.passed_triggers=0;
   if ( fDataType_ != "mc" ) nEvent.is_data=true;
-  if ( passTriggers(elTriggerPaths) ) 
+  if ( passTriggers(elTriggers) ) 
     {
-      counters[EV].fill("... pass electron triggers");
+      counters[EV].fill(evCuts[evElTrig]);
       nEvent.passed_triggers=1;
       nEvent.trigger_bit |= 1;
     } 
-  if ( passTriggers(muTriggerPaths) )
+  if ( passTriggers(muTriggers) )
     {
-      counters[EV].fill("... pass muon triggers");
+      counters[EV].fill(evCuts[evMuTrig]);
       nEvent.passed_triggers=1;
       nEvent.trigger_bit |= (1<<1);
     } 
-  if ( passTriggers(emTriggerPaths) )
+  if ( passTriggers(emTriggers) )
     {
-      counters[EV].fill("... pass EM triggers");
+      counters[EV].fill(evCuts[evEMTrig]);
       nEvent.passed_triggers=1;
       nEvent.trigger_bit |= (1<<2);
     }
-  if ( passTriggers(meTriggerPaths) )
+  if ( passTriggers(meTriggers) )
     {
-      counters[EV].fill("... pass ME triggers");
+      counters[EV].fill(evCuts[evMETrig]);
       nEvent.passed_triggers=1;
       nEvent.trigger_bit |= (1<<3);
     }
-  if ( passTriggers(metTriggerPaths) )
+  if ( passTriggers(metTriggers) )
     {
-      counters[EV].fill("... pass MET triggers");
+      counters[EV].fill(evCuts[evMETTrig]);
       nEvent.passed_triggers=1;
       nEvent.trigger_bit |= (1<<4);
     }
-  if ( passTriggers(htTriggerPaths) )
+  if ( passTriggers(htTriggers) )
     {
-      counters[EV].fill("... pass HT triggers");
+      counters[EV].fill(evCuts[evHTTrig]);
       nEvent.passed_triggers=1;
       nEvent.trigger_bit |= (1<<5);
     }
@@ -2633,7 +2182,7 @@ void JZBAnalysis::Analyze() {
     if (isMC&&!fmakeSmall) myTree->Fill();
     return;
   }
-  counters[EV].fill("... pass good event requirements");
+  counters[EV].fill(evCuts[evGood]);
 
   vector<lepton> leptons;
 
@@ -2643,10 +2192,10 @@ void JZBAnalysis::Analyze() {
   // #--- muon loop
   for(int muIndex=0;muIndex<fTR->NMus;muIndex++)
     {
-      counters[MU].fill("All mus");
+      counters[MU].fill(muCuts[muAll]);
       if(IsCustomMu2012(muIndex))
         {
-          counters[MU].fill("... pass mu selection");
+          counters[MU].fill(muCuts[muPass]);
           float px= fTR->MuPx[muIndex];
           float py= fTR->MuPy[muIndex];
           float pz= fTR->MuPz[muIndex];
@@ -2673,10 +2222,10 @@ void JZBAnalysis::Analyze() {
   // #--- electron loop
   for(int elIndex=0;elIndex<fTR->NEles;elIndex++)
     {
-      counters[EL].fill("All eles");
+      counters[EL].fill(elCuts[elAll]);
       if(IsCustomEl2012(elIndex))	
         {
-          counters[EL].fill("... pass e selection");
+          counters[EL].fill(elCuts[elPass]);
           float px= fTR->ElPx[elIndex];
           float py= fTR->ElPy[elIndex];
           float pz= fTR->ElPz[elIndex];
@@ -2721,7 +2270,7 @@ void JZBAnalysis::Analyze() {
   }
 
     
-  counters[EV].fill("... has at least 2 leptons");
+  counters[EV].fill(evCuts[ev2Lep]);
   int PosLepton1 = 0;
   int PosLepton2 = 1;
     
@@ -2749,7 +2298,7 @@ void JZBAnalysis::Analyze() {
     return;
   }
   
-  counters[EV].fill("... has at least 2 OS leptons");
+  counters[EV].fill(evCuts[ev2OSLep]);
   
   float mindiff=-1;
   int BestCandidate=sortedGoodLeptons.size();
@@ -2894,7 +2443,7 @@ void JZBAnalysis::Analyze() {
     if (isMC&&!fmakeSmall) myTree->Fill();
     return;
   }
-  counters[EV].fill("... pass dilepton pt selection");
+  counters[EV].fill(evCuts[evDilepPt]);
         
   // #--- construct different recoil models, initial the recoil vector will hold only the sum over the hard jets, only in the end we will add-up the lepton system
 
@@ -3066,9 +2615,11 @@ void JZBAnalysis::Analyze() {
   unsigned int mjlcounter=0;
   
   bool isSetGT = (fGlobalTag_ != "");
+  ObjectMask jetIDMask; // loose PF jet ID for all jets (IsGoodBasicPFJet)
+  PFJetMask(jetIDMask, kPFJetLoose, 0.0, 5.0);
   for(int i =0 ; i<fTR->NJets;i++) // PF jet loop
     {
-      counters[PJ].fill("All PF jets");
+      counters[PJ].fill(pjCuts[pjAll]);
       if(i==jMax){cout<<"max Num was reached"<<endl; break;}
 	
       float jpt = fTR->JPt[i];
@@ -3081,7 +2632,7 @@ void JZBAnalysis::Analyze() {
       }
       float jeta = fTR->JEta[i];
       float jphi = fTR->JPhi[i];
-      bool  isJetID = IsGoodBasicPFJet(i,0.0,5.0);
+      bool  isJetID = jetIDMask[i];
       int   ntracksch = fTR->JNAssoTracks[i];  
       int   ntracksne = fTR->JNConstituents[i];
 
@@ -3095,13 +2646,13 @@ void JZBAnalysis::Analyze() {
         for ( size_t ilep = 0; ilep<sortedGoodLeptons.size(); ++ilep )
           if ( aJet.DeltaR(sortedGoodLeptons[ilep].p)<DRmax) isClean=false;
         if ( !isClean ) continue;
-        counters[PJ].fill("... pass full lepton cleaning");
+        counters[PJ].fill(pjCuts[pjCleaning]);
       } else {
         // Remove jet close to leptons from Z candidate
         if(aJet.DeltaR(sortedGoodLeptons[PosLepton1].p)<DRmax) continue;
-        counters[PJ].fill("... pass lepton 1 veto");
+        counters[PJ].fill(pjCuts[pjVeto1]);
         if(aJet.DeltaR(sortedGoodLeptons[PosLepton2].p)<DRmax) continue;
-        counters[PJ].fill("... pass lepton 2 veto");
+        counters[PJ].fill(pjCuts[pjVeto2]);
       }
       
       //Get Uncertainty
@@ -3116,7 +2667,7 @@ void JZBAnalysis::Analyze() {
 
       // Keep jets over min. pt threshold
       if ( !(jpt>20) ) continue;
-      counters[PJ].fill("... pt>20.");
+      counters[PJ].fill(pjCuts[pjPt]);
 
 	
       if(fabs(jeta)>3.0 && fabs(jeta)<5.0) {
@@ -3128,7 +2679,7 @@ void JZBAnalysis::Analyze() {
       
       // Keep central jets
       if ( !(fabs(jeta)<3.0 ) ) continue;
-      counters[PJ].fill("... |eta|<3.0");
+      counters[PJ].fill(pjCuts[pjEta]);
       
       
       Mpx.push_back(aJet.Px());
@@ -3144,7 +2695,7 @@ void JZBAnalysis::Analyze() {
       if (!isJetID) { 
         nEvent.badJet = 1;
       } else {
-        counters[PJ].fill("... pass Jet ID");
+        counters[PJ].fill(pjCuts[pjJetID]);
       }
       
       lepton tmpLepton;
@@ -3153,7 +2704,7 @@ void JZBAnalysis::Analyze() {
       tmpLepton.index = i;
       tmpLepton.type = -1;
         
-      if(!nEvent.badJet) counters[PJ].fill("... pass Jet ID");
+      if(!nEvent.badJet) counters[PJ].fill(pjCuts[pjJetID]);
 
       nEvent.pfJetPt[nEvent.pfJetNum]    = jpt;
       nEvent.pfJetEta[nEvent.pfJetNum]   = jeta;
@@ -3171,7 +2722,7 @@ void JZBAnalysis::Analyze() {
       pfGoodJets.push_back(tmpLepton);
 
       if ( jpt>40 ) {
-        counters[PJ].fill("... pass tight jet selection");
+        counters[PJ].fill(pjCuts[pjTight]);
         nEvent.pfTightHT += jpt;
         nEvent.pfJetGoodPt[nEvent.pfJetGoodNum40]  = jpt;
         nEvent.pfJetGoodEta[nEvent.pfJetGoodNum40] = jeta;
@@ -3238,11 +2789,11 @@ void JZBAnalysis::Analyze() {
           bool is_tagged_med = fTR->JnewPFCombinedSecondaryVertexBPFJetTags[i] > 0.679;
           float random(-1.);
           random = fRand3Normal->Uniform(0,1); // get random number from uniform distribution
-          nEvent.MC_pfJetGoodNumBTag40   +=fBTagSF->modifyBTagsWithSF(is_tagged_med, fTR->JPt[i], fTR->JEta[i], fTR->JPartonFlavour[i], "mean", random);
+          nEvent.MC_pfJetGoodNumBTag40   +=fBTagSF->modifyBTagsWithSF(is_tagged_med, fTR->JPt[i], fTR->JEta[i], fTR->JPartonFlavour[i], BTagSF::kMean, random);
           random = fRand3Normal->Uniform(0,1); // get random number from uniform distribution
-          nEvent.MC_pfJetGoodNumBTag40dn+=fBTagSFup->modifyBTagsWithSF(is_tagged_med, fTR->JPt[i], fTR->JEta[i], fTR->JPartonFlavour[i], "max", random);
+          nEvent.MC_pfJetGoodNumBTag40dn+=fBTagSFup->modifyBTagsWithSF(is_tagged_med, fTR->JPt[i], fTR->JEta[i], fTR->JPartonFlavour[i], BTagSF::kMax, random);
           random = fRand3Normal->Uniform(0,1); // get random number from uniform distribution
-          nEvent.MC_pfJetGoodNumBTag40up+=fBTagSFdn->modifyBTagsWithSF(is_tagged_med, fTR->JPt[i], fTR->JEta[i], fTR->JPartonFlavour[i], "min", random);
+          nEvent.MC_pfJetGoodNumBTag40up+=fBTagSFdn->modifyBTagsWithSF(is_tagged_med, fTR->JPt[i], fTR->JEta[i], fTR->JPartonFlavour[i], BTagSF::kMin, random);
 	}
       }
       
@@ -3330,13 +2881,14 @@ void JZBAnalysis::Analyze() {
   
   int hemi_association=3; // association method: default 3 = minimal lund distance
   int hemi_seed=2; // seed 2: max inv mass
-  Hemisphere* hemisp = new Hemisphere(Mpx, Mpy, Mpz, ME, hemi_seed, hemi_association);
+  fHemisphere.SetObjects(Mpx.size(), &Mpx[0], &Mpy[0], &Mpz[0], &ME[0]);
+  fHemisphere.SetMethod(hemi_seed, hemi_association);
   for(unsigned int i=0;i<hemiobjs.type.size();i++) {
-    if(hemiobjs.type[i]=="jet") hemisp->SetNoSeed(i);
+    if(hemiobjs.type[i]=="jet") fHemisphere.SetNoSeed(i);
   }
       
-  vector<int> grouping = hemisp->getGrouping();
-  int NHemiIterations  = hemisp->GetNumLoop();
+  const int* grouping = fHemisphere.Grouping();
+  int NHemiIterations  = fHemisphere.GetNumLoop();
 
   TLorentzVector pseudojet1(0.,0.,0.,0.);
   TLorentzVector pseudojet2(0.,0.,0.,0.);
@@ -3344,7 +2896,7 @@ void JZBAnalysis::Analyze() {
   
   
   float dHT=0;
-  for(int i=0; i<Mpx.size(); ++i){
+  for(int i=0; i<fHemisphere.GetNObjects(); ++i){
     if(grouping[i]==1){
       pseudojet1.SetPx(pseudojet1.Px() + Mpx[i]);
       pseudojet1.SetPy(pseudojet1.Py() + Mpy[i]);
@@ -3361,7 +2913,6 @@ void JZBAnalysis::Analyze() {
       hemiobjs.hemisphere[i]=2;
     }
   }
-  delete hemisp;
     
   float testmass=0;
   float massive=0;
@@ -3466,27 +3017,26 @@ void JZBAnalysis::Analyze() {
   nEvent.st=nEvent.pt1+nEvent.pt2+nEvent.met[4]+ScalarSumOfJets; // lepton 1   + lepton2   + MET  + scalar sum of jets
     
   // Statistics ///////////////////////////////////////
-  string type("");
+  int itype = 3; // as booked in Begin
   switch ( (nEvent.id1+1)*(nEvent.id2+1) ) {
-  case 1: type = "ee"; break;
-  case 2: type = "em"; break;
-  case 4: type = "mm"; break;
-  default: type = "unknown";
+  case 1: itype = 0; break;
+  case 2: itype = 2; break;
+  case 4: itype = 1; break;
   }
-  counters[EV].fill("... "+type+" pairs");     
+  counters[EV].fill(pairCounters[itype][0]);
   if ( nEvent.pfJetGoodNum40>= 2 ) {
-    counters[EV].fill("... "+type+" + 2 jets");
+    counters[EV].fill(pairCounters[itype][1]);
     if ( fabs(nEvent.mll-91)<20 ) {
-      counters[EV].fill("... "+type+" + 2 jets + require Z");
+      counters[EV].fill(pairCounters[itype][2]);
       if ( nEvent.jzb[1]>50 ) {
-        counters[EV].fill("... "+type+" + 2 jets + require Z + JZB>50");
+        counters[EV].fill(pairCounters[itype][3]);
       }
     }
   }
   // Trigger information
   map<string,int>::iterator itend = fHLTLabelMap.end();
   char buf[256];
-  counters[TR].fill("All selected events");
+  counters[TR].fill(trAll);
   for ( map<string,int>::iterator it = fHLTLabelMap.begin(); it != itend; ++it ) {
     int bit = it->second;
     bool passed = fTR->HLTResults[bit];
@@ -3676,39 +3226,6 @@ void JZBAnalysis::Analyze() {
 }
 
 void JZBAnalysis::DeleteScalingFactors() {
-  delete CSVL__SFlight_0p0_to_0p5;
-  delete CSVL__SFlight_0p5_to_1p0;
-  delete CSVL__SFlight_1p0_to_1p5;
-  delete CSVL__SFlight_1p5_to_2p4;
-
-  delete CSVM__SFlight_0p0_to_0p8;
-  delete CSVM__SFlight_0p8_to_1p6;
-  delete CSVM__SFlight_1p6_to_2p4;
-
-  delete CSVT__SFlight;
-
-  delete lowCSVL__SFlight_0p0_to_0p5;
-  delete lowCSVL__SFlight_0p5_to_1p0;
-  delete lowCSVL__SFlight_1p0_to_1p5;
-  delete lowCSVL__SFlight_1p5_to_2p4;
-
-  delete lowCSVM__SFlight_0p0_to_0p8;
-  delete lowCSVM__SFlight_0p8_to_1p6;
-  delete lowCSVM__SFlight_1p6_to_2p4;
-
-  delete lowCSVT__SFlight;
-
-  delete highCSVL__SFlight_0p0_to_0p5;
-  delete highCSVL__SFlight_0p5_to_1p0;
-  delete highCSVL__SFlight_1p0_to_1p5;
-  delete highCSVL__SFlight_1p5_to_2p4;
-
-  delete highCSVM__SFlight_0p0_to_0p8;
-  delete highCSVM__SFlight_0p8_to_1p6;
-  delete highCSVM__SFlight_1p6_to_2p4;
-
-  delete highCSVT__SFlight;
-
   delete CSVL_SFb;
   delete CSVM_SFb;
   delete CSVT_SFb;
@@ -3718,6 +3235,7 @@ void JZBAnalysis::End(TFile *f){
   f->cd();	
   
   if(UseForZPlusB) DeleteScalingFactors();
+  if(!UseForZPlusB) solver->PrintStatistics();
   delete solver;
 
   myTree->Write();
@@ -3733,9 +3251,34 @@ void JZBAnalysis::End(TFile *f){
       counters[iCount].print();
     }
   }
+
+  // Same numbers as histograms in the output file and as csv next to it
+  std::string csvname(f->GetName());
+  if ( csvname.rfind(".root")!=std::string::npos ) csvname.erase(csvname.rfind(".root"));
+  csvname += "_counters.csv";
+  std::ofstream csv(csvname.c_str());
+  bool header = true;
+  for ( counters_t iCount=count_begin; iCount<count_end; 
+        iCount = counters_t(iCount+1) ) {
+    if ( !counters[iCount].size() ) continue;
+    TH1D *h = counters[iCount].makeHisto("Counters_"+any2string(int(iCount)));
+    h->Write();
+    delete h;
+    counters[iCount].writeCSV(csv,header);
+    header = false;
+  }
+  if ( !csv.good() ) std::cout << "JZBAnalysis::End ==> Error: could not write " << csvname << std::endl;
   
 }
 
+//________________________________________________________________________________________
+void JZBAnalysis::AddCounters(const JZBAnalysis& other) {
+  for ( counters_t iCount=count_begin; iCount<count_end; 
+        iCount = counters_t(iCount+1) ) {
+    counters[iCount].add(other.counters[iCount]);
+  }
+}
+
 template<class T>
 std::string JZBAnalysis::any2string(T i)
 {
@@ -3766,39 +3309,39 @@ const bool JZBAnalysis::IsCustomMu2012(const int index){
 
   // Acceptance cuts
   if (!(fTR->MuPt[index] > 10.0) )       return false;
-  counters[MU].fill(" ... pt > 10");
+  counters[MU].fill(muCuts[muPt]);
   if (!(fabs(fTR->MuEta[index])<2.4) ) return false;
-  counters[MU].fill(" ... |eta| < 2.4");
+  counters[MU].fill(muCuts[muEta]);
 
 
   // Quality cuts
   if ( !fTR->MuIsGlobalMuon[index] )  return false;
-  counters[MU].fill(" ... is global muon");
+  counters[MU].fill(muCuts[muGlobal]);
   if ( !fTR->MuIsTrackerMuon[index] ) return false;
-  counters[MU].fill(" ... is tracker muon");
+  counters[MU].fill(muCuts[muTracker]);
   if ( !fTR->MuIsPFMuon[index] )        return false;
-  counters[MU].fill(" ... is pf muon");
+  counters[MU].fill(muCuts[muPF]);
 
   // Hits
   if ( !(fTR->MuNChi2[index] < 10) )     return false;
-  counters[MU].fill(" ... nChi2 < 10");
+  counters[MU].fill(muCuts[muChi2]);
   if ( !(fTR->MuNMuHits[index] > 0) )     return false;
-  counters[MU].fill(" ... nValidHits > 0");
+  counters[MU].fill(muCuts[muValidHits]);
   if ( !(fTR->MuNPxHits[index] > 0) )       return false;
-  counters[MU].fill(" ... nPxHits > 0");
+  counters[MU].fill(muCuts[muPxHits]);
   if ( !(fTR->MuNMatchedStations[index] > 1) )      return false;
   //if ( !(fTR->MuNMatches[index] > 1) )      return false;
-  counters[MU].fill(" ... nMatchedStations > 1");
+  counters[MU].fill(muCuts[muStations]);
   if ( !(fTR->MuNSiLayers[index] > 5) )      return false;
-  counters[MU].fill(" ... nLayers > 5");
+  counters[MU].fill(muCuts[muLayers]);
 
 
   // Vertex compatibility
   if ( !(fabs(fTR->MuD0PV[index]) < 0.02) ) return false; //still open
-  counters[MU].fill(" ... D0(pv) < 0.02");
+  counters[MU].fill(muCuts[muD0]);
   //HPA recommendation not POG
   if ( !(fabs(fTR->MuDzPV[index]) < 0.1 ) ) return false; //still open
-  counters[MU].fill(" ... DZ(pv) < 0.1");
+  counters[MU].fill(muCuts[muDZ]);
   //if ( !(fabs(fTR->MuDzPV[index]) < 0.2 ) ) return false; //still open
   //counters[MU].fill(" ... DZ(pv) < 0.2");
 
@@ -3806,7 +3349,7 @@ const bool JZBAnalysis::IsCustomMu2012(const int index){
   // Flat isolation below 20 GeV (only for synch.: we cut at 20...)
   double Iso = MuPFIso(index);
   if ( !(Iso < 0.15) ) return false;
-  counters[MU].fill(" ... Iso < 0.15");
+  counters[MU].fill(muCuts[muIso]);
 
 
   return true;
@@ -4121,10 +3664,10 @@ float JZBAnalysis::ElPFIso(int index){
 const bool JZBAnalysis::IsCustomEl2012(const int index) {
   
   if(!(fabs(fTR->ElEta[index]) < 2.5) ) return false;
-  counters[EL].fill(" ... |eta| < 2.5");
+  counters[EL].fill(elCuts[elEta]);
 
   if(!(fTR->ElPt[index]) > 10.0 ) return false;
-  counters[EL].fill(" ... pT > 10");
+  counters[EL].fill(elCuts[elPt]);
 
   // Medium Working Point
   if ( fabs(fTR->ElEta[index]) < 1.479 ) { // Barrel
@@ -4139,15 +3682,15 @@ const bool JZBAnalysis::IsCustomEl2012(const int index) {
     if(!(fTR->ElHcalOverEcal[index]<0.10)) return false;
   }
   
-  counters[EL].fill(" ... pass additional electron ID cuts");
+  counters[EL].fill(elCuts[elID]);
 
   if(!(fTR->ElNumberOfMissingInnerHits[index]<=1)) return false;
-  counters[EL].fill(" ... N(missing inner hits) <= 1");
+  counters[EL].fill(elCuts[elMissHits]);
 
   float e=fTR->ElCaloEnergy[index];
   float p=fTR->ElCaloEnergy[index]/fTR->ElESuperClusterOverP[index];
   if(!(fabs(1/e-1/p)<0.05)) return false;
-  counters[EL].fill(" ... |1/e-1/p|<0.05");
+  counters[EL].fill(elCuts[elEoverP]);
 
   // Remove if close to muon
   for(int i=0;i<fTR->NMus;++i)
@@ -4159,18 +3702,18 @@ const bool JZBAnalysis::IsCustomEl2012(const int index) {
         if ( elP.DeltaR(muP) < 0.1 ) return false;
       }
     }
-  counters[EL].fill(" ... DR(e,mu)>0.1");
+  counters[EL].fill(elCuts[elDRmu]);
 
   if(!(abs(fTR->ElD0PV[index])<0.02)) return false;
-  counters[EL].fill(" ... D0(PV)<0.02");
+  counters[EL].fill(elCuts[elD0]);
   if(!(abs(fTR->ElDzPV[index])<0.1)) return false;
-  counters[EL].fill(" ... DZ(PV)<0.1");
+  counters[EL].fill(elCuts[elDZ]);
   if(!fTR->ElPassConversionVeto[index]) return false;
-  counters[EL].fill(" ... passed conversion rejection");
+  counters[EL].fill(elCuts[elConvVeto]);
   
   // ECAL gap veto
   if ( fabs(fTR->ElSCEta[index]) > 1.4442 && fabs(fTR->ElSCEta[index]) < 1.566 )  return false;  
-  counters[EL].fill(" ... not in ECAL gap");
+  counters[EL].fill(elCuts[elGap]);
 
   //fbrem : fTElNBrems (reco::GsfElectron::fbrem())  --> no cut?
   
@@ -4181,7 +3724,7 @@ const bool JZBAnalysis::IsCustomEl2012(const int index) {
     //Endcap with pt<20
     if ( !((pfIso  < 0.10) ) ) return false;
   }
-  counters[EL].fill(" ... pfIso  < 0.15 (or 0.1 for endcaps with pt<20)");
+  counters[EL].fill(elCuts[elIso]);
 
   return true;
 }
@@ -4201,9 +3744,9 @@ const bool JZBAnalysis::IsCustomJet(const int index){
   // See https://twiki.cern.ch/twiki/bin/view/CMS/JetID
 
   //  if ( !(fTR->CAJID_n90Hits[index] > 1) ) return false;
-  counters[JE].fill(" ... n90Hits > 1");
+  counters[JE].fill(jeCuts[jeN90Hits]);
   //  if ( !(fTR->CAJID_HPD[index] < 0.98)  ) return false;
-  counters[JE].fill(" ... HPD < 0.98");
+  counters[JE].fill(jeCuts[jeHPD]);
 
   if ( fabs(fTR->CAJEta[index])<3.0 ) {
     if ( !(fTR->CAJEMfrac[index] > 0.01)  ) return false;
@@ -4211,7 +3754,7 @@ const bool JZBAnalysis::IsCustomJet(const int index){
     if ( !(fTR->CAJEMfrac[index] > -0.9)  ) return false;
     if ( fTR->CAJPt[index] > 80 && !(fTR->CAJEMfrac[index]<1) ) return false;
   }
-  counters[JE].fill(" ... pass EMfrac cut");
+  counters[JE].fill(jeCuts[jeEMfrac]);
 
   return true;
 }
@@ -4535,7 +4078,7 @@ bool JZBAnalysis::MatchTrigger(lepton *a) {
 
   //cout << "We are testing lepton: " << a->p << " which is of type: " << a->type << endl;
   if(a->type == 0) {
-    if(! passTriggers(singleElTriggerPaths)) return false; 
+    if(! passTriggers(singleElTriggers)) return false; 
     for(int k = 0; k < fTR->NHLTObjs[1]; k++) {
       if(abs(fTR->HLTObjectID1[k]) == 11) {
         TLorentzVector tmpVector(0, 0, 0, 0);
@@ -4547,7 +4090,7 @@ bool JZBAnalysis::MatchTrigger(lepton *a) {
       }
     }
   } else {
-    if(! passTriggers(singleMuTriggerPaths)) return false; 
+    if(! passTriggers(singleMuTriggers)) return false; 
     for(int k = 0; k < fTR->NHLTObjs[0]; k++) {
       if(abs(fTR->HLTObjectID0[k]) == 13) {
         TLorentzVector tmpVector(0, 0, 0, 0);
@@ -4,22 +4,48 @@
 #include "base/TreeAnalyzerBase.hh"
 #include "base/TreeReader.hh"
 
+#include <TSystem.h>
+
 using namespace std;
 
 JZBAnalyzer::JZBAnalyzer(std::vector<std::string>& fileList, std::string dataType, std::string globalTag,
                          bool fullCleaning, bool isModelScan, bool makeSmall, bool doGenInfo)  
    : TreeAnalyzerBase(fileList) {
+  fDataType=dataType;
+  fGlobalTag=globalTag;
+  fFullCleaning=fullCleaning;
   f_isModelScan=isModelScan;
+  f_makeSmall=makeSmall;
   f_doGenInfo=doGenInfo;
+  fHistFile=NULL;
+  fNWorkers=0;
   fJZBAnalysis = new JZBAnalysis(fTR,dataType,globalTag,fullCleaning,isModelScan,makeSmall,doGenInfo,fileList);
 }
 
+JZBAnalyzer::JZBAnalyzer(std::vector<std::string>& fileList, const JZBAnalyzer *master)
+   : TreeAnalyzerBase(fileList, master) {
+  fDataType=master->fDataType;
+  fGlobalTag=master->fGlobalTag;
+  fFullCleaning=master->fFullCleaning;
+  f_isModelScan=master->f_isModelScan;
+  f_makeSmall=master->f_makeSmall;
+  f_doGenInfo=master->f_doGenInfo;
+  fHistFile=NULL;
+  fNWorkers=0;
+  // The sample (DY, ttbar, file number) is found from all the files of the job
+  fJZBAnalysis = new JZBAnalysis(fTR,fDataType,fGlobalTag,fFullCleaning,f_isModelScan,f_makeSmall,f_doGenInfo,master->fFileList);
+}
+
 JZBAnalyzer::~JZBAnalyzer() {
   delete fJZBAnalysis;
 }
 
 // Method for looping over the tree
 void JZBAnalyzer::Loop(){
+  if ( IsParallel() ) {
+    LoopParallel();
+    return;
+  }
   Long64_t nentries = fTR->GetEntries();
   cout << " total events in ntuples = " << fTR->GetEntries() << endl;
   if ( fTR->GetEntries() < 1 ) {
@@ -53,10 +79,10 @@ void JZBAnalyzer::Loop(){
   }
 }
 
-TFile *fHistFile;
-
 // Method called before starting the event loop
 void JZBAnalyzer::BeginJob(string fdata_PileUp, string fmc_PileUp){
+  fDataPUFile = fdata_PileUp;
+  fMCPUFile = fmc_PileUp;
   fHistFile = new TFile(outputFileName_.c_str(), "RECREATE");
   //	Note: the next line is commented out because we are now not saving in the analysis routine anymore but at the "analyzer level"
   //	fJZBAnalysis->outputFileName_ = outputFileName_;
@@ -69,4 +95,27 @@ void JZBAnalyzer::BeginJob(string fdata_PileUp, string fmc_PileUp){
 void JZBAnalyzer::EndJob(){
   fJZBAnalysis->End(fHistFile);
   fHistFile->Close();
+  delete fHistFile;
+  // Parallel running: the worker parts replace the (empty) output,
+  // their counters are in its csv file
+  for ( size_t i=0; i<fWorkerOutputs.size(); ++i ) {
+    TString csv = fWorkerOutputs[i];
+    csv.ReplaceAll(".root","_counters.csv");
+    gSystem->Unlink(csv);
+  }
+  MergeOutputs(outputFileName_);
+}
+
+// Parallel running: the worker writes its part of the output to outputFile
+TreeAnalyzerBase* JZBAnalyzer::MakeWorker(std::vector<std::string>& fileList, const TString& outputFile){
+  JZBAnalyzer *W = new JZBAnalyzer(fileList, this);
+  W->SetOutputFileName(outputFile.Data());
+  W->fJZBAnalysis->SetSmearingSeed(++fNWorkers);
+  W->BeginJob(fDataPUFile, fMCPUFile);
+  return W;
+}
+
+void JZBAnalyzer::MergeWorker(TreeAnalyzerBase *worker){
+  TreeAnalyzerBase::MergeWorker(worker);
+  fJZBAnalysis->AddCounters(*((JZBAnalyzer*)worker)->fJZBAnalysis);
 }
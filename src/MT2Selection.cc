@@ -0,0 +1,397 @@
+/*****************************************************************************
+*   Compiled selections and variables on MT2tree, see MT2Selection.hh        *
+*****************************************************************************/
+
+#include "MT2Selection.hh"
+#include "MT2tree.hh"
+
+#include "TTree.h"
+#include "TBranch.h"
+#include "TBranchElement.h"
+#include "TLeaf.h"
+#include "TTreeFormula.h"
+#include "TH1.h"
+#include "TSystem.h"
+#include "TMD5.h"
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <cctype>
+#include <cstdlib>
+#include <set>
+#include <algorithm>
+
+using namespace std;
+
+//____________________________________________________________________________
+MT2Selection::MT2Selection() : fWeightExpr("1"), fCompiled(false), fWeight(1.) {
+	fFunc.cuts = 0; fFunc.vars = 0; fFunc.weight = 0;
+	ResetCounters();
+}
+
+//____________________________________________________________________________
+int MT2Selection::AddCut(TString label, TString expr){
+	fCutLabel.push_back(label);
+	fCutExpr .push_back(expr);
+	fCompiled = false;
+	ResetCounters();
+	return fCutExpr.size()-1;
+}
+
+int MT2Selection::AddCuts(TString cuts){
+// Split a selection string at the top level "&&", the terms become
+// separate cuts labelled by their expression. A selection with a top
+// level "||" is added as a single cut.
+	string in = cuts.Data();
+	vector<string> terms;
+	int depth = 0;
+	size_t start = 0;
+	for(size_t i = 0; i < in.size(); ++i){
+		if     (in[i] == '(') depth++;
+		else if(in[i] == ')') depth--;
+		else if(depth == 0 && i+1 < in.size() && in[i] == '|' && in[i+1] == '|') return AddCut(cuts, cuts);
+		else if(depth == 0 && i+1 < in.size() && in[i] == '&' && in[i+1] == '&'){
+			terms.push_back(in.substr(start, i-start));
+			start = i+2;
+			i++;
+		}
+	}
+	terms.push_back(in.substr(start));
+
+	int last = -1;
+	for(size_t i = 0; i < terms.size(); ++i){
+		TString term = terms[i].c_str();
+		term = term.Strip(TString::kBoth);
+		if(term == "") continue;
+		last = AddCut(term, term);
+	}
+	return last;
+}
+
+int MT2Selection::AddVariable(TString expr){
+	fVarExpr.push_back(expr);
+	fCompiled = false;
+	return fVarExpr.size()-1;
+}
+
+//____________________________________________________________________________
+TString MT2Selection::Translate(TString expr){
+// TTree::Draw expression on MT2tree -> C++ expression on "MT2tree &t":
+// identifiers which are not members ("a.b", "a->b"), not scoped ("TMath::")
+// and not common math functions get a "t." prefix
+	static const char* freefuncs[] = {"abs", "fabs", "sqrt", "pow", "exp", "log", "log10",
+	                                  "sin", "cos", "tan", "asin", "acos", "atan", "atan2",
+	                                  "min", "max", "floor", "ceil", "true", "false", 0};
+	string in = expr.Data();
+	string out;
+	const size_t n = in.size();
+	size_t i = 0;
+	while(i < n){
+		char c = in[i];
+		if(c == '"' || c == '\''){ // literals
+			size_t j = in.find(c, i+1);
+			j = (j == string::npos) ? n : j+1;
+			out += in.substr(i, j-i);
+			i = j;
+		}
+		else if(isdigit(c) || (c == '.' && i+1 < n && isdigit(in[i+1]))){ // numbers, e.g. 2.4, 1e-3
+			size_t j = i+1;
+			while(j < n && (isalnum(in[j]) || in[j] == '.' || ((in[j] == '+' || in[j] == '-') && (in[j-1] == 'e' || in[j-1] == 'E')))) j++;
+			out += in.substr(i, j-i);
+			i = j;
+		}
+		else if(isalpha(c) || c == '_'){
+			size_t j = i+1;
+			while(j < n && (isalnum(in[j]) || in[j] == '_')) j++;
+			string id = in.substr(i, j-i);
+
+			size_t k = out.size();
+			while(k > 0 && isspace(out[k-1])) k--;
+			bool member = k > 0 && (out[k-1] == '.' || (k > 1 && ((out[k-2] == '-' && out[k-1] == '>') || (out[k-2] == ':' && out[k-1] == ':'))));
+			size_t m = j;
+			while(m < n && isspace(in[m])) m++;
+			bool scope = m+1 < n && in[m] == ':' && in[m+1] == ':';
+			bool free = false;
+			for(int f = 0; freefuncs[f] != 0; ++f) if(id == freefuncs[f]) free = true;
+
+			if(!member && !scope && !free) out += "t.";
+			out += id;
+			i = j;
+		}
+		else{
+			out += c;
+			i++;
+		}
+	}
+	return TString(out.c_str());
+}
+
+//____________________________________________________________________________
+TString MT2Selection::GetBody(TString &key) const {
+	TString body;
+	body += "int MT2SelCuts(MT2tree &t){\n";
+	for(size_t i = 0; i < fCutExpr.size(); ++i)
+		body += TString::Format("\tif(!(%s)) return %d;\n", Translate(fCutExpr[i]).Data(), (int)i);
+	body += TString::Format("\treturn %d;\n}\n\n", (int)fCutExpr.size());
+	body += "void MT2SelVars(MT2tree &t, double *v){\n";
+	for(size_t i = 0; i < fVarExpr.size(); ++i)
+		body += TString::Format("\tv[%d] = (%s);\n", (int)i, Translate(fVarExpr[i]).Data());
+	body += "}\n\n";
+	body += TString::Format("double MT2SelWeight(MT2tree &t){\n\treturn (%s);\n}\n\n", Translate(fWeightExpr).Data());
+	TMD5 md5; // a 32 bit hash may collide and load the wrong selection
+	md5.Update((const UChar_t*)body.Data(), body.Length());
+	md5.Final();
+	key = md5.AsString();
+	return body;
+}
+
+TString MT2Selection::GetSource(const vector<TString> &bodies, const vector<TString> &keys){
+// One namespace per selection
+	TString src;
+	src += "// Generated by MT2Selection, do not edit\n";
+	src += "#if !defined(__CINT__) && !defined(__MAKECINT__)\n";
+	src += "#include <cmath>\n#include \"TMath.h\"\n#include \"MT2tree.hh\"\n#include \"MT2Selection.hh\"\n";
+	src += "using namespace std;\n\nnamespace {\n\n";
+	for(size_t i = 0; i < bodies.size(); ++i){
+		src += TString::Format("namespace MT2Sel_%s {\n\n", keys[i].Data());
+		src += bodies[i];
+		src += TString::Format("const bool registered = MT2Selection::Register(\"%s\", &MT2SelCuts, &MT2SelVars, &MT2SelWeight);\n\n", keys[i].Data());
+		src += "}\n\n";
+	}
+	src += "}\n#endif\n";
+	return src;
+}
+
+bool MT2Selection::WriteSource(TString filename){
+	TString key;
+	TString body = GetBody(key);
+	TString src = GetSource(vector<TString>(1, body), vector<TString>(1, key));
+	ofstream file(filename.Data());
+	if(!file.good()){
+		cout << "MT2Selection::WriteSource ==> Error: cannot write " << filename << endl;
+		return false;
+	}
+	file << src;
+	return true;
+}
+
+//____________________________________________________________________________
+std::map<TString, MT2Selection::Functions>& MT2Selection::Registry(){
+	static std::map<TString, Functions> registry;
+	return registry;
+}
+
+bool MT2Selection::Register(const char *key, MT2CutFunc cuts, MT2VarFunc vars, MT2WeightFunc weight){
+	Functions f;
+	f.cuts   = cuts;
+	f.vars   = vars;
+	f.weight = weight;
+	Registry()[key] = f;
+	return true;
+}
+
+bool MT2Selection::Compile(TString includedir, TString builddir){
+	return CompileAll(vector<MT2Selection*>(1, this), includedir, builddir);
+}
+
+bool MT2Selection::CompileAll(const vector<MT2Selection*> &sels, TString includedir, TString builddir){
+// Compile the selections which are neither linked in nor compiled before,
+// all in one file
+	vector<TString> bodies;
+	vector<TString> keys;
+	for(size_t i = 0; i < sels.size(); ++i){
+		TString key;
+		TString body = sels[i]->GetBody(key);
+		if(Registry().count(key) || find(keys.begin(), keys.end(), key) != keys.end()) continue;
+		bodies.push_back(body);
+		keys.push_back(key);
+	}
+	if(!keys.empty()){
+		TString src = GetSource(bodies, keys);
+		if(builddir == "") builddir = GetBuildDir();
+		if(builddir == "") return false;
+		TString filename = TString::Format("%s/MT2Selection_%s.C", builddir.Data(), keys[0].Data());
+		ofstream file(filename.Data());
+		if(!file.good()){
+			cout << "MT2Selection::CompileAll ==> Error: cannot write " << filename << endl;
+			return false;
+		}
+		file << src;
+		file.close();
+		TString incpath = "-I" + includedir;
+		if(!TString(gSystem->GetIncludePath()).Contains(incpath)) gSystem->AddIncludePath(incpath);
+		if(!gSystem->CompileMacro(filename, "kO")){
+			cout << "MT2Selection::CompileAll ==> Error: cannot compile " << filename << endl;
+			return false;
+		}
+	}
+	bool ok = true;
+	for(size_t i = 0; i < sels.size(); ++i) ok = sels[i]->SetFunctions() && ok;
+	return ok;
+}
+
+TString MT2Selection::GetBuildDir(){
+// New directory of this process under the temp directory, so that
+// concurrent jobs never write or load each other's sources and libraries
+	static TString dir;
+	if(dir != "") return dir;
+	string templ = string(gSystem->TempDirectory()) + "/MT2Selection_XXXXXX";
+	vector<char> buf(templ.begin(), templ.end());
+	buf.push_back('\0');
+	if(mkdtemp(&buf[0]) == 0){
+		cout << "MT2Selection::GetBuildDir ==> Error: cannot create " << templ << endl;
+		return "";
+	}
+	dir = &buf[0];
+	return dir;
+}
+
+bool MT2Selection::SetFunctions(){
+	TString key;
+	GetBody(key);
+	std::map<TString, Functions>::const_iterator it = Registry().find(key);
+	if(it == Registry().end()){
+		cout << "MT2Selection::SetFunctions ==> Error: selection is not registered" << endl;
+		return false;
+	}
+	fFunc     = it->second;
+	fCompiled = true;
+	fValues.assign(fVarExpr.size(), 0.);
+	return true;
+}
+
+//____________________________________________________________________________
+bool MT2Selection::Pass(MT2tree &t, double scale){
+	if(!fCompiled){
+		cout << "MT2Selection::Pass ==> Error: selection not compiled" << endl;
+		return false;
+	}
+	fWeight = fFunc.weight(t);
+	const double w = scale*fWeight;
+	fNTotal++;
+	fWTotal += w;
+
+	const int npass = fFunc.cuts(t);
+	for(int i = 0; i < npass; ++i){
+		fNPass[i]++;
+		fWPass[i] += w;
+	}
+	if(npass < (int)fCutExpr.size()) return false;
+	if(fValues.size() > 0) fFunc.vars(t, &fValues[0]);
+	return true;
+}
+
+void MT2Selection::Book(TH1 *h, int var){
+	fHistos.push_back(make_pair(h, var));
+}
+
+Long64_t MT2Selection::Loop(TTree *tree, double scale, Long64_t nentries){
+// One pass with a temporary MT2tree, the previous address of the branch
+// (e.g. MassPlotter's fMT2tree) is set back afterwards
+	TBranch *br = tree->GetBranch("MT2tree");
+	if(!br){
+		cout << "MT2Selection::Loop ==> Error: no MT2tree branch in " << tree->GetName() << endl;
+		return 0;
+	}
+	void *address = br->GetAddress();
+	MT2tree *t = new MT2tree();
+	Long64_t nsel = Loop(tree, t, scale, nentries);
+	if(address) tree->SetBranchAddress("MT2tree", address);
+	else        tree->ResetBranchAddresses();
+	delete t;
+	return nsel;
+}
+
+bool MT2Selection::SelectBranches(TTree *tree, vector<pair<TString, bool> > &status) const {
+// Enable only the branches of the leaves used by the expressions, found by
+// TTreeFormula as in TTree::Draw. The previous status of all branches is
+// returned in status. False (nothing changed) if an expression does not
+// compile as a formula or calls a member function of MT2tree, which may
+// use any member.
+	vector<TString> exprs(fCutExpr);
+	exprs.insert(exprs.end(), fVarExpr.begin(), fVarExpr.end());
+	exprs.push_back(fWeightExpr);
+
+	if(tree->LoadTree(0) < 0) return false;
+	TBranch *top = tree->GetBranch("MT2tree");
+	set<TString> names;
+	for(size_t i = 0; i < exprs.size(); ++i){
+		TTreeFormula form("MT2SelBranches", exprs[i], tree);
+		if(form.GetNdim() == 0) return false;
+		for(int l = 0; l < form.GetNcodes(); ++l){
+			TLeaf *leaf = form.GetLeaf(l);
+			if(leaf == 0) continue;
+			TBranch *br = leaf->GetBranch();
+			if(br == top) return false;
+			names.insert(br->GetName());
+			TBranchElement *be = dynamic_cast<TBranchElement*>(br);
+			if(be && be->GetBranchCount()) names.insert(be->GetBranchCount()->GetName());
+		}
+	}
+
+	status.clear();
+	TObjArray *leaves = tree->GetListOfLeaves();
+	for(int l = 0; l < leaves->GetEntriesFast(); ++l){
+		TString name = ((TLeaf*)leaves->At(l))->GetBranch()->GetName();
+		status.push_back(make_pair(name, tree->GetBranchStatus(name) != 0));
+	}
+	tree->SetBranchStatus("*", 0);
+	for(set<TString>::const_iterator it = names.begin(); it != names.end(); ++it){
+		tree->SetBranchStatus(*it, 1);
+		tree->SetBranchStatus(*it + ".*", 1); // members of split objects
+	}
+	return true;
+}
+
+Long64_t MT2Selection::Loop(TTree *tree, MT2tree *&t, double scale, Long64_t nentries){
+// One pass over the tree: cut flow and booked histograms
+	if(!fCompiled && !Compile()) return 0;
+	vector<pair<TString, bool> > status;
+	bool selected = SelectBranches(tree, status);
+	tree->SetBranchAddress("MT2tree", &t);
+	if(nentries < 0 || nentries > tree->GetEntries()) nentries = tree->GetEntries();
+
+	Long64_t nsel = 0;
+	for(Long64_t i = 0; i < nentries; ++i){
+		tree->GetEntry(i);
+		if(!Pass(*t, scale)) continue;
+		nsel++;
+		for(size_t h = 0; h < fHistos.size(); ++h)
+			fHistos[h].first->Fill(fValues[fHistos[h].second], scale*fWeight);
+	}
+	if(selected){
+		for(size_t i = 0; i < status.size(); ++i) tree->SetBranchStatus(status[i].first, status[i].second);
+	}
+	return nsel;
+}
+
+//____________________________________________________________________________
+void MT2Selection::ResetCounters(){
+	fNTotal = 0;
+	fWTotal = 0.;
+	fNPass.assign(fCutExpr.size(), 0);
+	fWPass.assign(fCutExpr.size(), 0.);
+}
+
+double MT2Selection::GetEfficiency(int i) const {
+	double before = i > 0 ? fWPass[i-1] : fWTotal;
+	return before != 0. ? fWPass[i]/before : 0.;
+}
+
+void MT2Selection::PrintCutFlow(TString title) const {
+	cout << setfill('-') << setw(100) << "" << setfill(' ') << endl;
+	if(title != "") cout << " " << title << endl;
+	cout << setw(50) << left << " Cut" << right << setw(12) << "Events" << setw(14) << "Weighted"
+	     << setw(12) << "Eff." << setw(12) << "Cum. eff." << endl;
+	cout << setw(50) << left << " All events" << right << setw(12) << fNTotal << setw(14) << fWTotal << endl;
+	for(size_t i = 0; i < fCutExpr.size(); ++i){
+		TString label = " " + fCutLabel[i];
+		if(label.Length() > 49) label = label(0, 46) + "...";
+		cout << setw(50) << left << label << right << setw(12) << fNPass[i] << setw(14) << fWPass[i]
+		     << setw(12) << setprecision(4) << GetEfficiency(i)
+		     << setw(12) << setprecision(4) << (fWTotal != 0. ? fWPass[i]/fWTotal : 0.) << endl;
+	}
+	cout << setfill('-') << setw(100) << "" << setfill(' ') << endl;
+}
@@ -1,6 +1,6 @@
 #include "MT2tree.hh"
 
-#include "helper/Davismt2.h"
+#include "helper/MT2Calculator.hh"
 #include "helper/TMctLib.h"
 
 #include <vector>
@@ -15,6 +15,31 @@
 
 using std::vector;
 
+// MT2HemiEngine -----------------------------
+MT2HemiEngine::~MT2HemiEngine(){
+  delete fHemi;
+}
+
+Hemisphere& MT2HemiEngine::Get(int n, const float* px, const float* py, const float* pz, const float* E,
+                               int hemi_seed, int hemi_association){
+  // variants with the same jets and seeding in one event reuse one reconstruction (see Hemisphere.hh)
+  if(fHemi == 0) fHemi = new Hemisphere();
+  fHemi->SetObjects(n, px, py, pz, E);
+  fHemi->SetMethod(hemi_seed, hemi_association);
+  fHemi->NoRejectISR();
+  return *fHemi;
+}
+
+// MT2CalcEngine -----------------------------
+MT2CalcEngine::~MT2CalcEngine(){
+  delete fCalc;
+}
+
+MT2Calculator& MT2CalcEngine::Get(){
+  if(fCalc == 0) fCalc = new MT2Calculator();
+  return *fCalc;
+}
+
 // MT2Misc -----------------------------------
 MT2Misc::MT2Misc(){
   Reset();
@@ -1002,29 +1027,30 @@ Double_t MT2tree::GetMT2HemiNoISR(bool massive, int hemi_seed, int hemi_associat
   else return -999;
  
 
-  vector<float> px, py, pz, E;
-  vector<int>   jsel; // contains indices of all jets fed into hemisphere algo
+  float px[m_jetSize], py[m_jetSize], pz[m_jetSize], E[m_jetSize];
+  int   jsel[m_jetSize]; // contains indices of all jets fed into hemisphere algo
+  int   nsel = 0;
   for(int i=0; i<NJets; ++i){
 	if(jet[i].IsGoodPFJet(20, 2.4, 1)) continue;
-  	px.push_back(jet[i].lv.Px());
-	py.push_back(jet[i].lv.Py());
-	pz.push_back(jet[i].lv.Pz());
-	 E.push_back(jet[i].lv.E());
-	jsel.push_back(i);
+  	px[nsel] = jet[i].lv.Px();
+	py[nsel] = jet[i].lv.Py();
+	pz[nsel] = jet[i].lv.Pz();
+	 E[nsel] = jet[i].lv.E();
+	jsel[nsel] = i;
+	nsel++;
   }
 		
-  if (px.size()<2) return -999;
+  if (nsel<2) return -999;
 
   // get hemispheres (seed 2: max inv mass, association method: default 3 = minimal lund distance)
-  Hemisphere* hemi = new Hemisphere(px, py, pz, E, hemi_seed, hemi_association);
-  hemi->SetDebug(0);
-  if(MaxDR > 0) hemi->RejectISRDRmax(MaxDR);
-  vector<int> grouping = hemi->getGrouping();
+  Hemisphere& hemi = fHemiEngine.Get(nsel, px, py, pz, E, hemi_seed, hemi_association);
+  if(MaxDR > 0) hemi.RejectISRDRmax(MaxDR);
+  const int* grouping = hemi.Grouping();
 
   TLorentzVector pseudojet1(0.,0.,0.,0.);
   TLorentzVector pseudojet2(0.,0.,0.,0.);
   vector<int>    jused; // contains indices of jets used for pseudojets
-  for(int i=0; i<px.size(); ++i){
+  for(int i=0; i<nsel; ++i){
 	if(grouping[i]==1){
 		jused     .push_back(jsel[i]);
 		pseudojet1.SetPx(pseudojet1.Px() + px[i]);
@@ -1039,7 +1065,6 @@ Double_t MT2tree::GetMT2HemiNoISR(bool massive, int hemi_seed, int hemi_associat
 		pseudojet2.SetE( pseudojet2.E()  + E[i]);
 	}
   }
-  delete hemi;
  
   for(int i=0; i<NJets; ++i){
 	bool used(false);  
@@ -1075,26 +1100,27 @@ Double_t MT2tree::GetMT2Hemi(double testmass, bool massive, int PFJID, double mi
 	} else {return -111;}
   }
 
-  vector<float> px, py, pz, E;
+  float px[m_jetSize], py[m_jetSize], pz[m_jetSize], E[m_jetSize];
+  int   nsel = 0;
   for(int i=0; i<NJets; ++i){
 	if(jet[i].IsGoodPFJet(minJPt, maxJEta, PFJID) ==false) continue;
-  	px.push_back(jet[i].lv.Px());
-	py.push_back(jet[i].lv.Py());
-	pz.push_back(jet[i].lv.Pz());
-	E .push_back(jet[i].lv.E ());
+  	px[nsel] = jet[i].lv.Px();
+	py[nsel] = jet[i].lv.Py();
+	pz[nsel] = jet[i].lv.Pz();
+	E [nsel] = jet[i].lv.E ();
+	nsel++;
   }
 		
-  if (px.size()<2) return -999;
+  if (nsel<2) return -999;
   
 
   // get hemispheres (seed 2: max inv mass, association method: default 3 = minimal lund distance)
-  Hemisphere* hemi = new Hemisphere(px, py, pz, E, 2, hemi_association);
-  vector<int> grouping = hemi->getGrouping();
+  const int* grouping = fHemiEngine.Get(nsel, px, py, pz, E, 2, hemi_association).Grouping();
 
   TLorentzVector pseudojet1(0.,0.,0.,0.);
   TLorentzVector pseudojet2(0.,0.,0.,0.);
 	
-  for(int i=0; i<px.size(); ++i){
+  for(int i=0; i<nsel; ++i){
 	if(grouping[i]==1){
 		pseudojet1.SetPx(pseudojet1.Px() + px[i]);
 		pseudojet1.SetPy(pseudojet1.Py() + py[i]);
@@ -1107,7 +1133,6 @@ Double_t MT2tree::GetMT2Hemi(double testmass, bool massive, int PFJID, double mi
 		pseudojet2.SetE( pseudojet2.E()  + E[i]);
 	}
   }
-  delete hemi;
 
   if(met==4) {MET = -pseudojet1 - pseudojet2;} 
   if(MET.Pt()<30) {return -222;}
@@ -1191,12 +1216,7 @@ Double_t MT2tree::CalcMT2(double testmass, bool massive, TLorentzVector visible1
   pb[1] = visible2.Px();
   pb[2] = visible2.Py();
   
-  Davismt2 *mt2 = new Davismt2();
-  mt2->set_momenta(pa, pb, pmiss);
-  mt2->set_mn(testmass);
-  Double_t MT2=mt2->get_mt2();
-  delete mt2;
-  return MT2;
+  return fMT2Engine.Get().getMT2(pa, pb, pmiss, testmass);
 
 }
 
@@ -1332,25 +1352,26 @@ Double_t MT2tree::GetMaxHemiMass(int hemi_index){
 
 Double_t MT2tree::GetPseudoJetsdPhi(int hemi_seed, int hemi_association, int PFJID, double minJPt, double maxJEta){
 
-  vector<float> px, py, pz, E;
+  float px[m_jetSize], py[m_jetSize], pz[m_jetSize], E[m_jetSize];
+  int   nsel = 0;
   for(int i=0; i<NJets; ++i){
 	if(jet[i].IsGoodPFJet(minJPt, maxJEta, PFJID) ==false) continue;
-  	px.push_back(jet[i].lv.Px());
-	py.push_back(jet[i].lv.Py());
-	pz.push_back(jet[i].lv.Pz());
-	 E.push_back(jet[i].lv.E());
+  	px[nsel] = jet[i].lv.Px();
+	py[nsel] = jet[i].lv.Py();
+	pz[nsel] = jet[i].lv.Pz();
+	 E[nsel] = jet[i].lv.E();
+	nsel++;
   }
 		
-  if (px.size()<2) return -999;
+  if (nsel<2) return -999;
 
   // get hemispheres (seed 2: max inv mass, association method: default 3 = minimal lund distance)
-  Hemisphere* hemi = new Hemisphere(px, py, pz, E, hemi_seed, hemi_association);
-  vector<int> grouping = hemi->getGrouping();
+  const int* grouping = fHemiEngine.Get(nsel, px, py, pz, E, hemi_seed, hemi_association).Grouping();
 
   TLorentzVector pseudojet1(0.,0.,0.,0.);
   TLorentzVector pseudojet2(0.,0.,0.,0.);
 	
-  for(int i=0; i<px.size(); ++i){
+  for(int i=0; i<nsel; ++i){
 	if(grouping[i]==1){
 		pseudojet1.SetPx(pseudojet1.Px() + px[i]);
 		pseudojet1.SetPy(pseudojet1.Py() + py[i]);
@@ -1363,7 +1384,6 @@ Double_t MT2tree::GetPseudoJetsdPhi(int hemi_seed, int hemi_association, int PFJ
 		pseudojet2.SetE( pseudojet2.E()  + E[i]);
 	}
   }
-  delete hemi;
   return Util::DeltaPhi(pseudojet1.Phi(), pseudojet2.Phi());
 }
 
@@ -1985,27 +2005,26 @@ Double_t MT2tree::RemoveAndRecalcMT2(int option, float prob, bool hiDphi, float
   if(misc.CrazyHCAL ) return -9.;
 
   // make pseudojets with hemispheres
-  vector<float> px, py, pz, E;
+  float px[m_jetSize], py[m_jetSize], pz[m_jetSize], E[m_jetSize];
   for(int i=0; i<njets; ++i){
-  	px.push_back(JETS[i].Px());
-	py.push_back(JETS[i].Py());
-	pz.push_back(JETS[i].Pz());
-	E .push_back(JETS[i].E ());
+  	px[i] = JETS[i].Px();
+	py[i] = JETS[i].Py();
+	pz[i] = JETS[i].Pz();
+	E [i] = JETS[i].E ();
   }
 		
-  if (px.size()<2) { // protection against events with only one jet
+  if (njets<2) { // protection against events with only one jet
     misc.MT2 = 0;
     return -9.;
   }
 
   // get hemispheres (seed 2: max inv mass, association method: default 3 = minimal lund distance)
-  Hemisphere* hemi = new Hemisphere(px, py, pz, E, 2, 3);
-  vector<int> grouping = hemi->getGrouping();
+  const int* grouping = fHemiEngine.Get(njets, px, py, pz, E, 2, 3).Grouping();
 
   TLorentzVector pseudojet1(0.,0.,0.,0.);
   TLorentzVector pseudojet2(0.,0.,0.,0.);
 	
-  for(int i=0; i<px.size(); ++i){
+  for(int i=0; i<njets; ++i){
 	if(grouping[i]==1){
 		pseudojet1.SetPx(pseudojet1.Px() + px[i]);
 		pseudojet1.SetPy(pseudojet1.Py() + py[i]);
@@ -2018,7 +2037,6 @@ Double_t MT2tree::RemoveAndRecalcMT2(int option, float prob, bool hiDphi, float
 		pseudojet2.SetE( pseudojet2.E()  + E[i]);
 	}
   }
-  delete hemi;
 
   if(MET.Pt()<30) {return -9.;}
   float mt2 = CalcMT2(0, 0, pseudojet1, pseudojet2, MET); 
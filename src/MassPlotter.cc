@@ -8,6 +8,8 @@
 #include "TGraphAsymmErrors.h"
 #include "helper/Utilities.hh"
 #include "helper/Monitor.hh"
+#include "helper/PlotBook.hh"
+#include "MT2Selection.hh"
 
 #include "TLatex.h"
 #include "TLegend.h"
@@ -50,6 +52,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <map>
+#include <algorithm>
 #include <time.h> // access to date/time
 
 
@@ -165,10 +168,27 @@ void MassPlotter::MakeMT2PredictionAndPlots(bool cleaned , double dPhisplit[], d
 
 	TString cuts = cutStream.str().c_str();
 	
-	//                 variable                            cuts njets  nlepts HLT title     bins               flip_order  log  composite    ratio  stacked overlay 
-	MakePlot(fSamples,"misc.MT2" ,                         cuts, -3,   0,    "",  "MT2" , gNMT2bins, gMT2bins , false,  true ,  true,      true,  true,  false);
-//	MakePlot(fSamples,"hemi[0].lv1.M()" ,                  cuts, -3,   0,    "",  "h1.M", 30,       0, 1000  , false,  true ,  true,      true,  true,  false);
-//	MakePlot(fSamples,"hemi[0].lv2.M()" ,                  cuts, -3,   0,    "",  "h1.M", 30,       0, 1000  , false,  true ,  true,      true,  true,  false);
+	// the plots of this driver: all are booked first, the samples are then
+	// read only once and MakePlot takes the booked histograms
+	struct plotdef { TString var; TString title; int nbins; const double *bins; };
+	std::vector<plotdef> plots;
+//	double hemiMbins[31];
+//	for(int i=0; i<=30; i++) hemiMbins[i] = i*1000./30;
+	//                    variable             title   bins
+	plotdef mt2       = {"misc.MT2"        , "MT2" , gNMT2bins, gMT2bins }; plots.push_back(mt2);
+//	plotdef hemi0lv1M = {"hemi[0].lv1.M()" , "h1.M", 30,        hemiMbins}; plots.push_back(hemi0lv1M);
+//	plotdef hemi0lv2M = {"hemi[0].lv2.M()" , "h1.M", 30,        hemiMbins}; plots.push_back(hemi0lv2M);
+
+	for(size_t k = 0; k < plots.size(); ++k)
+		BookPlot(plots[k].var, cuts, -3, 0, "", plots[k].nbins, plots[k].bins);
+	FillBookedPlots();
+
+	for(size_t k = 0; k < plots.size(); ++k){
+		//               variable       cuts njets  nlepts HLT title           bins                             flip_order  log  composite    ratio  stacked overlay 
+		MakePlot(fSamples,plots[k].var, cuts, -3,   0,    "",  plots[k].title, plots[k].nbins, plots[k].bins, false,  true ,  true,      true,  true,  false);
+	}
+
+	ClearBookedPlots();
 
 }
 
@@ -196,6 +216,146 @@ void MassPlotter::MakePlot(TString var, TString cuts, int njets, int nleps, TStr
 
 }
 
+//________________________________________________________________________
+TString MassPlotter::GetPlotCuts(const sample &Sample, TString cuts, int njets, int nleps, TString HLT){
+// Selection of MakePlot: jet and lepton multiplicities, cuts and triggers for data
+	TString nJets = "NJetsIDLoose";
+	nJets += njets < 0 ? ">=" : "==";
+	nJets += TString::Format("%d",abs(njets));
+
+	TString  nLeps;
+	if     (nleps < 0 )  nLeps = " && (NEles + NMuons) >=";
+	else if(nleps >=0  ) nLeps = " && (NEles + NMuons) ==";
+	nLeps += TString::Format("%d",abs(nleps));
+	if     (nleps ==-10) nLeps = " "; 
+	if     (nleps ==-11) nLeps = " && NEles ==1 && NMuons ==0"; 
+	if     (nleps ==-13) nLeps = " && NEles ==0 && NMuons ==1"; 
+
+	TString theCuts = nJets + nLeps + "&&" + cuts;
+	if(Sample.type=="data" && HLT!="") theCuts += " &&("+HLT+")"; // triggers for data
+	return theCuts;
+}
+
+TString MassPlotter::GetSampleWeight(const sample &Sample, double scale_factor){
+	Double_t weight = scale_factor * Sample.xsection * Sample.kfact * Sample.lumi / (Sample.nevents);
+	if(Sample.type!="data") return TString::Format("%.15f*pileUp.Weight",weight);
+	else                    return TString::Format("%.15f"              ,weight);
+}
+
+TString MassPlotter::GetPlotSigWeight(const sample &Sample){
+	Double_t weight = Sample.xsection * Sample.kfact * Sample.lumi / (Sample.nevents);
+	return TString::Format("%f",weight);
+}
+
+void MassPlotter::GetCompSamplesPlot(const sample &Sample, TString var, TString cuts, TString optcut, bool RemoveLepts, double scale_factor,
+				     TString &variable, TString &theCuts, TString &weight){
+// Variable, cuts and weight of CompSamples: the variable with removed
+// leptons if requested, the optional cut for DYToLL
+	if(RemoveLepts && (Sample.sname == "DYToLL" || Sample.sname=="QCD_2")){
+		MapType::iterator iter = RemoveLeptMap.find(var);
+		if (iter != RemoveLeptMap.end() ){
+			variable = iter -> second;
+		} else {cout << "found RemoveLepts==true, but no corresponding map" << endl; variable = var;}
+	}else {
+		variable = var;
+	}
+	theCuts = cuts;
+	if(optcut!="_" && Sample.sname == "DYToLL") theCuts += "&&" + optcut;
+	weight  = GetSampleWeight(Sample, scale_factor);
+}
+
+//________________________________________________________________________
+void MassPlotter::BookPlot(TString var, TString cuts, int njets, int nleps, TString HLT,
+			   const int nbins, const double min, const double max){
+	double bins[nbins+1];
+	for(int i=0; i<=nbins; i++) bins[i] = min+i*(max-min)/nbins;
+	BookPlot(var, cuts, njets, nleps, HLT, nbins, bins);
+}
+
+void MassPlotter::BookPlot(TString var, TString cuts, int njets, int nleps, TString HLT,
+			   const int nbins, const double *bins){
+// Book a MakePlot histogram for all samples
+	for(size_t i = 0; i < fSamples.size(); ++i)
+		BookSamplePlot(fSamples[i], var, GetPlotCuts(fSamples[i], cuts, njets, nleps, HLT), GetSampleWeight(fSamples[i]), nbins, bins);
+}
+
+void MassPlotter::BookCompSamples(TString var, TString cuts, TString optcut, bool RemoveLepts,
+				  const int nbins, const double *bins, double scale_factor){
+// Book the CompSamples histograms of the first two samples
+	for(size_t i = 0; i < 2 && i < fSamples.size(); ++i){
+		TString variable, theCuts, weight;
+		GetCompSamplesPlot(fSamples[i], var, cuts, optcut, RemoveLepts, scale_factor, variable, theCuts, weight);
+		BookSamplePlot(fSamples[i], variable, theCuts, weight, nbins, bins);
+	}
+}
+
+void MassPlotter::BookPlotSig(TString var, TString cuts, int nbins, double min, double max){
+// Book the plotSig histograms of the mc and susy samples
+	double bins[nbins+1];
+	for(int i=0; i<=nbins; i++) bins[i] = min+i*(max-min)/nbins;
+	for(size_t i = 0; i < fSamples.size(); ++i){
+		if(!(fSamples[i].type=="susy") && !(fSamples[i].type=="mc")) continue;
+		BookSamplePlot(fSamples[i], var, cuts, GetPlotSigWeight(fSamples[i]), nbins, bins);
+	}
+}
+
+void MassPlotter::BookSamplePlot(const sample &Sample, TString var, TString theCuts, TString weight,
+				 const int nbins, const double *bins){
+	for(size_t j = 0; j < fBookedPlots.size(); ++j){ // booked before
+		bookedplot &p = fBookedPlots[j];
+		if(p.tree == Sample.tree && p.sname == Sample.name && p.var == var && p.cuts == theCuts && p.weight == weight
+		   && (int)p.bins.size() == nbins+1 && std::equal(p.bins.begin(), p.bins.end(), bins)) return;
+	}
+	bookedplot p;
+	p.tree   = Sample.tree;
+	p.sname  = Sample.name;
+	p.var    = var;
+	p.cuts   = theCuts;
+	p.weight = weight;
+	p.bins.assign(bins, bins+nbins+1);
+	p.histo  = 0;
+	fBookedPlots.push_back(p);
+}
+
+//________________________________________________________________________
+void MassPlotter::FillBookedPlots(){
+// Fill all booked plots with one pass per sample. Identical expressions
+// of different plots are evaluated once per event.
+	for(size_t j = 0; j < fBookedPlots.size(); ++j){
+		if(fBookedPlots[j].histo) continue; // filled before
+		TTree *tree = fBookedPlots[j].tree;
+		PlotBook book;
+		book.setVerbose(fVerbose>2 ? 1 : 0);
+		for(size_t k = j; k < fBookedPlots.size(); ++k){
+			bookedplot &p = fBookedPlots[k];
+			if(p.tree != tree || p.histo) continue;
+			p.histo = new TH1D(TString::Format("booked_%d", (int)k), "", p.bins.size()-1, &p.bins[0]);
+			p.histo->Sumw2();
+			p.histo->SetDirectory(0);
+			book.Book(p.histo, p.var, p.cuts, p.weight);
+		}
+		if(fVerbose>2) cout << "FillBookedPlots: looping over " << fBookedPlots[j].sname << " for " << book.GetNPlots() << " plots" << endl;
+		if(book.Fill(tree) < 0) cout << "MassPlotter::FillBookedPlots ==> Error in " << fBookedPlots[j].sname << endl;
+	}
+}
+
+TH1D* MassPlotter::GetBookedHisto(const sample &Sample, TString var, TString theCuts, TString weight,
+				  const int nbins, const double *bins){
+	for(size_t j = 0; j < fBookedPlots.size(); ++j){
+		bookedplot &p = fBookedPlots[j];
+		if(p.histo == 0 || p.tree != Sample.tree || p.sname != Sample.name) continue;
+		if(p.var != var || p.cuts != theCuts || p.weight != weight) continue;
+		if((int)p.bins.size() != nbins+1 || !std::equal(p.bins.begin(), p.bins.end(), bins)) continue;
+		return p.histo;
+	}
+	return 0;
+}
+
+void MassPlotter::ClearBookedPlots(){
+	for(size_t j = 0; j < fBookedPlots.size(); ++j) delete fBookedPlots[j].histo;
+	fBookedPlots.clear();
+}
+
 // ________________________________________________________________________
 void MassPlotter::PrintWEfficiency(int sample_index ,TString process,  std::string lept, Long64_t nevents, bool includeTaus){
 	sample Sample = fSamples[sample_index];
@@ -818,6 +978,27 @@ void MassPlotter::PrintCutFlow(int njets, int nleps, TString trigger, TString cu
 
 }
 
+//________________________________________________________________________
+void MassPlotter::PrintCompiledCutFlow(TString cuts, int njets, int nleps, TString HLT){
+// Cut flow of the MakePlot selection, one line per "&&" term, evaluated
+// with compiled code in a single pass per sample
+	vector<MT2Selection>  sels(fSamples.size());
+	vector<MT2Selection*> tocompile;
+	for(size_t i = 0; i < fSamples.size(); ++i){
+		sels[i].AddCuts(GetPlotCuts(fSamples[i], cuts, njets, nleps, HLT));
+		if(fSamples[i].type!="data") sels[i].SetWeight("pileUp.Weight");
+		tocompile.push_back(&sels[i]);
+	}
+	if(!MT2Selection::CompileAll(tocompile)) return;
+
+	for(size_t i = 0; i < fSamples.size(); ++i){
+		Double_t sample_weight = fSamples[i].xsection * fSamples[i].kfact * fSamples[i].lumi / (fSamples[i].nevents);
+		if(fVerbose>2) cout << "PrintCompiledCutFlow: looping over " << fSamples[i].name << endl;
+		sels[i].Loop(fSamples[i].tree, sample_weight);
+		sels[i].PrintCutFlow(fSamples[i].name);
+	}
+}
+
 //________________________________________________________________________
 
 void MassPlotter::FillMonitor(Monitor *count, TString sname, TString type, TString cut, double weight){
@@ -853,31 +1034,42 @@ void MassPlotter::plotSig(TString var, TString cuts, TString xtitle, int nbins,
 	h_susy      ->Sumw2();
 	// vector of all histos
 	vector<TH1D*> h_samples;
+	double bins[nbins+1];
+	for(int i=0; i<=nbins; i++) bins[i] = min+i*(max-min)/nbins;
 
 	for(size_t i = 0; i < fSamples.size(); ++i){
 	        if(!(fSamples[i].type=="susy") && !(fSamples[i].type=="mc")) continue;
 
-		h_samples.push_back(new TH1D(varname+"_"+fSamples[i].name, "", nbins, min, max));
-		h_samples[i] -> Sumw2();
+		TH1D *h = new TH1D(varname+"_"+fSamples[i].name, "", nbins, min, max);
+		h -> Sumw2();
+		h_samples.push_back(h);
 
 		Double_t weight = fSamples[i].xsection * fSamples[i].kfact * fSamples[i].lumi / (fSamples[i].nevents);
 
 		if(fVerbose>2) cout << "MakePlot: looping over " << fSamples[i].sname << endl;
 		if(fVerbose>2) cout << "           sample has weight " << weight << " and " << fSamples[i].tree->GetEntries() << " entries" << endl; 
 	
-		TString variable  = TString::Format("%s>>%s",var.Data(),h_samples[i]->GetName());
-		TString selection = TString::Format("(%f) * (%s)",weight,cuts.Data());
-		  
-		if(fVerbose>2) cout << "+++++ Drawing " << variable  << endl
-				    << "\twith cuts: "  << selection << endl;
-
-		int nev = fSamples[i].tree->Draw(variable.Data(),selection.Data(),"goff");
+		TString variable  = TString::Format("%s>>%s",var.Data(),h->GetName());
+		TString selection = TString::Format("(%s) * (%s)",GetPlotSigWeight(fSamples[i]).Data(),cuts.Data());
+
+		int nev;
+		TH1D *h_booked = GetBookedHisto(fSamples[i], var, cuts, GetPlotSigWeight(fSamples[i]), nbins, bins);
+		if(h_booked){ // already filled by FillBookedPlots
+			if(fVerbose>2) cout << "+++++ Using booked " << var << endl
+					    << "\twith cuts: "  << selection << endl;
+			h->Add(h_booked);
+			nev = (int)h_booked->GetEntries();
+		} else {
+			if(fVerbose>2) cout << "+++++ Drawing " << variable  << endl
+					    << "\twith cuts: "  << selection << endl;
+			nev = fSamples[i].tree->Draw(variable.Data(),selection.Data(),"goff");
+		}
 		
 		if(fVerbose>2) cout << "\tevents found : "  <<  nev << endl
-				    << "\t->Integral() : "  <<  h_samples[i]->Integral() << endl;
+				    << "\t->Integral() : "  <<  h->Integral() << endl;
 		
-		if( fSamples[i].type=="mc"        )   h_mc_sum->Add(h_samples[i]);
-		else if( fSamples[i].type=="susy" )   h_susy  ->Add(h_samples[i]);
+		if( fSamples[i].type=="mc"        )   h_mc_sum->Add(h);
+		else if( fSamples[i].type=="susy" )   h_susy  ->Add(h);
 	}
 	Float_t  x[nbins], y[nbins];
 	for (int i = 1; i <=nbins+1; i++){
@@ -930,7 +1122,7 @@ void MassPlotter::compSamples(TString var, TString cuts, TString optcut, bool Re
 void MassPlotter::CompSamples(std::vector<sample> Samples, TString var, TString cuts, TString optcut, bool RemoveLepts,
 			   TString xtitle, const int nbins, const double min, const double max, bool add_underflow, bool logflag, double scale_factor, bool normalize){
 
-  	double bins[nbins];
+  	double bins[nbins+1];
   	bins[0] = min;
   	for(int i=1; i<=nbins; i++)
     	bins[i] = min+i*(max-min)/nbins;
@@ -962,34 +1154,24 @@ void MassPlotter::CompSamples(std::vector<sample> Samples, TString var, TString
 		if(fVerbose>2) cout << "GetHisto: looping over " << Samples[i].sname << endl;
 		if(fVerbose>2) cout << "           sample has weight " << weight << " and " << Samples[i].tree->GetEntries() << " entries" << endl; 
 		// exchange variable to plot with the corresponding one with removed leptons;	
-		TString variable; 
-		TString selection; 
-		if(RemoveLepts && (Samples[i].sname == "DYToLL" || Samples[i].sname=="QCD_2")){
-			MapType::iterator iter = RemoveLeptMap.begin();
-			iter = RemoveLeptMap.find(var);
-			if (iter != RemoveLeptMap.end() ){
-				variable = iter -> second;
-			} else {cout << "found RemoveLepts==true, but no corresponding map" << endl; variable = var;}
-		}else {
-			variable = var;
-		}
-		if(optcut!="_" && Samples[i].sname == "DYToLL"){
-			TString newcuts = cuts + "&&" + optcut;  
-			if(Samples[i].type!="data") selection      = TString::Format("(%.15f*pileUp.Weight) * (%s)",weight,newcuts.Data());
-			else                        selection      = TString::Format("(%.15f) * (%s)"              ,weight,newcuts.Data()); 
+		TString variable, theCuts, weights;
+		GetCompSamplesPlot(Samples[i], var, cuts, optcut, RemoveLepts, scale_factor, variable, theCuts, weights);
+		TString selection = TString::Format("(%s) * (%s)",weights.Data(),theCuts.Data());
+
+		int nev;
+		TH1D *h_booked = GetBookedHisto(Samples[i], variable, theCuts, weights, nbins, bins);
+		if(h_booked){ // already filled by FillBookedPlots
+			if(fVerbose>2) cout << "+++++ Using booked " << variable << endl
+					    << "\twith cuts: "  << selection << endl;
+			histos[i]->Add(h_booked);
+			nev = (int)h_booked->GetEntries();
 		} else {
-			if(Samples[i].type!="data") selection      = TString::Format("(%.15f*pileUp.Weight) * (%s)",weight,cuts.Data());
-			else                        selection      = TString::Format("(%.15f) * (%s)"              ,weight,cuts.Data()); 
+			variable = TString::Format("%s>>%s",variable.Data(),histos[i]->GetName());
+			if(fVerbose>2) cout << "+++++ Drawing " << variable  << endl
+					    << "\twith cuts: "  << selection << endl;
+			nev = Samples[i].tree->Draw(variable.Data(),selection.Data(),"goff");
 		}
 
-		variable          = TString::Format("%s>>%s",variable.Data(),histos[i]->GetName());
-		
-			  
-		if(fVerbose>2) cout << "+++++ Drawing " << variable  << endl
-				    << "\twith cuts: "  << selection << endl;
-
-		int nev = Samples[i].tree->Draw(variable.Data(),selection.Data(),"goff");
-
 		// Add underflow & overflow bins
 		// This failed for older ROOT version when the first(last) bin is empty
 		// and there are underflow (overflow) events --- must check whether this 
@@ -1027,7 +1209,7 @@ void MassPlotter::MakePlot(std::vector<sample> Samples, TString var, TString cut
 			   bool flip_order, bool logflag, bool composited, bool ratio, 
 			   bool stacked, bool overlaySUSY, float overlayScale){
 
-  double bins[nbins];
+  double bins[nbins+1];
   bins[0] = min;
   for(int i=1; i<=nbins; i++)
     bins[i] = min+i*(max-min)/nbins;
@@ -1044,18 +1226,6 @@ void MassPlotter::MakePlot(std::vector<sample> Samples, TString var, TString cut
 
         TString varname = Util::removeFunnyChar(var.Data());
 
-	TString nJets = "NJetsIDLoose";
-	nJets += njets < 0 ? ">=" : "==";
-	nJets += TString::Format("%d",abs(njets));
-
-	TString  nLeps;
-	if     (nleps < 0 )  nLeps = " && (NEles + NMuons) >=";
-	else if(nleps >=0  ) nLeps = " && (NEles + NMuons) ==";
-	nLeps += TString::Format("%d",abs(nleps));
-	if     (nleps ==-10) nLeps = " "; 
-	if     (nleps ==-11) nLeps = " && NEles ==1 && NMuons ==0"; 
-	if     (nleps ==-13) nLeps = " && NEles ==0 && NMuons ==1"; 
-
 	THStack* h_stack     = new THStack(varname, "");
   	TH1D*    h_data      = new TH1D   (varname+"data"  , "", nbins, bins );
 	TH1D*    h_mc_sum    = new TH1D   (varname+"mc_sum", "", nbins, bins );
@@ -1101,6 +1271,21 @@ void MassPlotter::MakePlot(std::vector<sample> Samples, TString var, TString cut
 	TLegend* Legend1 = new TLegend(.71,.54,.91,.92);
 	//TLegend* Legend1 = new TLegend(.3,.5,.6,.88);
 
+	// samples which are not booked are read with compiled selections, all
+	// compiled at once. TTree::Draw is the fallback, e.g. for array loops
+	vector<MT2Selection>  sels(Samples.size());
+	vector<MT2Selection*> tocompile;
+	for(size_t i = 0; i < Samples.size(); ++i){
+		TString theCuts = GetPlotCuts(Samples[i], cuts, njets, nleps, HLT);
+		if(GetBookedHisto(Samples[i], var, theCuts, GetSampleWeight(Samples[i]), nbins, bins)) continue;
+		sels[i].AddCuts(theCuts);
+		sels[i].AddVariable(var);
+		if(Samples[i].type!="data") sels[i].SetWeight("pileUp.Weight");
+		tocompile.push_back(&sels[i]);
+	}
+	bool compiled = MT2Selection::CompileAll(tocompile);
+	if(!compiled) cout << "MassPlotter::MakePlot ==> Error: cannot compile " << var << " with cuts " << cuts << ", using TTree::Draw" << endl;
+
 	for(size_t i = 0; i < Samples.size(); ++i){
 		h_samples.push_back(new TH1D(varname+"_"+Samples[i].name, "", nbins, bins));
 		h_samples[i] -> Sumw2();
@@ -1122,19 +1307,26 @@ void MassPlotter::MakePlot(std::vector<sample> Samples, TString var, TString cut
 		if(fVerbose>2) cout << "           sample has weight " << weight << " and " << Samples[i].tree->GetEntries() << " entries" << endl; 
 	
 		TString variable  = TString::Format("%s>>%s",var.Data(),h_samples[i]->GetName());
-		TString theCuts = nJets + nLeps + "&&" + cuts;
-		if(Samples[i].type=="data" && HLT!="") theCuts += " &&("+HLT+")"; // triggers for data
-
-		TString selection;
-		if(Samples[i].type!="data") selection      = TString::Format("(%.15f*pileUp.Weight) * (%s)",weight,theCuts.Data());
-		else                        selection      = TString::Format("(%.15f) * (%s)"              ,weight,theCuts.Data()); 
-//		if(Samples[i].type!="data") selection      = TString::Format("(%.15f) * (%s)",              weight,theCuts.Data());
-//		else                        selection      = TString::Format("(%.15f) * (%s)"              ,weight,theCuts.Data()); 
-		  
-		if(fVerbose>2) cout << "+++++ Drawing " << variable  << endl
-				    << "\twith cuts: "  << selection << endl;
-
-		int nev = Samples[i].tree->Draw(variable.Data(),selection.Data(),"goff");
+		TString theCuts   = GetPlotCuts(Samples[i], cuts, njets, nleps, HLT);
+		TString selection = TString::Format("(%s) * (%s)",GetSampleWeight(Samples[i]).Data(),theCuts.Data());
+
+		int nev;
+		TH1D *h_booked = GetBookedHisto(Samples[i], var, theCuts, GetSampleWeight(Samples[i]), nbins, bins);
+		if(h_booked){ // already filled by FillBookedPlots
+			if(fVerbose>2) cout << "+++++ Using booked " << var << endl
+					    << "\twith cuts: "  << selection << endl;
+			h_samples[i]->Add(h_booked);
+			nev = (int)h_booked->GetEntries();
+		} else if(compiled) {
+			if(fVerbose>2) cout << "+++++ Compiled " << var  << endl
+					    << "\twith cuts: "  << selection << endl;
+			sels[i].Book(h_samples[i], 0);
+			nev = sels[i].Loop(Samples[i].tree, weight);
+		} else {
+			if(fVerbose>2) cout << "+++++ Drawing " << variable  << endl
+					    << "\twith cuts: "  << selection << endl;
+			nev = Samples[i].tree->Draw(variable.Data(),selection.Data(),"goff");
+		}
 
 		// Add underflow & overflow bins
 		// This failed for older ROOT version when the first(last) bin is empty
@@ -1435,10 +1627,9 @@ void MassPlotter::ABCD_MT2(TString var, TString basecut, TString upper_cut, TStr
 //     int nev = fSamples[i].tree->Draw(">>elist",basecut.Data(),"entrylist");
 //     fSamples[i].tree->SetEntryList(elist);
     
-    TString  weights   = (fSamples[i].type!="data" ?  TString::Format("(%.15f*pileUp.Weight)",weight) : TString::Format("(%.15f)",weight));
-    TString selection = TString::Format("(%s) * (%s)"      ,weights.Data(),basecut.Data());
-    TString sel_up    = TString::Format("(%s) * (%s && %s)",weights.Data(),basecut.Data(),upper_cut.Data());
-    TString sel_lo    = TString::Format("(%s) * (%s && %s)",weights.Data(),basecut.Data(),lower_cut.Data());
+    TString weights   = (fSamples[i].type!="data" ?  TString::Format("%.15f*pileUp.Weight",weight) : TString::Format("%.15f",weight));
+    TString cut_up    = TString::Format("%s && %s",basecut.Data(),upper_cut.Data());
+    TString cut_lo    = TString::Format("%s && %s",basecut.Data(),lower_cut.Data());
 
     // Remove jets intentionaly!!!
     // RemoveAndRecalcMT2() has to be called before any selection to make the internal changes effective!
@@ -1446,98 +1637,66 @@ void MassPlotter::ABCD_MT2(TString var, TString basecut, TString upper_cut, TStr
     //TString removeJet = "SmearAndRecalcMT2()>-5.";
     //TString removeJet = "RemoveAndRecalcMT2(0,0.000001)>-5.";
     //TString removeJet = "RemoveAndRecalcMT2(1,0.005)>-5.";
-    TString selection_QCD = TString::Format("(%s) * (%s && %s)"      ,weights.Data(),removeJet.Data(),basecut.Data());
-    TString sel_up_QCD    = TString::Format("(%s) * (%s && %s && %s)",weights.Data(),removeJet.Data(),basecut.Data(),upper_cut.Data());
-    TString sel_lo_QCD    = TString::Format("(%s) * (%s && %s && %s)",weights.Data(),removeJet.Data(),basecut.Data(),lower_cut.Data());
+    TString cut_QCD    = TString::Format("%s && %s"      ,removeJet.Data(),basecut.Data());
+    TString cut_up_QCD = TString::Format("%s && %s && %s",removeJet.Data(),basecut.Data(),upper_cut.Data());
+    TString cut_lo_QCD = TString::Format("%s && %s && %s",removeJet.Data(),basecut.Data(),lower_cut.Data());
 
-    TString variable;
+    // histograms and cuts of this sample, all filled in one pass over the tree
     TString var2 = "misc.MT2";
+    TH2D   *h_2d = 0;
+    TH1D   *h_lo = 0, *h_up = 0;
+    TString cut_2d;
     if (fSamples[i].type == "data"){
-      variable  = TString::Format("%s>>+%s",var2.Data(),h_ABCD_lower_y_band_data->GetName());
-      int nevL = fSamples[i].tree->Draw(variable,sel_lo,"goff");
-      variable  = TString::Format("%s>>+%s",var2.Data(),h_ABCD_upper_y_band_data->GetName());
-      int nevU = fSamples[i].tree->Draw(variable,sel_up,"goff");
-      if(fVerbose>2) cout << "\tData lower, events found : "  <<  nevL << endl
-			  << "\t->Integral() : "  <<  h_ABCD_lower_y_band_data->Integral() + h_ABCD_lower_y_band_data->GetBinContent(nbins+1) << endl;
-      if(fVerbose>2) cout << "\tData upper, events found : "  <<  nevU << endl
-			  << "\t->Integral() : "  <<  h_ABCD_upper_y_band_data->Integral() + h_ABCD_upper_y_band_data->GetBinContent(nbins+1) << endl;
+      h_lo = h_ABCD_lower_y_band_data;
+      h_up = h_ABCD_upper_y_band_data;
     }
     else if (fSamples[i].type == "mc" && fSamples[i].name == "QCD_Pt_120to170"){   // WARNING: checking statistical fluctuation in this pt bin!!!
-      variable  = TString::Format("%s:misc.MT2>>+%s",var.Data(),h_ABCD_MT2_qcd->GetName());
-      TString sel_u    = /*sel_up_QCD; /*/TString::Format("(%s) * (%s && misc.MT2<80&& %s)",weights.Data(),basecut.Data(),upper_cut.Data());
-      TString sel_l    = /*sel_lo_QCD; /*/TString::Format("(%s) * (%s && misc.MT2<80&& %s)",weights.Data(),basecut.Data(),lower_cut.Data());
-      int nev2d= fSamples[i].tree->Draw(variable,selection_QCD,"goff");
-      variable  = TString::Format("%s>>+%s",var2.Data(),h_ABCD_lower_y_band_qcd->GetName());
-      int nevL = fSamples[i].tree->Draw(variable,sel_l,"goff");
-      variable  = TString::Format("%s>>+%s",var2.Data(),h_ABCD_upper_y_band_qcd->GetName());
-      int nevU = fSamples[i].tree->Draw(variable,sel_u,"goff");
-      if(fVerbose>2) cout << "\t" << fSamples[i].name << " lower, events found : "  <<  nevL << endl
-			  << "\t->Integral() : "  <<  h_ABCD_lower_y_band_qcd->Integral() + h_ABCD_lower_y_band_qcd->GetBinContent(nbins+1) << endl;
-      if(fVerbose>2) cout << "\t" << fSamples[i].name << " upper, events found : "  <<  nevU << endl
-			  << "\t->Integral() : "  <<  h_ABCD_upper_y_band_qcd->Integral() + h_ABCD_upper_y_band_qcd->GetBinContent(nbins+1) << endl;
+      h_2d = h_ABCD_MT2_qcd;  cut_2d = cut_QCD;
+      h_lo = h_ABCD_lower_y_band_qcd;
+      h_up = h_ABCD_upper_y_band_qcd;
+      cut_up = TString::Format("%s && misc.MT2<80&& %s",basecut.Data(),upper_cut.Data());
+      cut_lo = TString::Format("%s && misc.MT2<80&& %s",basecut.Data(),lower_cut.Data());
     }
     else if (fSamples[i].type == "mc" && fSamples[i].name == "QCD_Pt_170to300"){   // WARNING: checking statistical fluctuation in this pt bin!!!
-      variable  = TString::Format("%s:misc.MT2>>+%s",var.Data(),h_ABCD_MT2_qcd->GetName());
-      TString sel_u    = /*sel_up_QCD; /*/TString::Format("(%s) * (%s && misc.MT2<140&& %s)",weights.Data(),basecut.Data(),upper_cut.Data());
-      TString sel_l    = /*sel_lo_QCD; /*/TString::Format("(%s) * (%s && misc.MT2<170&& %s)",weights.Data(),basecut.Data(),lower_cut.Data());
-      int nev2d= fSamples[i].tree->Draw(variable,selection_QCD,"goff");
-      variable  = TString::Format("%s>>+%s",var2.Data(),h_ABCD_lower_y_band_qcd->GetName());
-      int nevL = fSamples[i].tree->Draw(variable,sel_l,"goff");
-      variable  = TString::Format("%s>>+%s",var2.Data(),h_ABCD_upper_y_band_qcd->GetName());
-      int nevU = fSamples[i].tree->Draw(variable,sel_u,"goff");
-      if(fVerbose>2) cout << "\t" << fSamples[i].name << " lower, events found : "  <<  nevL << endl
-			  << "\t->Integral() : "  <<  h_ABCD_lower_y_band_qcd->Integral() + h_ABCD_lower_y_band_qcd->GetBinContent(nbins+1) << endl;
-      if(fVerbose>2) cout << "\t" << fSamples[i].name << " upper, events found : "  <<  nevU << endl
-			  << "\t->Integral() : "  <<  h_ABCD_upper_y_band_qcd->Integral() + h_ABCD_upper_y_band_qcd->GetBinContent(nbins+1) << endl;
+      h_2d = h_ABCD_MT2_qcd;  cut_2d = cut_QCD;
+      h_lo = h_ABCD_lower_y_band_qcd;
+      h_up = h_ABCD_upper_y_band_qcd;
+      cut_up = TString::Format("%s && misc.MT2<140&& %s",basecut.Data(),upper_cut.Data());
+      cut_lo = TString::Format("%s && misc.MT2<170&& %s",basecut.Data(),lower_cut.Data());
     }
     else if (fSamples[i].type == "mc" && fSamples[i].name == "QCD_Pt_300to470"){   // WARNING: checking statistical fluctuation in this pt bin!!!
-      variable  = TString::Format("%s:misc.MT2>>+%s",var.Data(),h_ABCD_MT2_qcd->GetName());
-      TString sel_u    = /*sel_up_QCD; /*/TString::Format("(%s) * (%s && misc.MT2<200&& %s)",weights.Data(),basecut.Data(),upper_cut.Data());
-      TString sel_l    = /*sel_lo_QCD; /*/TString::Format("(%s) * (%s && %s)",weights.Data(),basecut.Data(),lower_cut.Data());
-      int nev2d= fSamples[i].tree->Draw(variable,selection_QCD,"goff");
-      variable  = TString::Format("%s>>+%s",var2.Data(),h_ABCD_lower_y_band_qcd->GetName());
-      int nevL = fSamples[i].tree->Draw(variable,sel_l,"goff");
-      variable  = TString::Format("%s>>+%s",var2.Data(),h_ABCD_upper_y_band_qcd->GetName());
-      int nevU = fSamples[i].tree->Draw(variable,sel_u,"goff");
-      if(fVerbose>2) cout << "\t" << fSamples[i].name << " lower, events found : "  <<  nevL << endl
-			  << "\t->Integral() : "  <<  h_ABCD_lower_y_band_qcd->Integral() + h_ABCD_lower_y_band_qcd->GetBinContent(nbins+1) << endl;
-      if(fVerbose>2) cout << "\t" << fSamples[i].name << " upper, events found : "  <<  nevU << endl
-			  << "\t->Integral() : "  <<  h_ABCD_upper_y_band_qcd->Integral() + h_ABCD_upper_y_band_qcd->GetBinContent(nbins+1) << endl;
+      h_2d = h_ABCD_MT2_qcd;  cut_2d = cut_QCD;
+      h_lo = h_ABCD_lower_y_band_qcd;
+      h_up = h_ABCD_upper_y_band_qcd;
+      cut_up = TString::Format("%s && misc.MT2<200&& %s",basecut.Data(),upper_cut.Data());
     }
     else if (fSamples[i].type == "mc" && fSamples[i].sname == "QCD"){
-      variable  = TString::Format("%s:misc.MT2>>+%s",var.Data(),h_ABCD_MT2_qcd->GetName());
-      int nev2d= fSamples[i].tree->Draw(variable,selection_QCD,"goff");
-      variable  = TString::Format("%s>>+%s",var2.Data(),h_ABCD_lower_y_band_qcd->GetName());
-      int nevL = fSamples[i].tree->Draw(variable,sel_lo_QCD,"goff");
-      variable  = TString::Format("%s>>+%s",var2.Data(),h_ABCD_upper_y_band_qcd->GetName());
-      int nevU = fSamples[i].tree->Draw(variable,sel_up_QCD,"goff");
-      if(fVerbose>2) cout << "\t" << fSamples[i].name << " lower, events found : "  <<  nevL << endl
-			  << "\t->Integral() : "  <<  h_ABCD_lower_y_band_qcd->Integral() + h_ABCD_lower_y_band_qcd->GetBinContent(nbins+1) << endl;
-      if(fVerbose>2) cout << "\t" << fSamples[i].name << " upper, events found : "  <<  nevU << endl
-			  << "\t->Integral() : "  <<  h_ABCD_upper_y_band_qcd->Integral() + h_ABCD_upper_y_band_qcd->GetBinContent(nbins+1) << endl;
+      h_2d = h_ABCD_MT2_qcd;  cut_2d = cut_QCD;
+      h_lo = h_ABCD_lower_y_band_qcd;
+      h_up = h_ABCD_upper_y_band_qcd;
+      cut_up = cut_up_QCD;
+      cut_lo = cut_lo_QCD;
     }
     else if (fSamples[i].type == "mc"){
-      variable  = TString::Format("%s>>+%s",var2.Data(),h_ABCD_lower_y_band_mc->GetName());
-      int nevL = fSamples[i].tree->Draw(variable,sel_lo,"goff");
-      variable  = TString::Format("%s>>+%s",var2.Data(),h_ABCD_upper_y_band_mc->GetName());
-      int nevU = fSamples[i].tree->Draw(variable,sel_up,"goff");
-      if(fVerbose>2) cout << "\t" << fSamples[i].name << " lower, events found : "  <<  nevL << endl
-			  << "\t->Integral() : "  <<  h_ABCD_lower_y_band_mc->Integral() + h_ABCD_lower_y_band_mc->GetBinContent(nbins+1) << endl;
-      if(fVerbose>2) cout << "\t" << fSamples[i].name << " upper, events found : "  <<  nevU << endl
-			  << "\t->Integral() : "  <<  h_ABCD_upper_y_band_mc->Integral() + h_ABCD_upper_y_band_mc->GetBinContent(nbins+1) << endl;
+      h_lo = h_ABCD_lower_y_band_mc;
+      h_up = h_ABCD_upper_y_band_mc;
     }
     else if (fSamples[i].type == "susy"){
-      variable  = TString::Format("%s:misc.MT2>>+%s",var.Data(),h_ABCD_MT2_susy->GetName());
-      int nev2d= fSamples[i].tree->Draw(variable,selection,"goff");
-      variable  = TString::Format("%s>>+%s",var2.Data(),h_ABCD_lower_y_band_susy->GetName());
-      int nevL = fSamples[i].tree->Draw(variable,sel_lo,"goff");
-      variable  = TString::Format("%s>>+%s",var2.Data(),h_ABCD_upper_y_band_susy->GetName());
-      int nevU = fSamples[i].tree->Draw(variable,sel_up,"goff");
-      if(fVerbose>2) cout << "\t" << fSamples[i].name << " lower, events found : "  <<  nevL << endl
-			  << "\t->Integral() : "  <<  h_ABCD_lower_y_band_susy->Integral() + h_ABCD_lower_y_band_susy->GetBinContent(nbins+1) << endl;
-      if(fVerbose>2) cout << "\t" << fSamples[i].name << " upper, events found : "  <<  nevU << endl
-			  << "\t->Integral() : "  <<  h_ABCD_upper_y_band_susy->Integral() + h_ABCD_upper_y_band_susy->GetBinContent(nbins+1) << endl;
+      h_2d = h_ABCD_MT2_susy; cut_2d = basecut;
+      h_lo = h_ABCD_lower_y_band_susy;
+      h_up = h_ABCD_upper_y_band_susy;
     }
+    if(h_lo == 0) continue;
+
+    PlotBook book;
+    if(h_2d) book.Book(h_2d, var2, var, cut_2d, weights); // var:misc.MT2
+    int iL = book.Book(h_lo, var2, cut_lo, weights);
+    int iU = book.Book(h_up, var2, cut_up, weights);
+    book.Fill(fSamples[i].tree);
+    if(fVerbose>2) cout << "\t" << fSamples[i].name << " lower, events found : "  <<  book.GetNSelected(iL) << endl
+			<< "\t->Integral() : "  <<  h_lo->Integral() + h_lo->GetBinContent(nbins+1) << endl;
+    if(fVerbose>2) cout << "\t" << fSamples[i].name << " upper, events found : "  <<  book.GetNSelected(iU) << endl
+			<< "\t->Integral() : "  <<  h_up->Integral() + h_up->GetBinContent(nbins+1) << endl;
   }
   
   
@@ -1676,64 +1835,55 @@ void MassPlotter::PrintABCDPredictions(TString var, TString basecut, TString upp
     if(fVerbose>2) cout << "      sample has weight " << weight << endl; 
 
     TString weights   = fSamples[i].type!="data" ?  TString::Format("(%.15f*pileUp.Weight)",weight) : TString::Format("(%.15f)",weight);
-    TString selection = TString::Format("(%s) * (%s)"      ,weights.Data(),basecut.Data());
-    TString sel_up    = TString::Format("(%s) * (%s && %s)",weights.Data(),basecut.Data(),upper_cut.Data());
-    TString sel_lo    = TString::Format("(%s) * (%s && %s)",weights.Data(),basecut.Data(),lower_cut.Data());
+    TString cut_up    = TString::Format("%s && %s",basecut.Data(),upper_cut.Data());
+    TString cut_lo    = TString::Format("%s && %s",basecut.Data(),lower_cut.Data());
     if(fVerbose>2) cout << "      sel_lo = " << weights << endl; 
 //     TString selection = TString::Format("(%f) * (%s)"      ,weight,basecut.Data());
 //     TString sel_up    = TString::Format("(%f) * (%s && %s)",weight,basecut.Data(),upper_cut.Data());
 //     TString sel_lo    = TString::Format("(%f) * (%s && %s)",weight,basecut.Data(),lower_cut.Data());
 
-    TString variable;
+    // both bands of this sample are filled in one pass over the tree
     TString var2 = "misc.MT2";
+    TH1D   *h_lo = 0, *h_up = 0;
     if (fSamples[i].type == "data"){
-      variable  = TString::Format("%s>>+%s",var2.Data(),h_pred_lower_y_band_data->GetName());
-      int nevL = fSamples[i].tree->Draw(variable,sel_lo,"goff");
-      variable  = TString::Format("%s>>+%s",var2.Data(),h_pred_upper_y_band_data->GetName());
-      int nevU = fSamples[i].tree->Draw(variable,sel_up,"goff");
+      h_lo = h_pred_lower_y_band_data;
+      h_up = h_pred_upper_y_band_data;
     }
     else if (fSamples[i].type == "mc" && fSamples[i].name == "QCD_Pt_120to170"){   // WARNING: checking statistical fluctuation in this pt bin!!!
-      TString sel_u    = TString::Format("(%s) * (%s && misc.MT2<80&& %s)",weights.Data(),basecut.Data(),upper_cut.Data());
-      TString sel_l    = TString::Format("(%s) * (%s && misc.MT2<80&& %s)",weights.Data(),basecut.Data(),lower_cut.Data());
-      variable  = TString::Format("%s>>+%s",var2.Data(),h_pred_lower_y_band_qcd->GetName());
-      int nevL = fSamples[i].tree->Draw(variable,sel_l,"goff");
-      variable  = TString::Format("%s>>+%s",var2.Data(),h_pred_upper_y_band_qcd->GetName());
-      int nevU = fSamples[i].tree->Draw(variable,sel_u,"goff");
+      h_lo = h_pred_lower_y_band_qcd;
+      h_up = h_pred_upper_y_band_qcd;
+      cut_up = TString::Format("%s && misc.MT2<80&& %s",basecut.Data(),upper_cut.Data());
+      cut_lo = TString::Format("%s && misc.MT2<80&& %s",basecut.Data(),lower_cut.Data());
     }
     else if (fSamples[i].type == "mc" && fSamples[i].name == "QCD_Pt_170to300"){   // WARNING: checking statistical fluctuation in this pt bin!!!
-      TString sel_u    = TString::Format("(%s) * (%s && misc.MT2<140&& %s)",weights.Data(),basecut.Data(),upper_cut.Data());
-      TString sel_l    = TString::Format("(%s) * (%s && misc.MT2<170&& %s)",weights.Data(),basecut.Data(),lower_cut.Data());
-      variable  = TString::Format("%s>>+%s",var2.Data(),h_pred_lower_y_band_qcd->GetName());
-      int nevL = fSamples[i].tree->Draw(variable,sel_l,"goff");
-      variable  = TString::Format("%s>>+%s",var2.Data(),h_pred_upper_y_band_qcd->GetName());
-      int nevU = fSamples[i].tree->Draw(variable,sel_u,"goff");
+      h_lo = h_pred_lower_y_band_qcd;
+      h_up = h_pred_upper_y_band_qcd;
+      cut_up = TString::Format("%s && misc.MT2<140&& %s",basecut.Data(),upper_cut.Data());
+      cut_lo = TString::Format("%s && misc.MT2<170&& %s",basecut.Data(),lower_cut.Data());
     }
     else if (fSamples[i].type == "mc" && fSamples[i].name == "QCD_Pt_300to470"){   // WARNING: checking statistical fluctuation in this pt bin!!!
-      TString sel_u    = TString::Format("(%s) * (%s && misc.MT2<200&& %s)",weights.Data(),basecut.Data(),upper_cut.Data());
-      TString sel_l    = TString::Format("(%s) * (%s && %s)",weights.Data(),basecut.Data(),lower_cut.Data());
-      variable  = TString::Format("%s>>+%s",var2.Data(),h_pred_lower_y_band_qcd->GetName());
-      int nevL = fSamples[i].tree->Draw(variable,sel_l,"goff");
-      variable  = TString::Format("%s>>+%s",var2.Data(),h_pred_upper_y_band_qcd->GetName());
-      int nevU = fSamples[i].tree->Draw(variable,sel_u,"goff");
+      h_lo = h_pred_lower_y_band_qcd;
+      h_up = h_pred_upper_y_band_qcd;
+      cut_up = TString::Format("%s && misc.MT2<200&& %s",basecut.Data(),upper_cut.Data());
     }
     else if (fSamples[i].type == "mc" && fSamples[i].sname == "QCD"){
-      variable  = TString::Format("%s>>+%s",var2.Data(),h_pred_lower_y_band_qcd->GetName());
-      int nevL = fSamples[i].tree->Draw(variable,sel_lo,"goff");
-      variable  = TString::Format("%s>>+%s",var2.Data(),h_pred_upper_y_band_qcd->GetName());
-      int nevU = fSamples[i].tree->Draw(variable,sel_up,"goff");
+      h_lo = h_pred_lower_y_band_qcd;
+      h_up = h_pred_upper_y_band_qcd;
     }
     else if (fSamples[i].type == "mc"){
-      variable  = TString::Format("%s>>+%s",var2.Data(),h_pred_lower_y_band_mc->GetName());
-      int nevL = fSamples[i].tree->Draw(variable,sel_lo,"goff");
-      variable  = TString::Format("%s>>+%s",var2.Data(),h_pred_upper_y_band_mc->GetName());
-      int nevU = fSamples[i].tree->Draw(variable,sel_up,"goff");
+      h_lo = h_pred_lower_y_band_mc;
+      h_up = h_pred_upper_y_band_mc;
     }
     else if (fSamples[i].type == "susy"){
-      variable  = TString::Format("%s>>+%s",var2.Data(),h_pred_lower_y_band_susy->GetName());
-      int nevL = fSamples[i].tree->Draw(variable,sel_lo,"goff");
-      variable  = TString::Format("%s>>+%s",var2.Data(),h_pred_upper_y_band_susy->GetName());
-      int nevU = fSamples[i].tree->Draw(variable,sel_up,"goff");
+      h_lo = h_pred_lower_y_band_susy;
+      h_up = h_pred_upper_y_band_susy;
     }
+    if(h_lo == 0) continue;
+
+    PlotBook book;
+    book.Book(h_lo, var2, cut_lo, weights);
+    book.Book(h_up, var2, cut_up, weights);
+    book.Fill(fSamples[i].tree);
   }
   
   
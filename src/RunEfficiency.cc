@@ -211,6 +211,7 @@ bool momentumComparator(t_lepton i, t_lepton j) { return (i.p.Pt()>j.p.Pt()); }
 //-------------------------------------------------------------------------------------
 RunEfficiency::RunEfficiency(TreeReader *tr, std::string dataType, bool fullCleaning) : 
   UserAnalysisBase(tr), fDataType_(dataType), fFullCleaning_(fullCleaning) {
+  AddTriggerMenus();
   //	Util::SetStyle();	
   //	setTDRStyle();	
 }
@@ -445,245 +446,264 @@ vector<t_lepton> RunEfficiency::selectLeptons(vector<t_lepton>& leptons) {
 }
 
 
+//________________________________________________________________________________
+void RunEfficiency::AddTriggerMenus() {
+  // Trigger paths of the dilepton selections for JZB (0) and same sign (1) and
+  // of MT2, resolved to trigger bits at each new HLT menu
+  const char* mt2Paths[] = {
+    "HLT_HT150_v3",
+    "HLT_HT160_v2",
+    "HLT_HT200_v2",
+    "HLT_HT200_v3",
+    "HLT_HT240_v2",
+    "HLT_HT250_v2",
+    "HLT_HT250_v3",
+    "HLT_HT260_v2",
+    "HLT_HT300_v2",
+    "HLT_HT300_v3",
+    "HLT_HT300_v4",
+    "HLT_HT300_v5",
+    "HLT_HT350_v2",
+    "HLT_HT350_v3",
+    "HLT_HT350_v4",
+    "HLT_HT360_v2",
+    "HLT_HT400_v2",
+    "HLT_HT400_v3",
+    "HLT_HT400_v4",
+    "HLT_HT440_v2",
+    "HLT_HT450_v2",
+    "HLT_HT450_v3",
+    "HLT_HT450_v4",
+    "HLT_HT500_v2",
+    "HLT_HT500_v3",
+    "HLT_HT500_v4",
+    "HLT_HT550_v2",
+    "HLT_HT550_v3",
+    "HLT_HT550_v4",
+    "HLT_HT550_v5",
+    // MHT_HT
+    "HLT_HT250_MHT60_v2",
+    "HLT_HT250_MHT60_v3",
+    "HLT_HT250_MHT60_v4",
+    "HLT_HT250_MHT70_v1",
+    "HLT_HT260_MHT60_v2",
+    "HLT_HT300_MHT75_v4",
+    "HLT_HT300_MHT75_v5",
+    // QuadJet
+    "HLT_QuadJet50_BTagIP_v1",
+    "HLT_QuadJet50_Jet40_v1",
+    // Muons
+    "HLT_DoubleMu3_HT160_v2",
+    "HLT_DoubleMu3_v3",
+    "HLT_Mu8_Jet40_v2"
+  };
+  const char* elPathsJZB[] = {
+    "HLT_Ele17_CaloIdL_CaloIsoVL_Ele8_CaloIdL_CaloIsoVL_v1",
+    "HLT_Ele17_CaloIdL_CaloIsoVL_Ele8_CaloIdL_CaloIsoVL_v2",
+    "HLT_Ele17_CaloIdL_CaloIsoVL_Ele8_CaloIdL_CaloIsoVL_v3",
+    "HLT_Ele17_CaloIdL_CaloIsoVL_Ele8_CaloIdL_CaloIsoVL_v4",
+    "HLT_Ele17_CaloIdL_CaloIsoVL_Ele8_CaloIdL_CaloIsoVL_v5",
+    "HLT_Ele17_CaloIdL_CaloIsoVL_Ele8_CaloIdL_CaloIsoVL_v6",
+    "HLT_Ele17_CaloIdL_CaloIsoVL_Ele8_CaloIdL_CaloIsoVL_v7",
+    "HLT_Ele17_CaloIdL_CaloIsoVL_Ele8_CaloIdL_CaloIsoVL_v8",
+    "HLT_Ele17_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_Ele8_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_v1",
+    "HLT_Ele17_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_Ele8_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_v2",
+    "HLT_Ele17_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_Ele8_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_v3",
+    "HLT_Ele17_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_Ele8_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_v4",
+    "HLT_Ele17_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_Ele8_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_v5",
+    "HLT_Ele17_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_Ele8_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_v6",
+    "HLT_Ele17_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_Ele8_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_v7",
+    "HLT_Ele17_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_Ele8_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_v8",
+    "HLT_Ele17_CaloIdT_TrkIdVL_CaloIsoVL_TrkIsoVL_Ele8_CaloIdT_TrkIdVL_CaloIsoVL_TrkIsoVL_v1",
+    "HLT_Ele17_CaloIdT_TrkIdVL_CaloIsoVL_TrkIsoVL_Ele8_CaloIdT_TrkIdVL_CaloIsoVL_TrkIsoVL_v2",
+    "HLT_Ele17_CaloIdT_TrkIdVL_CaloIsoVL_TrkIsoVL_Ele8_CaloIdT_TrkIdVL_CaloIsoVL_TrkIsoVL_v3",
+    "HLT_Ele17_CaloIdT_TrkIdVL_CaloIsoVL_TrkIsoVL_Ele8_CaloIdT_TrkIdVL_CaloIsoVL_TrkIsoVL_v4",
+    "HLT_Ele17_CaloIdT_TrkIdVL_CaloIsoVL_TrkIsoVL_Ele8_CaloIdT_TrkIdVL_CaloIsoVL_TrkIsoVL_v5"
+  };
+  const char* elPathsSS[] = {
+    "HLT_ELE8_JET40",
+    "HLT_Ele8_CaloIdL_CaloIsoVL_Jet40_v1",
+    "HLT_Ele8_CaloIdL_CaloIsoVL_Jet40_v2",
+    "HLT_Ele8_CaloIdL_CaloIsoVL_Jet40_v3",
+    "HLT_Ele8_CaloIdL_CaloIsoVL_Jet40_v4",
+    "HLT_Ele8_CaloIdL_CaloIsoVL_Jet40_v5",
+    "HLT_ELE17_ELE8",
+    "HLT_Ele17_CaloIdL_CaloIsoVL_Ele8_CaloIdL_CaloIsoVL_v1",
+    "HLT_Ele17_CaloIdL_CaloIsoVL_Ele8_CaloIdL_CaloIsoVL_v2",
+    "HLT_Ele17_CaloIdL_CaloIsoVL_Ele8_CaloIdL_CaloIsoVL_v3",
+    "HLT_Ele17_CaloIdL_CaloIsoVL_Ele8_CaloIdL_CaloIsoVL_v4",
+    "HLT_Ele17_CaloIdL_CaloIsoVL_Ele8_CaloIdL_CaloIsoVL_v5",
+    "HLT_ELE17_ELE8_TIGHT",
+    "HLT_Ele17_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_Ele8_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_v1",
+    "HLT_Ele17_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_Ele8_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_v2",
+    "HLT_Ele17_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_Ele8_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_v3",
+    "HLT_Ele17_CaloIdT_TrkIdVL_CaloIsoVL_TrkIsoVL_Ele8_CaloIdT_TrkIdVL_CaloIsoVL_TrkIsoVL_v1",
+    "HLT_Ele17_CaloIdT_TrkIdVL_CaloIsoVL_TrkIsoVL_Ele8_CaloIdT_TrkIdVL_CaloIsoVL_TrkIsoVL_v2",
+    "HLT_Ele17_CaloIdT_TrkIdVL_CaloIsoVL_TrkIsoVL_Ele8_CaloIdT_TrkIdVL_CaloIsoVL_TrkIsoVL_v3",
+    "HLT_Ele17_CaloIdT_TrkIdVL_CaloIsoVL_TrkIsoVL_Ele8_CaloIdT_TrkIdVL_CaloIsoVL_TrkIsoVL_v4",
+    "HLT_Ele17_CaloIdT_TrkIdVL_CaloIsoVL_TrkIsoVL_Ele8_CaloIdT_TrkIdVL_CaloIsoVL_TrkIsoVL_v5",
+    "HLT_DOUBLEELE8_HT160",
+    "HLT_DoubleEle8_CaloIdL_TrkIdVL_HT160_v1",
+    "HLT_DoubleEle8_CaloIdL_TrkIdVL_HT160_v2",
+    "HLT_DoubleEle8_CaloIdL_TrkIdVL_HT160_v3",
+    "HLT_DoubleEle8_CaloIdL_TrkIdVL_HT150_v1",
+    "HLT_DoubleEle8_CaloIdL_TrkIdVL_HT150_v2",
+    "HLT_DoubleEle8_CaloIdL_TrkIdVL_HT150_v3",
+    "HLT_DOUBLEELE8_HT160_TIGHT",
+    "HLT_DoubleEle8_CaloIdT_TrkIdVL_HT160_v1",
+    "HLT_DoubleEle8_CaloIdT_TrkIdVL_HT160_v2",
+    "HLT_DoubleEle8_CaloIdT_TrkIdVL_HT160_v3",
+    "HLT_DoubleEle8_CaloIdT_TrkIdVL_HT150_v1",
+    "HLT_DoubleEle8_CaloIdT_TrkIdVL_HT150_v2",
+    "HLT_DoubleEle8_CaloIdT_TrkIdVL_HT150_v3"
+  };
+  const char* muPathsJZB[] = {
+    "HLT_DoubleMu6_v1",
+    "HLT_DoubleMu6_v2",
+    "HLT_DoubleMu6_v3",
+    "HLT_DoubleMu6_v4",
+    "HLT_DoubleMu6_v5",
+    "HLT_DoubleMu6_v6",
+    "HLT_DoubleMu6_v7",
+    "HLT_DoubleMu6_v8",
+    "HLT_DoubleMu7_v1",
+    "HLT_DoubleMu7_v2",
+    "HLT_DoubleMu7_v3",
+    "HLT_DoubleMu7_v4",
+    "HLT_DoubleMu7_v5",
+    "HLT_DoubleMu7_v6",
+    "HLT_DoubleMu7_v7",
+    "HLT_DoubleMu7_v8",
+    "HLT_DoubleMu8_v1",
+    "HLT_DoubleMu8_v2",
+    "HLT_Mu13_Mu8_v1",
+    "HLT_Mu13_Mu8_v2",
+    "HLT_Mu13_Mu8_v3",
+    "HLT_Mu13_Mu8_v4",
+    "HLT_Mu13_Mu8_v5",
+    "HLT_Mu13_Mu8_v6",
+    "HLT_Mu13_Mu8_v7",
+    "HLT_Mu13_Mu8_v8"
+  };
+  const char* muPathsSS[] = {
+    "HLT_MU8_JET40",
+    "HLT_Mu8_Jet40_v1",
+    "HLT_Mu8_Jet40_v2",
+    "HLT_Mu8_Jet40_v3",
+    "HLT_Mu8_Jet40_v4",
+    "HLT_Mu8_Jet40_v5",
+    "HLT_Mu8_Jet40_v6",
+    "HLT_DOUBLEMU7",
+    "HLT_DoubleMu6_v1",
+    "HLT_DoubleMu6_v2",
+    "HLT_DoubleMu6_v3",
+    "HLT_DoubleMu7_v1",
+    "HLT_DoubleMu7_v2",
+    "HLT_DoubleMu7_v3",
+    "HLT_MU13_MU8",
+    "HLT_Mu13_Mu8_v1",
+    "HLT_Mu13_Mu8_v2",
+    "HLT_MU17_ELE8",
+    "HLT_Mu17_Ele8_CaloIdL_v1",
+    "HLT_Mu17_Ele8_CaloIdL_v2",
+    "HLT_Mu17_Ele8_CaloIdL_v3",
+    "HLT_Mu17_Ele8_CaloIdL_v4",
+    "HLT_Mu17_Ele8_CaloIdL_v5",
+    "HLT_MU8_ELE17",
+    "HLT_Mu8_Ele17_CaloIdL_v1",
+    "HLT_Mu8_Ele17_CaloIdL_v2",
+    "HLT_Mu8_Ele17_CaloIdL_v3",
+    "HLT_Mu8_Ele17_CaloIdL_v4",
+    "HLT_Mu8_Ele17_CaloIdL_v5",
+    "HLT_DOUBLEMU3_HT160",
+    "HLT_DoubleMu3_HT160_v2",
+    "HLT_DoubleMu3_HT160_v3",
+    "HLT_DoubleMu3_HT150_v1",
+    "HLT_DoubleMu3_HT150_v2",
+    "HLT_DoubleMu3_HT150_v3"
+  };
+  const char* emuPathsJZB[] = {
+    "HLT_Mu17_Ele8_CaloIdL_v1",
+    "HLT_Mu17_Ele8_CaloIdL_v2",
+    "HLT_Mu17_Ele8_CaloIdL_v3",
+    "HLT_Mu17_Ele8_CaloIdL_v4",
+    "HLT_Mu17_Ele8_CaloIdL_v5",
+    "HLT_Mu17_Ele8_CaloIdL_v6",
+    "HLT_Mu17_Ele8_CaloIdL_v7",
+    "HLT_Mu17_Ele8_CaloIdL_v8",
+    "HLT_Mu17_Ele8_CaloIdL_v9",
+    "HLT_Mu8_Ele17_CaloIdL_v1",
+    "HLT_Mu8_Ele17_CaloIdL_v2",
+    "HLT_Mu8_Ele17_CaloIdL_v3",
+    "HLT_Mu8_Ele17_CaloIdL_v4",
+    "HLT_Mu8_Ele17_CaloIdL_v5",
+    "HLT_Mu8_Ele17_CaloIdL_v6",
+    "HLT_Mu8_Ele17_CaloIdL_v7",
+    "HLT_Mu8_Ele17_CaloIdL_v8",
+    "HLT_Mu8_Ele17_CaloIdL_v9"
+  };
+  const char* emuPathsSS[] = {
+    "HLT_MU3_ELE8_HT160",
+    "HLT_Mu3_Ele8_CaloIdL_TrkIdVL_HT160_v1",
+    "HLT_Mu3_Ele8_CaloIdL_TrkIdVL_HT160_v2",
+    "HLT_Mu3_Ele8_CaloIdL_TrkIdVL_HT160_v3",
+    "HLT_Mu3_Ele8_CaloIdL_TrkIdVL_HT150_v1",
+    "HLT_Mu3_Ele8_CaloIdL_TrkIdVL_HT150_v2",
+    "HLT_Mu3_Ele8_CaloIdL_TrkIdVL_HT150_v3",
+    "HLT_Ele17_CaloIdL_CaloIsoVL_Ele8_CaloIdL_CaloIsoVL_v1",
+    "HLT_Ele17_CaloIdL_CaloIsoVL_Ele8_CaloIdL_CaloIsoVL_v2",
+    "HLT_MU3_ELE8_HT160_TIGHT",
+    "HLT_Mu3_Ele8_CaloIdT_TrkIdVL_HT160_v1",
+    "HLT_Mu3_Ele8_CaloIdT_TrkIdVL_HT160_v2",
+    "HLT_Mu3_Ele8_CaloIdT_TrkIdVL_HT160_v3",
+    "HLT_Mu3_Ele8_CaloIdT_TrkIdVL_HT150_v1",
+    "HLT_Mu3_Ele8_CaloIdT_TrkIdVL_HT150_v2",
+    "HLT_Mu3_Ele8_CaloIdT_TrkIdVL_HT150_v3"
+  };
+
+  fMT2Triggers    = AddTriggerMenu(vector<string>(mt2Paths,    mt2Paths    + sizeof(mt2Paths)/sizeof(*mt2Paths)));
+  fElTriggers[0]  = AddTriggerMenu(vector<string>(elPathsJZB,  elPathsJZB  + sizeof(elPathsJZB)/sizeof(*elPathsJZB)));
+  fElTriggers[1]  = AddTriggerMenu(vector<string>(elPathsSS,   elPathsSS   + sizeof(elPathsSS)/sizeof(*elPathsSS)));
+  fMuTriggers[0]  = AddTriggerMenu(vector<string>(muPathsJZB,  muPathsJZB  + sizeof(muPathsJZB)/sizeof(*muPathsJZB)));
+  fMuTriggers[1]  = AddTriggerMenu(vector<string>(muPathsSS,   muPathsSS   + sizeof(muPathsSS)/sizeof(*muPathsSS)));
+  fEMuTriggers[0] = AddTriggerMenu(vector<string>(emuPathsJZB, emuPathsJZB + sizeof(emuPathsJZB)/sizeof(*emuPathsJZB)));
+  fEMuTriggers[1] = AddTriggerMenu(vector<string>(emuPathsSS,  emuPathsSS  + sizeof(emuPathsSS)/sizeof(*emuPathsSS)));
+}
+
+
 //-------------------------------------------------------------------------------
 const bool RunEfficiency::passAnyMT2Trigger() {
-
-  if ( GetHLTResult("HLT_HT150_v3") )        return true;
-  if ( GetHLTResult("HLT_HT160_v2") )        return true;
-  if ( GetHLTResult("HLT_HT200_v2") )        return true;
-  if ( GetHLTResult("HLT_HT200_v3") )        return true;
-  if ( GetHLTResult("HLT_HT240_v2") )        return true;
-  if ( GetHLTResult("HLT_HT250_v2") )        return true;
-  if ( GetHLTResult("HLT_HT250_v3") )        return true;
-  if ( GetHLTResult("HLT_HT260_v2") )        return true;
-  if ( GetHLTResult("HLT_HT300_v2") )        return true;
-  if ( GetHLTResult("HLT_HT300_v3") )        return true;
-  if ( GetHLTResult("HLT_HT300_v4") )        return true;
-  if ( GetHLTResult("HLT_HT300_v5") )        return true;
-  if ( GetHLTResult("HLT_HT350_v2") )        return true;
-  if ( GetHLTResult("HLT_HT350_v3") )        return true;
-  if ( GetHLTResult("HLT_HT350_v4") )        return true;
-  if ( GetHLTResult("HLT_HT360_v2") )        return true;
-  if ( GetHLTResult("HLT_HT400_v2") )        return true;
-  if ( GetHLTResult("HLT_HT400_v3") )        return true;
-  if ( GetHLTResult("HLT_HT400_v4") )        return true;
-  if ( GetHLTResult("HLT_HT440_v2") )        return true;
-  if ( GetHLTResult("HLT_HT450_v2") )        return true;
-  if ( GetHLTResult("HLT_HT450_v3") )        return true;
-  if ( GetHLTResult("HLT_HT450_v4") )        return true;
-  if ( GetHLTResult("HLT_HT500_v2") )        return true;
-  if ( GetHLTResult("HLT_HT500_v3") )        return true;
-  if ( GetHLTResult("HLT_HT500_v4") )        return true;
-  if ( GetHLTResult("HLT_HT550_v2") )        return true;
-  if ( GetHLTResult("HLT_HT550_v3") )        return true;
-  if ( GetHLTResult("HLT_HT550_v4") )        return true;
-  if ( GetHLTResult("HLT_HT550_v5") )        return true;
-  // MHT_HT
-  if ( GetHLTResult("HLT_HT250_MHT60_v2") )        return true;
-  if ( GetHLTResult("HLT_HT250_MHT60_v3") )        return true;
-  if ( GetHLTResult("HLT_HT250_MHT60_v4") )        return true;
-  if ( GetHLTResult("HLT_HT250_MHT70_v1") )        return true;
-  if ( GetHLTResult("HLT_HT260_MHT60_v2") )        return true;
-  if ( GetHLTResult("HLT_HT300_MHT75_v4") )        return true;
-  if ( GetHLTResult("HLT_HT300_MHT75_v5") )        return true;
-  // QuadJet
-  if ( GetHLTResult("HLT_QuadJet50_BTagIP_v1") )        return true;
-  if ( GetHLTResult("HLT_QuadJet50_Jet40_v1") )        return true;
-  // Muons
-  if ( GetHLTResult("HLT_DoubleMu3_HT160_v2") )        return true;
-  if ( GetHLTResult("HLT_DoubleMu3_v3") )        return true;
-  if ( GetHLTResult("HLT_Mu8_Jet40_v2") )        return true;
-  return false;
+  return GetTriggerMenuResult(fMT2Triggers);
 }
 
 
 
 //________________________________________________________________________________
 const bool RunEfficiency::passElTriggers(int iAnalysis) {
-  if(iAnalysis==0) {//JZB
-    if ( GetHLTResult("HLT_Ele17_CaloIdL_CaloIsoVL_Ele8_CaloIdL_CaloIsoVL_v1") )        return true;
-    if ( GetHLTResult("HLT_Ele17_CaloIdL_CaloIsoVL_Ele8_CaloIdL_CaloIsoVL_v2") )        return true;
-    if ( GetHLTResult("HLT_Ele17_CaloIdL_CaloIsoVL_Ele8_CaloIdL_CaloIsoVL_v3") )        return true;
-    if ( GetHLTResult("HLT_Ele17_CaloIdL_CaloIsoVL_Ele8_CaloIdL_CaloIsoVL_v4") )        return true;
-    if ( GetHLTResult("HLT_Ele17_CaloIdL_CaloIsoVL_Ele8_CaloIdL_CaloIsoVL_v5") )        return true;
-    if ( GetHLTResult("HLT_Ele17_CaloIdL_CaloIsoVL_Ele8_CaloIdL_CaloIsoVL_v6") )        return true;
-    if ( GetHLTResult("HLT_Ele17_CaloIdL_CaloIsoVL_Ele8_CaloIdL_CaloIsoVL_v7") )        return true;
-    if ( GetHLTResult("HLT_Ele17_CaloIdL_CaloIsoVL_Ele8_CaloIdL_CaloIsoVL_v8") )        return true;
-    if ( GetHLTResult("HLT_Ele17_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_Ele8_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_v1") )        return true;
-    if ( GetHLTResult("HLT_Ele17_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_Ele8_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_v2") )        return true;
-    if ( GetHLTResult("HLT_Ele17_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_Ele8_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_v3") )        return true;
-    if ( GetHLTResult("HLT_Ele17_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_Ele8_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_v4") )        return true;
-    if ( GetHLTResult("HLT_Ele17_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_Ele8_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_v5") )        return true;
-    if ( GetHLTResult("HLT_Ele17_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_Ele8_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_v6") )        return true;
-    if ( GetHLTResult("HLT_Ele17_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_Ele8_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_v7") )        return true;
-    if ( GetHLTResult("HLT_Ele17_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_Ele8_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_v8") )        return true;
-    if ( GetHLTResult("HLT_Ele17_CaloIdT_TrkIdVL_CaloIsoVL_TrkIsoVL_Ele8_CaloIdT_TrkIdVL_CaloIsoVL_TrkIsoVL_v1") )        return true;
-    if ( GetHLTResult("HLT_Ele17_CaloIdT_TrkIdVL_CaloIsoVL_TrkIsoVL_Ele8_CaloIdT_TrkIdVL_CaloIsoVL_TrkIsoVL_v2") )        return true;
-    if ( GetHLTResult("HLT_Ele17_CaloIdT_TrkIdVL_CaloIsoVL_TrkIsoVL_Ele8_CaloIdT_TrkIdVL_CaloIsoVL_TrkIsoVL_v3") )        return true;
-    if ( GetHLTResult("HLT_Ele17_CaloIdT_TrkIdVL_CaloIsoVL_TrkIsoVL_Ele8_CaloIdT_TrkIdVL_CaloIsoVL_TrkIsoVL_v4") )        return true;
-    if ( GetHLTResult("HLT_Ele17_CaloIdT_TrkIdVL_CaloIsoVL_TrkIsoVL_Ele8_CaloIdT_TrkIdVL_CaloIsoVL_TrkIsoVL_v5") )        return true;
-    return false;
-  }
-  if(iAnalysis==1) {//same sign
-    if ( GetHLTResult("HLT_ELE8_JET40") )        				return true;
-    if ( GetHLTResult("HLT_Ele8_CaloIdL_CaloIsoVL_Jet40_v1") )        	return true;
-    if ( GetHLTResult("HLT_Ele8_CaloIdL_CaloIsoVL_Jet40_v2") )        	return true;
-    if ( GetHLTResult("HLT_Ele8_CaloIdL_CaloIsoVL_Jet40_v3") )        	return true;
-    if ( GetHLTResult("HLT_Ele8_CaloIdL_CaloIsoVL_Jet40_v4") )        	return true;
-    if ( GetHLTResult("HLT_Ele8_CaloIdL_CaloIsoVL_Jet40_v5") )        	return true;
-    if ( GetHLTResult("HLT_ELE17_ELE8") )        				return true;
-    if ( GetHLTResult("HLT_Ele17_CaloIdL_CaloIsoVL_Ele8_CaloIdL_CaloIsoVL_v1") )        return true;
-    if ( GetHLTResult("HLT_Ele17_CaloIdL_CaloIsoVL_Ele8_CaloIdL_CaloIsoVL_v2") )        return true;
-    if ( GetHLTResult("HLT_Ele17_CaloIdL_CaloIsoVL_Ele8_CaloIdL_CaloIsoVL_v3") )        return true;
-    if ( GetHLTResult("HLT_Ele17_CaloIdL_CaloIsoVL_Ele8_CaloIdL_CaloIsoVL_v4") )        return true;
-    if ( GetHLTResult("HLT_Ele17_CaloIdL_CaloIsoVL_Ele8_CaloIdL_CaloIsoVL_v5") )        return true;
-    if ( GetHLTResult("HLT_ELE17_ELE8_TIGHT") )        			return true;
-    if ( GetHLTResult("HLT_Ele17_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_Ele8_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_v1") )        return true;
-    if ( GetHLTResult("HLT_Ele17_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_Ele8_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_v2") )        return true;
-    if ( GetHLTResult("HLT_Ele17_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_Ele8_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_v3") )        return true;
-    if ( GetHLTResult("HLT_Ele17_CaloIdT_TrkIdVL_CaloIsoVL_TrkIsoVL_Ele8_CaloIdT_TrkIdVL_CaloIsoVL_TrkIsoVL_v1") )        return true;
-    if ( GetHLTResult("HLT_Ele17_CaloIdT_TrkIdVL_CaloIsoVL_TrkIsoVL_Ele8_CaloIdT_TrkIdVL_CaloIsoVL_TrkIsoVL_v2") )        return true;
-    if ( GetHLTResult("HLT_Ele17_CaloIdT_TrkIdVL_CaloIsoVL_TrkIsoVL_Ele8_CaloIdT_TrkIdVL_CaloIsoVL_TrkIsoVL_v3") )        return true;
-    if ( GetHLTResult("HLT_Ele17_CaloIdT_TrkIdVL_CaloIsoVL_TrkIsoVL_Ele8_CaloIdT_TrkIdVL_CaloIsoVL_TrkIsoVL_v4") )        return true;
-    if ( GetHLTResult("HLT_Ele17_CaloIdT_TrkIdVL_CaloIsoVL_TrkIsoVL_Ele8_CaloIdT_TrkIdVL_CaloIsoVL_TrkIsoVL_v5") )        return true;
-    if ( GetHLTResult("HLT_DOUBLEELE8_HT160") )        			return true;
-    if ( GetHLTResult("HLT_DoubleEle8_CaloIdL_TrkIdVL_HT160_v1") )        	return true;
-    if ( GetHLTResult("HLT_DoubleEle8_CaloIdL_TrkIdVL_HT160_v2") )        	return true;
-    if ( GetHLTResult("HLT_DoubleEle8_CaloIdL_TrkIdVL_HT160_v3") )        	return true;
-    if ( GetHLTResult("HLT_DoubleEle8_CaloIdL_TrkIdVL_HT150_v1") )        	return true;
-    if ( GetHLTResult("HLT_DoubleEle8_CaloIdL_TrkIdVL_HT150_v2") )        	return true;
-    if ( GetHLTResult("HLT_DoubleEle8_CaloIdL_TrkIdVL_HT150_v3") )        	return true;
-    if ( GetHLTResult("HLT_DOUBLEELE8_HT160_TIGHT") )        		return true;
-    if ( GetHLTResult("HLT_DoubleEle8_CaloIdT_TrkIdVL_HT160_v1") )        	return true;
-    if ( GetHLTResult("HLT_DoubleEle8_CaloIdT_TrkIdVL_HT160_v2") )        	return true;
-    if ( GetHLTResult("HLT_DoubleEle8_CaloIdT_TrkIdVL_HT160_v3") )        	return true;
-    if ( GetHLTResult("HLT_DoubleEle8_CaloIdT_TrkIdVL_HT150_v1") )        	return true;
-    if ( GetHLTResult("HLT_DoubleEle8_CaloIdT_TrkIdVL_HT150_v2") )        	return true;
-    if ( GetHLTResult("HLT_DoubleEle8_CaloIdT_TrkIdVL_HT150_v3") )        	return true;
+  if(iAnalysis==0 || iAnalysis==1) {//JZB, same sign
+    return GetTriggerMenuResult(fElTriggers[iAnalysis]);
   }
   if(iAnalysis==2) {//mt2
     return passAnyMT2Trigger();
   }
   return false;
-  
 }
 
 //________________________________________________________________________________
 const bool RunEfficiency::passMuTriggers(int iAnalysis) {
-  if(iAnalysis==0) {//JZB
-    if ( GetHLTResult("HLT_DoubleMu6_v1") )        return true;
-    if ( GetHLTResult("HLT_DoubleMu6_v2") )        return true;
-    if ( GetHLTResult("HLT_DoubleMu6_v3") )        return true;
-    if ( GetHLTResult("HLT_DoubleMu6_v4") )        return true;
-    if ( GetHLTResult("HLT_DoubleMu6_v5") )        return true;
-    if ( GetHLTResult("HLT_DoubleMu6_v6") )        return true;
-    if ( GetHLTResult("HLT_DoubleMu6_v7") )        return true;
-    if ( GetHLTResult("HLT_DoubleMu6_v8") )        return true;
-    
-    if ( GetHLTResult("HLT_DoubleMu7_v1") )        return true;
-    if ( GetHLTResult("HLT_DoubleMu7_v2") )        return true;
-    if ( GetHLTResult("HLT_DoubleMu7_v3") )        return true;
-    if ( GetHLTResult("HLT_DoubleMu7_v4") )        return true;
-    if ( GetHLTResult("HLT_DoubleMu7_v5") )        return true;
-    if ( GetHLTResult("HLT_DoubleMu7_v6") )        return true;
-    if ( GetHLTResult("HLT_DoubleMu7_v7") )        return true;
-    if ( GetHLTResult("HLT_DoubleMu7_v8") )        return true;
-    
-    if ( GetHLTResult("HLT_DoubleMu8_v1") )        return true;
-    if ( GetHLTResult("HLT_DoubleMu8_v2") )        return true;
-
-    if ( GetHLTResult("HLT_Mu13_Mu8_v1") )        return true;
-    if ( GetHLTResult("HLT_Mu13_Mu8_v2") )        return true;
-    if ( GetHLTResult("HLT_Mu13_Mu8_v3") )        return true;
-    if ( GetHLTResult("HLT_Mu13_Mu8_v4") )        return true;
-    if ( GetHLTResult("HLT_Mu13_Mu8_v5") )        return true;
-    if ( GetHLTResult("HLT_Mu13_Mu8_v6") )        return true;
-    if ( GetHLTResult("HLT_Mu13_Mu8_v7") )        return true;
-    if ( GetHLTResult("HLT_Mu13_Mu8_v8") )        return true;
-  }
-  if(iAnalysis==1) {//same sign
-    if ( GetHLTResult("HLT_MU8_JET40") )        return true;
-    if ( GetHLTResult("HLT_Mu8_Jet40_v1") )        return true;
-    if ( GetHLTResult("HLT_Mu8_Jet40_v2") )        return true;
-    if ( GetHLTResult("HLT_Mu8_Jet40_v3") )        return true;
-    if ( GetHLTResult("HLT_Mu8_Jet40_v4") )        return true;
-    if ( GetHLTResult("HLT_Mu8_Jet40_v5") )        return true;
-    if ( GetHLTResult("HLT_Mu8_Jet40_v6") )        return true;
-    if ( GetHLTResult("HLT_DOUBLEMU7") )        return true;
-    if ( GetHLTResult("HLT_DoubleMu6_v1") )        return true;
-    if ( GetHLTResult("HLT_DoubleMu6_v2") )        return true;
-    if ( GetHLTResult("HLT_DoubleMu6_v3") )        return true;
-    if ( GetHLTResult("HLT_DoubleMu7_v1") )        return true;
-    if ( GetHLTResult("HLT_DoubleMu7_v2") )        return true;
-    if ( GetHLTResult("HLT_DoubleMu7_v3") )        return true;
-    if ( GetHLTResult("HLT_MU13_MU8") )        return true;
-    if ( GetHLTResult("HLT_Mu13_Mu8_v1") )        return true;
-    if ( GetHLTResult("HLT_Mu13_Mu8_v2") )        return true;
-    if ( GetHLTResult("HLT_MU17_ELE8") )        return true;
-    if ( GetHLTResult("HLT_Mu17_Ele8_CaloIdL_v1") )        return true;
-    if ( GetHLTResult("HLT_Mu17_Ele8_CaloIdL_v2") )        return true;
-    if ( GetHLTResult("HLT_Mu17_Ele8_CaloIdL_v3") )        return true;
-    if ( GetHLTResult("HLT_Mu17_Ele8_CaloIdL_v4") )        return true;
-    if ( GetHLTResult("HLT_Mu17_Ele8_CaloIdL_v5") )        return true;
-    if ( GetHLTResult("HLT_MU8_ELE17") )        return true;
-    if ( GetHLTResult("HLT_Mu8_Ele17_CaloIdL_v1") )        return true;
-    if ( GetHLTResult("HLT_Mu8_Ele17_CaloIdL_v2") )        return true;
-    if ( GetHLTResult("HLT_Mu8_Ele17_CaloIdL_v3") )        return true;
-    if ( GetHLTResult("HLT_Mu8_Ele17_CaloIdL_v4") )        return true;
-    if ( GetHLTResult("HLT_Mu8_Ele17_CaloIdL_v5") )        return true;
-    if ( GetHLTResult("HLT_DOUBLEMU3_HT160") )        return true;
-    if ( GetHLTResult("HLT_DoubleMu3_HT160_v2") )        return true;
-    if ( GetHLTResult("HLT_DoubleMu3_HT160_v3") )        return true;
-    if ( GetHLTResult("HLT_DoubleMu3_HT150_v1") )        return true;
-    if ( GetHLTResult("HLT_DoubleMu3_HT150_v2") )        return true;
-    if ( GetHLTResult("HLT_DoubleMu3_HT150_v3") )        return true;
+  if(iAnalysis==0 || iAnalysis==1) {//JZB, same sign
+    return GetTriggerMenuResult(fMuTriggers[iAnalysis]);
   }
   if(iAnalysis==2) {//mt2
     return passAnyMT2Trigger();
   }
   return false;
-} 
+}
 
 //______________________________________________________________________________
 const bool RunEfficiency::passEMuTriggers(int iAnalysis) {
-  if(iAnalysis==0) {//JZB
-    if ( GetHLTResult("HLT_Mu17_Ele8_CaloIdL_v1") )        return true;
-    if ( GetHLTResult("HLT_Mu17_Ele8_CaloIdL_v2") )        return true;
-    if ( GetHLTResult("HLT_Mu17_Ele8_CaloIdL_v3") )        return true;
-    if ( GetHLTResult("HLT_Mu17_Ele8_CaloIdL_v4") )        return true;
-    if ( GetHLTResult("HLT_Mu17_Ele8_CaloIdL_v5") )        return true;
-    if ( GetHLTResult("HLT_Mu17_Ele8_CaloIdL_v6") )        return true;
-    if ( GetHLTResult("HLT_Mu17_Ele8_CaloIdL_v7") )        return true;
-    if ( GetHLTResult("HLT_Mu17_Ele8_CaloIdL_v8") )        return true;
-    if ( GetHLTResult("HLT_Mu17_Ele8_CaloIdL_v9") )        return true;
-    
-    if ( GetHLTResult("HLT_Mu8_Ele17_CaloIdL_v1") )        return true;
-    if ( GetHLTResult("HLT_Mu8_Ele17_CaloIdL_v2") )        return true;
-    if ( GetHLTResult("HLT_Mu8_Ele17_CaloIdL_v3") )        return true;
-    if ( GetHLTResult("HLT_Mu8_Ele17_CaloIdL_v4") )        return true;
-    if ( GetHLTResult("HLT_Mu8_Ele17_CaloIdL_v5") )        return true;
-    if ( GetHLTResult("HLT_Mu8_Ele17_CaloIdL_v6") )        return true;
-    if ( GetHLTResult("HLT_Mu8_Ele17_CaloIdL_v7") )        return true;
-    if ( GetHLTResult("HLT_Mu8_Ele17_CaloIdL_v8") )        return true;
-    if ( GetHLTResult("HLT_Mu8_Ele17_CaloIdL_v9") )        return true;
-  }
-  if(iAnalysis==1) {//same sign
-    if ( GetHLTResult("HLT_MU3_ELE8_HT160") )        			return true;
-    if ( GetHLTResult("HLT_Mu3_Ele8_CaloIdL_TrkIdVL_HT160_v1") )        	return true;
-    if ( GetHLTResult("HLT_Mu3_Ele8_CaloIdL_TrkIdVL_HT160_v2") )        	return true;
-    if ( GetHLTResult("HLT_Mu3_Ele8_CaloIdL_TrkIdVL_HT160_v3") )        	return true;
-    if ( GetHLTResult("HLT_Mu3_Ele8_CaloIdL_TrkIdVL_HT150_v1") )        	return true;
-    if ( GetHLTResult("HLT_Mu3_Ele8_CaloIdL_TrkIdVL_HT150_v2") )        	return true;
-    if ( GetHLTResult("HLT_Mu3_Ele8_CaloIdL_TrkIdVL_HT150_v3") )        	return true;
-    if ( GetHLTResult("HLT_Ele17_CaloIdL_CaloIsoVL_Ele8_CaloIdL_CaloIsoVL_v1") )        return true;
-    if ( GetHLTResult("HLT_Ele17_CaloIdL_CaloIsoVL_Ele8_CaloIdL_CaloIsoVL_v2") )        return true;
-    if ( GetHLTResult("HLT_MU3_ELE8_HT160_TIGHT") )        			return true;
-    if ( GetHLTResult("HLT_Mu3_Ele8_CaloIdT_TrkIdVL_HT160_v1") )        	return true;
-    if ( GetHLTResult("HLT_Mu3_Ele8_CaloIdT_TrkIdVL_HT160_v2") )        	return true;
-    if ( GetHLTResult("HLT_Mu3_Ele8_CaloIdT_TrkIdVL_HT160_v3") )        	return true;
-    if ( GetHLTResult("HLT_Mu3_Ele8_CaloIdT_TrkIdVL_HT150_v1") )        	return true;
-    if ( GetHLTResult("HLT_Mu3_Ele8_CaloIdT_TrkIdVL_HT150_v2") )        	return true;
-    if ( GetHLTResult("HLT_Mu3_Ele8_CaloIdT_TrkIdVL_HT150_v3") )        	return true;
+  if(iAnalysis==0 || iAnalysis==1) {//JZB, same sign
+    return GetTriggerMenuResult(fEMuTriggers[iAnalysis]);
   }
   if(iAnalysis==2) {//mt2
     return passAnyMT2Trigger();
@@ -35,10 +35,7 @@ SSDLAnalysis::SSDLAnalysis(TreeReader *tr, bool data, string globaltag): UserAna
 	fCutnames[3] = " ... has at least one loose lepton (mc only)";
 
 
-	fCounter.fill(fCutnames[0], 0.);
-	fCounter.fill(fCutnames[1], 0.);
-	fCounter.fill(fCutnames[2], 0.);
-	fCounter.fill(fCutnames[3], 0.);
+	for(int i = 0; i < 4; ++i) fCuts[i] = fCounter.book(fCutnames[i]);
 }
 SSDLAnalysis::~SSDLAnalysis(){
 }
@@ -83,6 +80,9 @@ void SSDLAnalysis::Begin(const char* filename){
 
 //____________________________________________________________________________
 void SSDLAnalysis::End(){
+	// gDirectory is not this job's file when the workers of a parallel
+	// job are ended one after the other
+	fOutputFile->cd();
 	if (!fIsData) {
 		fMsugraCount->Write();
 		for (int i=0; i<10; i++) {
@@ -108,7 +108,6 @@ void SSDLAnalysis::End(){
 			fModelCount           [i] -> Write();
 		}
 	}
-	fOutputFile->cd();
 	fHEvCount->Write();
 	fAnalysisTree->Write();
 	fOutputFile->Close();
@@ -138,6 +137,7 @@ void SSDLAnalysis::ReadTriggers(const char* triggerfile){
 				sscanf(buffer, "Path\t%s", StringValue);
 				ps.paths.push_back(string(StringValue));
 			}
+			ps.menu = AddTriggerMenu(ps.paths); // resolved at each new HLT menu
 			fHLTPathSets.push_back(ps);
 			ok = true;
 		}
@@ -147,7 +147,7 @@ void SSDLAnalysis::ReadTriggers(const char* triggerfile){
 	if(fVerbose > 0){
 		cout << "Adding Trigger path sets:" << endl;
 		for(size_t i = 0; i < fHLTPathSets.size(); ++i){
-			HLTPathSet ps = fHLTPathSets[i];
+			const HLTPathSet &ps = fHLTPathSets[i];
 			cout << " " << ps.name << endl;
 			for(size_t j = 0; j < ps.paths.size(); ++j){
 				cout << "   > " << ps.paths[j] << endl;
@@ -161,7 +161,7 @@ void SSDLAnalysis::ReadTriggers(const char* triggerfile){
 }
 void SSDLAnalysis::AddTriggerBranches(){
 	for(unsigned int i = 0; i < fHLTPathSets.size(); i++){
-		HLTPathSet ps = fHLTPathSets[i];
+		const HLTPathSet &ps = fHLTPathSets[i];
 		TString prescalename = ps.name + "_PS";
 		if(AddBranch(ps.name.Data(),      "I", &fHLTResults[i])   == false ) exit(-1);
 		if(AddBranch(prescalename.Data(), "I", &fHLTPrescales[i]) == false ) exit(-1);
@@ -173,20 +173,18 @@ bool SSDLAnalysis::FillTriggers(){
 	if(fHLTPathSets.size() == 0 ) return false;
 
 	for(unsigned int i = 0; i < fHLTPathSets.size(); i++){ // loop over path sets
-		HLTPathSet ps = fHLTPathSets[i];
-
-		for(size_t j = 0; j < ps.paths.size(); ++j){ // loop over paths
+		// Bits of the paths of the set found in the current menu, the first
+		// one gives result and prescale
+		const vector<int> &bits = GetTriggerMenuBits(fHLTPathSets[i].menu);
+		if(bits.empty()){ // Bit not found
 			fHLTResults[i]   = -1;
 			fHLTPrescales[i] = -1;
-			string path = ps.paths[j];
-
-			if(GetHLTBit(path) == -1) continue; // Bit not found
-			bool triggered   = GetHLTResult(path);
-			fHLTResults[i]   = triggered ? 1:0;
-			fHLTPrescales[i] = GetHLTPrescale(path);
-			accept = accept || triggered;
-			break; // break loop after the bit is found
+			continue;
 		}
+		bool triggered   = fTR->HLTResults[bits[0]];
+		fHLTResults[i]   = triggered ? 1:0;
+		fHLTPrescales[i] = fTR->HLTPrescale[bits[0]];
+		accept = accept || triggered;
 	}
 	return accept;
 }
@@ -354,7 +352,7 @@ void SSDLAnalysis::Analyze(){
 	FillAnalysisTree();
 }
 void SSDLAnalysis::FillAnalysisTree(){
-	fCounter.fill(fCutnames[0]);
+	fCounter.fill(fCuts[0]);
 	bool TChiSlepSnu(false);
 	bool isRightHanded(false);
 	float x(0);
@@ -419,13 +417,13 @@ void SSDLAnalysis::FillAnalysisTree(){
 	}
 	// initial event selection: good event trigger, good primary vertex...
 	if( !IsGoodEvent() ) return;
-	fCounter.fill(fCutnames[1]);
+	fCounter.fill(fCuts[1]);
 	ResetTree();
 	
 	// Trigger selection
 	// if(fIsData && FillTriggers(fHLTPaths) == false) return;
 	FillTriggers();
-	fCounter.fill(fCutnames[2]);
+	fCounter.fill(fCuts[2]);
 
 	// Do object selections
 	vector<int> selectedMuInd  = MuonSelection(           &UserAnalysisBase::IsMostBasicMu);
@@ -442,7 +440,7 @@ void SSDLAnalysis::FillAnalysisTree(){
 	// Require at least one loose lepton
 	// if( (fTnqmus + fTnqels) < 1 ) return;
 	if( (nLooseMus + fTnqels) < 1 ) return;
-	fCounter.fill(fCutnames[3]);
+	fCounter.fill(fCuts[3]);
 
 	// Event and run info
 	fTRunNumber   = fTR->Run;
@@ -5,6 +5,20 @@ using namespace std;
 
 SSDLAnalyzer::SSDLAnalyzer(std::vector<std::string>& fileList, bool isdata, string globaltag) : TreeAnalyzerBase(fileList) {
 	fSSDLAnalysis = new SSDLAnalysis(fTR, isdata, globaltag);
+	fPtHatCut = -1.0;
+	fDoFillEffTree = false;
+	fGlobalTag = globaltag;
+	fUsePUFiles = false;
+}
+
+SSDLAnalyzer::SSDLAnalyzer(std::vector<std::string>& fileList, const SSDLAnalyzer *master) : TreeAnalyzerBase(fileList, master) {
+	fSSDLAnalysis = new SSDLAnalysis(fTR, master->fIsData, master->fGlobalTag);
+	fPtHatCut      = master->fPtHatCut;
+	fDoFillEffTree = master->fDoFillEffTree;
+	fGlobalTag     = master->fGlobalTag;
+	fUsePUFiles    = master->fUsePUFiles;
+	fDataPUFile    = master->fDataPUFile;
+	fMCPUFile      = master->fMCPUFile;
 }
 
 SSDLAnalyzer::~SSDLAnalyzer(){
@@ -14,6 +28,10 @@ SSDLAnalyzer::~SSDLAnalyzer(){
 
 // Method for looping over the tree
 void SSDLAnalyzer::Loop(){
+	if( IsParallel() ){
+		LoopParallel();
+		return;
+	}
 	Long64_t nentries = fTR->GetEntries();
 	cout << " total events in ntuples = " << nentries << endl;
 
@@ -36,8 +54,6 @@ void SSDLAnalyzer::Loop(){
 			// MARC // Prescale processing...
 			// MARC if ( prescale>1 && jentry%prescale ) continue;
 
-			fTR->GetEntry(jentry);
-
 			// Upper Pt Hat cut
 			if( (fPtHatCut > -1.0) && (fTR->PtHat > fPtHatCut) ) continue;
 
@@ -73,6 +89,9 @@ void SSDLAnalyzer::BeginJob(){
 }
 
 void SSDLAnalyzer::BeginJob(std::string dataPuFile, std::string mcPuFile){
+	fUsePUFiles = true;
+	fDataPUFile = dataPuFile;
+	fMCPUFile   = mcPuFile;
 	// fSSDLAnalysis->SetOutputDir(fOutputDir);
 	fSSDLAnalysis->SSDLAnalysis::SetPileUpSrc( dataPuFile , mcPuFile); //HERE
 	fSSDLAnalysis->SetOutputFile(fOutputFile);
@@ -84,4 +103,22 @@ void SSDLAnalyzer::BeginJob(std::string dataPuFile, std::string mcPuFile){
 // Method called after finishing the event loop
 void SSDLAnalyzer::EndJob(){
 	fSSDLAnalysis->End();
+	// Parallel running: the worker parts replace the (empty) output
+	TString output = fOutputFile;
+	if(!output.EndsWith(".root")) output += ".root";
+	MergeOutputs(output);
+}
+
+// Parallel running: the worker writes its part of the output to outputFile
+TreeAnalyzerBase* SSDLAnalyzer::MakeWorker(std::vector<std::string>& fileList, const TString& outputFile){
+	SSDLAnalyzer *W = new SSDLAnalyzer(fileList, this);
+	W->SetOutputFile(outputFile);
+	if(fUsePUFiles) W->BeginJob(fDataPUFile, fMCPUFile);
+	else            W->BeginJob();
+	return W;
+}
+
+void SSDLAnalyzer::MergeWorker(TreeAnalyzerBase *worker){
+	TreeAnalyzerBase::MergeWorker(worker);
+	fSSDLAnalysis->AddCounters(*((SSDLAnalyzer*)worker)->fSSDLAnalysis);
 }
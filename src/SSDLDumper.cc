@@ -14,9 +14,9 @@
 #include "helper/AnaClass.hh"
 #include "helper/Utilities.hh"
 #include "helper/FPRatios.hh"
-#include "helper/Davismt2.h"
 #include "helper/FakeRatios.hh"
 #include "helper/Monitor.hh"
+#include "helper/HistoCache.hh"
 
 // #include "helper/BTagSFUtil/BTagSFUtil.h"
 // #include "helper/BTagSF.hh"
@@ -26,6 +26,10 @@
 #include "TGraphAsymmErrors.h"
 #include "TEfficiency.h"
 #include "TRandom3.h"
+#include "TThread.h"
+#include "TMutex.h"
+#include "TVirtualMutex.h"
+#include "TSystem.h"
 
 #include "TWbox.h"
 #include "TMultiGraph.h"
@@ -36,6 +40,7 @@
 #include <time.h> // access to date/time
 
 #include <typeinfo>
+#include <algorithm>
 
 
 int gDEBUG_EVENTNUMBER_ = -1;  
@@ -301,11 +306,65 @@ SSDLDumper::SSDLDumper(TString configfile){
 	gSystematics["METUp"]    = 8;
 	gSystematics["METDown"]  = 9;
 
+	fNThreads     = 1;
+	fNJobs        = 1;
+	fWorkerIndex  = -1;
+	fShowProgress = true;
+	fIOMutex      = NULL;
+
+	fBTagSF      = NULL; // created in init()
+	fRand3       = NULL;
+	fRand3Normal = NULL;
+
+	fInvertZVeto   = gInvertZVeto;
+	fNJetSelCaches = 0;
+	fObsTree       = NULL;
+	fObsEntry      = -1;
+	resetObsCacheStats();
+}
+//____________________________________________________________________________
+SSDLDumper::SSDLDumper(const SSDLDumper *master){
+	// Worker clone used by processEntriesParallel: shares the region
+	// definitions of the master (read-only during the loop) instead of
+	// parsing the configuration file again
+	gRegions        = master->gRegions;
+	gRegion         = master->gRegion;
+	gNREGIONS       = master->gNREGIONS;
+	gBaseRegion     = master->gBaseRegion;
+	gSystematics    = master->gSystematics;
+	gApplyZVeto     = master->gApplyZVeto;
+	gDoWZValidation = master->gDoWZValidation;
+	tmp_gMinJetPt   = master->tmp_gMinJetPt;
+	tmp_gMuMaxIso   = master->tmp_gMuMaxIso;
+	tmp_gElMaxIso   = master->tmp_gElMaxIso;
+
+	fVerbose        = 0;
+	fOutputDir      = master->fOutputDir;
+	fOutputFileName = master->fOutputFileName;
+	fOutputFile     = NULL;
+	fGoodRunList    = master->fGoodRunList; // only read in the loop
+	fNThreads       = 1;
+	fNJobs          = 1;
+	fWorkerIndex    = -1;
+	fShowProgress   = true;
+	fIOMutex        = NULL;
+	fInvertZVeto    = master->fInvertZVeto;
+	fNJetSelCaches  = 0;
+	fObsTree        = NULL;
+	fObsEntry       = -1;
+	resetObsCacheStats();
+	fBTagSF         = NULL;
+	fRand3          = NULL;
+	fRand3Normal    = NULL;
+	init();
 }
 
 //____________________________________________________________________________
 SSDLDumper::~SSDLDumper(){
 	if(fOutputFile != NULL && fOutputFile->IsOpen()) fOutputFile->Close();
+	delete fBTagSF;
+	delete fRand3;
+	delete fRand3Normal;
 	fChain = 0;
 }
 
@@ -337,6 +396,9 @@ void SSDLDumper::init(){
 	fDoCounting = false;  // Disable counters by default
 
 	// fBTagSFUtil = new BTagSFUtil("CSV", 28);
+	delete fBTagSF;
+	delete fRand3;
+	delete fRand3Normal;
 	fBTagSF = new BTagSF();
 	fRand3 = new TRandom3(50);
 	fRand3Normal = new TRandom3(10);
@@ -461,67 +523,213 @@ void SSDLDumper::loop(){
         /////////////////////// 
         //READ JSON FILE
         /////////////////////// 
-        fGoodRunList = new GoodRunList(gJSONfile);
+        fGoodRunList = new GoodRunList();
+        if(gJSONfile != "" && !fGoodRunList->ReadJSON(gJSONfile)){
+		cout << "SSDLDumper::loop ==> Error: cannot read JSON " << gJSONfile << ", exiting..." << endl;
+		exit(1);
+	}
 	//////////////////////
+	if(fNJobs > 1 && fSamples.size() > 1) loopSamplesParallel();
+	else for(size_t i = 0; i < fSamples.size(); ++i) runSample(fSamples[i]);
+
+	delete fGoodRunList;
+}
+void SSDLDumper::runSample(Sample *S){
+	fSample = S; // TODO: Clean this up, call the triggers with an argument
+	fOutputFileName = fOutputDir + fSample->sname + "_Yields.root";
+	
+	fCurLumi = -1;
+	fCurRun  = -1;
+	skipRun  = false;
+	skipLumi = false;
+	
+	loopEvents(fSample);
+}
+//____________________________________________________________________________
+// Sample-level scheduling: a pool of fNJobs threads picks samples from a
+// queue sorted by tree size, largest first. Every job runs on its own clone
+// of the dumper, so that fSample, the run/lumi bookkeeping, the event
+// weights and the branch buffers are private to the job.
+struct SampleQueue {
+	SSDLDumper *master;
+	vector<SSDLDumper::Sample*> samples;
+	size_t next;
+};
+static void* runSampleQueue(void *arg){
+	SampleQueue *q = (SampleQueue*)arg;
+	while(true){
+		SSDLDumper::Sample *S = NULL;
+		SSDLDumper *W = NULL;
+		{
+			TLockGuard lock(q->master->fIOMutex);
+			if(q->next < q->samples.size()){
+				S = q->samples[q->next++];
+				W = new SSDLDumper(q->master);
+				W->fIOMutex = q->master->fIOMutex;
+				W->fShowProgress = false;
+				W->fVerbose      = q->master->fVerbose;
+				cout << " Starting " << S->sname << endl;
+			}
+		}
+		if(S == NULL) break;
+		W->runSample(S);
+		{
+			TLockGuard lock(q->master->fIOMutex);
+			cout << " Done with " << S->sname << endl;
+			delete W;
+		}
+	}
+	return 0;
+}
+static bool largerTree(const pair<Long64_t, SSDLDumper::Sample*> &a, const pair<Long64_t, SSDLDumper::Sample*> &b){
+	return a.first > b.first;
+}
+void SSDLDumper::loopSamplesParallel(){
+	TThread::Initialize();
+	fIOMutex = new TMutex();
+
+	// Order by number of entries, so that the long jobs start first and the
+	// small samples fill the gaps at the end
+	vector<pair<Long64_t, Sample*> > sizes;
 	for(size_t i = 0; i < fSamples.size(); ++i){
-		fSample = fSamples[i]; // TODO: Clean this up, call the triggers with an argument
-		fOutputFileName = fOutputDir + fSample->sname + "_Yields.root";
-		
-		fCurLumi = -1;
-		fCurRun  = -1;
-		skipRun  = false;
-		skipLumi = false;
-		
-		loopEvents(fSample);
+		TTree *tree = fSamples[i]->getTree();
+		sizes.push_back(make_pair(tree->GetEntries(), fSamples[i]));
+		fSamples[i]->cleanUp();
 	}
+	sort(sizes.begin(), sizes.end(), largerTree);
 
-	delete fGoodRunList;
+	SampleQueue queue;
+	queue.master = this;
+	queue.next   = 0;
+	for(size_t i = 0; i < sizes.size(); ++i) queue.samples.push_back(sizes[i].second);
+
+	int nthreads = TMath::Min(fNJobs, int(fSamples.size()));
+	if(fVerbose > 0) cout << " Running " << fSamples.size() << " samples on " << nthreads << " threads" << endl;
+	vector<TThread*> threads;
+	for(int i = 0; i < nthreads; ++i){
+		threads.push_back(new TThread(Form("SSDLJob_%d", i), runSampleQueue, &queue));
+		threads.back()->Run();
+	}
+	for(int i = 0; i < nthreads; ++i){
+		threads[i]->Join();
+		delete threads[i];
+	}
+
+	delete fIOMutex;
+	fIOMutex = NULL;
 }
 void SSDLDumper::loopEvents(Sample *S){
-	fDoCounting = true;
-	if(S->datamc == 0){
-		TString eventfilename  = fOutputDir + S->sname + "_SignalEvents.txt";
-		fOUTSTREAM.open(eventfilename.Data(), ios::trunc);		
+	// Opening files, booking and writing go through gDirectory and the ROOT
+	// object lists, which are shared between jobs running concurrently:
+	// serialize them on fIOMutex (no-op when running a single job)
+	TFile *pFile;
+	{
+		TLockGuard lock(fIOMutex);
+		fDoCounting = true;
+		if(S->datamc == 0){
+			TString eventfilename  = fOutputDir + S->sname + "_SignalEvents.txt";
+			fOUTSTREAM.open(eventfilename.Data(), ios::trunc);		
 //SIGEVENTS PRINTOUT		for(regIt = gRegions.begin(); regIt != gRegions.end(); regIt++) {
 //SIGEVENTS PRINTOUT			TString allRegionSigEvents  = fOutputDir + S->sname + "_SignalEvents_"+(*regIt)->sname+".txt";
 //SIGEVENTS PRINTOUT			(*regIt)->regionOutstream.open(allRegionSigEvents.Data(), ios::trunc);		
 //SIGEVENTS PRINTOUT			//outStreamMap[(*regIt)->sname] = (*regIt)->regionOutstream;
 //SIGEVENTS PRINTOUT		}
-	}
+		}
 
-	TFile *pFile = new TFile(fOutputFileName, "RECREATE");
+		pFile = new TFile(fOutputFileName, "RECREATE");
 
-	bookHistos(S);
-	bookSigEvTree();
+		bookHistos(S);
+		bookSigEvTree();
+		if(fIOMutex) fSigEv_Tree->SetDirectory(0); // no basket writing outside the lock
 	
-	TTree *tree = S->getTree();
-	S->evcount->Add(S->getEvCount());	
+		TTree *tree = S->getTree();
+		S->evcount->Add(S->getEvCount());	
 	
-	// Stuff to execute for each sample BEFORE looping on the events
-	initCounters();
+		// Stuff to execute for each sample BEFORE looping on the events
+		resetCounters();
+		initCounters();
+		resetObsCacheStats();
 
-	// Event loop
-	tree->ResetBranchAddresses();
-	// Init(tree);
-	Init(tree);
+		// Event loop
+		tree->ResetBranchAddresses();
+		// Init(tree);
+		Init(tree);
+	}
 	int ntrigger;
 	int nused;
 
 	if (fChain == 0) return;
 	Long64_t nentries = fChain->GetEntriesFast();
+	if(fNThreads > 1) processEntriesParallel(S, nentries);
+	else              processEntries(S, 0, nentries);
+
+	TLockGuard lock(fIOMutex);
+	//FOR PABLO	cout << "--------------------------------------------------" << endl;
+	//FOR PABLO	cout << "--------------------------------------------------" << endl;
+	//FOR PABLO	cout << "--" << Form("fired the trigger: %d   used in my analysis: %d", ntrigger, nused) << endl;
+	//FOR PABLO	cout << "--------------------------------------------------" << endl;
+	//FOR PABLO	cout << "--------------------------------------------------" << endl;
+
+	// Stuff to execute for each sample AFTER looping on the events
+	fillCutFlowHistos(S);
+	if(fVerbose > 1) printObsCacheStats(S->sname);
+	// marc printCutFlow(Muon);
+	// marc printCutFlow(Elec);
+	// marc printCutFlow(ElMu);
+	
+	writeHistos(S, pFile);
+	writeSigGraphs(S, Muon, pFile);
+	writeSigGraphs(S, Elec, pFile);
+	writeSigGraphs(S, ElMu, pFile);
+
+	writeSigEvTree(pFile);
+
+	deleteHistos(S);
+	S->cleanUp();
+
+	pFile->Write();
+	pFile->Close();
+
+	if(S->datamc == 0){
+		 fOUTSTREAM.close();
+//SIGEVENTS PRINTOUT		 for(regIt = gRegions.begin(); regIt != gRegions.end(); regIt++) {
+//SIGEVENTS PRINTOUT			//outStreamMap[(*regIt)->sname].close();
+//SIGEVENTS PRINTOUT			(*regIt)->regionOutstream.close();
+//SIGEVENTS PRINTOUT		}
+	}
+	fDoCounting = false;
+}
+//____________________________________________________________________________
+void SSDLDumper::processEntries(Sample *S, Long64_t first, Long64_t last){
+	// Event loop on the entries [first, last) of the tree attached with Init().
+	// Serial running calls this on the full range, workers of
+	// processEntriesParallel on their shard of it.
 	Long64_t nbytes = 0, nb = 0;
-	for (Long64_t jentry=0; jentry<nentries;jentry++) {
-		printProgress(jentry, nentries, S->sname);
+	makeRegionGroups();
+	for (Long64_t jentry=first; jentry<last;jentry++) {
+		if(fShowProgress) printProgress(jentry-first, last-first, S->sname);
 
 		Long64_t ientry = LoadTree(jentry);
 		if (ientry < 0) break;
-		nb = fChain->GetEntry(jentry);   nbytes += nb;
 
 		/////////////////////////////////////////////
 		//   APPLY JSON
 		/////////////////////////////////////////////
-		if (S->datamc == 0 && !IsInJSON()) continue;
-		
+		// Only Run and LumiSec are read for this, the other branches are
+		// read for the accepted entries: run and lumi ranges outside the
+		// JSON cost two small branches instead of the full event
+		if (S->datamc == 0){
+			b_Run    ->GetEntry(ientry);
+			b_LumiSec->GetEntry(ientry);
+			if (!IsInJSON()) continue;
+		}
+		nb = fChain->GetEntry(jentry);   nbytes += nb;
+		invalidateObsCache();
+
+		// workers: same random sequence for this event, whichever thread
+		// processes it. Serial running keeps the one stream of the job.
+		if(fWorkerIndex >= 0) seedRandoms();
+
 		// reset hypothesis leptons
 		resetHypLeptons();
 		
@@ -538,20 +746,21 @@ void SSDLDumper::loopEvents(Sample *S){
 
 		/////////////////////////////////////////////
 		// Event modifications
+		if(gDoSystStudies) saveEvent(); // keep the unmodified values for the variations below
 		scaleBTags(S, 0); // this applies the bTagSF
 		saveBTags(); // this just saves the btag values for each jet.
 		/////////////////////////////////////////////
 		
-		fCounter[Muon].fill(fMMCutNames[0]);
-		fCounter[ElMu].fill(fEMCutNames[0]);
-		fCounter[Elec].fill(fEECutNames[0]);
+		fCounter[Muon].fill(fMMCuts[0]);
+		fCounter[ElMu].fill(fEMCuts[0]);
+		fCounter[Elec].fill(fEECuts[0]);
 
 		// Select mutually exclusive runs for Jet and MultiJet datasets
 		if(!isGoodRun(S)) continue;
 
-		fCounter[Muon].fill(fMMCutNames[1]);
-		fCounter[ElMu].fill(fEMCutNames[1]);
-		fCounter[Elec].fill(fEECutNames[1]);
+		fCounter[Muon].fill(fMMCuts[1]);
+		fCounter[ElMu].fill(fEMCuts[1]);
+		fCounter[Elec].fill(fEECuts[1]);
 
 
 		// Compute event-by-event weights:
@@ -568,12 +777,8 @@ void SSDLDumper::loopEvents(Sample *S){
 		fillKinPlots(S,gRegion[gBaseRegion]);
 		if (gDoWZValidation) fillKinPlots(S,gRegion["WZEnriched"]);
 
-		for(regIt = gRegions.begin(); regIt != gRegions.end(); regIt++) {
-			TString allRegionSigEvents  = fOutputDir + S->sname + "_SignalEvents_"+(*regIt)->sname+".txt";
-			if ( (*regIt)->sname == "TTbarWSel") fDoCounting = true;
-			fillYields(S, gRegion[(*regIt)->sname]);
-			if ( (*regIt)->sname == "TTbarWSel") fDoCounting = false;
-		}
+		// all regions at once, same as fillYields(S, reg) for each of them
+		fillRegionYields(S);
 		
 		// fillYields(S, gRegion["TTbarWPresel"]);
 
@@ -602,92 +807,191 @@ void SSDLDumper::loopEvents(Sample *S){
 		if(!gDoSystStudies) continue;
 
 		// Jet pts scaled down
-		fChain->GetEntry(jentry); // reset tree vars
+		restoreEvent(); // reset tree vars
 		resetBTags(); // reset to scaled btag values
 		smearJetPts(S, 1);
 		fillSigEventTree(S, gSystematics["JetUp"]);
 
 		// Jet pts scaled down
-		fChain->GetEntry(jentry); // reset tree vars
+		restoreEvent(); // reset tree vars
 		resetBTags(); // reset to scaled btag values
 		smearJetPts(S, 2);
 		fillSigEventTree(S, gSystematics["JetDown"]);
 
 		// Jet pts smeared
-		fChain->GetEntry(jentry); // reset tree vars
+		restoreEvent(); // reset tree vars
 		resetBTags(); // reset to scaled btag values
 		smearJetPts(S, 3);
 		fillSigEventTree(S, gSystematics["JetSmear"]);
 
 		// Btags scaled up
-		fChain->GetEntry(jentry); // reset tree vars
+		restoreEvent(); // reset tree vars
 		scaleBTags(S, 1);
 		fillSigEventTree(S, gSystematics["BUp"]);
 
 		// Btags scaled down
-		fChain->GetEntry(jentry); // reset tree vars
+		restoreEvent(); // reset tree vars
 		scaleBTags(S, 2);
 		fillSigEventTree(S, gSystematics["BDown"]);
 
 		// Lepton pts scaled up
-		fChain->GetEntry(jentry); // reset tree vars
+		restoreEvent(); // reset tree vars
 		resetBTags(); // reset to scaled btag values
 		scaleLeptons(S, 1);
  		// fillYields(S, gRegion["TTbarWSelLU"]);
 		fillSigEventTree(S, gSystematics["LepUp"]);
 
 		// Lepton pts scaled down
-		fChain->GetEntry(jentry); // reset tree vars
+		restoreEvent(); // reset tree vars
 		resetBTags(); // reset to scaled btag values
 		scaleLeptons(S, 2);
  		// fillYields(S, gRegion["TTbarWSelLD"]);
 		fillSigEventTree(S, gSystematics["LepDown"]);
 
 		// scale the unclustered MET up
-		fChain->GetEntry(jentry); // reset tree vars
+		restoreEvent(); // reset tree vars
 		resetBTags(); // reset to scaled btag values
 		scaleMET(S, 0);
 		fillSigEventTree(S, gSystematics["METUp"]);
 
 		// scale the unclustered MET down
-		fChain->GetEntry(jentry); // reset tree vars
+		restoreEvent(); // reset tree vars
 		resetBTags(); // reset to scaled btag values
 		scaleMET(S, 2);
 		fillSigEventTree(S, gSystematics["METDown"]);
 	}
-	//FOR PABLO	cout << "--------------------------------------------------" << endl;
-	//FOR PABLO	cout << "--------------------------------------------------" << endl;
-	//FOR PABLO	cout << "--" << Form("fired the trigger: %d   used in my analysis: %d", ntrigger, nused) << endl;
-	//FOR PABLO	cout << "--------------------------------------------------" << endl;
-	//FOR PABLO	cout << "--------------------------------------------------" << endl;
+}
+//____________________________________________________________________________
+// Parallel running: each worker owns a clone of the dumper (branch buffers,
+// cut values, random generators, counters), its own copy of the sample
+// histograms and its own handle on the input file.
+struct ShardJob {
+	SSDLDumper *dumper;
+	SSDLDumper::Sample *sample;
+	Long64_t first;
+	Long64_t last;
+};
+static void* runShard(void *arg){
+	ShardJob *job = (ShardJob*)arg;
+	job->dumper->processEntries(job->sample, job->first, job->last);
+	return 0;
+}
+void SSDLDumper::processEntriesParallel(Sample *S, Long64_t nentries){
+	// Split [0, nentries) in contiguous shards. All ROOT objects are created
+	// and merged on this thread, the workers only read their own file and fill
+	// their own histograms. Shards are merged back in entry order, so the
+	// SigEvents tree and the signal event printout keep the serial ordering.
+	TThread::Initialize();
+	int nworkers = fNThreads;
+	if(nentries < nworkers) nworkers = nentries > 0 ? int(nentries) : 1;
+	Long64_t chunk = nentries/nworkers;
+
+	vector<SSDLDumper*> workers;
+	vector<Sample*>     shards;
+	vector<ShardJob>    jobs(nworkers);
+	vector<TThread*>    threads;
+	{
+		// Booking and opening the shard files go through the ROOT lists shared
+		// with the other samples of loopSamplesParallel, same lock as loopEvents
+		TLockGuard lock(fIOMutex);
+		for(int i = 0; i < nworkers; ++i){
+			SSDLDumper *W = new SSDLDumper(this);
+			W->fWorkerIndex = i;
+			W->fShowProgress = (i == 0);
+			Sample *shard = new Sample(S->location, S->sname, S->datamc, S->xsec, gNREGIONS, S->chansel, S->color);
+			W->fSample = shard;
+			W->beginShard(shard);
+			workers.push_back(W);
+			shards .push_back(shard);
+			jobs[i].dumper = W;
+			jobs[i].sample = shard;
+			jobs[i].first  = i*chunk;
+			jobs[i].last   = (i == nworkers-1) ? nentries : (i+1)*chunk;
+		}
+	}
+	if(fVerbose > 0) cout << " Processing " << S->sname << " with " << nworkers << " threads" << endl;
+
+	for(int i = 0; i < nworkers; ++i){
+		threads.push_back(new TThread(Form("%s_%d", S->sname.Data(), i), runShard, &jobs[i]));
+		threads.back()->Run();
+	}
+	for(int i = 0; i < nworkers; ++i){
+		threads[i]->Join();
+		delete threads[i];
+	}
+
+	TLockGuard lock(fIOMutex);
+	for(int i = 0; i < nworkers; ++i){
+		mergeShard(S, workers[i], shards[i]);
+		workers[i]->deleteHistos(shards[i]);
+		shards[i]->cleanUp();
+		delete shards[i];
+		delete workers[i];
+	}
+}
+void SSDLDumper::beginShard(Sample *S){
+	fDoCounting = true;
+	if(S->datamc == 0){
+		fOUTSTREAMName = fOutputDir + S->sname + Form("_SignalEvents_%d.txt", fWorkerIndex);
+		fOUTSTREAM.open(fOUTSTREAMName.Data(), ios::trunc);
+	}
 
-	// Stuff to execute for each sample AFTER looping on the events
-	fillCutFlowHistos(S);
-	// marc printCutFlow(Muon);
-	// marc printCutFlow(Elec);
-	// marc printCutFlow(ElMu);
-	
-	writeHistos(S, pFile);
-	writeSigGraphs(S, Muon, pFile);
-	writeSigGraphs(S, Elec, pFile);
-	writeSigGraphs(S, ElMu, pFile);
+	bookHistos(S);
+	bookSigEvTree();
+	fSigEv_Tree->SetDirectory(0); // stays in memory, copied into the master tree
 
-	writeSigEvTree(pFile);
+	initCounters();
 
-	deleteHistos(S);
-	S->cleanUp();
+	fCurLumi = -1;
+	fCurRun  = -1;
+	skipRun  = false;
+	skipLumi = false;
 
-	pFile->Write();
-	pFile->Close();
+	TTree *tree = S->getTree();
+	tree->ResetBranchAddresses();
+	Init(tree);
+}
+void SSDLDumper::mergeShard(Sample *S, SSDLDumper *W, Sample *shard){
+	mergeHistos(S, shard);
+
+	for(gChannel ch = channels_begin; ch < gNCHANNELS; ch=gChannel(ch+1)){
+		fCounter[ch]        .add(W->fCounter[ch]);
+		fCounterSync[ch]    .add(W->fCounterSync[ch]);
+		fCounterPurities[ch].add(W->fCounterPurities[ch]);
+	}
+	addObsCacheStats(W);
+
+	fSigEv_Tree->CopyEntries(W->fSigEv_Tree);
+	delete W->fSigEv_Tree;
+	W->fSigEv_Tree = NULL;
+
+	fSigEv_HI_MM_HT .insert(fSigEv_HI_MM_HT .end(), W->fSigEv_HI_MM_HT .begin(), W->fSigEv_HI_MM_HT .end());
+	fSigEv_HI_MM_MET.insert(fSigEv_HI_MM_MET.end(), W->fSigEv_HI_MM_MET.begin(), W->fSigEv_HI_MM_MET.end());
+	fSigEv_HI_EE_HT .insert(fSigEv_HI_EE_HT .end(), W->fSigEv_HI_EE_HT .begin(), W->fSigEv_HI_EE_HT .end());
+	fSigEv_HI_EE_MET.insert(fSigEv_HI_EE_MET.end(), W->fSigEv_HI_EE_MET.begin(), W->fSigEv_HI_EE_MET.end());
+	fSigEv_HI_EM_HT .insert(fSigEv_HI_EM_HT .end(), W->fSigEv_HI_EM_HT .begin(), W->fSigEv_HI_EM_HT .end());
+	fSigEv_HI_EM_MET.insert(fSigEv_HI_EM_MET.end(), W->fSigEv_HI_EM_MET.begin(), W->fSigEv_HI_EM_MET.end());
 
 	if(S->datamc == 0){
-		 fOUTSTREAM.close();
-//SIGEVENTS PRINTOUT		 for(regIt = gRegions.begin(); regIt != gRegions.end(); regIt++) {
-//SIGEVENTS PRINTOUT			//outStreamMap[(*regIt)->sname].close();
-//SIGEVENTS PRINTOUT			(*regIt)->regionOutstream.close();
-//SIGEVENTS PRINTOUT		}
+		W->fOUTSTREAM.close();
+		ifstream part(W->fOUTSTREAMName.Data());
+		fOUTSTREAM << part.rdbuf();
+		part.close();
+		gSystem->Unlink(W->fOUTSTREAMName);
 	}
-	fDoCounting = false;
+}
+//____________________________________________________________________________
+static UInt_t eventSeed(Int_t run, Int_t ls, Int_t event, UInt_t salt){
+	UInt_t seed = (UInt_t(run)*1000003u) ^ (UInt_t(ls)*7919u) ^ UInt_t(event) ^ (salt*2654435761u);
+	return seed == 0 ? 1 : seed; // TRandom3 takes 0 as 'seed from the clock'
+}
+void SSDLDumper::seedRandoms(){
+	// Seed the smearing generators of a worker from the event key: every
+	// event sees the same random sequence whichever worker processes it, so
+	// the output does not depend on the number of threads. It is not bit
+	// identical to serial running, which draws from one stream seeded once.
+	fRand3      ->SetSeed(eventSeed(Run, LumiSec, Event, 50));
+	fRand3Normal->SetSeed(eventSeed(Run, LumiSec, Event, 10));
 }
 //____________________________________________________________________________
 bool SSDLDumper::IsInJSON(){
@@ -727,59 +1031,14 @@ void SSDLDumper::fillYields(Sample *S, int reg){
 	fDoCounting = false;
 	
 	if(reg == gRegion[gBaseRegion])   fDoCounting  = true;
-
-	if(reg == gRegion["WZEnriched"])  gInvertZVeto = true;
-	else                              gInvertZVeto = false;
 	
 	fCurrentChannel = Muon;
 	int mu1(-1), mu2(-1);
 	if(mumuSignalTrigger()){ // Trigger selection
-		if(fDoCounting) fCounter[Muon].fill(fMMCutNames[2]);
+		if(fDoCounting) fCounter[Muon].fill(fMMCuts[2]);
 		if(isSSLLMuEvent(mu1, mu2)){ // Same-sign loose-loose di muon event
 		        gEventWeight = getSF(S, Muon, mu1, mu2);
-			if(  isTightMuon(mu1) &&  isTightMuon(mu2) ){ // Tight-tight
-				if(fDoCounting) fCounter[Muon].fill(fMMCutNames[15]); // ... first muon passes tight cut
-				if(fDoCounting) fCounter[Muon].fill(fMMCutNames[16]); // ... second muon passes tight cut
-				if(fDoCounting) fCounter[Muon].fill(fMMCutNames[17]); // ... both muons pass tight cut
-				S->region[reg][HighPt].mm.nt20_pt ->Fill(MuPt [mu1], MuPt [mu2], gEventWeight);
-				S->region[reg][HighPt].mm.nt20_eta->Fill(fabs(MuEta[mu1]), fabs(MuEta[mu2]), gEventWeight);
-				if(S->datamc == 0 ){
-				  //SIGEVENTS PRINTOUT	gRegions[reg]->regionOutstream << Form("%12s: MuMu - run %6.0d / ls %5.0d / ev %11.0d - HT(#J/#bJ) %6.2f(%1d/%1d) MET %6.2f MT2 %6.2f Pt1 %6.2f Pt2 %6.2f Charge %2d", S->sname.Data(), Run, LumiSec, Event, getHT(), getNJets(), getNBTags(), getMET(), getMT2(mu1,mu2,Muon), MuPt[mu1], MuPt[mu2], MuCharge[mu1]) << endl ;
-					if(reg == gRegion[gBaseRegion]){
-					  fOUTSTREAM << Form("%12s: MuMu - run %6.0d / ls %5.0d / ev %11.0d - HT(#J/#bJ) %6.2f(%1d/%1d) MET %6.2f MT2 %6.2f Pt1 %6.2f Pt2 %6.2f Charge %2d", S->sname.Data(), Run, LumiSec, Event, getHT(), getNJets(), getNBTags(), getMET(), getMT2(mu1,mu2,Muon), MuPt[mu1], MuPt[mu2], MuCharge[mu1]) << endl ;
-					}
-				}
-				if(S->datamc > 0 ){
-					S->region[reg][HighPt].mm.nt11_origin->Fill(muIndexToBin(mu1)-0.5, muIndexToBin(mu2)-0.5, gEventWeight);
-					if(isPromptMuon(mu1) && isPromptMuon(mu2)) S->region[reg][HighPt].mm.nt2pp_pt->Fill(MuPt[mu1], MuPt[mu2], gEventWeight);
-					if(isPromptMuon(mu1) &&   isFakeMuon(mu2)) S->region[reg][HighPt].mm.nt2pf_pt->Fill(MuPt[mu1], MuPt[mu2], gEventWeight);
-					if(  isFakeMuon(mu1) && isPromptMuon(mu2)) S->region[reg][HighPt].mm.nt2fp_pt->Fill(MuPt[mu1], MuPt[mu2], gEventWeight);
-					if(  isFakeMuon(mu1) &&   isFakeMuon(mu2)) S->region[reg][HighPt].mm.nt2ff_pt->Fill(MuPt[mu1], MuPt[mu2], gEventWeight);
-				}
-			}
-			if(  isTightMuon(mu1) && !isTightMuon(mu2) ){ // Tight-loose
-				if(fDoCounting) fCounter[Muon].fill(fMMCutNames[15]); // ... first muon passes tight cut
-				S->region[reg][HighPt].mm.nt10_pt ->Fill(MuPt [mu1], MuPt [mu2], gEventWeight);
-				S->region[reg][HighPt].mm.nt10_eta->Fill(fabs(MuEta[mu1]), fabs(MuEta[mu2]), gEventWeight);
-				if(S->datamc > 0) S->region[reg][HighPt].mm.nt10_origin->Fill(muIndexToBin(mu1)-0.5, muIndexToBin(mu2)-0.5, gEventWeight);
-			}
-			if( !isTightMuon(mu1) &&  isTightMuon(mu2) ){ // Loose-tight
-				if(fDoCounting) fCounter[Muon].fill(fMMCutNames[16]); // ... second muon passes tight cut
-				S->region[reg][HighPt].mm.nt10_pt ->Fill(MuPt [mu2], MuPt [mu1], gEventWeight); // tight one always in x axis; fill same again
-				S->region[reg][HighPt].mm.nt10_eta->Fill(fabs(MuEta[mu2]), fabs(MuEta[mu1]), gEventWeight);
-				if(S->datamc > 0) S->region[reg][HighPt].mm.nt10_origin->Fill(muIndexToBin(mu2)-0.5, muIndexToBin(mu1)-0.5, gEventWeight);
-			}
-			if( !isTightMuon(mu1) && !isTightMuon(mu2) ){ // Loose-loose
-				S->region[reg][HighPt].mm.nt00_pt ->Fill(MuPt [mu1], MuPt [mu2], gEventWeight);
-				S->region[reg][HighPt].mm.nt00_eta->Fill(fabs(MuEta[mu1]), fabs(MuEta[mu2]), gEventWeight);
-				if(S->datamc > 0) S->region[reg][HighPt].mm.nt00_origin->Fill(muIndexToBin(mu1)-0.5, muIndexToBin(mu2)-0.5, gEventWeight);
-			}
-			if(S->datamc > 0){
-				if(isPromptMuon(mu1) && isPromptMuon(mu2)) S->region[reg][HighPt].mm.npp_pt->Fill(MuPt[mu1], MuPt[mu2], gEventWeight);
-				if(isPromptMuon(mu1) &&   isFakeMuon(mu2)) S->region[reg][HighPt].mm.npf_pt->Fill(MuPt[mu1], MuPt[mu2], gEventWeight);
-				if(  isFakeMuon(mu1) && isPromptMuon(mu2)) S->region[reg][HighPt].mm.nfp_pt->Fill(MuPt[mu1], MuPt[mu2], gEventWeight);
-				if(  isFakeMuon(mu1) &&   isFakeMuon(mu2)) S->region[reg][HighPt].mm.nff_pt->Fill(MuPt[mu1], MuPt[mu2], gEventWeight);			
-			}
+			fillSSYields(S, reg, Muon, mu1, mu2);
 		}
 		resetHypLeptons();
 	}
@@ -789,62 +1048,10 @@ void SSDLDumper::fillYields(Sample *S, int reg){
 	fCurrentChannel = Elec;
 	int el1(-1), el2(-1);
 	if(elelSignalTrigger()){
-		if(fDoCounting) fCounter[Elec].fill(fEECutNames[2]);
+		if(fDoCounting) fCounter[Elec].fill(fEECuts[2]);
 		if( isSSLLElEvent(el1, el2) ){
             		gEventWeight = getSF(S, Elec, el1, el2);
-			if(  isTightElectron(el1) &&  isTightElectron(el2) ){ // Tight-tight
-				if(fDoCounting) fCounter[Elec].fill(fEECutNames[15]); // " ... first electron passes tight cut
-				if(fDoCounting) fCounter[Elec].fill(fEECutNames[16]); // " ... second electron passes tight cut
-				if(fDoCounting) fCounter[Elec].fill(fEECutNames[17]); // " ... both electrons pass tight cut
-				S->region[reg][HighPt].ee.nt20_pt ->Fill(ElPt [el1], ElPt [el2], gEventWeight);
-				S->region[reg][HighPt].ee.nt20_eta->Fill(fabs(ElEta[el1]), fabs(ElEta[el2]), gEventWeight);
-				if(S->datamc == 0 ){
-				  //SIGEVENTS PRINTOUT	gRegions[reg]->regionOutstream << Form("%12s: ElEl - run %6.0d / ls %5.0d / ev %11.0d - HT(#J/#bJ) %6.2f(%1d/%1d) MET %6.2f MT2 %6.2f Pt1 %6.2f Pt2 %6.2f Charge %2d", S->sname.Data(), Run, LumiSec, Event, getHT(), getNJets(), getNBTags(), getMET(), getMT2(el1,el2,Elec), ElPt[el1], ElPt[el2], ElCharge[el1]) << endl ;
-					if(reg == gRegion[gBaseRegion]){
-						fOUTSTREAM << Form("%12s: ElEl - run %6.0d / ls %5.0d / ev %11.0d - HT(#J/#bJ) %6.2f(%1d/%1d) MET %6.2f MT2 %6.2f Pt1 %6.2f Pt2 %6.2f Charge %2d", S->sname.Data(), Run, LumiSec, Event, getHT(), getNJets(), getNBTags(), getMET(), getMT2(el1,el2,Elec), ElPt[el1], ElPt[el2], ElCharge[el1]) << endl ;
-					}
-				}
-				if(S->datamc > 0 ){
-					S->region[reg][HighPt].ee.nt11_origin->Fill(elIndexToBin(el1)-0.5, elIndexToBin(el2)-0.5, gEventWeight);
-					if(isPromptElectron(el1) && isPromptElectron(el2)){
-						S->region[reg][HighPt].ee.nt2pp_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
-						if(!isChargeMatchedElectron(el1) || !isChargeMatchedElectron(el2)){
-							S->region[reg][HighPt].ee.nt2pp_cm_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);							
-						}
-					}
-					if(isPromptElectron(el1) &&   isFakeElectron(el2)) S->region[reg][HighPt].ee.nt2pf_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
-					if(  isFakeElectron(el1) && isPromptElectron(el2)) S->region[reg][HighPt].ee.nt2fp_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
-					if(  isFakeElectron(el1) &&   isFakeElectron(el2)) S->region[reg][HighPt].ee.nt2ff_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
-				}
-			}
-			if(  isTightElectron(el1) && !isTightElectron(el2) ){ // Tight-loose
-				if(fDoCounting) fCounter[Elec].fill(fEECutNames[15]);
-				S->region[reg][HighPt].ee.nt10_pt ->Fill(ElPt [el1], ElPt [el2], gEventWeight);
-				S->region[reg][HighPt].ee.nt10_eta->Fill(fabs(ElEta[el1]), fabs(ElEta[el2]), gEventWeight);
-				if(S->datamc > 0) S->region[reg][HighPt].ee.nt10_origin->Fill(elIndexToBin(el1)-0.5, elIndexToBin(el2)-0.5, gEventWeight);
-			}
-			if( !isTightElectron(el1) &&  isTightElectron(el2) ){ // Loose-tight
-				if(fDoCounting) fCounter[Elec].fill(fEECutNames[16]);
-				S->region[reg][HighPt].ee.nt10_pt ->Fill(ElPt [el2], ElPt [el1], gEventWeight); // tight one always in x axis; fill same again
-				S->region[reg][HighPt].ee.nt10_eta->Fill(fabs(ElEta[el2]), fabs(ElEta[el2]), gEventWeight);
-				if(S->datamc > 0) S->region[reg][HighPt].ee.nt10_origin->Fill(elIndexToBin(el2)-0.5, elIndexToBin(el1)-0.5, gEventWeight);
-			}
-			if( !isTightElectron(el1) && !isTightElectron(el2) ){ // Loose-loose
-				S->region[reg][HighPt].ee.nt00_pt ->Fill(ElPt [el1], ElPt [el2], gEventWeight);
-				S->region[reg][HighPt].ee.nt00_eta->Fill(fabs(ElEta[el1]), fabs(ElEta[el2]), gEventWeight);
-				if(S->datamc > 0) S->region[reg][HighPt].ee.nt00_origin->Fill(elIndexToBin(el1)-0.5, elIndexToBin(el2)-0.5, gEventWeight);
-			}
-			if(S->datamc > 0 ){
-				if(isPromptElectron(el1) && isPromptElectron(el2)){
-					S->region[reg][HighPt].ee.npp_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
-					if(!isChargeMatchedElectron(el1) || !isChargeMatchedElectron(el2)){
-						S->region[reg][HighPt].ee.npp_cm_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);							
-					}
-				}
-				if(isPromptElectron(el1) &&   isFakeElectron(el2)) S->region[reg][HighPt].ee.npf_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
-				if(  isFakeElectron(el1) && isPromptElectron(el2)) S->region[reg][HighPt].ee.nfp_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
-				if(  isFakeElectron(el1) &&   isFakeElectron(el2)) S->region[reg][HighPt].ee.nff_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
-			}
+			fillSSYields(S, reg, Elec, el1, el2);
 		}
 		resetHypLeptons();
 	}
@@ -854,53 +1061,10 @@ void SSDLDumper::fillYields(Sample *S, int reg){
 	fCurrentChannel = ElMu;
 	int mu(-1), el(-1);
 	if(elmuSignalTrigger()){
-		if(fDoCounting) fCounter[ElMu].fill(fEMCutNames[2]);
+		if(fDoCounting) fCounter[ElMu].fill(fEMCuts[2]);
 		if( isSSLLElMuEvent(mu, el) ){
 		        gEventWeight = getSF(S, ElMu, mu, el);
-			if(  isTightElectron(el) &&  isTightMuon(mu) ){ // Tight-tight
-				if(fDoCounting) fCounter[ElMu].fill(fEMCutNames[15]);
-				if(fDoCounting) fCounter[ElMu].fill(fEMCutNames[16]);
-				if(fDoCounting) fCounter[ElMu].fill(fEMCutNames[17]);
-				S->region[reg][HighPt].em.nt20_pt ->Fill(MuPt [mu], ElPt [el], gEventWeight);
-				S->region[reg][HighPt].em.nt20_eta->Fill(fabs(MuEta[mu]), fabs(ElEta[el]), gEventWeight);
-				if(S->datamc == 0){
-				  //SIGEVENTS PRINTOUT	gRegions[reg]->regionOutstream << Form("%12s: ElMu - run %6.0d / ls %5.0d / ev %11.0d - HT(#J/#bJ) %6.2f(%1d/%1d) MET %6.2f MT2 %6.2f Pt1 %6.2f Pt2 %6.2f Charge %2d", S->sname.Data(), Run, LumiSec, Event, getHT(), getNJets(), getNBTags(), getMET(), getMT2(mu,el,ElMu), MuPt[mu], ElPt[el], ElCharge[el]) << endl;
-					if(reg == gRegion[gBaseRegion]){
-						fOUTSTREAM << Form("%12s: ElMu - run %6.0d / ls %5.0d / ev %11.0d - HT(#J/#bJ) %6.2f(%1d/%1d) MET %6.2f MT2 %6.2f Pt1 %6.2f Pt2 %6.2f Charge %2d", S->sname.Data(), Run, LumiSec, Event, getHT(), getNJets(), getNBTags(), getMET(), getMT2(mu,el,ElMu), MuPt[mu], ElPt[el], ElCharge[el]) << endl;
-					}
-				}
-				
-				if(S->datamc > 0){
-					S->region[reg][HighPt].em.nt11_origin->Fill(muIndexToBin(mu)-0.5, elIndexToBin(el)-0.5, gEventWeight);
-					if(isPromptMuon(mu) && isPromptElectron(el)) S->region[reg][HighPt].em.nt2pp_pt->Fill(MuPt[mu], ElPt[el], gEventWeight);
-					if(isPromptMuon(mu) &&   isFakeElectron(el)) S->region[reg][HighPt].em.nt2pf_pt->Fill(MuPt[mu], ElPt[el], gEventWeight);
-					if(  isFakeMuon(mu) && isPromptElectron(el)) S->region[reg][HighPt].em.nt2fp_pt->Fill(MuPt[mu], ElPt[el], gEventWeight);
-					if(  isFakeMuon(mu) &&   isFakeElectron(el)) S->region[reg][HighPt].em.nt2ff_pt->Fill(MuPt[mu], ElPt[el], gEventWeight);
-				}
-			}
-			if( !isTightElectron(el) &&  isTightMuon(mu) ){ // Tight-loose
-				if(fDoCounting) fCounter[ElMu].fill(fEMCutNames[15]);
-				S->region[reg][HighPt].em.nt10_pt ->Fill(MuPt [mu], ElPt [el], gEventWeight);
-				S->region[reg][HighPt].em.nt10_eta->Fill(fabs(MuEta[mu]), fabs(ElEta[el]), gEventWeight);
-				if(S->datamc > 0) S->region[reg][HighPt].em.nt10_origin->Fill(muIndexToBin(mu)-0.5, elIndexToBin(el)-0.5, gEventWeight);
-			}
-			if(  isTightElectron(el) && !isTightMuon(mu) ){ // Loose-tight
-				if(fDoCounting) fCounter[ElMu].fill(fEMCutNames[16]);
-				S->region[reg][HighPt].em.nt01_pt ->Fill(MuPt [mu], ElPt [el], gEventWeight); // muon always in x axis for e/mu
-				S->region[reg][HighPt].em.nt01_eta->Fill(fabs(MuEta[mu]), fabs(ElEta[el]), gEventWeight);
-				if(S->datamc > 0) S->region[reg][HighPt].em.nt01_origin->Fill(muIndexToBin(mu)-0.5, elIndexToBin(el)-0.5, gEventWeight);
-			}
-			if( !isTightElectron(el) && !isTightMuon(mu) ){ // Loose-loose
-				S->region[reg][HighPt].em.nt00_pt ->Fill(MuPt [mu], ElPt [el], gEventWeight);
-				S->region[reg][HighPt].em.nt00_eta->Fill(fabs(MuEta[mu]), fabs(ElEta[el]), gEventWeight);
-				if(S->datamc > 0) S->region[reg][HighPt].em.nt00_origin->Fill(muIndexToBin(mu)-0.5, elIndexToBin(el)-0.5, gEventWeight);
-			}
-			if(S->datamc > 0){
-				if(isPromptMuon(mu) && isPromptElectron(el)) S->region[reg][HighPt].em.npp_pt->Fill(MuPt[mu], ElPt[el], gEventWeight);
-				if(isPromptMuon(mu) &&   isFakeElectron(el)) S->region[reg][HighPt].em.npf_pt->Fill(MuPt[mu], ElPt[el], gEventWeight);
-				if(  isFakeMuon(mu) && isPromptElectron(el)) S->region[reg][HighPt].em.nfp_pt->Fill(MuPt[mu], ElPt[el], gEventWeight);
-				if(  isFakeMuon(mu) &&   isFakeElectron(el)) S->region[reg][HighPt].em.nff_pt->Fill(MuPt[mu], ElPt[el], gEventWeight);
-			}
+			fillSSYields(S, reg, ElMu, mu, el);
 		}
 		resetHypLeptons();
 	}
@@ -915,30 +1079,7 @@ void SSDLDumper::fillYields(Sample *S, int reg){
 	if(elelSignalTrigger()){
 		if( isSSLLElEvent(el1, el2) ){ // this selects now OS events with the exact same cuts
 		        gEventWeight = getSF(S, Elec, el1, el2);
-			if(  isTightElectron(el1) &&  isTightElectron(el2) ){ // Tight-tight
-				if( isBarrelElectron(el1) &&  isBarrelElectron(el2)) S->region[reg][HighPt].ee.nt20_OS_BB_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
-				if(!isBarrelElectron(el1) && !isBarrelElectron(el2)) S->region[reg][HighPt].ee.nt20_OS_EE_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
-				if( isBarrelElectron(el1) && !isBarrelElectron(el2)) S->region[reg][HighPt].ee.nt20_OS_EB_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
-				if(!isBarrelElectron(el1) &&  isBarrelElectron(el2)) S->region[reg][HighPt].ee.nt20_OS_EB_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
-			}
-			if(  isTightElectron(el1) && !isTightElectron(el2) ){ // Tight-loose
-				if( isBarrelElectron(el1) &&  isBarrelElectron(el2)) S->region[reg][HighPt].ee.nt10_OS_BB_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
-				if(!isBarrelElectron(el1) && !isBarrelElectron(el2)) S->region[reg][HighPt].ee.nt10_OS_EE_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
-				if( isBarrelElectron(el1) && !isBarrelElectron(el2)) S->region[reg][HighPt].ee.nt10_OS_EB_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
-				if(!isBarrelElectron(el1) &&  isBarrelElectron(el2)) S->region[reg][HighPt].ee.nt10_OS_EB_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
-			}
-			if( !isTightElectron(el1) &&  isTightElectron(el2) ){ // Loose-tight
-				if( isBarrelElectron(el1) &&  isBarrelElectron(el2)) S->region[reg][HighPt].ee.nt01_OS_BB_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
-				if(!isBarrelElectron(el1) && !isBarrelElectron(el2)) S->region[reg][HighPt].ee.nt01_OS_EE_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
-				if( isBarrelElectron(el1) && !isBarrelElectron(el2)) S->region[reg][HighPt].ee.nt01_OS_EB_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
-				if(!isBarrelElectron(el1) &&  isBarrelElectron(el2)) S->region[reg][HighPt].ee.nt01_OS_EB_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
-			}
-			if( !isTightElectron(el1) && !isTightElectron(el2) ){ // Loose-loose
-				if( isBarrelElectron(el1) &&  isBarrelElectron(el2)) S->region[reg][HighPt].ee.nt00_OS_BB_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
-				if(!isBarrelElectron(el1) && !isBarrelElectron(el2)) S->region[reg][HighPt].ee.nt00_OS_EE_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
-				if( isBarrelElectron(el1) && !isBarrelElectron(el2)) S->region[reg][HighPt].ee.nt00_OS_EB_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
-				if(!isBarrelElectron(el1) &&  isBarrelElectron(el2)) S->region[reg][HighPt].ee.nt00_OS_EB_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
-			}
+			fillOSYields(S, reg, Elec, el1, el2);
 		}
 		resetHypLeptons();
 	}
@@ -948,29 +1089,464 @@ void SSDLDumper::fillYields(Sample *S, int reg){
 	if(elmuSignalTrigger()){
 		if( isSSLLElMuEvent(mu, el) ){ // this selects now OS events with the exact same cuts
 		        gEventWeight = getSF(S, ElMu, mu, el);
-			if(  isTightElectron(el) &&  isTightMuon(mu) ){ // Tight-tight
-				if( isBarrelElectron(el)) S->region[reg][HighPt].em.nt20_OS_BB_pt->Fill(MuPt[mu], ElPt[el], gEventWeight);
-				if(!isBarrelElectron(el)) S->region[reg][HighPt].em.nt20_OS_EE_pt->Fill(MuPt[mu], ElPt[el], gEventWeight);
+			fillOSYields(S, reg, ElMu, mu, el);
+		}
+		resetHypLeptons();
+	}
+	fChargeSwitch = 0;
+	fDoCounting = false;
+	resetHypLeptons();
+}
+//____________________________________________________________________________
+void SSDLDumper::fillSSYields(Sample *S, int reg, gChannel chan, int ind1, int ind2){
+	// Same-sign yields of region reg for the selected pair (ordered as in
+	// isSSLLMuEvent, isSSLLElEvent and isSSLLElMuEvent), weight gEventWeight
+	if(chan == Muon){
+		const int mu1(ind1), mu2(ind2);
+		if(  isTightMuon(mu1) &&  isTightMuon(mu2) ){ // Tight-tight
+			if(fDoCounting) fCounter[Muon].fill(fMMCuts[15]); // ... first muon passes tight cut
+			if(fDoCounting) fCounter[Muon].fill(fMMCuts[16]); // ... second muon passes tight cut
+			if(fDoCounting) fCounter[Muon].fill(fMMCuts[17]); // ... both muons pass tight cut
+			S->region[reg][HighPt].mm.nt20_pt ->Fill(MuPt [mu1], MuPt [mu2], gEventWeight);
+			S->region[reg][HighPt].mm.nt20_eta->Fill(fabs(MuEta[mu1]), fabs(MuEta[mu2]), gEventWeight);
+			if(S->datamc == 0 ){
+			  //SIGEVENTS PRINTOUT	gRegions[reg]->regionOutstream << Form("%12s: MuMu - run %6.0d / ls %5.0d / ev %11.0d - HT(#J/#bJ) %6.2f(%1d/%1d) MET %6.2f MT2 %6.2f Pt1 %6.2f Pt2 %6.2f Charge %2d", S->sname.Data(), Run, LumiSec, Event, getHT(), getNJets(), getNBTags(), getMET(), getMT2(mu1,mu2,Muon), MuPt[mu1], MuPt[mu2], MuCharge[mu1]) << endl ;
+				if(reg == gRegion[gBaseRegion]){
+				  fOUTSTREAM << Form("%12s: MuMu - run %6.0d / ls %5.0d / ev %11.0d - HT(#J/#bJ) %6.2f(%1d/%1d) MET %6.2f MT2 %6.2f Pt1 %6.2f Pt2 %6.2f Charge %2d", S->sname.Data(), Run, LumiSec, Event, getHT(), getNJets(), getNBTags(), getMET(), getMT2(mu1,mu2,Muon), MuPt[mu1], MuPt[mu2], MuCharge[mu1]) << endl ;
+				}
+			}
+			if(S->datamc > 0 ){
+				S->region[reg][HighPt].mm.nt11_origin->Fill(muIndexToBin(mu1)-0.5, muIndexToBin(mu2)-0.5, gEventWeight);
+				if(isPromptMuon(mu1) && isPromptMuon(mu2)) S->region[reg][HighPt].mm.nt2pp_pt->Fill(MuPt[mu1], MuPt[mu2], gEventWeight);
+				if(isPromptMuon(mu1) &&   isFakeMuon(mu2)) S->region[reg][HighPt].mm.nt2pf_pt->Fill(MuPt[mu1], MuPt[mu2], gEventWeight);
+				if(  isFakeMuon(mu1) && isPromptMuon(mu2)) S->region[reg][HighPt].mm.nt2fp_pt->Fill(MuPt[mu1], MuPt[mu2], gEventWeight);
+				if(  isFakeMuon(mu1) &&   isFakeMuon(mu2)) S->region[reg][HighPt].mm.nt2ff_pt->Fill(MuPt[mu1], MuPt[mu2], gEventWeight);
 			}
-			if( !isTightElectron(el) &&  isTightMuon(mu) ){ // Tight-loose
-				if( isBarrelElectron(el)) S->region[reg][HighPt].em.nt10_OS_BB_pt->Fill(MuPt[mu], ElPt[el], gEventWeight);
-				if(!isBarrelElectron(el)) S->region[reg][HighPt].em.nt10_OS_EE_pt->Fill(MuPt[mu], ElPt[el], gEventWeight);
+		}
+		if(  isTightMuon(mu1) && !isTightMuon(mu2) ){ // Tight-loose
+			if(fDoCounting) fCounter[Muon].fill(fMMCuts[15]); // ... first muon passes tight cut
+			S->region[reg][HighPt].mm.nt10_pt ->Fill(MuPt [mu1], MuPt [mu2], gEventWeight);
+			S->region[reg][HighPt].mm.nt10_eta->Fill(fabs(MuEta[mu1]), fabs(MuEta[mu2]), gEventWeight);
+			if(S->datamc > 0) S->region[reg][HighPt].mm.nt10_origin->Fill(muIndexToBin(mu1)-0.5, muIndexToBin(mu2)-0.5, gEventWeight);
+		}
+		if( !isTightMuon(mu1) &&  isTightMuon(mu2) ){ // Loose-tight
+			if(fDoCounting) fCounter[Muon].fill(fMMCuts[16]); // ... second muon passes tight cut
+			S->region[reg][HighPt].mm.nt10_pt ->Fill(MuPt [mu2], MuPt [mu1], gEventWeight); // tight one always in x axis; fill same again
+			S->region[reg][HighPt].mm.nt10_eta->Fill(fabs(MuEta[mu2]), fabs(MuEta[mu1]), gEventWeight);
+			if(S->datamc > 0) S->region[reg][HighPt].mm.nt10_origin->Fill(muIndexToBin(mu2)-0.5, muIndexToBin(mu1)-0.5, gEventWeight);
+		}
+		if( !isTightMuon(mu1) && !isTightMuon(mu2) ){ // Loose-loose
+			S->region[reg][HighPt].mm.nt00_pt ->Fill(MuPt [mu1], MuPt [mu2], gEventWeight);
+			S->region[reg][HighPt].mm.nt00_eta->Fill(fabs(MuEta[mu1]), fabs(MuEta[mu2]), gEventWeight);
+			if(S->datamc > 0) S->region[reg][HighPt].mm.nt00_origin->Fill(muIndexToBin(mu1)-0.5, muIndexToBin(mu2)-0.5, gEventWeight);
+		}
+		if(S->datamc > 0){
+			if(isPromptMuon(mu1) && isPromptMuon(mu2)) S->region[reg][HighPt].mm.npp_pt->Fill(MuPt[mu1], MuPt[mu2], gEventWeight);
+			if(isPromptMuon(mu1) &&   isFakeMuon(mu2)) S->region[reg][HighPt].mm.npf_pt->Fill(MuPt[mu1], MuPt[mu2], gEventWeight);
+			if(  isFakeMuon(mu1) && isPromptMuon(mu2)) S->region[reg][HighPt].mm.nfp_pt->Fill(MuPt[mu1], MuPt[mu2], gEventWeight);
+			if(  isFakeMuon(mu1) &&   isFakeMuon(mu2)) S->region[reg][HighPt].mm.nff_pt->Fill(MuPt[mu1], MuPt[mu2], gEventWeight);			
+		}
+	}
+	if(chan == Elec){
+		const int el1(ind1), el2(ind2);
+		if(  isTightElectron(el1) &&  isTightElectron(el2) ){ // Tight-tight
+			if(fDoCounting) fCounter[Elec].fill(fEECuts[15]); // " ... first electron passes tight cut
+			if(fDoCounting) fCounter[Elec].fill(fEECuts[16]); // " ... second electron passes tight cut
+			if(fDoCounting) fCounter[Elec].fill(fEECuts[17]); // " ... both electrons pass tight cut
+			S->region[reg][HighPt].ee.nt20_pt ->Fill(ElPt [el1], ElPt [el2], gEventWeight);
+			S->region[reg][HighPt].ee.nt20_eta->Fill(fabs(ElEta[el1]), fabs(ElEta[el2]), gEventWeight);
+			if(S->datamc == 0 ){
+			  //SIGEVENTS PRINTOUT	gRegions[reg]->regionOutstream << Form("%12s: ElEl - run %6.0d / ls %5.0d / ev %11.0d - HT(#J/#bJ) %6.2f(%1d/%1d) MET %6.2f MT2 %6.2f Pt1 %6.2f Pt2 %6.2f Charge %2d", S->sname.Data(), Run, LumiSec, Event, getHT(), getNJets(), getNBTags(), getMET(), getMT2(el1,el2,Elec), ElPt[el1], ElPt[el2], ElCharge[el1]) << endl ;
+				if(reg == gRegion[gBaseRegion]){
+					fOUTSTREAM << Form("%12s: ElEl - run %6.0d / ls %5.0d / ev %11.0d - HT(#J/#bJ) %6.2f(%1d/%1d) MET %6.2f MT2 %6.2f Pt1 %6.2f Pt2 %6.2f Charge %2d", S->sname.Data(), Run, LumiSec, Event, getHT(), getNJets(), getNBTags(), getMET(), getMT2(el1,el2,Elec), ElPt[el1], ElPt[el2], ElCharge[el1]) << endl ;
+				}
 			}
-			if(  isTightElectron(el) && !isTightMuon(mu) ){ // Loose-tight
-				if( isBarrelElectron(el)) S->region[reg][HighPt].em.nt01_OS_BB_pt->Fill(MuPt[mu], ElPt[el], gEventWeight);
-				if(!isBarrelElectron(el)) S->region[reg][HighPt].em.nt01_OS_EE_pt->Fill(MuPt[mu], ElPt[el], gEventWeight);
+			if(S->datamc > 0 ){
+				S->region[reg][HighPt].ee.nt11_origin->Fill(elIndexToBin(el1)-0.5, elIndexToBin(el2)-0.5, gEventWeight);
+				if(isPromptElectron(el1) && isPromptElectron(el2)){
+					S->region[reg][HighPt].ee.nt2pp_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
+					if(!isChargeMatchedElectron(el1) || !isChargeMatchedElectron(el2)){
+						S->region[reg][HighPt].ee.nt2pp_cm_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);							
+					}
+				}
+				if(isPromptElectron(el1) &&   isFakeElectron(el2)) S->region[reg][HighPt].ee.nt2pf_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
+				if(  isFakeElectron(el1) && isPromptElectron(el2)) S->region[reg][HighPt].ee.nt2fp_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
+				if(  isFakeElectron(el1) &&   isFakeElectron(el2)) S->region[reg][HighPt].ee.nt2ff_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
 			}
-			if( !isTightElectron(el) && !isTightMuon(mu) ){ // Loose-loose
-				if( isBarrelElectron(el)) S->region[reg][HighPt].em.nt00_OS_BB_pt->Fill(MuPt[mu], ElPt[el], gEventWeight);
-				if(!isBarrelElectron(el)) S->region[reg][HighPt].em.nt00_OS_EE_pt->Fill(MuPt[mu], ElPt[el], gEventWeight);
+		}
+		if(  isTightElectron(el1) && !isTightElectron(el2) ){ // Tight-loose
+			if(fDoCounting) fCounter[Elec].fill(fEECuts[15]);
+			S->region[reg][HighPt].ee.nt10_pt ->Fill(ElPt [el1], ElPt [el2], gEventWeight);
+			S->region[reg][HighPt].ee.nt10_eta->Fill(fabs(ElEta[el1]), fabs(ElEta[el2]), gEventWeight);
+			if(S->datamc > 0) S->region[reg][HighPt].ee.nt10_origin->Fill(elIndexToBin(el1)-0.5, elIndexToBin(el2)-0.5, gEventWeight);
+		}
+		if( !isTightElectron(el1) &&  isTightElectron(el2) ){ // Loose-tight
+			if(fDoCounting) fCounter[Elec].fill(fEECuts[16]);
+			S->region[reg][HighPt].ee.nt10_pt ->Fill(ElPt [el2], ElPt [el1], gEventWeight); // tight one always in x axis; fill same again
+			S->region[reg][HighPt].ee.nt10_eta->Fill(fabs(ElEta[el2]), fabs(ElEta[el2]), gEventWeight);
+			if(S->datamc > 0) S->region[reg][HighPt].ee.nt10_origin->Fill(elIndexToBin(el2)-0.5, elIndexToBin(el1)-0.5, gEventWeight);
+		}
+		if( !isTightElectron(el1) && !isTightElectron(el2) ){ // Loose-loose
+			S->region[reg][HighPt].ee.nt00_pt ->Fill(ElPt [el1], ElPt [el2], gEventWeight);
+			S->region[reg][HighPt].ee.nt00_eta->Fill(fabs(ElEta[el1]), fabs(ElEta[el2]), gEventWeight);
+			if(S->datamc > 0) S->region[reg][HighPt].ee.nt00_origin->Fill(elIndexToBin(el1)-0.5, elIndexToBin(el2)-0.5, gEventWeight);
+		}
+		if(S->datamc > 0 ){
+			if(isPromptElectron(el1) && isPromptElectron(el2)){
+				S->region[reg][HighPt].ee.npp_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
+				if(!isChargeMatchedElectron(el1) || !isChargeMatchedElectron(el2)){
+					S->region[reg][HighPt].ee.npp_cm_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);							
+				}
 			}
+			if(isPromptElectron(el1) &&   isFakeElectron(el2)) S->region[reg][HighPt].ee.npf_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
+			if(  isFakeElectron(el1) && isPromptElectron(el2)) S->region[reg][HighPt].ee.nfp_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
+			if(  isFakeElectron(el1) &&   isFakeElectron(el2)) S->region[reg][HighPt].ee.nff_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
 		}
+	}
+	if(chan == ElMu){
+		const int mu(ind1), el(ind2);
+		if(  isTightElectron(el) &&  isTightMuon(mu) ){ // Tight-tight
+			if(fDoCounting) fCounter[ElMu].fill(fEMCuts[15]);
+			if(fDoCounting) fCounter[ElMu].fill(fEMCuts[16]);
+			if(fDoCounting) fCounter[ElMu].fill(fEMCuts[17]);
+			S->region[reg][HighPt].em.nt20_pt ->Fill(MuPt [mu], ElPt [el], gEventWeight);
+			S->region[reg][HighPt].em.nt20_eta->Fill(fabs(MuEta[mu]), fabs(ElEta[el]), gEventWeight);
+			if(S->datamc == 0){
+			  //SIGEVENTS PRINTOUT	gRegions[reg]->regionOutstream << Form("%12s: ElMu - run %6.0d / ls %5.0d / ev %11.0d - HT(#J/#bJ) %6.2f(%1d/%1d) MET %6.2f MT2 %6.2f Pt1 %6.2f Pt2 %6.2f Charge %2d", S->sname.Data(), Run, LumiSec, Event, getHT(), getNJets(), getNBTags(), getMET(), getMT2(mu,el,ElMu), MuPt[mu], ElPt[el], ElCharge[el]) << endl;
+				if(reg == gRegion[gBaseRegion]){
+					fOUTSTREAM << Form("%12s: ElMu - run %6.0d / ls %5.0d / ev %11.0d - HT(#J/#bJ) %6.2f(%1d/%1d) MET %6.2f MT2 %6.2f Pt1 %6.2f Pt2 %6.2f Charge %2d", S->sname.Data(), Run, LumiSec, Event, getHT(), getNJets(), getNBTags(), getMET(), getMT2(mu,el,ElMu), MuPt[mu], ElPt[el], ElCharge[el]) << endl;
+				}
+			}
+			
+			if(S->datamc > 0){
+				S->region[reg][HighPt].em.nt11_origin->Fill(muIndexToBin(mu)-0.5, elIndexToBin(el)-0.5, gEventWeight);
+				if(isPromptMuon(mu) && isPromptElectron(el)) S->region[reg][HighPt].em.nt2pp_pt->Fill(MuPt[mu], ElPt[el], gEventWeight);
+				if(isPromptMuon(mu) &&   isFakeElectron(el)) S->region[reg][HighPt].em.nt2pf_pt->Fill(MuPt[mu], ElPt[el], gEventWeight);
+				if(  isFakeMuon(mu) && isPromptElectron(el)) S->region[reg][HighPt].em.nt2fp_pt->Fill(MuPt[mu], ElPt[el], gEventWeight);
+				if(  isFakeMuon(mu) &&   isFakeElectron(el)) S->region[reg][HighPt].em.nt2ff_pt->Fill(MuPt[mu], ElPt[el], gEventWeight);
+			}
+		}
+		if( !isTightElectron(el) &&  isTightMuon(mu) ){ // Tight-loose
+			if(fDoCounting) fCounter[ElMu].fill(fEMCuts[15]);
+			S->region[reg][HighPt].em.nt10_pt ->Fill(MuPt [mu], ElPt [el], gEventWeight);
+			S->region[reg][HighPt].em.nt10_eta->Fill(fabs(MuEta[mu]), fabs(ElEta[el]), gEventWeight);
+			if(S->datamc > 0) S->region[reg][HighPt].em.nt10_origin->Fill(muIndexToBin(mu)-0.5, elIndexToBin(el)-0.5, gEventWeight);
+		}
+		if(  isTightElectron(el) && !isTightMuon(mu) ){ // Loose-tight
+			if(fDoCounting) fCounter[ElMu].fill(fEMCuts[16]);
+			S->region[reg][HighPt].em.nt01_pt ->Fill(MuPt [mu], ElPt [el], gEventWeight); // muon always in x axis for e/mu
+			S->region[reg][HighPt].em.nt01_eta->Fill(fabs(MuEta[mu]), fabs(ElEta[el]), gEventWeight);
+			if(S->datamc > 0) S->region[reg][HighPt].em.nt01_origin->Fill(muIndexToBin(mu)-0.5, elIndexToBin(el)-0.5, gEventWeight);
+		}
+		if( !isTightElectron(el) && !isTightMuon(mu) ){ // Loose-loose
+			S->region[reg][HighPt].em.nt00_pt ->Fill(MuPt [mu], ElPt [el], gEventWeight);
+			S->region[reg][HighPt].em.nt00_eta->Fill(fabs(MuEta[mu]), fabs(ElEta[el]), gEventWeight);
+			if(S->datamc > 0) S->region[reg][HighPt].em.nt00_origin->Fill(muIndexToBin(mu)-0.5, elIndexToBin(el)-0.5, gEventWeight);
+		}
+		if(S->datamc > 0){
+			if(isPromptMuon(mu) && isPromptElectron(el)) S->region[reg][HighPt].em.npp_pt->Fill(MuPt[mu], ElPt[el], gEventWeight);
+			if(isPromptMuon(mu) &&   isFakeElectron(el)) S->region[reg][HighPt].em.npf_pt->Fill(MuPt[mu], ElPt[el], gEventWeight);
+			if(  isFakeMuon(mu) && isPromptElectron(el)) S->region[reg][HighPt].em.nfp_pt->Fill(MuPt[mu], ElPt[el], gEventWeight);
+			if(  isFakeMuon(mu) &&   isFakeElectron(el)) S->region[reg][HighPt].em.nff_pt->Fill(MuPt[mu], ElPt[el], gEventWeight);
+		}
+	}
+}
+//____________________________________________________________________________
+void SSDLDumper::fillOSYields(Sample *S, int reg, gChannel chan, int ind1, int ind2){
+	// Opposite-sign yields of region reg for the selected pair
+	if(chan == Elec){
+		const int el1(ind1), el2(ind2);
+		if(  isTightElectron(el1) &&  isTightElectron(el2) ){ // Tight-tight
+			if( isBarrelElectron(el1) &&  isBarrelElectron(el2)) S->region[reg][HighPt].ee.nt20_OS_BB_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
+			if(!isBarrelElectron(el1) && !isBarrelElectron(el2)) S->region[reg][HighPt].ee.nt20_OS_EE_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
+			if( isBarrelElectron(el1) && !isBarrelElectron(el2)) S->region[reg][HighPt].ee.nt20_OS_EB_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
+			if(!isBarrelElectron(el1) &&  isBarrelElectron(el2)) S->region[reg][HighPt].ee.nt20_OS_EB_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
+		}
+		if(  isTightElectron(el1) && !isTightElectron(el2) ){ // Tight-loose
+			if( isBarrelElectron(el1) &&  isBarrelElectron(el2)) S->region[reg][HighPt].ee.nt10_OS_BB_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
+			if(!isBarrelElectron(el1) && !isBarrelElectron(el2)) S->region[reg][HighPt].ee.nt10_OS_EE_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
+			if( isBarrelElectron(el1) && !isBarrelElectron(el2)) S->region[reg][HighPt].ee.nt10_OS_EB_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
+			if(!isBarrelElectron(el1) &&  isBarrelElectron(el2)) S->region[reg][HighPt].ee.nt10_OS_EB_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
+		}
+		if( !isTightElectron(el1) &&  isTightElectron(el2) ){ // Loose-tight
+			if( isBarrelElectron(el1) &&  isBarrelElectron(el2)) S->region[reg][HighPt].ee.nt01_OS_BB_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
+			if(!isBarrelElectron(el1) && !isBarrelElectron(el2)) S->region[reg][HighPt].ee.nt01_OS_EE_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
+			if( isBarrelElectron(el1) && !isBarrelElectron(el2)) S->region[reg][HighPt].ee.nt01_OS_EB_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
+			if(!isBarrelElectron(el1) &&  isBarrelElectron(el2)) S->region[reg][HighPt].ee.nt01_OS_EB_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
+		}
+		if( !isTightElectron(el1) && !isTightElectron(el2) ){ // Loose-loose
+			if( isBarrelElectron(el1) &&  isBarrelElectron(el2)) S->region[reg][HighPt].ee.nt00_OS_BB_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
+			if(!isBarrelElectron(el1) && !isBarrelElectron(el2)) S->region[reg][HighPt].ee.nt00_OS_EE_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
+			if( isBarrelElectron(el1) && !isBarrelElectron(el2)) S->region[reg][HighPt].ee.nt00_OS_EB_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
+			if(!isBarrelElectron(el1) &&  isBarrelElectron(el2)) S->region[reg][HighPt].ee.nt00_OS_EB_pt->Fill(ElPt[el1], ElPt[el2], gEventWeight);
+		}
+	}
+	if(chan == ElMu){
+		const int mu(ind1), el(ind2);
+		if(  isTightElectron(el) &&  isTightMuon(mu) ){ // Tight-tight
+			if( isBarrelElectron(el)) S->region[reg][HighPt].em.nt20_OS_BB_pt->Fill(MuPt[mu], ElPt[el], gEventWeight);
+			if(!isBarrelElectron(el)) S->region[reg][HighPt].em.nt20_OS_EE_pt->Fill(MuPt[mu], ElPt[el], gEventWeight);
+		}
+		if( !isTightElectron(el) &&  isTightMuon(mu) ){ // Tight-loose
+			if( isBarrelElectron(el)) S->region[reg][HighPt].em.nt10_OS_BB_pt->Fill(MuPt[mu], ElPt[el], gEventWeight);
+			if(!isBarrelElectron(el)) S->region[reg][HighPt].em.nt10_OS_EE_pt->Fill(MuPt[mu], ElPt[el], gEventWeight);
+		}
+		if(  isTightElectron(el) && !isTightMuon(mu) ){ // Loose-tight
+			if( isBarrelElectron(el)) S->region[reg][HighPt].em.nt01_OS_BB_pt->Fill(MuPt[mu], ElPt[el], gEventWeight);
+			if(!isBarrelElectron(el)) S->region[reg][HighPt].em.nt01_OS_EE_pt->Fill(MuPt[mu], ElPt[el], gEventWeight);
+		}
+		if( !isTightElectron(el) && !isTightMuon(mu) ){ // Loose-loose
+			if( isBarrelElectron(el)) S->region[reg][HighPt].em.nt00_OS_BB_pt->Fill(MuPt[mu], ElPt[el], gEventWeight);
+			if(!isBarrelElectron(el)) S->region[reg][HighPt].em.nt00_OS_EE_pt->Fill(MuPt[mu], ElPt[el], gEventWeight);
+		}
+	}
+}
+//____________________________________________________________________________
+// Region engine: the selection of fillYields for all regions in one go.
+// Lepton selection, jet cleaning and vetoes only depend on the second lepton
+// pt cuts of a region and on the inverted Z veto of WZEnriched, so the five
+// lepton pairs are selected once for each group of regions sharing these,
+// and each region of the group is a set of cuts on the stored pairs. The
+// yields, the printout and the cut flow are those of fillYields.
+void SSDLDumper::makeRegionGroups(){
+	const int wzreg = gRegion["WZEnriched"];
+	fRegionGroups.clear();
+	fRegionGroupOf.assign(gRegions.size(), -1);
+	for(size_t reg = 0; reg < gRegions.size(); ++reg){
+		const Region *R = gRegions[reg];
+		size_t g = 0;
+		for(; g < fRegionGroups.size(); ++g){
+			const int first = fRegionGroups[g].regions[0];
+			if(gRegions[first]->minMu2pt != R->minMu2pt) continue;
+			if(gRegions[first]->minEl2pt != R->minEl2pt) continue;
+			if((first == wzreg) != ((int)reg == wzreg))  continue;
+			break;
+		}
+		if(g == fRegionGroups.size()){
+			fRegionGroups.push_back(RegionGroup());
+			fRegionGroups[g].need3rdVet = false;
+			fRegionGroups[g].needTTZSel = false;
+		}
+		fRegionGroups[g].regions.push_back(reg);
+		if(R->app3rdVet)  fRegionGroups[g].need3rdVet = true;
+		if(R->vetoTTZSel) fRegionGroups[g].needTTZSel = true;
+		fRegionGroupOf[reg] = g;
+	}
+	for(int h = 0; h < gNYieldHyps; ++h) fRegionMask[h].assign(gRegions.size(), false);
+}
+SSDLDumper::HypObs SSDLDumper::getHypObs(){
+	HypObs obs;
+	obs.njets  = getNJets();
+	obs.nbjets = getNBTags();
+	obs.nbjmed = getNBTagsMed();
+	obs.ht     = getHT();
+	obs.met    = getMET();
+	return obs;
+}
+void SSDLDumper::selectHyp(Sample *S, LepHyp &H, gChannel chan, bool os, const RegionGroup &group){
+	// Everything isSSLLMuEvent, isSSLLElEvent and isSSLLElMuEvent look at
+	// before the region cuts, in the same order. Needs the cuts of the group
+	// to be set.
+	H.nlep1 = H.nlep2 = 0;
+	H.ind1  = H.ind2  = -1;
+	H.pair    = 0;
+	H.zveto   = H.lowmass = H.veto3rd = H.ttzsel = false;
+	H.weight  = 1.;
+	resetHypLeptons();
+
+	if(chan == Muon){
+		H.nlep1 = hasLooseMuons(H.ind1, H.ind2);
+		if(H.nlep1 < 2) return;
+		H.pair = os ? isOSLLEvent(H.ind1, H.ind2) : isSSLLEvent(H.ind1, H.ind2);
+		if(abs(H.pair) != 1) return;
+	}
+	if(chan == Elec){
+		H.nlep1 = hasLooseElectrons(H.ind1, H.ind2);
+		if(H.nlep1 < 2) return;
+		H.pair = os ? isOSLLEvent(H.ind1, H.ind2) : isSSLLEvent(H.ind1, H.ind2);
+		if(abs(H.pair) != 2) return;
+	}
+	if(chan == ElMu){
+		H.nlep1 = hasLooseMuons(H.ind1, H.ind2);
+		H.nlep2 = hasLooseElectrons(H.ind2, H.ind1);
+		if(H.nlep1 < 1 || H.nlep2 < 1) return;
+		H.pair = os ? isOSLLEvent(H.ind1, H.ind2) : isSSLLEvent(H.ind1, H.ind2);
+		if(abs(H.pair) != 3) return;
+	}
+
+	setHypLepton1(H.ind1, chan == Elec ? Elec : Muon);
+	setHypLepton2(H.ind2, chan == Muon ? Muon : Elec);
+
+	H.zveto = os || passesZVeto(); // no Z veto for OS, see isSSLLMuEvent
+	if(H.zveto){
+		if(chan == Muon) H.lowmass = passesMllEventVeto(H.ind1, H.ind2, 1, 8.) && passesGammaStarVeto(H.ind1, H.ind2, 0);
+		if(chan == Elec) H.lowmass = passesMllEventVeto(H.ind1, H.ind2, 2, 8.) && passesGammaStarVeto(H.ind1, H.ind2, 2);
+		if(chan == ElMu) H.lowmass = !(getMll(H.ind1, H.ind2, ElMu) < 8.)  && passesGammaStarVeto(H.ind1, H.ind2, 1);
+	}
+	if(!H.lowmass){
 		resetHypLeptons();
+		return;
 	}
-	fChargeSwitch = 0;
+
+	if(group.need3rdVet) H.veto3rd = passes3rdLepVeto();
+	H.obs    = getHypObs();
+	H.weight = getSF(S, chan, H.ind1, H.ind2);
+	if(group.needTTZSel){
+		// the jets of regions with the ttZ veto are cleaned against the
+		// leptons passesTTZSel leaves behind
+		H.ttzsel = passesTTZSel();
+		H.obsTTZ = getHypObs();
+	}
+	resetHypLeptons();
+}
+bool SSDLDumper::passesRegion(const LepHyp &H, gChannel chan, bool os, int reg, bool count){
+	// Region cuts of isSSLLMuEvent, isSSLLElEvent and isSSLLElMuEvent on a
+	// pair from selectHyp, count fills the cut flow as they do
+	const Region *R = gRegions[reg];
+	Monitor &counter = fCounter[chan];
+	const vector<Monitor::Handle> &cuts = (chan == Muon) ? fMMCuts : (chan == Elec) ? fEECuts : fEMCuts;
+	const int type = (chan == Muon) ? 1 : (chan == Elec) ? 2 : 3;
+
+	if(chan == ElMu){
+		if(H.nlep1 > 0 && count) counter.fill(cuts[3]);
+		if(H.nlep2 > 0 && count) counter.fill(cuts[4]);
+		if(H.nlep1 < 1 || H.nlep2 < 1) return false;
+		if(count) counter.fill(cuts[5]);
+	}
+	else{
+		if(H.nlep1 < 1) return false;
+		if(count) counter.fill(cuts[3]);
+		if(H.nlep1 < 2) return false;
+		if(count) counter.fill(cuts[4]);
+	}
+
+	if(abs(H.pair) != type) return false;
+	if(!os && R->chargeVeto > 0 && H.pair < 0) return false; // passesChVeto
+	if(!os && R->chargeVeto < 0 && H.pair > 0) return false;
+	if(count && (!os || chan == ElMu)) counter.fill(cuts[chan == ElMu ? 6 : 5]);
+
+	if(!os){
+		if(!H.zveto) return false;
+		if(count) counter.fill(cuts[chan == ElMu ? 7 : 6]);
+	}
+
+	if(!H.lowmass) return false;
+	if(count && chan != ElMu) counter.fill(cuts[7]);
+
+	if(R->app3rdVet && !H.veto3rd) return false;
+	if(count) counter.fill(cuts[8]);
+
+	if(R->vetoTTZSel && H.ttzsel) return false;
+	const HypObs &obs = R->vetoTTZSel ? H.obsTTZ : H.obs;
+
+	if(obs.njets < R->minNjets || obs.njets > R->maxNjets) return false;
+	if(count) counter.fill(cuts[9]);
+
+	if(obs.nbjets < R->minNbjets || obs.nbjmed < R->minNbjmed) return false;
+	if(obs.nbjets > R->maxNbjets || obs.nbjmed > R->maxNbjmed) return false;
+	if(count) counter.fill(cuts[10]);
+
+	if(!passesHTCut(R->minHT, R->maxHT, obs.ht)) return false;
+	if(count) counter.fill(cuts[11]);
+
+	if(!passesMETCut(R->minMet, R->maxMet, obs.met, obs.ht)) return false;
+	if(count) counter.fill(cuts[12]);
+
+	// pt cuts, as isGoodPrimMuon/isGoodSecMuon with the cuts of reg
+	if(chan == Muon){
+		if(!isLooseMuon(H.ind2) || MuPt[H.ind2] < R->minMu2pt) return false;
+		if(count) counter.fill(cuts[13]);
+		if(!isLooseMuon(H.ind1) || MuPt[H.ind1] < R->minMu1pt) return false;
+		if(count) counter.fill(cuts[14]);
+	}
+	if(chan == Elec){
+		if(!isLooseElectron(H.ind2) || ElPt[H.ind2] < R->minEl2pt) return false;
+		if(count) counter.fill(cuts[13]);
+		if(!isLooseElectron(H.ind1) || ElPt[H.ind1] < R->minEl1pt) return false;
+		if(count) counter.fill(cuts[14]);
+	}
+	if(chan == ElMu){
+		const int mu(H.ind1), el(H.ind2);
+		if(MuPt[mu] > ElPt[el]){
+			if(!isLooseMuon(mu)     || MuPt[mu] < R->minMu1pt) return false;
+			if(count) counter.fill(cuts[13]);
+			if(!isLooseElectron(el) || ElPt[el] < R->minEl2pt) return false;
+			if(count) counter.fill(cuts[14]);
+		}
+		else if(MuPt[mu] < ElPt[el]){
+			if(!isLooseElectron(el) || ElPt[el] < R->minEl1pt) return false;
+			if(count) counter.fill(cuts[14]);
+			if(!isLooseMuon(mu)     || MuPt[mu] < R->minMu2pt) return false;
+			if(count) counter.fill(cuts[13]);
+		}
+	}
+	return true;
+}
+void SSDLDumper::fillRegionYields(Sample *S){
+	// Same as calling fillYields for every region in gRegions
+	static const gChannel chan[gNYieldHyps] = {Muon, Elec, ElMu, Elec, ElMu};
+	const bool mmtrig = mumuSignalTrigger();
+	const bool eetrig = elelSignalTrigger();
+	const bool emtrig = elmuSignalTrigger();
+	const bool passtrig[gNYieldHyps] = {mmtrig, eetrig, emtrig, eetrig, emtrig};
+	const int base = gRegion[gBaseRegion];
+	const vector<Monitor::Handle> *cuts[gNYieldHyps] = {&fMMCuts, &fEECuts, &fEMCuts, &fEECuts, &fEMCuts};
+
+	// Select the pairs of each group and find the regions they pass
 	fDoCounting = false;
+	for(size_t g = 0; g < fRegionGroups.size(); ++g){
+		RegionGroup &group = fRegionGroups[g];
+		setRegionCuts(group.regions[0]);
+		for(int h = 0; h < gNYieldHyps; ++h){
+			if(!passtrig[h]) continue;
+			fCurrentChannel = chan[h];
+			fChargeSwitch   = (h < 3) ? 0 : 1;
+			selectHyp(S, group.hyp[h], chan[h], h >= 3, group);
+		}
+		for(size_t i = 0; i < group.regions.size(); ++i){
+			const int reg = group.regions[i];
+			const bool count = (reg == base);
+			for(int h = 0; h < gNYieldHyps; ++h){
+				fRegionMask[h][reg] = false;
+				if(!passtrig[h]) continue;
+				if(count && h < 3) fCounter[chan[h]].fill((*cuts[h])[2]);
+				fRegionMask[h][reg] = passesRegion(group.hyp[h], chan[h], h >= 3, reg, count && h < 3);
+			}
+		}
+	}
+
+	// Fill in the order of fillYields
+	for(size_t reg = 0; reg < gRegions.size(); ++reg){
+		bool pass = false;
+		for(int h = 0; h < gNYieldHyps; ++h) pass |= fRegionMask[h][reg];
+		if(!pass) continue;
+
+		setRegionCuts(reg);
+		const RegionGroup &group = fRegionGroups[fRegionGroupOf[reg]];
+		for(int h = 0; h < gNYieldHyps; ++h){
+			if(!fRegionMask[h][reg]) continue;
+			const LepHyp &H = group.hyp[h];
+			fDoCounting     = (h < 3 && (int)reg == base);
+			fCurrentChannel = chan[h];
+			fChargeSwitch   = (h < 3) ? 0 : 1;
+			resetHypLeptons();
+			setHypLepton1(H.ind1, chan[h] == Elec ? Elec : Muon);
+			setHypLepton2(H.ind2, chan[h] == Muon ? Muon : Elec);
+			if(gRegions[reg]->vetoTTZSel) passesTTZSel(); // hyp leptons as isSSLL*Event leaves them
+			gEventWeight = H.weight;
+			if(h < 3) fillSSYields(S, reg, chan[h], H.ind1, H.ind2);
+			else      fillOSYields(S, reg, chan[h], H.ind1, H.ind2);
+			resetHypLeptons();
+		}
+	}
+
+	if(!gRegions.empty()) setRegionCuts(gRegions.size()-1);
+	fChargeSwitch   = 0;
+	fDoCounting     = false;
+	fCurrentChannel = ElMu;
 	resetHypLeptons();
 }
+//____________________________________________________________________________
 void SSDLDumper::fillDiffYields(Sample *S){
 	// {  0 ,   1  ,    2   ,   3  ,   4  ,   5  ,    6    ,   7   ,   8   ,      9     ,     10      }
 	// {"HT", "MET", "NJets", "MT2", "PT1", "PT2", "NBJets", "MET2", "MET3", "NBJetsMed", "NBJetsMed2"}
@@ -2604,17 +3180,17 @@ void SSDLDumper::fillPuritiesCounters(Sample *S){
 	fCurrentChannel = Muon;
 	int mu1(-1), mu2(-1);
 	if(mumuSignalTrigger()){ // Trigger selection
-	        fCounterPurities[Muon].fill(fPuritiesCutNames[0]);
+	        fCounterPurities[Muon].fill(fPuritiesCuts[0]);
 		if(isSSLLMuEvent(mu1, mu2)){
-		        fCounterPurities[Muon].fill(fPuritiesCutNames[1]);
+		        fCounterPurities[Muon].fill(fPuritiesCuts[1]);
 			if(  isTightMuon(mu1) &&  isTightMuon(mu2) ){ // Tight-tight
-				fCounterPurities[Muon].fill(fPuritiesCutNames[2]);  
+				fCounterPurities[Muon].fill(fPuritiesCuts[2]);  
 			}  
 		}
 		resetHypLeptons();
 		fChargeSwitch = 1;
 		if(isSSLLMuEvent(mu1, mu2)){
-			fCounterPurities[Muon].fill(fPuritiesCutNames[3]); 
+			fCounterPurities[Muon].fill(fPuritiesCuts[3]); 
 		}
 		fChargeSwitch = 0;
 	}
@@ -2623,17 +3199,17 @@ void SSDLDumper::fillPuritiesCounters(Sample *S){
 	fCurrentChannel = Elec;
 	int el1(-1), el2(-1);
 	if(elelSignalTrigger()){ // Trigger selection
-	        fCounterPurities[Elec].fill(fPuritiesCutNames[0]);
+	        fCounterPurities[Elec].fill(fPuritiesCuts[0]);
 		if(isSSLLElEvent(el1, el2)){
-		        fCounterPurities[Elec].fill(fPuritiesCutNames[1]);
+		        fCounterPurities[Elec].fill(fPuritiesCuts[1]);
 			if(  isTightElectron(el1) &&  isTightElectron(el2) ){ // Tight-tight
-				fCounterPurities[Elec].fill(fPuritiesCutNames[2]);  
+				fCounterPurities[Elec].fill(fPuritiesCuts[2]);  
 			}  
 		}
 		resetHypLeptons();
 		fChargeSwitch = 1;
 		if(isSSLLElEvent(el1, el2)){
-			fCounterPurities[Elec].fill(fPuritiesCutNames[3]); 
+			fCounterPurities[Elec].fill(fPuritiesCuts[3]); 
 		}
 		fChargeSwitch = 0;
 	}
@@ -2642,17 +3218,17 @@ void SSDLDumper::fillPuritiesCounters(Sample *S){
 	fCurrentChannel = ElMu;
 	int mu(-1), el(-1);
 	if(elmuSignalTrigger()){ // Trigger selection
-	        fCounterPurities[ElMu].fill(fPuritiesCutNames[0]);
+	        fCounterPurities[ElMu].fill(fPuritiesCuts[0]);
 		if(isSSLLElMuEvent(mu, el)){
-		        fCounterPurities[ElMu].fill(fPuritiesCutNames[1]);
+		        fCounterPurities[ElMu].fill(fPuritiesCuts[1]);
 			if(  isTightElectron(el) &&  isTightMuon(mu) ){ // Tight-tight
-				fCounterPurities[ElMu].fill(fPuritiesCutNames[2]);  
+				fCounterPurities[ElMu].fill(fPuritiesCuts[2]);  
 			}  
 		}
 		resetHypLeptons();
 		fChargeSwitch = 1;
 		if(isSSLLElMuEvent(mu, el)){
-			fCounterPurities[ElMu].fill(fPuritiesCutNames[3]); 
+			fCounterPurities[ElMu].fill(fPuritiesCuts[3]); 
 		}
 		fChargeSwitch = 0;
 	}
@@ -2667,25 +3243,25 @@ void SSDLDumper::fillSyncCounters(Sample *S){
   fCurrentChannel = Muon;
   int mu1(-1), mu2(-1);
   if(abs(isOSLLEvent(mu1, mu2)) == 1) {
-    fCounterSync[Muon].fill(fSyncCutNames[0]);
+    fCounterSync[Muon].fill(fSyncCuts[0]);
     
     if ((S->sname).Contains("DoubleMu"))
       fOUTSTREAM << Run <<" "<< LumiSec <<" "<< Event <<" "<< getNJets() <<" "
 		 << getNBTagsMed() <<" "<< (pfMET>10) <<" "<<mumuSignalTrigger() <<" "<< elelSignalTrigger() 
 		 <<" "<< elmuSignalTrigger() << endl;
     
-    if (mumuSignalTrigger()) fCounterSync[Muon].fill(fSyncCutNames[1]);
+    if (mumuSignalTrigger()) fCounterSync[Muon].fill(fSyncCuts[1]);
     
     setHypLepton1(mu1, Muon);
     setHypLepton2(mu2, Muon);
     
-    if (getNBTagsMed() == 0) fCounterSync[Muon].fill(fSyncCutNames[2]);
-    if (getNJets() == 0)     fCounterSync[Muon].fill(fSyncCutNames[3]);
-    if (getNJets() == 1)     fCounterSync[Muon].fill(fSyncCutNames[4]);
-    if (getNJets() >= 2)     fCounterSync[Muon].fill(fSyncCutNames[5]);
+    if (getNBTagsMed() == 0) fCounterSync[Muon].fill(fSyncCuts[2]);
+    if (getNJets() == 0)     fCounterSync[Muon].fill(fSyncCuts[3]);
+    if (getNJets() == 1)     fCounterSync[Muon].fill(fSyncCuts[4]);
+    if (getNJets() >= 2)     fCounterSync[Muon].fill(fSyncCuts[5]);
     
-    if (pfMET      > 10)     fCounterSync[Muon].fill(fSyncCutNames[6]);
-    if (pfMETType1 > 10)     fCounterSync[Muon].fill(fSyncCutNames[7]);
+    if (pfMET      > 10)     fCounterSync[Muon].fill(fSyncCuts[6]);
+    if (pfMETType1 > 10)     fCounterSync[Muon].fill(fSyncCuts[7]);
   }
   //////////////////////////////////////////////////////////////////
   
@@ -2694,23 +3270,23 @@ void SSDLDumper::fillSyncCounters(Sample *S){
   resetHypLeptons();
   int el1(-1), el2(-1);
   if(abs(isOSLLEvent(el1, el2)) == 2) {
-    fCounterSync[Elec].fill(fSyncCutNames[0]);
+    fCounterSync[Elec].fill(fSyncCuts[0]);
     if ((S->sname).Contains("DoubleEl"))
       fOUTSTREAM << Run <<" "<< LumiSec <<" "<< Event <<" "<< getNJets() <<" "
 		 << getNBTagsMed() <<" "<< (pfMET>10) <<" "<<mumuSignalTrigger() <<" "<< elelSignalTrigger() 
 		 <<" "<< elmuSignalTrigger() << endl;
     
-    if (elelSignalTrigger()) fCounterSync[Elec].fill(fSyncCutNames[1]);
+    if (elelSignalTrigger()) fCounterSync[Elec].fill(fSyncCuts[1]);
     setHypLepton1(el1, Elec);
     setHypLepton2(el2, Elec);
     
-    if (getNBTagsMed() == 0) fCounterSync[Elec].fill(fSyncCutNames[2]);
-    if (getNJets() == 0)     fCounterSync[Elec].fill(fSyncCutNames[3]);
-    if (getNJets() == 1)     fCounterSync[Elec].fill(fSyncCutNames[4]);
-    if (getNJets() >= 2)     fCounterSync[Elec].fill(fSyncCutNames[5]);
+    if (getNBTagsMed() == 0) fCounterSync[Elec].fill(fSyncCuts[2]);
+    if (getNJets() == 0)     fCounterSync[Elec].fill(fSyncCuts[3]);
+    if (getNJets() == 1)     fCounterSync[Elec].fill(fSyncCuts[4]);
+    if (getNJets() >= 2)     fCounterSync[Elec].fill(fSyncCuts[5]);
     
-    if (pfMET      > 10)     fCounterSync[Elec].fill(fSyncCutNames[6]);
-    if (pfMETType1 > 10)     fCounterSync[Elec].fill(fSyncCutNames[7]);
+    if (pfMET      > 10)     fCounterSync[Elec].fill(fSyncCuts[6]);
+    if (pfMETType1 > 10)     fCounterSync[Elec].fill(fSyncCuts[7]);
   }
   //////////////////////////////////////////////////////////////////
   
@@ -2719,23 +3295,23 @@ void SSDLDumper::fillSyncCounters(Sample *S){
   int mu(-1), el(-1);
   resetHypLeptons();
   if(abs(isOSLLEvent(mu, el)) == 3) {
-    fCounterSync[ElMu].fill(fSyncCutNames[0]);
+    fCounterSync[ElMu].fill(fSyncCuts[0]);
     if ((S->sname).Contains("MuEG"))
       fOUTSTREAM << Run <<" "<< LumiSec <<" "<< Event <<" "<< getNJets() <<" "
 		 << getNBTagsMed() <<" "<< (pfMET>10) <<" "<<mumuSignalTrigger() <<" "<< elelSignalTrigger() 
 		 <<" "<< elmuSignalTrigger() << endl;
-    if (elmuSignalTrigger()) fCounterSync[ElMu].fill(fSyncCutNames[1]);
+    if (elmuSignalTrigger()) fCounterSync[ElMu].fill(fSyncCuts[1]);
     
     setHypLepton1(mu, Muon);
     setHypLepton2(el, Elec);
     
-    if (getNBTagsMed() == 0) fCounterSync[ElMu].fill(fSyncCutNames[2]);
-    if (getNJets() == 0)     fCounterSync[ElMu].fill(fSyncCutNames[3]);
-    if (getNJets() == 1)     fCounterSync[ElMu].fill(fSyncCutNames[4]);
-    if (getNJets() >= 2)     fCounterSync[ElMu].fill(fSyncCutNames[5]);
+    if (getNBTagsMed() == 0) fCounterSync[ElMu].fill(fSyncCuts[2]);
+    if (getNJets() == 0)     fCounterSync[ElMu].fill(fSyncCuts[3]);
+    if (getNJets() == 1)     fCounterSync[ElMu].fill(fSyncCuts[4]);
+    if (getNJets() >= 2)     fCounterSync[ElMu].fill(fSyncCuts[5]);
     
-    if (pfMET      > 10)     fCounterSync[ElMu].fill(fSyncCutNames[6]);
-    if (pfMETType1 > 10)     fCounterSync[ElMu].fill(fSyncCutNames[7]);
+    if (pfMET      > 10)     fCounterSync[ElMu].fill(fSyncCuts[6]);
+    if (pfMETType1 > 10)     fCounterSync[ElMu].fill(fSyncCuts[7]);
   }
   //////////////////////////////////////////////////////////////////
 
@@ -2848,104 +3424,34 @@ void SSDLDumper::initCutNames(){
 	fPuritiesCutNames.push_back(" Used OS      "); //3
 
 }
+void SSDLDumper::resetCounters(){
+	// Start every sample from empty counters, otherwise the cut flows of a
+	// datacard run accumulate over all samples processed before
+	for(gChannel ch = channels_begin; ch < gNCHANNELS; ch=gChannel(ch+1)){
+		fCounter[ch]         = Monitor();
+		fCounterSync[ch]     = Monitor();
+		fCounterPurities[ch] = Monitor();
+	}
+}
 void SSDLDumper::initCounters(){
-	fCounter[Muon].fill(fMMCutNames[0],  0.);
-	fCounter[Muon].fill(fMMCutNames[1],  0.);
-	fCounter[Muon].fill(fMMCutNames[2],  0.);
-	fCounter[Muon].fill(fMMCutNames[3],  0.);
-	fCounter[Muon].fill(fMMCutNames[4],  0.);
-	fCounter[Muon].fill(fMMCutNames[5],  0.);
-	fCounter[Muon].fill(fMMCutNames[6],  0.);
-	fCounter[Muon].fill(fMMCutNames[7],  0.);
-	fCounter[Muon].fill(fMMCutNames[8],  0.);
-	fCounter[Muon].fill(fMMCutNames[9],  0.);
-	fCounter[Muon].fill(fMMCutNames[10], 0.);
-	fCounter[Muon].fill(fMMCutNames[11], 0.);
-	fCounter[Muon].fill(fMMCutNames[12], 0.);
-	fCounter[Muon].fill(fMMCutNames[13], 0.);
-	fCounter[Muon].fill(fMMCutNames[14], 0.);
-	fCounter[Muon].fill(fMMCutNames[15], 0.);
-	fCounter[Muon].fill(fMMCutNames[16], 0.);
-	fCounter[Muon].fill(fMMCutNames[17], 0.);
-
-	fCounter[Elec].fill(fEECutNames[0],  0.);
-	fCounter[Elec].fill(fEECutNames[1],  0.);
-	fCounter[Elec].fill(fEECutNames[2],  0.);
-	fCounter[Elec].fill(fEECutNames[3],  0.);
-	fCounter[Elec].fill(fEECutNames[4],  0.);
-	fCounter[Elec].fill(fEECutNames[5],  0.);
-	fCounter[Elec].fill(fEECutNames[6],  0.);
-	fCounter[Elec].fill(fEECutNames[7],  0.);
-	fCounter[Elec].fill(fEECutNames[8],  0.);
-	fCounter[Elec].fill(fEECutNames[9],  0.);
-	fCounter[Elec].fill(fEECutNames[10], 0.);
-	fCounter[Elec].fill(fEECutNames[11], 0.);
-	fCounter[Elec].fill(fEECutNames[12], 0.);
-	fCounter[Elec].fill(fEECutNames[13], 0.);
-	fCounter[Elec].fill(fEECutNames[14], 0.);
-	fCounter[Elec].fill(fEECutNames[15], 0.);
-	fCounter[Elec].fill(fEECutNames[16], 0.);
-	fCounter[Elec].fill(fEECutNames[17], 0.);
-
-	fCounter[ElMu].fill(fEMCutNames[0],  0.);
-	fCounter[ElMu].fill(fEMCutNames[1],  0.);
-	fCounter[ElMu].fill(fEMCutNames[2],  0.);
-	fCounter[ElMu].fill(fEMCutNames[3],  0.);
-	fCounter[ElMu].fill(fEMCutNames[4],  0.);
-	fCounter[ElMu].fill(fEMCutNames[5],  0.);
-	fCounter[ElMu].fill(fEMCutNames[6],  0.);
-	fCounter[ElMu].fill(fEMCutNames[7],  0.);
-	fCounter[ElMu].fill(fEMCutNames[8],  0.);
-	fCounter[ElMu].fill(fEMCutNames[9],  0.);
-	fCounter[ElMu].fill(fEMCutNames[10], 0.);
-	fCounter[ElMu].fill(fEMCutNames[11], 0.);
-	fCounter[ElMu].fill(fEMCutNames[12], 0.);
-	fCounter[ElMu].fill(fEMCutNames[13], 0.);
-	fCounter[ElMu].fill(fEMCutNames[14], 0.);
-	fCounter[ElMu].fill(fEMCutNames[15], 0.);
-	fCounter[ElMu].fill(fEMCutNames[16], 0.);
-	fCounter[ElMu].fill(fEMCutNames[17], 0.);
- 
-	fCounterSync[Muon].fill(fSyncCutNames[0], 0.);
-	fCounterSync[Muon].fill(fSyncCutNames[1], 0.);
-	fCounterSync[Muon].fill(fSyncCutNames[2], 0.);
-	fCounterSync[Muon].fill(fSyncCutNames[3], 0.);
-	fCounterSync[Muon].fill(fSyncCutNames[4], 0.);
-	fCounterSync[Muon].fill(fSyncCutNames[5], 0.);
-	fCounterSync[Muon].fill(fSyncCutNames[6], 0.);
-	fCounterSync[Muon].fill(fSyncCutNames[7], 0.);
-
-	fCounterSync[Elec].fill(fSyncCutNames[0], 0.);
-	fCounterSync[Elec].fill(fSyncCutNames[1], 0.);
-	fCounterSync[Elec].fill(fSyncCutNames[2], 0.);
-	fCounterSync[Elec].fill(fSyncCutNames[3], 0.);
-	fCounterSync[Elec].fill(fSyncCutNames[4], 0.);
-	fCounterSync[Elec].fill(fSyncCutNames[5], 0.);
-	fCounterSync[Elec].fill(fSyncCutNames[6], 0.);
-	fCounterSync[Elec].fill(fSyncCutNames[7], 0.);
-
-	fCounterSync[ElMu].fill(fSyncCutNames[0], 0.);
-	fCounterSync[ElMu].fill(fSyncCutNames[1], 0.);
-	fCounterSync[ElMu].fill(fSyncCutNames[2], 0.);
-	fCounterSync[ElMu].fill(fSyncCutNames[3], 0.);
-	fCounterSync[ElMu].fill(fSyncCutNames[4], 0.);
-	fCounterSync[ElMu].fill(fSyncCutNames[5], 0.);
-	fCounterSync[ElMu].fill(fSyncCutNames[6], 0.);
-	fCounterSync[ElMu].fill(fSyncCutNames[7], 0.);
-	
-
-	fCounterPurities[Muon].fill(fPuritiesCutNames[0],0.);
-	fCounterPurities[Muon].fill(fPuritiesCutNames[1],0.);
-	fCounterPurities[Muon].fill(fPuritiesCutNames[2],0.);
-	fCounterPurities[Muon].fill(fPuritiesCutNames[3],0.);
-	fCounterPurities[Elec].fill(fPuritiesCutNames[0],0.);
-	fCounterPurities[Elec].fill(fPuritiesCutNames[1],0.);
-	fCounterPurities[Elec].fill(fPuritiesCutNames[2],0.);
-	fCounterPurities[Elec].fill(fPuritiesCutNames[3],0.);
-	fCounterPurities[ElMu].fill(fPuritiesCutNames[0],0.);
-	fCounterPurities[ElMu].fill(fPuritiesCutNames[1],0.);
-	fCounterPurities[ElMu].fill(fPuritiesCutNames[2],0.);
-	fCounterPurities[ElMu].fill(fPuritiesCutNames[3],0.);
+	// Register the cut flow counters in printing order and keep their
+	// handles, the event loop then fills them without any string lookup
+	fMMCuts.clear(); fEECuts.clear(); fEMCuts.clear(); fSyncCuts.clear(); fPuritiesCuts.clear();
+	for(size_t i = 0; i < fMMCutNames.size(); ++i) fMMCuts.push_back(fCounter[Muon].book(fMMCutNames[i]));
+	for(size_t i = 0; i < fEECutNames.size(); ++i) fEECuts.push_back(fCounter[Elec].book(fEECutNames[i]));
+	for(size_t i = 0; i < fEMCutNames.size(); ++i) fEMCuts.push_back(fCounter[ElMu].book(fEMCutNames[i]));
+
+	// same names in all channels, hence the same handles
+	for(size_t i = 0; i < fSyncCutNames.size(); ++i){
+		fSyncCuts.push_back(fCounterSync[Muon].book(fSyncCutNames[i]));
+		fCounterSync[Elec].book(fSyncCutNames[i]);
+		fCounterSync[ElMu].book(fSyncCutNames[i]);
+	}
+	for(size_t i = 0; i < fPuritiesCutNames.size(); ++i){
+		fPuritiesCuts.push_back(fCounterPurities[Muon].book(fPuritiesCutNames[i]));
+		fCounterPurities[Elec].book(fPuritiesCutNames[i]);
+		fCounterPurities[ElMu].book(fPuritiesCutNames[i]);
+	}
 //
 //	fCounterWZ[Muon].fill(fWZCutNames[0],0.);
 //	fCounterWZ[Muon].fill(fWZCutNames[1],0.);
@@ -4090,6 +4596,209 @@ void SSDLDumper::writeHistos(Sample *S, TFile *pFile){
 		}
 	}
 }
+void SSDLDumper::mergeHistos(Sample *S, Sample *T){
+	// Add all histograms written by writeHistos from shard T to sample S.
+	// Event counter and cut flows are not included, they are filled by the
+	// master from the input file and the merged counters.
+
+	// Histos for differential yields
+	for(size_t k = 0; k < gNCHANNELS; ++k){
+		DiffPredYields *d = &S->diffyields[k];
+		DiffPredYields *e = &T->diffyields[k];
+		for(size_t j = 0; j < gNDiffVars; ++j){
+			d->hnt11[j]->Add(e->hnt11[j]);
+			d->hnt10[j]->Add(e->hnt10[j]);
+			d->hnt01[j]->Add(e->hnt01[j]);
+			d->hnt00[j]->Add(e->hnt00[j]);
+			d->hnpp[j] ->Add(e->hnpp[j] );
+			d->hnpf[j] ->Add(e->hnpf[j] );
+			d->hnfp[j] ->Add(e->hnfp[j] );
+			d->hnff[j] ->Add(e->hnff[j] );
+			if(k == Muon) continue;
+			d->hnt2_os_BB[j]->Add(e->hnt2_os_BB[j]);
+			d->hnt2_os_EE[j]->Add(e->hnt2_os_EE[j]);
+			if(k == ElMu) continue;
+			d->hnt2_os_EB[j]->Add(e->hnt2_os_EB[j]);
+		}
+	}
+
+	// Kinematic histos
+	for(size_t k = 0; k < gNKinSels; ++k){
+		for(size_t j = 0; j < gNKinVars; ++j){
+			S->kinplots[k][HighPt].hvar[j]->Add(T->kinplots[k][HighPt].hvar[j]);
+			S->kinplots_wz[k]     .hvar[j]->Add(T->kinplots_wz[k]     .hvar[j]);
+		}
+	}
+
+	// Id histos for electrons
+	for(size_t j = 0; j < gNSels; ++j){
+		S->idplots.hhoe   [j]->Add(T->idplots.hhoe   [j]);
+		S->idplots.hsiesie[j]->Add(T->idplots.hsiesie[j]);
+		S->idplots.hdeta  [j]->Add(T->idplots.hdeta  [j]);
+		S->idplots.hdphi  [j]->Add(T->idplots.hdphi  [j]);
+		S->idplots.hmvaid [j]->Add(T->idplots.hmvaid [j]);
+		S->idplots.hmedwp [j]->Add(T->idplots.hmedwp [j]);
+	}
+
+	for(size_t l = 0; l < 2; ++l){
+		// Isolation histos
+		IsoPlots *ip = &S->isoplots[l];
+		IsoPlots *iq = &T->isoplots[l];
+		for(size_t j = 0; j < gNSels; ++j){
+			ip->hiso[j]->Add(iq->hiso[j]);
+			for(int k = 0; k < gNMuFPtBins; ++k) ip->hiso_pt[j][k]->Add(iq->hiso_pt[j][k]);
+			for(int k = 0; k < gNNVrtxBins; ++k) ip->hiso_nv[j][k]->Add(iq->hiso_nv[j][k]);
+		}
+
+		// Pile-up histos
+		PuPlots *pu = &S->puplots[l];
+		PuPlots *pv = &T->puplots[l];
+		pu->hdtrig ->Add(pv->hdtrig );
+		pu->hstrig ->Add(pv->hstrig );
+		pu->hssdl  ->Add(pv->hssdl  );
+		pu->hntight->Add(pv->hntight);
+		pu->hnloose->Add(pv->hnloose);
+
+		// Ratio histos
+		for(size_t j = 0; j < gNRatioVars; ++j){
+			S->ratioplots[l].ntight[j]->Add(T->ratioplots[l].ntight[j]);
+			S->ratioplots[l].nloose[j]->Add(T->ratioplots[l].nloose[j]);
+		}
+
+		// TL ratios
+		TLRatios *tl = &S->tlratios[l];
+		TLRatios *tm = &T->tlratios[l];
+		tl->fntight   ->Add(tm->fntight   );
+		tl->fnloose   ->Add(tm->fnloose   );
+		tl->pntight   ->Add(tm->pntight   );
+		tl->pnloose   ->Add(tm->pnloose   );
+		tl->fntight_nv->Add(tm->fntight_nv);
+		tl->fnloose_nv->Add(tm->fnloose_nv);
+		tl->pntight_nv->Add(tm->pntight_nv);
+		tl->pnloose_nv->Add(tm->pnloose_nv);
+
+		tl->fntight_ttbar->Add(tm->fntight_ttbar);
+		tl->fnloose_ttbar->Add(tm->fnloose_ttbar);
+		tl->pntight_ttbar->Add(tm->pntight_ttbar);
+		tl->pnloose_ttbar->Add(tm->pnloose_ttbar);
+
+		tl->fntight_genID         ->Add(tm->fntight_genID         );
+		tl->fnloose_genID         ->Add(tm->fnloose_genID         );
+		tl->pntight_genID         ->Add(tm->pntight_genID         );
+		tl->pnloose_genID         ->Add(tm->pnloose_genID         );
+		tl->fntight_sig_genID     ->Add(tm->fntight_sig_genID     );
+		tl->fnloose_sig_genID     ->Add(tm->fnloose_sig_genID     );
+		tl->pntight_sig_genID     ->Add(tm->pntight_sig_genID     );
+		tl->pnloose_sig_genID     ->Add(tm->pnloose_sig_genID     );
+		tl->fntight_sigSup_genID  ->Add(tm->fntight_sigSup_genID  );
+		tl->fnloose_sigSup_genID  ->Add(tm->fnloose_sigSup_genID  );
+		tl->pntight_sigSup_genID  ->Add(tm->pntight_sigSup_genID  );
+		tl->pnloose_sigSup_genID  ->Add(tm->pnloose_sigSup_genID  );
+		tl->fntight_sigSup_genMID ->Add(tm->fntight_sigSup_genMID );
+		tl->fnloose_sigSup_genMID ->Add(tm->fnloose_sigSup_genMID );
+		tl->pntight_sigSup_genMID ->Add(tm->pntight_sigSup_genMID );
+		tl->pnloose_sigSup_genMID ->Add(tm->pnloose_sigSup_genMID );
+		tl->fntight_sigSup_genGMID->Add(tm->fntight_sigSup_genGMID);
+		tl->fnloose_sigSup_genGMID->Add(tm->fnloose_sigSup_genGMID);
+		tl->pntight_sigSup_genGMID->Add(tm->pntight_sigSup_genGMID);
+		tl->pnloose_sigSup_genGMID->Add(tm->pnloose_sigSup_genGMID);
+
+		tl->fratio_pt ->Add(*tm->fratio_pt );
+		tl->pratio_pt ->Add(*tm->pratio_pt );
+		tl->fratio_eta->Add(*tm->fratio_eta);
+		tl->pratio_eta->Add(*tm->pratio_eta);
+		tl->fratio_nv ->Add(*tm->fratio_nv );
+		tl->pratio_nv ->Add(*tm->pratio_nv );
+
+		tl->sigSup_mll           ->Add(tm->sigSup_mll           );
+		tl->sigSup_dRVetoLoose   ->Add(tm->sigSup_dRVetoLoose   );
+		tl->sigSup_dRVetoJet     ->Add(tm->sigSup_dRVetoJet     );
+		tl->sigSup_mllDRVetoLoose->Add(tm->sigSup_mllDRVetoLoose);
+		tl->sigSup_jetptDRVetoJet->Add(tm->sigSup_jetptDRVetoJet);
+		tl->sigSup_deltaPtVetoJet->Add(tm->sigSup_deltaPtVetoJet);
+		tl->sigSup_MID24_Iso     ->Add(tm->sigSup_MID24_Iso     );
+		tl->sigSup_MID500_Iso    ->Add(tm->sigSup_MID500_Iso    );
+		tl->sigSup_MID400_Iso    ->Add(tm->sigSup_MID400_Iso    );
+		tl->sigSup_MID15_Iso     ->Add(tm->sigSup_MID15_Iso     );
+		tl->sigSup_dPhiLooseJet  ->Add(tm->sigSup_dPhiLooseJet  );
+		tl->sigSup_nJets         ->Add(tm->sigSup_nJets         );
+
+		tl->sig_MID24_Iso        ->Add(tm->sig_MID24_Iso        );
+		tl->sig_MID500_Iso       ->Add(tm->sig_MID500_Iso       );
+		tl->sig_MID400_Iso       ->Add(tm->sig_MID400_Iso       );
+		tl->sig_MID15_Iso        ->Add(tm->sig_MID15_Iso        );
+
+		if(S->datamc > 0){
+			tl->sst_origin->Add(tm->sst_origin);
+			tl->ssl_origin->Add(tm->ssl_origin);
+			tl->zt_origin ->Add(tm->zt_origin );
+			tl->zl_origin ->Add(tm->zl_origin );
+		}
+	}
+
+	// Charge mis-ID
+	S->chmisid.ospairs    ->Add(T->chmisid.ospairs);
+	S->chmisid.sspairs    ->Add(T->chmisid.sspairs);
+	S->chmisid.chmid_BB_pt->Add(*T->chmisid.chmid_BB_pt);
+	S->chmisid.chmid_BE_pt->Add(*T->chmisid.chmid_BE_pt);
+	S->chmisid.chmid_EE_pt->Add(*T->chmisid.chmid_EE_pt);
+	S->chmisid.chmid_B_pt ->Add(*T->chmisid.chmid_B_pt );
+	S->chmisid.chmid_E_pt ->Add(*T->chmisid.chmid_E_pt );
+
+	// Yields
+	for(int r = 0; r < gNREGIONS; ++r){
+		for(gChannel ch = channels_begin; ch < gNCHANNELS; ch=gChannel(ch+1)){
+			Channel *C, *D;
+			if(ch == Muon){ C = &S->region[r][HighPt].mm; D = &T->region[r][HighPt].mm; }
+			if(ch == Elec){ C = &S->region[r][HighPt].ee; D = &T->region[r][HighPt].ee; }
+			if(ch == ElMu){ C = &S->region[r][HighPt].em; D = &T->region[r][HighPt].em; }
+			C->nt20_pt ->Add(D->nt20_pt );
+			C->nt10_pt ->Add(D->nt10_pt );
+			C->nt01_pt ->Add(D->nt01_pt );
+			C->nt00_pt ->Add(D->nt00_pt );
+			C->nt20_eta->Add(D->nt20_eta);
+			C->nt10_eta->Add(D->nt10_eta);
+			C->nt01_eta->Add(D->nt01_eta);
+			C->nt00_eta->Add(D->nt00_eta);
+
+			if(ch == Elec || ch == ElMu){
+				C->nt20_OS_BB_pt->Add(D->nt20_OS_BB_pt);
+				C->nt20_OS_EE_pt->Add(D->nt20_OS_EE_pt);
+				C->nt10_OS_BB_pt->Add(D->nt10_OS_BB_pt);
+				C->nt10_OS_EE_pt->Add(D->nt10_OS_EE_pt);
+				C->nt01_OS_BB_pt->Add(D->nt01_OS_BB_pt);
+				C->nt01_OS_EE_pt->Add(D->nt01_OS_EE_pt);
+				C->nt00_OS_BB_pt->Add(D->nt00_OS_BB_pt);
+				C->nt00_OS_EE_pt->Add(D->nt00_OS_EE_pt);
+				if(ch == Elec){
+					C->nt20_OS_EB_pt->Add(D->nt20_OS_EB_pt);
+					C->nt10_OS_EB_pt->Add(D->nt10_OS_EB_pt);
+					C->nt01_OS_EB_pt->Add(D->nt01_OS_EB_pt);
+					C->nt00_OS_EB_pt->Add(D->nt00_OS_EB_pt);
+				}
+			}
+
+			if(S->datamc > 0){
+				C->npp_pt     ->Add(D->npp_pt     );
+				C->nfp_pt     ->Add(D->nfp_pt     );
+				C->npf_pt     ->Add(D->npf_pt     );
+				C->nff_pt     ->Add(D->nff_pt     );
+				C->nt2pp_pt   ->Add(D->nt2pp_pt   );
+				C->nt2fp_pt   ->Add(D->nt2fp_pt   );
+				C->nt2pf_pt   ->Add(D->nt2pf_pt   );
+				C->nt2ff_pt   ->Add(D->nt2ff_pt   );
+				C->nt11_origin->Add(D->nt11_origin);
+				C->nt10_origin->Add(D->nt10_origin);
+				C->nt01_origin->Add(D->nt01_origin);
+				C->nt00_origin->Add(D->nt00_origin);
+				if(ch != Muon){
+					C->npp_cm_pt  ->Add(D->npp_cm_pt  );
+					C->nt2pp_cm_pt->Add(D->nt2pp_cm_pt);
+				}
+			}
+		}
+	}
+}
 void SSDLDumper::writeSigGraphs(Sample *S, gChannel chan, TFile *pFile){
 	TString channame = "MM";
 	if(chan == Elec) channame = "EE";
@@ -4128,13 +4837,14 @@ void SSDLDumper::writeSigGraphs(Sample *S, gChannel chan, TFile *pFile){
 	delete sigevents;
 }
 int  SSDLDumper::readHistos(TString filename){
-	TFile *pFile = TFile::Open(filename, "READ");
-	if(pFile == NULL){
+	// Histograms come from the binary cache of the file if it is up to date
+	HistoCache cache;
+	cache.setVerbose(fVerbose);
+	if(!cache.Open(filename)){
 		cout << "File " << filename << " does not exist!" << endl;
 		exit(1);
 	}
 
-	pFile->cd();
 	if(gNSAMPLES != fSamples.size()){
 		cout << "Mismatch in number of samples! Help!" << endl;
 		exit(1);
@@ -4147,42 +4857,42 @@ int  SSDLDumper::readHistos(TString filename){
 		if(fVerbose > 2) cout << "Reading histos for " << S->sname << endl;
 
 		// Event count histo
-		getObjectSafe(pFile, S->sname + "/" + S->sname + "_EventCount", S->evcount);
+		cache.GetObjectSafe(S->sname + "/" + S->sname + "_EventCount", S->evcount);
 		S->ngen = S->evcount->GetEntries();
 
 		// Cut flow histos
-		getObjectSafe(pFile, S->sname + "/MMCutFlow", S->cutFlowHisto[Muon]);
-		getObjectSafe(pFile, S->sname + "/EECutFlow", S->cutFlowHisto[Elec]);
-		getObjectSafe(pFile, S->sname + "/EMCutFlow", S->cutFlowHisto[ElMu]);
+		cache.GetObjectSafe(S->sname + "/MMCutFlow", S->cutFlowHisto[Muon]);
+		cache.GetObjectSafe(S->sname + "/EECutFlow", S->cutFlowHisto[Elec]);
+		cache.GetObjectSafe(S->sname + "/EMCutFlow", S->cutFlowHisto[ElMu]);
 
 		// Histos for differential yields
 		for(size_t k = 0; k < gNCHANNELS; ++k){
 			TString name;
 			for(size_t j = 0; j < gNDiffVars; ++j){
 				getname = Form("%s_%s_NT11_%s", S->sname.Data(), DiffPredYields::var_name[j].Data(), gChanLabel[k].Data());
-				getObjectSafe(pFile, S->sname + "/DiffYields/" + getname, S->diffyields[k].hnt11[j]);
+				cache.GetObjectSafe(S->sname + "/DiffYields/" + getname, S->diffyields[k].hnt11[j]);
 				getname = Form("%s_%s_NT10_%s", S->sname.Data(), DiffPredYields::var_name[j].Data(), gChanLabel[k].Data());
-				getObjectSafe(pFile, S->sname + "/DiffYields/" + getname, S->diffyields[k].hnt10[j]);
+				cache.GetObjectSafe(S->sname + "/DiffYields/" + getname, S->diffyields[k].hnt10[j]);
 				getname = Form("%s_%s_NT01_%s", S->sname.Data(), DiffPredYields::var_name[j].Data(), gChanLabel[k].Data());
-				getObjectSafe(pFile, S->sname + "/DiffYields/" + getname, S->diffyields[k].hnt01[j]);
+				cache.GetObjectSafe(S->sname + "/DiffYields/" + getname, S->diffyields[k].hnt01[j]);
 				getname = Form("%s_%s_NT00_%s", S->sname.Data(), DiffPredYields::var_name[j].Data(), gChanLabel[k].Data());
-				getObjectSafe(pFile, S->sname + "/DiffYields/" + getname, S->diffyields[k].hnt00[j]);
+				cache.GetObjectSafe(S->sname + "/DiffYields/" + getname, S->diffyields[k].hnt00[j]);
 				getname = Form("%s_%s_NPP_%s", S->sname.Data(), DiffPredYields::var_name[j].Data(), gChanLabel[k].Data());
-				getObjectSafe(pFile, S->sname + "/DiffYields/" + getname, S->diffyields[k].hnpp[j]);
+				cache.GetObjectSafe(S->sname + "/DiffYields/" + getname, S->diffyields[k].hnpp[j]);
 				getname = Form("%s_%s_NPF_%s", S->sname.Data(), DiffPredYields::var_name[j].Data(), gChanLabel[k].Data());
-				getObjectSafe(pFile, S->sname + "/DiffYields/" + getname, S->diffyields[k].hnpf[j]);
+				cache.GetObjectSafe(S->sname + "/DiffYields/" + getname, S->diffyields[k].hnpf[j]);
 				getname = Form("%s_%s_NFP_%s", S->sname.Data(), DiffPredYields::var_name[j].Data(), gChanLabel[k].Data());
-				getObjectSafe(pFile, S->sname + "/DiffYields/" + getname, S->diffyields[k].hnfp[j]);
+				cache.GetObjectSafe(S->sname + "/DiffYields/" + getname, S->diffyields[k].hnfp[j]);
 				getname = Form("%s_%s_NFF_%s", S->sname.Data(), DiffPredYields::var_name[j].Data(), gChanLabel[k].Data());
-				getObjectSafe(pFile, S->sname + "/DiffYields/" + getname, S->diffyields[k].hnff[j]);
+				cache.GetObjectSafe(S->sname + "/DiffYields/" + getname, S->diffyields[k].hnff[j]);
 				if(k == Muon) continue;
 				getname = Form("%s_%s_NT11_OS_BB_%s", S->sname.Data(), DiffPredYields::var_name[j].Data(), gChanLabel[k].Data());
-				getObjectSafe(pFile, S->sname + "/DiffYields/" + getname, S->diffyields[k].hnt2_os_BB[j]);
+				cache.GetObjectSafe(S->sname + "/DiffYields/" + getname, S->diffyields[k].hnt2_os_BB[j]);
 				getname = Form("%s_%s_NT11_OS_EE_%s", S->sname.Data(), DiffPredYields::var_name[j].Data(), gChanLabel[k].Data());
-				getObjectSafe(pFile, S->sname + "/DiffYields/" + getname, S->diffyields[k].hnt2_os_EE[j]);
+				cache.GetObjectSafe(S->sname + "/DiffYields/" + getname, S->diffyields[k].hnt2_os_EE[j]);
 				if(k == ElMu) continue;
 				getname = Form("%s_%s_NT11_OS_EB_%s", S->sname.Data(), DiffPredYields::var_name[j].Data(), gChanLabel[k].Data());
-				getObjectSafe(pFile, S->sname + "/DiffYields/" + getname, S->diffyields[k].hnt2_os_EB[j]);
+				cache.GetObjectSafe(S->sname + "/DiffYields/" + getname, S->diffyields[k].hnt2_os_EB[j]);
 			}
 		}	
 
@@ -4193,7 +4903,7 @@ int  SSDLDumper::readHistos(TString filename){
 			getname = Form("%s_%s_HTvsMET", S->sname.Data(), gKinSelNames[k].Data());
 			for(size_t j = 0; j < gNKinVars; ++j){
 				getname = Form("%s_%s_%s", S->sname.Data(), gKinSelNames[k].Data(), KinPlots::var_name[j].Data());
-				getObjectSafe(pFile, S->sname + "/KinPlots/" + getname, kp->hvar[j]);
+				cache.GetObjectSafe(S->sname + "/KinPlots/" + getname, kp->hvar[j]);
 				kp->hvar[j]->SetFillColor(S->color);
 			}
 		}
@@ -4204,7 +4914,7 @@ int  SSDLDumper::readHistos(TString filename){
 			KinPlots *kp = &S->kinplots_wz[k];
 			for(size_t j = 0; j < gNKinVars; ++j){
 				getname = Form("%s_%s_%s", S->sname.Data(), gKinSelNames[k].Data(), KinPlots::var_name[j].Data());
-				getObjectSafe(pFile, S->sname + "/WZValidation/" + getname, kp->hvar[j]);
+				cache.GetObjectSafe(S->sname + "/WZValidation/" + getname, kp->hvar[j]);
 				kp->hvar[j]->SetFillColor(S->color);
 			}
 		}
@@ -4215,27 +4925,27 @@ int  SSDLDumper::readHistos(TString filename){
 		for(size_t j = 0; j < gNSels; ++j){
 			// hoe
 			getname = Form("%s_%s_%shoe", S->sname.Data(), IdPlots::sel_name[j].Data(), gEMULabel[1].Data());
-			getObjectSafe(pFile, S->sname + "/IdPlots/" + getname, idp->hhoe[j]);
+			cache.GetObjectSafe(S->sname + "/IdPlots/" + getname, idp->hhoe[j]);
 			idp->hhoe[j]->SetFillColor(S->color);
 			// sigma ieta ieta
 			getname = Form("%s_%s_%ssiesie", S->sname.Data(), IdPlots::sel_name[j].Data(), gEMULabel[1].Data());
-			getObjectSafe(pFile, S->sname + "/IdPlots/" + getname, idp->hsiesie[j]);
+			cache.GetObjectSafe(S->sname + "/IdPlots/" + getname, idp->hsiesie[j]);
 			idp->hsiesie[j]->SetFillColor(S->color);
 			// delta eta
 			getname = Form("%s_%s_%sdeta", S->sname.Data(), IdPlots::sel_name[j].Data(), gEMULabel[1].Data());
-			getObjectSafe(pFile, S->sname + "/IdPlots/" + getname, idp->hdeta[j]);
+			cache.GetObjectSafe(S->sname + "/IdPlots/" + getname, idp->hdeta[j]);
 			idp->hdeta[j]->SetFillColor(S->color);
 			// delta phi
 			getname = Form("%s_%s_%sdphi", S->sname.Data(), IdPlots::sel_name[j].Data(), gEMULabel[1].Data());
-			getObjectSafe(pFile, S->sname + "/IdPlots/" + getname, idp->hdphi[j]);
+			cache.GetObjectSafe(S->sname + "/IdPlots/" + getname, idp->hdphi[j]);
 			idp->hdphi[j]->SetFillColor(S->color);
 			// mva id
 			getname = Form("%s_%s_%smvaid", S->sname.Data(), IdPlots::sel_name[j].Data(), gEMULabel[1].Data());
-			getObjectSafe(pFile, S->sname + "/IdPlots/" + getname, idp->hmvaid[j]);
+			cache.GetObjectSafe(S->sname + "/IdPlots/" + getname, idp->hmvaid[j]);
 			idp->hmvaid[j]->SetFillColor(S->color);
 			// medium ID WP pass
 			getname = Form("%s_%s_%smedwp", S->sname.Data(), IdPlots::sel_name[j].Data(), gEMULabel[1].Data());
-			getObjectSafe(pFile, S->sname + "/IdPlots/" + getname, idp->hmedwp[j]);
+			cache.GetObjectSafe(S->sname + "/IdPlots/" + getname, idp->hmedwp[j]);
 			idp->hmedwp[j]->SetFillColor(S->color);
 		}
 
@@ -4244,16 +4954,16 @@ int  SSDLDumper::readHistos(TString filename){
 			IsoPlots *ip = &S->isoplots[lep];
 			for(size_t j = 0; j < gNSels; ++j){
 				getname = Form("%s_%s_%siso", S->sname.Data(), IsoPlots::sel_name[j].Data(), gEMULabel[lep].Data());
-				getObjectSafe(pFile, S->sname + "/IsoPlots/" + getname, ip->hiso[j]);
+				cache.GetObjectSafe(S->sname + "/IsoPlots/" + getname, ip->hiso[j]);
 				ip->hiso[j]->SetFillColor(S->color);
 				for(int k = 0; k < gNMuFPtBins; ++k){
 					getname = Form("%s_%s_%siso_pt%d", S->sname.Data(), IsoPlots::sel_name[j].Data(), gEMULabel[lep].Data(), k);
-					getObjectSafe(pFile, S->sname + "/IsoPlots/" + getname, ip->hiso_pt[j][k]);
+					cache.GetObjectSafe(S->sname + "/IsoPlots/" + getname, ip->hiso_pt[j][k]);
 					ip->hiso_pt[j][k]->SetFillColor(S->color);
 				}
 				for(int k = 0; k < gNNVrtxBins; ++k){
 					getname = Form("%s_%s_%siso_nv%d", S->sname.Data(), IsoPlots::sel_name[j].Data(), gEMULabel[lep].Data(), k);
-					getObjectSafe(pFile, S->sname + "/IsoPlots/" + getname, ip->hiso_nv[j][k]);
+					cache.GetObjectSafe(S->sname + "/IsoPlots/" + getname, ip->hiso_nv[j][k]);
 					ip->hiso_nv[j][k]->SetFillColor(S->color);
 				}
 			}
@@ -4262,111 +4972,111 @@ int  SSDLDumper::readHistos(TString filename){
 			FRatioPlots *rp = &S->ratioplots[lep];
 			for(size_t j = 0; j < gNRatioVars; ++j){
 				getname = Form("%s_%s_ntight_%s", S->sname.Data(), gEMULabel[lep].Data(), FRatioPlots::var_name[j].Data());
-				getObjectSafe(pFile, S->sname + "/FRatioPlots/" + getname, rp->ntight[j]);
+				cache.GetObjectSafe(S->sname + "/FRatioPlots/" + getname, rp->ntight[j]);
 				getname = Form("%s_%s_nloose_%s", S->sname.Data(), gEMULabel[lep].Data(), FRatioPlots::var_name[j].Data());
-				getObjectSafe(pFile, S->sname + "/FRatioPlots/" + getname, rp->nloose[j]);
+				cache.GetObjectSafe(S->sname + "/FRatioPlots/" + getname, rp->nloose[j]);
 			}
 
 			// Pile-up plots
 			PuPlots *pu = &S->puplots[lep];
 			getname = Form("%s_%s_dtrig", S->sname.Data(), gEMULabel[lep].Data());
-			getObjectSafe(pFile, S->sname + "/PuPlots/" + getname, pu->hdtrig);
+			cache.GetObjectSafe(S->sname + "/PuPlots/" + getname, pu->hdtrig);
 			getname = Form("%s_%s_strig", S->sname.Data(), gEMULabel[lep].Data());
-			getObjectSafe(pFile, S->sname + "/PuPlots/" + getname, pu->hstrig);
+			cache.GetObjectSafe(S->sname + "/PuPlots/" + getname, pu->hstrig);
 			getname = Form("%s_%s_ssdl", S->sname.Data(), gEMULabel[lep].Data());
-			getObjectSafe(pFile, S->sname + "/PuPlots/" + getname, pu->hssdl);
+			cache.GetObjectSafe(S->sname + "/PuPlots/" + getname, pu->hssdl);
 			getname = Form("%s_%s_ntight", S->sname.Data(), gEMULabel[lep].Data());
-			getObjectSafe(pFile, S->sname + "/PuPlots/" + getname, pu->hntight);
+			cache.GetObjectSafe(S->sname + "/PuPlots/" + getname, pu->hntight);
 			getname = Form("%s_%s_nloose", S->sname.Data(), gEMULabel[lep].Data());
-			getObjectSafe(pFile, S->sname + "/PuPlots/" + getname, pu->hnloose);
+			cache.GetObjectSafe(S->sname + "/PuPlots/" + getname, pu->hnloose);
 			
 			// TL RATIOS
 			TString chanlabel = "";
 			if      (lep == 0) chanlabel = gChanLabel[Muon];
 			else if (lep == 1) chanlabel = gChanLabel[Elec];
 			TString tlname = S->sname + "/TLRatios/" + S->sname + "_" + chanlabel;
-			getObjectSafe(pFile, tlname + "_fNTight", S->tlratios[lep].fntight);
-			getObjectSafe(pFile, tlname + "_fNLoose", S->tlratios[lep].fnloose);
-			getObjectSafe(pFile, tlname + "_pNTight", S->tlratios[lep].pntight);
-			getObjectSafe(pFile, tlname + "_pNLoose", S->tlratios[lep].pnloose);
+			cache.GetObjectSafe(tlname + "_fNTight", S->tlratios[lep].fntight);
+			cache.GetObjectSafe(tlname + "_fNLoose", S->tlratios[lep].fnloose);
+			cache.GetObjectSafe(tlname + "_pNTight", S->tlratios[lep].pntight);
+			cache.GetObjectSafe(tlname + "_pNLoose", S->tlratios[lep].pnloose);
 			
-			getObjectSafe(pFile, tlname + "_fNTight_nv", S->tlratios[lep].fntight_nv);
-			getObjectSafe(pFile, tlname + "_fNLoose_nv", S->tlratios[lep].fnloose_nv);
-			getObjectSafe(pFile, tlname + "_pNTight_nv", S->tlratios[lep].pntight_nv);
-			getObjectSafe(pFile, tlname + "_pNLoose_nv", S->tlratios[lep].pnloose_nv);
+			cache.GetObjectSafe(tlname + "_fNTight_nv", S->tlratios[lep].fntight_nv);
+			cache.GetObjectSafe(tlname + "_fNLoose_nv", S->tlratios[lep].fnloose_nv);
+			cache.GetObjectSafe(tlname + "_pNTight_nv", S->tlratios[lep].pntight_nv);
+			cache.GetObjectSafe(tlname + "_pNLoose_nv", S->tlratios[lep].pnloose_nv);
 			// duplicate for ttbar only ratios
-			getObjectSafe(pFile, tlname + "_fNTight_ttbar", S->tlratios[lep].fntight_ttbar);
-			getObjectSafe(pFile, tlname + "_fNLoose_ttbar", S->tlratios[lep].fnloose_ttbar);
-			getObjectSafe(pFile, tlname + "_pNTight_ttbar", S->tlratios[lep].pntight_ttbar);
-			getObjectSafe(pFile, tlname + "_pNLoose_ttbar", S->tlratios[lep].pnloose_ttbar);
+			cache.GetObjectSafe(tlname + "_fNTight_ttbar", S->tlratios[lep].fntight_ttbar);
+			cache.GetObjectSafe(tlname + "_fNLoose_ttbar", S->tlratios[lep].fnloose_ttbar);
+			cache.GetObjectSafe(tlname + "_pNTight_ttbar", S->tlratios[lep].pntight_ttbar);
+			cache.GetObjectSafe(tlname + "_pNLoose_ttbar", S->tlratios[lep].pnloose_ttbar);
 			
 			// gen ID
-			getObjectSafe(pFile, tlname + "_fNTight_genID", S->tlratios[lep].fntight_genID);
-			getObjectSafe(pFile, tlname + "_fNLoose_genID", S->tlratios[lep].fnloose_genID);
-			getObjectSafe(pFile, tlname + "_pNTight_genID", S->tlratios[lep].pntight_genID);
-			getObjectSafe(pFile, tlname + "_pNLoose_genID", S->tlratios[lep].pnloose_genID);
+			cache.GetObjectSafe(tlname + "_fNTight_genID", S->tlratios[lep].fntight_genID);
+			cache.GetObjectSafe(tlname + "_fNLoose_genID", S->tlratios[lep].fnloose_genID);
+			cache.GetObjectSafe(tlname + "_pNTight_genID", S->tlratios[lep].pntight_genID);
+			cache.GetObjectSafe(tlname + "_pNLoose_genID", S->tlratios[lep].pnloose_genID);
 			
-			getObjectSafe(pFile, tlname + "_fNTight_sig_genID", S->tlratios[lep].fntight_sig_genID);
-			getObjectSafe(pFile, tlname + "_fNLoose_sig_genID", S->tlratios[lep].fnloose_sig_genID);
-			getObjectSafe(pFile, tlname + "_pNTight_sig_genID", S->tlratios[lep].pntight_sig_genID);
-			getObjectSafe(pFile, tlname + "_pNLoose_sig_genID", S->tlratios[lep].pnloose_sig_genID);
+			cache.GetObjectSafe(tlname + "_fNTight_sig_genID", S->tlratios[lep].fntight_sig_genID);
+			cache.GetObjectSafe(tlname + "_fNLoose_sig_genID", S->tlratios[lep].fnloose_sig_genID);
+			cache.GetObjectSafe(tlname + "_pNTight_sig_genID", S->tlratios[lep].pntight_sig_genID);
+			cache.GetObjectSafe(tlname + "_pNLoose_sig_genID", S->tlratios[lep].pnloose_sig_genID);
 			
-			getObjectSafe(pFile, tlname + "_fNTight_sigSup_genID", S->tlratios[lep].fntight_sigSup_genID);
-			getObjectSafe(pFile, tlname + "_fNLoose_sigSup_genID", S->tlratios[lep].fnloose_sigSup_genID);
-			getObjectSafe(pFile, tlname + "_pNTight_sigSup_genID", S->tlratios[lep].pntight_sigSup_genID);
-			getObjectSafe(pFile, tlname + "_pNLoose_sigSup_genID", S->tlratios[lep].pnloose_sigSup_genID);
+			cache.GetObjectSafe(tlname + "_fNTight_sigSup_genID", S->tlratios[lep].fntight_sigSup_genID);
+			cache.GetObjectSafe(tlname + "_fNLoose_sigSup_genID", S->tlratios[lep].fnloose_sigSup_genID);
+			cache.GetObjectSafe(tlname + "_pNTight_sigSup_genID", S->tlratios[lep].pntight_sigSup_genID);
+			cache.GetObjectSafe(tlname + "_pNLoose_sigSup_genID", S->tlratios[lep].pnloose_sigSup_genID);
 			
-			getObjectSafe(pFile, tlname + "_fNTight_sigSup_genMID", S->tlratios[lep].fntight_sigSup_genMID);
-			getObjectSafe(pFile, tlname + "_fNLoose_sigSup_genMID", S->tlratios[lep].fnloose_sigSup_genMID);
-			getObjectSafe(pFile, tlname + "_pNTight_sigSup_genMID", S->tlratios[lep].pntight_sigSup_genMID);
-			getObjectSafe(pFile, tlname + "_pNLoose_sigSup_genMID", S->tlratios[lep].pnloose_sigSup_genMID);
+			cache.GetObjectSafe(tlname + "_fNTight_sigSup_genMID", S->tlratios[lep].fntight_sigSup_genMID);
+			cache.GetObjectSafe(tlname + "_fNLoose_sigSup_genMID", S->tlratios[lep].fnloose_sigSup_genMID);
+			cache.GetObjectSafe(tlname + "_pNTight_sigSup_genMID", S->tlratios[lep].pntight_sigSup_genMID);
+			cache.GetObjectSafe(tlname + "_pNLoose_sigSup_genMID", S->tlratios[lep].pnloose_sigSup_genMID);
 			
-			getObjectSafe(pFile, tlname + "_fNTight_sigSup_genGMID", S->tlratios[lep].fntight_sigSup_genGMID);
-			getObjectSafe(pFile, tlname + "_fNLoose_sigSup_genGMID", S->tlratios[lep].fnloose_sigSup_genGMID);
-			getObjectSafe(pFile, tlname + "_pNTight_sigSup_genGMID", S->tlratios[lep].pntight_sigSup_genGMID);
-			getObjectSafe(pFile, tlname + "_pNLoose_sigSup_genGMID", S->tlratios[lep].pnloose_sigSup_genGMID);
-
-			getObjectSafe(pFile, tlname + "_fRatio_pt",  S->tlratios[lep].fratio_pt);
-			getObjectSafe(pFile, tlname + "_pRatio_pt",  S->tlratios[lep].pratio_pt);
-			getObjectSafe(pFile, tlname + "_fRatio_eta", S->tlratios[lep].fratio_eta);
-			getObjectSafe(pFile, tlname + "_pRatio_eta", S->tlratios[lep].pratio_eta);
-			getObjectSafe(pFile, tlname + "_fRatio_nv", S->tlratios[lep].fratio_nv);
-			getObjectSafe(pFile, tlname + "_pRatio_nv", S->tlratios[lep].pratio_nv);
+			cache.GetObjectSafe(tlname + "_fNTight_sigSup_genGMID", S->tlratios[lep].fntight_sigSup_genGMID);
+			cache.GetObjectSafe(tlname + "_fNLoose_sigSup_genGMID", S->tlratios[lep].fnloose_sigSup_genGMID);
+			cache.GetObjectSafe(tlname + "_pNTight_sigSup_genGMID", S->tlratios[lep].pntight_sigSup_genGMID);
+			cache.GetObjectSafe(tlname + "_pNLoose_sigSup_genGMID", S->tlratios[lep].pnloose_sigSup_genGMID);
+
+			cache.GetObjectSafe(tlname + "_fRatio_pt",  S->tlratios[lep].fratio_pt);
+			cache.GetObjectSafe(tlname + "_pRatio_pt",  S->tlratios[lep].pratio_pt);
+			cache.GetObjectSafe(tlname + "_fRatio_eta", S->tlratios[lep].fratio_eta);
+			cache.GetObjectSafe(tlname + "_pRatio_eta", S->tlratios[lep].pratio_eta);
+			cache.GetObjectSafe(tlname + "_fRatio_nv", S->tlratios[lep].fratio_nv);
+			cache.GetObjectSafe(tlname + "_pRatio_nv", S->tlratios[lep].pratio_nv);
 
 			// SigSup plots
-			getObjectSafe(pFile, tlname + "_sigSup_mll"           , S->tlratios[lep].sigSup_mll           );
-			getObjectSafe(pFile, tlname + "_sigSup_dRVetoLoose"   , S->tlratios[lep].sigSup_dRVetoLoose   );
-			getObjectSafe(pFile, tlname + "_sigSup_dRVetoJet"     , S->tlratios[lep].sigSup_dRVetoJet     );
-			getObjectSafe(pFile, tlname + "_sigSup_mllDRVetoLoose", S->tlratios[lep].sigSup_mllDRVetoLoose);
-			getObjectSafe(pFile, tlname + "_sigSup_jetptDRVetoJet", S->tlratios[lep].sigSup_jetptDRVetoJet);
-			getObjectSafe(pFile, tlname + "_sigSup_deltaPtVetoJet", S->tlratios[lep].sigSup_deltaPtVetoJet);
-			getObjectSafe(pFile, tlname + "_sigSup_MID24_Iso",      S->tlratios[lep].sigSup_MID24_Iso     );
-			getObjectSafe(pFile, tlname + "_sigSup_MID500_Iso",     S->tlratios[lep].sigSup_MID500_Iso    );
-			getObjectSafe(pFile, tlname + "_sigSup_MID400_Iso",     S->tlratios[lep].sigSup_MID400_Iso    );
-			getObjectSafe(pFile, tlname + "_sigSup_MID15_Iso",      S->tlratios[lep].sigSup_MID15_Iso     );
-			getObjectSafe(pFile, tlname + "_sigSup_dPhiLooseJet",   S->tlratios[lep].sigSup_dPhiLooseJet  );
-			getObjectSafe(pFile, tlname + "_sigSup_nJets",          S->tlratios[lep].sigSup_nJets         );
+			cache.GetObjectSafe(tlname + "_sigSup_mll"           , S->tlratios[lep].sigSup_mll           );
+			cache.GetObjectSafe(tlname + "_sigSup_dRVetoLoose"   , S->tlratios[lep].sigSup_dRVetoLoose   );
+			cache.GetObjectSafe(tlname + "_sigSup_dRVetoJet"     , S->tlratios[lep].sigSup_dRVetoJet     );
+			cache.GetObjectSafe(tlname + "_sigSup_mllDRVetoLoose", S->tlratios[lep].sigSup_mllDRVetoLoose);
+			cache.GetObjectSafe(tlname + "_sigSup_jetptDRVetoJet", S->tlratios[lep].sigSup_jetptDRVetoJet);
+			cache.GetObjectSafe(tlname + "_sigSup_deltaPtVetoJet", S->tlratios[lep].sigSup_deltaPtVetoJet);
+			cache.GetObjectSafe(tlname + "_sigSup_MID24_Iso",      S->tlratios[lep].sigSup_MID24_Iso     );
+			cache.GetObjectSafe(tlname + "_sigSup_MID500_Iso",     S->tlratios[lep].sigSup_MID500_Iso    );
+			cache.GetObjectSafe(tlname + "_sigSup_MID400_Iso",     S->tlratios[lep].sigSup_MID400_Iso    );
+			cache.GetObjectSafe(tlname + "_sigSup_MID15_Iso",      S->tlratios[lep].sigSup_MID15_Iso     );
+			cache.GetObjectSafe(tlname + "_sigSup_dPhiLooseJet",   S->tlratios[lep].sigSup_dPhiLooseJet  );
+			cache.GetObjectSafe(tlname + "_sigSup_nJets",          S->tlratios[lep].sigSup_nJets         );
 			
-			getObjectSafe(pFile, tlname + "_sig_MID24_Iso",  S->tlratios[lep].sig_MID24_Iso );
-			getObjectSafe(pFile, tlname + "_sig_MID500_Iso", S->tlratios[lep].sig_MID500_Iso);
-			getObjectSafe(pFile, tlname + "_sig_MID400_Iso", S->tlratios[lep].sig_MID400_Iso);
-			getObjectSafe(pFile, tlname + "_sig_MID15_Iso",  S->tlratios[lep].sig_MID15_Iso );
+			cache.GetObjectSafe(tlname + "_sig_MID24_Iso",  S->tlratios[lep].sig_MID24_Iso );
+			cache.GetObjectSafe(tlname + "_sig_MID500_Iso", S->tlratios[lep].sig_MID500_Iso);
+			cache.GetObjectSafe(tlname + "_sig_MID400_Iso", S->tlratios[lep].sig_MID400_Iso);
+			cache.GetObjectSafe(tlname + "_sig_MID15_Iso",  S->tlratios[lep].sig_MID15_Iso );
 			if(S->datamc > 0){
-				getObjectSafe(pFile, tlname + "_fTOrigin", S->tlratios[lep].sst_origin);
-				getObjectSafe(pFile, tlname + "_fLOrigin", S->tlratios[lep].ssl_origin);
-				getObjectSafe(pFile, tlname + "_pTOrigin", S->tlratios[lep].zt_origin );
-				getObjectSafe(pFile, tlname + "_pLOrigin", S->tlratios[lep].zl_origin );
+				cache.GetObjectSafe(tlname + "_fTOrigin", S->tlratios[lep].sst_origin);
+				cache.GetObjectSafe(tlname + "_fLOrigin", S->tlratios[lep].ssl_origin);
+				cache.GetObjectSafe(tlname + "_pTOrigin", S->tlratios[lep].zt_origin );
+				cache.GetObjectSafe(tlname + "_pLOrigin", S->tlratios[lep].zl_origin );
 			}
 		}
 		
 		TString chmidname = S->sname + "/ChMisID/" + S->sname + "_" + gChanLabel[Elec].Data();
-		getObjectSafe(pFile, chmidname + "_ospairs", S->chmisid.ospairs);
-		getObjectSafe(pFile, chmidname + "_sspairs", S->chmisid.sspairs);
-		getObjectSafe(pFile, chmidname + "_chmid_BB_pt", S->chmisid.chmid_BB_pt);
-		getObjectSafe(pFile, chmidname + "_chmid_BE_pt", S->chmisid.chmid_BE_pt);
-		getObjectSafe(pFile, chmidname + "_chmid_EE_pt", S->chmisid.chmid_EE_pt);
-		getObjectSafe(pFile, chmidname + "_chmid_B_pt",  S->chmisid.chmid_B_pt);
-		getObjectSafe(pFile, chmidname + "_chmid_E_pt",  S->chmisid.chmid_E_pt);
+		cache.GetObjectSafe(chmidname + "_ospairs", S->chmisid.ospairs);
+		cache.GetObjectSafe(chmidname + "_sspairs", S->chmisid.sspairs);
+		cache.GetObjectSafe(chmidname + "_chmid_BB_pt", S->chmisid.chmid_BB_pt);
+		cache.GetObjectSafe(chmidname + "_chmid_BE_pt", S->chmisid.chmid_BE_pt);
+		cache.GetObjectSafe(chmidname + "_chmid_EE_pt", S->chmisid.chmid_EE_pt);
+		cache.GetObjectSafe(chmidname + "_chmid_B_pt",  S->chmisid.chmid_B_pt);
+		cache.GetObjectSafe(chmidname + "_chmid_E_pt",  S->chmisid.chmid_E_pt);
 		
 		// Yields
 		for(size_t HighPt = 0; HighPt < 2; ++HighPt){
@@ -4379,47 +5089,47 @@ int  SSDLDumper::readHistos(TString filename){
 					if(ch == Elec) C = &R->ee;
 					if(ch == ElMu) C = &R->em;
 					TString root = S->sname +"/"+ gRegions[r]->sname +"/"+ S->sname +"_"+ gRegions[r]->sname +"_"+ gChanLabel[ch];
-					getObjectSafe(pFile, root + "_NT20_pt",  C->nt20_pt );
-					getObjectSafe(pFile, root + "_NT10_pt" , C->nt10_pt );
-					getObjectSafe(pFile, root + "_NT01_pt" , C->nt01_pt );
-					getObjectSafe(pFile, root + "_NT00_pt" , C->nt00_pt );
-					getObjectSafe(pFile, root + "_NT20_eta", C->nt20_eta);
-					getObjectSafe(pFile, root + "_NT10_eta", C->nt10_eta);
-					getObjectSafe(pFile, root + "_NT01_eta", C->nt01_eta);
-					getObjectSafe(pFile, root + "_NT00_eta", C->nt00_eta);
+					cache.GetObjectSafe(root + "_NT20_pt",  C->nt20_pt );
+					cache.GetObjectSafe(root + "_NT10_pt" , C->nt10_pt );
+					cache.GetObjectSafe(root + "_NT01_pt" , C->nt01_pt );
+					cache.GetObjectSafe(root + "_NT00_pt" , C->nt00_pt );
+					cache.GetObjectSafe(root + "_NT20_eta", C->nt20_eta);
+					cache.GetObjectSafe(root + "_NT10_eta", C->nt10_eta);
+					cache.GetObjectSafe(root + "_NT01_eta", C->nt01_eta);
+					cache.GetObjectSafe(root + "_NT00_eta", C->nt00_eta);
 					if(S->datamc > 0){
-						getObjectSafe(pFile, root + "_NPP_pt"     , C->npp_pt     );
-						getObjectSafe(pFile, root + "_NFP_pt"     , C->nfp_pt     );
-						getObjectSafe(pFile, root + "_NPF_pt"     , C->npf_pt     );
-						getObjectSafe(pFile, root + "_NFF_pt"     , C->nff_pt     );
-						getObjectSafe(pFile, root + "_NT2PP_pt"   , C->nt2pp_pt   );
-						getObjectSafe(pFile, root + "_NT2FP_pt"   , C->nt2fp_pt   );
-						getObjectSafe(pFile, root + "_NT2PF_pt"   , C->nt2pf_pt   );
-						getObjectSafe(pFile, root + "_NT2FF_pt"   , C->nt2ff_pt   );
-						getObjectSafe(pFile, root + "_NT20_Origin", C->nt11_origin);
-						getObjectSafe(pFile, root + "_NT10_Origin", C->nt10_origin);
-						getObjectSafe(pFile, root + "_NT01_Origin", C->nt01_origin);
-						getObjectSafe(pFile, root + "_NT00_Origin", C->nt00_origin);
+						cache.GetObjectSafe(root + "_NPP_pt"     , C->npp_pt     );
+						cache.GetObjectSafe(root + "_NFP_pt"     , C->nfp_pt     );
+						cache.GetObjectSafe(root + "_NPF_pt"     , C->npf_pt     );
+						cache.GetObjectSafe(root + "_NFF_pt"     , C->nff_pt     );
+						cache.GetObjectSafe(root + "_NT2PP_pt"   , C->nt2pp_pt   );
+						cache.GetObjectSafe(root + "_NT2FP_pt"   , C->nt2fp_pt   );
+						cache.GetObjectSafe(root + "_NT2PF_pt"   , C->nt2pf_pt   );
+						cache.GetObjectSafe(root + "_NT2FF_pt"   , C->nt2ff_pt   );
+						cache.GetObjectSafe(root + "_NT20_Origin", C->nt11_origin);
+						cache.GetObjectSafe(root + "_NT10_Origin", C->nt10_origin);
+						cache.GetObjectSafe(root + "_NT01_Origin", C->nt01_origin);
+						cache.GetObjectSafe(root + "_NT00_Origin", C->nt00_origin);
 						
 						if(ch != Muon){
-							getObjectSafe(pFile, root + "_NPP_CM_pt"  , C->npp_cm_pt  );
-							getObjectSafe(pFile, root + "_NT2PP_CM_pt", C->nt2pp_cm_pt);
+							cache.GetObjectSafe(root + "_NPP_CM_pt"  , C->npp_cm_pt  );
+							cache.GetObjectSafe(root + "_NT2PP_CM_pt", C->nt2pp_cm_pt);
 						}
 					}
 					if(ch == Elec || ch == ElMu){
-						getObjectSafe(pFile, root + "_NT20_OS_BB_pt", C->nt20_OS_BB_pt);
-						getObjectSafe(pFile, root + "_NT20_OS_EE_pt", C->nt20_OS_EE_pt);
-						getObjectSafe(pFile, root + "_NT10_OS_BB_pt", C->nt10_OS_BB_pt);
-						getObjectSafe(pFile, root + "_NT10_OS_EE_pt", C->nt10_OS_EE_pt);
-						getObjectSafe(pFile, root + "_NT01_OS_BB_pt", C->nt01_OS_BB_pt);
-						getObjectSafe(pFile, root + "_NT01_OS_EE_pt", C->nt01_OS_EE_pt);
-						getObjectSafe(pFile, root + "_NT00_OS_BB_pt", C->nt00_OS_BB_pt);
-						getObjectSafe(pFile, root + "_NT00_OS_EE_pt", C->nt00_OS_EE_pt);
+						cache.GetObjectSafe(root + "_NT20_OS_BB_pt", C->nt20_OS_BB_pt);
+						cache.GetObjectSafe(root + "_NT20_OS_EE_pt", C->nt20_OS_EE_pt);
+						cache.GetObjectSafe(root + "_NT10_OS_BB_pt", C->nt10_OS_BB_pt);
+						cache.GetObjectSafe(root + "_NT10_OS_EE_pt", C->nt10_OS_EE_pt);
+						cache.GetObjectSafe(root + "_NT01_OS_BB_pt", C->nt01_OS_BB_pt);
+						cache.GetObjectSafe(root + "_NT01_OS_EE_pt", C->nt01_OS_EE_pt);
+						cache.GetObjectSafe(root + "_NT00_OS_BB_pt", C->nt00_OS_BB_pt);
+						cache.GetObjectSafe(root + "_NT00_OS_EE_pt", C->nt00_OS_EE_pt);
 						if(ch == Elec) {
-							getObjectSafe(pFile, root + "_NT20_OS_EB_pt", C->nt20_OS_EB_pt);
-							getObjectSafe(pFile, root + "_NT10_OS_EB_pt", C->nt10_OS_EB_pt);
-							getObjectSafe(pFile, root + "_NT01_OS_EB_pt", C->nt01_OS_EB_pt);
-							getObjectSafe(pFile, root + "_NT00_OS_EB_pt", C->nt00_OS_EB_pt);
+							cache.GetObjectSafe(root + "_NT20_OS_EB_pt", C->nt20_OS_EB_pt);
+							cache.GetObjectSafe(root + "_NT10_OS_EB_pt", C->nt10_OS_EB_pt);
+							cache.GetObjectSafe(root + "_NT01_OS_EB_pt", C->nt01_OS_EB_pt);
+							cache.GetObjectSafe(root + "_NT00_OS_EB_pt", C->nt00_OS_EB_pt);
 						}
 					}
 				}
@@ -4431,6 +5141,7 @@ int  SSDLDumper::readHistos(TString filename){
 			}
 		}
 	}
+	cache.Update();
 	return 0;
 }
 int  SSDLDumper::readSigGraphs(TString filename){
@@ -4653,26 +5364,36 @@ bool SSDLDumper::eMuTrigger(){
 //////////////////////////////////////////////////////////////////////////////
 // Helper functions:
 //____________________________________________________________________________
-void SSDLDumper::scaleBTags(Sample *S, int flag, TString model){
+void SSDLDumper::scaleBTags(Sample *S, int flag, BTagSF::SMSModel model){
 	// for now supports only CSVM b-tagger. can be extended if need be
 	if(S->datamc == 0) return; // don't smear data
-	bool isFastsim = false;
-	if (model != "") isFastsim= true;
+	BTagSF::Variation var = BTagSF::kMean;
+	if(flag == 1) var = BTagSF::kMax;
+	if(flag == 2) var = BTagSF::kMin;
+
+	// collect the good jets, then correct them all at once
+	int   index[30];
+	bool  tagged[30];
+	float pt[30], eta[30], random[30];
+	int   flavor[30];
+	int n = 0;
 	for(size_t i = 0; i < NJets; ++i){
 		if(isGoodJet(i) == false) continue;
-		bool is_tagged_lse = JetCSVBTag[i] > 0.244; // not used in RA5
-		bool is_tagged_med = JetCSVBTag[i] > 0.679;
-		float random(-1.);
-		if (flag == 0)	random = fRand3Normal->Uniform(0,1); // get random number from uniform distribution
-		else			random = fRand3->Uniform(0,1); // get random number from uniform distribution
-		string meanminmax = "mean";
-		if(flag == 1) meanminmax = "max";
-		if(flag == 2) meanminmax = "min";
-
-		bool newTag = fBTagSF->modifyBTagsWithSF(is_tagged_med, JetPt[i], JetEta[i], JetPartonID[i], meanminmax, random, isFastsim, model); // WARNING: change this to partonflavor once the minitrees are ready!!!
-		if(!newTag) JetCSVBTag[i] = 0.1; // not tagged
-		if( newTag) JetCSVBTag[i] = 1.0; // tagged
-	}
+		index[n]  = i;
+		tagged[n] = JetCSVBTag[i] > 0.679; // medium, loose (0.244) not used in RA5
+		pt[n]     = JetPt[i];
+		eta[n]    = JetEta[i];
+		flavor[n] = JetPartonID[i]; // WARNING: change this to partonflavor once the minitrees are ready!!!
+		if (flag == 0)	random[n] = fRand3Normal->Uniform(0,1); // get random number from uniform distribution
+		else			random[n] = fRand3->Uniform(0,1); // get random number from uniform distribution
+		n++;
+	}
+	fBTagSF->modifyBTagsWithSF(n, tagged, pt, eta, flavor, random, var, model);
+	for(int k = 0; k < n; ++k){
+		if(!tagged[k]) JetCSVBTag[index[k]] = 0.1; // not tagged
+		if( tagged[k]) JetCSVBTag[index[k]] = 1.0; // tagged
+	}
+	invalidateObsCache();
 }
 // void SSDLDumper::scaleBTags(Sample *S, int flag){
 // 	if(S->datamc == 0) return; // don't smear data
@@ -4703,6 +5424,28 @@ void SSDLDumper::resetBTags(){
 	// Resets the b tags for all jets to saved values
 	if(fSaved_Tags.size() < 1) return;
 	for(size_t i = 0; i < NJets; ++i) JetCSVBTag[i] = fSaved_Tags[i];
+	invalidateObsCache();
+}
+void SSDLDumper::saveEvent(){
+	// Snapshot of all tree variables modified by smearJetPts, scaleBTags,
+	// scaleLeptons and scaleMET, so that the systematic variations can start
+	// from the unmodified event without reading the entry again
+	fSaved_JetPt .assign(JetPt,      JetPt      + NJets);
+	fSaved_RawTags.assign(JetCSVBTag, JetCSVBTag + NJets);
+	fSaved_MuPt  .assign(MuPt,       MuPt       + NMus);
+	fSaved_ElPt  .assign(ElPt,       ElPt       + NEls);
+	fSaved_pfMET      = pfMET;
+	fSaved_pfMETType1 = pfMETType1;
+}
+void SSDLDumper::restoreEvent(){
+	// Restores the snapshot taken by saveEvent
+	std::copy(fSaved_JetPt  .begin(), fSaved_JetPt  .end(), JetPt);
+	std::copy(fSaved_RawTags.begin(), fSaved_RawTags.end(), JetCSVBTag);
+	std::copy(fSaved_MuPt   .begin(), fSaved_MuPt   .end(), MuPt);
+	std::copy(fSaved_ElPt   .begin(), fSaved_ElPt   .end(), ElPt);
+	pfMET      = fSaved_pfMET;
+	pfMETType1 = fSaved_pfMETType1;
+	invalidateObsCache();
 }
 void SSDLDumper::scaleMET(Sample *S, int flag){
 	// first try on MET uncertainty
@@ -4826,6 +5569,7 @@ void SSDLDumper::smearJetPts(Sample *S, int flag){
 		}
 	}
 	propagateMET(jets, ojets);                                                  // propagate this change to the MET
+	invalidateObsCache();
 }
 // original void SSDLDumper::smearJetPts(Sample *S, int flag){
 // original 	// Modify the jet pt for systematics studies
@@ -4878,12 +5622,14 @@ void SSDLDumper::scaleLeptons(Sample *S, int flag){
 		leps += tmp;
 	}
 	propagateMET(leps, oleps);
+	invalidateObsCache();
 }
 void SSDLDumper::smearMET(Sample *S){
 	if(S->datamc == 0) return; // don't smear data
 	//TRandom3 * myRand = new TRandom3(0);
 	float sm_met = getMET() + fRand3->Gaus(0, 0.05) * getMET();
 	pfMET = sm_met;
+	invalidateObsCache();
 }
 float SSDLDumper::getJetPt(int i){
 	return JetPt[i];
@@ -4897,6 +5643,7 @@ float SSDLDumper::getMET(){
 void SSDLDumper::setMET(float newmet){
 	if (gMETType1)  pfMETType1 = newmet;
 	else            pfMET      = newmet;
+	invalidateObsCache(); // also for scaleMET and propagateMET
 }
 float SSDLDumper::getMETPhi(){
 	// Return the METPhi, either the true one or the one corrected for applied
@@ -4958,18 +5705,42 @@ float SSDLDumper::getNthJetPt(int n){
 	return sorted[n].val;
 }
 int SSDLDumper::getNJets(float pt){
+	JetSelCache &C = getJetSelCache();
+	fObsCalls[kObsNJets]++;
+	for(size_t k = 0; k < C.njets.size(); ++k){
+		if(C.njets[k].first != pt) continue;
+		fObsHits[kObsNJets]++;
+		return C.njets[k].second;
+	}
 	int njets(0);
-	for(size_t i = 0; i < NJets; ++i) if(isGoodJet(i, pt)) njets++;
+	for(size_t i = 0; i < NJets; ++i) if(isGoodJet(C, i, pt)) njets++;
+	C.njets.push_back(make_pair(pt, njets));
 	return njets;
 }
 int SSDLDumper::getNBTags(){
+	JetSelCache &C = getJetSelCache();
+	fObsCalls[kObsNBTags]++;
+	if(C.hasNBTags){
+		fObsHits[kObsNBTags]++;
+		return C.nbtags;
+	}
 	int ntags(0);
-	for(size_t i = 0; i < NJets; ++i) if(isGoodJet(i) && JetCSVBTag[i] > 0.244) ntags++;
+	for(size_t i = 0; i < NJets; ++i) if(isGoodJet(C, i) && JetCSVBTag[i] > 0.244) ntags++;
+	C.nbtags    = ntags;
+	C.hasNBTags = true;
 	return ntags;
 }
 int SSDLDumper::getNBTagsMed(){
+	JetSelCache &C = getJetSelCache();
+	fObsCalls[kObsNBTagsMed]++;
+	if(C.hasNBTagsMed){
+		fObsHits[kObsNBTagsMed]++;
+		return C.nbtagsmed;
+	}
 	int ntags(0);
-	for(size_t i = 0; i < NJets; ++i) if(isGoodJet(i) && JetCSVBTag[i] > 0.679) ntags++;
+	for(size_t i = 0; i < NJets; ++i) if(isGoodJet(C, i) && JetCSVBTag[i] > 0.679) ntags++;
+	C.nbtagsmed    = ntags;
+	C.hasNBTagsMed = true;
 	return ntags;
 }
 std::vector< int > SSDLDumper::getNBTagsMedIndices(){
@@ -4992,8 +5763,16 @@ float SSDLDumper::getBetaStar(int njet){
 	return -1;
 }
 float SSDLDumper::getHT(){
+	JetSelCache &C = getJetSelCache();
+	fObsCalls[kObsHT]++;
+	if(C.hasHT){
+		fObsHits[kObsHT]++;
+		return C.ht;
+	}
 	float ht(0.);
-	for(size_t i = 0; i < NJets; ++i) if(isGoodJet(i)) ht += getJetPt(i);
+	for(size_t i = 0; i < NJets; ++i) if(isGoodJet(C, i)) ht += getJetPt(i);
+	C.ht    = ht;
+	C.hasHT = true;
 	return ht;
 }
 float SSDLDumper::getWeightedHT(){
@@ -5037,6 +5816,15 @@ float SSDLDumper::getDPhiMLs(int ind1, int ind2, gChannel chan){
 float SSDLDumper::getMT2(int ind1, int ind2, gChannel chan){
 	// Calculate MT2 variable for two leptons and missing energy,
 	// assuming zero testmass
+	checkObsCacheEntry();
+	fObsCalls[kObsMT2]++;
+	for(size_t k = 0; k < fMT2Memo.size(); ++k){
+		const ObsMemo &m = fMT2Memo[k];
+		if(m.ind1 != ind1 || m.ind2 != ind2 || m.chan != chan) continue;
+		fObsHits[kObsMT2]++;
+		return m.value;
+	}
+
 	double pa[3];
 	double pb[3];
 	double pmiss[3];
@@ -5069,13 +5857,9 @@ float SSDLDumper::getMT2(int ind1, int ind2, gChannel chan){
 	pb[1] = pl2.Px();
 	pb[2] = pl2.Py();
 	
-	Davismt2 *DavisMT2 = new Davismt2();
-	DavisMT2->set_verbose(0);
-	DavisMT2->set_momenta(pa, pb, pmiss);
-	DavisMT2->set_mn(0.); // testmass
-	double MT2 = DavisMT2->get_mt2();
-	delete DavisMT2;
-	return MT2;
+	ObsMemo m = {ind1, ind2, chan, 0., float(fMT2Calc.getMT2(pa, pb, pmiss, 0.))}; // testmass
+	fMT2Memo.push_back(m);
+	return m.value;
 }
 float SSDLDumper::getMll(int ind1, int ind2, gChannel chan){
 	// Calculate inv mass for two leptons
@@ -5099,18 +5883,29 @@ float SSDLDumper::getMll(int ind1, int ind2, gChannel chan){
 }
 int   SSDLDumper::getClosestJet(int ind, gChannel chan, float jetPtCut){
 // Get index of the closest jet
+	JetSelCache &C = getJetSelCache();
+	fObsCalls[kObsClosestJet]++;
+	for(size_t k = 0; k < C.closest.size(); ++k){
+		const ObsMemo &m = C.closest[k];
+		if(m.ind1 != ind || m.chan != chan || m.cut != jetPtCut) continue;
+		fObsHits[kObsClosestJet]++;
+		return int(m.value);
+	}
+
 	float lepeta = (chan==Muon)?MuEta[ind]:ElEta[ind];
 	float lepphi = (chan==Muon)?MuPhi[ind]:ElPhi[ind];
 	
 	float mindr = 999.;
 	int cljetindex = -1;
 	for(size_t i = 0; i < NJets; ++i){
-		if(isGoodJet(i, jetPtCut) == false) continue;
+		if(isGoodJet(C, i, jetPtCut) == false) continue;
 		float dr = Util::GetDeltaR(lepeta, JetEta[i], lepphi, JetPhi[i]);
 		if(dr > mindr) continue;
 		mindr = dr;
 		cljetindex = i;
 	}
+	ObsMemo m = {ind, -1, chan, jetPtCut, float(cljetindex)};
+	C.closest.push_back(m);
 	return cljetindex;
 }
 float SSDLDumper::getClosestJetPt(int ind, gChannel chan, float jetPtCut){
@@ -5178,25 +5973,97 @@ float SSDLDumper::getAwayJetPt(int ind, gChannel chan){
 	float lepphi = (chan==Muon)?MuPhi[ind]:ElPhi[ind];
 	
 	if(NJets < 1) return 0.;
+
+	JetSelCache &C = getJetSelCache();
+	fObsCalls[kObsAwayJetPt]++;
+	for(size_t k = 0; k < C.away.size(); ++k){
+		const ObsMemo &m = C.away[k];
+		if(m.ind1 != ind || m.chan != chan) continue;
+		fObsHits[kObsAwayJetPt]++;
+		return m.value;
+	}
 	
-	float mindr  = 888.;
+	ObsMemo m = {ind, -1, chan, 0., 0.};
 	for(size_t i = 0; i < NJets; ++i){
 		if(Util::GetDeltaR(lepeta, JetEta[i], lepphi, JetPhi[i]) < 1.0) continue;
-		if(!isGoodJet(i)) continue;
-		return getJetPt(i); // assume sorted by pt, so this will return the hardest one
+		if(!isGoodJet(C, i)) continue;
+		m.value = getJetPt(i); // assume sorted by pt, so this will return the hardest one
+		break;
 	}
-	return 0.;
+	C.away.push_back(m);
+	return m.value;
 }
 float SSDLDumper::getMaxJPt(){
+	JetSelCache &C = getJetSelCache();
+	fObsCalls[kObsMaxJPt]++;
+	if(C.hasMaxJPt){
+		fObsHits[kObsMaxJPt]++;
+		return C.maxjpt;
+	}
 	float maxpt(0.);
 	for(size_t i = 0; i < NJets; ++i){
-		if(!isGoodJet(i)) continue;
+		if(!isGoodJet(C, i)) continue;
 		if(getJetPt(i) < maxpt) continue;
 		maxpt = getJetPt(i);
 	}
+	C.maxjpt    = maxpt;
+	C.hasMaxJPt = true;
 	return maxpt;
 }
 
+//____________________________________________________________________________
+SSDLDumper::JetSelCache& SSDLDumper::getJetSelCache(){
+	// The entry for the current jet selection state, made on first use.
+	// isGoodJet depends on the hyp leptons, on fC_minJetPt and, through the
+	// tight lepton cleaning, on the second lepton pt cuts.
+	const lepton *hyp[3] = {&fHypLepton1, &fHypLepton2, &fHypLepton3};
+	checkObsCacheEntry();
+	fObsCalls[kObsGoodJets]++;
+	for(int c = 0; c < fNJetSelCaches; ++c){
+		JetSelCache &C = fJetSelCaches[c];
+		if(C.minJetPt != fC_minJetPt || C.minMu2pt != fC_minMu2pt || C.minEl2pt != fC_minEl2pt) continue;
+		bool same = true;
+		for(int h = 0; h < 3; ++h) if(C.hyptype[h] != hyp[h]->type || C.hypindex[h] != hyp[h]->index) same = false;
+		if(!same) continue;
+		fObsHits[kObsGoodJets]++;
+		return C;
+	}
+
+	if(fNJetSelCaches == int(fJetSelCaches.size())) fJetSelCaches.push_back(JetSelCache());
+	JetSelCache &C = fJetSelCaches[fNJetSelCaches++]; // reuses the vectors of earlier events
+	for(int h = 0; h < 3; ++h){
+		C.hyptype [h] = hyp[h]->type;
+		C.hypindex[h] = hyp[h]->index;
+	}
+	C.minJetPt = fC_minJetPt;
+	C.minMu2pt = fC_minMu2pt;
+	C.minEl2pt = fC_minEl2pt;
+	C.good.resize(NJets);
+	for(size_t i = 0; i < NJets; ++i) C.good[i] = isGoodJet(i, -9999.); // pt cuts applied by the users
+	C.njets  .clear();
+	C.closest.clear();
+	C.away   .clear();
+	C.hasHT = C.hasNBTags = C.hasNBTagsMed = C.hasMaxJPt = false;
+	return C;
+}
+void SSDLDumper::resetObsCacheStats(){
+	for(int k = 0; k < kNObsCache; ++k) fObsCalls[k] = fObsHits[k] = 0;
+}
+void SSDLDumper::addObsCacheStats(const SSDLDumper *W){
+	for(int k = 0; k < kNObsCache; ++k){
+		fObsCalls[k] += W->fObsCalls[k];
+		fObsHits [k] += W->fObsHits [k];
+	}
+}
+void SSDLDumper::printObsCacheStats(TString sname){
+	static const char *names[kNObsCache] = {"GoodJets", "NJets", "HT", "NBTags", "NBTagsMed", "MaxJPt", "ClosestJet", "AwayJetPt", "MT2"};
+	cout << " Observable cache for " << sname << ":" << endl;
+	for(int k = 0; k < kNObsCache; ++k){
+		if(fObsCalls[k] == 0) continue;
+		cout << Form("   %-12s %12lld calls, %12lld computed, hit rate %5.1f%%", names[k], fObsCalls[k], fObsCalls[k]-fObsHits[k], 100.*fObsHits[k]/fObsCalls[k]) << endl;
+	}
+}
+
 int SSDLDumper::getNTightMuons(){
 	int nmus = 0;
 	for(size_t i = 0; i < NMus; ++i) if(isTightMuon(i)) nmus++;
@@ -5303,8 +6170,7 @@ void SSDLDumper::setRegionCuts(int reg){
 	fC_vetoTTZSel = gRegions[reg]->vetoTTZSel ;
 	fC_chargeVeto = gRegions[reg]->chargeVeto ;
 
-	if(reg == gRegion["WZEnriched"])  gInvertZVeto = true;
-	else                              gInvertZVeto = false;
+	fInvertZVeto = (reg == gRegion["WZEnriched"]);
 }
 void SSDLDumper::setLowPtCuts(){
 	if (fC_minHT < 250) fC_minHT = 250.;
@@ -5332,9 +6198,7 @@ void SSDLDumper::printRegionCuts(int reg){
 	cout << "fC_app3rdVet : " << fC_app3rdVet  << endl;
 	cout << "fC_vetoTTZSel: " << fC_vetoTTZSel << endl;
 	cout << "fC_chargeVeto: " << fC_chargeVeto << endl;
-
-	if(reg == gRegion["WZEnriched"])  gInvertZVeto = true;
-	else                              gInvertZVeto = false;
+	cout << "fInvertZVeto : " << fInvertZVeto  << endl;
 }
 
 //____________________________________________________________________________
@@ -5598,15 +6462,21 @@ bool SSDLDumper::passesJet50Cut(){
 }
 //____________________________________________________________________________
 bool SSDLDumper::passesHTCut(float min, float max){
-	return (getHT() >= min && getHT() < max);
+	return passesHTCut(min, max, getHT());
 }
 bool SSDLDumper::passesMETCut(float min, float max){
+	return passesMETCut(min, max, getMET(), getHT());
+}
+bool SSDLDumper::passesHTCut(float min, float max, float ht){
+	return (ht >= min && ht < max);
+}
+bool SSDLDumper::passesMETCut(float min, float max, float met, float ht){
 	if (!gTTWZ && max > 7999. && min < 49.) {  // for Baseline regions...
-		if (getHT() < 500.) return (getMET() >= 30. && getMET() < max);
-		else                return (getMET() >=  0. && getMET() < max);
+		if (ht < 500.) return (met >= 30. && met < max);
+		else           return (met >=  0. && met < max);
 	}
 	else {
-		return (getMET() >= min && getMET() < max);
+		return (met >= min && met < max);
 	}
 }
 bool SSDLDumper::passesZVetoNew(int l1, int l2, int toggle, float dm){
@@ -5660,7 +6530,7 @@ bool SSDLDumper::passesZVetoNew(int l1, int l2, int toggle, float dm){
 			if( ( fabs((pel2+pel3).M()) - gMZ ) < dm) return false;
 		  }
 	}
-	if (gInvertZVeto) return false;
+	if (fInvertZVeto) return false;
 	return true;
 }
 bool SSDLDumper::passesGammaStarVeto(int l1, int l2, int toggle, float mass){
@@ -5761,7 +6631,7 @@ bool SSDLDumper::passesZVeto(float dm){
 	// return passesZVeto(&SSDLDumper::isTightMuon, &SSDLDumper::isTightElectron, dm);
 	// return passesZVeto(&SSDLDumper::isLooseMuon, &SSDLDumper::isLooseElectron, dm);
 	// return !passesZVeto(&SSDLDumper::isGoodMuonForZVeto, &SSDLDumper::isGoodEleForZVeto, dm); //inverted Zveto
-	if (gInvertZVeto)  return !passZVeto;
+	if (fInvertZVeto)  return !passZVeto;
 	else               return  passZVeto;
 }
 bool SSDLDumper::passesChVeto(int ch){
@@ -6226,14 +7096,14 @@ bool SSDLDumper::isSSLLMuEvent(int& mu1, int& mu2){
 	// This should include all the cuts for the final selection
 	int nmus = hasLooseMuons(mu1, mu2);
 	if(nmus < 1) return false; // >0 loose muons
-	if(fDoCounting) fCounter[Muon].fill(fMMCutNames[3]);
+	if(fDoCounting) fCounter[Muon].fill(fMMCuts[3]);
 	if(nmus < 2) return false; // >1 loose muons
-	if(fDoCounting) fCounter[Muon].fill(fMMCutNames[4]);
+	if(fDoCounting) fCounter[Muon].fill(fMMCuts[4]);
 
 	if(fChargeSwitch == 0){
 		if(abs(isSSLLEvent(mu1, mu2)) != 1) return false;
 		if(!passesChVeto(fC_chargeVeto))    return false;
-		if(fDoCounting) fCounter[Muon].fill(fMMCutNames[5]);
+		if(fDoCounting) fCounter[Muon].fill(fMMCuts[5]);
 	}
 	if(fChargeSwitch == 1){
 		if(abs(isOSLLEvent(mu1, mu2)) != 1) return false;
@@ -6250,38 +7120,38 @@ bool SSDLDumper::isSSLLMuEvent(int& mu1, int& mu2){
 		// misidd as SS events
 		if(!passesZVeto()) return false; // no Zs in event
 		//if(!passesZVetoNew(mu1, mu2, 0)) return false; // no Zs in event
-		if(fDoCounting) fCounter[Muon].fill(fMMCutNames[6]);
+		if(fDoCounting) fCounter[Muon].fill(fMMCuts[6]);
 	}
 	
 	if(!passesMllEventVeto(mu1, mu2, 1, 8.)) return false; // no low mass OSSF pairs
 	if(!passesGammaStarVeto(mu1, mu2, 0)) return false; // reject GStar
-	if(fDoCounting) fCounter[Muon].fill(fMMCutNames[7]);
+	if(fDoCounting) fCounter[Muon].fill(fMMCuts[7]);
 
 
 	if(fC_app3rdVet && !passes3rdLepVeto()) return false; // 3rd lepton veto
-	if(fDoCounting) fCounter[Muon].fill(fMMCutNames[8]);
+	if(fDoCounting) fCounter[Muon].fill(fMMCuts[8]);
 
 	if(fC_vetoTTZSel && passesTTZSel()) return false; // ttZ veto
-	// if(fDoCounting) fCounter[Muon].fill(fMMCutNames[8]);
+	// if(fDoCounting) fCounter[Muon].fill(fMMCuts[8]);
 
 	if(getNJets() < fC_minNjets || getNJets() > fC_maxNjets) return false;    // njets cut
-	if(fDoCounting) fCounter[Muon].fill(fMMCutNames[9]);
+	if(fDoCounting) fCounter[Muon].fill(fMMCuts[9]);
 
 	if(getNBTags() < fC_minNbjets || getNBTagsMed() < fC_minNbjmed) return false;    // nbjets cut
 	if(getNBTags() > fC_maxNbjets || getNBTagsMed() > fC_maxNbjmed) return false;    // nbjets cut
-	if(fDoCounting) fCounter[Muon].fill(fMMCutNames[10]); // FIXME
+	if(fDoCounting) fCounter[Muon].fill(fMMCuts[10]); // FIXME
 
 	if(!passesHTCut(fC_minHT, fC_maxHT) )  return false;    // ht cut
-	if(fDoCounting) fCounter[Muon].fill(fMMCutNames[11]);
+	if(fDoCounting) fCounter[Muon].fill(fMMCuts[11]);
 
 	if(!passesMETCut(fC_minMet, fC_maxMet) ) return false;    // met cut
-	if(fDoCounting) fCounter[Muon].fill(fMMCutNames[12]);
+	if(fDoCounting) fCounter[Muon].fill(fMMCuts[12]);
 
 	if(!isGoodSecMuon(mu2)) return false; // pt cuts
-	if(fDoCounting) fCounter[Muon].fill(fMMCutNames[13]);
+	if(fDoCounting) fCounter[Muon].fill(fMMCuts[13]);
 
 	if(!isGoodPrimMuon(mu1)) return false;
-	if(fDoCounting) fCounter[Muon].fill(fMMCutNames[14]);
+	if(fDoCounting) fCounter[Muon].fill(fMMCuts[14]);
 
 	return true;
 }
@@ -6289,14 +7159,14 @@ bool SSDLDumper::isSSLLElEvent(int& el1, int& el2){
 	// This should include all the cuts for the final selection
 	int nels = hasLooseElectrons(el1, el2);
 	if(nels < 1) return false; // >0 eles;
-	if(fDoCounting) fCounter[Elec].fill(fEECutNames[3]);
+	if(fDoCounting) fCounter[Elec].fill(fEECuts[3]);
 	if(nels < 2) return false; // >1 eles
-	if(fDoCounting) fCounter[Elec].fill(fEECutNames[4]);
+	if(fDoCounting) fCounter[Elec].fill(fEECuts[4]);
 
 	if(fChargeSwitch == 0){
 		if(abs(isSSLLEvent(el1, el2)) != 2) return false;
 		if(!passesChVeto(fC_chargeVeto))    return false;
-		if(fDoCounting) fCounter[Elec].fill(fEECutNames[5]);
+		if(fDoCounting) fCounter[Elec].fill(fEECuts[5]);
 	}
 	if(fChargeSwitch == 1){
 		if(abs(isOSLLEvent(el1, el2)) != 2) return false;
@@ -6313,58 +7183,58 @@ bool SSDLDumper::isSSLLElEvent(int& el1, int& el2){
 		// misidd as SS events
 		if(!passesZVeto()) return false; // no Zs in event
 		//if(!passesZVetoNew(el1, el2, 2)) return false; // no Zs in event
-		if(fDoCounting) fCounter[Elec].fill(fEECutNames[6]);
+		if(fDoCounting) fCounter[Elec].fill(fEECuts[6]);
 	}
 
 	if(!passesMllEventVeto(el1, el2, 2, 8.))      return false; // no low mass OSSF pairs
 	if(!passesGammaStarVeto(el1, el2, 2)) return false; // reject GStar
-	if(fDoCounting) fCounter[Elec].fill(fEECutNames[7]);
+	if(fDoCounting) fCounter[Elec].fill(fEECuts[7]);
 
 
 	if(fC_app3rdVet && !passes3rdLepVeto()) return false; // 3rd lepton veto
-	if(fDoCounting) fCounter[Elec].fill(fEECutNames[8]);
+	if(fDoCounting) fCounter[Elec].fill(fEECuts[8]);
 
 	if(fC_vetoTTZSel && passesTTZSel()) return false; // ttZ veto
-	// if(fDoCounting) fCounter[Elec].fill(fEECutNames[8]);
+	// if(fDoCounting) fCounter[Elec].fill(fEECuts[8]);
 
 	if(getNJets() < fC_minNjets || getNJets() > fC_maxNjets) return false;    // njets cut
-	if(fDoCounting) fCounter[Elec].fill(fEECutNames[9]);
+	if(fDoCounting) fCounter[Elec].fill(fEECuts[9]);
 
 	if(getNBTags() < fC_minNbjets || getNBTagsMed() < fC_minNbjmed) return false;    // nbjets cut
 	if(getNBTags() > fC_maxNbjets || getNBTagsMed() > fC_maxNbjmed) return false;    // nbjets cut
-	if(fDoCounting) fCounter[Elec].fill(fEECutNames[10]); // FIXME
+	if(fDoCounting) fCounter[Elec].fill(fEECuts[10]); // FIXME
 
 	if(!passesHTCut(fC_minHT, fC_maxHT) )  return false;    // ht cut
-	if(fDoCounting) fCounter[Elec].fill(fEECutNames[11]);
+	if(fDoCounting) fCounter[Elec].fill(fEECuts[11]);
 
 	if(!passesMETCut(fC_minMet, fC_maxMet) ) return false;    // met cut
-	if(fDoCounting) fCounter[Elec].fill(fEECutNames[12]);
+	if(fDoCounting) fCounter[Elec].fill(fEECuts[12]);
 
 	if(!isGoodSecElectron(el2)) return false; // pt cuts
-	if(fDoCounting) fCounter[Elec].fill(fEECutNames[13]);
+	if(fDoCounting) fCounter[Elec].fill(fEECuts[13]);
 
 	if(!isGoodPrimElectron(el1)) return false;
-	if(fDoCounting) fCounter[Elec].fill(fEECutNames[14]);
+	if(fDoCounting) fCounter[Elec].fill(fEECuts[14]);
 
 	return true;
 }
 bool SSDLDumper::isSSLLElMuEvent(int& mu, int& el){
 	// This should include all the cuts for the final selection
 	int nmus = hasLooseMuons(mu, el);
-	if(nmus > 0 && fDoCounting) fCounter[ElMu].fill(fEMCutNames[3]);
+	if(nmus > 0 && fDoCounting) fCounter[ElMu].fill(fEMCuts[3]);
 	int nels = hasLooseElectrons(el, mu);
-	if(nels > 0 && fDoCounting) fCounter[ElMu].fill(fEMCutNames[4]);
+	if(nels > 0 && fDoCounting) fCounter[ElMu].fill(fEMCuts[4]);
 	if(nels < 1 || nmus < 1) return false;
-	if(nels > 0 && fDoCounting) fCounter[ElMu].fill(fEMCutNames[5]);
+	if(nels > 0 && fDoCounting) fCounter[ElMu].fill(fEMCuts[5]);
 
 	if(fChargeSwitch == 0){
 		if(abs(isSSLLEvent(mu, el)) != 3) return false;
 		if(!passesChVeto(fC_chargeVeto))  return false;
-		if(fDoCounting) fCounter[ElMu].fill(fEMCutNames[6]);
+		if(fDoCounting) fCounter[ElMu].fill(fEMCuts[6]);
 	}
 	if(fChargeSwitch == 1){
 		if(abs(isOSLLEvent(mu, el)) != 3) return false;
-		if(fDoCounting) fCounter[ElMu].fill(fEMCutNames[6]);
+		if(fDoCounting) fCounter[ElMu].fill(fEMCuts[6]);
 	}
 
 	// Define hypothesis leptons
@@ -6378,7 +7248,7 @@ bool SSDLDumper::isSSLLElMuEvent(int& mu, int& el){
 		// misidd as SS events
 		if(!passesZVeto()) return false;
 		//if(!passesZVetoNew(mu, el, 1)) return false;
-		if(fDoCounting) fCounter[ElMu].fill(fEMCutNames[7]);
+		if(fDoCounting) fCounter[ElMu].fill(fEMCuts[7]);
 	}
 
 	// this is a cross-flavor same sign mass cut. wtf.
@@ -6386,35 +7256,35 @@ bool SSDLDumper::isSSLLElMuEvent(int& mu, int& el){
 	if(!passesGammaStarVeto(mu, el, 1)) return false; // reject GStar
 
 	if(fC_app3rdVet && !passes3rdLepVeto()) return false; // 3rd lepton veto
-	if(fDoCounting) fCounter[ElMu].fill(fEMCutNames[8]);
+	if(fDoCounting) fCounter[ElMu].fill(fEMCuts[8]);
 
 	if(fC_vetoTTZSel && passesTTZSel()) return false; // ttZ veto
-	// if(fDoCounting) fCounter[ElMu].fill(fEMCutNames[8]);
+	// if(fDoCounting) fCounter[ElMu].fill(fEMCuts[8]);
 
 	if(getNJets() < fC_minNjets || getNJets() > fC_maxNjets) return false;    // njets cut
-	if(fDoCounting) fCounter[ElMu].fill(fEMCutNames[9]);
+	if(fDoCounting) fCounter[ElMu].fill(fEMCuts[9]);
 
 	if(getNBTags() < fC_minNbjets || getNBTagsMed() < fC_minNbjmed) return false;    // nbjets cut
 	if(getNBTags() > fC_maxNbjets || getNBTagsMed() > fC_maxNbjmed) return false;    // nbjets cut	if(getNBTags() > fC_maxNbjets) return false;
-	if(fDoCounting) fCounter[ElMu].fill(fEMCutNames[10]); // FIXME
+	if(fDoCounting) fCounter[ElMu].fill(fEMCuts[10]); // FIXME
 
 	if(!passesHTCut(fC_minHT, fC_maxHT) )  return false;    // ht cut
-	if(fDoCounting) fCounter[ElMu].fill(fEMCutNames[11]);
+	if(fDoCounting) fCounter[ElMu].fill(fEMCuts[11]);
 
 	if(!passesMETCut(fC_minMet, fC_maxMet) ) return false;    // met cut
-	if(fDoCounting) fCounter[ElMu].fill(fEMCutNames[12]);
+	if(fDoCounting) fCounter[ElMu].fill(fEMCuts[12]);
 
 	if(MuPt[mu] > ElPt[el]){
 		if(!isGoodPrimMuon(mu))    return false;
-		if(fDoCounting) fCounter[ElMu].fill(fEMCutNames[13]);
+		if(fDoCounting) fCounter[ElMu].fill(fEMCuts[13]);
 		if(!isGoodSecElectron(el)) return false;
-		if(fDoCounting) fCounter[ElMu].fill(fEMCutNames[14]);
+		if(fDoCounting) fCounter[ElMu].fill(fEMCuts[14]);
 	}
 	else if(MuPt[mu] < ElPt[el]){
 		if(!isGoodPrimElectron(el)) return false;
-		if(fDoCounting) fCounter[ElMu].fill(fEMCutNames[14]);
+		if(fDoCounting) fCounter[ElMu].fill(fEMCuts[14]);
 		if(!isGoodSecMuon(mu))      return false;
-		if(fDoCounting) fCounter[ElMu].fill(fEMCutNames[13]);
+		if(fDoCounting) fCounter[ElMu].fill(fEMCuts[13]);
 	}
 	return true;
 }
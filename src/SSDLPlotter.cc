@@ -14,6 +14,8 @@
 #include "helper/FakeRatios.hh"
 #include "helper/Monitor.hh"
 #include "helper/TTGammaScaleFactor.h"
+#include "helper/ScanGrid.hh"
+#include "helper/YieldGrid.hh"
 
 #include "TLorentzVector.h"
 #include "TGraphAsymmErrors.h"
@@ -22,6 +24,9 @@
 #include "TWbox.h"
 #include "TMultiGraph.h"
 #include "TGaxis.h"
+#include "TThread.h"
+#include "TObjArray.h"
+#include "TObjString.h"
 
 #include <iostream>
 #include <iomanip>
@@ -65,18 +70,40 @@ ttGpred ttG_SR0;
 SSDLPlotter::SSDLPlotter(TString configfile):SSDLDumper(configfile){ 
 // Default constructor, no samples are set
 	fDO_OPT=false;
+	fFRToys=false;
+	fSigEvents = NULL;
 }
 SSDLPlotter::SSDLPlotter(TString outputdir, TString outputfile):SSDLDumper(){
 // Explicit constructor with output directory and output file
 	fDO_OPT=false;
+	fFRToys=false;
+	fSigEvents = NULL;
 	setOutputDir(outputdir);
 	setOutputFile(outputfile);
 }
+SSDLPlotter::SSDLPlotter(const SSDLPlotter *master):SSDLDumper(master){
+// Worker clone for the signal scans, see scanModelGeneric
+	fDO_OPT=false;
+	fFRToys = master->fFRToys;
+	fSigEvents = NULL;
+	fLatex = NULL;
+	fLumiNorm = master->fLumiNorm;
+}
 SSDLPlotter::~SSDLPlotter(){
 	if(fOutputFile != NULL && fOutputFile->IsOpen()) fOutputFile->Close();
+	delete fSigEvents;
 	fChain = 0;
 }
 
+//____________________________________________________________________________
+FakeRatios* SSDLPlotter::newFakeRatios(){
+// Systematics from the ratio errors by linear error propagation,
+// the toys (setFRToys) agree within a few percent but are much slower
+	FakeRatios *FR = new FakeRatios();
+	FR->setESystMode(fFRToys ? FakeRatios::Toys : FakeRatios::Analytic);
+	return FR;
+}
+
 //____________________________________________________________________________
 void SSDLPlotter::init(TString filename){
 	if(fVerbose > 0) cout << "------------------------------------" << endl;
@@ -84,6 +111,7 @@ void SSDLPlotter::init(TString filename){
 	Util::SetStyle();
 	gStyle->SetOptStat(0);
 	
+	delete fBTagSF;
 	fBTagSF = new BTagSF();
 	readDatacard(filename);
 
@@ -389,6 +417,19 @@ void SSDLPlotter::init(TString filename){
 	fHighPtData.push_back(MuEG4);
 	fHighPtData.push_back(MuEG5);
 }
+
+//____________________________________________________________________________
+SigEventTable* SSDLPlotter::getSigEvents(){
+// The SigEvents tree is read into memory once per output file and shared
+// by all predictions and plots looping on the signal events
+	if(fSigEvents == NULL) fSigEvents = new SigEventTable();
+	if(!fSigEvents->IsOpen() || fSigEvents->GetFileName() != fOutputFileName){
+		fSigEvents->setVerbose(fVerbose);
+		fSigEvents->Open(fOutputFileName);
+	}
+	return fSigEvents;
+}
+
 void SSDLPlotter::doSMSscans(TString region, TString file, TString model){
         // This macro runs over the the SMS scans 
         // TString pathtofile = ""; //"dcap://t3se01.psi.ch:22125//pnfs/psi.ch/cms/trivcat/store/user/";
@@ -398,10 +439,23 @@ void SSDLPlotter::doSMSscans(TString region, TString file, TString model){
 	// bool for the low-pt analysis...
 	bool lowpt = false;
 	
+	// several regions are scanned in one pass: "SR01,SR02,SR03"
+	vector<int> regs;
+	TObjArray *names = region.Tokenize(",");
+	for (int i = 0; i < names->GetEntries(); ++i) {
+		TString name = ((TObjString*)names->At(i))->GetString();
+		if (gRegion.find(name) == gRegion.end()) {
+			cout << "SSDLPlotter::doSMSscans ==> Error: unknown region " << name << endl;
+			continue;
+		}
+		regs.push_back(gRegion[name]);
+	}
+	delete names;
+
 	cout << "Running Over region: " << region << endl;
 	cout << "On file: " << file << endl;
 	//	scanSMS(file, gRegion[region]);
-	scanModelGeneric(file , gRegion[region], model, lowpt);
+	scanModelGeneric(file , regs, model, lowpt);
 }
 void SSDLPlotter::doAnalysis(){
 	// sandBox();  
@@ -577,7 +631,7 @@ void SSDLPlotter::showStatusBar(int nEvent, int nEvents, int updateIntervall, bo
 }
 //____________________________________________________________________________
 void SSDLPlotter::sandBox(){
-	FakeRatios *FR = new FakeRatios();
+	FakeRatios *FR = newFakeRatios();
 	FR->setIsMC(true);
 	FR->setNToyMCs(100);
 	FR->setAddESyst(0.0);
@@ -618,9 +672,9 @@ void SSDLPlotter::pythiaMadgraph(bool pythia){
 	const float WZESyst  = 0.2;
 	const float WZESyst2 = WZESyst*WZESyst;
 
-	TFile * pFile;
-	if (pythia) pFile = TFile::Open("/shome/mdunser/workspace/CMSSW_5_2_5/src/DiLeptonAnalysis/NTupleProducer/macros/plots/Jul25_WZ__WZ_invZveto_jet70/WZTo3LNuPythia_Yields.root");
-	else pFile = TFile::Open("/shome/mdunser/workspace/CMSSW_5_2_5/src/DiLeptonAnalysis/NTupleProducer/macros/plots/Sep10_WZ_invZveto_jet70/WZTo3LNu_dataAndMadgraph_Yields.root");
+	SigEventTable sigevents;
+	if (pythia) sigevents.Open("/shome/mdunser/workspace/CMSSW_5_2_5/src/DiLeptonAnalysis/NTupleProducer/macros/plots/Jul25_WZ__WZ_invZveto_jet70/WZTo3LNuPythia_Yields.root");
+	else sigevents.Open("/shome/mdunser/workspace/CMSSW_5_2_5/src/DiLeptonAnalysis/NTupleProducer/macros/plots/Sep10_WZ_invZveto_jet70/WZTo3LNu_dataAndMadgraph_Yields.root");
 
 	// ///////////////////////////////////////////////////////////////////////////////////
 	// // RATIOS /////////////////////////////////////////////////////////////////////////
@@ -659,7 +713,7 @@ void SSDLPlotter::pythiaMadgraph(bool pythia){
 	// float nt2_wz_mc_mm_e2(0.), nt2_wz_mc_em_e2(0.), nt2_wz_mc_ee_e2(0.);
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-	TTree *sigtree; getObjectSafe(pFile, "SigEvents", sigtree);
+	SigEventReader sigtree(&sigevents);
 	
 	string *sname = 0;
 	int flag;
@@ -668,26 +722,26 @@ void SSDLPlotter::pythiaMadgraph(bool pythia){
 	float eta1, eta2, mll;
 	int   event, run;
 
-	sigtree->SetBranchAddress("SystFlag", &flag);
-	sigtree->SetBranchAddress("Event",    &event);
-	sigtree->SetBranchAddress("Run",      &run);
-	sigtree->SetBranchAddress("SName",    &sname);
-	sigtree->SetBranchAddress("SType",    &SType);
-	sigtree->SetBranchAddress("PUWeight", &puweight);
-	sigtree->SetBranchAddress("SLumi",    &SLumi);
-	sigtree->SetBranchAddress("Flavor",   &Flavor);
-	sigtree->SetBranchAddress("pT1",      &pT1);
-	sigtree->SetBranchAddress("pT2",      &pT2);
-	sigtree->SetBranchAddress("eta1",     &eta1);
-	sigtree->SetBranchAddress("eta2",     &eta2);
-	sigtree->SetBranchAddress("TLCat",    &TLCat);
-	sigtree->SetBranchAddress("HT",       &HT);
-	sigtree->SetBranchAddress("MET",      &MET);
-	sigtree->SetBranchAddress("MT2",      &MT2);
-	sigtree->SetBranchAddress("NJ",       &NJ);
-	sigtree->SetBranchAddress("NbJ",      &NbJ);
-	sigtree->SetBranchAddress("NbJmed",   &NbJmed);
-	sigtree->SetBranchAddress("Mll",      &mll);
+	sigtree.SetBranchAddress("SystFlag", &flag);
+	sigtree.SetBranchAddress("Event",    &event);
+	sigtree.SetBranchAddress("Run",      &run);
+	sigtree.SetBranchAddress("SName",    &sname);
+	sigtree.SetBranchAddress("SType",    &SType);
+	sigtree.SetBranchAddress("PUWeight", &puweight);
+	sigtree.SetBranchAddress("SLumi",    &SLumi);
+	sigtree.SetBranchAddress("Flavor",   &Flavor);
+	sigtree.SetBranchAddress("pT1",      &pT1);
+	sigtree.SetBranchAddress("pT2",      &pT2);
+	sigtree.SetBranchAddress("eta1",     &eta1);
+	sigtree.SetBranchAddress("eta2",     &eta2);
+	sigtree.SetBranchAddress("TLCat",    &TLCat);
+	sigtree.SetBranchAddress("HT",       &HT);
+	sigtree.SetBranchAddress("MET",      &MET);
+	sigtree.SetBranchAddress("MT2",      &MT2);
+	sigtree.SetBranchAddress("NJ",       &NJ);
+	sigtree.SetBranchAddress("NbJ",      &NbJ);
+	sigtree.SetBranchAddress("NbJmed",   &NbJmed);
+	sigtree.SetBranchAddress("Mll",      &mll);
 
 	// FakeRatios *FR = new FakeRatios();
 
@@ -727,8 +781,8 @@ void SSDLPlotter::pythiaMadgraph(bool pythia){
 	float minPt1 = 20.;
 	float minPt2 = 10.;
 	float trigScale[3] = {gMMTrigScale, gEMTrigScale, gEETrigScale};
-	for( int i = 0; i < sigtree->GetEntries(); i++ ){
-		sigtree->GetEntry(i);
+	for( int i = 0; i < sigtree.GetEntries(); i++ ){
+		sigtree.GetEntry(i);
 		
 		// if( flag != systflag ) continue;
 		
@@ -914,8 +968,7 @@ void SSDLPlotter::makeROCCurve(){
 	lat->SetTextColor(kBlack);
 	lat->SetTextSize(0.04);
 
-	TFile *pFile = TFile::Open(fOutputFileName);
-	TTree *sigtree; getObjectSafe(pFile, "SigEvents", sigtree);
+	SigEventReader sigtree(getSigEvents());
 	string *sname = 0;
 	int flag;
 	int   SType, Flavor, TLCat, NJ, NbJ, NbJmed;
@@ -923,30 +976,30 @@ void SSDLPlotter::makeROCCurve(){
 	float eta1, eta2, mll, mvaid1, mvaid2, medwp1, medwp2;
 	float pfiso1, pfiso2;
 
-	sigtree->SetBranchAddress("SystFlag", &flag);
-	sigtree->SetBranchAddress("SName",    &sname);
-	sigtree->SetBranchAddress("SType",    &SType);
-	sigtree->SetBranchAddress("PUWeight", &puweight);
-	sigtree->SetBranchAddress("SLumi",    &SLumi);
-	sigtree->SetBranchAddress("Flavor",   &Flavor);
-	sigtree->SetBranchAddress("pT1",      &pT1);
-	sigtree->SetBranchAddress("pT2",      &pT2);
-	sigtree->SetBranchAddress("eta1",     &eta1);
-	sigtree->SetBranchAddress("eta2",     &eta2);
-	sigtree->SetBranchAddress("TLCat",    &TLCat);
-	sigtree->SetBranchAddress("HT",       &HT);
-	sigtree->SetBranchAddress("MET",      &MET);
-	sigtree->SetBranchAddress("MT2",      &MT2);
-	sigtree->SetBranchAddress("NJ",       &NJ);
-	sigtree->SetBranchAddress("NbJ",      &NbJ);
-	sigtree->SetBranchAddress("NbJmed",   &NbJmed);
-	sigtree->SetBranchAddress("Mll",      &mll);
-	sigtree->SetBranchAddress("PFIso1",   &pfiso1);
-	sigtree->SetBranchAddress("PFIso2",   &pfiso2);
-	sigtree->SetBranchAddress("MVAID1",   &mvaid1);
-	sigtree->SetBranchAddress("MVAID2",   &mvaid2);
-	sigtree->SetBranchAddress("medWP1",   &medwp1);
-	sigtree->SetBranchAddress("medWP2",   &medwp2);
+	sigtree.SetBranchAddress("SystFlag", &flag);
+	sigtree.SetBranchAddress("SName",    &sname);
+	sigtree.SetBranchAddress("SType",    &SType);
+	sigtree.SetBranchAddress("PUWeight", &puweight);
+	sigtree.SetBranchAddress("SLumi",    &SLumi);
+	sigtree.SetBranchAddress("Flavor",   &Flavor);
+	sigtree.SetBranchAddress("pT1",      &pT1);
+	sigtree.SetBranchAddress("pT2",      &pT2);
+	sigtree.SetBranchAddress("eta1",     &eta1);
+	sigtree.SetBranchAddress("eta2",     &eta2);
+	sigtree.SetBranchAddress("TLCat",    &TLCat);
+	sigtree.SetBranchAddress("HT",       &HT);
+	sigtree.SetBranchAddress("MET",      &MET);
+	sigtree.SetBranchAddress("MT2",      &MT2);
+	sigtree.SetBranchAddress("NJ",       &NJ);
+	sigtree.SetBranchAddress("NbJ",      &NbJ);
+	sigtree.SetBranchAddress("NbJmed",   &NbJmed);
+	sigtree.SetBranchAddress("Mll",      &mll);
+	sigtree.SetBranchAddress("PFIso1",   &pfiso1);
+	sigtree.SetBranchAddress("PFIso2",   &pfiso2);
+	sigtree.SetBranchAddress("MVAID1",   &mvaid1);
+	sigtree.SetBranchAddress("MVAID2",   &mvaid2);
+	sigtree.SetBranchAddress("medWP1",   &medwp1);
+	sigtree.SetBranchAddress("medWP2",   &medwp2);
 
 
 	std::vector< std::pair < float , float> > etas;
@@ -967,8 +1020,8 @@ void SSDLPlotter::makeROCCurve(){
 			int n_ttj_tot(0), n_ttj_pass(0);
 			int n_ttj_medwp_pass(0);
 
-			for( int i = 0; i < sigtree->GetEntries(); i++ ){
-				sigtree->GetEntry(i);
+			for( int i = 0; i < sigtree.GetEntries(); i++ ){
+				sigtree.GetEntry(i);
 				
 				if (*sname != "TTJets" && *sname != "TTbarW" ) continue; // just look at relevant samples
 				if (Flavor != 2) continue; // only interested in events with two electrons
@@ -1800,6 +1853,7 @@ void SSDLPlotter::makeNT012Plots(gChannel chan, vector<int> mcsamples, bool(SSDL
 				if (ientry < 0) break;
 				if(fVerbose > 1) printProgress(jentry, nentries, fSamples[index]->name);
 				nb = fChain->GetEntry(jentry);   nbytes += nb;
+				invalidateObsCache();
 
 				int ind1(-1), ind2(-1);
 				if((*this.*eventSelector)(ind1, ind2) == false) continue;
@@ -2286,6 +2340,7 @@ void SSDLPlotter::makeMuIsolationPlots(bool dottbar){
 			Long64_t ientry = LoadTree(jentry);
 			if (ientry < 0) break;
 			nb = fChain->GetEntry(jentry);   nbytes += nb;
+			invalidateObsCache();
 		
 			int muind1(-1), muind2(-1);
 			if(hasLooseMuons(muind1, muind2) < 1) continue;
@@ -2836,6 +2891,7 @@ void SSDLPlotter::makeElIsolationPlots(bool dottbar){
 			Long64_t ientry = LoadTree(jentry);
 			if (ientry < 0) break;
 			nb = fChain->GetEntry(jentry);   nbytes += nb;
+			invalidateObsCache();
 
 			int elind1(-1), elind2(-1);
 			if(hasLooseElectrons(elind1, elind2) < 1) continue;
@@ -3661,7 +3717,7 @@ void SSDLPlotter::makeNT2KinPlots(bool loglin){
 			gPad->RedrawAxis();
 			p_ratio->Draw();
 
-			FakeRatios *FR = new FakeRatios();
+			FakeRatios *FR = newFakeRatios();
 			TGraphAsymmErrors* gr_obs = FR->getGraphPoissonErrors(hvar_data[i]);
 			gr_obs->SetMarkerColor(kBlack);
 			gr_obs->SetMarkerStyle(8);
@@ -6227,7 +6283,7 @@ void SSDLPlotter::makeNTightLoosePlots(gChannel chan){
 		nloose->Draw("goff");
 		nloose->GetXaxis()->SetTitle(axis_name[i]);
 		
-		FakeRatios *FR = new FakeRatios();
+		FakeRatios *FR = newFakeRatios();
 		TGraphAsymmErrors* nt_obs = FR->getGraphPoissonErrors(ntight_data);
 		nt_obs->SetMarkerColor(kBlack);
 		nt_obs->SetMarkerStyle(8);
@@ -6683,8 +6739,7 @@ void SSDLPlotter::makeTTWNLOPlot(vector<TString> diffVarName, vector<int> nbins,
 //	float chargeFactor = chVeto ? 0.5:1.;
 	
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-	TFile *pFile = TFile::Open(fOutputFileName);
-	TTree *sigtree; getObjectSafe(pFile, "SigEvents", sigtree);
+	SigEventReader sigtree(getSigEvents());
 	
 	string *sname = 0;
 	int flag;
@@ -6696,29 +6751,29 @@ void SSDLPlotter::makeTTWNLOPlot(vector<TString> diffVarName, vector<int> nbins,
 	int passZVeto, passes3rdSFLepVeto;
 	float diffVar(-999.);
 	
-	sigtree->SetBranchAddress("SystFlag", &flag);
-	sigtree->SetBranchAddress("Event",    &event);
-	sigtree->SetBranchAddress("Run",      &run);
-	sigtree->SetBranchAddress("SName",    &sname);
-	sigtree->SetBranchAddress("SType",    &SType);
-	sigtree->SetBranchAddress("PUWeight", &puweight);
-	sigtree->SetBranchAddress("SLumi",    &SLumi);
-	sigtree->SetBranchAddress("Flavor",   &Flavor);
-	sigtree->SetBranchAddress("Charge",   &charge);
-	sigtree->SetBranchAddress("pT1",      &pT1);
-	sigtree->SetBranchAddress("pT2",      &pT2);
-	sigtree->SetBranchAddress("eta1",     &eta1);
-	sigtree->SetBranchAddress("eta2",     &eta2);
-	sigtree->SetBranchAddress("TLCat",    &TLCat);
-	sigtree->SetBranchAddress("HT",       &HT);
-	sigtree->SetBranchAddress("MET",      &MET);
-	sigtree->SetBranchAddress("MT2",      &MT2);
-	sigtree->SetBranchAddress("NJ",       &NJ);
-	sigtree->SetBranchAddress("NbJ",      &NbJ);
-	sigtree->SetBranchAddress("NbJmed",   &NbJmed);
-	sigtree->SetBranchAddress("Mll",      &mll);
-	sigtree->SetBranchAddress("PassZVeto",&passZVeto);
-	sigtree->SetBranchAddress("Pass3rdSFLepVeto",&passes3rdSFLepVeto);
+	sigtree.SetBranchAddress("SystFlag", &flag);
+	sigtree.SetBranchAddress("Event",    &event);
+	sigtree.SetBranchAddress("Run",      &run);
+	sigtree.SetBranchAddress("SName",    &sname);
+	sigtree.SetBranchAddress("SType",    &SType);
+	sigtree.SetBranchAddress("PUWeight", &puweight);
+	sigtree.SetBranchAddress("SLumi",    &SLumi);
+	sigtree.SetBranchAddress("Flavor",   &Flavor);
+	sigtree.SetBranchAddress("Charge",   &charge);
+	sigtree.SetBranchAddress("pT1",      &pT1);
+	sigtree.SetBranchAddress("pT2",      &pT2);
+	sigtree.SetBranchAddress("eta1",     &eta1);
+	sigtree.SetBranchAddress("eta2",     &eta2);
+	sigtree.SetBranchAddress("TLCat",    &TLCat);
+	sigtree.SetBranchAddress("HT",       &HT);
+	sigtree.SetBranchAddress("MET",      &MET);
+	sigtree.SetBranchAddress("MT2",      &MT2);
+	sigtree.SetBranchAddress("NJ",       &NJ);
+	sigtree.SetBranchAddress("NbJ",      &NbJ);
+	sigtree.SetBranchAddress("NbJmed",   &NbJmed);
+	sigtree.SetBranchAddress("Mll",      &mll);
+	sigtree.SetBranchAddress("PassZVeto",&passZVeto);
+	sigtree.SetBranchAddress("Pass3rdSFLepVeto",&passes3rdSFLepVeto);
 	
 	
 	// {  0 ,   1  ,    2   ,   3  ,   4  ,   5  ,    6    ,   7   ,      8     ,      9      }
@@ -6752,9 +6807,9 @@ void SSDLPlotter::makeTTWNLOPlot(vector<TString> diffVarName, vector<int> nbins,
 		histoname = "TTW_LO_to_NLO_Ratio_" + diffVarName[i];   h_HT_ratio .push_back(new TH1D(histoname , histoname, nbins[i], xmin[i], xmax[i]));   h_HT_ratio[i]  ->Sumw2();
 	}
 	
-	for( int i = 0; i < sigtree->GetEntries(); i++ ){
-		showStatusBar(i, sigtree->GetEntries(), 10000);
-		sigtree->GetEntry(i);
+	for( int i = 0; i < sigtree.GetEntries(); i++ ){
+		showStatusBar(i, sigtree.GetEntries(), 10000);
+		sigtree.GetEntry(i);
 		
 		if( flag != systflag ) continue;
 		if (*sname != "TTbarW" && *sname != "TTbarWNLO") continue;
@@ -6988,7 +7043,7 @@ void SSDLPlotter::makeTTWNLOPlot(vector<TString> diffVarName, vector<int> nbins,
 	
 }
 void SSDLPlotter::makePRLPlot1(){
-	FakeRatios *FR = new FakeRatios();
+	FakeRatios *FR = newFakeRatios();
 	const int nchans = 8;
 	TString axis_labels_1[nchans] = {
 		"H_{T} >  80",
@@ -8045,7 +8100,7 @@ void SSDLPlotter::makeAllIntPredictions(){
 	  h_pred_mc   ->SetBinError(i+1, sqrt(sspreds[reg].rare_err*sspreds[reg].rare_err + sspreds[reg].rare_stat*sspreds[reg].rare_stat));
 	  h_pred_ttw  ->SetBinError(i+1, sqrt(sspreds[reg].wz_err  *sspreds[reg].wz_err   + sspreds[reg].wz_stat  *sspreds[reg].wz_stat  ));
 	}
-	FakeRatios *FR = new FakeRatios();
+	FakeRatios *FR = newFakeRatios();
 	FR->setNToyMCs(100);
 	FR->setAddESyst(0.5);
 
@@ -9184,7 +9239,7 @@ SSPrediction SSDLPlotter::makeIntPrediction(TString filename, int reg){
  	///////////////////////////////////////////////////////////////////////////////////
  	// PREDICTIONS ////////////////////////////////////////////////////////////////////
  	///////////////////////////////////////////////////////////////////////////////////
- 	FakeRatios *FR = new FakeRatios();
+ 	FakeRatios *FR = newFakeRatios();
  	FR->setNToyMCs(100);
  	FR->setAddESyst(0.5);
  
@@ -10039,7 +10094,7 @@ TTWZPrediction SSDLPlotter::makeIntPredictionTTW(TString filename, int reg){
 	///////////////////////////////////////////////////////////////////////////////////
 	// PREDICTIONS ////////////////////////////////////////////////////////////////////
 	///////////////////////////////////////////////////////////////////////////////////
-	FakeRatios *FR = new FakeRatios();
+	FakeRatios *FR = newFakeRatios();
 	FR->setNToyMCs(100);
 	FR->setAddESyst(0.5);
 	// FR->setAddESyst(0.0);
@@ -12280,7 +12335,7 @@ void SSDLPlotter::makeTTWDiffPredictionSigEvent(vector<TString> diffVarName, vec
 	calculateRatio(fEGData, Elec, SigSup, elfratio_data, elfratio_data_e);
 	calculateRatio(fEGData, Elec, ZDecay, elpratio_data, elpratio_data_e);
 	
-	FakeRatios *FR = new FakeRatios();
+	FakeRatios *FR = newFakeRatios();
 	
 	float fbb(0.),fee(0.),feb(0.);
 	float fbbE(0.),feeE(0.),febE(0.);
@@ -12357,8 +12412,7 @@ void SSDLPlotter::makeTTWDiffPredictionSigEvent(vector<TString> diffVarName, vec
 	// SIGEVENT TREE //////////////////////////////////////////////////////////////////
 	///////////////////////////////////////////////////////////////////////////////////
 	
-	TFile *pFile = TFile::Open(fOutputFileName);
-	TTree *sigtree; getObjectSafe(pFile, "SigEvents", sigtree);
+	SigEventReader sigtree(getSigEvents());
 	
 	string *sname = 0;
 	int flag(0);
@@ -12372,30 +12426,30 @@ void SSDLPlotter::makeTTWDiffPredictionSigEvent(vector<TString> diffVarName, vec
 	string samplename;
 	TString flavorString = "";
 	
-	sigtree->SetBranchAddress("SystFlag", &flag);
-	sigtree->SetBranchAddress("Event",    &event);
-	sigtree->SetBranchAddress("Run",      &run);
-	sigtree->SetBranchAddress("SName",    &sname);
-	sigtree->SetBranchAddress("SType",    &SType);
-	sigtree->SetBranchAddress("PUWeight", &puweight);
-	sigtree->SetBranchAddress("SLumi",    &SLumi);
-	sigtree->SetBranchAddress("Flavor",   &Flavor);
-	sigtree->SetBranchAddress("Charge",   &charge);
-	sigtree->SetBranchAddress("pT1",      &pT1);
-	sigtree->SetBranchAddress("pT2",      &pT2);
-	sigtree->SetBranchAddress("eta1",     &eta1);
-	sigtree->SetBranchAddress("eta2",     &eta2);
-	sigtree->SetBranchAddress("TLCat",    &TLCat);
-	sigtree->SetBranchAddress("HT",       &HT);
-	sigtree->SetBranchAddress("MET",      &MET);
-	sigtree->SetBranchAddress("MT2",      &MT2);
-	sigtree->SetBranchAddress("NJ",       &NJ);
-	sigtree->SetBranchAddress("NbJ",      &NbJ);
-	sigtree->SetBranchAddress("NbJmed",   &NbJmed);
-	sigtree->SetBranchAddress("Mll",      &mll);
-	sigtree->SetBranchAddress("PassZVeto",&passZVeto);
-	sigtree->SetBranchAddress("Pass3rdSFLepVeto",&passes3rdSFLepVeto);
-	sigtree->SetBranchAddress("HLTSF",    &HLTSF);
+	sigtree.SetBranchAddress("SystFlag", &flag);
+	sigtree.SetBranchAddress("Event",    &event);
+	sigtree.SetBranchAddress("Run",      &run);
+	sigtree.SetBranchAddress("SName",    &sname);
+	sigtree.SetBranchAddress("SType",    &SType);
+	sigtree.SetBranchAddress("PUWeight", &puweight);
+	sigtree.SetBranchAddress("SLumi",    &SLumi);
+	sigtree.SetBranchAddress("Flavor",   &Flavor);
+	sigtree.SetBranchAddress("Charge",   &charge);
+	sigtree.SetBranchAddress("pT1",      &pT1);
+	sigtree.SetBranchAddress("pT2",      &pT2);
+	sigtree.SetBranchAddress("eta1",     &eta1);
+	sigtree.SetBranchAddress("eta2",     &eta2);
+	sigtree.SetBranchAddress("TLCat",    &TLCat);
+	sigtree.SetBranchAddress("HT",       &HT);
+	sigtree.SetBranchAddress("MET",      &MET);
+	sigtree.SetBranchAddress("MT2",      &MT2);
+	sigtree.SetBranchAddress("NJ",       &NJ);
+	sigtree.SetBranchAddress("NbJ",      &NbJ);
+	sigtree.SetBranchAddress("NbJmed",   &NbJmed);
+	sigtree.SetBranchAddress("Mll",      &mll);
+	sigtree.SetBranchAddress("PassZVeto",&passZVeto);
+	sigtree.SetBranchAddress("Pass3rdSFLepVeto",&passes3rdSFLepVeto);
+	sigtree.SetBranchAddress("HLTSF",    &HLTSF);
 	
 	float trigScale[3] = {gMMTrigScale, gEMTrigScale, gEETrigScale};
 	
@@ -12407,9 +12461,9 @@ void SSDLPlotter::makeTTWDiffPredictionSigEvent(vector<TString> diffVarName, vec
 	if (flavor_sel ==  4) flavorString = "_EM_OS";
 	if (flavor_sel ==  5) flavorString = "_EE_OS";
 	
-	for( int i = 0; i < sigtree->GetEntries(); i++ ){
-		showStatusBar(i, sigtree->GetEntries(), 10000);
-		sigtree->GetEntry(i);
+	for( int i = 0; i < sigtree.GetEntries(); i++ ){
+		showStatusBar(i, sigtree.GetEntries(), 10000);
+		sigtree.GetEntry(i);
 		
 		
 		if( flag != systflag ) continue;
@@ -13259,8 +13313,7 @@ void SSDLPlotter::makeKinematicPlotsPaper(){
 	float nt2_wz_mc_mm_e2(0.), nt2_wz_mc_em_e2(0.), nt2_wz_mc_ee_e2(0.);
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-	TFile *pFile = TFile::Open(fOutputFileName);
-	TTree *sigtree; getObjectSafe(pFile, "SigEvents", sigtree);
+	SigEventReader sigtree(getSigEvents());
 	
 	string *sname = 0;
 	int flag;
@@ -13271,31 +13324,31 @@ void SSDLPlotter::makeKinematicPlotsPaper(){
 	int charge;
 	int passZVeto, passes3rdSFLepVeto;
 
-	sigtree->SetBranchAddress("SystFlag", &flag);
-	sigtree->SetBranchAddress("Event",    &event);
-	sigtree->SetBranchAddress("Run",      &run);
-	sigtree->SetBranchAddress("SName",    &sname);
-	sigtree->SetBranchAddress("SType",    &SType);
-	sigtree->SetBranchAddress("PUWeight", &puweight);
-	sigtree->SetBranchAddress("SLumi",    &SLumi);
-	sigtree->SetBranchAddress("Flavor",   &Flavor);
-	sigtree->SetBranchAddress("Charge",   &charge);
-	sigtree->SetBranchAddress("pT1",      &pT1);
-	sigtree->SetBranchAddress("pT2",      &pT2);
-	sigtree->SetBranchAddress("eta1",     &eta1);
-	sigtree->SetBranchAddress("eta2",     &eta2);
-	sigtree->SetBranchAddress("TLCat",    &TLCat);
-	sigtree->SetBranchAddress("HT",       &HT);
-	sigtree->SetBranchAddress("MET",      &MET);
-	sigtree->SetBranchAddress("MT2",      &MT2);
-	sigtree->SetBranchAddress("NJ",       &NJ);
-	sigtree->SetBranchAddress("NbJ",      &NbJ);
-	sigtree->SetBranchAddress("NbJmed",   &NbJmed);
-	sigtree->SetBranchAddress("Mll",      &mll);
-	sigtree->SetBranchAddress("PassZVeto",&passZVeto);
-	sigtree->SetBranchAddress("Pass3rdSFLepVeto",&passes3rdSFLepVeto);
-
-	FakeRatios *FR = new FakeRatios();
+	sigtree.SetBranchAddress("SystFlag", &flag);
+	sigtree.SetBranchAddress("Event",    &event);
+	sigtree.SetBranchAddress("Run",      &run);
+	sigtree.SetBranchAddress("SName",    &sname);
+	sigtree.SetBranchAddress("SType",    &SType);
+	sigtree.SetBranchAddress("PUWeight", &puweight);
+	sigtree.SetBranchAddress("SLumi",    &SLumi);
+	sigtree.SetBranchAddress("Flavor",   &Flavor);
+	sigtree.SetBranchAddress("Charge",   &charge);
+	sigtree.SetBranchAddress("pT1",      &pT1);
+	sigtree.SetBranchAddress("pT2",      &pT2);
+	sigtree.SetBranchAddress("eta1",     &eta1);
+	sigtree.SetBranchAddress("eta2",     &eta2);
+	sigtree.SetBranchAddress("TLCat",    &TLCat);
+	sigtree.SetBranchAddress("HT",       &HT);
+	sigtree.SetBranchAddress("MET",      &MET);
+	sigtree.SetBranchAddress("MT2",      &MT2);
+	sigtree.SetBranchAddress("NJ",       &NJ);
+	sigtree.SetBranchAddress("NbJ",      &NbJ);
+	sigtree.SetBranchAddress("NbJmed",   &NbJmed);
+	sigtree.SetBranchAddress("Mll",      &mll);
+	sigtree.SetBranchAddress("PassZVeto",&passZVeto);
+	sigtree.SetBranchAddress("Pass3rdSFLepVeto",&passes3rdSFLepVeto);
+
+	FakeRatios *FR = newFakeRatios();
 
 	std::map< std::string, float > rareMapMM;
 	std::map< std::string, float > rareMapEM;
@@ -13315,8 +13368,8 @@ void SSDLPlotter::makeKinematicPlotsPaper(){
 
 	float trigScale[3] = {gMMTrigScale, gEMTrigScale, gEETrigScale};
 
-	for( int i = 0; i < sigtree->GetEntries(); i++ ){
-		sigtree->GetEntry(i);
+	for( int i = 0; i < sigtree.GetEntries(); i++ ){
+		sigtree.GetEntry(i);
 		
 		// if( flag != systflag ) continue;
 		
@@ -13701,8 +13754,8 @@ void SSDLPlotter::makeKinematicPlotsPaper(){
 
 	for(size_t i = 0; i < metbins; ++i){
 		const float FakeESyst2 = 0.25;
-		FakeRatios *FRhi = new FakeRatios();
-		FakeRatios *FRlo = new FakeRatios();
+		FakeRatios *FRhi = newFakeRatios();
+		FakeRatios *FRlo = newFakeRatios();
 		FRhi->setNToyMCs(100);  // speedup
 		FRhi->setAddESyst(0.5); // additional systematics
 		FRlo->setNToyMCs(100);  // speedup
@@ -13789,7 +13842,7 @@ void SSDLPlotter::makeKinematicPlotsPaper(){
 		float nt2_em_EE_os_hiht = flipsemEE_hiht_histoMET->GetBinContent(i+1);
 
 		// Errors
-		FakeRatios *FR = new FakeRatios();
+		FakeRatios *FR = newFakeRatios();
 
 		// // Simple error propagation assuming error on number of events is FR->getEStat2()
 		// nt11_ee_cm->SetBinContent(i+1, 2*fbb*nt2_ee_BB_os + 2*fee*nt2_ee_EE_os + 2*feb*nt2_ee_EB_os);
@@ -13840,8 +13893,8 @@ void SSDLPlotter::makeKinematicPlotsPaper(){
 
 	for(size_t i = 0; i < htbins; ++i){
 		const float FakeESyst2 = 0.25;
-		FakeRatios *FRhi = new FakeRatios();
-		FakeRatios *FRlo = new FakeRatios();
+		FakeRatios *FRhi = newFakeRatios();
+		FakeRatios *FRlo = newFakeRatios();
 		FRhi->setNToyMCs(100);  // speedup
 		FRhi->setAddESyst(0.5); // additional systematics
 		FRlo->setNToyMCs(100);  // speedup
@@ -13928,7 +13981,7 @@ void SSDLPlotter::makeKinematicPlotsPaper(){
 		float nt2_em_EE_os_hiht = flipsemEE_hiht_histoHT->GetBinContent(i+1);
 
 		// Errors
-		FakeRatios *FR = new FakeRatios();
+		FakeRatios *FR = newFakeRatios();
 
 		// // Simple error propagation assuming error on number of events is FR->getEStat2()
 		// nt11_ee_cm->SetBinContent(i+1, 2*fbb*nt2_ee_BB_os + 2*fee*nt2_ee_EE_os + 2*feb*nt2_ee_EB_os);
@@ -13979,8 +14032,8 @@ void SSDLPlotter::makeKinematicPlotsPaper(){
 
 	for(size_t i = 0; i < njbins; ++i){
 		const float FakeESyst2 = 0.25;
-		FakeRatios *FRhi = new FakeRatios();
-		FakeRatios *FRlo = new FakeRatios();
+		FakeRatios *FRhi = newFakeRatios();
+		FakeRatios *FRlo = newFakeRatios();
 		FRhi->setNToyMCs(100);  // speedup
 		FRhi->setAddESyst(0.5); // additional systematics
 		FRlo->setNToyMCs(100);  // speedup
@@ -14067,7 +14120,7 @@ void SSDLPlotter::makeKinematicPlotsPaper(){
 		float nt2_em_EE_os_hiht = flipsemEE_hiht_histoNJ->GetBinContent(i+1);
 
 		// Errors
-		FakeRatios *FR = new FakeRatios();
+		FakeRatios *FR = newFakeRatios();
 
 		// // Simple error propagation assuming error on number of events is FR->getEStat2()
 		// nt11_ee_cm->SetBinContent(i+1, 2*fbb*nt2_ee_BB_os + 2*fee*nt2_ee_EE_os + 2*feb*nt2_ee_EB_os);
@@ -14118,8 +14171,8 @@ void SSDLPlotter::makeKinematicPlotsPaper(){
 
 	for(size_t i = 0; i < nbjbins; ++i){
 		const float FakeESyst2 = 0.25;
-		FakeRatios *FRhi = new FakeRatios();
-		FakeRatios *FRlo = new FakeRatios();
+		FakeRatios *FRhi = newFakeRatios();
+		FakeRatios *FRlo = newFakeRatios();
 		FRhi->setNToyMCs(100);  // speedup
 		FRhi->setAddESyst(0.5); // additional systematics
 		FRlo->setNToyMCs(100);  // speedup
@@ -14206,7 +14259,7 @@ void SSDLPlotter::makeKinematicPlotsPaper(){
 		float nt2_em_EE_os_hiht = flipsemEE_hiht_histoNBJ->GetBinContent(i+1);
 
 		// Errors
-		FakeRatios *FR = new FakeRatios();
+		FakeRatios *FR = newFakeRatios();
 
 		// // Simple error propagation assuming error on number of events is FR->getEStat2()
 		// nt11_ee_cm->SetBinContent(i+1, 2*fbb*nt2_ee_BB_os + 2*fee*nt2_ee_EE_os + 2*feb*nt2_ee_EB_os);
@@ -14524,9 +14577,20 @@ TTWZPrediction SSDLPlotter::makePredictionSignalEvents(float minHT, float maxHT,
 	float nt2_wz_mc_mm_e2(0.), nt2_wz_mc_em_e2(0.), nt2_wz_mc_ee_e2(0.);
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-	TFile *pFile = TFile::Open(fOutputFileName);
-	TTree *sigtree; getObjectSafe(pFile, "SigEvents", sigtree);
-	
+	// Preselection on the columns, the pt cuts depend on the channel
+	SigEventTable *sigevents = getSigEvents();
+	vector<int> rows;
+	sigevents->Select(rows);
+	sigevents->Filter(rows, "SystFlag", systflag, systflag);
+	sigevents->Filter(rows, "Mll",      8.);
+	sigevents->Filter(rows, "HT",       minHT,  maxHT);
+	sigevents->Filter(rows, "MET",      minMET, maxMET);
+	sigevents->Filter(rows, "NJ",       minNjets);
+	sigevents->Filter(rows, "NbJ",      minNbjetsL);
+	sigevents->Filter(rows, "NbJmed",   minNbjetsM);
+
+	SigEventReader sigtree(sigevents);
+
 	string *sname = 0;
 	int flag;
 	int   SType, Flavor, TLCat, NJ, NbJ, NbJmed;
@@ -14536,33 +14600,33 @@ TTWZPrediction SSDLPlotter::makePredictionSignalEvents(float minHT, float maxHT,
 	int charge;
 	int passZVeto, passes3rdSFLepVeto;
 
-	sigtree->SetBranchAddress("SystFlag", &flag);
-	sigtree->SetBranchAddress("Event",    &event);
-	sigtree->SetBranchAddress("LS",       &ls);
-	sigtree->SetBranchAddress("Run",      &run);
-	sigtree->SetBranchAddress("SName",    &sname);
-	sigtree->SetBranchAddress("SType",    &SType);
-	sigtree->SetBranchAddress("PUWeight", &puweight);
-	sigtree->SetBranchAddress("SLumi",    &SLumi);
-	sigtree->SetBranchAddress("Flavor",   &Flavor);
-	sigtree->SetBranchAddress("Charge",   &charge);
-	sigtree->SetBranchAddress("pT1",      &pT1);
-	sigtree->SetBranchAddress("pT2",      &pT2);
-	sigtree->SetBranchAddress("eta1",     &eta1);
-	sigtree->SetBranchAddress("eta2",     &eta2);
-	sigtree->SetBranchAddress("TLCat",    &TLCat);
-	sigtree->SetBranchAddress("HT",       &HT);
-	sigtree->SetBranchAddress("MET",      &MET);
-	sigtree->SetBranchAddress("MT2",      &MT2);
-	sigtree->SetBranchAddress("NJ",       &NJ);
-	sigtree->SetBranchAddress("NbJ",      &NbJ);
-	sigtree->SetBranchAddress("NbJmed",   &NbJmed);
-	sigtree->SetBranchAddress("Mll",      &mll);
-	sigtree->SetBranchAddress("PassZVeto",&passZVeto);
-	sigtree->SetBranchAddress("Pass3rdSFLepVeto",&passes3rdSFLepVeto);
-	sigtree->SetBranchAddress("HLTSF",    &HLTSF);
-
-	FakeRatios *FR = new FakeRatios();
+	sigtree.SetBranchAddress("SystFlag", &flag);
+	sigtree.SetBranchAddress("Event",    &event);
+	sigtree.SetBranchAddress("LS",       &ls);
+	sigtree.SetBranchAddress("Run",      &run);
+	sigtree.SetBranchAddress("SName",    &sname);
+	sigtree.SetBranchAddress("SType",    &SType);
+	sigtree.SetBranchAddress("PUWeight", &puweight);
+	sigtree.SetBranchAddress("SLumi",    &SLumi);
+	sigtree.SetBranchAddress("Flavor",   &Flavor);
+	sigtree.SetBranchAddress("Charge",   &charge);
+	sigtree.SetBranchAddress("pT1",      &pT1);
+	sigtree.SetBranchAddress("pT2",      &pT2);
+	sigtree.SetBranchAddress("eta1",     &eta1);
+	sigtree.SetBranchAddress("eta2",     &eta2);
+	sigtree.SetBranchAddress("TLCat",    &TLCat);
+	sigtree.SetBranchAddress("HT",       &HT);
+	sigtree.SetBranchAddress("MET",      &MET);
+	sigtree.SetBranchAddress("MT2",      &MT2);
+	sigtree.SetBranchAddress("NJ",       &NJ);
+	sigtree.SetBranchAddress("NbJ",      &NbJ);
+	sigtree.SetBranchAddress("NbJmed",   &NbJmed);
+	sigtree.SetBranchAddress("Mll",      &mll);
+	sigtree.SetBranchAddress("PassZVeto",&passZVeto);
+	sigtree.SetBranchAddress("Pass3rdSFLepVeto",&passes3rdSFLepVeto);
+	sigtree.SetBranchAddress("HLTSF",    &HLTSF);
+
+	FakeRatios *FR = newFakeRatios();
 
 	std::map< std::string, float > rareMapMM;
 	std::map< std::string, float > rareMapEM;
@@ -14582,17 +14646,8 @@ TTWZPrediction SSDLPlotter::makePredictionSignalEvents(float minHT, float maxHT,
 
 	float trigScale[3] = {gMMTrigScale, gEMTrigScale, gEETrigScale};
 
-	for( int i = 0; i < sigtree->GetEntries(); i++ ){
-		sigtree->GetEntry(i);
-		
-		if( flag != systflag ) continue;
-		
-		if ( mll < 8.) continue;
-		if ( HT  < minHT  || HT  > maxHT)  continue;
-		if ( MET < minMET || MET > maxMET) continue;
-		if ( NJ  < minNjets)      continue;
-		if ( NbJ < minNbjetsL)    continue;
-		if ( NbJmed < minNbjetsM) continue;
+	for( size_t i = 0; i < rows.size(); i++ ){
+		sigtree.GetEntry(rows[i]);
 
 		gChannel chan = gChannel(Flavor);
 		if(chan == ElMu || Flavor == 4){
@@ -15355,6 +15410,352 @@ TTWZPrediction SSDLPlotter::makePredictionSignalEvents(float minHT, float maxHT,
 	return pred;
 
 }
+
+//____________________________________________________________________________
+bool SSDLPlotter::fillTTWYieldGrid(YieldGrid &grid, int chVeto, int flag){
+	// Fills the yields of makePredictionSignalEvents into a booked grid with
+	// gNCHANNELS*gNTTWGridYields slots and integrates it. The axes can be any
+	// of the cut variables of the prediction, lower thresholds only
+	const TString axisNames[7] = {"HT", "MET", "NJ", "NbJ", "NbJmed", "pT1", "pT2"};
+	if(grid.GetNSlots() != gNCHANNELS*gNTTWGridYields || grid.GetNCells() == 0){
+		cout << "SSDLPlotter::fillTTWYieldGrid ==> Error: grid is not booked with " << gNCHANNELS*gNTTWGridYields << " slots" << endl;
+		return false;
+	}
+	vector<int> axisVar(grid.GetNAxes(), -1);
+	for(int a = 0; a < grid.GetNAxes(); ++a){
+		for(int v = 0; v < 7; ++v) if(grid.GetAxisName(a) == axisNames[v]) axisVar[a] = v;
+		if(axisVar[a] < 0){
+			cout << "SSDLPlotter::fillTTWYieldGrid ==> Error: cannot cut on " << grid.GetAxisName(a) << endl;
+			return false;
+		}
+	}
+
+	// Charge misID probabilities, applied to the OS yields in getTTWPrediction
+	float fbb(0.), fee(0.), feb(0.);
+	float fbbE(0.), feeE(0.), febE(0.);
+	calculateChMisIdProb(fEGData, BB, fbb, fbbE);
+	calculateChMisIdProb(fEGData, EB, feb, febE);
+	calculateChMisIdProb(fEGData, EE, fee, feeE);
+	grid.SetParameter("fbb", fbb); grid.SetParameter("fbbE", fbbE);
+	grid.SetParameter("feb", feb); grid.SetParameter("febE", febE);
+	grid.SetParameter("fee", fee); grid.SetParameter("feeE", feeE);
+
+	SigEventTable *sigevents = getSigEvents();
+	vector<int> rows;
+	sigevents->Select(rows);
+	sigevents->Filter(rows, "SystFlag", flag, flag);
+	sigevents->Filter(rows, "Mll",      8.);
+
+	SigEventReader sigtree(sigevents);
+
+	string *sname = 0;
+	int   SType, Flavor, TLCat, NJ, NbJ, NbJmed, charge, passZVeto;
+	float puweight, pT1, pT2, eta1, eta2, HT, MET, HLTSF;
+
+	sigtree.SetBranchAddress("SName",    &sname);
+	sigtree.SetBranchAddress("SType",    &SType);
+	sigtree.SetBranchAddress("PUWeight", &puweight);
+	sigtree.SetBranchAddress("Flavor",   &Flavor);
+	sigtree.SetBranchAddress("Charge",   &charge);
+	sigtree.SetBranchAddress("pT1",      &pT1);
+	sigtree.SetBranchAddress("pT2",      &pT2);
+	sigtree.SetBranchAddress("eta1",     &eta1);
+	sigtree.SetBranchAddress("eta2",     &eta2);
+	sigtree.SetBranchAddress("TLCat",    &TLCat);
+	sigtree.SetBranchAddress("HT",       &HT);
+	sigtree.SetBranchAddress("MET",      &MET);
+	sigtree.SetBranchAddress("NJ",       &NJ);
+	sigtree.SetBranchAddress("NbJ",      &NbJ);
+	sigtree.SetBranchAddress("NbJmed",   &NbJmed);
+	sigtree.SetBranchAddress("PassZVeto",&passZVeto);
+	sigtree.SetBranchAddress("HLTSF",    &HLTSF);
+
+	FakeRatios *FR = newFakeRatios();
+	const float chargeFactor = chVeto ? 0.5:1.;
+	double vars[7];
+	vector<double> values(grid.GetNAxes());
+
+	for( size_t i = 0; i < rows.size(); i++ ){
+		sigtree.GetEntry(rows[i]);
+
+		gChannel chan = gChannel(Flavor);
+		if(Flavor == 4) chan = ElMu;
+		if(Flavor == 5) chan = Elec;
+		if(Flavor == 3 || Flavor > 5) continue;
+
+		vars[0] = HT; vars[1] = MET; vars[2] = NJ; vars[3] = NbJ; vars[4] = NbJmed;
+		vars[5] = pT1; vars[6] = pT2;
+		if(chan == ElMu){ // pt cuts on the leading and subleading lepton
+			vars[5] = TMath::Max(pT1, pT2);
+			vars[6] = TMath::Min(pT1, pT2);
+		}
+		for(int a = 0; a < grid.GetNAxes(); ++a) values[a] = vars[axisVar[a]];
+		const Long64_t cell = grid.FindCell(&values[0]);
+		if(cell < 0) continue;
+		const int slot = chan*gNTTWGridYields;
+
+		if(SType < 3){
+			if(Flavor < 3){
+				if (gApplyZVeto && passZVeto == 0)  continue;
+				if (chVeto && charge != chVeto ) continue;
+				Sample *S = fSampleMap[TString(*sname)];
+
+				// muon first in e-mu events
+				const gChannel chan1 = (chan == ElMu) ? Muon : chan;
+				const gChannel chan2 = (chan == ElMu) ? Elec : chan;
+				const float f1 = getFRatio(chan1, pT1, eta1, S->datamc);
+				const float f2 = getFRatio(chan2, pT2, eta2, S->datamc);
+				const float p1 = getPRatio(chan1, pT1, S->datamc);
+				const float p2 = getPRatio(chan2, pT2, S->datamc);
+				const float nf = FR->getWpf(FakeRatios::gTLCat(TLCat), f1, f2, p1, p2)
+				               + FR->getWfp(FakeRatios::gTLCat(TLCat), f1, f2, p1, p2)
+				               + FR->getWff(FakeRatios::gTLCat(TLCat), f1, f2, p1, p2);
+				grid.Fill(cell, slot+TTWGridFake,  nf);
+				grid.Fill(cell, slot+TTWGridFake2, nf*nf);
+				if(TLCat == 0) grid.Fill(cell, slot+TTWGridObs);
+			}
+			if(Flavor == 4){
+				if (TLCat == 0) grid.Fill(cell, slot+TTWGridOSBB, chargeFactor);
+				if (TLCat == 1) grid.Fill(cell, slot+TTWGridOSEE, chargeFactor);
+			}
+			if(Flavor == 5){
+				if (TLCat == 0)               grid.Fill(cell, slot+TTWGridOSBB, chargeFactor);
+				if (TLCat == 1 || TLCat == 2) grid.Fill(cell, slot+TTWGridOSEB, chargeFactor);
+				if (TLCat == 3)               grid.Fill(cell, slot+TTWGridOSEE, chargeFactor);
+			}
+		}
+
+		if(SType == 15 && TLCat == 0){
+			if (*sname == "WWTo2L2Nu") continue;
+			if (Flavor > 2) continue;
+			if (chVeto && charge != chVeto ) continue;
+			Sample *S = fSampleMap[*sname];
+			const float w = puweight*HLTSF*fLumiNorm/S->getLumi();
+			int yield = TTWGridRare;
+			if(*sname == "WZTo3LNu") yield = TTWGridWZ;
+			if(*sname == "TTbarW")   yield = TTWGridTTW;
+			if(*sname == "TTbarZ")   yield = TTWGridTTZ;
+			grid.Fill(cell, slot+yield,   w);
+			grid.Fill(cell, slot+yield+1, w*w);
+		}
+	}
+	delete FR;
+
+	grid.Integrate();
+	return true;
+}
+
+TTWZPrediction SSDLPlotter::getTTWPrediction(const YieldGrid &grid, Long64_t cut, FakeRatios *FR, bool ttw){
+	// Same yields as makePredictionSignalEvents at the cut point of the grid,
+	// without the printout. The statistical errors of the fakes and of the MC
+	// are only approximated by the sums of squared event weights, good enough
+	// to rank the cut points but not to quote them. FR is for getEStat2
+	const float RareESyst2 = 0.5*0.5;
+	const float FakeESyst2 = 0.5*0.5;
+	const float WZESyst2   = 0.15*0.15;
+	const float TTZESyst2  = 0.5*0.5;
+	const float TTWESyst2  = 0.5*0.5;
+
+	TTWZPrediction pred = TTWZPrediction();
+	if(cut < 0 || !grid.IsIntegrated()){
+		cout << "SSDLPlotter::getTTWPrediction ==> Error: cut point is not on the grid" << endl;
+		return pred;
+	}
+
+	float obs[3], fake[3], fake_e2[3], cmid[3], cmid_e1[3], cmid_e2[3];
+	float rare[3], rare_e2[3], wz[3], wz_e2[3], ttz[3], ttz_e2[3], ttw_[3], ttw_e2[3];
+	const float fbb = grid.GetParameter("fbb"), fbbE = grid.GetParameter("fbbE");
+	const float feb = grid.GetParameter("feb"), febE = grid.GetParameter("febE");
+	const float fee = grid.GetParameter("fee"), feeE = grid.GetParameter("feeE");
+	for(int c = 0; c < gNCHANNELS; ++c){
+		const int slot = c*gNTTWGridYields;
+		obs[c]     = grid.GetSum(cut, slot+TTWGridObs);
+		fake[c]    = grid.GetSum(cut, slot+TTWGridFake);
+		fake_e2[c] = grid.GetSum(cut, slot+TTWGridFake2);
+		rare[c]    = grid.GetSum(cut, slot+TTWGridRare);
+		rare_e2[c] = grid.GetSum(cut, slot+TTWGridRare2);
+		wz[c]      = grid.GetSum(cut, slot+TTWGridWZ);
+		wz_e2[c]   = grid.GetSum(cut, slot+TTWGridWZ2);
+		ttz[c]     = grid.GetSum(cut, slot+TTWGridTTZ);
+		ttz_e2[c]  = grid.GetSum(cut, slot+TTWGridTTZ2);
+		ttw_[c]    = grid.GetSum(cut, slot+TTWGridTTW);
+		ttw_e2[c]  = grid.GetSum(cut, slot+TTWGridTTW2);
+		if(!ttw){
+			rare[c] += ttw_[c] + ttz[c]; rare_e2[c] += ttw_e2[c] + ttz_e2[c];
+			ttw_[c] = ttw_e2[c] = ttz[c] = ttz_e2[c] = 0.;
+		}
+
+		const float nBB = grid.GetSum(cut, slot+TTWGridOSBB);
+		const float nEB = grid.GetSum(cut, slot+TTWGridOSEB);
+		const float nEE = grid.GetSum(cut, slot+TTWGridOSEE);
+		const float s = (c == Elec) ? 2. : 1.; // both electrons can be mismeasured
+		cmid[c]    = s*(fbb*nBB + fee*nEE + feb*nEB);
+		cmid_e1[c] = s*sqrt(fbb*fbb*FR->getEStat2(nBB) + fee*fee*FR->getEStat2(nEE) + feb*feb*FR->getEStat2(nEB));
+		cmid_e2[c] = s*sqrt(fbbE*fbbE*nBB*nBB + feeE*feeE*nEE*nEE + febE*febE*nEB*nEB);
+	}
+	cmid[Muon] = cmid_e1[Muon] = cmid_e2[Muon] = 0.;
+
+	pred.obs_mm = obs[Muon]; pred.obs_em = obs[ElMu]; pred.obs_ee = obs[Elec];
+	pred.obs    = pred.obs_mm + pred.obs_em + pred.obs_ee;
+
+	pred.ttw_mm = ttw_[Muon]; pred.ttw_em = ttw_[ElMu]; pred.ttw_ee = ttw_[Elec];
+	pred.ttw    = pred.ttw_mm + pred.ttw_em + pred.ttw_ee;
+	pred.ttw_err_mm = sqrt(ttw_e2[Muon] + TTWESyst2*ttw_[Muon]*ttw_[Muon]);
+	pred.ttw_err_em = sqrt(ttw_e2[ElMu] + TTWESyst2*ttw_[ElMu]*ttw_[ElMu]);
+	pred.ttw_err_ee = sqrt(ttw_e2[Elec] + TTWESyst2*ttw_[Elec]*ttw_[Elec]);
+	pred.ttw_err    = sqrt(ttw_e2[Muon] + ttw_e2[ElMu] + ttw_e2[Elec] + TTWESyst2*pred.ttw*pred.ttw);
+
+	pred.ttz_mm = ttz[Muon]; pred.ttz_em = ttz[ElMu]; pred.ttz_ee = ttz[Elec];
+	pred.ttz    = pred.ttz_mm + pred.ttz_em + pred.ttz_ee;
+	pred.ttz_err_mm = sqrt(ttz_e2[Muon] + TTZESyst2*ttz[Muon]*ttz[Muon]);
+	pred.ttz_err_em = sqrt(ttz_e2[ElMu] + TTZESyst2*ttz[ElMu]*ttz[ElMu]);
+	pred.ttz_err_ee = sqrt(ttz_e2[Elec] + TTZESyst2*ttz[Elec]*ttz[Elec]);
+	pred.ttz_err    = sqrt(ttz_e2[Muon] + ttz_e2[ElMu] + ttz_e2[Elec] + TTZESyst2*pred.ttz*pred.ttz);
+
+	pred.ttwz_mm = pred.ttw_mm + pred.ttz_mm;
+	pred.ttwz_em = pred.ttw_em + pred.ttz_em;
+	pred.ttwz_ee = pred.ttw_ee + pred.ttz_ee;
+	pred.ttwz    = pred.ttw    + pred.ttz;
+
+	pred.fake_mm = fake[Muon]; pred.fake_em = fake[ElMu]; pred.fake_ee = fake[Elec];
+	pred.fake    = pred.fake_mm + pred.fake_em + pred.fake_ee;
+	pred.fake_err_mm = sqrt(fake_e2[Muon] + FakeESyst2*fake[Muon]*fake[Muon]);
+	pred.fake_err_em = sqrt(fake_e2[ElMu] + FakeESyst2*fake[ElMu]*fake[ElMu]);
+	pred.fake_err_ee = sqrt(fake_e2[Elec] + FakeESyst2*fake[Elec]*fake[Elec]);
+	pred.fake_err    = sqrt(fake_e2[Muon] + fake_e2[ElMu] + fake_e2[Elec] + FakeESyst2*pred.fake*pred.fake);
+
+	pred.cmid_em     = cmid[ElMu]; pred.cmid_ee = cmid[Elec];
+	pred.cmid        = pred.cmid_em + pred.cmid_ee;
+	pred.cmid_err_em = sqrt(cmid_e1[ElMu]*cmid_e1[ElMu] + cmid_e2[ElMu]*cmid_e2[ElMu]);
+	pred.cmid_err_ee = sqrt(cmid_e1[Elec]*cmid_e1[Elec] + cmid_e2[Elec]*cmid_e2[Elec]);
+	pred.cmid_err    = sqrt(pred.cmid_err_em*pred.cmid_err_em + pred.cmid_err_ee*pred.cmid_err_ee);
+
+	pred.wz_mm = wz[Muon]; pred.wz_em = wz[ElMu]; pred.wz_ee = wz[Elec];
+	pred.wz    = pred.wz_mm + pred.wz_em + pred.wz_ee;
+	pred.wz_err_mm = sqrt(wz_e2[Muon] + WZESyst2*wz[Muon]*wz[Muon]);
+	pred.wz_err_em = sqrt(wz_e2[ElMu] + WZESyst2*wz[ElMu]*wz[ElMu]);
+	pred.wz_err_ee = sqrt(wz_e2[Elec] + WZESyst2*wz[Elec]*wz[Elec]);
+	pred.wz_err    = sqrt(wz_e2[Muon] + wz_e2[ElMu] + wz_e2[Elec] + WZESyst2*pred.wz*pred.wz);
+
+	pred.rare_mm = rare[Muon]; pred.rare_em = rare[ElMu]; pred.rare_ee = rare[Elec];
+	pred.rare    = pred.rare_mm + pred.rare_em + pred.rare_ee;
+	pred.rare_err_mm = sqrt(rare_e2[Muon] + RareESyst2*rare[Muon]*rare[Muon]);
+	pred.rare_err_em = sqrt(rare_e2[ElMu] + RareESyst2*rare[ElMu]*rare[ElMu]);
+	pred.rare_err_ee = sqrt(rare_e2[Elec] + RareESyst2*rare[Elec]*rare[Elec]);
+	pred.rare_err    = sqrt(rare_e2[Muon] + rare_e2[ElMu] + rare_e2[Elec] + RareESyst2*pred.rare*pred.rare);
+
+	// total background, as in makePredictionSignalEvents
+	float stat2[3], syst2[3];
+	for(int c = 0; c < gNCHANNELS; ++c){
+		stat2[c] = fake_e2[c] + cmid_e1[c]*cmid_e1[c] + rare_e2[c] + ttz_e2[c] + wz_e2[c];
+		syst2[c] = FakeESyst2*fake[c]*fake[c] + cmid_e2[c]*cmid_e2[c] + RareESyst2*(rare[c]+ttz[c])*(rare[c]+ttz[c]) + WZESyst2*wz_e2[c];
+	}
+	pred.tot_mm = fake[Muon] + cmid[Muon] + rare[Muon] + wz[Muon] + ttz[Muon];
+	pred.tot_em = fake[ElMu] + cmid[ElMu] + rare[ElMu] + wz[ElMu] + ttz[ElMu];
+	pred.tot_ee = fake[Elec] + cmid[Elec] + rare[Elec] + wz[Elec] + ttz[Elec];
+	pred.tot    = pred.tot_mm + pred.tot_em + pred.tot_ee;
+	pred.tot_err_mm = sqrt(stat2[Muon] + syst2[Muon]);
+	pred.tot_err_em = sqrt(stat2[ElMu] + syst2[ElMu]);
+	pred.tot_err_ee = sqrt(stat2[Elec] + syst2[Elec]);
+	pred.tot_err    = sqrt(stat2[Muon] + stat2[ElMu] + stat2[Elec]
+	                     + FakeESyst2*pred.fake*pred.fake + RareESyst2*(pred.rare+pred.ttz)*(pred.rare+pred.ttz) + WZESyst2*pred.wz*pred.wz
+	                     + cmid_e2[ElMu]*cmid_e2[ElMu] + cmid_e2[Elec]*cmid_e2[Elec]);
+	return pred;
+}
+
+YieldGrid* SSDLPlotter::makeTTWYieldGrid(const vector<vector<double> > &thresholds, int chVeto, int flag){
+	const TString axisNames[7] = {"HT", "MET", "NJ", "NbJ", "NbJmed", "pT1", "pT2"};
+	if(thresholds.size() != 7){
+		cout << "SSDLPlotter::makeTTWYieldGrid ==> Error: need the thresholds of HT, MET, NJ, NbJ, NbJmed, pT1 and pT2" << endl;
+		return 0;
+	}
+	YieldGrid *grid = new YieldGrid(gNCHANNELS*gNTTWGridYields);
+	for(int a = 0; a < 7; ++a) grid->AddAxis(axisNames[a], thresholds[a]);
+	if(grid->GetNAxes() != 7 || !grid->Book() || !fillTTWYieldGrid(*grid, chVeto, flag)){
+		delete grid;
+		return 0;
+	}
+	cout << "SSDLPlotter::makeTTWYieldGrid ==> Filled yield grid with " << grid->GetNCells() << " cut points" << endl;
+	return grid;
+}
+
+void SSDLPlotter::scanTTWYieldGrid(const YieldGrid &grid, float lumi, float lumiSF_fake, TString outputdir, float (*computeZBi)(float, float, float), int chVeto){
+	// The cut points are ranked on the grid. The best one of each signal
+	// efficiency step is then redone with makePredictionSignalEvents, such
+	// that the quoted yields and errors are the same as for the cut files
+	const float lumiSF = lumi/fLumiNorm;
+	FakeRatios *FR = newFakeRatios();
+
+	float ZBi_best[11];
+	Long64_t cut_best[11];
+	for(int i = 0; i < 11; ++i){
+		ZBi_best[i] = 0.;
+		cut_best[i] = -1;
+	}
+
+	for(Long64_t cut = 0; cut < grid.GetNCells(); ++cut){
+		const TTWZPrediction pred = getTTWPrediction(grid, cut, FR);
+		float b, b_err, s;
+		getTTWZBiInputs(pred, lumiSF, lumiSF_fake, b, b_err, s);
+		if(s <= 0. || b <= 0.) continue;
+
+		const float ZBi  = (*computeZBi)(s+b, b, b_err);
+		const int   iEff = int(10.*s/(0.232*lumi*0.22*0.22*0.67));
+		if(iEff < 0 || iEff > 10) continue;
+		if(ZBi > ZBi_best[iEff]){
+			ZBi_best[iEff] = ZBi;
+			cut_best[iEff] = cut;
+		}
+	}
+	delete FR;
+	cout << "SSDLPlotter::scanTTWYieldGrid ==> Scanned " << grid.GetNCells() << " cut points" << endl;
+
+	ofstream OUT(outputdir + "/ZBiGridScan.txt", ios::trunc);
+	OUT << "Best cuts on the yield grid, expected for " << lumi/1000. << " fb-1:" << endl;
+	OUT << "Seff   \tS     \tB +- s(B)\tZBi";
+	for(int a = 0; a < grid.GetNAxes(); ++a) OUT << "\t" << grid.GetAxisName(a);
+	OUT << endl;
+
+	for(int i = 0; i < 11; ++i){
+		if(cut_best[i] < 0) continue;
+		float th[7];
+		for(int a = 0; a < 7; ++a) th[a] = grid.GetThreshold(cut_best[i], a);
+
+		const TTWZPrediction pred = makePredictionSignalEvents(th[0], 10000., th[1], 10000., int(th[2]), int(th[3]), int(th[4]), th[5], th[6], chVeto, true);
+		float b, b_err, s;
+		getTTWZBiInputs(pred, lumiSF, lumiSF_fake, b, b_err, s);
+		const float ZBi  = (*computeZBi)(s+b, b, b_err);
+		const float effS = s/(0.232*lumi*0.22*0.22*0.67);
+
+		OUT << effS << "\t" << s << "\t" << b << " +- " << b_err << "\t" << ZBi;
+		for(int a = 0; a < 7; ++a) OUT << "\t" << th[a];
+		OUT << endl;
+
+		// same format as the cuts_Seff files
+		ofstream CUTS(outputdir + Form("/gridcuts_Seff%d.txt", i*10), ios::trunc);
+		for(int a = 0; a < 7; ++a) CUTS << grid.GetAxisName(a) << " " << th[a] << " 10000." << endl;
+		CUTS.close();
+	}
+	OUT.close();
+	cout << "SSDLPlotter::scanTTWYieldGrid ==> Best cuts on the grid written to " << outputdir << "/ZBiGridScan.txt" << endl;
+}
+
+void SSDLPlotter::getTTWZBiInputs(const TTWZPrediction &pred, float lumiSF, float lumiSF_fake, float &b, float &b_err, float &s){
+	// Background, its error and the ttW signal scaled to the luminosity, with
+	// the fakes and charge misID from data scaled separately
+	const float b_mm = (pred.rare_mm+pred.wz_mm+pred.ttz_mm)*lumiSF + (pred.fake_mm             )*lumiSF_fake;
+	const float b_em = (pred.rare_em+pred.wz_em+pred.ttz_em)*lumiSF + (pred.fake_em+pred.cmid_em)*lumiSF_fake;
+	const float b_ee = (pred.rare_ee+pred.wz_ee+pred.ttz_ee)*lumiSF + (pred.fake_ee+pred.cmid_ee)*lumiSF_fake;
+
+	const float b_mm_err = (pred.rare_err_mm+pred.wz_err_mm)*lumiSF + (pred.fake_err_mm                 )*lumiSF_fake;
+	const float b_em_err = (pred.rare_err_em+pred.wz_err_em)*lumiSF + (pred.fake_err_em+pred.cmid_err_em)*lumiSF_fake;
+	const float b_ee_err = (pred.rare_err_ee+pred.wz_err_ee)*lumiSF + (pred.fake_err_ee+pred.cmid_err_ee)*lumiSF_fake;
+
+	b     = b_mm + b_em + b_ee;
+	b_err = sqrt(b_mm_err*b_mm_err + b_em_err*b_em_err + b_ee_err*b_ee_err);
+	s     = pred.ttw*lumiSF;
+}
+
 void SSDLPlotter::makeTTWKinPlotsSigEvent() {
 	vector<TString> diffVarName, xAxisTitle, yAxisTitle;
 	vector<int> nbins;
@@ -15580,7 +15981,7 @@ void SSDLPlotter::makeTTWKinPlotSigEvent(vector<TString> diffVarName, vector<int
 	// RATIOS /////////////////////////////////////////////////////////////////////////
 	///////////////////////////////////////////////////////////////////////////////////
 	
-	FakeRatios *FR = new FakeRatios();
+	FakeRatios *FR = newFakeRatios();
 	
 	///////////////////////////////////////////////////////////////////////////////////
 	// THE FINAL HISTOGRAMS ///////////////////////////////////////////////////////////
@@ -15626,8 +16027,7 @@ void SSDLPlotter::makeTTWKinPlotSigEvent(vector<TString> diffVarName, vector<int
 	// SIGEVENT TREE //////////////////////////////////////////////////////////////////
 	///////////////////////////////////////////////////////////////////////////////////
 	
-	TFile *pFile = TFile::Open(fOutputFileName);
-	TTree *sigtree; getObjectSafe(pFile, "SigEvents", sigtree);
+	SigEventReader sigtree(getSigEvents());
 	
 	string *sname = 0;
 	int flag(0);
@@ -15641,51 +16041,51 @@ void SSDLPlotter::makeTTWKinPlotSigEvent(vector<TString> diffVarName, vector<int
 	
 	string samplename, tmp_samplename = "init";
 	
-	sigtree->SetBranchAddress("SystFlag", &flag);
-	sigtree->SetBranchAddress("Event",    &event);
-	sigtree->SetBranchAddress("Run",      &run);
-	sigtree->SetBranchAddress("SName",    &sname);
-	sigtree->SetBranchAddress("SType",    &SType);
-	sigtree->SetBranchAddress("PUWeight", &puweight);
-	sigtree->SetBranchAddress("SLumi",    &SLumi);
-	sigtree->SetBranchAddress("Flavor",   &Flavor);
-	sigtree->SetBranchAddress("Charge",   &charge);
-	sigtree->SetBranchAddress("pT1",      &pT1);
-	sigtree->SetBranchAddress("pT2",      &pT2);
-	sigtree->SetBranchAddress("eta1",     &eta1);
-	sigtree->SetBranchAddress("eta2",     &eta2);
-	sigtree->SetBranchAddress("TLCat",    &TLCat);
-	sigtree->SetBranchAddress("HT",       &HT);
-	sigtree->SetBranchAddress("MET",      &MET);
-	sigtree->SetBranchAddress("MT2",      &MT2);
-	sigtree->SetBranchAddress("NJ",       &NJ);
-	sigtree->SetBranchAddress("NbJ",      &NbJ);
-	sigtree->SetBranchAddress("NbJmed",   &NbJmed);
-	sigtree->SetBranchAddress("Mll",      &mll);
-	sigtree->SetBranchAddress("PassZVeto",&passZVeto);
-	sigtree->SetBranchAddress("Pass3rdSFLepVeto",&passes3rdSFLepVeto);
-	sigtree->SetBranchAddress("HLTSF",    &HLTSF);
-	sigtree->SetBranchAddress("Pass3rdVeto", &passes3rdVeto);
-	sigtree->SetBranchAddress("NVrtx", &NVrtx);
-	sigtree->SetBranchAddress("PFIso1", &PFIso1);
-	sigtree->SetBranchAddress("PFIso2", &PFIso2);
-	sigtree->SetBranchAddress("D01", &D01);
-	sigtree->SetBranchAddress("D02", &D02);
-	sigtree->SetBranchAddress("Rho", &Rho);
-	sigtree->SetBranchAddress("Rho", &Rho);
-	sigtree->SetBranchAddress("BetaStar1", &BetaStar1);
-	sigtree->SetBranchAddress("BetaStar2", &BetaStar2);
-	sigtree->SetBranchAddress("BetaStar3", &BetaStar3);
-	sigtree->SetBranchAddress("BetaStar4", &BetaStar4);
-	sigtree->SetBranchAddress("BetaStar5", &BetaStar5);
-	sigtree->SetBranchAddress("MTLep1", &MTLep1);
-	sigtree->SetBranchAddress("MTLep2", &MTLep2);
+	sigtree.SetBranchAddress("SystFlag", &flag);
+	sigtree.SetBranchAddress("Event",    &event);
+	sigtree.SetBranchAddress("Run",      &run);
+	sigtree.SetBranchAddress("SName",    &sname);
+	sigtree.SetBranchAddress("SType",    &SType);
+	sigtree.SetBranchAddress("PUWeight", &puweight);
+	sigtree.SetBranchAddress("SLumi",    &SLumi);
+	sigtree.SetBranchAddress("Flavor",   &Flavor);
+	sigtree.SetBranchAddress("Charge",   &charge);
+	sigtree.SetBranchAddress("pT1",      &pT1);
+	sigtree.SetBranchAddress("pT2",      &pT2);
+	sigtree.SetBranchAddress("eta1",     &eta1);
+	sigtree.SetBranchAddress("eta2",     &eta2);
+	sigtree.SetBranchAddress("TLCat",    &TLCat);
+	sigtree.SetBranchAddress("HT",       &HT);
+	sigtree.SetBranchAddress("MET",      &MET);
+	sigtree.SetBranchAddress("MT2",      &MT2);
+	sigtree.SetBranchAddress("NJ",       &NJ);
+	sigtree.SetBranchAddress("NbJ",      &NbJ);
+	sigtree.SetBranchAddress("NbJmed",   &NbJmed);
+	sigtree.SetBranchAddress("Mll",      &mll);
+	sigtree.SetBranchAddress("PassZVeto",&passZVeto);
+	sigtree.SetBranchAddress("Pass3rdSFLepVeto",&passes3rdSFLepVeto);
+	sigtree.SetBranchAddress("HLTSF",    &HLTSF);
+	sigtree.SetBranchAddress("Pass3rdVeto", &passes3rdVeto);
+	sigtree.SetBranchAddress("NVrtx", &NVrtx);
+	sigtree.SetBranchAddress("PFIso1", &PFIso1);
+	sigtree.SetBranchAddress("PFIso2", &PFIso2);
+	sigtree.SetBranchAddress("D01", &D01);
+	sigtree.SetBranchAddress("D02", &D02);
+	sigtree.SetBranchAddress("Rho", &Rho);
+	sigtree.SetBranchAddress("Rho", &Rho);
+	sigtree.SetBranchAddress("BetaStar1", &BetaStar1);
+	sigtree.SetBranchAddress("BetaStar2", &BetaStar2);
+	sigtree.SetBranchAddress("BetaStar3", &BetaStar3);
+	sigtree.SetBranchAddress("BetaStar4", &BetaStar4);
+	sigtree.SetBranchAddress("BetaStar5", &BetaStar5);
+	sigtree.SetBranchAddress("MTLep1", &MTLep1);
+	sigtree.SetBranchAddress("MTLep2", &MTLep2);
 	
 	float trigScale[3] = {gMMTrigScale, gEMTrigScale, gEETrigScale};
 	
-	for( int i = 0; i < sigtree->GetEntries(); i++ ){
-		if (!verbose) showStatusBar(i, sigtree->GetEntries(), 10000);
-		sigtree->GetEntry(i);
+	for( int i = 0; i < sigtree.GetEntries(); i++ ){
+		if (!verbose) showStatusBar(i, sigtree.GetEntries(), 10000);
+		sigtree.GetEntry(i);
 		
         //		if (tmp_samplename == "init") tmp_samplename = *sname;
 		if (verbose && tmp_samplename != *sname) {
@@ -16522,7 +16922,7 @@ void SSDLPlotter::makeDiffPrediction(){
 
 		for(size_t i = 0; i < nbins; ++i){
 			const float FakeESyst2 = 0.25;
-			FakeRatios *FR = new FakeRatios();
+			FakeRatios *FR = newFakeRatios();
 			FR->setNToyMCs(100); // speedup
 			FR->setAddESyst(0.5); // additional systematics
 
@@ -16615,7 +17015,7 @@ void SSDLPlotter::makeDiffPrediction(){
 			float nt2_em_EE_os = nt2_os_em_ee->GetBinContent(i+1);
 			
 			// Errors
-			FakeRatios *FR = new FakeRatios();
+			FakeRatios *FR = newFakeRatios();
 
 			// Simple error propagation assuming error on number of events is FR->getEStat2()
 			nt11_ee_cm->SetBinContent(i+1, 2*fbb*nt2_ee_BB_os + 2*fee*nt2_ee_EE_os + 2*feb*nt2_ee_EB_os);
@@ -17713,7 +18113,7 @@ void SSDLPlotter::makeDiffPredictionTTW(int varbin){
 
 	for(size_t i = 0; i < nbins; ++i){
 		const float FakeESyst2 = 0.25;
-		FakeRatios *FR = new FakeRatios();
+		FakeRatios *FR = newFakeRatios();
 		FR->setNToyMCs(100); // speedup
 		FR->setAddESyst(0.5); // additional systematics
 
@@ -17793,7 +18193,7 @@ void SSDLPlotter::makeDiffPredictionTTW(int varbin){
 		float nt2_em_EE_os = nt2_os_em_ee->GetBinContent(i+1);
 		
 		// Errors
-		FakeRatios *FR = new FakeRatios();
+		FakeRatios *FR = newFakeRatios();
 
 		// Simple error propagation assuming error on number of events is FR->getEStat2()
 		nt11_ee_cm->SetBinContent(i+1, 2*fbb*nt2_ee_BB_os + 2*fee*nt2_ee_EE_os + 2*feb*nt2_ee_EB_os);
@@ -18182,7 +18582,7 @@ void SSDLPlotter::makeDiffPredictionTTW(int varbin){
 	leg->SetTextSize(0.038);
 	leg->SetBorderSize(0);
 
-	FakeRatios *FR = new FakeRatios();
+	FakeRatios *FR = newFakeRatios();
 	TGraphAsymmErrors* gr_obs = FR->getGraphPoissonErrors(nt11);
 	gr_obs->SetMarkerColor(kBlack);
 	gr_obs->SetMarkerStyle(20);
@@ -18506,7 +18906,7 @@ void SSDLPlotter::makeIntMCClosure(vector<int> samples, TString filename, int re
  	///////////////////////////////////////////////////////////////////////////////////
  	// PREDICTIONS ////////////////////////////////////////////////////////////////////
  	///////////////////////////////////////////////////////////////////////////////////
- 	FakeRatios *FR = new FakeRatios();
+ 	FakeRatios *FR = newFakeRatios();
  	FR->setIsMC(true);
  	FR->setNToyMCs(100);
  	FR->setAddESyst(0.0);
@@ -19286,7 +19686,7 @@ void SSDLPlotter::makeWZValidation(SSPrediction pred, TString label){
 	  gPad->RedrawAxis();
 	  p_ratio->Draw();
 	  
-	  FakeRatios *FR = new FakeRatios();
+	  FakeRatios *FR = newFakeRatios();
 	  TGraphAsymmErrors* gr_obs = FR->getGraphPoissonErrors(hvar_data[i]);
 	  gr_obs->SetMarkerColor(kBlack);
 	  gr_obs->SetMarkerStyle(8);
@@ -19829,7 +20229,7 @@ void SSDLPlotter::makeIntMCClosureTTW(vector<int> samples, TString filename, int
  	}
 	
 	// Fake Predictions
- 	FakeRatios *FR = new FakeRatios();
+ 	FakeRatios *FR = newFakeRatios();
  	FR->setIsMC(true);
  	FR->setNToyMCs(100);
  	FR->setAddESyst(0.0);
@@ -20549,6 +20949,7 @@ void SSDLPlotter::makeTTbarClosure(){
 		Long64_t ientry = LoadTree(jentry);
 		if (ientry < 0) break;
 		nb = fChain->GetEntry(jentry);   nbytes += nb;
+		invalidateObsCache();
 
 		int ind1(-1), ind2(-1);
 		
@@ -20762,8 +21163,7 @@ void SSDLPlotter::makeTTbarClosure(){
 }
 
 void SSDLPlotter::storeWeightedPred(int baseRegion){
-	TFile *pFile = TFile::Open(fOutputFileName);
-	TTree *sigtree; getObjectSafe(pFile, "SigEvents", sigtree);
+	SigEventReader sigtree(getSigEvents());
 
 	string *sname = 0;
 	int flag;
@@ -20775,28 +21175,28 @@ void SSDLPlotter::storeWeightedPred(int baseRegion){
 	signed int charge;
 
 	
-	sigtree->SetBranchAddress("SystFlag",    &flag);
-	sigtree->SetBranchAddress("Event",       &event);
-	sigtree->SetBranchAddress("Run",         &run);
-	sigtree->SetBranchAddress("SName",       &sname);
-	sigtree->SetBranchAddress("SType",       &stype);
-	sigtree->SetBranchAddress("SLumi",       &slumi);
-	sigtree->SetBranchAddress("PUWeight",    &puweight);
-	sigtree->SetBranchAddress("Flavor",      &flav);
-	sigtree->SetBranchAddress("pT1",         &pT1);
-	sigtree->SetBranchAddress("pT2",         &pT2);
-	sigtree->SetBranchAddress("eta1",        &eta1);
-	sigtree->SetBranchAddress("eta2",        &eta2);
-	sigtree->SetBranchAddress("TLCat",       &cat);
-	sigtree->SetBranchAddress("HT",          &HT);
-	sigtree->SetBranchAddress("MET",         &MET);
-	sigtree->SetBranchAddress("MT2",         &MT2);
-	sigtree->SetBranchAddress("NJ",          &njets);
-	sigtree->SetBranchAddress("NbJ",         &nbjets);
-	sigtree->SetBranchAddress("NbJmed",      &nbjetsmed);
-	sigtree->SetBranchAddress("Charge",      &charge);
-	sigtree->SetBranchAddress("Pass3rdVeto", &pass3rdVeto);
-	FakeRatios *FR = new FakeRatios();
+	sigtree.SetBranchAddress("SystFlag",    &flag);
+	sigtree.SetBranchAddress("Event",       &event);
+	sigtree.SetBranchAddress("Run",         &run);
+	sigtree.SetBranchAddress("SName",       &sname);
+	sigtree.SetBranchAddress("SType",       &stype);
+	sigtree.SetBranchAddress("SLumi",       &slumi);
+	sigtree.SetBranchAddress("PUWeight",    &puweight);
+	sigtree.SetBranchAddress("Flavor",      &flav);
+	sigtree.SetBranchAddress("pT1",         &pT1);
+	sigtree.SetBranchAddress("pT2",         &pT2);
+	sigtree.SetBranchAddress("eta1",        &eta1);
+	sigtree.SetBranchAddress("eta2",        &eta2);
+	sigtree.SetBranchAddress("TLCat",       &cat);
+	sigtree.SetBranchAddress("HT",          &HT);
+	sigtree.SetBranchAddress("MET",         &MET);
+	sigtree.SetBranchAddress("MT2",         &MT2);
+	sigtree.SetBranchAddress("NJ",          &njets);
+	sigtree.SetBranchAddress("NbJ",         &nbjets);
+	sigtree.SetBranchAddress("NbJmed",      &nbjetsmed);
+	sigtree.SetBranchAddress("Charge",      &charge);
+	sigtree.SetBranchAddress("Pass3rdVeto", &pass3rdVeto);
+	FakeRatios *FR = newFakeRatios();
 
 	float npp(0.), npf(0.), nfp(0.), nff(0.);
 	float f1(0.), f2(0.), p1(0.), p2(0.);
@@ -20829,8 +21229,8 @@ void SSDLPlotter::storeWeightedPred(int baseRegion){
 	debugOUTSTREAM.open("debugOUTSTREAM.txt", ios::trunc);
 
 	
-	for( int i = 0; i < sigtree->GetEntries(); i++ ){
-		sigtree->GetEntry(i);
+	for( int i = 0; i < sigtree.GetEntries(); i++ ){
+		sigtree.GetEntry(i);
 		if( flav > 2 ) continue; // OS events
 		Sample *S = fSampleMap[TString(*sname)];
 
@@ -21503,30 +21903,29 @@ TGraph* SSDLPlotter::getSigEventGraph(gChannel chan, int reg){
 	vector<float> ht;
 	vector<float> met;
 
-	TFile *pFile = TFile::Open(fOutputFileName);
-	TTree *sigtree; getObjectSafe(pFile, "SigEvents", sigtree);
+	SigEventReader sigtree(getSigEvents());
 
 	string *sname = 0;
 	int flag;
 	int   stype, flav, cat, njets, nbjets;
 	float puweight, pT1, pT2, HT, MET, MT2;
 
-	sigtree->SetBranchAddress("SystFlag",    &flag);
-	sigtree->SetBranchAddress("SName",    &sname);
-	sigtree->SetBranchAddress("SType",    &stype);
-	sigtree->SetBranchAddress("PUWeight", &puweight);
-	sigtree->SetBranchAddress("Flavor",   &flav);
-	sigtree->SetBranchAddress("pT1",      &pT1);
-	sigtree->SetBranchAddress("pT2",      &pT2);
-	sigtree->SetBranchAddress("TLCat",    &cat);
-	sigtree->SetBranchAddress("HT",       &HT);
-	sigtree->SetBranchAddress("MET",      &MET);
-	sigtree->SetBranchAddress("MT2",      &MT2);
-	sigtree->SetBranchAddress("NJ",       &njets);
-	sigtree->SetBranchAddress("NbJ",      &nbjets);
-	
-	for( int i = 0; i < sigtree->GetEntries(); i++ ){
-		sigtree->GetEntry(i);
+	sigtree.SetBranchAddress("SystFlag",    &flag);
+	sigtree.SetBranchAddress("SName",    &sname);
+	sigtree.SetBranchAddress("SType",    &stype);
+	sigtree.SetBranchAddress("PUWeight", &puweight);
+	sigtree.SetBranchAddress("Flavor",   &flav);
+	sigtree.SetBranchAddress("pT1",      &pT1);
+	sigtree.SetBranchAddress("pT2",      &pT2);
+	sigtree.SetBranchAddress("TLCat",    &cat);
+	sigtree.SetBranchAddress("HT",       &HT);
+	sigtree.SetBranchAddress("MET",      &MET);
+	sigtree.SetBranchAddress("MT2",      &MT2);
+	sigtree.SetBranchAddress("NJ",       &njets);
+	sigtree.SetBranchAddress("NbJ",      &nbjets);
+	
+	for( int i = 0; i < sigtree.GetEntries(); i++ ){
+		sigtree.GetEntry(i);
 		Sample *S = fSampleMap[TString(*sname)];
 		int datamc = S->datamc;
 		
@@ -21575,8 +21974,7 @@ TGraph* SSDLPlotter::getSigEventGraph(gChannel chan, float HTmin, float HTmax, f
 	vector<float> nj;
 	vector<int> nb;
 
-	TFile *pFile = TFile::Open(fOutputFileName);
-	TTree *sigtree; getObjectSafe(pFile, "SigEvents", sigtree);
+	SigEventReader sigtree(getSigEvents());
 
 	string *sname = 0;
 	int flag;
@@ -21584,20 +21982,20 @@ TGraph* SSDLPlotter::getSigEventGraph(gChannel chan, float HTmin, float HTmax, f
 	float HT, MET, pT1,pT2;
 	int njets, nbjets;
 
-	sigtree->SetBranchAddress("SystFlag", &flag);
-	sigtree->SetBranchAddress("SName",    &sname);
-	sigtree->SetBranchAddress("SType",    &stype);
-	sigtree->SetBranchAddress("Flavor",   &flav);
-	sigtree->SetBranchAddress("TLCat",    &cat);
-	sigtree->SetBranchAddress("HT",       &HT);
-	sigtree->SetBranchAddress("MET",      &MET);
-	sigtree->SetBranchAddress("NbJ",      &nbjets);
-	sigtree->SetBranchAddress("NJ",       &njets);
-	sigtree->SetBranchAddress("pT1",      &pT1);
-	sigtree->SetBranchAddress("pT2",      &pT2);
-	
-	for( int i = 0; i < sigtree->GetEntries(); i++ ){
-		sigtree->GetEntry(i);
+	sigtree.SetBranchAddress("SystFlag", &flag);
+	sigtree.SetBranchAddress("SName",    &sname);
+	sigtree.SetBranchAddress("SType",    &stype);
+	sigtree.SetBranchAddress("Flavor",   &flav);
+	sigtree.SetBranchAddress("TLCat",    &cat);
+	sigtree.SetBranchAddress("HT",       &HT);
+	sigtree.SetBranchAddress("MET",      &MET);
+	sigtree.SetBranchAddress("NbJ",      &nbjets);
+	sigtree.SetBranchAddress("NJ",       &njets);
+	sigtree.SetBranchAddress("pT1",      &pT1);
+	sigtree.SetBranchAddress("pT2",      &pT2);
+	
+	for( int i = 0; i < sigtree.GetEntries(); i++ ){
+		sigtree.GetEntry(i);
 		Sample *S = fSampleMap[TString(*sname)];
 		int datamc = S->datamc;
 		
@@ -22521,29 +22919,57 @@ void SSDLPlotter::scanMSUGRA( const char * filestring){
 	eff_->Write();
 
 }
+//____________________________________________________________________________
+// SMS scan of the chargino-neutralino models: as scanModelGeneric, the tree is
+// read once and split over fNThreads clones of the plotter, each filling its
+// own sparse grid (see ScanGrid) that is merged on this thread.
+struct SSDLPlotter::SMSJob {
+	static const int kNX    = 3; // values of x in the scan
+	static const int kNSyst = 9;
+
+	// Slots of the grid per value of x: the yields, then the passing events
+	// per variation, each for all and for right handed sleptons
+	static const int kNXSlots = 2 + 2*kNSyst;
+	static const int kNSlots  = kNX*kNXSlots;
+	static inline int yieldSlot(int x, bool right){ return x*kNXSlots + right; };
+	static inline int passSlot(int x, int i, bool right){ return x*kNXSlots + 2 + 2*i + right; };
+
+	SSDLPlotter *worker;
+	TFile       *file;
+	TTree       *tree;
+	Long64_t     first;
+	Long64_t     last;
+
+	int          reg;
+	float        xvals[kNX];
+	bool         debug;
+	TH1D        *xsecs;            // only read
+	TH2D        *nTot[kNX];        // generated events per mass point, only read
+	TH2D        *nTotRight[kNX];
+
+	ScanGrid        *grid;
+	vector<TString>  debugLines;
+	int              nTight, nSignal, nEE, nEM, nMM;
+};
+
+static void* runSMSJob(void *arg){
+	SSDLPlotter::SMSJob *job = (SSDLPlotter::SMSJob*)arg;
+	job->worker->scanSMSEntries(job);
+	return 0;
+}
+
 void SSDLPlotter::scanSMS( const char * filestring, int reg){
 
         bool verbose = false;
-	if (verbose) fOUTSTREAM.open( "SMSoutput_"+gRegions[reg]->sname+".txt" );
 
 	// put the x-values that are in the scan here. those are percentage numbers. i.e. if x == 0.05 put 5
-	int nx(3);
+	const int nx = SMSJob::kNX;
 	float xvals[nx];
 	xvals[0] = 0.05;
 	xvals[1] = 0.50;
 	xvals[2] = 0.95;
 
-	TH2D * TChi_yield_      [nx];
-	TH2D * TChiRight_yield_ [nx];
-
-	for (int i = 0; i<nx; i++) {
-		TChi_yield_              [i] = new TH2D(Form("TChi_yield%.0f", 100*xvals[i])      , Form("TChi_yield%.0f", 100*xvals[i])      , 101, -5, 1005    , 101 , -5 , 1005);
-		TChiRight_yield_         [i] = new TH2D(Form("TChiRight_yield%.0f", 100* xvals[i]), Form("TChiRight_yield%.0f", 100*xvals[i]) , 101, -5, 1005    , 101 , -5 , 1005);
-		TChi_yield_              [i]->Sumw2();
-		TChiRight_yield_         [i]->Sumw2();
-	}
-
-	int nSyst(9);
+	const int nSyst = SMSJob::kNSyst;
 	TString systs[nSyst];
 	systs[0] = "norm";
 	systs[1] = "metsmear";
@@ -22555,23 +22981,16 @@ void SSDLPlotter::scanSMS( const char * filestring, int reg){
 	systs[7] = "METup";
 	systs[8] = "METdown";
 
-	TH2D  * TChi_nPass_     [nx][nSyst];
-	TH2D  * TChiRight_nPass_[nx][nSyst];
-	for (int i = 0; i<nx; i++) {
-		for (int j = 0; j<nSyst; j++) {
-			TChi_nPass_      [i][j] = new TH2D(Form("TChi_nPass_x%.0f_"+systs[j]     , 100*xvals[i]), Form("TChi_nPass_x%.0f_"+systs[j]     , 100*xvals[i]) , 101, -5, 1005, 101, -5, 1005);
-			TChiRight_nPass_ [i][j] = new TH2D(Form("TChiRight_nPass_x%.0f_"+systs[j], 100*xvals[i]), Form("TChiRight_nPass_x%.0f_"+systs[j], 100*xvals[i]) , 101, -5, 1005, 101, -5, 1005);
-			TChi_nPass_      [i][j]->Sumw2();
-			TChiRight_nPass_ [i][j]->Sumw2();
-		}
-	}
-
 	// get the histo with the x-secs
 	TFile * xsecFile_ = new TFile("msugraSSDL/C1N2_8TeV_xsecs.root", "READ", "xsecFile_");
 	TH1D  * xsecs     = (TH1D *) xsecFile_->Get("xsecs");
 
 	// get the histo with the count for each point
 	TFile * file_ = TFile::Open(filestring); //, "READ", "file_");
+	if (file_ == NULL || file_->IsZombie()) {
+		cout << "SSDLPlotter::scanSMS ==> Error: cannot open " << filestring << endl;
+		return;
+	}
 	TH2D  * TChi_nTot_ [nx];
 	TH2D  * TChiRight_nTot_[nx];
 	for (int i = 0; i<nx; i++) {
@@ -22580,144 +22999,104 @@ void SSDLPlotter::scanSMS( const char * filestring, int reg){
 		TChi_nTot_[i]     ->Sumw2();
 		TChiRight_nTot_[i]->Sumw2();
 	}
-	// get the Analysis tree from the file, initialize it
-	TTree * tree_ = (TTree *) file_->Get("Analysis");
-	tree_->ResetBranchAddresses();
-	Init(tree_);
 
 	// just for counting, really
+	TTree * tree_ = (TTree *) file_->Get("Analysis");
 	Long64_t tot_events = tree_->GetEntriesFast();
 	cout << "Total Number of entries: " << tot_events << endl;
-	int n_tot = 0;
-	int signalTot(0);
-	int nEE(0), nEM(0), nMM(0);
-	int nSlepSnu(0), nSlepSlep(0);
 
-	bool doSystematic = true;
-	// make a dummy sample for the systematic functions
-	Sample *S = new Sample();
-	S->datamc = 1;
-	// need to initialize the TRandom object for the systematic studies
-	SSDLDumper::fRand3 = new TRandom3(0);
+	// ===============================================================
+	// ======== set up the workers, one shard of entries each ========
+	// ===============================================================
+	TThread::Initialize();
+	int nworkers = fNThreads > 1 ? fNThreads : 1;
+	if (tot_events < nworkers) nworkers = tot_events > 0 ? int(tot_events) : 1;
+	Long64_t chunk = tot_events/nworkers;
+
+	vector<SMSJob> jobs(nworkers);
+	for (int w = 0; w < nworkers; ++w) {
+		SMSJob &job = jobs[w];
+		job.worker = new SSDLPlotter(this);
+		job.worker->fWorkerIndex = w;
+		job.file  = TFile::Open(filestring);
+		job.tree  = (TTree *) job.file->Get("Analysis");
+		job.tree  ->ResetBranchAddresses();
+		job.worker->Init(job.tree);
+		job.first = w*chunk;
+		job.last  = (w == nworkers-1) ? tot_events : (w+1)*chunk;
+
+		job.reg   = reg;
+		job.debug = verbose;
+		job.xsecs = xsecs;
+		for (int x = 0; x < nx; ++x) {
+			job.xvals    [x] = xvals[x];
+			job.nTot     [x] = TChi_nTot_[x];
+			job.nTotRight[x] = TChiRight_nTot_[x];
+		}
+		job.grid = new ScanGrid(SMSJob::kNSlots, 101, -5, 1005, 101, -5, 1005);
+		job.nTight = job.nSignal = job.nEE = job.nEM = job.nMM = 0;
+	}
+	if (fVerbose > 0) cout << " Scanning SMS in " << gRegions[reg]->sname << " with " << nworkers << " threads" << endl;
 
-	for (Long64_t jentry=0; jentry<tree_->GetEntriesFast();jentry++) {
-		setRegionCuts(reg);
-		printProgress(jentry, tot_events, "SMS Scan "+gRegions[reg]->sname);
-		for (int i = 0; i<nSyst; i++) {
-			tree_->GetEntry(jentry); // have to reload the entry for each systematic
-			int x=0;                   // get the value of x. yes, in the treee it's m0
-			if (m0 == xvals[0]) x = 0;
-			if (m0 == xvals[1]) x = 1;
-			if (m0 == xvals[2]) x = 2;
-			 
-			if (!doSystematic && i!=0) continue;
-			if (i == 1) smearMET(S);
-			if (i == 2) scaleLeptons(S, 1);
-			if (i == 3) scaleLeptons(S, 2);
-			if (i == 4) smearJetPts(S, 1);
-			if (i == 5) smearJetPts(S, 2);
-			if (i == 6) smearJetPts(S, 3);
-			if (i == 7) scaleMET(S, 0);
-			if (i == 8) scaleMET(S, 1);
-			// fancier now if (i == 9) {pfMET = pfMET + 0.05 * pfMET; }
-			// fancier now if (i ==10) {pfMET = pfMET - 0.05 * pfMET; }
-			int   xsecBin      = xsecs->FindBin(mGlu);
-			float nloXsec      = xsecs->GetBinContent(xsecBin);
-			int   nGenBin      = TChi_nTot_[x]->FindBin(mGlu, mLSP);
-			float nGen         = TChi_nTot_[x]->GetBinContent(nGenBin);
-			int   nGenBinRight = TChiRight_nTot_[x]->FindBin(mGlu, mLSP);
-			float nGenRight    = TChiRight_nTot_[x]->GetBinContent(nGenBin);
-			float weight       = fLumiNorm * nloXsec / nGen;
-			float weightRight  = fLumiNorm * nloXsec / nGenRight;
-			float idsf(-999.), trigsf(-999.);
-			
-			int mu1(-1), mu2(-1);
-			if( isSSLLMuEvent(mu1, mu2) ){ // Same-sign loose-loose di muon event
-				// if(pass3rdVeto && !passes3rdLepVeto()) continue;
-				if(isTightMuon(mu1) &&  isTightMuon(mu2) ){ // Tight-tight
-					n_tot++;
-					if ( IsSignalMuon[mu1] != 1 || IsSignalMuon[mu2] != 1 ) continue;
-					signalTot++;
-					idsf   = getLeptonSFMu(MuPt[mu1], MuEta[mu1])*getLeptonSFMu(MuPt[mu2], MuEta[mu2]);
-					trigsf = getTriggerSFMuMu(MuEta[mu2]);
-					if (verbose) fOUTSTREAM << Form("MM - mGlu %4.0f - mLSP %4.0f - HT %4.2f - MET %6.2f Pt1 %6.2f Pt2 %6.2f | %2d | SlepSnu: %2i", mGlu, mLSP, getHT(), pfMET, MuPt[mu1], MuPt[mu2], MuCharge[mu1], isTChiSlepSnu) << endl ;
-					TChi_nPass_[x] [i]-> Fill(mGlu, mLSP);
-					if (i==0) {
-						TChi_yield_ [x]-> Fill(mGlu, mLSP, weight * idsf*trigsf);
-					}
-					if (isRightHanded == 1 && isTChiSlepSnu == 0){
-						TChiRight_nPass_[x] [i]-> Fill(mGlu, mLSP);
-						if (i==0) {
-							TChiRight_yield_ [x]-> Fill(mGlu, mLSP, weightRight * idsf*trigsf);
-						}
-					}
-					nMM++;
-					continue;
-				}
-				resetHypLeptons();
-			}
-			int mu(-1), el(-1);
-			if( isSSLLElMuEvent(mu, el) ){
-				// if(pass3rdVeto && !passes3rdLepVeto()) continue;
-				if(  isTightElectron(el) &&  isTightMuon(mu) ){ // Tight-tight
-					n_tot++;
-					if ( IsSignalMuon[mu] != 1 || IsSignalElectron[el] != 1 ) continue;
-					signalTot++;
-					idsf   = getLeptonSFMu(MuPt[mu], MuEta[mu])*getLeptonSFEl(ElPt[el], ElEta[el]);
-					trigsf = getTriggerSFMuEl();
-
-					if (verbose) fOUTSTREAM << Form("EM - mGlu %4.0f - mLSP %4.0f - HT %4.2f - MET %6.2f Pt1 %6.2f Pt2 %6.2f | %2d | SlepSnu: %2i", mGlu, mLSP, getHT(), pfMET, MuPt[mu], ElPt[el], MuCharge[mu1], isTChiSlepSnu) << endl ;
-					TChi_nPass_[x] [i]-> Fill(mGlu, mLSP);
-					if (i==0) {
-						TChi_yield_ [x]-> Fill(mGlu, mLSP, weight * idsf*trigsf);
-					}
-					if (isRightHanded == 1 && isTChiSlepSnu == 0){
-						TChiRight_nPass_[x] [i]-> Fill(mGlu, mLSP);
-						if (i==0) {
-							TChiRight_yield_ [x]-> Fill(mGlu, mLSP, weightRight * idsf*trigsf);
-						}
-					}
-					nEM++;
-					continue;
-				}
-				resetHypLeptons();
-			}
-			int el1(-1), el2(-1);
-			if( isSSLLElEvent(el1, el2) ){
-				// if(pass3rdVeto && !passes3rdLepVeto()) continue;
-				if(  isTightElectron(el1) &&  isTightElectron(el2) ){ // Tight-tight
-					n_tot++;
-					if ( IsSignalElectron[el1] != 1 || IsSignalElectron[el2] != 1 ) continue;
-					signalTot++;
-					idsf   = getLeptonSFEl(ElPt[el1], ElEta[el1])*getLeptonSFEl(ElPt[el2], ElEta[el2]);
-					trigsf = getTriggerSFElEl(ElPt[el2]);
-
-					if (verbose) fOUTSTREAM << Form("EE - mGlu %4.0f - mLSP %4.0f - HT %4.2f - MET %6.2f Pt1 %6.2f Pt2 %6.2f | %2d | SlepSnu: %2i", mGlu, mLSP, getHT(), pfMET, ElPt[el1], ElPt[el2], ElCharge[el1], isTChiSlepSnu) << endl ;
-					TChi_nPass_[x] [i]-> Fill(mGlu, mLSP);
-					if (i==0) {
-						TChi_yield_ [x]-> Fill(mGlu, mLSP, weight * idsf*trigsf);
-					}
-					if (isRightHanded == 1 && isTChiSlepSnu == 0){
-						TChiRight_nPass_[x] [i]-> Fill(mGlu, mLSP);
-						if (i==0) {
-							TChiRight_yield_ [x]-> Fill(mGlu, mLSP, weightRight* idsf*trigsf);
-						}
-					}
-					nEE++;
-				}
-			}
+	if (nworkers == 1) jobs[0].worker->scanSMSEntries(&jobs[0]);
+	else {
+		vector<TThread*> threads;
+		for (int w = 0; w < nworkers; ++w) {
+			threads.push_back(new TThread(Form("SMS_scan_%d", w), runSMSJob, &jobs[w]));
+			threads.back()->Run();
+		}
+		for (int w = 0; w < nworkers; ++w) {
+			threads[w]->Join();
+			delete threads[w];
 		}
 	}
-	if (verbose) cout << "Total Number of SS events: " << n_tot << endl;
-	if (verbose) cout << "nEE: " << nEE << " nEM: " << nEM << " nMM: " << nMM << endl;
-	if (verbose) fOUTSTREAM << "Total number of tight pairs: " << n_tot << " total number of signal pairs: " << signalTot << " resulting efficiency: " << signalTot/n_tot << endl;
-	if (verbose) fOUTSTREAM << "nEE: " << nEE << " nEM: " << nEM << " nMM: " << nMM << endl;
-	if (verbose) fOUTSTREAM << "nSlepSnu: " << nSlepSnu << " nSlepSlep: " << nSlepSlep << endl;
 
-	TH2D * TChi_eff_      [nx] [nSyst];
-	TH2D * TChiRight_eff_ [nx] [nSyst];
+	// merge the shards into the first one, in entry order
+	ScanGrid *grid = jobs[0].grid;
+	for (int w = 0; w < nworkers; ++w) {
+		SMSJob &job = jobs[w];
+		if (w > 0) {
+			grid->Add(*job.grid);
+			delete job.grid;
+			jobs[0].debugLines.insert(jobs[0].debugLines.end(), job.debugLines.begin(), job.debugLines.end());
+			jobs[0].nTight  += job.nTight;
+			jobs[0].nSignal += job.nSignal;
+			jobs[0].nEE     += job.nEE;
+			jobs[0].nEM     += job.nEM;
+			jobs[0].nMM     += job.nMM;
+		}
+		delete job.worker;
+		job.file->Close();
+		delete job.file;
+	}
+	SMSJob &res = jobs[0];
+
+	if (verbose) {
+		fOUTSTREAM.open( "SMSoutput_"+gRegions[reg]->sname+".txt" );
+		for (size_t k = 0; k < res.debugLines.size(); ++k) fOUTSTREAM << res.debugLines[k] << endl;
+		fOUTSTREAM << "Total number of tight pairs: " << res.nTight << " total number of signal pairs: " << res.nSignal << " resulting efficiency: " << (res.nTight > 0 ? float(res.nSignal)/res.nTight : 0.) << endl;
+		fOUTSTREAM << "nEE: " << res.nEE << " nEM: " << res.nEM << " nMM: " << res.nMM << endl;
+		fOUTSTREAM.close();
+		cout << "Total Number of SS events: " << res.nTight << endl;
+		cout << "nEE: " << res.nEE << " nEM: " << res.nEM << " nMM: " << res.nMM << endl;
+	}
+
+	TH2D * TChi_yield_      [nx];
+	TH2D * TChiRight_yield_ [nx];
+	TH2D * TChi_nPass_      [nx][nSyst];
+	TH2D * TChiRight_nPass_ [nx][nSyst];
+	TH2D * TChi_eff_        [nx][nSyst];
+	TH2D * TChiRight_eff_   [nx][nSyst];
 	for (int x=0; x<nx;x++) {
+		TChi_yield_              [x] = new TH2D(Form("TChi_yield%.0f", 100*xvals[x])      , Form("TChi_yield%.0f", 100*xvals[x])      , 101, -5, 1005    , 101 , -5 , 1005);
+		TChiRight_yield_         [x] = new TH2D(Form("TChiRight_yield%.0f", 100* xvals[x]), Form("TChiRight_yield%.0f", 100*xvals[x]) , 101, -5, 1005    , 101 , -5 , 1005);
+		grid->FillHisto(TChi_yield_     [x], SMSJob::yieldSlot(x, false));
+		grid->FillHisto(TChiRight_yield_[x], SMSJob::yieldSlot(x, true ));
 		for (int i=0; i<nSyst;i++) {
+			TChi_nPass_      [x][i] = new TH2D(Form("TChi_nPass_x%.0f_"+systs[i]     , 100*xvals[x]), Form("TChi_nPass_x%.0f_"+systs[i]     , 100*xvals[x]) , 101, -5, 1005, 101, -5, 1005);
+			TChiRight_nPass_ [x][i] = new TH2D(Form("TChiRight_nPass_x%.0f_"+systs[i], 100*xvals[x]), Form("TChiRight_nPass_x%.0f_"+systs[i], 100*xvals[x]) , 101, -5, 1005, 101, -5, 1005);
+			grid->FillHisto(TChi_nPass_     [x][i], SMSJob::passSlot(x, i, false));
+			grid->FillHisto(TChiRight_nPass_[x][i], SMSJob::passSlot(x, i, true ));
 			TChi_eff_      [x][i] = new TH2D(Form("TChi_eff_x%.0f_"+systs[i]      , 100*xvals[x]) , Form("TChi_eff_x%.0f_"+systs[i]     , 100*xvals[x]) , 101, -5, 1005, 101, -5, 1005);
 			TChiRight_eff_ [x][i] = new TH2D(Form("TChiRight_eff_x%.0f_"+systs[i] , 100*xvals[x]) , Form("TChiRight_eff_x%.0f_"+systs[i], 100*xvals[x]) , 101, -5, 1005, 101, -5, 1005);
 			TChi_eff_      [x][i]->Sumw2();
@@ -22726,6 +23105,7 @@ void SSDLPlotter::scanSMS( const char * filestring, int reg){
 			TChiRight_eff_ [x][i]->Divide(TChiRight_nPass_[x][i] , TChiRight_nTot_[x] , 1. , 1.);
 		}
 	}
+	delete grid;
 
 	TFile * res_;
 	res_ = new TFile("SMSresults_"+gRegions[reg]->sname+".root", "RECREATE", "res_");
@@ -22744,11 +23124,144 @@ void SSDLPlotter::scanSMS( const char * filestring, int reg){
 			TChiRight_nPass_[x][i]->Write();
 		}
 	}
-	file_->Close();
 	res_->Close();
-
-	//	delete S;
 	delete res_;
+
+	for (int x=0; x<nx;x++) {
+		delete TChi_yield_     [x];
+		delete TChiRight_yield_[x];
+		for (int i=0; i<nSyst; i++) {
+			delete TChi_nPass_     [x][i];
+			delete TChiRight_nPass_[x][i];
+			delete TChi_eff_       [x][i];
+			delete TChiRight_eff_  [x][i];
+		}
+	}
+	file_->Close();
+	delete file_;
+	xsecFile_->Close();
+	delete xsecFile_;
+}
+
+void SSDLPlotter::scanSMSEntries(SMSJob *job){
+	// Event loop of one worker of scanSMS, every entry is read once and each
+	// variation starts from the saved event. The random generators are seeded
+	// with the event number, as in scanModelEntries.
+	bool doSystematic = true;
+	// make a dummy sample for the systematic functions
+	Sample *S = new Sample();
+	S->datamc = 1;
+
+	setRegionCuts(job->reg);
+	ScanGrid *G = job->grid;
+	for (Long64_t jentry = job->first; jentry < job->last; jentry++) {
+		if (fWorkerIndex == 0) printProgress(jentry-job->first, job->last-job->first, "SMS Scan "+gRegions[job->reg]->sname);
+		job->tree->GetEntry(jentry);
+		saveEvent(); // each systematic starts from the unmodified event
+
+		int x=0;                   // get the value of x. yes, in the treee it's m0
+		if (m0 == job->xvals[0]) x = 0;
+		if (m0 == job->xvals[1]) x = 1;
+		if (m0 == job->xvals[2]) x = 2;
+		double *cell = G->GetCell(G->FindBin(mGlu, mLSP));
+
+		for (int i = 0; i<SMSJob::kNSyst; i++) {
+			if (!doSystematic && i!=0) continue;
+			restoreEvent();
+			fRand3       ->SetSeed(Event);
+			fRand3Normal ->SetSeed(Event);
+			if (i == 1) smearMET(S);
+			if (i == 2) scaleLeptons(S, 1);
+			if (i == 3) scaleLeptons(S, 2);
+			if (i == 4) smearJetPts(S, 1);
+			if (i == 5) smearJetPts(S, 2);
+			if (i == 6) smearJetPts(S, 3);
+			if (i == 7) scaleMET(S, 0);
+			if (i == 8) scaleMET(S, 1);
+			// fancier now if (i == 9) {pfMET = pfMET + 0.05 * pfMET; }
+			// fancier now if (i ==10) {pfMET = pfMET - 0.05 * pfMET; }
+			scanSMSFill(job, i, x, cell);
+		}
+	}
+	delete S;
+}
+
+void SSDLPlotter::scanSMSFill(SMSJob *job, int i, int x, double *cell){
+	// Selection of variation i on the current event
+	ScanGrid *G = job->grid;
+	int   xsecBin      = job->xsecs->FindFixBin(mGlu);
+	float nloXsec      = job->xsecs->GetBinContent(xsecBin);
+	int   nGenBin      = job->nTot[x]->FindFixBin(mGlu, mLSP);
+	float nGen         = job->nTot[x]->GetBinContent(nGenBin);
+	float nGenRight    = job->nTotRight[x]->GetBinContent(nGenBin);
+	float weight       = fLumiNorm * nloXsec / nGen;
+	float weightRight  = fLumiNorm * nloXsec / nGenRight;
+	bool  right        = (isRightHanded == 1 && isTChiSlepSnu == 0);
+	float idsf(-999.), trigsf(-999.);
+
+	int mu1(-1), mu2(-1);
+	if( isSSLLMuEvent(mu1, mu2) ){ // Same-sign loose-loose di muon event
+		// if(pass3rdVeto && !passes3rdLepVeto()) continue;
+		if(isTightMuon(mu1) &&  isTightMuon(mu2) ){ // Tight-tight
+			job->nTight++;
+			if ( IsSignalMuon[mu1] != 1 || IsSignalMuon[mu2] != 1 ) return;
+			job->nSignal++;
+			idsf   = getLeptonSFMu(MuPt[mu1], MuEta[mu1])*getLeptonSFMu(MuPt[mu2], MuEta[mu2]);
+			trigsf = getTriggerSFMuMu(MuEta[mu2]);
+			if (job->debug) job->debugLines.push_back(TString::Format("MM - mGlu %4.0f - mLSP %4.0f - HT %4.2f - MET %6.2f Pt1 %6.2f Pt2 %6.2f | %2d | SlepSnu: %2i", mGlu, mLSP, getHT(), pfMET, MuPt[mu1], MuPt[mu2], MuCharge[mu1], isTChiSlepSnu));
+			G->Fill(cell, SMSJob::passSlot(x, i, false));
+			if (i==0) G->Fill(cell, SMSJob::yieldSlot(x, false), weight * idsf*trigsf);
+			if (right) {
+				G->Fill(cell, SMSJob::passSlot(x, i, true));
+				if (i==0) G->Fill(cell, SMSJob::yieldSlot(x, true), weightRight * idsf*trigsf);
+			}
+			job->nMM++;
+			return;
+		}
+		resetHypLeptons();
+	}
+	int mu(-1), el(-1);
+	if( isSSLLElMuEvent(mu, el) ){
+		// if(pass3rdVeto && !passes3rdLepVeto()) continue;
+		if(  isTightElectron(el) &&  isTightMuon(mu) ){ // Tight-tight
+			job->nTight++;
+			if ( IsSignalMuon[mu] != 1 || IsSignalElectron[el] != 1 ) return;
+			job->nSignal++;
+			idsf   = getLeptonSFMu(MuPt[mu], MuEta[mu])*getLeptonSFEl(ElPt[el], ElEta[el]);
+			trigsf = getTriggerSFMuEl();
+
+			if (job->debug) job->debugLines.push_back(TString::Format("EM - mGlu %4.0f - mLSP %4.0f - HT %4.2f - MET %6.2f Pt1 %6.2f Pt2 %6.2f | %2d | SlepSnu: %2i", mGlu, mLSP, getHT(), pfMET, MuPt[mu], ElPt[el], MuCharge[mu], isTChiSlepSnu));
+			G->Fill(cell, SMSJob::passSlot(x, i, false));
+			if (i==0) G->Fill(cell, SMSJob::yieldSlot(x, false), weight * idsf*trigsf);
+			if (right) {
+				G->Fill(cell, SMSJob::passSlot(x, i, true));
+				if (i==0) G->Fill(cell, SMSJob::yieldSlot(x, true), weightRight * idsf*trigsf);
+			}
+			job->nEM++;
+			return;
+		}
+		resetHypLeptons();
+	}
+	int el1(-1), el2(-1);
+	if( isSSLLElEvent(el1, el2) ){
+		// if(pass3rdVeto && !passes3rdLepVeto()) continue;
+		if(  isTightElectron(el1) &&  isTightElectron(el2) ){ // Tight-tight
+			job->nTight++;
+			if ( IsSignalElectron[el1] != 1 || IsSignalElectron[el2] != 1 ) return;
+			job->nSignal++;
+			idsf   = getLeptonSFEl(ElPt[el1], ElEta[el1])*getLeptonSFEl(ElPt[el2], ElEta[el2]);
+			trigsf = getTriggerSFElEl(ElPt[el2]);
+
+			if (job->debug) job->debugLines.push_back(TString::Format("EE - mGlu %4.0f - mLSP %4.0f - HT %4.2f - MET %6.2f Pt1 %6.2f Pt2 %6.2f | %2d | SlepSnu: %2i", mGlu, mLSP, getHT(), pfMET, ElPt[el1], ElPt[el2], ElCharge[el1], isTChiSlepSnu));
+			G->Fill(cell, SMSJob::passSlot(x, i, false));
+			if (i==0) G->Fill(cell, SMSJob::yieldSlot(x, false), weight * idsf*trigsf);
+			if (right) {
+				G->Fill(cell, SMSJob::passSlot(x, i, true));
+				if (i==0) G->Fill(cell, SMSJob::yieldSlot(x, true), weightRight* idsf*trigsf);
+			}
+			job->nEE++;
+		}
+	}
 }
 void SSDLPlotter::SUSYWorkshopPlots( TString sestring, int mgluino, int mlsp){
 
@@ -22862,38 +23375,129 @@ void SSDLPlotter::SUSYWorkshopPlots( TString sestring, int mgluino, int mlsp){
 
 	res_->Close();
 }
-void SSDLPlotter::scanModelGeneric( const char * filestring, int reg, TString model, bool lowpt){
+//____________________________________________________________________________
+// Signal scans: all regions and systematic variations of a model scan are
+// filled in one pass over the tree, split over fNThreads workers. Each worker
+// is a clone of the plotter with its own handle on the file and its own
+// sparse grid of sums (see ScanGrid), the grids are merged on this thread.
+struct SSDLPlotter::ScanJob {
+	// Quantities filled for the events passing a region, per variation
+	enum Quantity { kNPass = 0, kNPassNoScale, kLepSyst, kPuNo, kPuUp, kPuDn, kIsrUp, kIsrDn, kNQuantities };
+	// Counters per mass point, independent of the regions
+	enum Counter  { kNEvents = 0, kSumX, kSumY, kNCounters };
+	// PDF sets, sums of the event weights of their members
+	enum PdfSet   { kCTEQ = 0, kCT10, kMSTW, kNPdfSets };
+	// One dimensional distributions at (xVal, yVal)
+	enum Dist     { kHT = 0, kMET, kNJETS, kJETPT, kGENJETPT, kPT, kNDists };
+
+	static const int kNSyst = 8;
+	static const int kNCTEQ = 40, kNCT10 = 52, kNMSTW = 40;
+	static const int kNPdf  = kNCTEQ + kNCT10 + kNMSTW;
+	static const int xVal   = 775;
+	static const int yVal   = 525;
+
+	// Slots of the grid: PDF sums and counters of all events, then per region
+	// the PDF sums of the passing events, the quantities per variation and
+	// the yield
+	static const int kNGlobalSlots = kNPdf + kNCounters;
+	static const int kNRegionSlots = kNPdf + kNSyst*kNQuantities + 1;
+	static inline int nSlots(int nregs){ return kNGlobalSlots + nregs*kNRegionSlots; };
+	static inline int pdfSlot(int r, int set, int j){ // r = -1: all events
+		static const int offset[kNPdfSets] = {0, kNCTEQ, kNCTEQ + kNCT10};
+		return (r < 0 ? 0 : kNGlobalSlots + r*kNRegionSlots) + offset[set] + j;
+	};
+	static inline int counterSlot(int c){ return kNPdf + c; };
+	static inline int slot(int r, int syst, int q){ return kNGlobalSlots + r*kNRegionSlots + kNPdf + syst*kNQuantities + q; };
+	static inline int yieldSlot(int r){ return kNGlobalSlots + (r+1)*kNRegionSlots - 1; };
+
+	static TH1F* bookDist(TString model, int d){
+		static const char  *name [kNDists] = {"HT", "MET", "NJETS", "JETPT", "GENJETPT", "PT"};
+		static const int    nbins[kNDists] = { 100,   100,      10,     100,        100,  100};
+		static const double min  [kNDists] = { 200.,   50.,      2.,      0.,         0.,  10.};
+		static const double max  [kNDists] = { 700.,  400.,     12.,    200.,       200., 200.};
+		TString hname = model + TString::Format("_%s_%d_%d", name[d], xVal, yVal);
+		TH1F *h = new TH1F(hname, hname, nbins[d], min[d], max[d]);
+		h->Sumw2();
+		return h;
+	};
+
+	void fillPdf(double *cell, int r, const float *cteq, const float *ct10, const float *mstw){
+		for (int j = 0; j < kNCTEQ; ++j) grid->Fill(cell, pdfSlot(r, kCTEQ, j), cteq[j]);
+		for (int j = 0; j < kNCT10; ++j) grid->Fill(cell, pdfSlot(r, kCT10, j), ct10[j]);
+		for (int j = 0; j < kNMSTW; ++j) grid->Fill(cell, pdfSlot(r, kMSTW, j), mstw[j]);
+	};
+	void fillPass(double *cell, int r, int i, float sf, float isrweight, float isrweightdn,
+	              float pu, float puup, float pudn, float lepsyst){
+		grid->Fill(cell, slot(r, i, kNPass       ), sf*isrweight); // fill weighted by SFs
+		grid->Fill(cell, slot(r, i, kIsrUp       ), sf); // isr weight = 1
+		grid->Fill(cell, slot(r, i, kIsrDn       ), sf*isrweightdn);
+		grid->Fill(cell, slot(r, i, kPuNo        ), sf*pu  *isrweight);
+		grid->Fill(cell, slot(r, i, kPuUp        ), sf*puup*isrweight);
+		grid->Fill(cell, slot(r, i, kPuDn        ), sf*pudn*isrweight);
+		grid->Fill(cell, slot(r, i, kNPassNoScale));
+		grid->Fill(cell, slot(r, i, kLepSyst     ), lepsyst);
+	};
 
-	SSDLDumper::setRegionCuts(reg);
-	if (lowpt) setLowPtCuts();
+	SSDLPlotter *worker;
+	TFile       *file;
+	TTree       *tree;
+	Long64_t     first;
+	Long64_t     last;
+
+	vector<int>  regs;
+	TString      model;
+	BTagSF::SMSModel btagCorrection;
+	bool         lowpt;
+	bool         debug;
+	TH2D        *nTot;  // generated events per mass point, only read
+
+	ScanGrid        *grid;
+	vector<TH1F*>    dists;     // kNDists per region
+	vector<vector<TString> > debugLines; // per region
+	vector<int>      nTight, nSignal, nEE, nEM, nMM; // per region
+};
+
+static void* runScanJob(void *arg){
+	SSDLPlotter::ScanJob *job = (SSDLPlotter::ScanJob*)arg;
+	job->worker->scanModelEntries(job);
+	return 0;
+}
 
-	cout<< "minMu1pt  " << fC_minMu1pt  << endl;
-	cout<< "minMu2pt  " << fC_minMu2pt  << endl;
-	cout<< "minEl1pt  " << fC_minEl1pt  << endl;
-	cout<< "minEl2pt  " << fC_minEl2pt  << endl;
-	cout<< "minHT     " << fC_minHT     << endl;
-	cout<< "maxHT     " << fC_maxHT     << endl;
-	cout<< "minMet    " << fC_minMet    << endl;
-	cout<< "maxMet    " << fC_maxMet    << endl;
-	cout<< "minJetPt  " << fC_minJetPt  << endl;
-	cout<< "minNjets  " << fC_minNjets  << endl;
-	cout<< "maxNjets  " << fC_maxNjets  << endl;
-	cout<< "minNbjets " << fC_minNbjets << endl;
-	cout<< "maxNbjets " << fC_maxNbjets << endl;
-	cout<< "minNbjmed " << fC_minNbjmed << endl;
-	cout<< "maxNbjmed " << fC_maxNbjmed << endl;
+void SSDLPlotter::scanModelGeneric( const char * filestring, int reg, TString model, bool lowpt){
+	vector<int> regs(1, reg);
+	scanModelGeneric(filestring, regs, model, lowpt);
+}
 
-	bool verbose = false;
-	if (verbose) fOUTSTREAM.open( model+"_"+gRegions[reg]->sname+".txt" );
-	fOUTSTREAM.open("/shome/mdunser/workspace/CMSSW_5_2_5/src/DiLeptonAnalysis/NTupleProducer/macros/SMSresults/T6ttWW_debug.txt");
+void SSDLPlotter::scanModelGeneric( const char * filestring, vector<int> regs, TString model, bool lowpt){
+	const int nregs = regs.size();
+	if (nregs < 1) return;
 
-	/////////////////////////////////////////////////////
-	// for debugging:
- 	// setRegionCuts(0);
+	for (int r = 0; r < nregs; ++r) {
+		SSDLDumper::setRegionCuts(regs[r]);
+		if (lowpt) setLowPtCuts();
 
-	/////////////////////////////////////////////////////
+		cout<< "Region    " << gRegions[regs[r]]->sname << endl;
+		cout<< "minMu1pt  " << fC_minMu1pt  << endl;
+		cout<< "minMu2pt  " << fC_minMu2pt  << endl;
+		cout<< "minEl1pt  " << fC_minEl1pt  << endl;
+		cout<< "minEl2pt  " << fC_minEl2pt  << endl;
+		cout<< "minHT     " << fC_minHT     << endl;
+		cout<< "maxHT     " << fC_maxHT     << endl;
+		cout<< "minMet    " << fC_minMet    << endl;
+		cout<< "maxMet    " << fC_maxMet    << endl;
+		cout<< "minJetPt  " << fC_minJetPt  << endl;
+		cout<< "minNjets  " << fC_minNjets  << endl;
+		cout<< "maxNjets  " << fC_maxNjets  << endl;
+		cout<< "minNbjets " << fC_minNbjets << endl;
+		cout<< "maxNbjets " << fC_maxNbjets << endl;
+		cout<< "minNbjmed " << fC_minNbjmed << endl;
+		cout<< "maxNbjmed " << fC_maxNbjmed << endl;
+	}
 
-	int nSyst(8);
+	// debug printout of the events at one mass point
+	bool verbose = fVerbose > 1;
+
+	const int nSyst = ScanJob::kNSyst;
 	TString systs[nSyst];
 	systs[0] = "norm";
 	systs[1] = "JESup";
@@ -22903,51 +23507,22 @@ void SSDLPlotter::scanModelGeneric( const char * filestring, int reg, TString mo
 	systs[5] = "btagDown";
 	systs[6] = "METup";
 	systs[7] = "METdown";
-	
+
 	int nbins, min, max;
 	// other scans:
 	nbins =  300;
 	min   =    0;
 	max   = 1500;
 
-	TH2D  * Model_nPass_noScale_[nSyst];
-	TH2D  * Model_nPass_        [nSyst];
-	TH2D  * Model_eff_          [nSyst];
-	TH2D  * Model_lepSyst_      [nSyst];
-	TH2D  * Model_puUp_         [nSyst];
-	TH2D  * Model_puDn_         [nSyst];
-	TH2D  * Model_isrUp_        [nSyst];
-	TH2D  * Model_isrDn_        [nSyst];
-	TH2D  * Model_puNo_         [nSyst];
-	for (int j = 0; j<nSyst; j++) {
-		Model_nPass_         [j] = new TH2D(model+"_nPass_"+systs[j]         , model+"_nPass_"+systs[j]         , nbins, min, max, nbins, min, max);
-		Model_nPass_         [j]->Sumw2();
-		Model_nPass_noScale_ [j] = new TH2D(model+"_nPass_noScale_"+systs[j] , model+"_nPass_noScale_"+systs[j] , nbins, min, max, nbins, min, max);
-		Model_nPass_noScale_ [j]->Sumw2();
-		Model_eff_           [j] = new TH2D(model+"_eff_"+systs[j]           , model+"_eff_"+systs[j]           , nbins, min, max, nbins, min, max);
-		Model_eff_           [j]->Sumw2();
-		Model_lepSyst_       [j] = new TH2D(model+"_lepSyst_"+systs[j]       , model+"_lepSyst_"+systs[j]       , nbins, min, max, nbins, min, max);
-		Model_lepSyst_       [j]->Sumw2();
-		Model_puUp_          [j] = new TH2D(model+"_puUp_"+systs[j]          , model+"_puUp_"+systs[j]          , nbins, min, max, nbins, min, max);
-		Model_puUp_          [j]->Sumw2();
-		Model_puDn_          [j] = new TH2D(model+"_puDn_"+systs[j]          , model+"_puDn_"+systs[j]          , nbins, min, max, nbins, min, max);
-		Model_puDn_          [j]->Sumw2();
-		Model_isrUp_         [j] = new TH2D(model+"_isrUp_"+systs[j]         , model+"_isrUp_"+systs[j]         , nbins, min, max, nbins, min, max);
-		Model_isrUp_         [j]->Sumw2();
-		Model_isrDn_         [j] = new TH2D(model+"_isrDn_"+systs[j]         , model+"_isrDn_"+systs[j]         , nbins, min, max, nbins, min, max);
-		Model_isrDn_         [j]->Sumw2();
-		Model_puNo_         [j] = new TH2D(model+"_puNo_"+systs[j]           , model+"_puNo_"+systs[j]          , nbins, min, max, nbins, min, max);
-		Model_puNo_         [j]->Sumw2();
-	}
-	TH2D * Model_yield_ ;
-	Model_yield_  = new TH2D(model+"_yield"      , model+"_yield"  , nbins, min, max, nbins, min, max);
-	Model_yield_ ->Sumw2();
-
 	// TFile * xsecFile_ = new TFile("/shome/mdunser/xsecfiles/"+model+"_xsecs.root", "READ", "xsecFile_");
 	// TH1D  * xsecs     = (TH1D *) xsecFile_->Get("xsecs");
 	// TF1   * xsecfit =  xsecs->GetFunction("xsec_fit1");
 
 	TFile * file_ = TFile::Open(filestring);
+	if (file_ == NULL || file_->IsZombie()) {
+		cout << "SSDLPlotter::scanModelGeneric ==> Error: cannot open " << filestring << endl;
+		return;
+	}
 	// get the histo with the count for each point
 	TH2D  * Model_nTot_ ;
 	Model_nTot_ = (TH2D  *) file_->Get("ModelCountAll");
@@ -22973,342 +23548,453 @@ void SSDLPlotter::scanModelGeneric( const char * filestring, int reg, TString mo
 	Model_nTot_nChi2_ISRweightDn_ = (TH2D  *) file_->Get("ModelCountAll_nChi2_ISRweightDn");
 	if (Model_nTot_nChi2_ISRweightDn_ != NULL) Model_nTot_nChi2_ISRweightDn_ ->Sumw2();
 
-	// ===============================================================
-	// ======== one dimensional distributions ========================
-	// ===============================================================
-	int xVal = 775;
-	int yVal = 525;
-	
-	TH1F  * Model_HT_xVal_yVal_       ;
-	TH1F  * Model_MET_xVal_yVal_      ;
-	TH1F  * Model_NJETS_xVal_yVal_    ;
-	TH1F  * Model_JETPT_xVal_yVal_    ;
-	TH1F  * Model_GENJETPT_xVal_yVal_ ;
-	TH1F  * Model_PT_xVal_yVal_       ;
-	Model_HT_xVal_yVal_        = new TH1F(model+Form("_HT_%d_%d"      , xVal, yVal), model+Form("_HT_%d_%d"      , xVal, yVal), 100, 200., 700.);
-	Model_MET_xVal_yVal_       = new TH1F(model+Form("_MET_%d_%d"     , xVal, yVal), model+Form("_MET_%d_%d"     , xVal, yVal), 100,  50., 400.);
-	Model_NJETS_xVal_yVal_     = new TH1F(model+Form("_NJETS_%d_%d"   , xVal, yVal), model+Form("_NJETS_%d_%d"   , xVal, yVal),  10,   2 ,  12 );
-	Model_JETPT_xVal_yVal_     = new TH1F(model+Form("_JETPT_%d_%d"   , xVal, yVal), model+Form("_JETPT_%d_%d"   , xVal, yVal), 100,   0., 200.);
-	Model_GENJETPT_xVal_yVal_  = new TH1F(model+Form("_GENJETPT_%d_%d", xVal, yVal), model+Form("_GENJETPT_%d_%d", xVal, yVal), 100,   0., 200.);
-	Model_PT_xVal_yVal_        = new TH1F(model+Form("_PT_%d_%d"      , xVal, yVal), model+Form("_PT_%d_%d"      , xVal, yVal), 100,  10., 200.);
-	Model_HT_xVal_yVal_       -> Sumw2();
-	Model_MET_xVal_yVal_      -> Sumw2();
-	Model_NJETS_xVal_yVal_    -> Sumw2();
-	Model_JETPT_xVal_yVal_    -> Sumw2();
-	Model_GENJETPT_xVal_yVal_ -> Sumw2();
-	Model_PT_xVal_yVal_       -> Sumw2();
-	// ===============================================================
-	// ===============================================================
-
-	// get the Analysis tree from the file, initialize it
-	TTree * tree_ = (TTree *) file_->Get("Analysis");
-	tree_->ResetBranchAddresses();
-	Init(tree_);
-
 	// just for counting, really
+	TTree * tree_ = (TTree *) file_->Get("Analysis");
 	Long64_t tot_events = tree_->GetEntriesFast();
 	cout << "Total Number of entries: " << tot_events << endl;
-	int n_tot = 0;
-	int signalTot(0);
-	int nEE(0), nEM(0), nMM(0);
-
-	bool doSystematic = true;
-	// make a dummy sample for the systematic functions
-	Sample *S = new Sample();
-	S->datamc = 1;
-	// need to initialize the TRandom object for the systematic studies
-	SSDLDumper::fRand3       = new TRandom3(10);
-	SSDLDumper::fRand3Normal = new TRandom3(10);
-
 
 	// BTAG CORRECTION FACTOR FOR FASTSIM!!!!!
 	// =========================================================
-	// T7btw, T1tttt, T5tttt: "T1tttt"
-	// T6ttWW, T6ttWWx05, T6ttWWx08: "T2tt"
-	// T5lnu, T5VV: "T1"
-	TString btagCorrection = "T1tttt";
-
-
-	// PDF uncertainties 
-	// ===========================================================
-	int ncteq(40), nct10(52), nmstw(40);
-	TH2D  * Model_nTot_cteq_[ncteq];
-	TH2D  * Model_nTot_ct10_[nct10];
-	TH2D  * Model_nTot_mstw_[nmstw];
-	TH2D  * Model_nPass_cteq_[ncteq];
-	TH2D  * Model_nPass_ct10_[nct10];
-	TH2D  * Model_nPass_mstw_[nmstw];
-	for (int j = 0; j<ncteq; j++) {
+	// T7btw, T1tttt, T5tttt: kT1tttt
+	// T6ttWW, T6ttWWx05, T6ttWWx08: kT2tt
+	// T5lnu, T5VV: kT1
+	BTagSF::SMSModel btagCorrection = BTagSF::kT1tttt;
+
+	// ===============================================================
+	// ======== set up the workers, one shard of entries each ========
+	// ===============================================================
+	// All ROOT objects are created and merged on this thread, the workers
+	// only read their own file and fill their own grid and histograms.
+	TThread::Initialize();
+	int nworkers = fNThreads > 1 ? fNThreads : 1;
+	if (tot_events < nworkers) nworkers = tot_events > 0 ? int(tot_events) : 1;
+	Long64_t chunk = tot_events/nworkers;
+
+	vector<ScanJob> jobs(nworkers);
+	for (int w = 0; w < nworkers; ++w) {
+		ScanJob &job = jobs[w];
+		job.worker = new SSDLPlotter(this);
+		job.worker->fWorkerIndex = w;
+		job.file  = TFile::Open(filestring);
+		job.tree  = (TTree *) job.file->Get("Analysis");
+		job.tree  ->ResetBranchAddresses();
+		job.worker->Init(job.tree);
+		job.first = w*chunk;
+		job.last  = (w == nworkers-1) ? tot_events : (w+1)*chunk;
+
+		job.regs           = regs;
+		job.model          = model;
+		job.btagCorrection = btagCorrection;
+		job.lowpt          = lowpt;
+		job.debug          = verbose;
+		job.nTot           = Model_nTot_;
+
+		job.grid = new ScanGrid(ScanJob::nSlots(nregs), nbins, min, max, nbins, min, max);
+		for (int r = 0; r < nregs; ++r) for (int d = 0; d < ScanJob::kNDists; ++d) job.dists.push_back(ScanJob::bookDist(model, d));
+		job.debugLines.resize(nregs);
+		job.nTight .assign(nregs, 0);
+		job.nSignal.assign(nregs, 0);
+		job.nEE    .assign(nregs, 0);
+		job.nEM    .assign(nregs, 0);
+		job.nMM    .assign(nregs, 0);
+	}
+	if (fVerbose > 0) cout << " Scanning " << model << " in " << nregs << " regions with " << nworkers << " threads" << endl;
+
+	if (nworkers == 1) jobs[0].worker->scanModelEntries(&jobs[0]);
+	else {
+		vector<TThread*> threads;
+		for (int w = 0; w < nworkers; ++w) {
+			threads.push_back(new TThread(Form("%s_scan_%d", model.Data(), w), runScanJob, &jobs[w]));
+			threads.back()->Run();
+		}
+		for (int w = 0; w < nworkers; ++w) {
+			threads[w]->Join();
+			delete threads[w];
+		}
+	}
+
+	// merge the shards into the first one, in entry order
+	ScanGrid *grid = jobs[0].grid;
+	for (int w = 0; w < nworkers; ++w) {
+		ScanJob &job = jobs[w];
+		if (w > 0) {
+			grid->Add(*job.grid);
+			delete job.grid;
+			for (size_t k = 0; k < job.dists.size(); ++k) {
+				jobs[0].dists[k]->Add(job.dists[k]);
+				delete job.dists[k];
+			}
+			for (int r = 0; r < nregs; ++r) {
+				jobs[0].debugLines[r].insert(jobs[0].debugLines[r].end(), job.debugLines[r].begin(), job.debugLines[r].end());
+				jobs[0].nTight [r] += job.nTight [r];
+				jobs[0].nSignal[r] += job.nSignal[r];
+				jobs[0].nEE    [r] += job.nEE    [r];
+				jobs[0].nEM    [r] += job.nEM    [r];
+				jobs[0].nMM    [r] += job.nMM    [r];
+			}
+		}
+		delete job.worker;
+		job.file->Close();
+		delete job.file;
+	}
+	ScanJob &res = jobs[0];
+
+	// PDF sums of all events, the same for all regions
+	TH2D  * Model_nTot_cteq_[ScanJob::kNCTEQ];
+	TH2D  * Model_nTot_ct10_[ScanJob::kNCT10];
+	TH2D  * Model_nTot_mstw_[ScanJob::kNMSTW];
+	for (int j = 0; j<ScanJob::kNCTEQ; j++) {
 		Model_nTot_cteq_         [j] = new TH2D(model+Form("_nTot_cteq_%d",j) , model+Form("_nTot_cteq_%d",j) , nbins, min, max, nbins, min, max);
-		Model_nPass_cteq_        [j] = new TH2D(model+Form("_nPass_cteq_%d",j), model+Form("_nPass_cteq_%d",j), nbins, min, max, nbins, min, max);
-		Model_nTot_cteq_         [j]->Sumw2();
-		Model_nPass_cteq_        [j]->Sumw2();
+		grid->FillHisto(Model_nTot_cteq_[j], ScanJob::pdfSlot(-1, ScanJob::kCTEQ, j));
 	}
-	for (int j = 0; j<nct10; j++) {
+	for (int j = 0; j<ScanJob::kNCT10; j++) {
 		Model_nTot_ct10_         [j] = new TH2D(model+Form("_nTot_ct10_%d",j) , model+Form("_nTot_ct10_%d",j) , nbins, min, max, nbins, min, max);
-		Model_nPass_ct10_        [j] = new TH2D(model+Form("_nPass_ct10_%d",j), model+Form("_nPass_ct10_%d",j), nbins, min, max, nbins, min, max);
-		Model_nTot_ct10_         [j]->Sumw2();
-		Model_nPass_ct10_        [j]->Sumw2();
+		grid->FillHisto(Model_nTot_ct10_[j], ScanJob::pdfSlot(-1, ScanJob::kCT10, j));
 	}
-	for (int j = 0; j<nmstw; j++) {
+	for (int j = 0; j<ScanJob::kNMSTW; j++) {
 		Model_nTot_mstw_         [j] = new TH2D(model+Form("_nTot_mstw_%d",j) , model+Form("_nTot_mstw_%d",j) , nbins, min, max, nbins, min, max);
-		Model_nPass_mstw_        [j] = new TH2D(model+Form("_nPass_mstw_%d",j), model+Form("_nPass_mstw_%d",j), nbins, min, max, nbins, min, max);
-		Model_nTot_mstw_         [j]->Sumw2();
-		Model_nPass_mstw_        [j]->Sumw2();
+		grid->FillHisto(Model_nTot_mstw_[j], ScanJob::pdfSlot(-1, ScanJob::kMSTW, j));
 	}
-	// ===========================================================
-	// ===========================================================
 
-	float xvar(-1);
-	float yvar(-1);
-	for (Long64_t jentry=0; jentry<tree_->GetEntriesFast();jentry++) {
-		setRegionCuts(reg);
-		if (lowpt) setLowPtCuts();
-		printProgress(jentry, tot_events, model+" Scan "+gRegions[reg]->sname);
+	for (int r = 0; r < nregs; ++r) {
+		TString region = gRegions[regs[r]]->sname;
 
-		for (int i = 0; i<nSyst; i++) {
-			tree_->GetEntry(jentry); // have to reload the entry for each systematic
-			fRand3       ->SetSeed(Event);
-			fRand3Normal ->SetSeed(Event);
-			saveBTags();      // save the values of the new btag
-			scaleBTags(S, 0, btagCorrection); // this applies the bTagSF
-
-			if (!doSystematic && i!=0) continue;
-			if (i == 1) smearJetPts(S, 1);
-			if (i == 2) smearJetPts(S, 2);
-			if (i == 3) smearJetPts(S, 3);
-			if (i == 4) {resetBTags(); scaleBTags(S, 1, btagCorrection);}
-			if (i == 5) {resetBTags(); scaleBTags(S, 2, btagCorrection);}
-			if (i == 6) scaleMET(S, 0);
-			if (i == 7) scaleMET(S, 1);
-
-			// T6ttWW     scan: xvar = mGlu and yvar = mChi
-			// T6ttWW x05 scan: xvar = mGlu and yvar = mLSP
-			// T6ttWW x08 scan: xvar = mGlu and yvar = mLSP
-			// T5tttt     scan: xvar = mGlu and yvar = mChi
-			// T7btw      scan: xvar = mGlu and yvar = mChi
-			// T1tttt     scan: xvar = mGlu and yvar = mLSP
-			// T5VV       scan: xvar = mGlu and yvar = mChi
-			xvar = mGlu;
-			yvar = mLSP;
-
-			// PDF uncertainties:
-			// =====================================================================
-			if ( i ==0) {
-				for (int j = 0; j<nct10; j++) {
-					if (j < 40 ) Model_nTot_cteq_         [j] ->Fill(xvar, yvar, WPdfCTEQ[j]);
-					Model_nTot_ct10_         [j] ->Fill(xvar, yvar, WPdfCT10[j]);
-					if (j < 40 ) Model_nTot_mstw_         [j] ->Fill(xvar, yvar, WPdfMRST[j]);
-				}
+		if (verbose) {
+			fOUTSTREAM.open(fOutputDir+model+"_"+region+"_debug.txt");
+			for (size_t k = 0; k < res.debugLines[r].size(); ++k) fOUTSTREAM << res.debugLines[r][k] << endl;
+			fOUTSTREAM << "Total number of tight pairs: " << res.nTight[r] << " total number of signal pairs: " << res.nSignal[r] << " resulting efficiency: " << (res.nTight[r] > 0 ? float(res.nSignal[r])/res.nTight[r] : 0.) << endl;
+			fOUTSTREAM << "nEE: " << res.nEE[r] << " nEM: " << res.nEM[r] << " nMM: " << res.nMM[r] << endl;
+			fOUTSTREAM.close();
+		}
+		if (fVerbose > 0) cout << region << ": Total Number of SS events: " << res.nTight[r] << endl;
+		if (fVerbose > 0) cout << region << ": nEE: " << res.nEE[r] << " nEM: " << res.nEM[r] << " nMM: " << res.nMM[r] << endl;
+
+		TH2D  * Model_nPass_noScale_[nSyst];
+		TH2D  * Model_nPass_        [nSyst];
+		TH2D  * Model_eff_          [nSyst];
+		TH2D  * Model_lepSyst_      [nSyst];
+		TH2D  * Model_puUp_         [nSyst];
+		TH2D  * Model_puDn_         [nSyst];
+		TH2D  * Model_isrUp_        [nSyst];
+		TH2D  * Model_isrDn_        [nSyst];
+		TH2D  * Model_puNo_         [nSyst];
+		for (int j = 0; j<nSyst; j++) {
+			Model_nPass_         [j] = new TH2D(model+"_nPass_"+systs[j]         , model+"_nPass_"+systs[j]         , nbins, min, max, nbins, min, max);
+			Model_nPass_noScale_ [j] = new TH2D(model+"_nPass_noScale_"+systs[j] , model+"_nPass_noScale_"+systs[j] , nbins, min, max, nbins, min, max);
+			Model_eff_           [j] = new TH2D(model+"_eff_"+systs[j]           , model+"_eff_"+systs[j]           , nbins, min, max, nbins, min, max);
+			Model_eff_           [j]->Sumw2();
+			Model_lepSyst_       [j] = new TH2D(model+"_lepSyst_"+systs[j]       , model+"_lepSyst_"+systs[j]       , nbins, min, max, nbins, min, max);
+			Model_puUp_          [j] = new TH2D(model+"_puUp_"+systs[j]          , model+"_puUp_"+systs[j]          , nbins, min, max, nbins, min, max);
+			Model_puDn_          [j] = new TH2D(model+"_puDn_"+systs[j]          , model+"_puDn_"+systs[j]          , nbins, min, max, nbins, min, max);
+			Model_isrUp_         [j] = new TH2D(model+"_isrUp_"+systs[j]         , model+"_isrUp_"+systs[j]         , nbins, min, max, nbins, min, max);
+			Model_isrDn_         [j] = new TH2D(model+"_isrDn_"+systs[j]         , model+"_isrDn_"+systs[j]         , nbins, min, max, nbins, min, max);
+			Model_puNo_          [j] = new TH2D(model+"_puNo_"+systs[j]          , model+"_puNo_"+systs[j]          , nbins, min, max, nbins, min, max);
+			grid->FillHisto(Model_nPass_        [j], ScanJob::slot(r, j, ScanJob::kNPass       ));
+			grid->FillHisto(Model_nPass_noScale_[j], ScanJob::slot(r, j, ScanJob::kNPassNoScale));
+			grid->FillHisto(Model_lepSyst_      [j], ScanJob::slot(r, j, ScanJob::kLepSyst     ));
+			grid->FillHisto(Model_puUp_         [j], ScanJob::slot(r, j, ScanJob::kPuUp        ));
+			grid->FillHisto(Model_puDn_         [j], ScanJob::slot(r, j, ScanJob::kPuDn        ));
+			grid->FillHisto(Model_isrUp_        [j], ScanJob::slot(r, j, ScanJob::kIsrUp       ));
+			grid->FillHisto(Model_isrDn_        [j], ScanJob::slot(r, j, ScanJob::kIsrDn       ));
+			grid->FillHisto(Model_puNo_         [j], ScanJob::slot(r, j, ScanJob::kPuNo        ));
+			Model_eff_ [j]->Divide(Model_nPass_[j], Model_nTot_ , 1. , 1.);
+		}
+		TH2D * Model_yield_ ;
+		Model_yield_  = new TH2D(model+"_yield"      , model+"_yield"  , nbins, min, max, nbins, min, max);
+		grid->FillHisto(Model_yield_, ScanJob::yieldSlot(r));
+
+		TH2D  * Model_nPass_cteq_[ScanJob::kNCTEQ];
+		TH2D  * Model_nPass_ct10_[ScanJob::kNCT10];
+		TH2D  * Model_nPass_mstw_[ScanJob::kNMSTW];
+		for (int j = 0; j<ScanJob::kNCTEQ; j++) {
+			Model_nPass_cteq_        [j] = new TH2D(model+Form("_nPass_cteq_%d",j), model+Form("_nPass_cteq_%d",j), nbins, min, max, nbins, min, max);
+			grid->FillHisto(Model_nPass_cteq_[j], ScanJob::pdfSlot(r, ScanJob::kCTEQ, j));
+		}
+		for (int j = 0; j<ScanJob::kNCT10; j++) {
+			Model_nPass_ct10_        [j] = new TH2D(model+Form("_nPass_ct10_%d",j), model+Form("_nPass_ct10_%d",j), nbins, min, max, nbins, min, max);
+			grid->FillHisto(Model_nPass_ct10_[j], ScanJob::pdfSlot(r, ScanJob::kCT10, j));
+		}
+		for (int j = 0; j<ScanJob::kNMSTW; j++) {
+			Model_nPass_mstw_        [j] = new TH2D(model+Form("_nPass_mstw_%d",j), model+Form("_nPass_mstw_%d",j), nbins, min, max, nbins, min, max);
+			grid->FillHisto(Model_nPass_mstw_[j], ScanJob::pdfSlot(r, ScanJob::kMSTW, j));
+		}
+		TH1F ** dists = &res.dists[r*ScanJob::kNDists];
 
-				int m1(-1), m2(-1);
-				if( isSSLLMuEvent(m1, m2) ){ // Same-sign loose-loose di muon event
-					if(isTightMuon(m1) &&  isTightMuon(m2) ){ // Tight-tight
-						if ( IsSignalMuon[m1] != 1 || IsSignalMuon[m2] != 1 ) continue;
-							for (int j = 0; j<nct10; j++) {
-								if (j < 40 ) Model_nPass_cteq_         [j] ->Fill(xvar, yvar, WPdfCTEQ[j]);
-								Model_nPass_ct10_         [j] ->Fill(xvar, yvar, WPdfCT10[j]);
-								if (j < 40 ) Model_nPass_mstw_         [j] ->Fill(xvar, yvar, WPdfMRST[j]);
-							}
-					}
-				}
-				int m(-1), e(-1);
-				if( isSSLLElMuEvent(m, e) ){
-					if(  isTightElectron(e) &&  isTightMuon(m) ){ // Tight-tight
-						if ( IsSignalMuon[m] != 1 || IsSignalElectron[e] != 1 ) continue;
-							for (int j = 0; j<nct10; j++) {
-								if (j < 40 ) Model_nPass_cteq_         [j] ->Fill(xvar, yvar, WPdfCTEQ[j]);
-								Model_nPass_ct10_         [j] ->Fill(xvar, yvar, WPdfCT10[j]);
-								if (j < 40 ) Model_nPass_mstw_         [j] ->Fill(xvar, yvar, WPdfMRST[j]);
-							}
-					}
-				}
-				int e1(-1), e2(-1);
-				if( isSSLLElEvent(e1, e2) ){
-					if(  isTightElectron(e1) &&  isTightElectron(e2) ){ // Tight-tight
-						if ( IsSignalElectron[e1] != 1 || IsSignalElectron[e2] != 1 ) continue;
-							for (int j = 0; j<nct10; j++) {
-								if (j < 40 ) Model_nPass_cteq_         [j] ->Fill(xvar, yvar, WPdfCTEQ[j]);
-								Model_nPass_ct10_         [j] ->Fill(xvar, yvar, WPdfCT10[j]);
-								if (j < 40 ) Model_nPass_mstw_         [j] ->Fill(xvar, yvar, WPdfMRST[j]);
-							}
-					}
-				}
-				// =====================================================================
-			}
+		TFile * res_;
+		res_ = new TFile(fOutputDir+model+"_results_"+region+".root", "RECREATE", "res_");
+		res_   -> cd();
 
-			 
+		Model_yield_ ->Write();
+		Model_nTot_  ->Write();
+		Model_nTot_ISRweight_   ->Write();
+		Model_nTot_ISRweightDn_ ->Write();
+		if (Model_nTot_nChi2_ != NULL) {
+			Model_nTot_nChi2_  ->Write();
+			Model_nTot_nChi2_ISRweight_   ->Write();
+			Model_nTot_nChi2_ISRweightDn_ ->Write();
+		}
+		for (int d = 0; d < ScanJob::kNDists; ++d) dists[d]->Write();
 
-			if (xvar == xVal && yvar == yVal) {
-				Model_HT_xVal_yVal_     -> Fill(getHT()   );
-				Model_MET_xVal_yVal_    -> Fill(getMET()  );
-				Model_NJETS_xVal_yVal_  -> Fill(getNJets());
-				for (int i = 0; i <NJets; ++i) {
-					Model_JETPT_xVal_yVal_  -> Fill(JetPt[i]);
-					Model_GENJETPT_xVal_yVal_  -> Fill(JetGenPt[i]);
-				}
-				for (int i = 0; i < NMus; ++i) Model_PT_xVal_yVal_    -> Fill(MuPt[i]);
-				for (int i = 0; i < NEls; ++i) Model_PT_xVal_yVal_    -> Fill(ElPt[i]);
+		for (int i=0; i<nSyst; i++) {
+			Model_eff_             [i]->Write();
+			Model_nPass_           [i]->Write();
+			Model_nPass_noScale_   [i]->Write();
+			Model_lepSyst_         [i]->Write();
+			Model_puNo_            [i]->Write();
+			Model_puUp_            [i]->Write();
+			Model_puDn_            [i]->Write();
+			Model_isrUp_           [i]->Write();
+			Model_isrDn_           [i]->Write();
+		}
+		for (int i=0; i<ScanJob::kNCT10; ++i){
+			Model_nTot_ct10_ [i] ->Write();
+			Model_nPass_ct10_[i] ->Write();
+			if (i<ScanJob::kNCTEQ) {
+				Model_nTot_cteq_ [i] ->Write();
+				Model_nTot_mstw_ [i] ->Write();
+				Model_nPass_cteq_[i] ->Write();
+				Model_nPass_mstw_[i] ->Write();
 			}
+		}
+		res_->Close();
+		delete res_;
+
+		// compact table of the mass points for the limit tools: one line per
+		// mass point with at least one event in the tree
+		ofstream table(fOutputDir+model+"_results_"+region+".txt");
+		table << "# " << model << " " << region << ": generated events, yield with stat. error and efficiency per variation" << endl;
+		table << "# mGlu mLSP nGen yield yieldErr";
+		for (int i = 0; i < nSyst; ++i) table << " eff_" << systs[i];
+		table << endl;
+		vector<int> bins = grid->GetBins();
+		for (size_t k = 0; k < bins.size(); ++k) {
+			const double *cell = grid->FindCell(bins[k]);
+			const double nev   = cell[2*ScanJob::counterSlot(ScanJob::kNEvents)];
+			if (nev <= 0.) continue;
+			// all events of a bin are at the same mass point
+			const double xvar = cell[2*ScanJob::counterSlot(ScanJob::kSumX)]/nev;
+			const double yvar = cell[2*ScanJob::counterSlot(ScanJob::kSumY)]/nev;
+			table << Form("%7.1f %7.1f %9.0f %10.5f %10.5f", xvar, yvar,
+			              Model_nTot_->GetBinContent(Model_nTot_->FindBin(xvar, yvar)),
+			              Model_yield_->GetBinContent(bins[k]), Model_yield_->GetBinError(bins[k]));
+			for (int i = 0; i < nSyst; ++i) table << Form(" %9.6f", Model_eff_[i]->GetBinContent(bins[k]));
+			table << endl;
+		}
+		table.close();
 
-			// float nloXsec      = xsecfit->Eval(xvar);
-			int   nGenBin      = Model_nTot_->FindBin(xvar, yvar);
-			float nGen         = Model_nTot_->GetBinContent(nGenBin);
-			float weight       = fLumiNorm / nGen;
-			float idsf(-999.), trigsf(-999.);
-			float lepsyst(0.);
-			float isrweight(-999.), isrweightdn(-999.);
-
-			int mu1(-1), mu2(-1);
-			if( isSSLLMuEvent(mu1, mu2) ){ // Same-sign loose-loose di muon event
-				if(isTightMuon(mu1) &&  isTightMuon(mu2) ){ // Tight-tight
-					n_tot++;
-					if ( IsSignalMuon[mu1] != 1 || IsSignalMuon[mu2] != 1 ) continue;
-					if ( (model == "T5VV" || model == "T5VVlowpt") && nChi != 2) continue;
-					signalTot++;
-					idsf   = getLeptonSFMu(MuPt[mu1], MuEta[mu1])*getLeptonSFMu(MuPt[mu2], MuEta[mu2]);
-					trigsf = getTriggerSFMuMu(MuEta[mu2]);
-					if (lowpt) trigsf =  getTriggerSFMuMuLowpt(MuEta[mu2]);
-					lepsyst = getLeptonSystematic(MuPt[mu1], MuPt[mu2], Muon);
-					isrweight   = getISRSystematic(susyPt, 0);
-					isrweightdn = getISRSystematic(susyPt, 2);
-					Model_nPass_         [i]-> Fill(xvar, yvar, idsf*trigsf*isrweight); // fill weighted by SFs
-					Model_isrUp_         [i]-> Fill(xvar, yvar, idsf*trigsf); // isr weight = 1
-					Model_isrDn_         [i]-> Fill(xvar, yvar, idsf*trigsf*isrweightdn);
-					Model_puNo_          [i]-> Fill(xvar, yvar, idsf*trigsf*PUWeight  *isrweight);
-					Model_puUp_          [i]-> Fill(xvar, yvar, idsf*trigsf*PUWeightUp*isrweight);
-					Model_puDn_          [i]-> Fill(xvar, yvar, idsf*trigsf*PUWeightDn*isrweight);
-					Model_nPass_noScale_ [i]-> Fill(xvar, yvar);
-					Model_lepSyst_       [i]-> Fill(xvar, yvar, lepsyst);
-					if (i==0) {
-						Model_yield_-> Fill(xvar, yvar, weight * gMMTrigScale);
-					}
-					if (xvar == 525 && yvar == 250) {
-						fOUTSTREAM << Form("%d mumu systematic: %d l1pt: %.2f l2pt: %.2f njets: %d nbjets: %d met: %.2f ht: %.2f trigSF: %.2f idSF: %.2f", Event, i, MuPt[mu1], MuPt[mu2], getNJets(), getNBTagsMed(), getMET(), getHT(), trigsf, idsf) << endl;
-					}
-					nMM++;
-					continue;
-				}
-				resetHypLeptons();
-			} // end loop on mumu channel
-			int mu(-1), el(-1);
-			if( isSSLLElMuEvent(mu, el) ){
-				if(  isTightElectron(el) &&  isTightMuon(mu) ){ // Tight-tight
-					n_tot++;
-					if ( IsSignalMuon[mu] != 1 || IsSignalElectron[el] != 1 ) continue;
-					if ( (model == "T5VV" || model == "T5VVlowpt") && nChi != 2) continue;
-					signalTot++;
-					idsf   = getLeptonSFMu(MuPt[mu], MuEta[mu])*getLeptonSFEl(ElPt[el], ElEta[el]);
-					trigsf = getTriggerSFMuEl();
-					if (lowpt) trigsf =  getTriggerSFMuElLowpt();
-					lepsyst = getLeptonSystematic(MuPt[mu], ElPt[el], ElMu);
-					isrweight   = getISRSystematic(susyPt, 0);
-					isrweightdn = getISRSystematic(susyPt, 2);
-					Model_nPass_         [i]-> Fill(xvar, yvar, idsf*trigsf*isrweight); // fill weighted by SFs
-					Model_isrUp_         [i]-> Fill(xvar, yvar, idsf*trigsf); // isr weight = 1
-					Model_isrDn_         [i]-> Fill(xvar, yvar, idsf*trigsf*isrweightdn);
-					Model_puNo_          [i]-> Fill(xvar, yvar, idsf*trigsf*PUWeight  *isrweight);
-					Model_puUp_          [i]-> Fill(xvar, yvar, idsf*trigsf*PUWeightUp*isrweight);
-					Model_puDn_          [i]-> Fill(xvar, yvar, idsf*trigsf*PUWeightDn*isrweight);
-					Model_nPass_noScale_ [i]-> Fill(xvar, yvar);
-					Model_lepSyst_       [i]-> Fill(xvar, yvar, lepsyst);
-					if (i==0) {
-						Model_yield_-> Fill(xvar, yvar, weight * gEMTrigScale);
-					}
-					nEM++;
-					if (xvar == 525 && yvar == 250) {
-						fOUTSTREAM << Form("%d emu systematic: %d l1pt: %.2f l2pt: %.2f njets: %d nbjets: %d met: %.2f ht: %.2f trigSF: %.2f idSF: %.2f", Event, i, MuPt[mu], ElPt[el], getNJets(), getNBTagsMed(), getMET(), getHT(), trigsf, idsf) << endl;
-					}
-					continue;
-				}
-				resetHypLeptons();
-			} // end loop on emu channel
-			int el1(-1), el2(-1);
-			if( isSSLLElEvent(el1, el2) ){
-				if(  isTightElectron(el1) &&  isTightElectron(el2) ){ // Tight-tight
-					n_tot++;
-					if ( IsSignalElectron[el1] != 1 || IsSignalElectron[el2] != 1 ) continue;
-					if ( (model == "T5VV" || model == "T5VVlowpt") && nChi != 2) continue;
-					signalTot++;
-					idsf   = getLeptonSFEl(ElPt[el1], ElEta[el1])*getLeptonSFEl(ElPt[el2], ElEta[el2]);
-					trigsf = getTriggerSFElEl(ElPt[el2]);
-					if (lowpt) trigsf =  getTriggerSFElElLowpt();
-					lepsyst = getLeptonSystematic(ElPt[el1], ElPt[el2], Elec);
-					isrweight   = getISRSystematic(susyPt, 0);
-					isrweightdn = getISRSystematic(susyPt, 2);
-					Model_nPass_         [i]-> Fill(xvar, yvar, idsf*trigsf*isrweight); // fill weighted by SFs
-					Model_isrUp_         [i]-> Fill(xvar, yvar, idsf*trigsf); // isr weight = 1
-					Model_isrDn_         [i]-> Fill(xvar, yvar, idsf*trigsf*isrweightdn);
-					Model_puNo_          [i]-> Fill(xvar, yvar, idsf*trigsf*PUWeight  *isrweight);
-					Model_puUp_          [i]-> Fill(xvar, yvar, idsf*trigsf*PUWeightUp*isrweight);
-					Model_puDn_          [i]-> Fill(xvar, yvar, idsf*trigsf*PUWeightDn*isrweight);
-					Model_nPass_noScale_ [i]-> Fill(xvar, yvar);
-					Model_lepSyst_       [i]-> Fill(xvar, yvar, lepsyst);
-					if (i==0) {
-						Model_yield_-> Fill(xvar, yvar, weight * gEETrigScale);
-					}
-					nEE++;
-					if (xvar == 525 && yvar == 250) {
-						fOUTSTREAM << Form("%d ee systematic: %d l1pt: %.2f l2pt: %.2f njets: %d nbjets: %d met: %.2f ht: %.2f trigSF: %.2f idSF: %.2f", Event, i, ElPt[el1], ElPt[el2], getNJets(), getNBTagsMed(), getMET(), getHT(), trigsf, idsf) << endl;
-					}
-				}
-			} // end loop on ee channel
-		} // end loop on all systematics
-	} // end loop on all events
-	if (verbose) cout << "Total Number of SS events: " << n_tot << endl;
-	if (verbose) cout << "nEE: " << nEE << " nEM: " << nEM << " nMM: " << nMM << endl;
-	if (verbose) fOUTSTREAM << "Total number of tight pairs: " << n_tot << " total number of signal pairs: " << signalTot << " resulting efficiency: " << signalTot/n_tot << endl;
-	if (verbose) fOUTSTREAM << "nEE: " << nEE << " nEM: " << nEM << " nMM: " << nMM << endl;
-
-	fOUTSTREAM.close();
+		for (int i=0; i<nSyst; i++) {
+			delete Model_eff_[i];
+			delete Model_nPass_[i];
+			delete Model_nPass_noScale_[i];
+			delete Model_lepSyst_[i];
+			delete Model_puNo_[i];
+			delete Model_puUp_[i];
+			delete Model_puDn_[i];
+			delete Model_isrUp_[i];
+			delete Model_isrDn_[i];
+		}
+		for (int i=0; i<ScanJob::kNCT10; ++i) {
+			delete Model_nPass_ct10_[i];
+			if (i<ScanJob::kNCTEQ) {
+				delete Model_nPass_cteq_[i];
+				delete Model_nPass_mstw_[i];
+			}
+		}
+		delete Model_yield_;
+	}
 
-	for (int i=0; i<nSyst;i++) {
-		Model_eff_ [i]->Divide(Model_nPass_[i], Model_nTot_ , 1. , 1.);
+	for (int i=0; i<ScanJob::kNCT10; ++i) {
+		delete Model_nTot_ct10_[i];
+		if (i<ScanJob::kNCTEQ) {
+			delete Model_nTot_cteq_[i];
+			delete Model_nTot_mstw_[i];
+		}
 	}
+	for (size_t k = 0; k < res.dists.size(); ++k) delete res.dists[k];
+	delete grid;
+	file_->Close();
+	delete file_;
+}
 
-	TFile * res_;
-	res_ = new TFile(fOutputDir+model+"_results_"+gRegions[reg]->sname+".root", "RECREATE", "res_");
-	res_   -> cd();
+void SSDLPlotter::scanModelEntries(ScanJob *job){
+	// Event loop of one worker of scanModelGeneric. Every entry is read once,
+	// each variation starts from the saved event instead of reading it again.
+	// The random generators are seeded with the event number, the results do
+	// not depend on the number of workers.
+	// make a dummy sample for the systematic functions
+	Sample *S = new Sample();
+	S->datamc = 1;
 
-	Model_yield_ ->Write();
-	Model_nTot_  ->Write();
-	Model_nTot_ISRweight_   ->Write();
-	Model_nTot_ISRweightDn_ ->Write();
-	if (Model_nTot_nChi2_ != NULL) {
-		Model_nTot_nChi2_  ->Write();
-		Model_nTot_nChi2_ISRweight_   ->Write();
-		Model_nTot_nChi2_ISRweightDn_ ->Write();
+	ScanGrid *G = job->grid;
+	const int nregs = job->regs.size();
+	for (Long64_t jentry = job->first; jentry < job->last; jentry++) {
+		if (fWorkerIndex == 0) printProgress(jentry-job->first, job->last-job->first, job->model+" Scan");
+		job->tree->GetEntry(jentry);
+		saveEvent();
+
+		// T6ttWW     scan: xvar = mGlu and yvar = mChi
+		// T6ttWW x05 scan: xvar = mGlu and yvar = mLSP
+		// T6ttWW x08 scan: xvar = mGlu and yvar = mLSP
+		// T5tttt     scan: xvar = mGlu and yvar = mChi
+		// T7btw      scan: xvar = mGlu and yvar = mChi
+		// T1tttt     scan: xvar = mGlu and yvar = mLSP
+		// T5VV       scan: xvar = mGlu and yvar = mChi
+		float xvar = mGlu;
+		float yvar = mLSP;
+		double *cell = G->GetCell(G->FindBin(xvar, yvar));
+		G->Fill(cell, ScanJob::counterSlot(ScanJob::kNEvents));
+		G->Fill(cell, ScanJob::counterSlot(ScanJob::kSumX), xvar);
+		G->Fill(cell, ScanJob::counterSlot(ScanJob::kSumY), yvar);
+
+		// PDF uncertainties, all events
+		job->fillPdf(cell, -1, WPdfCTEQ, WPdfCT10, WPdfMRST);
+
+		for (int r = 0; r < nregs; ++r) {
+			setRegionCuts(job->regs[r]);
+			if (job->lowpt) setLowPtCuts();
+
+			for (int i = 0; i < ScanJob::kNSyst; i++) {
+				restoreEvent();
+				fRand3       ->SetSeed(Event);
+				fRand3Normal ->SetSeed(Event);
+				saveBTags();      // save the values of the new btag
+				scaleBTags(S, 0, job->btagCorrection); // this applies the bTagSF
+
+				if (i == 1) smearJetPts(S, 1);
+				if (i == 2) smearJetPts(S, 2);
+				if (i == 3) smearJetPts(S, 3);
+				if (i == 4) {resetBTags(); scaleBTags(S, 1, job->btagCorrection);}
+				if (i == 5) {resetBTags(); scaleBTags(S, 2, job->btagCorrection);}
+				if (i == 6) scaleMET(S, 0);
+				if (i == 7) scaleMET(S, 1);
+
+				scanModelFill(job, r, i, xvar, yvar, cell);
+			}
+		}
 	}
-	Model_HT_xVal_yVal_       ->Write();
-	Model_MET_xVal_yVal_      ->Write();
-	Model_NJETS_xVal_yVal_    ->Write();
-	Model_JETPT_xVal_yVal_    ->Write();
-	Model_GENJETPT_xVal_yVal_ ->Write();
-	Model_PT_xVal_yVal_       ->Write();
-
-	for (int i=0; i<nSyst; i++) {
-		Model_eff_             [i]->Write();
-		Model_nPass_           [i]->Write();
-		Model_nPass_noScale_   [i]->Write();
-		Model_lepSyst_         [i]->Write();
-		Model_puNo_            [i]->Write();
-		Model_puUp_            [i]->Write();
-		Model_puDn_            [i]->Write();
-		Model_isrUp_           [i]->Write();
-		Model_isrDn_           [i]->Write();
+	delete S;
+}
+
+void SSDLPlotter::scanModelFill(ScanJob *job, int r, int i, float xvar, float yvar, double *cell){
+	// Selection of region r for variation i on the current event
+	ScanGrid *G = job->grid;
+	const bool nchi2 = (job->model == "T5VV" || job->model == "T5VVlowpt");
+
+	// PDF uncertainties:
+	// =====================================================================
+	if ( i ==0) {
+		int m1(-1), m2(-1);
+		if( isSSLLMuEvent(m1, m2) ){ // Same-sign loose-loose di muon event
+			if(isTightMuon(m1) &&  isTightMuon(m2) ){ // Tight-tight
+				if ( IsSignalMuon[m1] != 1 || IsSignalMuon[m2] != 1 ) return;
+				job->fillPdf(cell, r, WPdfCTEQ, WPdfCT10, WPdfMRST);
+			}
+		}
+		int m(-1), e(-1);
+		if( isSSLLElMuEvent(m, e) ){
+			if(  isTightElectron(e) &&  isTightMuon(m) ){ // Tight-tight
+				if ( IsSignalMuon[m] != 1 || IsSignalElectron[e] != 1 ) return;
+				job->fillPdf(cell, r, WPdfCTEQ, WPdfCT10, WPdfMRST);
+			}
+		}
+		int e1(-1), e2(-1);
+		if( isSSLLElEvent(e1, e2) ){
+			if(  isTightElectron(e1) &&  isTightElectron(e2) ){ // Tight-tight
+				if ( IsSignalElectron[e1] != 1 || IsSignalElectron[e2] != 1 ) return;
+				job->fillPdf(cell, r, WPdfCTEQ, WPdfCT10, WPdfMRST);
+			}
+		}
+		// =====================================================================
 	}
-	for (int i=0; i<nct10; ++i){
-		Model_nTot_ct10_ [i] ->Write();
-		Model_nPass_ct10_[i] ->Write();
-		if (i<40) {
-			Model_nTot_cteq_ [i] ->Write();
-			Model_nTot_mstw_ [i] ->Write();
-			Model_nPass_cteq_[i] ->Write();
-			Model_nPass_mstw_[i] ->Write();
+
+	if (xvar == ScanJob::xVal && yvar == ScanJob::yVal) {
+		TH1F ** dists = &job->dists[r*ScanJob::kNDists];
+		dists[ScanJob::kHT]    -> Fill(getHT()   );
+		dists[ScanJob::kMET]   -> Fill(getMET()  );
+		dists[ScanJob::kNJETS] -> Fill(getNJets());
+		for (int j = 0; j <NJets; ++j) {
+			dists[ScanJob::kJETPT]    -> Fill(JetPt[j]);
+			dists[ScanJob::kGENJETPT] -> Fill(JetGenPt[j]);
 		}
+		for (int j = 0; j < NMus; ++j) dists[ScanJob::kPT] -> Fill(MuPt[j]);
+		for (int j = 0; j < NEls; ++j) dists[ScanJob::kPT] -> Fill(ElPt[j]);
 	}
-	file_->Close();
-	res_->Close();
 
-	delete res_, Model_nTot_, Model_nTot_ISRweight_, Model_nTot_ISRweightDn_;
+	// float nloXsec      = xsecfit->Eval(xvar);
+	int   nGenBin      = job->nTot->FindFixBin(xvar, yvar);
+	float nGen         = job->nTot->GetBinContent(nGenBin);
+	float weight       = fLumiNorm / nGen;
+	float idsf(-999.), trigsf(-999.);
+	float lepsyst(0.);
+	float isrweight(-999.), isrweightdn(-999.);
+	bool  debug = job->debug && xvar == 525 && yvar == 250;
+
+	int mu1(-1), mu2(-1);
+	if( isSSLLMuEvent(mu1, mu2) ){ // Same-sign loose-loose di muon event
+		if(isTightMuon(mu1) &&  isTightMuon(mu2) ){ // Tight-tight
+			job->nTight[r]++;
+			if ( IsSignalMuon[mu1] != 1 || IsSignalMuon[mu2] != 1 ) return;
+			if ( nchi2 && nChi != 2) return;
+			job->nSignal[r]++;
+			idsf   = getLeptonSFMu(MuPt[mu1], MuEta[mu1])*getLeptonSFMu(MuPt[mu2], MuEta[mu2]);
+			trigsf = getTriggerSFMuMu(MuEta[mu2]);
+			if (job->lowpt) trigsf =  getTriggerSFMuMuLowpt(MuEta[mu2]);
+			lepsyst = getLeptonSystematic(MuPt[mu1], MuPt[mu2], Muon);
+			isrweight   = getISRSystematic(susyPt, 0);
+			isrweightdn = getISRSystematic(susyPt, 2);
+			job->fillPass(cell, r, i, idsf*trigsf, isrweight, isrweightdn, PUWeight, PUWeightUp, PUWeightDn, lepsyst);
+			if (i==0) G->Fill(cell, ScanJob::yieldSlot(r), weight * gMMTrigScale);
+			if (debug) {
+				job->debugLines[r].push_back(TString::Format("%d mumu systematic: %d l1pt: %.2f l2pt: %.2f njets: %d nbjets: %d met: %.2f ht: %.2f trigSF: %.2f idSF: %.2f", Event, i, MuPt[mu1], MuPt[mu2], getNJets(), getNBTagsMed(), getMET(), getHT(), trigsf, idsf));
+			}
+			job->nMM[r]++;
+			return;
+		}
+		resetHypLeptons();
+	} // end loop on mumu channel
+	int mu(-1), el(-1);
+	if( isSSLLElMuEvent(mu, el) ){
+		if(  isTightElectron(el) &&  isTightMuon(mu) ){ // Tight-tight
+			job->nTight[r]++;
+			if ( IsSignalMuon[mu] != 1 || IsSignalElectron[el] != 1 ) return;
+			if ( nchi2 && nChi != 2) return;
+			job->nSignal[r]++;
+			idsf   = getLeptonSFMu(MuPt[mu], MuEta[mu])*getLeptonSFEl(ElPt[el], ElEta[el]);
+			trigsf = getTriggerSFMuEl();
+			if (job->lowpt) trigsf =  getTriggerSFMuElLowpt();
+			lepsyst = getLeptonSystematic(MuPt[mu], ElPt[el], ElMu);
+			isrweight   = getISRSystematic(susyPt, 0);
+			isrweightdn = getISRSystematic(susyPt, 2);
+			job->fillPass(cell, r, i, idsf*trigsf, isrweight, isrweightdn, PUWeight, PUWeightUp, PUWeightDn, lepsyst);
+			if (i==0) G->Fill(cell, ScanJob::yieldSlot(r), weight * gEMTrigScale);
+			job->nEM[r]++;
+			if (debug) {
+				job->debugLines[r].push_back(TString::Format("%d emu systematic: %d l1pt: %.2f l2pt: %.2f njets: %d nbjets: %d met: %.2f ht: %.2f trigSF: %.2f idSF: %.2f", Event, i, MuPt[mu], ElPt[el], getNJets(), getNBTagsMed(), getMET(), getHT(), trigsf, idsf));
+			}
+			return;
+		}
+		resetHypLeptons();
+	} // end loop on emu channel
+	int el1(-1), el2(-1);
+	if( isSSLLElEvent(el1, el2) ){
+		if(  isTightElectron(el1) &&  isTightElectron(el2) ){ // Tight-tight
+			job->nTight[r]++;
+			if ( IsSignalElectron[el1] != 1 || IsSignalElectron[el2] != 1 ) return;
+			if ( nchi2 && nChi != 2) return;
+			job->nSignal[r]++;
+			idsf   = getLeptonSFEl(ElPt[el1], ElEta[el1])*getLeptonSFEl(ElPt[el2], ElEta[el2]);
+			trigsf = getTriggerSFElEl(ElPt[el2]);
+			if (job->lowpt) trigsf =  getTriggerSFElElLowpt();
+			lepsyst = getLeptonSystematic(ElPt[el1], ElPt[el2], Elec);
+			isrweight   = getISRSystematic(susyPt, 0);
+			isrweightdn = getISRSystematic(susyPt, 2);
+			job->fillPass(cell, r, i, idsf*trigsf, isrweight, isrweightdn, PUWeight, PUWeightUp, PUWeightDn, lepsyst);
+			if (i==0) G->Fill(cell, ScanJob::yieldSlot(r), weight * gEETrigScale);
+			job->nEE[r]++;
+			if (debug) {
+				job->debugLines[r].push_back(TString::Format("%d ee systematic: %d l1pt: %.2f l2pt: %.2f njets: %d nbjets: %d met: %.2f ht: %.2f trigSF: %.2f idSF: %.2f", Event, i, ElPt[el1], ElPt[el2], getNJets(), getNBTagsMed(), getMET(), getHT(), trigsf, idsf));
+			}
+		}
+	} // end loop on ee channel
 }
+
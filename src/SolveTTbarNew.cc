@@ -19,9 +19,12 @@ debug(0),
 mt(173.), mW(80.4),
 qz1lo(-3000.), qz1hi(3000.), qz2lo(-3000.), qz2hi(3000.), nscan(1000), qz1strt(0.), qz2strt(0.), discconverge(0.000001),
 qz1min(0.), qz2min(0.),
-status(-1)
+status(-1),
+fMinimizer(0), fFunctor(this, &SolveTTbarNew::EquationPar, 2),
+fTolerance(0.001), fMaxCalls(1000000), fWarmStart(true)
 {
-
+ for(int i = 0; i<18; ++i) fPar[i] = 0.;
+ ResetStatistics();
  return;
 }
 
@@ -30,7 +33,22 @@ status(-1)
 //****************************************************************************
 
 SolveTTbarNew::~SolveTTbarNew () {
+	delete fMinimizer;
+}
 
+void SolveTTbarNew::ResetStatistics(){
+	fNMin = 0; fNConverged = 0; fNCalls = 0;
+	fMaxNCalls = 0;
+	fSumEdm = 0.;
+}
+
+void SolveTTbarNew::PrintStatistics(){
+	cout << " SolveTTbarNew: " << fNMin << " minimizations with " << fMinName << " " << fAlgoName
+	     << " (tolerance " << fTolerance << ", warm start " << (fWarmStart ? "on" : "off") << ")" << endl;
+	if(fNMin == 0) return;
+	cout << "   converged (status 0): " << 100.*GetConvergedFraction() << " %" << endl;
+	cout << "   function calls: mean " << GetMeanNCalls() << ", max " << fMaxNCalls << endl;
+	cout << "   mean EDM: " << GetMeanEdm() << endl;
 }
 
 //NEW
@@ -50,6 +68,13 @@ double SolveTTbarNew::EquationGlob(const double *xglob){
 
 }
 
+double SolveTTbarNew::EquationPar(const double *x){
+// same as equation with the fixed parameters of the current minimization
+	double xx[2] = {x[0], x[1]};
+	return Equation(xx,fPar);
+
+}
+
 double SolveTTbarNew::Equation(double *x, double *p){
 // Solves the constraint equations and returns a discriminant of type D2
 // expects qz in q[2] to be filled for q1 and q2
@@ -124,12 +149,10 @@ double SolveTTbarNew::Equation(double *x, double *p){
 
 }
 
-// does Minimization of equation using some minimizers defined in root
-// output is discriminant of type D2
-double SolveTTbarNew::NumericalMinimization(int &statuss, double &edm, double &q1z, double&q2z, double pb1[], double pb2[], double pl1[], double pl2[], double pTm[], const char *minName, const char *algoName, int randomSeed)
-{
-   // create minimizer giving a name and a name (optionally) for the specific
-   // algorithm
+ROOT::Math::Minimizer* SolveTTbarNew::GetMinimizer(const char *minName, const char *algoName){
+// the minimizer is created once and reused, unless another one is asked for
+   if(fMinimizer != 0 && fMinName == minName && fAlgoName == algoName) return fMinimizer;
+   delete fMinimizer;
    // possible choices are: 
    //     minName                  algoName
    // Minuit /Minuit2             Migrad, Simplex,Combined,Scan  (default is Migrad)
@@ -140,78 +163,68 @@ double SolveTTbarNew::NumericalMinimization(int &statuss, double &edm, double &q
    //  GSLMultiFit
    //   GSLSimAn
    //   Genetic
-   ROOT::Math::Minimizer* min = 
-      ROOT::Math::Factory::CreateMinimizer(minName, algoName);
-
-   // set tolerance , etc...
-   min->SetMaxFunctionCalls(1000000); // for Minuit/Minuit2 
-   min->SetMaxIterations(10000);  // for GSL 
-   min->SetTolerance(0.001);
-   min->SetPrintLevel(0);
+   fMinimizer = ROOT::Math::Factory::CreateMinimizer(minName, algoName);
+   if(fMinimizer == 0){
+      cout << "SolveTTbarNew::GetMinimizer ==> Error: cannot create minimizer " << minName << " " << algoName << endl;
+      return 0;
+   }
+   fMinName  = minName;
+   fAlgoName = algoName;
+   fMinimizer->SetPrintLevel(0);
+   fMinimizer->SetFunction(fFunctor);
+   return fMinimizer;
+}
 
-   // create funciton wrapper for minmizer
-   // a IMultiGenFunction type 
-   SolveTTbarNew dummy;
-   ROOT::Math::Functor f(&dummy, &SolveTTbarNew::EquationGlob, 20); 
-   double step[2] = {0.001,0.001};
+// does Minimization of equation using some minimizers defined in root
+// output is discriminant of type D2
+double SolveTTbarNew::NumericalMinimization(int &statuss, double &edm, double &q1z, double&q2z, double pb1[], double pb2[], double pl1[], double pl2[], double pTm[], const char *minName, const char *algoName, int randomSeed)
+{
    // starting point
-    
-   double variable[2] = { q1z,q2z};
-   //double variable[2] = { 0.,0.};
    if (randomSeed >= 0) { 
       TRandom2 r(randomSeed);
-      variable[0] = r.Uniform(-20,20);
-      variable[1] = r.Uniform(-20,20);
+      q1z = r.Uniform(-20,20);
+      q2z = r.Uniform(-20,20);
    }
- 
-   min->SetFunction(f);
- 
+   // fixed parameters
+   GetEquationParameters(pb1, pb2, pl1, pl2, pTm, fPar);
+   return Minimize(statuss, edm, q1z, q2z, minName, algoName);
+}
+
+void SolveTTbarNew::MinimizePairings(int npairs, double pb1[][4], double pb2[][4], double pl1[], double pl2[], double pTm[], D2Result res[], const char *minName, const char *algoName)
+{
+   double q1z = 0., q2z = 0.;
+   for(int i = 0; i < npairs; ++i){
+      D2Result &r = res[i];
+      if(!fWarmStart || i == 0 || res[i-1].status != 0){ q1z = 0.; q2z = 0.; }
+      GetEquationParameters(pb1[i], pb2[i], pl1, pl2, pTm, fPar);
+      r.d2     = Minimize(r.status, r.edm, q1z, q2z, minName, algoName);
+      r.q1z    = q1z;
+      r.q2z    = q2z;
+      r.ncalls = fMinimizer != 0 ? fMinimizer->NCalls() : 0;
+   }
+}
+
+double SolveTTbarNew::Minimize(int &statuss, double &edm, double &q1z, double &q2z, const char *minName, const char *algoName)
+{
+   ROOT::Math::Minimizer* min = GetMinimizer(minName, algoName);
+   if(min == 0){
+      statuss = -1;
+      return 9999.99;
+   }
+   // start from scratch, keeping the minimizer and the function
+   min->Clear();
+
+   // set tolerance , etc...
+   min->SetMaxFunctionCalls(fMaxCalls); // for Minuit/Minuit2 
+   min->SetMaxIterations(10000);  // for GSL 
+   min->SetTolerance(fTolerance);
+
+   double step[2] = {0.001,0.001};
    // Set the free variables to be minimized!
-//   min->SetVariable(0,"x",variable[0], step[0]);
-//   min->SetVariable(1,"y",variable[1], step[1]);
-   min->SetLimitedVariable(0,"x",variable[0], step[0],-8050.,8050.);
-   min->SetLimitedVariable(1,"y",variable[1], step[1],-8050.,8050.);
-
-   // Set fixed variables
-   min->SetFixedVariable(2,  "pb1x",    pb1[0]);
-   min->SetFixedVariable(3,  "pb1y",    pb1[1]);
-   min->SetFixedVariable(4,  "pb1z",    pb1[2]);
-   min->SetFixedVariable(5,  "pb1mag",  pb1[3]);
-   min->SetFixedVariable(6,  "pb2x",    pb2[0]);
-   min->SetFixedVariable(7,  "pb2y",    pb2[1]);
-   min->SetFixedVariable(8,  "pb2z",    pb2[2]);
-   min->SetFixedVariable(9,  "pb2mag",  pb2[3]);
-   min->SetFixedVariable(10, "pl1x",    pl1[0]);
-   min->SetFixedVariable(11, "pl1y",    pl1[1]);
-   min->SetFixedVariable(12, "pl1z",    pl1[2]);
-   min->SetFixedVariable(13, "pl1mag",  pl1[3]);
-   min->SetFixedVariable(14, "pl2x",    pl2[0]);
-   min->SetFixedVariable(15, "pl2y",    pl2[1]);
-   min->SetFixedVariable(16, "pl2z",    pl2[2]);
-   min->SetFixedVariable(17, "pl2mag",  pl2[3]);
-   min->SetFixedVariable(18, "pTmx",    pTm[0]);
-   min->SetFixedVariable(19, "pTmy",    pTm[1]);
-   // Set fixed but smeared Variables --> very slow ~ 5 h
-/*   double st = 0.01;
-   min->SetLimitedVariable(2,  "pb1x",    pb1[0], st, 0.8*pb1[0], 1.2*pb1[0]);
-   min->SetLimitedVariable(3,  "pb1y",    pb1[1], st, 0.8*pb1[1], 1.2*pb1[1]);
-   min->SetLimitedVariable(4,  "pb1z",    pb1[2], st, 0.8*pb1[2], 1.2*pb1[2]);
-   min->SetLimitedVariable(5,  "pb1mag",  pb1[3], st, 0.8*pb1[3], 1.2*pb1[3]);
-   min->SetLimitedVariable(6,  "pb2x",    pb2[0], st, 0.8*pb2[0], 1.2*pb2[0]);
-   min->SetLimitedVariable(7,  "pb2y",    pb2[1], st, 0.8*pb2[1], 1.2*pb2[1]);
-   min->SetLimitedVariable(8,  "pb2z",    pb2[2], st, 0.8*pb2[2], 1.2*pb2[2]);
-   min->SetLimitedVariable(9,  "pb2mag",  pb2[3], st, 0.8*pb2[3], 1.2*pb2[3]);
-   min->SetLimitedVariable(10, "pl1x",    pl1[0], st, 0.99*pl1[0],1.01*pl1[0]);
-   min->SetLimitedVariable(11, "pl1y",    pl1[1], st, 0.99*pl1[1],1.01*pl1[1]);
-   min->SetLimitedVariable(12, "pl1z",    pl1[2], st, 0.99*pl1[2],1.01*pl1[2]);
-   min->SetLimitedVariable(13, "pl1mag",  pl1[3], st, 0.99*pl1[3],1.01*pl1[3]);
-   min->SetLimitedVariable(14, "pl2x",    pl2[0], st, 0.99*pl2[0],1.01*pl2[0]);
-   min->SetLimitedVariable(15, "pl2y",    pl2[1], st, 0.99*pl2[1],1.01*pl2[1]);
-   min->SetLimitedVariable(16, "pl2z",    pl2[2], st, 0.99*pl2[2],1.01*pl2[2]);
-   min->SetLimitedVariable(17, "pl2mag",  pl2[3], st, 0.99*pl2[3],1.01*pl2[3]);
-   min->SetLimitedVariable(18, "pTmx",    pTm[0], st, 0.8*pTm[0], 1.2*pTm[0]);
-   min->SetLimitedVariable(19, "pTmy",    pTm[1], st, 0.8*pTm[1], 1.2*pTm[1]);
-*/
+   // the fixed ones (b jets, leptons, MET) are in fPar, see EquationPar
+   min->SetLimitedVariable(0,"x",q1z, step[0],-8050.,8050.);
+   min->SetLimitedVariable(1,"y",q2z, step[1],-8050.,8050.);
+
    // do the minimization
    min->Minimize(); 
    statuss = min->Status();
@@ -221,11 +234,16 @@ double SolveTTbarNew::NumericalMinimization(int &statuss, double &edm, double &q
    edm = min->Edm();
    q1z = xs[0], q2z = xs[1];
 
-   if(debug>0 /*|| status>0 || returnValue>300.*/ /*|| (fabs(q1z)==1000.||fabs(q2z)==1000.||q1z==0.||q2z==0.||edm>0.01||returnValue>800.) || algoName=="Combined" || algoName=="Fumili2" || algoName=="Migrad" || (fabs(returnValue-edm)<0.1 && edm>0.01) *//*|| returnValue==edm || (algoName=="Migrad"&&statuss==0) */){
+   fNMin++;
+   if(statuss == 0) fNConverged++;
+   fNCalls += min->NCalls();
+   if(min->NCalls() > fMaxNCalls) fMaxNCalls = min->NCalls();
+   fSumEdm += edm;
+
+   if(debug>0){
    std::cout << "Minimum: f(" << xs[0] << ", " << xs[1] << "): " 
              << "D " <<  min->MinValue()  << std::endl;
-   std::cout << "Additional Info for method " << minName << " with algorithm " << algoName << ": EDM " << min->Edm() << " NCalls " << min->NCalls() << " Nfree " << min->NFree() << " errorscale " << min->ErrorDef() << " status " << statuss << " strategy " << min->Strategy() << std::endl;
-//   if(debug>1){
+   std::cout << "Additional Info for method " << fMinName << " with algorithm " << fAlgoName << ": EDM " << min->Edm() << " NCalls " << min->NCalls() << " Nfree " << min->NFree() << " errorscale " << min->ErrorDef() << " status " << statuss << " strategy " << min->Strategy() << std::endl;
 	min->Hesse();
 	std::cout << " now Provide error: " << std::endl;
 	min->ProvidesError();
@@ -234,16 +252,11 @@ double SolveTTbarNew::NumericalMinimization(int &statuss, double &edm, double &q
 	std::cout << gs;// << ",  " << gs[1];// << std::endl;
    	const double *es = min->Errors();
    	std::cout << " errors at minimum: " << es[0] << ",  " << es[1] << std::endl;
-//	if(debug>2){
 	   std::cout << "Print results: " << std::endl;
 	   min->PrintResults();
-//	}
-//    }
 	std::cout << std::endl;
    }
 
-//   delete xs;
-   delete min;
    return returnValue;
 
 }
@@ -1,10 +1,16 @@
 #include <stdlib.h>
 #include <TTree.h>
 #include <TString.h>
+#include <TThread.h>
+#include <TFile.h>
+#include <TFileMerger.h>
+#include <TSystem.h>
+#include <TDirectory.h>
 #include <sstream>
 #include <stdio.h>
 #include <assert.h>
 #include <fstream>
+#include <algorithm>
 
 #include "base/TreeAnalyzerBase.hh"
 
@@ -15,13 +21,41 @@ TreeAnalyzerBase::TreeAnalyzerBase(std::vector<std::string>& fileList) {
     fNEntries = fTR->GetEntries();
     fVerbose = 0;
     fMaxEvents = -1;
+    fNThreads = 1;
+    fShowProgress = true;
+    fFileList = fileList;
     fCurRun = -1; // Initialise to dummy value
     fCurLumi = -1;
     skipLumi = false;
     skipRun = false;
 }
 
+TreeAnalyzerBase::TreeAnalyzerBase(std::vector<std::string>& fileList, const TreeAnalyzerBase *master) {
+    fTR = new TreeReader(fileList);
+    fNEntries = fTR->GetEntries();
+    fIsData = master->fIsData;
+    fOutputDir = master->fOutputDir;
+    fOutputFile = master->fOutputFile;
+    fVerbose = master->fVerbose;
+    fMaxEvents = -1;
+    fNThreads = 1;
+    fShowProgress = false;
+    fFileList = fileList;
+    fGoodRunList = master->fGoodRunList;
+    fCurRun = -1;
+    fCurLumi = -1;
+    skipLumi = false;
+    skipRun = false;
+}
+
 TreeAnalyzerBase::~TreeAnalyzerBase(){
+    // Branches read in this job: can be fed to getBranches.pl -report
+    TString report = fOutputDir + "UsedBranches.txt";
+    fTR->WriteBranchReport(report.Data());
+    if ( fVerbose>0 ) {
+        cout << "Branches read (list written to " << report << "):" << endl;
+        fTR->PrintBranchReport(cout);
+    }
     delete fTR;
 }
 
@@ -36,115 +70,144 @@ void TreeAnalyzerBase::PrintProgress(Long64_t entry){
         if ( !(entry/power) ) break;
         step = power;
     }
+    if ( !fShowProgress ) return;
     if( !(entry%step) ) cout << ">>> Processing event # " << entry << endl;
     else if ( entry==fNEntries-1 )
         cout << ">>> Processing last event # " << entry << endl;
 }
 
 // ---------------------------------
-// JSON stuff
-void TreeAnalyzerBase::ReadJSON(const char* JSONpath) {
-    string line;	
-    ifstream JSON(JSONpath);
-    if(!JSON) cout << "ERROR : JSON FILE DOES NOT EXIST" << endl;
-    assert(JSON);
-    if (JSON.is_open()){
-      string tmp;
-      while (JSON.good()){
-        getline (JSON,tmp);
-	line+=tmp;
-      }
+// Parallel running
+const bool TreeAnalyzerBase::IsParallel() const {
+    // A maximum number of events is counted over the whole job: serial
+    return fNThreads > 1 && fMaxEvents < 0;
+}
+
+// Number of events in a file, -1 if it cannot be read
+static Long64_t countEntries(const string& file){
+    TFile *f = TFile::Open(file.c_str());
+    if ( !f ) return -1;
+    TTree *tree = (TTree*)f->Get("Events");
+    Long64_t n = tree ? tree->GetEntries() : -1;
+    delete f;
+    return n;
+}
+
+static void* runWorker(void *arg){
+    TreeAnalyzerBase *worker = (TreeAnalyzerBase*)arg;
+    worker->Loop();
+    return 0;
+}
+
+void TreeAnalyzerBase::LoopParallel(){
+    // Workers are made, begun and ended on this thread, only their event
+    // loops run in parallel. Each reads a contiguous range of entries, from
+    // the files which hold it.
+    TThread::Initialize();
+    TDirectory *dir = gDirectory;
+    const int nfiles = fFileList.size();
+    const Long64_t nentries = fTR->GetEntries();
+
+    // First entry of each file in the chain
+    vector<Long64_t> start(nfiles+1, 0);
+    for ( int i=0; i<nfiles; ++i ) {
+        Long64_t n = countEntries(fFileList[i]);
+        start[i+1] = start[i] + (n > 0 ? n : 0);
     }
-    JSON.close();
-
-    line.erase(0,1);
-    line.erase(line.size()-1);
-	
-    size_t index;
-    while( (index=line.find("  ")) != string::npos )  line.erase(index,1);
-
-    // split JSON into runs with associated lumis
-    string c =", \"";
-    vector<string> splitted;
-    while(line.find(c) != string::npos){
-        int loc = line.find(c);
-        string tmp=line.substr(0, (loc));
-        splitted.push_back(tmp);	
-        line=line.erase(0, tmp.size()+2);
-    }	       
-    splitted.push_back(line); // for the last entry
-	
-    // loop over runs (with lumis)
-    for(size_t i=0; i<splitted.size(); ++i){
-        fCurRunLumi.run =0;
-        fCurRunLumi.lumi_min.clear();
-        fCurRunLumi.lumi_max.clear();
-
-        // first seperate runs and save them
-        if(splitted[i].find(":") != string::npos){
-            int loc = splitted[i].find(":");
-            string tmp = splitted[i].substr(1,loc-2);
-            stringstream ss ( tmp);
-            ss >> fCurRunLumi.run;
-            splitted[i].erase(0, loc+1);
-        }else {cout << "ERROR in ReadJSON: seperate runs" << endl; return;}
-
-        // now we're left with the lumis, remove the surrounding "[]"
-        if(splitted[i].find("[[") == string::npos || splitted[i].find("]]") == string::npos){ cout << "ERROR in ReadJSON: lumi parsing" << endl; return;}
-        else{
-            int loc  = splitted[i].find("[[");
-            int loc2 = splitted[i].find("]]");
-            splitted[i].erase(loc   , 1);
-            splitted[i].erase(loc2  , 1);
+    const bool byEntry = (start[nfiles] == nentries);
+    if ( !byEntry )
+        cout << "TreeAnalyzerBase::LoopParallel ==> Warning: cannot count the entries of each file, splitting by file" << endl;
+    const Long64_t nparts = byEntry ? nentries : nfiles;
+    const int nworkers = fNThreads < nparts ? fNThreads : nparts;
+
+    vector<TreeAnalyzerBase*> workers;
+    fWorkerOutputs.clear();
+    for ( int i=0; i<nworkers; ++i ) {
+        int firstFile = i*nfiles/nworkers, endFile = (i+1)*nfiles/nworkers;
+        Long64_t first = 0, last = -1; // entries in the worker's files
+        if ( byEntry ) {
+            Long64_t begin = i*nentries/nworkers, end = (i+1)*nentries/nworkers;
+            firstFile = upper_bound(start.begin(), start.end(), begin) - start.begin() - 1;
+            endFile   = lower_bound(start.begin(), start.end(), end) - start.begin();
+            first = begin - start[firstFile];
+            last  = end - start[firstFile];
         }
-        // left with lumis a la [a, b], [c, d], ...
-        while(splitted[i].find("[")!= string::npos){
-            int loc1 = splitted[i].find("[");
-            int loc2 = splitted[i].find("]");
-            int loc3 = splitted[i].find(",", loc1);
-            string lumi1= splitted[i].substr(loc1+1, loc3-1);
-            string lumi2= splitted[i].substr(loc3+1, loc2-1);
-            stringstream ss (lumi1); int lumimin;
-            ss >> lumimin;	
-            fCurRunLumi.lumi_min.push_back(lumimin);
-            stringstream ss2 (lumi2); int lumimax;
-            ss2 >> lumimax;
-            fCurRunLumi.lumi_max.push_back(lumimax);
-            splitted[i].erase(loc1, loc2-loc1+3);
-        }
-	// push_back run and lumis
-	fRunLumis.push_back(fCurRunLumi);
+        vector<string> files(fFileList.begin() + firstFile, fFileList.begin() + endFile);
+        TString output = fOutputFile;
+        output.ReplaceAll(".root", "");
+        output += Form("_part%d.root", i);
+        TreeAnalyzerBase *worker = MakeWorker(files, output);
+        if ( !worker ) break;
+        worker->fTR->SetEntryRange(first, last);
+        if ( byEntry ) worker->fNEntries = last - first;
+        worker->fShowProgress = (i == 0);
+        workers.push_back(worker);
+        fWorkerOutputs.push_back(output);
+    }
+    dir->cd();
+    if ( workers.empty() ) {
+        cout << "TreeAnalyzerBase::LoopParallel ==> No parallel running for this analyzer, running serially" << endl;
+        fNThreads = 1;
+        fWorkerOutputs.clear();
+        Loop();
+        return;
     }
+    cout << " Running on " << nentries << " events in " << nfiles << " files with " << workers.size() << " threads" << endl;
 
-    if(fVerbose >1){
-        cout << "-----------------------------------------------" << endl;
-        cout << "Reading the following runs and lumi sections from JSON file:" << endl; 
-        for(size_t i=0; i<fRunLumis.size(); ++i){
-            cout << "  Run: " << fRunLumis[i].run << " Lumis: " ;
-            for(size_t k=0; k<fRunLumis[i].lumi_min.size(); ++k){
-                cout << " [" << fRunLumis[i].lumi_min[k] << ", " << fRunLumis[i].lumi_max[k] << "] ";
-            }
-            cout << endl;
-        }
-        cout << "-----------------------------------------------" << endl;
+    vector<TThread*> threads;
+    for ( size_t i=0; i<workers.size(); ++i ) {
+        threads.push_back(new TThread(Form("TreeAnalyzer_%d", int(i)), runWorker, workers[i]));
+        threads.back()->Run();
+    }
+    for ( size_t i=0; i<workers.size(); ++i ) {
+        threads[i]->Join();
+        delete threads[i];
+    }
+
+    for ( size_t i=0; i<workers.size(); ++i ) {
+        MergeWorker(workers[i]);
+        workers[i]->EndJob();
+        delete workers[i];
+    }
+    dir->cd();
+}
+
+void TreeAnalyzerBase::MergeWorker(TreeAnalyzerBase *worker){
+    fTR->AddBranchReport(*worker->fTR);
+}
+
+void TreeAnalyzerBase::MergeOutputs(const TString& outputFile){
+    // Trees are chained and histograms added, as with hadd
+    if ( fWorkerOutputs.empty() ) return;
+    TFileMerger merger(kFALSE);
+    merger.OutputFile(outputFile, kTRUE);
+    for ( size_t i=0; i<fWorkerOutputs.size(); ++i ) merger.AddFile(fWorkerOutputs[i]);
+    if ( !merger.Merge() ) {
+        cout << "TreeAnalyzerBase::MergeOutputs ==> Error: merging into " << outputFile << " failed, keeping the part files" << endl;
+        return;
     }
+    for ( size_t i=0; i<fWorkerOutputs.size(); ++i ) gSystem->Unlink(fWorkerOutputs[i]);
+    fWorkerOutputs.clear();
+}
+
+// ---------------------------------
+// JSON stuff
+void TreeAnalyzerBase::ReadJSON(const char* JSONpath) {
+    // JSONpath can combine several files, see GoodRunList::ReadJSON
+    bool ok = fGoodRunList.ReadJSON(JSONpath);
+    if(!ok) cout << "ERROR : JSON FILE DOES NOT EXIST" << endl;
+    assert(ok);
+
+    if(fVerbose >1) fGoodRunList.Print(cout);
 }
 
 const bool TreeAnalyzerBase::CheckRunLumi(void) const {
-    bool good(false);
-    if(fRunLumis.size()==0) {
+    if(!fGoodRunList.IsInitialized()) {
         if (fVerbose>1) 
             cout << "CheckRunLumi: fRunLumis is empty. Assuming no JSON." << endl; 
         return true;
     }
-    for(size_t r=0; r<fRunLumis.size(); ++r){
-        if(fTR->Run != fRunLumis[r].run) continue;
-        for(size_t l=0; l<fRunLumis[r].lumi_min.size(); ++l){
-            if(fTR->LumiSection < fRunLumis[r].lumi_min[l]) continue;
-            if(fTR->LumiSection > fRunLumis[r].lumi_max[l]) continue;
-            good = true;
-        }
-    }
+    bool good = fGoodRunList.CheckRunLumi(fTR->Run, fTR->LumiSection);
     if(fVerbose > 3){
         if(good) cout <<  "JSON: accepted ";
         else     cout <<  "JSON: rejected ";
@@ -156,17 +219,13 @@ const bool TreeAnalyzerBase::CheckRunLumi(void) const {
 //________________________________________________________________________________________
 const bool TreeAnalyzerBase::CheckRun(void) const {
     // Check if current run is in JSON file
-    bool runInJson(false);
-
     // Not initialized: assume no JSON
-    if(fRunLumis.size()==0) {
+    if(!fGoodRunList.IsInitialized()) {
         if (fVerbose>1) 
             cout << "CheckRunLumi: fRunLumis is empty. Assuming no JSON." << endl; 
         return true;
     }
-    for(size_t r=0; r<fRunLumis.size(); ++r)
-        if(fTR->Run == fRunLumis[r].run)
-            runInJson = true;
+    bool runInJson = fGoodRunList.CheckRun(fTR->Run);
 
     if ( !runInJson && fVerbose>2 ) 
         cout << "Run " << fTR->Run << " not in JSON file" << endl;
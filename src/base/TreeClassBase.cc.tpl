@@ -5,12 +5,16 @@
 #include <TH2.h>
 #include <TStyle.h>
 #include <TCanvas.h>
+#include <fstream>
+#include <iomanip>
 
 //____________________________________________________________________
 TreeClassBase::TreeClassBase(const std::vector<std::string>& fileList)
 {
     fEvent = new fwlite::ChainEvent(fileList);
     fCurRun = -1;
+    fLazy = true;
+    fNEventsLoaded = 0;
     Init();
 }
 
@@ -23,16 +27,14 @@ TreeClassBase::~TreeClassBase()
 
 //____________________________________________________________________
 // Retrieve all branches ("getByLabel")
+// Event branches are only reset and fetched on first access, unless
+// lazy loading is switched off
 // Returns false if any branch fails to load
 const bool TreeClassBase::GetAllByLabel(void) {
 
     const edm::EventBase* event = fEvent;
     bool result(true);
-
-    // Initialize key variables
-    Run         = 0;
-    Event       = 0;
-    LumiSection = 0;
+    ++fNEventsLoaded;
 
     // Load run information if run has changed
     if ( fCurRun != event->id().run() ) {
@@ -45,8 +47,12 @@ const bool TreeClassBase::GetAllByLabel(void) {
 
     }
 
-    // Get all event handles and assign to members
-    <GETEVENTHANDLES>
+    // Reset all event branches
+    for ( std::vector<LazyBranchBase*>::const_iterator it = fBranches.begin();
+          it != fBranches.end(); ++it ) {
+      (*it)->Reset();
+      if ( !fLazy ) result &= (*it)->Load();
+    }
 
     return result;
     
@@ -61,3 +67,51 @@ void TreeClassBase::Init(void)
     <DEFINELABELS>
 
 }
+
+//____________________________________________________________________
+void TreeClassBase::RegisterBranch(LazyBranchBase& branch, const edm::InputTag& tag, const char* name)
+{
+    branch.Setup(fEvent, tag, name);
+    fBranches.push_back(&branch);
+}
+
+//____________________________________________________________________
+// Print branches read in this job, with the fraction of events they were read in
+void TreeClassBase::PrintBranchReport(std::ostream& os) const
+{
+    size_t nused = 0;
+    for ( std::vector<LazyBranchBase*>::const_iterator it = fBranches.begin();
+          it != fBranches.end(); ++it ) {
+      if ( !(*it)->NLoads() ) continue;
+      ++nused;
+      os << std::setw(30) << std::left << (*it)->Name() << std::right << " "
+         << std::setw(10) << (*it)->NLoads() << " "
+         << std::setw(3) << static_cast<int>(fNEventsLoaded>0?(*it)->NLoads()*100./fNEventsLoaded:0.) << "%" << std::endl;
+    }
+    os << "Read " << nused << " of " << fBranches.size() << " event branches in "
+       << fNEventsLoaded << " events" << std::endl;
+}
+
+//____________________________________________________________________
+// Write the list of branches read in this job, one per line.
+// This is the same format as getBranches.pl and can be given
+// to makeTreeClassBase.py to restrict the next build
+void TreeClassBase::WriteBranchReport(const char* filename) const
+{
+    std::ofstream file(filename);
+    if ( !file ) { std::cout << "WriteBranchReport: cannot write to " << filename << std::endl; return; }
+    for ( std::vector<LazyBranchBase*>::const_iterator it = fBranches.begin();
+          it != fBranches.end(); ++it )
+      if ( (*it)->NLoads() ) file << (*it)->Name() << std::endl;
+    file.close();
+}
+
+//____________________________________________________________________
+// Add the branches read by another reader, e.g. a parallel worker
+void TreeClassBase::AddBranchReport(const TreeClassBase& other)
+{
+    if ( other.fBranches.size() != fBranches.size() ) return;
+    for ( size_t i = 0; i < fBranches.size(); ++i )
+      fBranches[i]->AddLoads(other.fBranches[i]->NLoads());
+    fNEventsLoaded += other.fNEventsLoaded;
+}
@@ -6,6 +6,8 @@
 const TreeReader& TreeReader::ToBegin() {
 
     fwlite::ChainEvent result = fEvent->toBegin();
+    if ( fFirstEntry>0 ) fEvent->to(fFirstEntry);
+    fCurEntry = fFirstEntry;
     LoadAll();
     while ( !(AtEnd() || CheckLoading()) ) { // Go to the first healthy event
       ++(*this);
@@ -20,9 +22,11 @@ const TreeReader& TreeReader::ToBegin() {
 const TreeReader& TreeReader::operator++() {
 
     fwlite::ChainEvent result = ++(*fEvent);
+    ++fCurEntry;
     LoadAll();
     while ( !(AtEnd() || CheckLoading()) ) {
       result = ++(*fEvent);
+      ++fCurEntry;
       LoadAll();
     }
     
@@ -37,6 +41,7 @@ const Int_t TreeReader::GetEntry(const Long64_t entry)
     if (!fEvent) return 0;
     
     Int_t result = fEvent->to(entry);
+    fCurEntry = entry;
     LoadAll(); // Retrieve all the branches
     
     return result;
@@ -1,4 +1,5 @@
 #include <cstdlib>
+#include <algorithm>
 
 #include <TH1I.h>
 #include <TLorentzVector.h>
@@ -97,6 +98,9 @@ int UserAnalysisBase::GetPDGParticle(pdgparticle &part, int id){
 }
 
 void UserAnalysisBase::GetHLTNames(){
+  // Nothing to do if the menu did not change since the last run
+  if( !fHLTLabels.empty() && fHLTLabels.size() == fTR->HLTNames.size()
+      && std::equal(fHLTLabels.begin(), fHLTLabels.end(), fTR->HLTNames.begin()) ) return;
 	
   fHLTLabelMap.clear();
   fHLTLabels.clear();
@@ -106,6 +110,63 @@ void UserAnalysisBase::GetHLTNames(){
     fHLTLabels.push_back(fTR->HLTNames[i]);
     if (fVerbose>3) cout << " " << i << " " << fTR->HLTNames[i] << endl;
   }
+  ResolveTriggerMenus();
+}
+
+int UserAnalysisBase::AddTriggerMenu(const vector<string>& paths){
+  // Returns the index of the new menu, resolved right away if the HLT
+  // names are already known
+  fTriggerMenuPaths.push_back(paths);
+  fTriggerMenuBits.push_back(vector<int>());
+  if( !fHLTLabels.empty() ) ResolveTriggerMenus();
+  return fTriggerMenuPaths.size()-1;
+}
+
+void UserAnalysisBase::ResolveTriggerMenus(){
+  // Bits of each menu, in the order of its paths. A pattern adds all the
+  // matching paths (in menu order), every bit is taken only once.
+  for( size_t m=0; m < fTriggerMenuPaths.size(); ++m ){
+    const vector<string> &paths = fTriggerMenuPaths[m];
+    vector<int> &bits = fTriggerMenuBits[m];
+    bits.clear();
+    vector<bool> taken(fHLTLabels.size(), false);
+    for( size_t j=0; j < paths.size(); ++j ){
+      if( paths[j].find_first_of("*?") == string::npos ){
+        map<string,int>::iterator it = fHLTLabelMap.find(paths[j]);
+        if( it == fHLTLabelMap.end() || taken[it->second] ) continue;
+        taken[it->second] = true;
+        bits.push_back(it->second);
+        continue;
+      }
+      for( size_t i=0; i < fHLTLabels.size(); ++i ){
+        if( taken[i] || !MatchHLTName(paths[j].c_str(), fHLTLabels[i].c_str()) ) continue;
+        taken[i] = true;
+        bits.push_back(i);
+      }
+    }
+    if(fVerbose > 2) cout << "UserAnalysisBase::ResolveTriggerMenus ==> Menu " << m << ": "
+                          << bits.size() << " of " << paths.size() << " paths found" << endl;
+  }
+}
+
+bool UserAnalysisBase::GetTriggerMenuResult(int menu){
+  const vector<int> &bits = fTriggerMenuBits[menu];
+  for( size_t i=0; i < bits.size(); ++i ) if( fTR->HLTResults[bits[i]] ) return true;
+  return false;
+}
+
+bool UserAnalysisBase::MatchHLTName(const char* pattern, const char* name){
+  // Glob matching: '*' matches any sequence, '?' any single character
+  const char *star = 0, *back = 0;
+  while( *name ){
+    if( *pattern == '*' ){ star = pattern++; back = name; continue; }
+    if( *pattern == '?' || *pattern == *name ){ ++pattern; ++name; continue; }
+    if( !star ) return false;
+    pattern = star+1; // let the last '*' take one more character
+    name = ++back;
+  }
+  while( *pattern == '*' ) ++pattern;
+  return *pattern == 0;
 }
 
 int UserAnalysisBase::GetHLTBit(string theHltName){
@@ -852,16 +913,120 @@ bool UserAnalysisBase::IsGoodHadronicEvent(){
           HLT_Mu5_Ele5     || HLT_Mu3_Ele8_HT70U_v1);
 }
 
+///////////////////////////////////////////////////////////////
+// Batch object selections (see base/ObjectSelection.hh)
+void UserAnalysisBase::PFJetMask(ObjectMask& mask, PFJetID id, double ptcut, double absetacut){
+  // Batch version of IsGoodBasicPFJet, IsGoodPFJetMedium and IsGoodPFJetTight
+  const int n = fTR->NJets;
+  if(n == 0){
+    mask.clear();
+    return;
+  }
+  switch(id){
+  case kPFJetTight:
+    ObjSel::PFJetKernel<ObjSel::PFJetTight>(mask, n, ptcut, absetacut, fTR->JPt(), fTR->JEta(), fTR->JNConstituents(),
+                                            fTR->JNeutralEmFrac(), fTR->JNeutralHadFrac(), fTR->JChargedEmFrac(),
+                                            fTR->JChargedHadFrac(), fTR->JNAssoTracks());
+    break;
+  case kPFJetMedium:
+    ObjSel::PFJetKernel<ObjSel::PFJetMedium>(mask, n, ptcut, absetacut, fTR->JPt(), fTR->JEta(), fTR->JNConstituents(),
+                                             fTR->JNeutralEmFrac(), fTR->JNeutralHadFrac(), fTR->JChargedEmFrac(),
+                                             fTR->JChargedHadFrac(), fTR->JNAssoTracks());
+    break;
+  default:
+    ObjSel::PFJetKernel<ObjSel::PFJetLoose>(mask, n, ptcut, absetacut, fTR->JPt(), fTR->JEta(), fTR->JNConstituents(),
+                                            fTR->JNeutralEmFrac(), fTR->JNeutralHadFrac(), fTR->JChargedEmFrac(),
+                                            fTR->JChargedHadFrac(), fTR->JNAssoTracks());
+  }
+}
+
+void UserAnalysisBase::MuonMask(ObjectMask& mask, MuonID id){
+  // Batch version of IsMostBasicMu, IsGoodBasicMu, IsLooseMu and IsTightMu
+  const int n = fTR->NMus;
+  if(n == 0){
+    mask.clear();
+    return;
+  }
+  vector<float> iso;
+  ObjSel::MuPFIsoKernel(iso, n, fTR->MuPfIsoR03ChHad(), fTR->MuPfIsoR03NeHad(), fTR->MuPfIsoR03Photon(),
+                        fTR->MuPfIsoR03SumPUPt(), fTR->MuPt());
+  switch(id){
+  case kMostBasicMu:
+    ObjSel::MostBasicMuKernel(mask, n, iso, fTR->MuPt(), fTR->MuEta(), fTR->MuIsGlobalMuon(),
+                              fTR->MuIsTrackerMuon(), fTR->MuIsPFMuon());
+    break;
+  case kTightMu:
+    ObjSel::MuonKernel<ObjSel::TightMu>(mask, n, iso, fTR->MuPt(), fTR->MuEta(), fTR->MuIsGlobalMuon(), fTR->MuIsPFMuon(),
+                                        fTR->MuNChi2(), fTR->MuNSiLayers(), fTR->MuNPxHits(), fTR->MuNGlMuHits(),
+                                        fTR->MuNMatchedStations(), fTR->MuD0PV(), fTR->MuDzPV());
+    break;
+  default: // kGoodBasicMu, kLooseMu
+    ObjSel::MuonKernel<ObjSel::GoodBasicMu>(mask, n, iso, fTR->MuPt(), fTR->MuEta(), fTR->MuIsGlobalMuon(), fTR->MuIsPFMuon(),
+                                            fTR->MuNChi2(), fTR->MuNSiLayers(), fTR->MuNPxHits(), fTR->MuNGlMuHits(),
+                                            fTR->MuNMatchedStations(), fTR->MuD0PV(), fTR->MuDzPV());
+  }
+}
+
+void UserAnalysisBase::ElectronMask(ObjectMask& mask, ElectronID id){
+  // Batch version of IsGoodBasicEl, IsGoodTriggerEl, IsGoodElId_LooseWP,
+  // IsGoodElId_MediumWP and IsLooseEl. Only the branches the ID cuts on are read
+  const int n = fTR->NEles;
+  if(n == 0){
+    mask.clear();
+    return;
+  }
+  switch(id){
+  case kGoodTriggerEl:
+    ObjSel::ElectronKernel<ObjSel::GoodTriggerEl>(mask, n, fTR->ElEta(), fTR->ElSigmaIetaIeta(), fTR->ElDeltaPhiSuperClusterAtVtx(),
+                                                  fTR->ElDeltaEtaSuperClusterAtVtx(), fTR->ElHcalOverEcal());
+    break;
+  case kElId_LooseWP:
+    ObjSel::ElectronKernel<ObjSel::ElId_LooseWP>(mask, n, fTR->ElEta(), fTR->ElSigmaIetaIeta(), fTR->ElDeltaPhiSuperClusterAtVtx(),
+                                                 fTR->ElDeltaEtaSuperClusterAtVtx(), fTR->ElHcalOverEcal());
+    ObjSel::ElectronIPKernel<ObjSel::ElId_LooseWP>(mask, n, fTR->ElD0PV(), fTR->ElDzPV());
+    ObjSel::ElectronTrackKernel<ObjSel::ElId_LooseWP>(mask, n, fTR->ElCaloEnergy(), fTR->ElESuperClusterOverP(),
+                                                      fTR->ElNumberOfMissingInnerHits(), fTR->ElPassConversionVeto());
+    break;
+  case kElId_MediumWP:
+    ObjSel::ElectronKernel<ObjSel::ElId_MediumWP>(mask, n, fTR->ElEta(), fTR->ElSigmaIetaIeta(), fTR->ElDeltaPhiSuperClusterAtVtx(),
+                                                  fTR->ElDeltaEtaSuperClusterAtVtx(), fTR->ElHcalOverEcal());
+    ObjSel::ElectronIPKernel<ObjSel::ElId_MediumWP>(mask, n, fTR->ElD0PV(), fTR->ElDzPV());
+    ObjSel::ElectronTrackKernel<ObjSel::ElId_MediumWP>(mask, n, fTR->ElCaloEnergy(), fTR->ElESuperClusterOverP(),
+                                                       fTR->ElNumberOfMissingInnerHits(), fTR->ElPassConversionVeto());
+    break;
+  default: // kGoodBasicEl, kLooseEl
+    ObjSel::ElectronKernel<ObjSel::GoodBasicEl>(mask, n, fTR->ElEta(), fTR->ElSigmaIetaIeta(), fTR->ElDeltaPhiSuperClusterAtVtx(),
+                                                fTR->ElDeltaEtaSuperClusterAtVtx(), fTR->ElHcalOverEcal());
+    ObjSel::ElectronIPKernel<ObjSel::GoodBasicEl>(mask, n, fTR->ElD0PV(), fTR->ElDzPV());
+  }
+  if(id != kLooseEl) return;
+  // IsLooseEl: kinematics and rho-corrected isolation on the survivors
+  for(int ind = 0; ind < n; ++ind){
+    if(!mask[ind]) continue;
+    if(fTR->ElPt[ind] < 5. || fabs(fTR->ElEta[ind]) > 2.4 || ElPFIso(ind) > 1.0) mask[ind] = 0;
+  }
+}
+
 vector<int> UserAnalysisBase::ElectronSelection(bool(UserAnalysisBase::*eleSelector)(int)){
   // Returns the vector of indices of
   // good electrons sorted by Pt
   if(eleSelector == NULL) eleSelector = &UserAnalysisBase::IsGoodBasicEl;
   vector<int>    selectedObjInd;
   vector<double> selectedObjPt;
+  // use the batch selection for the standard selectors
+  ObjectMask mask;
+  bool batch = true;
+  if     (eleSelector == &UserAnalysisBase::IsGoodBasicEl      ) ElectronMask(mask, kGoodBasicEl);
+  else if(eleSelector == &UserAnalysisBase::IsGoodTriggerEl    ) ElectronMask(mask, kGoodTriggerEl);
+  else if(eleSelector == &UserAnalysisBase::IsGoodElId_LooseWP ) ElectronMask(mask, kElId_LooseWP);
+  else if(eleSelector == &UserAnalysisBase::IsGoodElId_MediumWP) ElectronMask(mask, kElId_MediumWP);
+  else if(eleSelector == &UserAnalysisBase::IsLooseEl          ) ElectronMask(mask, kLooseEl);
+  else batch = false;
   // form the vector of indices
   for(int ind = 0; ind < fTR->NEles; ++ind){
     // selection
-    if((*this.*eleSelector)(ind) == false) continue;
+    if(batch){ if(!mask[ind]) continue; }
+    else if((*this.*eleSelector)(ind) == false) continue;
 
     if (fTR->ElPt[ind] != fTR->ElPt[ind]) { 
       std::cout<<"ERROR!!!! this should never happen!!! there is an electron which's pT is NaN!!!!!"<<std::endl;
@@ -923,10 +1088,18 @@ vector<int> UserAnalysisBase::PFJetSelection(double ptcut, double absetacut, boo
   if(pfjetSelector == NULL) pfjetSelector = &UserAnalysisBase::IsGoodBasicPFJet;
   vector<int>    selectedObjInd;
   vector<double> selectedObjPt;
+  // use the batch selection for the standard selectors
+  ObjectMask mask;
+  bool batch = true;
+  if     (pfjetSelector == &UserAnalysisBase::IsGoodBasicPFJet ) PFJetMask(mask, kPFJetLoose,  ptcut, absetacut);
+  else if(pfjetSelector == &UserAnalysisBase::IsGoodPFJetMedium) PFJetMask(mask, kPFJetMedium, ptcut, absetacut);
+  else if(pfjetSelector == &UserAnalysisBase::IsGoodPFJetTight ) PFJetMask(mask, kPFJetTight,  ptcut, absetacut);
+  else batch = false;
   // form the vector of indices
   for(int ind = 0; ind < fTR->NJets; ++ind){
     // selection
-    if((*this.*pfjetSelector)(ind, ptcut, absetacut) == false) continue;
+    if(batch){ if(!mask[ind]) continue; }
+    else if((*this.*pfjetSelector)(ind, ptcut, absetacut) == false) continue;
 
     selectedObjInd.push_back(ind);
     selectedObjPt.push_back(fTR->JPt[ind]);
@@ -959,10 +1132,19 @@ vector<int> UserAnalysisBase::MuonSelection(bool(UserAnalysisBase::*muonSelector
   if(muonSelector == NULL) muonSelector = &UserAnalysisBase::IsGoodBasicMu;
   vector<int>	selectedObjInd;
   vector<double>	selectedObjPt;
+  // use the batch selection for the standard selectors
+  ObjectMask mask;
+  bool batch = true;
+  if     (muonSelector == &UserAnalysisBase::IsMostBasicMu) MuonMask(mask, kMostBasicMu);
+  else if(muonSelector == &UserAnalysisBase::IsGoodBasicMu) MuonMask(mask, kGoodBasicMu);
+  else if(muonSelector == &UserAnalysisBase::IsLooseMu    ) MuonMask(mask, kLooseMu);
+  else if(muonSelector == &UserAnalysisBase::IsTightMu    ) MuonMask(mask, kTightMu);
+  else batch = false;
   // form the vector of indices
   for(int ind = 0; ind < fTR->NMus; ++ind){
     // selection
-    if((*this.*muonSelector)(ind) == false) continue;
+    if(batch){ if(!mask[ind]) continue; }
+    else if((*this.*muonSelector)(ind) == false) continue;
     selectedObjInd.push_back(ind);
     selectedObjPt.push_back(fTR->MuPt[ind]);
   }	
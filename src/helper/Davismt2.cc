@@ -43,6 +43,7 @@ Davismt2::Davismt2(){
 	mt2_b  = 0.;
 	scale = 1.;
 	verbose = 1;
+	rel_precision = RELATIVE_PRECISION;
 }
 
 Davismt2::~Davismt2(){}
@@ -121,8 +122,8 @@ void Davismt2::set_momenta(double* pa0, double* pb0, double* pmiss0){
 	mn   = mn_unscale/scale; 
 	mnsq = mn*mn;
 
-	if (ABSOLUTE_PRECISION > 100.*RELATIVE_PRECISION) precision = ABSOLUTE_PRECISION;
-	else precision = 100.*RELATIVE_PRECISION;
+	if (ABSOLUTE_PRECISION > 100.*rel_precision) precision = ABSOLUTE_PRECISION;
+	else precision = 100.*rel_precision;
 }
 
 void Davismt2::set_mn(double mn0){
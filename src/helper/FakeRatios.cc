@@ -20,7 +20,7 @@
 
 using namespace std;
 
-FakeRatios::FakeRatios() : fVerbose(0), fNToyMCs(100), fAddESyst(0.0), fIsMC(false), fNGen(0) {
+FakeRatios::FakeRatios() : fVerbose(0), fNToyMCs(100), fAddESyst(0.0), fIsMC(false), fNGen(0), fESystMode(Toys), fToySeed(4357) {
 	// Initialize arrays to avoid segfaults
 	fMMNtl[0] = -1.; fMMNtl[1] = -1.; fMMNtl[2] = -1.; 
 	fEENtl[0] = -1.; fEENtl[1] = -1.; fEENtl[2] = -1.; 
@@ -30,9 +30,13 @@ FakeRatios::FakeRatios() : fVerbose(0), fNToyMCs(100), fAddESyst(0.0), fIsMC(fal
 	fMPRatio[0] = 1.; fMPRatio[1] = 0.; 
 	fEFRatio[0] = 0.; fEFRatio[1] = 0.; 
 	fEPRatio[0] = 1.; fEPRatio[1] = 0.; 
+
+	fRand = new TRandom3(fToySeed);
 }
 
-FakeRatios::~FakeRatios(){}
+FakeRatios::~FakeRatios(){
+	delete fRand;
+}
 
 //____________________________________________________________________________________
 // Input
@@ -79,7 +83,7 @@ float FakeRatios::getMMNppEStat(){
 	return getNppEStat(      fMMNtl[0], 0.5*fMMNtl[1], 0.5*fMMNtl[1], fMMNtl[2], fMFRatio[0], fMFRatio[0], fMPRatio[0], fMPRatio[0]);
 }
 float FakeRatios::getMMNppESyst(){
-	float fromtoys = getESystFromToys2(fMMNtl[0], 0.5*fMMNtl[1], 0.5*fMMNtl[1], fMMNtl[2], fMFRatio[0], fMFRatio[0], fMPRatio[0], fMPRatio[0], fMFRatio[1], fMFRatio[1], fMPRatio[1], fMPRatio[1], &FakeRatios::getNpp);
+	float fromtoys = getESyst2(fMMNtl[0], 0.5*fMMNtl[1], 0.5*fMMNtl[1], fMMNtl[2], fMFRatio[0], fMFRatio[0], fMPRatio[0], fMPRatio[0], fMFRatio[1], fMFRatio[1], fMPRatio[1], fMPRatio[1], &FakeRatios::getNpp);
 	float addsyst = fAddESyst * getMMNpp();
 	return sqrt(fromtoys + addsyst*addsyst);
 }
@@ -94,7 +98,7 @@ float FakeRatios::getMMNpfEStat(){
 	return sqrt(2.)*getNpfEStat(      fMMNtl[0], 0.5*fMMNtl[1], 0.5*fMMNtl[1], fMMNtl[2], fMFRatio[0], fMFRatio[0], fMPRatio[0], fMPRatio[0]);
 }
 float FakeRatios::getMMNpfESyst(){
-	float fromtoys = 4.*getESystFromToys2(fMMNtl[0], 0.5*fMMNtl[1], 0.5*fMMNtl[1], fMMNtl[2], fMFRatio[0], fMFRatio[0], fMPRatio[0], fMPRatio[0], fMFRatio[1], fMFRatio[1], fMPRatio[1], fMPRatio[1], &FakeRatios::getNpf);
+	float fromtoys = 4.*getESyst2(fMMNtl[0], 0.5*fMMNtl[1], 0.5*fMMNtl[1], fMMNtl[2], fMFRatio[0], fMFRatio[0], fMPRatio[0], fMPRatio[0], fMFRatio[1], fMFRatio[1], fMPRatio[1], fMPRatio[1], &FakeRatios::getNpf);
 	float addsyst = fAddESyst * getMMNpf();
 	return sqrt(fromtoys + addsyst*addsyst);	
 }
@@ -109,7 +113,7 @@ float FakeRatios::getMMNffEStat(){
 	return getNffEStat(      fMMNtl[0], 0.5*fMMNtl[1], 0.5*fMMNtl[1], fMMNtl[2], fMFRatio[0], fMFRatio[0], fMPRatio[0], fMPRatio[0]);
 }
 float FakeRatios::getMMNffESyst(){
-	float fromtoys = getESystFromToys2(fMMNtl[0], 0.5*fMMNtl[1], 0.5*fMMNtl[1], fMMNtl[2], fMFRatio[0], fMFRatio[0], fMPRatio[0], fMPRatio[0], fMFRatio[1], fMFRatio[1], fMPRatio[1], fMPRatio[1], &FakeRatios::getNff);
+	float fromtoys = getESyst2(fMMNtl[0], 0.5*fMMNtl[1], 0.5*fMMNtl[1], fMMNtl[2], fMFRatio[0], fMFRatio[0], fMPRatio[0], fMPRatio[0], fMFRatio[1], fMFRatio[1], fMPRatio[1], fMPRatio[1], &FakeRatios::getNff);
 	float addsyst = fAddESyst * getMMNff();
 	return sqrt(fromtoys + addsyst*addsyst);	
 }
@@ -125,7 +129,7 @@ float FakeRatios::getEENppEStat(){
 	return getNppEStat(      fEENtl[0], 0.5*fEENtl[1], 0.5*fEENtl[1], fEENtl[2], fEFRatio[0], fEFRatio[0], fEPRatio[0], fEPRatio[0]);
 }
 float FakeRatios::getEENppESyst(){
-	float fromtoys = getESystFromToys2(fEENtl[0], 0.5*fEENtl[1], 0.5*fEENtl[1], fEENtl[2], fEFRatio[0], fEFRatio[0], fEPRatio[0], fEPRatio[0], fEFRatio[1], fEFRatio[1], fEPRatio[1], fEPRatio[1], &FakeRatios::getNpp);
+	float fromtoys = getESyst2(fEENtl[0], 0.5*fEENtl[1], 0.5*fEENtl[1], fEENtl[2], fEFRatio[0], fEFRatio[0], fEPRatio[0], fEPRatio[0], fEFRatio[1], fEFRatio[1], fEPRatio[1], fEPRatio[1], &FakeRatios::getNpp);
 	float addsyst = fAddESyst * getEENpp();
 	return sqrt(fromtoys + addsyst*addsyst);	
 }
@@ -140,7 +144,7 @@ float FakeRatios::getEENpfEStat(){
 	return sqrt(2.)*getNfpEStat(      fEENtl[0], 0.5*fEENtl[1], 0.5*fEENtl[1], fEENtl[2], fEFRatio[0], fEFRatio[0], fEPRatio[0], fEPRatio[0]);
 }
 float FakeRatios::getEENpfESyst(){
-	float fromtoys =  4.*getESystFromToys2(fEENtl[0], 0.5*fEENtl[1], 0.5*fEENtl[1], fEENtl[2], fEFRatio[0], fEFRatio[0], fEPRatio[0], fEPRatio[0], fEFRatio[1], fEFRatio[1], fEPRatio[1], fEPRatio[1], &FakeRatios::getNfp);
+	float fromtoys =  4.*getESyst2(fEENtl[0], 0.5*fEENtl[1], 0.5*fEENtl[1], fEENtl[2], fEFRatio[0], fEFRatio[0], fEPRatio[0], fEPRatio[0], fEFRatio[1], fEFRatio[1], fEPRatio[1], fEPRatio[1], &FakeRatios::getNfp);
 	float addsyst = fAddESyst * getEENpf();
 	return sqrt(fromtoys + addsyst*addsyst);	
 }
@@ -155,7 +159,7 @@ float FakeRatios::getEENffEStat(){
 	return getNffEStat(      fEENtl[0], 0.5*fEENtl[1], 0.5*fEENtl[1], fEENtl[2], fEFRatio[0], fEFRatio[0], fEPRatio[0], fEPRatio[0]);
 }
 float FakeRatios::getEENffESyst(){
-	float fromtoys = getESystFromToys2(fEENtl[0], 0.5*fEENtl[1], 0.5*fEENtl[1], fEENtl[2], fEFRatio[0], fEFRatio[0], fEPRatio[0], fEPRatio[0], fEFRatio[1], fEFRatio[1], fEPRatio[1], fEPRatio[1], &FakeRatios::getNff);
+	float fromtoys = getESyst2(fEENtl[0], 0.5*fEENtl[1], 0.5*fEENtl[1], fEENtl[2], fEFRatio[0], fEFRatio[0], fEPRatio[0], fEPRatio[0], fEFRatio[1], fEFRatio[1], fEPRatio[1], fEPRatio[1], &FakeRatios::getNff);
 	float addsyst = fAddESyst * getEENff();
 	return sqrt(fromtoys + addsyst*addsyst);	
 }
@@ -171,7 +175,7 @@ float FakeRatios::getEMNppEStat(){
 	return getNppEStat(      fEMNtl[0], fEMNtl[1], fEMNtl[2], fEMNtl[3], fMFRatio[0], fEFRatio[0], fMPRatio[0], fEPRatio[0]);
 }
 float FakeRatios::getEMNppESyst(){
-	float fromtoys = getESystFromToys2(fEMNtl[0], fEMNtl[1], fEMNtl[2], fEMNtl[3], fMFRatio[0], fEFRatio[0], fMPRatio[0], fEPRatio[0], fMFRatio[1], fEFRatio[1], fMPRatio[1], fEPRatio[1], &FakeRatios::getNpp);	
+	float fromtoys = getESyst2(fEMNtl[0], fEMNtl[1], fEMNtl[2], fEMNtl[3], fMFRatio[0], fEFRatio[0], fMPRatio[0], fEPRatio[0], fMFRatio[1], fEFRatio[1], fMPRatio[1], fEPRatio[1], &FakeRatios::getNpp);	
 	float addsyst = fAddESyst * getEMNpp();
 	return sqrt(fromtoys + addsyst*addsyst);	
 }
@@ -186,7 +190,7 @@ float FakeRatios::getEMNpfEStat(){
 	return getNpfEStat(      fEMNtl[0], fEMNtl[1], fEMNtl[2], fEMNtl[3], fMFRatio[0], fEFRatio[0], fMPRatio[0], fEPRatio[0]);
 }
 float FakeRatios::getEMNpfESyst(){
-	float fromtoys = getESystFromToys2(fEMNtl[0], fEMNtl[1], fEMNtl[2], fEMNtl[3], fMFRatio[0], fEFRatio[0], fMPRatio[0], fEPRatio[0], fMFRatio[1], fEFRatio[1], fMPRatio[1], fEPRatio[1], &FakeRatios::getNpf);
+	float fromtoys = getESyst2(fEMNtl[0], fEMNtl[1], fEMNtl[2], fEMNtl[3], fMFRatio[0], fEFRatio[0], fMPRatio[0], fEPRatio[0], fMFRatio[1], fEFRatio[1], fMPRatio[1], fEPRatio[1], &FakeRatios::getNpf);
 	float addsyst = fAddESyst * getEMNpf();
 	return sqrt(fromtoys + addsyst*addsyst);	
 }
@@ -201,7 +205,7 @@ float FakeRatios::getEMNfpEStat(){
 	return getNfpEStat(      fEMNtl[0], fEMNtl[1], fEMNtl[2], fEMNtl[3], fMFRatio[0], fEFRatio[0], fMPRatio[0], fEPRatio[0]);
 }
 float FakeRatios::getEMNfpESyst(){
-	float fromtoys = getESystFromToys2(fEMNtl[0], fEMNtl[1], fEMNtl[2], fEMNtl[3], fMFRatio[0], fEFRatio[0], fMPRatio[0], fEPRatio[0], fMFRatio[1], fEFRatio[1], fMPRatio[1], fEPRatio[1], &FakeRatios::getNfp);
+	float fromtoys = getESyst2(fEMNtl[0], fEMNtl[1], fEMNtl[2], fEMNtl[3], fMFRatio[0], fEFRatio[0], fMPRatio[0], fEPRatio[0], fMFRatio[1], fEFRatio[1], fMPRatio[1], fEPRatio[1], &FakeRatios::getNfp);
 	float addsyst = fAddESyst * getEMNfp();
 	return sqrt(fromtoys + addsyst*addsyst);	
 }
@@ -216,7 +220,7 @@ float FakeRatios::getEMSingleEStat(){
 	return getNfpNpfSumEStat(fEMNtl[0], fEMNtl[1], fEMNtl[2], fEMNtl[3], fMFRatio[0], fEFRatio[0], fMPRatio[0], fEPRatio[0]);
 }
 float FakeRatios::getEMSingleESyst(){
-	float fromtoys = getESystFromToys2(fEMNtl[0], fEMNtl[1], fEMNtl[2], fEMNtl[3], fMFRatio[0], fEFRatio[0], fMPRatio[0], fEPRatio[0], fMFRatio[1], fEFRatio[1], fMPRatio[1], fEPRatio[1], &FakeRatios::getNfpNpfSum);
+	float fromtoys = getESyst2(fEMNtl[0], fEMNtl[1], fEMNtl[2], fEMNtl[3], fMFRatio[0], fEFRatio[0], fMPRatio[0], fEPRatio[0], fMFRatio[1], fEFRatio[1], fMPRatio[1], fEPRatio[1], &FakeRatios::getNfpNpfSum);
 	float addsyst = fAddESyst * (getEMNfp() + getEMNpf());
 	return sqrt(fromtoys + addsyst*addsyst);
 }
@@ -231,7 +235,7 @@ float FakeRatios::getEMNffEStat(){
 	return getNffEStat(      fEMNtl[0], fEMNtl[1], fEMNtl[2], fEMNtl[3], fMFRatio[0], fEFRatio[0], fMPRatio[0], fEPRatio[0]);
 }
 float FakeRatios::getEMNffESyst(){
-	float fromtoys = getESystFromToys2(fEMNtl[0], fEMNtl[1], fEMNtl[2], fEMNtl[3], fMFRatio[0], fEFRatio[0], fMPRatio[0], fEPRatio[0], fMFRatio[1], fEFRatio[1], fMPRatio[1], fEPRatio[1], &FakeRatios::getNff);
+	float fromtoys = getESyst2(fEMNtl[0], fEMNtl[1], fEMNtl[2], fEMNtl[3], fMFRatio[0], fEFRatio[0], fMPRatio[0], fEPRatio[0], fMFRatio[1], fEFRatio[1], fMPRatio[1], fEPRatio[1], &FakeRatios::getNff);
 	float addsyst = fAddESyst * getEMNff();
 	return sqrt(fromtoys + addsyst*addsyst);	
 }
@@ -248,7 +252,7 @@ float FakeRatios::getMMTotEStat(){
 	return getNfpNpfNffSumEStat(fMMNtl[0], 0.5*fMMNtl[1], 0.5*fMMNtl[1], fMMNtl[2], fMFRatio[0], fMFRatio[0], fMPRatio[0], fMPRatio[0]);
 }
 float FakeRatios::getMMTotESyst(){
-	float fromtoys = sqrt(getESystFromToys2(fMMNtl[0], 0.5*fMMNtl[1], 0.5*fMMNtl[1], fMMNtl[2], fMFRatio[0], fMFRatio[0], fMPRatio[0], fMPRatio[0], fMFRatio[1], fMFRatio[1], fMPRatio[1], fMPRatio[1], &FakeRatios::getNfpNpfNffSum));
+	float fromtoys = sqrt(getESyst2(fMMNtl[0], 0.5*fMMNtl[1], 0.5*fMMNtl[1], fMMNtl[2], fMFRatio[0], fMFRatio[0], fMPRatio[0], fMPRatio[0], fMFRatio[1], fMFRatio[1], fMPRatio[1], fMPRatio[1], &FakeRatios::getNfpNpfNffSum));
 	float addsyst = fAddESyst * getMMTotFakes();
 	return sqrt(fromtoys + addsyst*addsyst);
 }
@@ -259,7 +263,7 @@ float FakeRatios::getEETotEStat(){
 	return getNfpNpfNffSumEStat(fEENtl[0], 0.5*fEENtl[1], 0.5*fEENtl[1], fEENtl[2], fEFRatio[0], fEFRatio[0], fEPRatio[0], fEPRatio[0]);
 }
 float FakeRatios::getEETotESyst(){
-	float fromtoys = sqrt(getESystFromToys2(fEENtl[0], 0.5*fEENtl[1], 0.5*fEENtl[1], fEENtl[2], fEFRatio[0], fEFRatio[0], fEPRatio[0], fEPRatio[0], fEFRatio[1], fEFRatio[1], fEPRatio[1], fEPRatio[1], &FakeRatios::getNfpNpfNffSum));
+	float fromtoys = sqrt(getESyst2(fEENtl[0], 0.5*fEENtl[1], 0.5*fEENtl[1], fEENtl[2], fEFRatio[0], fEFRatio[0], fEPRatio[0], fEPRatio[0], fEFRatio[1], fEFRatio[1], fEPRatio[1], fEPRatio[1], &FakeRatios::getNfpNpfNffSum));
 	float addsyst = fAddESyst * getEETotFakes();
 	return sqrt(fromtoys + addsyst*addsyst);
 }
@@ -270,7 +274,7 @@ float FakeRatios::getEMTotEStat(){
 	return getNfpNpfNffSumEStat(fEMNtl[0], fEMNtl[1], fEMNtl[2], fEMNtl[3], fMFRatio[0], fEFRatio[0], fMPRatio[0], fEPRatio[0]);
 }
 float FakeRatios::getEMTotESyst(){
-	float fromtoys = sqrt(getESystFromToys2(fEMNtl[0], fEMNtl[1], fEMNtl[2], fEMNtl[3], fMFRatio[0], fEFRatio[0], fMPRatio[0], fEPRatio[0], fMFRatio[1], fEFRatio[1], fMPRatio[1], fEPRatio[1], &FakeRatios::getNfpNpfNffSum));
+	float fromtoys = sqrt(getESyst2(fEMNtl[0], fEMNtl[1], fEMNtl[2], fEMNtl[3], fMFRatio[0], fEFRatio[0], fMPRatio[0], fEPRatio[0], fMFRatio[1], fEFRatio[1], fMPRatio[1], fEPRatio[1], &FakeRatios::getNfpNpfNffSum));
 	float addsyst = fAddESyst * getEMTotFakes();
 	return sqrt(fromtoys + addsyst*addsyst);
 }
@@ -309,152 +313,17 @@ float FakeRatios::getTotDoubleEStat(){
 	return sqrt( mm*mm + ee*ee + em*em );
 }
 float FakeRatios::getTotESyst(){
-	// Assume errors of p and f are uncorrelated
-	// Throw toys in a gaussian around f and p with df and dp as their sigmas
-	// Distributions for f and p are cut off at 0 and 1
-	float f1  = fMFRatio[0];
-	float df1 = fMFRatio[1];
-	float f2  = fEFRatio[0];
-	float df2 = fEFRatio[1];
-	float p1  = fMPRatio[0];
-	float dp1 = fMPRatio[1];
-	float p2  = fEPRatio[0];
-	float dp2 = fEPRatio[1];	
-
-	if(fVerbose > 2) cout << "FakeRatios::getTotESyst ..." << endl;
-	TRandom3 *rand = new TRandom3();
-	rand->SetSeed();
-	vector<float> f_results;
-	for(size_t i = 0; i < fNToyMCs; ++i){ // vary f1
-		float f1_v = rand->Gaus(f1, df1);
-		if(f1_v > 1. || f1_v < 0.){--i; continue;} // throw again if f<0 or f>1
-		for(size_t j = 0; j < fNToyMCs; ++j){ // vary f2
-			float f2_v = rand->Gaus(f2, df2);
-			if(f2_v > 1. || f2_v < 0.){--j; continue;} // throw again if f<0 or f>1
-			float result = getTotFakes(f1_v, f2_v, p1, p2);
-			f_results.push_back(result);
-			if(fVerbose > 2) cout << result << endl;
-		}
-	}
-	float rms_f = TMath::RMS(f_results.begin(), f_results.end());
-	if(fVerbose > 2) cout << " RMS = " << rms_f << endl;
-	if(fVerbose > 2) cout << endl;
-	vector<float> p_results;
-	for(size_t i = 0; i < fNToyMCs; ++i){ // vary p1
-		float p1_v = rand->Gaus(p1, dp1);
-		if(p1_v > 1. || p1_v < 0.){--i; continue;} // throw again if p<0 or p>1
-		for(size_t j = 0; j < fNToyMCs; ++j){ // vary p2
-			float p2_v = rand->Gaus(p2, dp2);
-			if(p2_v > 1. || p2_v < 0.){--j; continue;} // throw again if p<0 or p>1
-			float result = getTotFakes(f1, f2, p1_v, p2_v);
-			p_results.push_back(result);
-			if(fVerbose > 2) cout << result << endl;
-		}
-	}
-	float rms_p = TMath::RMS(p_results.begin(), p_results.end());
-	if(fVerbose > 2) cout << " RMS = " << rms_p << endl;
-	
-	float fromtoys = rms_f*rms_f + rms_p*rms_p;
+	float fromtoys = getTotESyst2(&FakeRatios::getTotFakes, PF|FP|FF);
 	float addsyst = fAddESyst * getTotFakes();
 	return sqrt(fromtoys + addsyst*addsyst);
 }
 float FakeRatios::getTotSingleESyst(){
-	// Assume errors of p and f are uncorrelated
-	// Throw toys in a gaussian around f and p with df and dp as their sigmas
-	// Distributions for f and p are cut off at 0 and 1
-	float f1  = fMFRatio[0];
-	float df1 = fMFRatio[1];
-	float f2  = fEFRatio[0];
-	float df2 = fEFRatio[1];
-	float p1  = fMPRatio[0];
-	float dp1 = fMPRatio[1];
-	float p2  = fEPRatio[0];
-	float dp2 = fEPRatio[1];	
-
-	if(fVerbose > 2) cout << "FakeRatios::getTotESyst ..." << endl;
-	TRandom3 *rand = new TRandom3();
-	rand->SetSeed();
-	vector<float> f_results;
-	for(size_t i = 0; i < fNToyMCs; ++i){ // vary f1
-		float f1_v = rand->Gaus(f1, df1);
-		if(f1_v > 1. || f1_v < 0.){--i; continue;} // throw again if f<0 or f>1
-		for(size_t j = 0; j < fNToyMCs; ++j){ // vary f2
-			float f2_v = rand->Gaus(f2, df2);
-			if(f2_v > 1. || f2_v < 0.){--j; continue;} // throw again if f<0 or f>1
-			float result = getTotSingleFakes(f1_v, f2_v, p1, p2);
-			f_results.push_back(result);
-			if(fVerbose > 2) cout << result << endl;
-		}
-	}
-	float rms_f = TMath::RMS(f_results.begin(), f_results.end());
-	if(fVerbose > 2) cout << " RMS = " << rms_f << endl;
-	if(fVerbose > 2) cout << endl;
-	vector<float> p_results;
-	for(size_t i = 0; i < fNToyMCs; ++i){ // vary p1
-		float p1_v = rand->Gaus(p1, dp1);
-		if(p1_v > 1. || p1_v < 0.){--i; continue;} // throw again if p<0 or p>1
-		for(size_t j = 0; j < fNToyMCs; ++j){ // vary p2
-			float p2_v = rand->Gaus(p2, dp2);
-			if(p2_v > 1. || p2_v < 0.){--j; continue;} // throw again if p<0 or p>1
-			float result = getTotSingleFakes(f1, f2, p1_v, p2_v);
-			p_results.push_back(result);
-			if(fVerbose > 2) cout << result << endl;
-		}
-	}
-	float rms_p = TMath::RMS(p_results.begin(), p_results.end());
-	if(fVerbose > 2) cout << " RMS = " << rms_p << endl;
-	
-	float fromtoys = rms_f*rms_f + rms_p*rms_p;
+	float fromtoys = getTotESyst2(&FakeRatios::getTotSingleFakes, PF|FP);
 	float addsyst = fAddESyst * getTotSingleFakes();
 	return sqrt(fromtoys + addsyst*addsyst);
 }
 float FakeRatios::getTotDoubleESyst(){
-	// Assume errors of p and f are uncorrelated
-	// Throw toys in a gaussian around f and p with df and dp as their sigmas
-	// Distributions for f and p are cut off at 0 and 1
-	float f1  = fMFRatio[0];
-	float df1 = fMFRatio[1];
-	float f2  = fEFRatio[0];
-	float df2 = fEFRatio[1];
-	float p1  = fMPRatio[0];
-	float dp1 = fMPRatio[1];
-	float p2  = fEPRatio[0];
-	float dp2 = fEPRatio[1];	
-
-	if(fVerbose > 2) cout << "FakeRatios::getTotESyst ..." << endl;
-	TRandom3 *rand = new TRandom3();
-	rand->SetSeed();
-	vector<float> f_results;
-	for(size_t i = 0; i < fNToyMCs; ++i){ // vary f1
-		float f1_v = rand->Gaus(f1, df1);
-		if(f1_v > 1. || f1_v < 0.){--i; continue;} // throw again if f<0 or f>1
-		for(size_t j = 0; j < fNToyMCs; ++j){ // vary f2
-			float f2_v = rand->Gaus(f2, df2);
-			if(f2_v > 1. || f2_v < 0.){--j; continue;} // throw again if f<0 or f>1
-			float result = getTotDoubleFakes(f1_v, f2_v, p1, p2);
-			f_results.push_back(result);
-			if(fVerbose > 2) cout << result << endl;
-		}
-	}
-	float rms_f = TMath::RMS(f_results.begin(), f_results.end());
-	if(fVerbose > 2) cout << " RMS = " << rms_f << endl;
-	if(fVerbose > 2) cout << endl;
-	vector<float> p_results;
-	for(size_t i = 0; i < fNToyMCs; ++i){ // vary p1
-		float p1_v = rand->Gaus(p1, dp1);
-		if(p1_v > 1. || p1_v < 0.){--i; continue;} // throw again if p<0 or p>1
-		for(size_t j = 0; j < fNToyMCs; ++j){ // vary p2
-			float p2_v = rand->Gaus(p2, dp2);
-			if(p2_v > 1. || p2_v < 0.){--j; continue;} // throw again if p<0 or p>1
-			float result = getTotDoubleFakes(f1, f2, p1_v, p2_v);
-			p_results.push_back(result);
-			if(fVerbose > 2) cout << result << endl;
-		}
-	}
-	float rms_p = TMath::RMS(p_results.begin(), p_results.end());
-	if(fVerbose > 2) cout << " RMS = " << rms_p << endl;
-	
-	float fromtoys = rms_f*rms_f + rms_p*rms_p;
+	float fromtoys = getTotESyst2(&FakeRatios::getTotDoubleFakes, FF);
 	float addsyst = fAddESyst * getTotDoubleFakes();
 	return sqrt(fromtoys + addsyst*addsyst);
 }
@@ -621,45 +490,169 @@ float FakeRatios::getNfpNpfSumEStat(float Ntt, float Ntl, float Nlt, float Nll,
 }
 
 //____________________________________________________________________________________
-// Throw toy MC to determine systematics from errors on ratios
+// Systematic errors from the errors on the ratios
+namespace {
+	// Running mean and variance (Welford), normalized as TMath::RMS
+	struct RunningRMS {
+		RunningRMS() : n(0), mean(0.), m2(0.) {}
+		void add(double x){
+			++n;
+			double delta = x - mean;
+			mean += delta/n;
+			m2   += delta*(x - mean);
+		}
+		double rms2() const { return n > 1 ? m2/(n-1) : 0.; }
+		long n;
+		double mean, m2;
+	};
+
+	// Tight and loose weights of one lepton with ratios f and p for
+	// being prompt (w[0]) or fake (w[1]), and their derivatives
+	void getLegWeights(double f, double p, double w[2][2], double dwdf[2][2], double dwdp[2][2]){
+		double den  = f - p;
+		double den2 = den*den;
+		w[0][0]    =  p*(f-1.)/den; w[0][1]    =  p*f/den;
+		w[1][0]    =  f*(1.-p)/den; w[1][1]    = -f*p/den;
+		dwdf[0][0] =  p*(1.-p)/den2; dwdf[0][1] = -p*p/den2;
+		dwdf[1][0] = -p*(1.-p)/den2; dwdf[1][1] =  p*p/den2;
+		dwdp[0][0] =  f*(f-1.)/den2; dwdp[0][1] =  f*f/den2;
+		dwdp[1][0] =  f*(1.-f)/den2; dwdp[1][1] = -f*f/den2;
+	}
+}
+
+float FakeRatios::getESyst2(float Ntt, float Ntl, float Nlt, float Nll, float f1, float f2, float p1, float p2, float df1, float df2, float dp1, float dp2, float(FakeRatios::*func)(float, float, float, float, float, float, float, float)){
+	int comps = getComponents(func);
+	if(fESystMode == Analytic && comps != 0) return getESystAnalytic2(Ntt, Ntl, Nlt, Nll, f1, f2, p1, p2, df1, df2, dp1, dp2, comps);
+	return getESystFromToys2(Ntt, Ntl, Nlt, Nll, f1, f2, p1, p2, df1, df2, dp1, dp2, func);
+}
+
+float FakeRatios::throwRatio(float r, float dr){
+	// Throw again if r<0 or r>1
+	float r_v;
+	do { r_v = fRand->Gaus(r, dr); } while(r_v > 1. || r_v < 0.);
+	return r_v;
+}
+
 float FakeRatios::getESystFromToys2(float Ntt, float Ntl, float Nlt, float Nll, float f1, float f2, float p1, float p2, float df1, float df2, float dp1, float dp2, float(FakeRatios::*func)(float, float, float, float, float, float, float, float)){
 	// Assume errors of p and f are uncorrelated
 	// Throw toys in a gaussian around f and p with df and dp as their sigmas
 	// Distributions for f and p are cut off at 0 and 1
+	// The RMS is accumulated on the fly, the seed is reset for every call
 	if(fVerbose > 2) cout << "FakeRatios::getESystFromToys2 ..." << endl;
-	TRandom3 *rand = new TRandom3();
-	rand->SetSeed();
-	vector<float> f_results;
-	for(size_t i = 0; i < fNToyMCs; ++i){ // vary f1
-		float f1_v = rand->Gaus(f1, df1);
-		if(f1_v > 1. || f1_v < 0.){--i; continue;} // throw again if f<0 or f>1
-		for(size_t j = 0; j < fNToyMCs; ++j){ // vary f2
-			float f2_v = rand->Gaus(f2, df2);
-			if(f2_v > 1. || f2_v < 0.){--j; continue;} // throw again if f<0 or f>1
+	fRand->SetSeed(fToySeed);
+	RunningRMS f_results;
+	for(int i = 0; i < fNToyMCs; ++i){ // vary f1
+		float f1_v = throwRatio(f1, df1);
+		for(int j = 0; j < fNToyMCs; ++j){ // vary f2
+			float f2_v = throwRatio(f2, df2);
 			float result = (*this.*func)(Ntt, Ntl, Nlt, Nll, f1_v, f2_v, p1, p2);
-			f_results.push_back(result);
+			f_results.add(result);
 			if(fVerbose > 2) cout << result << endl;
 		}
 	}
-	float rms_f = TMath::RMS(f_results.begin(), f_results.end());
-	if(fVerbose > 2) cout << " RMS = " << rms_f << endl;
+	if(fVerbose > 2) cout << " RMS = " << sqrt(f_results.rms2()) << endl;
 	if(fVerbose > 2) cout << endl;
-	vector<float> p_results;
-	for(size_t i = 0; i < fNToyMCs; ++i){ // vary p1
-		float p1_v = rand->Gaus(p1, dp1);
-		if(p1_v > 1. || p1_v < 0.){--i; continue;} // throw again if p<0 or p>1
-		for(size_t j = 0; j < fNToyMCs; ++j){ // vary p2
-			float p2_v = rand->Gaus(p2, dp2);
-			if(p2_v > 1. || p2_v < 0.){--j; continue;} // throw again if p<0 or p>1
+	RunningRMS p_results;
+	for(int i = 0; i < fNToyMCs; ++i){ // vary p1
+		float p1_v = throwRatio(p1, dp1);
+		for(int j = 0; j < fNToyMCs; ++j){ // vary p2
+			float p2_v = throwRatio(p2, dp2);
 			float result = (*this.*func)(Ntt, Ntl, Nlt, Nll, f1, f2, p1_v, p2_v);
-			p_results.push_back(result);
+			p_results.add(result);
 			if(fVerbose > 2) cout << result << endl;
 		}
 	}
-	float rms_p = TMath::RMS(p_results.begin(), p_results.end());
-	if(fVerbose > 2) cout << " RMS = " << rms_p << endl;
-	
-	return rms_f*rms_f + rms_p*rms_p;
+	if(fVerbose > 2) cout << " RMS = " << sqrt(p_results.rms2()) << endl;
+
+	return f_results.rms2() + p_results.rms2();
+}
+
+float FakeRatios::getESystAnalytic2(float Ntt, float Ntl, float Nlt, float Nll, float f1, float f2, float p1, float p2, float df1, float df2, float dp1, float dp2, int comps){
+	// Linear error propagation, errors of f1, f2, p1, p2 uncorrelated
+	double d[4] = {0., 0., 0., 0.}; // dN/df1, dN/df2, dN/dp1, dN/dp2
+	addDerivatives(Ntt, Ntl, Nlt, Nll, f1, f2, p1, p2, comps, d);
+	return d[0]*d[0]*df1*df1 + d[1]*d[1]*df2*df2 + d[2]*d[2]*dp1*dp1 + d[3]*d[3]*dp2*dp2;
+}
+
+int FakeRatios::getComponents(float(FakeRatios::*func)(float, float, float, float, float, float, float, float)){
+	// Which of Npp, Npf, Nfp, Nff make up the prediction, 0 if unknown
+	if(func == &FakeRatios::getNpp)          return PP;
+	if(func == &FakeRatios::getNpf)          return PF;
+	if(func == &FakeRatios::getNfp)          return FP;
+	if(func == &FakeRatios::getNff)          return FF;
+	if(func == &FakeRatios::getNfpNpfSum)    return PF|FP;
+	if(func == &FakeRatios::getNfpNpfNffSum) return PF|FP|FF;
+	return 0;
+}
+
+void FakeRatios::addDerivatives(float Ntt, float Ntl, float Nlt, float Nll, float f1, float f2, float p1, float p2, int comps, double *d){
+	// The predictions are bilinear in the weights of the two leptons,
+	// e.g. Npf = sum_ij N_ij w1_prompt(i) w2_fake(j), i,j = tight, loose,
+	// so the derivatives only need the derivatives of the weights
+	double N[2][2] = {{Ntt, Ntl}, {Nlt, Nll}};
+	double w1[2][2], dw1df[2][2], dw1dp[2][2];
+	double w2[2][2], dw2df[2][2], dw2dp[2][2];
+	getLegWeights(f1, p1, w1, dw1df, dw1dp);
+	getLegWeights(f2, p2, w2, dw2df, dw2dp);
+	for(int c = 0; c < 4; ++c){ // PP, PF, FP, FF
+		if(!(comps & (1<<c))) continue;
+		int a = c/2; // lepton 1 prompt/fake
+		int b = c%2; // lepton 2 prompt/fake
+		for(int i = 0; i < 2; ++i) for(int j = 0; j < 2; ++j){
+			d[0] += N[i][j] * dw1df[a][i] * w2[b][j];
+			d[1] += N[i][j] * w1[a][i]    * dw2df[b][j];
+			d[2] += N[i][j] * dw1dp[a][i] * w2[b][j];
+			d[3] += N[i][j] * w1[a][i]    * dw2dp[b][j];
+		}
+	}
+}
+
+float FakeRatios::getTotESyst2(float(FakeRatios::*func)(float, float, float, float), int comps){
+	// Squared systematic error on a sum over all channels, see getTotFakes
+	float f1  = fMFRatio[0];
+	float df1 = fMFRatio[1];
+	float f2  = fEFRatio[0];
+	float df2 = fEFRatio[1];
+	float p1  = fMPRatio[0];
+	float dp1 = fMPRatio[1];
+	float p2  = fEPRatio[0];
+	float dp2 = fEPRatio[1];
+
+	if(fESystMode == Analytic){
+		double d[4] = {0., 0., 0., 0.};
+		addDerivatives(fMMNtl[0], 0.5*fMMNtl[1], 0.5*fMMNtl[1], fMMNtl[2], f1, f2, p1, p2, comps, d);
+		addDerivatives(fEENtl[0], 0.5*fEENtl[1], 0.5*fEENtl[1], fEENtl[2], f1, f2, p1, p2, comps, d);
+		addDerivatives(fEMNtl[0],     fEMNtl[1],     fEMNtl[2], fEMNtl[3], f1, f2, p1, p2, comps, d);
+		return d[0]*d[0]*df1*df1 + d[1]*d[1]*df2*df2 + d[2]*d[2]*dp1*dp1 + d[3]*d[3]*dp2*dp2;
+	}
+
+	if(fVerbose > 2) cout << "FakeRatios::getTotESyst2 ..." << endl;
+	fRand->SetSeed(fToySeed);
+	RunningRMS f_results;
+	for(int i = 0; i < fNToyMCs; ++i){ // vary f1
+		float f1_v = throwRatio(f1, df1);
+		for(int j = 0; j < fNToyMCs; ++j){ // vary f2
+			float f2_v = throwRatio(f2, df2);
+			float result = (*this.*func)(f1_v, f2_v, p1, p2);
+			f_results.add(result);
+			if(fVerbose > 2) cout << result << endl;
+		}
+	}
+	if(fVerbose > 2) cout << " RMS = " << sqrt(f_results.rms2()) << endl;
+	if(fVerbose > 2) cout << endl;
+	RunningRMS p_results;
+	for(int i = 0; i < fNToyMCs; ++i){ // vary p1
+		float p1_v = throwRatio(p1, dp1);
+		for(int j = 0; j < fNToyMCs; ++j){ // vary p2
+			float p2_v = throwRatio(p2, dp2);
+			float result = (*this.*func)(f1, f2, p1_v, p2_v);
+			p_results.add(result);
+			if(fVerbose > 2) cout << result << endl;
+		}
+	}
+	if(fVerbose > 2) cout << " RMS = " << sqrt(p_results.rms2()) << endl;
+
+	return f_results.rms2() + p_results.rms2();
 }
 
 //____________________________________________________________________________________
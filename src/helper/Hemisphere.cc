@@ -7,67 +7,237 @@ using std::vector;
 using std::cout;
 using std::endl;
 
+#include <cstring>
+
 // constructor specifying the seed and association methods
-Hemisphere::Hemisphere(vector<float> Px_vector, vector<float> Py_vector, vector<float> Pz_vector,
-	vector<float> E_vector, int seed_method, int hemisphere_association_method) : Object_Px(Px_vector),
-	Object_Py(Py_vector), Object_Pz(Pz_vector), Object_E(E_vector), seed_meth(seed_method),
+Hemisphere::Hemisphere(const vector<float>& Px_vector, const vector<float>& Py_vector, const vector<float>& Pz_vector,
+	const vector<float>& E_vector, int seed_method, int hemisphere_association_method) : nObjects(0),
+	Object_Px(0), Object_Py(0), Object_Pz(0), Object_E(0), nextCache(0), nCacheHits(0), seed_meth(seed_method),
 	hemi_meth(hemisphere_association_method), status(0),
 	dRminSeed1(0.5),nItermax(100),
 	rejectISR(0), rejectISRPt(0), rejectISRPtmax(10000.),
 rejectISRDR(0), rejectISRDRmax(100.), dbg(0)  {
-	for(int i = 0; i < (int) Object_Px.size(); i++){
-		Object_Noseed.push_back(0);
-		Object_Noassoc.push_back(0);
-	}
+	Reserve(kInitObjects);
+	ClearCache();
+	SetVectors(Px_vector, Py_vector, Pz_vector, E_vector);
 	numLoop =0;
 }
 
 // constructor without specification of the seed and association methods
 // in this case, the latter must be given by calling SetMethod before invoking reconstruct()
-Hemisphere::Hemisphere(vector<float> Px_vector, vector<float> Py_vector, vector<float> Pz_vector,
-	vector<float> E_vector) : Object_Px(Px_vector),
-	Object_Py(Py_vector), Object_Pz(Pz_vector), Object_E(E_vector), seed_meth(0),
+Hemisphere::Hemisphere(const vector<float>& Px_vector, const vector<float>& Py_vector, const vector<float>& Pz_vector,
+	const vector<float>& E_vector) : nObjects(0),
+	Object_Px(0), Object_Py(0), Object_Pz(0), Object_E(0), nextCache(0), nCacheHits(0), seed_meth(0),
 	hemi_meth(0), status(0),
 	dRminSeed1(0.5),nItermax(100),
 	rejectISR(0), rejectISRPt(0), rejectISRPtmax(10000.),
 rejectISRDR(0), rejectISRDRmax(100.), dbg(0)  {
-	for(int i = 0; i < (int) Object_Px.size(); i++){
-		Object_Noseed.push_back(0);
-		Object_Noassoc.push_back(0);
-	}
+	Reserve(kInitObjects);
+	ClearCache();
+	SetVectors(Px_vector, Py_vector, Pz_vector, E_vector);
 	numLoop =0;
 }
 
-vector<float> Hemisphere::getAxis1(){
-	if (status != 1) {
-		if (rejectISR == 0) {
-			this->Reconstruct();
-		} else {
-			this->RejectISR();
-		}
+// reusable engine
+Hemisphere::Hemisphere(int seed_method, int hemisphere_association_method) : nObjects(0),
+	Object_Px(0), Object_Py(0), Object_Pz(0), Object_E(0), nextCache(0), nCacheHits(0), seed_meth(seed_method),
+	hemi_meth(hemisphere_association_method), status(0),
+	dRminSeed1(0.5),nItermax(100),
+	rejectISR(0), rejectISRPt(0), rejectISRPtmax(10000.),
+rejectISRDR(0), rejectISRDRmax(100.), dbg(0)  {
+	Reserve(kInitObjects);
+	ClearCache();
+	numLoop =0;
+}
+
+Hemisphere::Hemisphere(const Hemisphere& other){
+	*this = other;
+}
+
+Hemisphere& Hemisphere::operator=(const Hemisphere& other){
+	if(this == &other) return *this;
+	nObjects = other.nObjects;
+	for(int k = 0; k < 4; ++k) Object_Input[k] = other.Object_Input[k];
+	Object_P = other.Object_P;
+	Object_Pt = other.Object_Pt;
+	Object_Phi = other.Object_Phi;
+	Object_Eta = other.Object_Eta;
+	Object_Group = other.Object_Group;
+	Object_Noseed = other.Object_Noseed;
+	Object_Noassoc = other.Object_Noassoc;
+	for(int c = 0; c < kNCache; ++c) Cache[c] = other.Cache[c];
+	for(int j = 0; j < 5; ++j){
+		Axis1[j] = other.Axis1[j];
+		Axis2[j] = other.Axis2[j];
 	}
-	return Axis1;
+	// the input of the vector constructors is owned, point to our copy of it
+	const bool owned = other.Object_Px == other.Object_Input[0].data();
+	Object_Px = owned ? Object_Input[0].data() : other.Object_Px;
+	Object_Py = owned ? Object_Input[1].data() : other.Object_Py;
+	Object_Pz = owned ? Object_Input[2].data() : other.Object_Pz;
+	Object_E  = owned ? Object_Input[3].data() : other.Object_E;
+	nextCache = other.nextCache;
+	nCacheHits = other.nCacheHits;
+	seed_meth = other.seed_meth;
+	hemi_meth = other.hemi_meth;
+	status = other.status;
+	dRminSeed1 = other.dRminSeed1;
+	nItermax = other.nItermax;
+	rejectISR = other.rejectISR;
+	rejectISRPt = other.rejectISRPt;
+	rejectISRPtmax = other.rejectISRPtmax;
+	rejectISRDR = other.rejectISRDR;
+	rejectISRDRmax = other.rejectISRDRmax;
+	dbg = other.dbg;
+	numLoop = other.numLoop;
+	return *this;
 }
-vector<float> Hemisphere::getAxis2(){
-	if (status != 1) {
-		if (rejectISR == 0) {
-			this->Reconstruct();
-		} else {
-			this->RejectISR();
-		}
+
+void Hemisphere::Reserve(int n){
+	// the storage only grows, the results up to nObjects are kept
+	if(n <= (int) Object_P.size()) return;
+	Object_P.resize(n);
+	Object_Pt.resize(n);
+	Object_Phi.resize(n);
+	Object_Eta.resize(n);
+	Object_Group.resize(n);
+	Object_Noseed.resize(n);
+	Object_Noassoc.resize(n);
+}
+
+void Hemisphere::SetVectors(const vector<float>& Px_vector, const vector<float>& Py_vector, const vector<float>& Pz_vector,
+	const vector<float>& E_vector){
+	// copy the input into the internal storage
+	int vsize = (int) Px_vector.size();
+	if((int) Py_vector.size() != vsize || (int) Pz_vector.size() != vsize || (int) E_vector.size() < vsize){
+		cout << "WARNING!!!!! Input vectors have different size! Fix it!" << endl;
+		vsize = 0;
 	}
-	return Axis2;
+	Object_Input[0].assign(Px_vector.begin(), Px_vector.begin()+vsize);
+	Object_Input[1].assign(Py_vector.begin(), Py_vector.begin()+vsize);
+	Object_Input[2].assign(Pz_vector.begin(), Pz_vector.begin()+vsize);
+	Object_Input[3].assign(E_vector.begin(),  E_vector.begin() +vsize);
+	SetObjects(vsize, Object_Input[0].data(), Object_Input[1].data(), Object_Input[2].data(), Object_Input[3].data());
 }
 
-vector<int> Hemisphere::getGrouping(){
-	if (status != 1) {
-		if (rejectISR == 0) {
-			this->Reconstruct();
-		} else {
-			this->RejectISR();
-		}
+void Hemisphere::SetObjects(int n, const float* px, const float* py, const float* pz, const float* E){
+	Reserve(n);
+	nObjects  = n;
+	Object_Px = px;
+	Object_Py = py;
+	Object_Pz = pz;
+	Object_E  = E;
+	for(int i = 0; i < n; i++){
+		Object_Noseed[i]  = 0;
+		Object_Noassoc[i] = 0;
+		Object_Group[i]   = 0;
+	}
+	for(int j = 0; j < 5; ++j){
+		Axis1[j] = 0;
+		Axis2[j] = 0;
+	}
+	status = 0;
+}
+
+void Hemisphere::Compute(){
+	if (status == 1) return;
+	if (FindInCache()) return;
+
+	// the key of the new cache entry is taken before the reconstruction,
+	// which can change the NoSeed and NoAssoc lists when rejecting ISR
+	CacheEntry& C = Cache[nextCache];
+	nextCache = (nextCache+1)%kNCache;
+	StoreInCache(C, true);
+	if (rejectISR == 0) {
+		this->Reconstruct();
+	} else {
+		this->RejectISR();
+	}
+	StoreInCache(C, false);
+	// also unsuccessful reconstructions are not repeated
+	status = 1;
+}
+
+bool Hemisphere::FindInCache(){
+	const size_t fsize = nObjects*sizeof(float);
+	const size_t isize = nObjects*sizeof(int);
+	for(int c = 0; c < kNCache; ++c){
+		const CacheEntry& C = Cache[c];
+		if(C.n != nObjects || C.seed_meth != seed_meth || C.hemi_meth != hemi_meth || C.nItermax != nItermax) continue;
+		if(C.rejectISRPt != rejectISR*rejectISRPt || C.rejectISRDR != rejectISR*rejectISRDR) continue;
+		if(C.dRminSeed1 != dRminSeed1 || C.rejectISRPtmax != rejectISRPtmax || C.rejectISRDRmax != rejectISRDRmax) continue;
+		// C.n == nObjects: the vectors of the entry hold nObjects values
+		if(memcmp(C.Input[0].data(), Object_Px, fsize) != 0 || memcmp(C.Input[1].data(), Object_Py, fsize) != 0 ||
+		   memcmp(C.Input[2].data(), Object_Pz, fsize) != 0 || memcmp(C.Input[3].data(), Object_E,  fsize) != 0) continue;
+		if(memcmp(C.Noseed.data(), Object_Noseed.data(), isize) != 0 || memcmp(C.Noassoc.data(), Object_Noassoc.data(), isize) != 0) continue;
+
+		memcpy(Object_Group.data(),   C.Group.data(),      isize);
+		memcpy(Object_Noseed.data(),  C.NoseedOut.data(),  isize);
+		memcpy(Object_Noassoc.data(), C.NoassocOut.data(), isize);
+		memcpy(Axis1, C.Axis1, sizeof(Axis1));
+		memcpy(Axis2, C.Axis2, sizeof(Axis2));
+		numLoop = C.numLoop;
+		nCacheHits++;
+		status = 1;
+		return true;
 	}
-	return Object_Group;
+	return false;
+}
+
+void Hemisphere::StoreInCache(CacheEntry& C, bool key){
+	const size_t fsize = nObjects*sizeof(float);
+	const size_t isize = nObjects*sizeof(int);
+	if(key){
+		C.n = nObjects;
+		C.seed_meth = seed_meth;
+		C.hemi_meth = hemi_meth;
+		C.nItermax  = nItermax;
+		C.rejectISRPt = rejectISR*rejectISRPt;
+		C.rejectISRDR = rejectISR*rejectISRDR;
+		C.dRminSeed1     = dRminSeed1;
+		C.rejectISRPtmax = rejectISRPtmax;
+		C.rejectISRDRmax = rejectISRDRmax;
+		C.Input[0].assign(Object_Px, Object_Px+nObjects);
+		C.Input[1].assign(Object_Py, Object_Py+nObjects);
+		C.Input[2].assign(Object_Pz, Object_Pz+nObjects);
+		C.Input[3].assign(Object_E,  Object_E +nObjects);
+		C.Noseed .assign(Object_Noseed.begin(),  Object_Noseed.begin() +nObjects);
+		C.Noassoc.assign(Object_Noassoc.begin(), Object_Noassoc.begin()+nObjects);
+	} else {
+		C.Group     .assign(Object_Group.begin(),   Object_Group.begin()  +nObjects);
+		C.NoseedOut .assign(Object_Noseed.begin(),  Object_Noseed.begin() +nObjects);
+		C.NoassocOut.assign(Object_Noassoc.begin(), Object_Noassoc.begin()+nObjects);
+		memcpy(C.Axis1, Axis1, sizeof(Axis1));
+		memcpy(C.Axis2, Axis2, sizeof(Axis2));
+		C.numLoop = numLoop;
+	}
+}
+
+vector<float> Hemisphere::getAxis1(){
+	Compute();
+	return vector<float>(Axis1, Axis1+5);
+}
+vector<float> Hemisphere::getAxis2(){
+	Compute();
+	return vector<float>(Axis2, Axis2+5);
+}
+
+vector<int> Hemisphere::getGrouping(){
+	Compute();
+	return vector<int>(Object_Group.begin(), Object_Group.begin()+nObjects);
+}
+
+const int* Hemisphere::Grouping(){
+	Compute();
+	return Object_Group.data();
+}
+const float* Hemisphere::Axis1Array(){
+	Compute();
+	return Axis1;
+}
+const float* Hemisphere::Axis2Array(){
+	Compute();
+	return Axis2;
 }
 
 int Hemisphere::Reconstruct(){
@@ -86,37 +256,23 @@ int Hemisphere::Reconstruct(){
 
 
 	numLoop=0; // initialize numLoop for Zero
-	int vsize = (int) Object_Px.size();
-	if((int) Object_Py.size() != vsize || (int) Object_Pz.size() != vsize){
-		cout << "WARNING!!!!! Input vectors have different size! Fix it!" << endl;
-		return 0;
-	}
+	int vsize = nObjects;
 	if (dbg > 0) {
 //    cout << " Hemisphere method, vsn = " << hemivsn << endl;
 		cout << " Hemisphere method " << endl;
 	}
 
-	// clear some vectors if method reconstruct() is called again
-	if (!Object_P.empty()){
-		Object_P.clear();
-		Object_Pt.clear();
-		Object_Eta.clear();
-		Object_Phi.clear();
-		Object_Group.clear();
-		Axis1.clear();
-		Axis2.clear();
-	}
-	// initialize the vectors
+	// initialize the arrays (also if reconstruct() is called again)
 	for(int j = 0; j < vsize; ++j){
-		Object_P.push_back(0);
-		Object_Pt.push_back(0);
-		Object_Eta.push_back(0);
-		Object_Phi.push_back(0);
-		Object_Group.push_back(0);
+		Object_P[j] = 0;
+		Object_Pt[j] = 0;
+		Object_Eta[j] = 0;
+		Object_Phi[j] = 0;
+		Object_Group[j] = 0;
 	}
 	for(int j = 0; j < 5; ++j){
-		Axis1.push_back(0);
-		Axis2.push_back(0);
+		Axis1[j] = 0;
+		Axis2[j] = 0;
 	}
 
 	// compute additional quantities for vectors Object_xxx
@@ -619,7 +775,7 @@ int Hemisphere::RejectISR(){
 		float newAxis2_E = Axis2[4];
 
 	// loop over all objects associated to a hemisphere
-		int vsize = (int) Object_Px.size();
+		int vsize = nObjects;
 		for (int i = 0; i < vsize; ++i){
 			if (Object_Group[i] == 1 || Object_Group[i] == 2){
 //         cout << "  Object = " << i << ", Object_Group = " << Object_Group[i] << endl;
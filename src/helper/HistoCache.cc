@@ -0,0 +1,509 @@
+/*****************************************************************************
+ * Flat binary cache of the histograms of a ROOT file, see HistoCache.hh      *
+ *****************************************************************************/
+
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+#include "helper/HistoCache.hh"
+
+#include "TFile.h"
+#include "TMD5.h"
+#include "TH1F.h"
+#include "TH1D.h"
+#include "TH2F.h"
+#include "TH2D.h"
+#include "TEfficiency.h"
+#include "TAxis.h"
+#include "THashList.h"
+#include "TObjString.h"
+
+using namespace std;
+
+//____________________________________________________________________________
+// File layout, in native byte order:
+//   header (64 bytes): magic, byte order mark, number of records, offset of
+//                      the index, MD5 of the source file as hex string
+//   records:           one per object, starting at multiples of 8 bytes
+//   index:             per record the name length, name, offset and size
+namespace {
+	const char   kMagic[8]   = {'S', 'S', 'D', 'L', 'H', 'C', '0', '1'};
+	const UInt_t kByteOrder  = 0x01020304;
+	const size_t kHeaderSize = 64;
+	const size_t kMD5Offset  = 24;
+	const int    kNStats     = 13; // statistics of TH1::GetStats, at most kNstat
+
+	enum RecordType { kTH1F = 1, kTH1D, kTH2F, kTH2D, kTEfficiency };
+
+	template <class T> void put(vector<char> &out, const T &v){
+		const char *p = (const char*)&v;
+		out.insert(out.end(), p, p + sizeof(T));
+	}
+	void putString(vector<char> &out, const char *s){
+		UInt_t n = strlen(s);
+		put(out, n);
+		out.insert(out.end(), s, s + n);
+	}
+	void putArray(vector<char> &out, const void *p, size_t bytes){
+		out.insert(out.end(), (const char*)p, (const char*)p + bytes);
+	}
+
+	// Sequential reading of a record, ok is false once it runs past the end
+	struct Reader {
+		const char *p;
+		const char *end;
+		bool ok;
+		Reader(const char *begin, const char *e) : p(begin), end(e), ok(true) {};
+		template <class T> T get(){
+			T v = T();
+			if(ok && p + sizeof(T) <= end){ memcpy(&v, p, sizeof(T)); p += sizeof(T); }
+			else ok = false;
+			return v;
+		}
+		const char* getBytes(size_t n){
+			if(!ok || p + n > end){ ok = false; return 0; }
+			const char *q = p;
+			p += n;
+			return q;
+		}
+		TString getString(){
+			UInt_t n = get<UInt_t>();
+			const char *s = getBytes(n);
+			return s ? TString(s, n) : TString();
+		}
+	};
+
+	struct AxisRecord {
+		Int_t nbins;
+		Double_t min, max;
+		vector<Double_t> edges;
+		TString title;
+		vector<pair<Int_t, TString> > labels;
+	};
+
+	void putAxis(vector<char> &out, const TAxis *a){
+		put<Int_t>(out, a->GetNbins());
+		put<Double_t>(out, a->GetXmin());
+		put<Double_t>(out, a->GetXmax());
+		const TArrayD *edges = a->GetXbins();
+		put<Int_t>(out, edges->GetSize());
+		putArray(out, edges->GetArray(), edges->GetSize()*sizeof(Double_t));
+		putString(out, a->GetTitle());
+		THashList *labels = a->GetLabels();
+		put<Int_t>(out, labels ? labels->GetSize() : 0);
+		if(labels == 0) return;
+		TIter next(labels);
+		while(TObjString *l = (TObjString*)next()){
+			put<Int_t>(out, l->GetUniqueID());
+			putString(out, l->GetString().Data());
+		}
+	}
+	AxisRecord getAxis(Reader &r){
+		AxisRecord a;
+		a.nbins = r.get<Int_t>();
+		a.min   = r.get<Double_t>();
+		a.max   = r.get<Double_t>();
+		Int_t n = r.get<Int_t>();
+		const char *edges = r.getBytes(n > 0 ? n*sizeof(Double_t) : 0);
+		if(edges && n > 0){
+			a.edges.resize(n);
+			memcpy(&a.edges[0], edges, n*sizeof(Double_t));
+		}
+		a.title = r.getString();
+		Int_t nlabels = r.get<Int_t>();
+		for(Int_t i = 0; r.ok && i < nlabels; ++i){
+			Int_t bin = r.get<Int_t>();
+			a.labels.push_back(make_pair(bin, r.getString()));
+		}
+		return a;
+	}
+	void setAxis(TAxis *a, const AxisRecord &rec){
+		if(rec.edges.size() == size_t(rec.nbins+1)) a->Set(rec.nbins, &rec.edges[0]);
+		a->SetTitle(rec.title);
+		for(size_t i = 0; i < rec.labels.size(); ++i) a->SetBinLabel(rec.labels[i].first, rec.labels[i].second);
+	}
+
+	void putAttributes(vector<char> &out, const TAttLine *l, const TAttFill *f, const TAttMarker *m){
+		put<Short_t>(out, l->GetLineColor());
+		put<Short_t>(out, l->GetLineStyle());
+		put<Short_t>(out, l->GetLineWidth());
+		put<Short_t>(out, f->GetFillColor());
+		put<Short_t>(out, f->GetFillStyle());
+		put<Short_t>(out, m->GetMarkerColor());
+		put<Short_t>(out, m->GetMarkerStyle());
+		put<Float_t>(out, m->GetMarkerSize());
+	}
+	void getAttributes(Reader &r, TAttLine *l, TAttFill *f, TAttMarker *m){
+		l->SetLineColor  (r.get<Short_t>());
+		l->SetLineStyle  (r.get<Short_t>());
+		l->SetLineWidth  (r.get<Short_t>());
+		f->SetFillColor  (r.get<Short_t>());
+		f->SetFillStyle  (r.get<Short_t>());
+		m->SetMarkerColor(r.get<Short_t>());
+		m->SetMarkerStyle(r.get<Short_t>());
+		m->SetMarkerSize (r.get<Float_t>());
+	}
+
+	// Reads n elements of T into array, if the record holds exactly n
+	template <class T> bool getArray(Reader &r, T *array, Int_t n){
+		Int_t size = r.get<Int_t>();
+		const char *data = r.getBytes(size > 0 ? size*sizeof(T) : 0);
+		if(!r.ok || size != n) return false;
+		if(n > 0) memcpy(array, data, n*sizeof(T));
+		return true;
+	}
+}
+
+//____________________________________________________________________________
+HistoCache::HistoCache() : fFile(0), fMap(0), fMapSize(0), fVerbose(0) {
+}
+
+HistoCache::~HistoCache(){
+	Close();
+}
+
+bool HistoCache::Open(TString filename){
+	Close();
+	fFileName  = filename;
+	fCacheName = GetCacheName(filename);
+
+	// only local files can be checksummed, others are always read directly
+	TMD5 *md5 = TMD5::FileChecksum(filename);
+	fChecksum = md5 ? md5->AsString() : "";
+	delete md5;
+
+	if(!fChecksum.empty() && Map()){
+		if(fVerbose > 0) cout << "HistoCache::Open ==> Reading " << fIndex.size() << " histograms of " << filename << " from " << fCacheName << endl;
+		return true;
+	}
+	if(fVerbose > 0) cout << "HistoCache::Open ==> No valid cache for " << filename << ", reading the file" << endl;
+	return GetFile() != 0;
+}
+
+void HistoCache::Close(){
+	if(fMap) munmap(fMap, fMapSize);
+	fMap     = 0;
+	fMapSize = 0;
+	fIndex.clear();
+	fNew.clear();
+	if(fFile){
+		fFile->Close();
+		delete fFile;
+	}
+	fFile = 0;
+}
+
+TFile* HistoCache::GetFile(){
+	if(fFile) return fFile;
+	fFile = TFile::Open(fFileName, "READ");
+	if(fFile != 0 && fFile->IsZombie()){
+		delete fFile;
+		fFile = 0;
+	}
+	if(fFile == 0) cout << "HistoCache::GetFile ==> Error: cannot open " << fFileName << endl;
+	return fFile;
+}
+
+//____________________________________________________________________________
+bool HistoCache::Map(){
+	int fd = open(fCacheName.Data(), O_RDONLY);
+	if(fd < 0) return false;
+	struct stat st;
+	void *map = MAP_FAILED;
+	if(fstat(fd, &st) == 0 && size_t(st.st_size) >= kHeaderSize)
+		map = mmap(0, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if(map == MAP_FAILED) return false;
+	const size_t size = st.st_size;
+
+	const char *header = (const char*)map;
+	UInt_t order, nrecords;
+	ULong64_t index;
+	memcpy(&order,    header +  8, sizeof(order));
+	memcpy(&nrecords, header + 12, sizeof(nrecords));
+	memcpy(&index,    header + 16, sizeof(index));
+	string checksum(header + kMD5Offset, strnlen(header + kMD5Offset, kHeaderSize - kMD5Offset));
+	if(memcmp(header, kMagic, 8) != 0 || order != kByteOrder || checksum != fChecksum || index > size){
+		if(fVerbose > 1) cout << "HistoCache::Map ==> " << fCacheName << " is out of date" << endl;
+		munmap(map, size);
+		return false;
+	}
+
+	Reader r(header + index, header + size);
+	for(UInt_t i = 0; r.ok && i < nrecords; ++i){
+		TString name = r.getString();
+		Record rec;
+		rec.offset = r.get<ULong64_t>();
+		rec.size   = r.get<ULong64_t>();
+		if(rec.offset < kHeaderSize || rec.offset + rec.size > index) r.ok = false;
+		if(r.ok) fIndex[name.Data()] = rec;
+	}
+	if(!r.ok){
+		cout << "HistoCache::Map ==> Error: corrupt index in " << fCacheName << endl;
+		fIndex.clear();
+		munmap(map, size);
+		return false;
+	}
+	fMap     = map;
+	fMapSize = size;
+	return true;
+}
+
+TObject* HistoCache::Get(const TString &name){
+	map<string, Record>::const_iterator it = fIndex.find(name.Data());
+	if(it != fIndex.end()){
+		TObject *obj = Decode((const char*)fMap + it->second.offset, it->second.size);
+		if(obj) return obj;
+		cout << "HistoCache::Get ==> Error: cannot decode " << name << " from " << fCacheName << endl;
+	}
+
+	TFile *file = GetFile();
+	if(file == 0) return 0;
+	TObject *obj = file->Get(name);
+	if(obj == 0) return 0;
+	if(obj->InheritsFrom(TH1::Class()))         ((TH1*)obj)->SetDirectory(0);
+	if(obj->InheritsFrom(TEfficiency::Class())) ((TEfficiency*)obj)->SetDirectory(0);
+
+	vector<char> rec;
+	if(!fChecksum.empty() && Encode(rec, obj)) fNew.push_back(make_pair(string(name.Data()), rec));
+	return obj;
+}
+
+//____________________________________________________________________________
+bool HistoCache::Update(){
+	// New cache with the records of the mapped one and the new ones. Written
+	// to a temporary file first, concurrent jobs never see a partial cache.
+	if(fNew.empty() || fChecksum.empty()) return false;
+
+	vector<pair<string, Record> > records;
+	vector<const char*>           data;
+	map<string, bool> updated;
+	for(size_t i = 0; i < fNew.size(); ++i) updated[fNew[i].first] = true;
+	for(map<string, Record>::const_iterator it = fIndex.begin(); it != fIndex.end(); ++it){
+		if(updated.count(it->first)) continue;
+		records.push_back(*it);
+		data.push_back((const char*)fMap + it->second.offset);
+	}
+	for(size_t i = 0; i < fNew.size(); ++i){
+		Record rec;
+		rec.size = fNew[i].second.size();
+		records.push_back(make_pair(fNew[i].first, rec));
+		data.push_back(rec.size > 0 ? &fNew[i].second[0] : 0);
+	}
+
+	TString tmp = fCacheName + Form(".%d", getpid());
+	FILE *out = fopen(tmp.Data(), "wb");
+	if(!out){
+		cout << "HistoCache::Update ==> Error: cannot write " << tmp << endl;
+		return false;
+	}
+	char header[kHeaderSize];
+	memset(header, 0, sizeof(header));
+	bool ok = fwrite(header, 1, kHeaderSize, out) == kHeaderSize;
+
+	static const char pad[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+	size_t offset = kHeaderSize;
+	for(size_t i = 0; ok && i < records.size(); ++i){
+		records[i].second.offset = offset;
+		ok = fwrite(data[i], 1, records[i].second.size, out) == records[i].second.size;
+		offset += records[i].second.size;
+		size_t npad = (8 - offset%8)%8;
+		ok = ok && fwrite(pad, 1, npad, out) == npad;
+		offset += npad;
+	}
+
+	vector<char> index;
+	for(size_t i = 0; i < records.size(); ++i){
+		putString(index, records[i].first.c_str());
+		put<ULong64_t>(index, records[i].second.offset);
+		put<ULong64_t>(index, records[i].second.size);
+	}
+	ok = ok && fwrite(&index[0], 1, index.size(), out) == index.size();
+
+	UInt_t    nrecords  = records.size();
+	ULong64_t indexoffs = offset;
+	memcpy(header,      kMagic,      8);
+	memcpy(header +  8, &kByteOrder, sizeof(kByteOrder));
+	memcpy(header + 12, &nrecords,   sizeof(nrecords));
+	memcpy(header + 16, &indexoffs,  sizeof(indexoffs));
+	strncpy(header + kMD5Offset, fChecksum.c_str(), kHeaderSize - kMD5Offset - 1);
+	ok = ok && fseek(out, 0, SEEK_SET) == 0 && fwrite(header, 1, kHeaderSize, out) == kHeaderSize;
+	ok = (fclose(out) == 0) && ok;
+	if(!ok || rename(tmp.Data(), fCacheName.Data()) != 0){
+		unlink(tmp.Data());
+		cout << "HistoCache::Update ==> Error: cannot write " << fCacheName << endl;
+		return false;
+	}
+	if(fVerbose > 0) cout << "HistoCache::Update ==> Wrote " << records.size() << " histograms to " << fCacheName << endl;
+	fNew.clear();
+	return true;
+}
+
+//____________________________________________________________________________
+bool HistoCache::Encode(vector<char> &out, const TObject *obj){
+	if(obj->IsA() == TEfficiency::Class()){
+		const TEfficiency *e = (const TEfficiency*)obj;
+		if(e->GetTotalHistogram() == 0 || e->GetPassedHistogram() == 0) return false;
+		put<Int_t>(out, kTEfficiency);
+		putString(out, e->GetName());
+		putString(out, e->GetTitle());
+		put<Int_t>   (out, e->GetStatisticOption());
+		put<Double_t>(out, e->GetConfidenceLevel());
+		put<Double_t>(out, e->GetBetaAlpha());
+		put<Double_t>(out, e->GetBetaBeta());
+		put<Double_t>(out, e->GetWeight());
+		put<UInt_t>  (out, e->TestBits(0x00ffc000)); // class status bits
+		putAttributes(out, e, e, e);
+		return EncodeHisto(out, e->GetTotalHistogram()) && EncodeHisto(out, e->GetPassedHistogram());
+	}
+	if(obj->InheritsFrom(TH1::Class())) return EncodeHisto(out, (const TH1*)obj);
+	return false;
+}
+
+bool HistoCache::EncodeHisto(vector<char> &out, const TH1 *h){
+	Int_t type = 0;
+	const TArrayF *af = 0;
+	const TArrayD *ad = 0;
+	if     (h->IsA() == TH1F::Class()){ type = kTH1F; af = (const TH1F*)h; }
+	else if(h->IsA() == TH1D::Class()){ type = kTH1D; ad = (const TH1D*)h; }
+	else if(h->IsA() == TH2F::Class()){ type = kTH2F; af = (const TH2F*)h; }
+	else if(h->IsA() == TH2D::Class()){ type = kTH2D; ad = (const TH2D*)h; }
+	else return false;
+
+	put<Int_t>(out, type);
+	putString(out, h->GetName());
+	putString(out, h->GetTitle());
+	putString(out, h->GetOption());
+	putAxis(out, h->GetXaxis());
+	if(type == kTH2F || type == kTH2D) putAxis(out, h->GetYaxis());
+	putAttributes(out, h, h, h);
+
+	Double_t stats[kNStats];
+	memset(stats, 0, sizeof(stats));
+	h->GetStats(stats);
+	putArray(out, stats, sizeof(stats));
+	put<Double_t>(out, h->GetEntries());
+	put<Double_t>(out, h->GetMinimumStored());
+	put<Double_t>(out, h->GetMaximumStored());
+	put<Double_t>(out, h->GetNormFactor());
+
+	if(af){
+		put<Int_t>(out, af->GetSize());
+		putArray(out, af->GetArray(), af->GetSize()*sizeof(Float_t));
+	}
+	else{
+		put<Int_t>(out, ad->GetSize());
+		putArray(out, ad->GetArray(), ad->GetSize()*sizeof(Double_t));
+	}
+	const TArrayD *sumw2 = const_cast<TH1*>(h)->GetSumw2();
+	put<Int_t>(out, sumw2->GetSize());
+	putArray(out, sumw2->GetArray(), sumw2->GetSize()*sizeof(Double_t));
+	return true;
+}
+
+TObject* HistoCache::Decode(const char *data, size_t size){
+	const char *end = data + size;
+	Int_t type;
+	if(size < sizeof(type)) return 0;
+	memcpy(&type, data, sizeof(type));
+	if(type != kTEfficiency) return DecodeHisto(data, end);
+
+	Reader r(data + sizeof(type), end);
+	TString name      = r.getString();
+	TString title     = r.getString();
+	Int_t    option   = r.get<Int_t>();
+	Double_t cl       = r.get<Double_t>();
+	Double_t alpha    = r.get<Double_t>();
+	Double_t beta     = r.get<Double_t>();
+	Double_t weight   = r.get<Double_t>();
+	UInt_t   bits     = r.get<UInt_t>();
+	TEfficiency *e = new TEfficiency();
+	getAttributes(r, e, e, e);
+	if(!r.ok){ delete e; return 0; }
+
+	const char *p = r.p;
+	TH1 *total  = DecodeHisto(p, end);
+	TH1 *passed = total ? DecodeHisto(p, end) : 0;
+	if(passed == 0){
+		delete total;
+		delete e;
+		return 0;
+	}
+	// no consistency checks, the histograms come from a valid efficiency
+	e->SetTotalHistogram (*total,  "f");
+	e->SetPassedHistogram(*passed, "f");
+	delete total;
+	delete passed;
+	e->SetName(name);
+	e->SetTitle(title);
+	e->SetStatisticOption(TEfficiency::EStatOption(option));
+	e->SetConfidenceLevel(cl);
+	e->SetBetaAlpha(alpha);
+	e->SetBetaBeta(beta);
+	e->SetWeight(weight);
+	e->ResetBit(0x00ffc000);
+	e->SetBit(bits);
+	e->SetDirectory(0);
+	return e;
+}
+
+TH1* HistoCache::DecodeHisto(const char *&data, const char *end){
+	Reader r(data, end);
+	Int_t type = r.get<Int_t>();
+	if(type < kTH1F || type > kTH2D) return 0;
+	const bool is2d = (type == kTH2F || type == kTH2D);
+
+	TString name   = r.getString();
+	TString title  = r.getString();
+	TString option = r.getString();
+	AxisRecord x = getAxis(r);
+	AxisRecord y;
+	if(is2d) y = getAxis(r);
+	if(!r.ok || x.nbins < 1 || (is2d && y.nbins < 1)) return 0;
+
+	TH1 *h = 0;
+	TArrayF *af = 0;
+	TArrayD *ad = 0;
+	if(type == kTH1F){ TH1F *hf = new TH1F(name, title, x.nbins, x.min, x.max); h = hf; af = hf; }
+	if(type == kTH1D){ TH1D *hd = new TH1D(name, title, x.nbins, x.min, x.max); h = hd; ad = hd; }
+	if(type == kTH2F){ TH2F *hf = new TH2F(name, title, x.nbins, x.min, x.max, y.nbins, y.min, y.max); h = hf; af = hf; }
+	if(type == kTH2D){ TH2D *hd = new TH2D(name, title, x.nbins, x.min, x.max, y.nbins, y.min, y.max); h = hd; ad = hd; }
+	h->SetDirectory(0);
+	h->SetOption(option);
+	setAxis(h->GetXaxis(), x);
+	if(is2d) setAxis(h->GetYaxis(), y);
+	getAttributes(r, h, h, h);
+
+	Double_t stats[kNStats];
+	const char *s = r.getBytes(sizeof(stats));
+	if(s) memcpy(stats, s, sizeof(stats));
+	Double_t entries = r.get<Double_t>();
+	Double_t minimum = r.get<Double_t>();
+	Double_t maximum = r.get<Double_t>();
+	Double_t norm    = r.get<Double_t>();
+
+	bool ok = af ? getArray(r, af->GetArray(), af->GetSize()) : getArray(r, ad->GetArray(), ad->GetSize());
+	Int_t nsumw2 = r.get<Int_t>();
+	const char *sumw2 = r.getBytes(nsumw2 > 0 ? nsumw2*sizeof(Double_t) : 0);
+	if(ok && r.ok && nsumw2 > 0){
+		if(h->GetSumw2N() == 0) h->Sumw2();
+		ok = h->GetSumw2N() == nsumw2;
+		if(ok) memcpy(h->GetSumw2()->GetArray(), sumw2, nsumw2*sizeof(Double_t));
+	}
+	else if(ok && r.ok && h->GetSumw2N() > 0) h->GetSumw2()->Set(0); // unweighted
+	if(!ok || !r.ok){
+		delete h;
+		return 0;
+	}
+	h->SetMinimum(minimum);
+	h->SetMaximum(maximum);
+	h->SetNormFactor(norm);
+	h->PutStats(stats);
+	h->SetEntries(entries);
+	data = r.p;
+	return h;
+}
@@ -0,0 +1,103 @@
+/*****************************************************************************
+ * Reusable MT2 calculator with analytic early exits, see MT2Calculator.hh   *
+ * The bisection itself is done by Davismt2 (H.-C. Cheng, Z. Han)            *
+ *****************************************************************************/
+
+#include <cmath>
+
+#include "helper/MT2Calculator.hh"
+#include "TLorentzVector.h"
+
+using namespace std;
+
+MT2Calculator::MT2Calculator(double relprecision) : fPrecision(relprecision), fNCalls(0), fNEarly(0) {
+	fSolver.set_verbose(0);
+}
+
+//____________________________________________________________________________
+bool MT2Calculator::balanced(const double *pa, const double *pb, const double *pmiss, double mn, double &mt2) const {
+	// Returns true (and the value in mt2) if MT2 is given by the
+	// unconstrained minimum of the heavier side
+	mn = fabs(mn);
+	const double *ph = pa; // heavier visible system
+	const double *pl = pb; // lighter visible system
+	if(fabs(pa[0]) < fabs(pb[0])){ ph = pb; pl = pa; }
+	double mh = fabs(ph[0]);
+	double ml = fabs(pl[0]);
+	double Eh  = sqrt(mh*mh + ph[1]*ph[1] + ph[2]*ph[2]);
+	double El  = sqrt(ml*ml + pl[1]*pl[1] + pl[2]*pl[2]);
+	double met = sqrt(pmiss[1]*pmiss[1] + pmiss[2]*pmiss[2]);
+
+	// Same scale and choice of massless code as in Davismt2
+	double scale = Eh > El ? Eh/100. : El/100.;
+	if(met/100. > scale) scale = met/100.;
+	if(!(scale > 0.)) return false;
+	bool massless = (mh*mh/(scale*scale) < MIN_MASS) && (ml*ml/(scale*scale) < MIN_MASS);
+
+	if(massless){
+		// Massless visible and invisible particles: MT2 = 0 if
+		// pmiss = alpha*pa + beta*pb with alpha, beta >= 0
+		if(mn > 0.) return false;
+		double det = pa[1]*pb[2] - pa[2]*pb[1];
+		if(det == 0.) return false;
+		double alpha = (pmiss[1]*pb[2] - pmiss[2]*pb[1])/det;
+		double beta  = (pa[1]*pmiss[2] - pa[2]*pmiss[1])/det;
+		if(alpha < 0. || beta < 0.) return false;
+		mt2 = 0.;
+		return true;
+	}
+
+	// MT of the heavier side is minimal (= mh + mn) for an invisible
+	// momentum of (mn/mh)*ph. If the lighter side takes the remaining
+	// missing momentum with a smaller MT, this minimum is MT2.
+	double qx  = pmiss[1] - mn/mh*ph[1];
+	double qy  = pmiss[2] - mn/mh*ph[2];
+	double Eq  = sqrt(mn*mn + qx*qx + qy*qy);
+	double mtlsq = ml*ml + mn*mn + 2.*(El*Eq - pl[1]*qx - pl[2]*qy);
+	double mt2h  = mh + mn;
+	if(mtlsq > mt2h*mt2h) return false;
+	mt2 = mt2h;
+	return true;
+}
+
+//____________________________________________________________________________
+double MT2Calculator::getMT2(const double *pa, const double *pb, const double *pmiss, double mn){
+	fNCalls++;
+	double mt2 = 0.;
+	if(balanced(pa, pb, pmiss, mn, mt2)){
+		fNEarly++;
+		return mt2;
+	}
+
+	// Davismt2 takes non-const arrays
+	double a[3]    = {pa[0], pa[1], pa[2]};
+	double b[3]    = {pb[0], pb[1], pb[2]};
+	double miss[3] = {pmiss[0], pmiss[1], pmiss[2]};
+	fSolver.set_precision(fPrecision);
+	fSolver.set_momenta(a, b, miss);
+	fSolver.set_mn(mn);
+	return fSolver.get_mt2();
+}
+
+double MT2Calculator::getMT2(const TLorentzVector &visible1, const TLorentzVector &visible2,
+                             const TLorentzVector &MET, double mn, bool massive){
+	double pa[3], pb[3], pmiss[3];
+
+	pmiss[0] = 0;
+	pmiss[1] = MET.Px();
+	pmiss[2] = MET.Py();
+
+	pa[0] = massive ? visible1.M() : 0;
+	pa[1] = visible1.Px();
+	pa[2] = visible1.Py();
+
+	pb[0] = massive ? visible2.M() : 0;
+	pb[1] = visible2.Px();
+	pb[2] = visible2.Py();
+
+	return getMT2(pa, pb, pmiss, mn);
+}
+
+void MT2Calculator::getMT2(int n, const double *pa, const double *pb, const double *pmiss, double mn, double *mt2){
+	for(int i = 0; i < n; ++i) mt2[i] = getMT2(pa + 3*i, pb + 3*i, pmiss + 3*i, mn);
+}
@@ -0,0 +1,198 @@
+/*****************************************************************************
+ * Single pass filling of many histograms from a tree, see PlotBook.hh       *
+ *****************************************************************************/
+
+#include <iostream>
+
+#include "helper/PlotBook.hh"
+
+#include "TTree.h"
+#include "TTreeFormula.h"
+#include "TTreeFormulaManager.h"
+#include "TH1.h"
+#include "TH2.h"
+
+using namespace std;
+
+//____________________________________________________________________________
+PlotBook::PlotBook() : fVerbose(0) {
+}
+
+PlotBook::~PlotBook(){
+	DeleteFormulas();
+}
+
+//____________________________________________________________________________
+int PlotBook::AddExpression(const TString &expr){
+	map<TString, int>::const_iterator it = fExprIndex.find(expr);
+	if(it != fExprIndex.end()) return it->second;
+	fExpr.push_back(expr);
+	fExprIndex[expr] = fExpr.size()-1;
+	return fExpr.size()-1;
+}
+
+int PlotBook::Book(TH1 *h, TString var, TString cut, TString weight){
+	if(h == 0) return -1;
+	if(cut    == "") cut    = "1";
+	if(weight == "") weight = "1";
+	Plot p;
+	p.histo         = h;
+	p.expr[kX]      = AddExpression(var);
+	p.expr[kY]      = -1;
+	p.expr[kCut]    = AddExpression(cut);
+	p.expr[kWeight] = AddExpression(weight);
+	p.nsel          = 0;
+	p.manager       = 0;
+	for(int s = 0; s < kNSlots; ++s) p.form[s] = 0;
+	fPlots.push_back(p);
+	return fPlots.size()-1;
+}
+
+int PlotBook::Book(TH2 *h, TString xvar, TString yvar, TString cut, TString weight){
+	int i = Book((TH1*)h, xvar, cut, weight);
+	if(i < 0) return i;
+	fPlots[i].expr[kY] = AddExpression(yvar);
+	return i;
+}
+
+void PlotBook::Clear(){
+	DeleteFormulas();
+	fPlots.clear();
+	fExpr.clear();
+	fExprIndex.clear();
+}
+
+//____________________________________________________________________________
+void PlotBook::DeleteFormulas(){
+	for(size_t i = 0; i < fForm.size(); ++i) delete fForm[i];
+	fForm.clear();
+	fScalar.clear();
+	// the managers are deleted with their last formula
+	for(size_t p = 0; p < fPlots.size(); ++p){
+		for(int s = 0; s < kNSlots; ++s){
+			delete fPlots[p].form[s];
+			fPlots[p].form[s] = 0;
+		}
+		fPlots[p].manager = 0;
+	}
+}
+
+bool PlotBook::Compile(TTree *tree){
+	DeleteFormulas();
+	bool ok = true;
+	for(size_t i = 0; i < fExpr.size(); ++i){
+		TTreeFormula *f = new TTreeFormula(TString::Format("PlotBook_%d", (int)i), fExpr[i], tree);
+		if(f->GetNdim() == 0){
+			cout << "PlotBook::Compile ==> Error: cannot compile " << fExpr[i] << endl;
+			ok = false;
+		}
+		fScalar.push_back(f->GetMultiplicity() == 0);
+		if(!fScalar.back()){ // arrays are evaluated per plot
+			delete f;
+			f = 0;
+		}
+		fForm.push_back(f);
+	}
+	if(!ok) return false;
+
+	// The array expressions of a plot are paired instance by instance, as
+	// the formulas of one TTree::Draw: own formulas, synchronized by a manager
+	for(size_t p = 0; p < fPlots.size(); ++p){
+		Plot &plot = fPlots[p];
+		for(int s = 0; s < kNSlots; ++s){
+			const int i = plot.expr[s];
+			if(i < 0 || fScalar[i]) continue;
+			plot.form[s] = new TTreeFormula(TString::Format("PlotBook_%d_%d", (int)p, s), fExpr[i], tree);
+			if(plot.manager == 0) plot.manager = new TTreeFormulaManager();
+			plot.manager->Add(plot.form[s]);
+		}
+		if(plot.manager) plot.manager->Sync();
+	}
+
+	fNdata .assign(fExpr.size(), 0);
+	fValue .assign(fExpr.size(), 0.);
+	fLoaded.assign(fExpr.size(), false);
+	return true;
+}
+
+// Read scalar expression i for the current event, if not done yet
+inline void PlotBook::Load(int i){
+	if(fLoaded[i]) return;
+	fLoaded[i] = true;
+	fNdata[i]  = fForm[i]->GetNdata();
+	fValue[i]  = fNdata[i] > 0 ? fForm[i]->EvalInstance(0) : 0.;
+}
+
+// Loads the scalar expressions of a plot, false if the event is rejected
+// by them: a scalar without data (e.g. an index out of range) or a cut.
+// The cut comes first, the weight and variables are not read for events
+// failing it.
+inline bool PlotBook::LoadScalars(const Plot &plot){
+	static const int order[kNSlots] = {kCut, kWeight, kX, kY};
+	for(int o = 0; o < kNSlots; ++o){
+		const int s = order[o];
+		const int i = plot.expr[s];
+		if(i < 0 || !fScalar[i]) continue;
+		Load(i);
+		if(fNdata[i] == 0) return false;
+		if(s == kCut && fValue[i] == 0.) return false;
+	}
+	return true;
+}
+
+// Instance k of an expression of a plot, after LoadScalars and the
+// GetNdata() of the plot's manager
+inline double PlotBook::Value(const Plot &plot, int slot, int k){
+	const int i = plot.expr[slot];
+	if(fScalar[i]) return fValue[i];
+	return plot.form[slot]->EvalInstance(k);
+}
+
+//____________________________________________________________________________
+Long64_t PlotBook::Fill(TTree *tree, Long64_t nentries, Long64_t firstentry){
+	if(tree == 0 || fPlots.size() == 0) return 0;
+	if(tree->LoadTree(firstentry) < 0) return 0;
+	if(!Compile(tree)){
+		DeleteFormulas();
+		return -1;
+	}
+	for(size_t p = 0; p < fPlots.size(); ++p) fPlots[p].nsel = 0;
+
+	Long64_t last = tree->GetEntries();
+	if(nentries >= 0 && firstentry + nentries < last) last = firstentry + nentries;
+	if(fVerbose > 0) cout << "PlotBook::Fill ==> " << fPlots.size() << " plots, " << fExpr.size()
+	                      << " expressions, " << last - firstentry << " entries" << endl;
+
+	int treenumber = tree->GetTreeNumber();
+	Long64_t nread = 0;
+	for(Long64_t entry = firstentry; entry < last; ++entry){
+		if(tree->LoadTree(entry) < 0) break;
+		if(tree->GetTreeNumber() != treenumber){ // new file in a chain
+			treenumber = tree->GetTreeNumber();
+			for(size_t i = 0; i < fForm.size(); ++i) if(fForm[i]) fForm[i]->UpdateFormulaLeaves();
+			for(size_t p = 0; p < fPlots.size(); ++p) if(fPlots[p].manager) fPlots[p].manager->UpdateFormulaLeaves();
+		}
+		nread++;
+		fLoaded.assign(fLoaded.size(), false);
+		const double treeweight = tree->GetWeight();
+
+		for(size_t p = 0; p < fPlots.size(); ++p){
+			Plot &plot = fPlots[p];
+			if(!LoadScalars(plot)) continue;
+			const bool is2d = plot.expr[kY] >= 0;
+
+			// number of instances of the array expressions, 1 for scalars only
+			const int n = plot.manager ? plot.manager->GetNdata() : 1;
+			for(int k = 0; k < n; ++k){
+				const double c = Value(plot, kCut, k);
+				if(c == 0.) continue;
+				const double w = treeweight*Value(plot, kWeight, k)*c;
+				if(is2d) ((TH2*)plot.histo)->Fill(Value(plot, kX, k), Value(plot, kY, k), w);
+				else     plot.histo->Fill(Value(plot, kX, k), w);
+				plot.nsel++;
+			}
+		}
+	}
+	DeleteFormulas();
+	return nread;
+}
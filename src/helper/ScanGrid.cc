@@ -0,0 +1,72 @@
+/*****************************************************************************
+ * Sparse weighted 2D grid for the signal scans, see ScanGrid.hh              *
+ *****************************************************************************/
+
+#include <iostream>
+#include <cmath>
+
+#include "helper/ScanGrid.hh"
+
+#include "TH2D.h"
+
+using namespace std;
+
+//____________________________________________________________________________
+ScanGrid::ScanGrid(int nslots, int nbinsx, double xmin, double xmax, int nbinsy, double ymin, double ymax) :
+	fNSlots(nslots), fXaxis(nbinsx, xmin, xmax), fYaxis(nbinsy, ymin, ymax), fEntries(nslots, 0) {
+}
+
+int ScanGrid::FindBin(double x, double y) const {
+	const int bx = fXaxis.FindFixBin(x);
+	const int by = fYaxis.FindFixBin(y);
+	return bx + (fXaxis.GetNbins()+2)*by;
+}
+
+double* ScanGrid::GetCell(int bin){
+	vector<double> &cell = fCells[bin];
+	if(cell.empty()) cell.assign(2*fNSlots, 0.);
+	return &cell[0];
+}
+
+vector<int> ScanGrid::GetBins() const {
+	vector<int> bins;
+	bins.reserve(fCells.size());
+	for(map<int, vector<double> >::const_iterator it = fCells.begin(); it != fCells.end(); ++it) bins.push_back(it->first);
+	return bins;
+}
+
+const double* ScanGrid::FindCell(int bin) const {
+	map<int, vector<double> >::const_iterator it = fCells.find(bin);
+	return it != fCells.end() ? &it->second[0] : 0;
+}
+
+//____________________________________________________________________________
+void ScanGrid::Add(const ScanGrid &other){
+	if(other.fNSlots != fNSlots || other.fXaxis.GetNbins() != fXaxis.GetNbins() || other.fYaxis.GetNbins() != fYaxis.GetNbins()){
+		cout << "ScanGrid::Add ==> Error: grids have different layouts" << endl;
+		return;
+	}
+	for(map<int, vector<double> >::const_iterator it = other.fCells.begin(); it != other.fCells.end(); ++it){
+		double *cell = GetCell(it->first);
+		for(int i = 0; i < 2*fNSlots; ++i) cell[i] += it->second[i];
+	}
+	for(int s = 0; s < fNSlots; ++s) fEntries[s] += other.fEntries[s];
+}
+
+void ScanGrid::FillHisto(TH2D *h, int slot) const {
+	if(h->GetNbinsX() != fXaxis.GetNbins() || h->GetNbinsY() != fYaxis.GetNbins()){
+		cout << "ScanGrid::FillHisto ==> Error: " << h->GetName() << " has a different binning" << endl;
+		return;
+	}
+	if(h->GetSumw2N() == 0) h->Sumw2();
+	const double entries = h->GetEntries(); // SetBinContent counts entries itself
+	for(map<int, vector<double> >::const_iterator it = fCells.begin(); it != fCells.end(); ++it){
+		const double sumw  = it->second[2*slot];
+		const double sumw2 = it->second[2*slot+1];
+		if(sumw == 0. && sumw2 == 0.) continue;
+		const double err = h->GetBinError(it->first);
+		h->SetBinContent(it->first, h->GetBinContent(it->first) + sumw);
+		h->SetBinError  (it->first, sqrt(err*err + sumw2));
+	}
+	h->SetEntries(entries + fEntries[slot]);
+}
@@ -0,0 +1,219 @@
+/*****************************************************************************
+ * Column-wise in-memory copy of the SigEvents tree, see SigEventTable.hh     *
+ *****************************************************************************/
+
+#include <iostream>
+#include <limits>
+#include <cstdlib>
+
+#include "helper/SigEventTable.hh"
+
+#include "TFile.h"
+#include "TTree.h"
+#include "TBranch.h"
+#include "TLeaf.h"
+
+using namespace std;
+
+const double SigEventTable::kNoLimit = numeric_limits<double>::infinity();
+
+//____________________________________________________________________________
+SigEventTable::SigEventTable() : fFile(0), fTree(0), fNEntries(0), fVerbose(0) {
+}
+
+SigEventTable::~SigEventTable(){
+	Close();
+}
+
+bool SigEventTable::Open(TString filename, TString treename){
+	Close();
+	fFile = TFile::Open(filename);
+	if(fFile == 0 || fFile->IsZombie()){
+		cout << "SigEventTable::Open ==> Error: cannot open " << filename << endl;
+		delete fFile; fFile = 0;
+		return false;
+	}
+	fTree = (TTree*)fFile->Get(treename);
+	if(fTree == 0){
+		cout << "SigEventTable::Open ==> Error: no tree " << treename << " in " << filename << endl;
+		Close();
+		return false;
+	}
+	fFileName = filename;
+	fNEntries = fTree->GetEntries();
+	if(fVerbose > 0) cout << "SigEventTable::Open ==> " << fNEntries << " signal events in " << filename << endl;
+	return true;
+}
+
+void SigEventTable::Close(){
+	if(fFile != 0) fFile->Close();
+	delete fFile;
+	fFile     = 0;
+	fTree     = 0;
+	fFileName = "";
+	fNEntries = 0;
+	fType.clear();
+	fIntCol.clear();
+	fFloatCol.clear();
+	fStringCol.clear();
+}
+
+//____________________________________________________________________________
+SigEventTable::ColumnType SigEventTable::Load(const TString &name){
+// Reads the whole branch into its column, once
+	map<TString, ColumnType>::const_iterator it = fType.find(name);
+	if(it != fType.end()) return it->second;
+
+	ColumnType type = kNone;
+	TBranch *b = fTree ? fTree->GetBranch(name) : 0;
+	if(b == 0){
+		cout << "SigEventTable::Load ==> Error: no branch " << name << endl;
+		fType[name] = type;
+		return type;
+	}
+
+	// The leaf is not always named as the branch (MTLep2 has leaf MTLep1)
+	TLeaf *l = (TLeaf*)b->GetListOfLeaves()->At(0);
+	TString tname = l ? l->GetTypeName() : "";
+	if(tname == "Int_t"){
+		vector<int> &col = fIntCol[name];
+		col.resize(fNEntries);
+		int v;
+		fTree->SetBranchAddress(name, &v);
+		for(Long64_t i = 0; i < fNEntries; ++i){
+			b->GetEntry(i);
+			col[i] = v;
+		}
+		type = kInt;
+	}
+	else if(tname == "Float_t"){
+		vector<float> &col = fFloatCol[name];
+		col.resize(fNEntries);
+		float v;
+		fTree->SetBranchAddress(name, &v);
+		for(Long64_t i = 0; i < fNEntries; ++i){
+			b->GetEntry(i);
+			col[i] = v;
+		}
+		type = kFloat;
+	}
+	else if(TString(b->GetClassName()) == "string"){
+		StringColumn &col = fStringCol[name];
+		col.index.resize(fNEntries);
+		map<string, int> index;
+		string *v = new string;
+		fTree->SetBranchAddress(name, &v);
+		for(Long64_t i = 0; i < fNEntries; ++i){
+			b->GetEntry(i);
+			map<string, int>::const_iterator vit = index.find(*v);
+			if(vit == index.end()){
+				vit = index.insert(make_pair(*v, (int)col.values.size())).first;
+				col.values.push_back(*v);
+			}
+			col.index[i] = vit->second;
+		}
+		fTree->ResetBranchAddress(b);
+		delete v;
+		type = kString;
+	}
+	else{
+		cout << "SigEventTable::Load ==> Error: branch " << name << " has unsupported type " << (l ? tname : TString(b->GetClassName())) << endl;
+		exit(-1);
+	}
+	if(type != kString) fTree->ResetBranchAddress(b);
+
+	if(fVerbose > 1 && type != kNone) cout << "SigEventTable::Load ==> Read column " << name << endl;
+	fType[name] = type;
+	return type;
+}
+
+const vector<int>* SigEventTable::GetIntColumn(const TString &name){
+	if(Load(name) != kInt) return 0;
+	return &fIntCol[name];
+}
+
+const vector<float>* SigEventTable::GetFloatColumn(const TString &name){
+	if(Load(name) != kFloat) return 0;
+	return &fFloatCol[name];
+}
+
+const vector<int>* SigEventTable::GetStringIndex(const TString &name){
+	if(Load(name) != kString) return 0;
+	return &fStringCol[name].index;
+}
+
+const vector<string>* SigEventTable::GetStringValues(const TString &name){
+	if(Load(name) != kString) return 0;
+	return &fStringCol[name].values;
+}
+
+//____________________________________________________________________________
+void SigEventTable::Select(vector<int> &rows) const {
+	rows.resize(fNEntries);
+	for(Long64_t i = 0; i < fNEntries; ++i) rows[i] = i;
+}
+
+bool SigEventTable::Filter(vector<int> &rows, const TString &name, double min, double max){
+	ColumnType type = Load(name);
+	if(type != kInt && type != kFloat){
+		cout << "SigEventTable::Filter ==> Error: cannot cut on " << name << endl;
+		return false;
+	}
+	if(rows.empty()) return true;
+
+	size_t n = 0;
+	if(type == kInt){
+		const int *v = &fIntCol[name][0];
+		for(size_t i = 0; i < rows.size(); ++i){
+			const int r = rows[i];
+			if(v[r] < min || v[r] > max) continue;
+			rows[n++] = r;
+		}
+	}
+	else{
+		const float *v = &fFloatCol[name][0];
+		for(size_t i = 0; i < rows.size(); ++i){
+			const int r = rows[i];
+			if(v[r] < min || v[r] > max) continue;
+			rows[n++] = r;
+		}
+	}
+	rows.resize(n);
+	return true;
+}
+
+//____________________________________________________________________________
+void SigEventReader::SetBranchAddress(const TString &name, int *address){
+	const vector<int> *col = fTable->GetIntColumn(name);
+	if(col == 0){
+		cout << "SigEventReader::SetBranchAddress ==> Error: no Int_t column " << name << endl;
+		exit(-1);
+	}
+	fInt.push_back(make_pair(col, address));
+}
+
+void SigEventReader::SetBranchAddress(const TString &name, float *address){
+	const vector<float> *col = fTable->GetFloatColumn(name);
+	if(col == 0){
+		cout << "SigEventReader::SetBranchAddress ==> Error: no Float_t column " << name << endl;
+		exit(-1);
+	}
+	fFloat.push_back(make_pair(col, address));
+}
+
+void SigEventReader::SetBranchAddress(const TString &name, string **address){
+	const vector<int> *col = fTable->GetStringIndex(name);
+	if(col == 0){
+		cout << "SigEventReader::SetBranchAddress ==> Error: no string column " << name << endl;
+		exit(-1);
+	}
+	fString.push_back(make_pair(col, address));
+	fStringValues.push_back(fTable->GetStringValues(name));
+}
+
+void SigEventReader::GetEntry(Long64_t i){
+	for(size_t k = 0; k < fInt.size();   ++k) *fInt[k].second   = (*fInt[k].first)[i];
+	for(size_t k = 0; k < fFloat.size(); ++k) *fFloat[k].second = (*fFloat[k].first)[i];
+	for(size_t k = 0; k < fString.size(); ++k)
+		*fString[k].second = const_cast<string*>(&(*fStringValues[k])[(*fString[k].first)[i]]);
+}
@@ -0,0 +1,122 @@
+/*****************************************************************************
+ * Cumulative weighted yield grid for the cut optimizations, see YieldGrid.hh *
+ *****************************************************************************/
+
+#include <iostream>
+#include <algorithm>
+#include <new>
+#include <cmath>
+
+#include "helper/YieldGrid.hh"
+
+using namespace std;
+
+//____________________________________________________________________________
+YieldGrid::YieldGrid(int nslots) :
+	fNSlots(nslots), fNCells(0), fIntegrated(false) {
+}
+
+int YieldGrid::AddAxis(const TString &name, vector<double> thresholds){
+	if(!fSums.empty()){
+		cout << "YieldGrid::AddAxis ==> Error: grid is already booked, ignoring axis " << name << endl;
+		return -1;
+	}
+	if(thresholds.empty() || FindAxis(name) >= 0){
+		cout << "YieldGrid::AddAxis ==> Error: no thresholds or duplicate axis " << name << endl;
+		return -1;
+	}
+	sort(thresholds.begin(), thresholds.end());
+	thresholds.erase(unique(thresholds.begin(), thresholds.end()), thresholds.end());
+	fNames.push_back(name);
+	fThresholds.push_back(thresholds);
+	return fNames.size()-1;
+}
+
+int YieldGrid::FindAxis(const TString &name) const {
+	for(size_t i = 0; i < fNames.size(); ++i) if(fNames[i] == name) return i;
+	return -1;
+}
+
+bool YieldGrid::Book(){
+	// The first axis runs fastest
+	fStrides.assign(fNames.size(), 1);
+	fNCells = 1;
+	for(size_t i = 0; i < fNames.size(); ++i){
+		fStrides[i] = fNCells;
+		fNCells *= fThresholds[i].size();
+	}
+	try{
+		fSums.assign(fNCells*fNSlots, 0.);
+	}
+	catch(const bad_alloc&){
+		cout << "YieldGrid::Book ==> Error: cannot allocate " << fNCells << " cells of " << fNSlots << " slots" << endl;
+		fSums.clear();
+		return false;
+	}
+	fIntegrated = false;
+	return true;
+}
+
+//____________________________________________________________________________
+Long64_t YieldGrid::FindCell(const double *values) const {
+	Long64_t cell = 0;
+	for(size_t i = 0; i < fThresholds.size(); ++i){
+		const vector<double> &th = fThresholds[i];
+		// last threshold <= value
+		const int bin = upper_bound(th.begin(), th.end(), values[i]) - th.begin() - 1;
+		if(bin < 0) return -1;
+		cell += bin*fStrides[i];
+	}
+	return cell;
+}
+
+Long64_t YieldGrid::FindCut(const double *cuts) const {
+	Long64_t cell = 0;
+	for(size_t i = 0; i < fThresholds.size(); ++i){
+		const vector<double> &th = fThresholds[i];
+		const int bin = lower_bound(th.begin(), th.end(), cuts[i] - 1.e-4) - th.begin();
+		if(bin == int(th.size()) || fabs(th[bin] - cuts[i]) > 1.e-4) return -1;
+		cell += bin*fStrides[i];
+	}
+	return cell;
+}
+
+double YieldGrid::GetThreshold(Long64_t cell, int axis) const {
+	const int bin = (cell/fStrides[axis]) % fThresholds[axis].size();
+	return fThresholds[axis][bin];
+}
+
+//____________________________________________________________________________
+void YieldGrid::Integrate(){
+	if(fIntegrated) return;
+	// Suffix sums along one axis after the other, going backwards through the
+	// cells such that the next cell along the axis is already summed
+	for(size_t i = 0; i < fThresholds.size(); ++i){
+		const Long64_t stride = fStrides[i];
+		const Long64_t nbins  = fThresholds[i].size();
+		for(Long64_t cell = fNCells-1; cell >= 0; --cell){
+			if((cell/stride) % nbins == nbins-1) continue;
+			float       *sum  = &fSums[cell*fNSlots];
+			const float *next = &fSums[(cell+stride)*fNSlots];
+			for(int s = 0; s < fNSlots; ++s) sum[s] += next[s];
+		}
+	}
+	fIntegrated = true;
+}
+
+void YieldGrid::Add(const YieldGrid &other){
+	if(other.fNSlots != fNSlots || other.fThresholds != fThresholds || other.fIntegrated != fIntegrated){
+		cout << "YieldGrid::Add ==> Error: grids have different layouts" << endl;
+		return;
+	}
+	for(size_t i = 0; i < fSums.size(); ++i) fSums[i] += other.fSums[i];
+}
+
+double YieldGrid::GetParameter(const TString &name) const {
+	map<TString, double>::const_iterator it = fParameters.find(name);
+	if(it == fParameters.end()){
+		cout << "YieldGrid::GetParameter ==> Error: no parameter " << name << endl;
+		return 0.;
+	}
+	return it->second;
+}
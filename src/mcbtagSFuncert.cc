@@ -10,6 +10,7 @@
 #include "TAxis.h"
 #include <iostream>
 #include "mcbtagSFuncert.h"
+#include "helper/BTagSF.hh"
 
 //------------------------------------------------------------------------
 //------------------------------------------------------------------------
@@ -55,10 +56,11 @@
 // https://twiki.cern.ch/twiki/pub/CMS/BtagPOG/SFb-mujet_payload.txt
 double btagScaleFactor(double jetpt, std::string algo, bool useFastSim) {
   double SFb = 1.0;
-  double ptmin[] = {30, 40, 50, 60, 70, 80, 100, 120, 160, 210, 260, 320, 400, 500};
-  double ptmax[] = {40, 50, 60, 70, 80,100, 120, 160, 210, 260, 320, 400, 500, 670};
-  double CFb[] = {0.982194,0.980998,0.992014,0.994472,0.996825,0.999822,1.00105,1.00023,0.991994,0.979123,0.947207,0.928006,0.874260,0.839610};
-  const unsigned int nbins = sizeof(ptmin)/sizeof(double);
+  // fastsim corrections shared with BTagSF
+  const double *ptmin = BTagSF::fFastSimPtMin;
+  const double *ptmax = BTagSF::fFastSimPtMax;
+  const double *CFb   = BTagSF::fFastSimSF[BTagSF::kFSb];
+  const unsigned int nbins = BTagSF::kNFastSimBins;
 
     if (algo == "CSVM") {
       float pt = std::max(std::min(jetpt, 670.),30.);
@@ -83,8 +85,8 @@ double btagScaleFactorError(double jetpt, std::string algo, bool useFastSim, SMS
   double SFerr_fast_stat = 0;
   double SFerr_fast_syst = 0;
   if (algo == "CSVM") {
-        double ptmin[] = {30, 40, 50, 60, 70, 80, 100, 120, 160, 210, 260, 320, 400, 500};
-        double ptmax[] = {40, 50, 60, 70, 80,100, 120, 160, 210, 260, 320, 400, 500, 670};
+        const double *ptmin = BTagSF::fFastSimPtMin;
+        const double *ptmax = BTagSF::fFastSimPtMax;
         double SFb_error[] = {
             0.0295675,
             0.0295095,
@@ -100,15 +102,13 @@ double btagScaleFactorError(double jetpt, std::string algo, bool useFastSim, SMS
             0.0541299,
             0.0578761,
             0.0655432 };
-	double CFb_error[] = {
-	  0.00253112,0.00296453,0.00113963,0.00128363,0.00232566,0.00232353,0.00219086,0.00156856,
-	  0.00322279,0.00400414,0.00737465,0.0105033,0.0171706,0.0344172}; // stat + PU
+	const double *CFb_error = BTagSF::fFastSimErr[BTagSF::kFSb]; // stat + PU
 	double CFb_T1tttt_syst[] = {
 	  0.00716144,0.00659549,0.00515735,0.00384551,0.00435913,0.00394750,0.00587666,0.00569624,
 	  0.000432074,-0.0108556,-0.0150331,-0.0310161,-0.0266697,-0.0185043};
         
 	double fudgeFactor=1.5;
-        const unsigned int nbins = sizeof(ptmin)/sizeof(double);
+        const unsigned int nbins = BTagSF::kNFastSimBins;
         if (jetpt < ptmin[0]) {
 	  SFerr_full =  0.12*fudgeFactor;
 	  SFerr_fast_stat = CFb_error[0]*2.; //no idea if this is right (not on the twiki)